@@ -24,6 +24,8 @@ set(LLDB_ENABLE_PYTHON_SCRIPTS_SWIG_API_GENERATION 1 CACHE BOOL
   "Enables using new Python scripts for SWIG API generation .")  
 set(LLDB_RELOCATABLE_PYTHON 0 CACHE BOOL
   "Causes LLDB to use the PYTHONHOME environment variable to locate Python.")
+set(LLDB_BUILD_PERF_TESTS 0 CACHE BOOL
+  "Builds the lldb-perf benchmarks in tools/lldb-perf.")
 
 if ((NOT MSVC) OR MSVC12)
   add_definitions( -DHAVE_ROUND )
@@ -194,6 +196,10 @@ if (NOT LIBXML2_FOUND)
   find_package(LibXml2)
 endif()
 
+if (NOT LIBLZMA_FOUND)
+  find_package(LibLZMA)
+endif()
+
 # Find libraries or frameworks that may be needed
 if (CMAKE_SYSTEM_NAME MATCHES "Darwin")
   find_library(CARBON_LIBRARY Carbon)
@@ -217,6 +223,12 @@ else()
     include_directories(${LIBXML2_INCLUDE_DIR})
   endif()
 
+  if (LIBLZMA_FOUND)
+    add_definitions( -DLIBLZMA_DEFINED )
+    list(APPEND system_libs ${LIBLZMA_LIBRARIES})
+    include_directories(${LIBLZMA_INCLUDE_DIRS})
+  endif()
+
 endif()
 
 if (HAVE_LIBPTHREAD)
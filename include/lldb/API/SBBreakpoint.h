@@ -91,6 +91,20 @@ public:
     const char *
     GetCondition ();
 
+    //------------------------------------------------------------------
+    /// Make the breakpoint a tracepoint that collects \a collect on each
+    /// hit instead of stopping, or a breakpoint again if the list is
+    /// empty. See the "tracepoint collect" command for the items.
+    //------------------------------------------------------------------
+    void
+    SetTracepointCollect (SBStringList &collect);
+
+    void
+    GetTracepointCollect (SBStringList &collect);
+
+    bool
+    IsTracepoint ();
+
     void
     SetThreadID (lldb::tid_t sb_thread_id);
 
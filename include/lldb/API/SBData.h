@@ -167,9 +167,11 @@ protected:
 
 private:
     friend class SBInstruction;
+    friend class SBMemoryReadRangeList;
     friend class SBProcess;
     friend class SBSection;
     friend class SBTarget;
+    friend class SBTracepointRecordList;
     friend class SBValue;
 
     lldb::DataExtractorSP  m_opaque_sp;
@@ -257,6 +257,14 @@ public:
     bool
     GetDescription (lldb::SBStream &description);
 
+    //------------------------------------------------------------------
+    /// Get the statistics of all targets, and the statistics shared by
+    /// all targets, as JSON. This is what "statistics dump --all-targets"
+    /// prints.
+    //------------------------------------------------------------------
+    bool
+    GetStatistics (lldb::SBStream &stats);
+
     uint32_t
     GetTerminalWidth () const;
 
@@ -71,10 +71,12 @@ protected:
     friend class SBDebugger;
     friend class SBCommunication;
     friend class SBHostOS;
+    friend class SBMemoryReadRangeList;
     friend class SBPlatform;
     friend class SBProcess;
     friend class SBThread;
     friend class SBTarget;
+    friend class SBTracepointRecordList;
     friend class SBValue;
     friend class SBWatchpoint;
     friend class SBBreakpoint;
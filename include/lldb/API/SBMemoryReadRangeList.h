@@ -0,0 +1,71 @@
+//===-- SBMemoryReadRangeList.h ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SBMemoryReadRangeList_h_
+#define LLDB_SBMemoryReadRangeList_h_
+
+#include "lldb/API/SBDefines.h"
+#include "lldb/API/SBData.h"
+#include "lldb/API/SBError.h"
+
+namespace lldb {
+
+class LLDB_API SBMemoryReadRangeList
+{
+public:
+    SBMemoryReadRangeList ();
+
+    SBMemoryReadRangeList (const lldb::SBMemoryReadRangeList &rhs);
+
+    ~SBMemoryReadRangeList ();
+
+    const SBMemoryReadRangeList &
+    operator = (const lldb::SBMemoryReadRangeList &rhs);
+
+    uint32_t
+    GetSize () const;
+
+    void
+    Append (lldb::addr_t addr, size_t size);
+
+    void
+    Clear ();
+
+    lldb::addr_t
+    GetAddressAtIndex (uint32_t idx) const;
+
+    size_t
+    GetByteSizeAtIndex (uint32_t idx) const;
+
+    //------------------------------------------------------------------
+    /// Get the bytes that were read for a range by
+    /// SBProcess::ReadMemoryRanges(). This can be shorter than the
+    /// size of the range if only part of it could be read.
+    //------------------------------------------------------------------
+    lldb::SBData
+    GetDataAtIndex (uint32_t idx) const;
+
+    lldb::SBError
+    GetErrorAtIndex (uint32_t idx) const;
+
+    bool
+    GetDescription (lldb::SBStream &description) const;
+
+private:
+    friend class SBProcess;
+
+    size_t
+    ReadMemory (lldb_private::Process &process);
+
+    std::unique_ptr<lldb_private::MemoryReadRangeListImpl> m_opaque_ap;
+};
+
+} // namespace lldb
+
+#endif // LLDB_SBMemoryReadRangeList_h_
@@ -248,6 +248,33 @@ public:
     size_t
     ReadMemory (addr_t addr, void *buf, size_t size, lldb::SBError &error);
 
+    //------------------------------------------------------------------
+    /// Read all of the ranges in \a ranges at once.
+    ///
+    /// This is much faster than calling ReadMemory() for each range
+    /// when the ranges are small and scattered since they are read in
+    /// as few requests to the process as possible.
+    ///
+    /// @param[in,out] ranges
+    ///     The ranges to read. The data and error for each range can be
+    ///     retrieved from the list afterwards.
+    ///
+    /// @param[out] error
+    ///     Set if the process couldn't be read from at all.
+    ///
+    /// @return
+    ///     The number of ranges that were read completely.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryRanges (lldb::SBMemoryReadRangeList &ranges, lldb::SBError &error);
+
+    //------------------------------------------------------------------
+    /// Append the data the tracepoints collected since the last call to
+    /// \a records. This works while the process is running.
+    //------------------------------------------------------------------
+    lldb::SBError
+    GetTracepointData (lldb::SBTracepointRecordList &records);
+
     size_t
     WriteMemory (addr_t addr, const void *buf, size_t size, lldb::SBError &error);
 
@@ -74,6 +74,7 @@ protected:
     friend class SBInstruction;
     friend class SBInstructionList;
     friend class SBLineEntry;
+    friend class SBMemoryReadRangeList;
     friend class SBModule;
     friend class SBModuleSpec;
     friend class SBModuleSpecList;
@@ -86,6 +87,7 @@ protected:
     friend class SBTarget;
     friend class SBThread;
     friend class SBThreadPlan;
+    friend class SBTracepointRecordList;
     friend class SBType;
     friend class SBTypeEnumMember;
     friend class SBTypeMemberFunction;
@@ -768,6 +768,13 @@ public:
     bool
     GetDescription (lldb::SBStream &description, lldb::DescriptionLevel description_level);
 
+    //------------------------------------------------------------------
+    /// Get the statistics of the work done for this target as JSON.
+    /// This is what "statistics dump" prints for a target.
+    //------------------------------------------------------------------
+    bool
+    GetStatistics (lldb::SBStream &stats);
+
     lldb::SBValue
     EvaluateExpression (const char *expr, const SBExpressionOptions &options);
 
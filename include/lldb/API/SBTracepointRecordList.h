@@ -0,0 +1,87 @@
+//===-- SBTracepointRecordList.h --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLDB_SBTracepointRecordList_h_
+#define LLDB_SBTracepointRecordList_h_
+
+#include "lldb/API/SBDefines.h"
+#include "lldb/API/SBData.h"
+#include "lldb/API/SBError.h"
+
+namespace lldb {
+
+class LLDB_API SBTracepointRecordList
+{
+public:
+    SBTracepointRecordList ();
+
+    SBTracepointRecordList (const lldb::SBTracepointRecordList &rhs);
+
+    ~SBTracepointRecordList ();
+
+    const SBTracepointRecordList &
+    operator = (const lldb::SBTracepointRecordList &rhs);
+
+    uint32_t
+    GetSize () const;
+
+    void
+    Clear ();
+
+    lldb::break_id_t
+    GetBreakpointIDAtIndex (uint32_t idx) const;
+
+    lldb::break_id_t
+    GetLocationIDAtIndex (uint32_t idx) const;
+
+    lldb::tid_t
+    GetThreadIDAtIndex (uint32_t idx) const;
+
+    lldb::addr_t
+    GetAddressAtIndex (uint32_t idx) const;
+
+    //------------------------------------------------------------------
+    /// Get the number of values of a record, one per item of the collect
+    /// list of its tracepoint.
+    //------------------------------------------------------------------
+    uint32_t
+    GetNumValuesAtIndex (uint32_t idx) const;
+
+    const char *
+    GetValueNameAtIndex (uint32_t idx, uint32_t value_idx) const;
+
+    //------------------------------------------------------------------
+    /// Get the bytes collected for a value, in the byte order of the
+    /// process. The data is invalid if the value couldn't be collected.
+    //------------------------------------------------------------------
+    lldb::SBData
+    GetValueDataAtIndex (uint32_t idx, uint32_t value_idx) const;
+
+    //------------------------------------------------------------------
+    /// Get the number of records the process dropped since it started
+    /// because they weren't fetched in time.
+    //------------------------------------------------------------------
+    uint64_t
+    GetNumDropped () const;
+
+    bool
+    GetDescription (lldb::SBStream &description) const;
+
+private:
+    friend class SBProcess;
+
+    lldb_private::Error
+    GetTracepointData (lldb_private::Process &process);
+
+    std::unique_ptr<lldb_private::TracepointRecordListImpl> m_opaque_ap;
+};
+
+} // namespace lldb
+
+#endif // LLDB_SBTracepointRecordList_h_
@@ -503,6 +503,18 @@ public:
     //------------------------------------------------------------------
     const char *GetConditionText () const;
 
+    //------------------------------------------------------------------
+    /// Set what the breakpoint collects when it is hit, see
+    /// BreakpointOptions::SetTracepointCollect().
+    //------------------------------------------------------------------
+    void SetTracepointCollect (const StringList &collect);
+
+    const StringList &
+    GetTracepointCollect () const;
+
+    bool
+    IsTracepoint () const;
+
     //------------------------------------------------------------------
     // The next section are various utility functions.
     //------------------------------------------------------------------
@@ -802,6 +814,11 @@ private:
     void
     SendBreakpointChangedEvent (BreakpointEventData *data);
 
+    // Let the process know that what its breakpoint sites have to evaluate
+    // or collect on a hit changed.
+    void
+    NotifySitesConditionsChanged ();
+
     DISALLOW_COPY_AND_ASSIGN(Breakpoint);
 };
 
@@ -473,6 +473,11 @@ private:
     
     void
     SendBreakpointLocationChangedEvent (lldb::BreakpointEventType eventKind);
+
+    // Let the process know that what the breakpoint site has to evaluate
+    // or collect on a hit may have changed.
+    void
+    NotifySiteConditionsChanged ();
     
     DISALLOW_COPY_AND_ASSIGN (BreakpointLocation);
 };
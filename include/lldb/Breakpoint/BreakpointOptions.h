@@ -189,6 +189,36 @@ public:
     //------------------------------------------------------------------
     const char *GetConditionText (size_t *hash = NULL) const;
     
+    //------------------------------------------------------------------
+    // Tracepoint
+    //------------------------------------------------------------------
+    //------------------------------------------------------------------
+    /// Set what the breakpoint collects when it is hit. A breakpoint that
+    /// collects something is a tracepoint: its hits are recorded where
+    /// the process runs and don't stop it.
+    ///
+    /// @param[in] collect
+    ///    One item per string, a register ("$pc"), a variable, or
+    ///    "<expression>@<byte-size>" for memory. Pass an empty list to
+    ///    turn the tracepoint back into a breakpoint.
+    //------------------------------------------------------------------
+    void SetTracepointCollect (const StringList &collect)
+    {
+        m_tracepoint_collect = collect;
+    }
+
+    const StringList &
+    GetTracepointCollect () const
+    {
+        return m_tracepoint_collect;
+    }
+
+    bool
+    IsTracepoint () const
+    {
+        return m_tracepoint_collect.GetSize() > 0;
+    }
+
     //------------------------------------------------------------------
     // Enabled/Ignore Count
     //------------------------------------------------------------------
@@ -355,6 +385,7 @@ private:
     std::unique_ptr<ThreadSpec> m_thread_spec_ap; // Thread for which this breakpoint will take
     std::string m_condition_text;  // The condition to test.
     size_t m_condition_text_hash; // Its hash, so that locations know when the condition is updated.
+    StringList m_tracepoint_collect; // What the breakpoint collects if it is a tracepoint.
 };
 
 } // namespace lldb_private
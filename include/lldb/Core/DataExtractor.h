@@ -1075,6 +1075,28 @@ public:
     int64_t
     GetSLEB128 (lldb::offset_t *offset_ptr) const;
 
+    //------------------------------------------------------------------
+    /// Extract \a count signed LEB128 values from \a *offset_ptr.
+    ///
+    /// This is faster than calling GetSLEB128() \a count times.
+    ///
+    /// @param[in,out] offset_ptr
+    ///     A pointer to an offset within the data that will be advanced
+    ///     past the last value that was extracted.
+    ///
+    /// @param[out] dst
+    ///     A buffer with room for \a count values.
+    ///
+    /// @param[in] count
+    ///     The number of values to extract.
+    ///
+    /// @return
+    ///     The number of values that were extracted, which is less than
+    ///     \a count if the end of the data was reached.
+    //------------------------------------------------------------------
+    uint32_t
+    GetSLEB128 (lldb::offset_t *offset_ptr, int64_t *dst, uint32_t count) const;
+
     //------------------------------------------------------------------
     /// Extract a unsigned LEB128 value from \a *offset_ptr.
     ///
@@ -1096,6 +1118,28 @@ public:
     uint64_t
     GetULEB128 (lldb::offset_t *offset_ptr) const;
 
+    //------------------------------------------------------------------
+    /// Extract \a count unsigned LEB128 values from \a *offset_ptr.
+    ///
+    /// This is faster than calling GetULEB128() \a count times.
+    ///
+    /// @param[in,out] offset_ptr
+    ///     A pointer to an offset within the data that will be advanced
+    ///     past the last value that was extracted.
+    ///
+    /// @param[out] dst
+    ///     A buffer with room for \a count values.
+    ///
+    /// @param[in] count
+    ///     The number of values to extract.
+    ///
+    /// @return
+    ///     The number of values that were extracted, which is less than
+    ///     \a count if the end of the data was reached.
+    //------------------------------------------------------------------
+    uint32_t
+    GetULEB128 (lldb::offset_t *offset_ptr, uint64_t *dst, uint32_t count) const;
+
     lldb::DataBufferSP &
     GetSharedDataBuffer ()
     {
@@ -1270,6 +1314,18 @@ public:
     uint32_t
     Skip_LEB128 (lldb::offset_t *offset_ptr) const;
 
+    //------------------------------------------------------------------
+    /// Skip \a count LEB128 numbers at \a *offset_ptr.
+    ///
+    /// This is faster than calling Skip_LEB128() \a count times.
+    ///
+    /// @return
+    ///     The number of values that were skipped, which is less than
+    ///     \a count if the end of the data was reached.
+    //------------------------------------------------------------------
+    uint32_t
+    Skip_LEB128 (lldb::offset_t *offset_ptr, uint32_t count) const;
+
     //------------------------------------------------------------------
     /// Test the validity of \a offset.
     ///
@@ -20,6 +20,7 @@
 #include "lldb/Core/IOHandler.h"
 #include "lldb/Core/Listener.h"
 #include "lldb/Core/SourceManager.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Core/UserID.h"
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Host/HostThread.h"
@@ -175,6 +176,13 @@ public:
         return m_target_list;
     }
 
+    //------------------------------------------------------------------
+    /// Report the statistics of the selected target, or of all targets,
+    /// along with the statistics that are shared by all targets.
+    //------------------------------------------------------------------
+    StructuredData::DictionarySP
+    ReportStatistics (bool all_targets);
+
     PlatformList &
     GetPlatformList ()
     {
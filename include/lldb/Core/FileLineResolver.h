@@ -67,6 +67,9 @@ public:
            uint32_t line,
            bool check_inlines);
 protected:    
+    void
+    ResolveCompileUnit (CompileUnit &cu);
+
     FileSpec m_file_spec; // This is the file spec we are looking for.
     uint32_t m_line_number; // This is the line number that we are looking for.
     SymbolContextList m_sc_list;
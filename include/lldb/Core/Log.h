@@ -17,6 +17,8 @@
 #include <stdio.h>
 
 // C++ Includes
+#include <atomic>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/lldb-private.h"
@@ -37,6 +39,8 @@
 #define LLDB_LOG_OPTION_PREPEND_THREAD_NAME     (1U << 6)
 #define LLDB_LOG_OPTION_BACKTRACE               (1U << 7)
 #define LLDB_LOG_OPTION_APPEND                  (1U << 8)
+#define LLDB_LOG_OPTION_ASYNC                   (1U << 9)
+#define LLDB_LOG_OPTION_FLIGHT_RECORDER         (1U << 10)
 
 //----------------------------------------------------------------------
 // Logging Functions
@@ -179,6 +183,15 @@ protected:
     Flags m_mask_bits;
 
 private:
+    void
+    RecordAsync(const lldb::StreamSP &stream_sp, const char *format, va_list args);
+
+    // The stream that m_recorder_sink_id was registered for with the
+    // LogRecorder, used by LLDB_LOG_OPTION_ASYNC and
+    // LLDB_LOG_OPTION_FLIGHT_RECORDER logs.
+    std::atomic<Stream *> m_recorder_stream;
+    std::atomic<uint32_t> m_recorder_sink_id;
+
   DISALLOW_COPY_AND_ASSIGN(Log);
 };
 
@@ -0,0 +1,125 @@
+//===-- LogRecorder.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_LogRecorder_h_
+#define liblldb_LogRecorder_h_
+
+// C Includes
+#include <stdint.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class LogRecorder LogRecorder.h "lldb/Core/LogRecorder.h"
+/// @brief The backend for asynchronous and flight recorder logs.
+///
+/// Logs that are enabled with LLDB_LOG_OPTION_ASYNC don't write to their
+/// stream on the thread that is logging. The message is copied into a
+/// ring buffer that belongs to the logging thread without taking any
+/// locks, and a background thread drains all of the ring buffers and
+/// writes the messages to the log stream in a compact binary format.
+/// "log decode" turns a binary log back into text.
+///
+/// Logs that are enabled with LLDB_LOG_OPTION_FLIGHT_RECORDER are
+/// recorded the same way, but only the most recent messages are kept in
+/// memory. They are written to the log stream when "log dump" is run,
+/// when the log is disabled, or when lldb crashes.
+//----------------------------------------------------------------------
+class LogRecorder
+{
+public:
+    //------------------------------------------------------------------
+    // The binary log format is a FileHeader followed by records. Each
+    // record is a RecordHeader followed by "length" bytes of message
+    // text. Flight recorder dumps append a new FileHeader each time.
+    // Values are in the byte order of the host that wrote the log, which
+    // can be detected from FileHeader::byte_order_mark.
+    //------------------------------------------------------------------
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order_mark;
+    };
+
+    struct RecordHeader
+    {
+        uint64_t timestamp;     // Nanoseconds since Jan 1, 1970
+        uint64_t thread_id;
+        uint32_t sequence;
+        uint32_t length;
+    };
+
+    static const char g_magic[8];
+
+    enum
+    {
+        eVersion = 1,
+        eByteOrderMark = 0x01020304
+    };
+
+    //------------------------------------------------------------------
+    /// Register a stream that records can be sent to.
+    ///
+    /// @param[in] stream_sp
+    ///     The stream that the binary log will be written to.
+    ///
+    /// @param[in] flight_recorder
+    ///     If true, only keep the most recent records for this stream in
+    ///     memory until they are dumped.
+    ///
+    /// @return
+    ///     The ID to pass to LogRecorder::Record(). Registering the same
+    ///     stream again returns the same ID.
+    //------------------------------------------------------------------
+    static uint32_t
+    AddSink (const lldb::StreamSP &stream_sp, bool flight_recorder);
+
+    //------------------------------------------------------------------
+    /// Record a message for a sink on the current thread. This never
+    /// blocks: if the current thread's ring buffer is full the message
+    /// is dropped and the number of dropped messages is logged later.
+    //------------------------------------------------------------------
+    static void
+    Record (uint32_t sink_id, const char *message, size_t length);
+
+    //------------------------------------------------------------------
+    /// Write out everything that has been recorded so far.
+    //------------------------------------------------------------------
+    static void
+    Flush ();
+
+    //------------------------------------------------------------------
+    /// Write the contents of all flight recorders to their streams.
+    ///
+    /// @return
+    ///     The number of records that were written.
+    //------------------------------------------------------------------
+    static size_t
+    DumpFlightRecorders ();
+
+    //------------------------------------------------------------------
+    /// Decode a binary log into text.
+    ///
+    /// @return
+    ///     True if the data was a valid binary log, false if it wasn't
+    ///     (in which case an error is written to \a strm).
+    //------------------------------------------------------------------
+    static bool
+    Decode (const DataExtractor &data, Stream &strm);
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_LogRecorder_h_
@@ -663,6 +663,26 @@ public:
     lldb::CompUnitSP
     GetCompileUnitAtIndex (size_t idx);
 
+    //------------------------------------------------------------------
+    /// Get the compile units that may contain line entries for a file.
+    ///
+    /// Uses the symbol file's source file index when it has one, and
+    /// returns all compile units of the module otherwise.
+    ///
+    /// @param[in] file_spec
+    ///     The source file to look for.
+    ///
+    /// @param[out] cu_list
+    ///     The candidate compile units. Callers still need to match
+    ///     \a file_spec against each compile unit's support files.
+    ///
+    /// @return
+    ///     The number of compile units in \a cu_list.
+    //------------------------------------------------------------------
+    size_t
+    GetCompileUnitsForFile (const FileSpec &file_spec,
+                            std::vector<lldb::CompUnitSP> &cu_list);
+
     const ConstString &
     GetObjectName() const;
 
@@ -13,6 +13,8 @@
 #include <vector>
 #include <list>
 #include <functional>
+#include <string>
+#include <unordered_map>
 
 #include "lldb/lldb-private.h"
 #include "lldb/Host/Mutex.h"
@@ -88,6 +90,21 @@ public:
     const ModuleList&
     operator= (const ModuleList& rhs);
 
+    //------------------------------------------------------------------
+    /// Keep hash indexes of the modules in this list by UUID and by
+    /// file name.
+    ///
+    /// FindModules(), FindFirstModule(), FindModule() and
+    /// ReplaceEquivalent() then only need to look at the modules that
+    /// share the UUID or file name being searched for instead of every
+    /// module in the list. Keeping the indexes makes adding and
+    /// removing modules a little slower and computes the UUID of each
+    /// module as it is added, so this is meant for large, long lived
+    /// lists like the global shared module list.
+    //------------------------------------------------------------------
+    void
+    EnableIndexes ();
+
     //------------------------------------------------------------------
     /// Append a module to the module list.
     ///
@@ -583,7 +600,38 @@ protected:
     
     void
     ClearImpl (bool use_notifier = true);
-    
+
+    //------------------------------------------------------------------
+    // Index maintenance and lookups. These must be called with
+    // m_modules_mutex locked.
+    //------------------------------------------------------------------
+    void
+    AddToIndexes (Module *module);
+
+    void
+    RemoveFromIndexes (Module *module);
+
+    void
+    RebuildIndexes ();
+
+    bool
+    GetIndexedModules (const ModuleSpec &module_spec, std::vector<Module *> &modules) const;
+
+    //------------------------------------------------------------------
+    // Index typedefs. Modules are indexed by raw pointer so the indexes
+    // don't keep them alive or keep them from being seen as orphans.
+    //------------------------------------------------------------------
+    typedef std::unordered_map<std::string, std::vector<Module *> > UUIDIndex; ///< Modules keyed by their UUID bytes
+    typedef std::unordered_map<const char *, std::vector<Module *> > FileIndex; ///< Modules keyed by their uniqued file name
+
+    struct IndexKeys
+    {
+        std::string uuid;
+        const char *file_name;
+    };
+
+    typedef std::unordered_map<const Module *, IndexKeys> IndexKeysMap; ///< The keys each module was indexed with
+
     //------------------------------------------------------------------
     // Member variables.
     //------------------------------------------------------------------
@@ -591,6 +639,11 @@ protected:
     mutable Mutex m_modules_mutex;
 
     Notifier* m_notifier;
+
+    bool m_indexed;               ///< True if the indexes below are maintained
+    UUIDIndex m_uuid_index;
+    FileIndex m_file_index;
+    IndexKeysMap m_index_keys;
     
 public:
     typedef LockingAdaptedIterable<collection, lldb::ModuleSP, vector_adapter> ModuleIterable;
@@ -62,6 +62,34 @@ public:
     static void
     ResetCategoryTimes ();
 
+    //--------------------------------------------------------------
+    /// Start or stop recording a begin and end event for every Timer
+    /// scope. Events are appended to a buffer owned by the current
+    /// thread, so recording takes no locks, and a disabled trace costs
+    /// a single flag check per timer. Enabling tracing discards the
+    /// events of the previous trace.
+    //--------------------------------------------------------------
+    static void
+    SetTracing (bool enable);
+
+    static bool
+    GetTracing ();
+
+    //--------------------------------------------------------------
+    /// Write the recorded events in the Chrome Trace Event JSON
+    /// format that chrome://tracing and other trace viewers can load.
+    /// Tracing should be disabled before the trace is dumped.
+    //--------------------------------------------------------------
+    static void
+    DumpChromeTrace (Stream &s);
+
+    //--------------------------------------------------------------
+    /// If the LLDB_TRACE_FILE environment variable was set when the
+    /// timers were initialized, write the trace to that file.
+    //--------------------------------------------------------------
+    static void
+    Terminate ();
+
 protected:
 
     void
@@ -84,6 +112,7 @@ protected:
     TimeValue m_timer_start;
     uint64_t m_total_ticks; // Total running time for this timer including when other timers below this are running
     uint64_t m_timer_ticks; // Ticks for this timer that do not include when other timers below this one are running
+    bool m_traced;          // True if a begin trace event was recorded for this timer
     static uint32_t g_depth;
     static uint32_t g_display_depth;
     static FILE * g_file;
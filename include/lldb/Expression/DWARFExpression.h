@@ -68,6 +68,12 @@ public:
     //------------------------------------------------------------------
     DWARFExpression(const DWARFExpression& rhs);
 
+    //------------------------------------------------------------------
+    /// Assignment operator
+    //------------------------------------------------------------------
+    DWARFExpression &
+    operator = (const DWARFExpression& rhs);
+
     //------------------------------------------------------------------
     /// Destructor
     //------------------------------------------------------------------
@@ -397,6 +403,35 @@ public:
                             lldb::addr_t address,
                             ABI *abi);
 
+    enum SimpleLocationKind
+    {
+        eSimpleLocationNone,            // Missing, or needs the opcode interpreter
+        eSimpleLocationAddress,         // The file address in "operand"
+        eSimpleLocationRegister,        // The value is in register "reg_num"
+        eSimpleLocationRegisterOffset,  // At register "reg_num" plus the signed "operand"
+        eSimpleLocationFrameBaseOffset, // At the frame base plus the signed "operand"
+        eSimpleLocationCallFrameCFA     // The canonical frame address (for frame bases)
+    };
+
+    //------------------------------------------------------------------
+    /// Describe the location at \a addr if it is made of a single
+    /// opcode, so clients that can't run the opcode interpreter (like
+    /// code that translates the location for a remote stub) can use it.
+    /// Register numbers are of the kind returned by GetRegisterKind().
+    ///
+    /// @param[in] loclist_base_addr
+    ///     The base address of the location list, if IsLocationList()
+    ///     is true. The same address space as \a addr.
+    ///
+    /// @param[in] addr
+    ///     The pc the location is wanted at.
+    //------------------------------------------------------------------
+    SimpleLocationKind
+    GetSimpleLocation (lldb::addr_t loclist_base_addr,
+                       lldb::addr_t addr,
+                       uint32_t &reg_num,
+                       uint64_t &operand) const;
+
 protected:
     //------------------------------------------------------------------
     /// Pretty-prints the location expression to a stream
@@ -430,6 +465,44 @@ protected:
                  lldb::offset_t &offset, 
                  lldb::offset_t &len);
 
+    //------------------------------------------------------------------
+    /// The opcodes decoded once into a form that is quick to evaluate.
+    /// Location list entries are indexed by address range and each
+    /// expression is classified so the common single opcode locations
+    /// (DW_OP_addr, DW_OP_regN, DW_OP_bregN and DW_OP_fbreg) can be
+    /// evaluated without going through the opcode interpreter.
+    //------------------------------------------------------------------
+    struct CompiledExpression;
+    struct CompiledLocation;
+
+    static CompiledExpression
+    CompileExpression (const DataExtractor &data,
+                       lldb::offset_t data_offset,
+                       lldb::offset_t data_length);
+
+    const CompiledLocation &
+    GetCompiledLocation () const;
+
+    const CompiledExpression *
+    FindCompiledExpression (lldb::addr_t loclist_base_addr,
+                            lldb::addr_t addr) const;
+
+    bool
+    EvaluateCompiledExpression (const CompiledExpression &expr,
+                                ExecutionContext *exe_ctx,
+                                ClangExpressionVariableList *expr_locals,
+                                ClangExpressionDeclMap *decl_map,
+                                RegisterContext *reg_ctx,
+                                const Value* initial_value_ptr,
+                                Value& result,
+                                Error *error_ptr) const;
+
+    void
+    ClearCompiledLocation ()
+    {
+        std::atomic_store (&m_compiled_sp, std::shared_ptr<CompiledLocation>());
+    }
+
     //------------------------------------------------------------------
     /// Classes that inherit from DWARFExpression can see and modify these
     //------------------------------------------------------------------
@@ -440,6 +513,9 @@ protected:
     lldb::addr_t m_loclist_slide;               ///< A value used to slide the location list offsets so that 
                                                 ///< they are relative to the object that owns the location list
                                                 ///< (the function for frame base and variable location lists)
+    mutable std::shared_ptr<CompiledLocation> m_compiled_sp; ///< Lazily decoded opcodes, shared between copies of this expression.
+                                                ///< Only accessed with the std::atomic_* shared_ptr functions, it is
+                                                ///< filled in from const methods that run on many threads.
 
 };
 
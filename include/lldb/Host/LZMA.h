@@ -0,0 +1,77 @@
+//===-- LZMA.h --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_LZMA_h_
+#define liblldb_LZMA_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private {
+
+namespace lzma {
+
+//----------------------------------------------------------------------
+/// Returns true if LLDB was built with liblzma support and the
+/// functions below can actually decompress data.
+//----------------------------------------------------------------------
+bool
+IsAvailable ();
+
+//----------------------------------------------------------------------
+/// Reads the stream footer and index of an .xz stream and returns the
+/// size the data will have once uncompressed.
+///
+/// @param[in] data
+///     The complete .xz stream.
+///
+/// @param[in] data_size
+///     The size in bytes of \a data.
+///
+/// @param[out] uncompressed_size
+///     Filled in with the uncompressed size on success.
+///
+/// @return
+///     An error describing why the size could not be determined.
+//----------------------------------------------------------------------
+Error
+GetUncompressedSize (const uint8_t *data,
+                     size_t data_size,
+                     uint64_t &uncompressed_size);
+
+//----------------------------------------------------------------------
+/// Decompresses a complete .xz stream into a newly allocated buffer.
+///
+/// @param[in] data
+///     The complete .xz stream.
+///
+/// @param[in] data_size
+///     The size in bytes of \a data.
+///
+/// @param[out] error
+///     Set to an error describing why decompression failed.
+///
+/// @return
+///     A buffer with the uncompressed bytes, or an empty shared pointer
+///     if decompression failed.
+//----------------------------------------------------------------------
+lldb::DataBufferSP
+Uncompress (const uint8_t *data,
+            size_t data_size,
+            Error &error);
+
+} // namespace lzma
+
+} // namespace lldb_private
+
+#endif  // liblldb_LZMA_h_
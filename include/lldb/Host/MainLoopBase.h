@@ -0,0 +1,121 @@
+//===-- MainLoopBase.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_Host_MainLoopBase_h_
+#define lldb_Host_MainLoopBase_h_
+
+#include <functional>
+#include <memory>
+
+#include "lldb/Core/Error.h"
+#include "lldb/Host/IOObject.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class MainLoopBase MainLoopBase.h "lldb/Host/MainLoopBase.h"
+/// @brief The base class of the event loops that drive lldb-server.
+///
+/// A main loop waits for any of the registered objects to become
+/// readable and runs the callback that was registered with it on the
+/// thread that called Run(). Everything that happens in response to an
+/// event therefore happens on one thread, which is what ptrace requires
+/// of the code that controls the inferior.
+///
+/// Registering an object returns a handle, and the object stays
+/// registered until the handle is destroyed. Callbacks may register and
+/// unregister objects, including their own.
+///
+/// This class does not implement any of the waiting itself; see
+/// MainLoopPosix.
+//----------------------------------------------------------------------
+class MainLoopBase
+{
+private:
+    class ReadHandle;
+
+public:
+    typedef std::unique_ptr<ReadHandle> ReadHandleUP;
+
+    typedef std::function<void(MainLoopBase &)> Callback;
+
+    MainLoopBase () { }
+
+    virtual
+    ~MainLoopBase () { }
+
+    //------------------------------------------------------------------
+    /// Call \a callback whenever \a object_sp has data available to be
+    /// read (or has been closed by the other side).
+    ///
+    /// @return
+    ///     A handle that keeps the object registered, or NULL with
+    ///     \a error set if the object couldn't be registered.
+    //------------------------------------------------------------------
+    virtual ReadHandleUP
+    RegisterReadObject (const lldb::IOObjectSP &object_sp,
+                        const Callback &callback,
+                        Error &error)
+    {
+        error.SetErrorString ("Not implemented");
+        return nullptr;
+    }
+
+    //------------------------------------------------------------------
+    /// Wait for events and dispatch them until RequestTermination() is
+    /// called from one of the callbacks.
+    //------------------------------------------------------------------
+    virtual Error
+    Run ()
+    {
+        return Error ("Not implemented");
+    }
+
+    //------------------------------------------------------------------
+    /// Make Run() return once the callback that is running returns.
+    //------------------------------------------------------------------
+    virtual void
+    RequestTermination () { }
+
+protected:
+    ReadHandleUP
+    CreateReadHandle (const lldb::IOObjectSP &object_sp)
+    {
+        return ReadHandleUP (new ReadHandle (*this, object_sp->GetWaitableHandle ()));
+    }
+
+    virtual void
+    UnregisterReadObject (IOObject::WaitableHandle handle) { }
+
+private:
+    class ReadHandle
+    {
+    public:
+        ~ReadHandle () { m_mainloop.UnregisterReadObject (m_handle); }
+
+    private:
+        ReadHandle (MainLoopBase &mainloop, IOObject::WaitableHandle handle) :
+            m_mainloop (mainloop),
+            m_handle (handle)
+        {
+        }
+
+        MainLoopBase &m_mainloop;
+        IOObject::WaitableHandle m_handle;
+
+        friend class MainLoopBase;
+        DISALLOW_COPY_AND_ASSIGN (ReadHandle);
+    };
+
+    DISALLOW_COPY_AND_ASSIGN (MainLoopBase);
+};
+
+} // namespace lldb_private
+
+#endif // lldb_Host_MainLoopBase_h_
@@ -11,6 +11,9 @@
 #define liblldb_NativeBreakpoint_h_
 
 #include "lldb/lldb-types.h"
+#include "lldb/Host/common/NativeTracepointBuffer.h"
+
+#include <vector>
 
 namespace lldb_private
 {
@@ -42,6 +45,26 @@ namespace lldb_private
         virtual bool
         IsSoftwareBreakpoint () const = 0;
 
+        // Agent expression bytecode for the conditions that a hit is
+        // reported under. A hit is reported if any of them is true, or
+        // always if there are none.
+        void
+        SetConditions (std::vector<std::vector<uint8_t>> &&conditions) { m_conditions = std::move (conditions); }
+
+        const std::vector<std::vector<uint8_t>> &
+        GetConditions () const { return m_conditions; }
+
+        // What to collect when the breakpoint is hit. A breakpoint with
+        // items is a tracepoint: hits are recorded instead of reported.
+        void
+        SetTracepointItems (std::vector<NativeTracepointItem> &&items) { m_tracepoint_items = std::move (items); }
+
+        const std::vector<NativeTracepointItem> &
+        GetTracepointItems () const { return m_tracepoint_items; }
+
+        bool
+        IsTracepoint () const { return !m_tracepoint_items.empty (); }
+
     protected:
         const lldb::addr_t m_addr;
         int32_t m_ref_count;
@@ -54,6 +77,8 @@ namespace lldb_private
 
     private:
         bool m_enabled;
+        std::vector<std::vector<uint8_t>> m_conditions;
+        std::vector<NativeTracepointItem> m_tracepoint_items;
 
         // -----------------------------------------------------------
         // interface for NativeBreakpointList
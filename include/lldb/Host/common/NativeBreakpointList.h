@@ -33,6 +33,13 @@ namespace lldb_private
         Error
         DecRef (lldb::addr_t addr);
 
+        // Like DecRef(), but an enabled software breakpoint that loses its
+        // last reference is handed back in "breakpoint_sp" instead of being
+        // disabled, so the caller can take out its trap together with
+        // others.
+        Error
+        DecRefWithoutDisabling (lldb::addr_t addr, NativeBreakpointSP &breakpoint_sp);
+
         Error
         EnableBreakpoint (lldb::addr_t addr);
 
@@ -16,8 +16,11 @@
 #include "lldb/lldb-types.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Host/Mutex.h"
+#include "lldb/Target/MemoryReadRange.h"
 
 #include "NativeBreakpointList.h"
+#include "NativeSoftwareWatchpointList.h"
+#include "NativeTracepointBuffer.h"
 #include "NativeWatchpointList.h"
 
 namespace lldb_private
@@ -82,6 +85,41 @@ namespace lldb_private
         virtual Error
         Kill () = 0;
 
+        //------------------------------------------------------------------
+        /// Enable or disable non-stop mode.
+        ///
+        /// In non-stop mode a thread that stops doesn't stop the other
+        /// threads of the process. Each stop is reported to the delegates
+        /// with NativeDelegate::ThreadStopped() instead of a change of the
+        /// process state, and the process stays running for as long as
+        /// any of its threads are.
+        ///
+        /// The default implementation doesn't support non-stop mode.
+        ///
+        /// @return
+        ///     Returns an error object.
+        //------------------------------------------------------------------
+        virtual Error
+        SetNonStopMode (bool enable);
+
+        bool
+        GetNonStopMode () const
+        {
+            return m_non_stop_mode;
+        }
+
+        //------------------------------------------------------------------
+        /// Stop a single running thread in non-stop mode. The stop is
+        /// reported with NativeDelegate::ThreadStopped() once the thread
+        /// has stopped. Stopping a thread that is already stopped does
+        /// nothing.
+        ///
+        /// @return
+        ///     Returns an error object.
+        //------------------------------------------------------------------
+        virtual Error
+        StopThread (lldb::tid_t tid);
+
         //----------------------------------------------------------------------
         // Memory and memory region functions
         //----------------------------------------------------------------------
@@ -89,15 +127,57 @@ namespace lldb_private
         virtual Error
         GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info);
 
+        //----------------------------------------------------------------------
+        /// Get every mapped memory region of the process at once.
+        ///
+        /// @param[out] regions
+        ///     The mapped regions, sorted by address.
+        ///
+        /// @param[out] generation
+        ///     A number that changes whenever the memory map of the process
+        ///     changes, so callers can tell whether a copy of the map they
+        ///     got earlier is still current.
+        //----------------------------------------------------------------------
+        virtual Error
+        GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation);
+
         virtual Error
         ReadMemory(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) = 0;
 
         virtual Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) = 0;
 
+        //----------------------------------------------------------------------
+        /// Read several memory ranges at once.
+        ///
+        /// Subclasses that can read many ranges with a single request to the
+        /// operating system should override this. The default implementation
+        /// reads each range with ReadMemory().
+        ///
+        /// @param[in,out] ranges
+        ///     The ranges to read. Each range gets its data_sp filled in with
+        ///     the bytes that could be read and its error set if none could.
+        //----------------------------------------------------------------------
+        virtual Error
+        ReadMemoryRanges (MemoryReadRanges &ranges);
+
+        Error
+        ReadMemoryRangesWithoutTrap (MemoryReadRanges &ranges);
+
         virtual Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) = 0;
 
+        //----------------------------------------------------------------------
+        /// Write a block of memory with as few requests to the operating
+        /// system as possible.
+        ///
+        /// Subclasses that can write a whole block with a single request
+        /// should override this. The default implementation calls
+        /// WriteMemory().
+        //----------------------------------------------------------------------
+        virtual Error
+        WriteMemoryBlock (lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written);
+
         virtual Error
         AllocateMemory(size_t size, uint32_t permissions, lldb::addr_t &addr) = 0;
 
@@ -125,6 +205,54 @@ namespace lldb_private
         virtual Error
         RemoveBreakpoint (lldb::addr_t addr);
 
+        struct SoftwareBreakpointUpdate
+        {
+            bool insert;
+            lldb::addr_t addr;
+            uint32_t size_hint;
+            Error error;
+        };
+
+        //----------------------------------------------------------------------
+        /// Insert and remove many software breakpoints at once, with the
+        /// reference counting of SetBreakpoint() and RemoveBreakpoint().
+        ///
+        /// The removals are done before the insertions. The traps that go
+        /// in or out on the same page are read, written and verified with
+        /// one request each, instead of a few per breakpoint.
+        ///
+        /// @param[in,out] updates
+        ///     The breakpoints to insert or remove. Each one gets its error
+        ///     set if it couldn't be.
+        //----------------------------------------------------------------------
+        void
+        UpdateSoftwareBreakpoints (std::vector<SoftwareBreakpointUpdate> &updates);
+
+        //----------------------------------------------------------------------
+        /// Replace the conditions of the breakpoint at \a addr. Each one is
+        /// agent expression bytecode, and a hit is only reported if one of
+        /// them is true. Process plug-ins that don't evaluate conditions
+        /// report every hit.
+        //----------------------------------------------------------------------
+        Error
+        SetBreakpointConditions (lldb::addr_t addr, std::vector<std::vector<uint8_t>> &&conditions);
+
+        //----------------------------------------------------------------------
+        /// Replace what the breakpoint at \a addr collects into the
+        /// tracepoint buffer when it is hit while the process is running.
+        /// With items, hits whose conditions are true are recorded and the
+        /// thread keeps running; process plug-ins that can't step over the
+        /// breakpoint without stopping report the hit after recording it.
+        //----------------------------------------------------------------------
+        Error
+        SetTracepoint (lldb::addr_t addr, std::vector<NativeTracepointItem> &&items);
+
+        NativeTracepointBuffer &
+        GetTracepointBuffer ()
+        {
+            return m_tracepoint_buffer;
+        }
+
         virtual Error
         EnableBreakpoint (lldb::addr_t addr);
 
@@ -146,6 +274,14 @@ namespace lldb_private
         virtual Error
         RemoveWatchpoint (lldb::addr_t addr);
 
+        // The watchpoints that SetWatchpoint() couldn't get debug registers
+        // for and that are watched by protecting their pages instead.
+        const NativeSoftwareWatchpointList &
+        GetSoftwareWatchpointList () const
+        {
+            return m_software_watchpoint_list;
+        }
+
         //----------------------------------------------------------------------
         // Accessors
         //----------------------------------------------------------------------
@@ -248,6 +384,13 @@ namespace lldb_private
 
             virtual void
             DidExec (NativeProcessProtocol *process) = 0;
+
+            // Called in non-stop mode when a thread stopped. The other
+            // threads of the process may still be running.
+            virtual void
+            ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+            {
+            }
         };
 
         //------------------------------------------------------------------
@@ -309,9 +452,12 @@ namespace lldb_private
         Mutex m_delegates_mutex;
         std::vector<NativeDelegate*> m_delegates;
         NativeBreakpointList m_breakpoint_list;
+        NativeTracepointBuffer m_tracepoint_buffer;
         NativeWatchpointList m_watchpoint_list;
+        NativeSoftwareWatchpointList m_software_watchpoint_list;
         int m_terminal_fd;
         uint32_t m_stop_id;
+        bool m_non_stop_mode;
 
         // -----------------------------------------------------------
         // Internal interface for state handling
@@ -328,6 +474,18 @@ namespace lldb_private
         virtual void
         DoStopIDBumped (uint32_t newBumpId);
 
+        // -----------------------------------------------------------
+        // Internal interface for software watchpoints, which
+        // SetWatchpoint() falls back to when it can't set a hardware
+        // watchpoint. Derived classes that can protect memory pages
+        // implement these on top of m_software_watchpoint_list.
+        // -----------------------------------------------------------
+        virtual Error
+        SetSoftwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags);
+
+        virtual Error
+        RemoveSoftwareWatchpoint (lldb::addr_t addr);
+
         // -----------------------------------------------------------
         // Internal interface for software breakpoints
         // -----------------------------------------------------------
@@ -346,7 +504,16 @@ namespace lldb_private
         void
         NotifyDidExec ();
 
-        NativeThreadProtocolSP
+        // -----------------------------------------------------------
+        /// Notify the delegates that a thread stopped in non-stop mode.
+        // -----------------------------------------------------------
+        void
+        NotifyThreadStopped (lldb::tid_t tid);
+
+        // Look up a thread with m_threads_mutex already held. The default
+        // searches m_threads, derived classes that index their threads by
+        // ID can do better.
+        virtual NativeThreadProtocolSP
         GetThreadByIDUnlocked (lldb::tid_t tid);
 
     private:
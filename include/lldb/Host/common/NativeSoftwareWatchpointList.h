@@ -0,0 +1,154 @@
+//===-- NativeSoftwareWatchpointList.h --------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeSoftwareWatchpointList_h_
+#define liblldb_NativeSoftwareWatchpointList_h_
+
+#include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
+
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace lldb_private
+{
+    // Watchpoints that are watched by taking away access to the pages they
+    // are on, so there can be more of them than debug registers, and they
+    // can be of any size.
+    //
+    // This keeps track of the pages and of the protection each one needs;
+    // the process changes the protection. Watchpoints that share a page
+    // share its protection, and neighbouring pages that change the same way
+    // are changed together.
+    //
+    // Watch flags are the ones of NativeWatchpoint: 0x1 to watch writes and
+    // 0x2 to watch reads. Permissions are lldb::Permissions bits.
+    class NativeSoftwareWatchpointList
+    {
+    public:
+        struct Watchpoint
+        {
+            lldb::addr_t addr;
+            size_t size;
+            uint32_t watch_flags;
+            uint64_t num_faults;    // Faults taken on the pages of the watchpoint
+            uint64_t num_hits;
+        };
+
+        // Set the pages in [addr, addr + size) to "permissions".
+        struct ProtectionChange
+        {
+            lldb::addr_t addr;
+            size_t size;
+            uint32_t permissions;
+        };
+        typedef std::vector<ProtectionChange> ProtectionChanges;
+
+        // Gets the permissions a page has before it is watched.
+        typedef std::function<bool (lldb::addr_t page_addr, uint32_t &permissions)> GetPermissionsCallback;
+
+        NativeSoftwareWatchpointList (size_t page_size = 4096);
+
+        void
+        SetPageSize (size_t page_size) { m_page_size = page_size; }
+
+        size_t
+        GetPageSize () const { return m_page_size; }
+
+        lldb::addr_t
+        GetPageAddress (lldb::addr_t addr) const { return addr & ~static_cast<lldb::addr_t> (m_page_size - 1); }
+
+        // Add a watchpoint, replacing any other one at "addr", and append
+        // the protection changes that start watching it to "changes".
+        Error
+        Add (lldb::addr_t addr, size_t size, uint32_t watch_flags,
+             const GetPermissionsCallback &get_permissions, ProtectionChanges &changes);
+
+        // Remove a watchpoint and append the protection changes that stop
+        // watching it to "changes".
+        Error
+        Remove (lldb::addr_t addr, ProtectionChanges &changes);
+
+        // Remove all watchpoints and append the protection changes that
+        // give all pages their permissions back to "changes".
+        void
+        Clear (ProtectionChanges &changes);
+
+        bool
+        IsEmpty () const { return m_watchpoints.empty (); }
+
+        bool
+        IsWatchedPage (lldb::addr_t page_addr) const { return m_pages.count (page_addr) > 0; }
+
+        // The watch flags of all the watchpoints on a page.
+        uint32_t
+        GetPageWatchFlags (lldb::addr_t page_addr) const;
+
+        // The number of pages a watchpoint is on.
+        size_t
+        GetNumPages (const Watchpoint &watchpoint) const;
+
+        const Watchpoint *
+        FindWatchpoint (lldb::addr_t addr) const;
+
+        // Append the watchpoints with bytes in [addr, addr + size) to
+        // "watchpoints", lowest address first.
+        void
+        FindWatchpoints (lldb::addr_t addr, size_t size, std::vector<Watchpoint *> &watchpoints);
+
+        // Count a fault taken on a page against the watchpoints on it.
+        void
+        RecordFault (lldb::addr_t page_addr);
+
+        // A thread is about to access a watched page with its protection
+        // taken off, or is done with it. Returns true, with the change to
+        // make in "change", if the protection of the page has to change.
+        // Pages stay unprotected until the last access that needed them
+        // is done.
+        bool
+        BeginAccess (lldb::addr_t page_addr, ProtectionChange &change);
+
+        bool
+        EndAccess (lldb::addr_t page_addr, ProtectionChange &change);
+
+        // Split [addr, addr + size), a range that currently has "permissions"
+        // throughout, into the ranges of pages that had the same permissions
+        // before they were watched, and append them to "ranges", lowest
+        // address first.
+        void
+        GetUnwatchedRanges (lldb::addr_t addr, size_t size, uint32_t permissions, ProtectionChanges &ranges) const;
+
+        // The permissions a page with "permissions" gets to watch accesses
+        // of "watch_flags".
+        static uint32_t
+        GetWatchedPermissions (uint32_t permissions, uint32_t watch_flags);
+
+    private:
+        struct Page
+        {
+            uint32_t permissions;       // Before the page was watched
+            uint32_t watch_flags;       // Of all the watchpoints on the page
+            uint32_t num_watchpoints;
+            uint32_t num_accesses;      // Accesses in progress that need it unprotected
+        };
+
+        uint32_t
+        GetCurrentPermissions (const Page &page) const;
+
+        static void
+        AppendChange (ProtectionChanges &changes, lldb::addr_t addr, size_t size, uint32_t permissions);
+
+        size_t m_page_size;
+        std::map<lldb::addr_t, Watchpoint> m_watchpoints;
+        std::map<lldb::addr_t, Page> m_pages;
+    };
+}
+
+#endif // ifndef liblldb_NativeSoftwareWatchpointList_h_
@@ -0,0 +1,109 @@
+//===-- NativeTracepointBuffer.h --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeTracepointBuffer_h_
+#define liblldb_NativeTracepointBuffer_h_
+
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+
+#include <deque>
+#include <vector>
+
+namespace lldb_private
+{
+    // Something a tracepoint collects when it is hit: a register, or
+    // "byte_size" bytes at the address that the agent expression bytecode
+    // "address_expr" computes.
+    struct NativeTracepointItem
+    {
+        NativeTracepointItem () :
+            reg_num (UINT32_MAX),
+            byte_size (0),
+            address_expr ()
+        {
+        }
+
+        bool
+        IsRegister () const { return address_expr.empty (); }
+
+        uint32_t reg_num;
+        uint32_t byte_size;
+        std::vector<uint8_t> address_expr;
+    };
+
+    // The data collected by the tracepoints of a process, kept until the
+    // client drains it. When the buffer is full the oldest records are
+    // dropped to make room, so a client that doesn't keep up loses the
+    // start of the trace rather than the process having to stop.
+    //
+    // Not thread safe, the process that owns the buffer serializes the
+    // access to it.
+    class NativeTracepointBuffer
+    {
+    public:
+        struct Record
+        {
+            Record () :
+                tid (LLDB_INVALID_THREAD_ID),
+                addr (LLDB_INVALID_ADDRESS),
+                values (),
+                available ()
+            {
+            }
+
+            size_t
+            GetByteSize () const;
+
+            lldb::tid_t tid;
+            lldb::addr_t addr;
+            // One entry per collected item, in the order of the items.
+            // Items that couldn't be collected are empty and not
+            // "available".
+            std::vector<std::vector<uint8_t>> values;
+            std::vector<bool> available;
+        };
+
+        static const size_t kDefaultCapacity = 4 * 1024 * 1024;
+
+        NativeTracepointBuffer (size_t capacity = kDefaultCapacity);
+
+        void
+        Add (Record &&record);
+
+        // The record that was added first. The buffer must not be empty.
+        const Record &
+        GetOldest () const { return m_records.front (); }
+
+        void
+        RemoveOldest ();
+
+        void
+        Clear ();
+
+        size_t
+        GetNumRecords () const { return m_records.size (); }
+
+        size_t
+        GetByteSize () const { return m_byte_size; }
+
+        // The number of records dropped to make room since the buffer was
+        // created.
+        uint64_t
+        GetNumDropped () const { return m_num_dropped; }
+
+    private:
+        const size_t m_capacity;
+        std::deque<Record> m_records;
+        size_t m_byte_size;
+        uint64_t m_num_dropped;
+    };
+}
+
+#endif // ifndef liblldb_NativeTracepointBuffer_h_
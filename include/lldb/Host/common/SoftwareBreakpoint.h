@@ -13,6 +13,8 @@
 #include "lldb/lldb-private-forward.h"
 #include "NativeBreakpoint.h"
 
+#include <vector>
+
 namespace lldb_private
 {
     class SoftwareBreakpoint : public NativeBreakpoint
@@ -23,6 +25,24 @@ namespace lldb_private
         static Error
         CreateSoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, size_t size_hint, NativeBreakpointSP &breakpoint_spn);
 
+        // Create software breakpoints at all of "addrs" at once. The traps
+        // that are on the same page are read, written and verified with one
+        // request each. "breakpoints" and "errors" get an entry per address,
+        // the breakpoint is only set if there is no error.
+        static void
+        CreateSoftwareBreakpoints (NativeProcessProtocol &process,
+                                   const std::vector<lldb::addr_t> &addrs,
+                                   const std::vector<size_t> &size_hints,
+                                   std::vector<NativeBreakpointSP> &breakpoints,
+                                   std::vector<Error> &errors);
+
+        // Take the traps of enabled software breakpoints out at once, the
+        // same way. "errors" gets an entry per breakpoint.
+        static void
+        RemoveSoftwareBreakpoints (NativeProcessProtocol &process,
+                                   const std::vector<NativeBreakpointSP> &breakpoints,
+                                   std::vector<Error> &errors);
+
         SoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, const uint8_t *saved_opcodes, const uint8_t *trap_opcodes, size_t opcode_size);
 
     protected:
@@ -44,6 +64,9 @@ namespace lldb_private
         uint8_t m_trap_opcodes [MAX_TRAP_OPCODE_SIZE];
         const size_t m_opcode_size;
 
+        static Error
+        GetTrapOpcode (NativeProcessProtocol &process, lldb::addr_t addr, size_t size_hint, size_t &bp_opcode_size, const uint8_t *&bp_opcode_bytes);
+
         static Error
         EnableSoftwareBreakpoint (NativeProcessProtocol &process, lldb::addr_t addr, size_t bp_opcode_size, const uint8_t *bp_opcode_bytes, uint8_t *saved_opcode_bytes);
 
@@ -59,7 +59,7 @@ class ConnectionFileDescriptor : public Connection
     bool InterruptRead() override;
 
     lldb::IOObjectSP
-    GetReadObject()
+    GetReadObject() override
     {
         return m_read_sp;
     }
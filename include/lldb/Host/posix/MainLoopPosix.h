@@ -0,0 +1,131 @@
+//===-- MainLoopPosix.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_Host_posix_MainLoopPosix_h_
+#define lldb_Host_posix_MainLoopPosix_h_
+
+#include <signal.h>
+
+#include <map>
+
+#include "lldb/Host/MainLoopBase.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class MainLoopPosix MainLoopPosix.h "lldb/Host/posix/MainLoopPosix.h"
+/// @brief A main loop that waits on file descriptors and signals.
+///
+/// On Linux the loop is built on epoll, and signals are received through
+/// a signalfd, so the number of descriptors is not limited by FD_SETSIZE
+/// and waiting doesn't get slower as more descriptors are added. Other
+/// hosts use poll() and a self-pipe written from the signal handler.
+//----------------------------------------------------------------------
+class MainLoopPosix : public MainLoopBase
+{
+private:
+    class SignalHandle;
+
+public:
+    typedef std::unique_ptr<SignalHandle> SignalHandleUP;
+
+    MainLoopPosix ();
+
+    ~MainLoopPosix () override;
+
+    ReadHandleUP
+    RegisterReadObject (const lldb::IOObjectSP &object_sp,
+                        const Callback &callback,
+                        Error &error) override;
+
+    //------------------------------------------------------------------
+    /// Call \a callback whenever signal \a signo is received.
+    ///
+    /// On Linux the signal is blocked in the calling thread while it is
+    /// registered, and it must also be blocked in every other thread of
+    /// the process, or it may be delivered to one of those instead. Only
+    /// one callback can be registered for each signal.
+    //------------------------------------------------------------------
+    SignalHandleUP
+    RegisterSignal (int signo, const Callback &callback, Error &error);
+
+    Error
+    Run () override;
+
+    void
+    RequestTermination () override
+    {
+        m_terminate_request = true;
+    }
+
+protected:
+    void
+    UnregisterReadObject (IOObject::WaitableHandle handle) override;
+
+    void
+    UnregisterSignal (int signo);
+
+private:
+    class SignalHandle
+    {
+    public:
+        ~SignalHandle () { m_mainloop.UnregisterSignal (m_signo); }
+
+    private:
+        SignalHandle (MainLoopPosix &mainloop, int signo) :
+            m_mainloop (mainloop),
+            m_signo (signo)
+        {
+        }
+
+        MainLoopPosix &m_mainloop;
+        int m_signo;
+
+        friend class MainLoopPosix;
+        DISALLOW_COPY_AND_ASSIGN (SignalHandle);
+    };
+
+    struct SignalInfo
+    {
+        Callback callback;
+        bool was_blocked;
+#if !defined(__linux__)
+        struct sigaction old_action;
+#endif
+    };
+
+    Error
+    WatchDescriptor (int fd);
+
+    void
+    ProcessReadObject (IOObject::WaitableHandle handle);
+
+    void
+    ProcessSignals ();
+
+    void
+    ProcessSignal (int signo);
+
+    std::map<IOObject::WaitableHandle, Callback> m_read_fds;
+    std::map<int, SignalInfo> m_signals;
+    sigset_t m_signal_set;
+    // On Linux this is the signalfd, elsewhere it is the read end of the
+    // pipe that the signal handler writes to.
+    int m_signal_fd;
+#if defined(__linux__)
+    int m_epoll_fd;
+#else
+    int m_signal_pipe_write_fd;
+#endif
+    bool m_terminate_request;
+};
+
+} // namespace lldb_private
+
+#endif // lldb_Host_posix_MainLoopPosix_h_
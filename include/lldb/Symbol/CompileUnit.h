@@ -245,6 +245,22 @@ public:
     LineTable*
     GetLineTable ();
 
+    //------------------------------------------------------------------
+    /// Get the line table for the compile unit without parsing it.
+    ///
+    /// SymbolFile plug-ins can use this to answer single address
+    /// queries without building the whole line table.
+    ///
+    /// @return
+    ///     The line table object pointer, or NULL if the line table
+    ///     hasn't been parsed yet.
+    //------------------------------------------------------------------
+    LineTable*
+    GetLineTableIfParsed () const
+    {
+        return m_line_table_ap.get();
+    }
+
     //------------------------------------------------------------------
     /// Get the compile unit's support file list.
     ///
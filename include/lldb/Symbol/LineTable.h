@@ -232,6 +232,15 @@ public:
     uint32_t
     GetSize () const;
 
+    //------------------------------------------------------------------
+    /// Get the compile unit this line table belongs to.
+    //------------------------------------------------------------------
+    CompileUnit *
+    GetCompileUnit () const
+    {
+        return m_comp_unit;
+    }
+
     typedef lldb_private::RangeArray<lldb::addr_t, lldb::addr_t, 32> FileAddressRanges;
     
     //------------------------------------------------------------------
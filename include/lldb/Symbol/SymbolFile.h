@@ -12,6 +12,7 @@
 
 #include "lldb/lldb-private.h"
 #include "lldb/Core/PluginInterface.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Symbol/ClangASTType.h"
 #include "lldb/Symbol/ClangNamespaceDecl.h"
 #include "lldb/Symbol/Type.h"
@@ -151,6 +152,33 @@ public:
                                            const ConstString &name,
                                            const ClangNamespaceDecl *parent_namespace_decl) = 0;
 
+    //------------------------------------------------------------------
+    /// Find the compile units whose line tables may refer to a file.
+    ///
+    /// Symbol files that can cheaply index the source files of their
+    /// compile units should override this so that file and line
+    /// lookups don't need to visit every compile unit.
+    ///
+    /// @param[in] file_spec
+    ///     The source file to look for. Only the basename is used so
+    ///     the results must still be matched against the full path.
+    ///
+    /// @param[out] cu_indexes
+    ///     Filled in with the indexes of the compile units that may
+    ///     refer to \a file_spec, in ascending order.
+    ///
+    /// @return
+    ///     \b true if \a cu_indexes contains all compile units that
+    ///     can refer to \a file_spec, \b false if this symbol file
+    ///     has no such index and all compile units must be searched.
+    //------------------------------------------------------------------
+    virtual bool
+    FindCompileUnitsForFile (const FileSpec &file_spec,
+                             std::vector<uint32_t> &cu_indexes)
+    {
+        return false;
+    }
+
     ObjectFile*             GetObjectFile() { return m_obj_file; }
     const ObjectFile*       GetObjectFile() const { return m_obj_file; }
 
@@ -163,6 +191,16 @@ public:
     { 
     }
 
+    //------------------------------------------------------------------
+    /// Add statistics about the work this symbol file has done and the
+    /// memory it uses to \a stats for "statistics dump". This must not
+    /// parse anything that hasn't been parsed yet.
+    //------------------------------------------------------------------
+    virtual void
+    AddStatistics (StructuredData::Dictionary &stats)
+    {
+    }
+
     
 protected:
     ObjectFile*             m_obj_file; // The object file that symbols can be extracted from.
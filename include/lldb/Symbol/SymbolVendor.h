@@ -95,6 +95,10 @@ public:
                           uint32_t resolve_scope,
                           SymbolContextList& sc_list);
 
+    virtual bool
+    FindCompileUnitsForFile (const FileSpec &file_spec,
+                             std::vector<uint32_t> &cu_indexes);
+
     virtual size_t
     FindGlobalVariables (const ConstString &name,
                          const ClangNamespaceDecl *namespace_decl,
@@ -179,6 +183,15 @@ public:
     virtual void
     ClearSymtab ();
 
+    //------------------------------------------------------------------
+    /// Get the time spent parsing the symbol table, in nanoseconds.
+    //------------------------------------------------------------------
+    uint64_t
+    GetSymtabParseTime () const
+    {
+        return m_symtab_parse_time;
+    }
+
     //------------------------------------------------------------------
     /// Notify the SymbolVendor that the file addresses in the Sections
     /// for this module have been changed.
@@ -207,6 +220,8 @@ protected:
     CompileUnits m_compile_units; // The current compile units
     lldb::ObjectFileSP m_objfile_sp;    // Keep a reference to the object file in case it isn't the same as the module object file (debug symbols in a separate file)
     std::unique_ptr<SymbolFile> m_sym_file_ap; // A single symbol file. Subclasses can add more of these if needed.
+    uint64_t m_symtab_parse_time;   // Nanoseconds spent parsing the symbol table
+    bool m_symtab_parsed;
 
 private:
     //------------------------------------------------------------------
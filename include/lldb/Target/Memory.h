@@ -12,6 +12,7 @@
 
 // C Includes
 // C++ Includes
+#include <list>
 #include <map>
 #include <vector>
 
@@ -26,10 +27,37 @@ namespace lldb_private {
     //----------------------------------------------------------------------
     // A class to track memory that was read from a live process between 
     // runs. 
+    //
+    // Memory is cached in fixed-size lines that are evicted in least
+    // recently used order once the cache grows past its byte budget.
+    // Sequential misses grow a read-ahead window so walking through memory
+    // needs fewer round trips to the process. Lines that come from memory
+    // regions that weren't writable when they were read survive stops so
+    // text and constant data don't need to be read again after every step.
     //----------------------------------------------------------------------
     class MemoryCache
     {
     public:
+        struct Statistics
+        {
+            Statistics () :
+                hits (0),
+                misses (0),
+                read_ahead_lines (0),
+                evicted_lines (0),
+                uncached_reads (0),
+                bytes_read (0)
+            {
+            }
+
+            uint64_t hits;              // Cache line lookups that were satisfied by the cache
+            uint64_t misses;            // Cache line lookups that had to read from the process
+            uint64_t read_ahead_lines;  // Extra cache lines read because reads were sequential
+            uint64_t evicted_lines;     // Cache lines removed to stay within the byte budget
+            uint64_t uncached_reads;    // Reads that were too large to go through the cache
+            uint64_t bytes_read;        // Total bytes read from the process
+        };
+
         //------------------------------------------------------------------
         // Constructors and Destructors
         //------------------------------------------------------------------
@@ -40,6 +68,15 @@ namespace lldb_private {
         void
         Clear(bool clear_invalid_ranges = false);
         
+        //------------------------------------------------------------------
+        // Remove all cache lines except the ones that were read from memory
+        // regions that were readable and not writable. Called each time the
+        // process stops. The lines that are kept are checked against the
+        // region info of the new stop before they are used again.
+        //------------------------------------------------------------------
+        void
+        ClearWritableMemory ();
+
         void
         Flush (lldb::addr_t addr, size_t size);
         
@@ -48,6 +85,16 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        // Copy memory into "dst" only if all of it is already in the cache.
+        // This never reads from the process and returns false if any part
+        // of the range would need to be read.
+        //------------------------------------------------------------------
+        bool
+        ReadIfCached (lldb::addr_t addr,
+                      void *dst,
+                      size_t dst_len);
         
         uint32_t
         GetMemoryCacheLineSize() const
@@ -61,17 +108,74 @@ namespace lldb_private {
         bool
         RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size);
 
+        Statistics
+        GetStatistics () const;
+
+        void
+        ResetStatistics ();
+
+        void
+        Dump (Stream &strm) const;
+
     protected:
-        typedef std::map<lldb::addr_t, lldb::DataBufferSP> BlockMap;
+        typedef std::list<lldb::addr_t> LRUList;
+
+        struct CacheLine
+        {
+            lldb::DataBufferSP data_sp;
+            LRUList::iterator lru_pos;
+            lldb::addr_t region_base;   // The region the line was read from
+            lldb::addr_t region_end;
+            bool read_only;
+            bool needs_recheck;         // Kept across a stop, region not checked since
+        };
+
+        typedef std::map<lldb::addr_t, CacheLine> BlockMap;
         typedef RangeArray<lldb::addr_t, lldb::addr_t, 4> InvalidRanges;
+        typedef RangeDataVector<lldb::addr_t, lldb::addr_t, uint32_t> RegionPermissions;
+
+        void
+        UpdateSettings ();
+
+        BlockMap::iterator
+        FillCacheLines (lldb::addr_t line_addr, Error &error);
+
+        void
+        InsertCacheLine (lldb::addr_t line_addr,
+                         const uint8_t *bytes,
+                         size_t byte_size,
+                         lldb::addr_t region_base,
+                         lldb::addr_t region_end,
+                         bool read_only);
+
+        void
+        RemoveCacheLine (BlockMap::iterator pos);
+
+        bool
+        RecheckCacheLine (BlockMap::iterator pos);
+
+        bool
+        GetRegionPermissions (lldb::addr_t addr,
+                              uint32_t &permissions,
+                              lldb::addr_t &region_base,
+                              lldb::addr_t &region_end);
+
         //------------------------------------------------------------------
         // Classes that inherit from MemoryCache can see and modify these
         //------------------------------------------------------------------
         Process &m_process;
         uint32_t m_cache_line_byte_size;
-        Mutex m_mutex;
+        uint64_t m_cache_max_byte_size;     // Byte budget for all cache lines
+        uint64_t m_cache_byte_size;         // Bytes currently held in cache lines
+        mutable Mutex m_mutex;
         BlockMap m_cache;
+        LRUList m_lru;                      // Most recently used cache line first
         InvalidRanges m_invalid_ranges;
+        RegionPermissions m_region_permissions; // Memory regions seen since the last stop
+        bool m_region_info_supported;
+        lldb::addr_t m_read_ahead_addr;     // The line a sequential read would miss on next
+        uint32_t m_read_ahead_lines;        // The number of lines to read on the next sequential miss
+        Statistics m_stats;
     private:
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
     };
@@ -0,0 +1,66 @@
+//===-- MemoryReadRange.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_MemoryReadRange_h
+#define lldb_MemoryReadRange_h
+
+#include <vector>
+
+#include "lldb/lldb-private.h"
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private
+{
+    //----------------------------------------------------------------------
+    // One entry in a vectored memory read. The caller fills in the address
+    // and size, the reader fills in "data_sp" with the bytes that were read
+    // (which can be shorter than "size" if only part of the range could be
+    // read) and "error" if nothing could be read.
+    //----------------------------------------------------------------------
+    struct MemoryReadRange
+    {
+        MemoryReadRange () :
+            addr (LLDB_INVALID_ADDRESS),
+            size (0),
+            data_sp (),
+            error ()
+        {
+        }
+
+        MemoryReadRange (lldb::addr_t a, size_t s) :
+            addr (a),
+            size (s),
+            data_sp (),
+            error ()
+        {
+        }
+
+        size_t
+        GetBytesRead () const
+        {
+            return data_sp ? data_sp->GetByteSize() : 0;
+        }
+
+        bool
+        Succeeded () const
+        {
+            return GetBytesRead() == size;
+        }
+
+        lldb::addr_t addr;
+        size_t size;
+        lldb::DataBufferSP data_sp;
+        Error error;
+    };
+
+    typedef std::vector<MemoryReadRange> MemoryReadRanges;
+}
+
+#endif // #ifndef lldb_MemoryReadRange_h
@@ -10,6 +10,9 @@
 #ifndef lldb_MemoryRegionInfo_h
 #define lldb_MemoryRegionInfo_h
 
+#include <algorithm>
+#include <vector>
+
 #include "lldb/Core/RangeMap.h"
 #include "lldb/Utility/Range.h"
 
@@ -92,6 +95,69 @@ namespace lldb_private
         {
             m_execute = val;
         }
+
+        bool
+        operator == (const MemoryRegionInfo &rhs) const
+        {
+            return m_range == rhs.m_range &&
+                   m_read == rhs.m_read &&
+                   m_write == rhs.m_write &&
+                   m_execute == rhs.m_execute;
+        }
+
+        bool
+        operator != (const MemoryRegionInfo &rhs) const
+        {
+            return !(*this == rhs);
+        }
+
+        //------------------------------------------------------------------
+        /// Find the region that contains \a load_addr in a memory map.
+        ///
+        /// @param[in] regions
+        ///     The mapped regions of a process, sorted by address and not
+        ///     overlapping.
+        ///
+        /// @param[in] load_addr
+        ///     The address to look up.
+        ///
+        /// @param[out] region_info
+        ///     The mapped region that contains \a load_addr, or if it isn't
+        ///     mapped, a region with no permissions from \a load_addr up to
+        ///     the next mapped region.
+        ///
+        /// @return
+        ///     False if \a load_addr comes after the last mapped region.
+        //------------------------------------------------------------------
+        static bool
+        FindRegion (const std::vector<MemoryRegionInfo> &regions,
+                    lldb::addr_t load_addr,
+                    MemoryRegionInfo &region_info)
+        {
+            // Find the first region that starts after the address, the one
+            // before it is the only one that can contain it.
+            auto pos = std::upper_bound (regions.begin(),
+                                         regions.end(),
+                                         load_addr,
+                                         [] (lldb::addr_t addr, const MemoryRegionInfo &region) -> bool
+                                         {
+                                             return addr < region.GetRange().GetRangeBase();
+                                         });
+            if (pos != regions.begin() && (pos - 1)->GetRange().Contains (load_addr))
+            {
+                region_info = *(pos - 1);
+                return true;
+            }
+            if (pos == regions.end())
+                return false;
+
+            region_info.GetRange().SetRangeBase (load_addr);
+            region_info.GetRange().SetByteSize (pos->GetRange().GetRangeBase() - load_addr);
+            region_info.SetReadable (eNo);
+            region_info.SetWritable (eNo);
+            region_info.SetExecutable (eNo);
+            return true;
+        }
         
     protected:
         RangeType m_range;
@@ -28,6 +28,7 @@
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Host/FileSpec.h"
+#include "lldb/Host/MainLoop.h"
 #include "lldb/Host/Mutex.h"
 
 // TODO pull NativeDelegate class out of NativeProcessProtocol so we
@@ -953,6 +954,12 @@ class ModuleCache;
         ///     inferior.  Must outlive the NativeProcessProtocol
         ///     instance.
         ///
+        /// @param[in] mainloop
+        ///     The main loop that will deliver the inferior's events.
+        ///     The process must only be used on the thread that runs
+        ///     it, and it must outlive the NativeProcessProtocol
+        ///     instance.
+        ///
         /// @param[out] process_sp
         ///     On successful return from the method, this parameter
         ///     contains the shared pointer to the
@@ -967,6 +974,7 @@ class ModuleCache;
         LaunchNativeProcess (
             ProcessLaunchInfo &launch_info,
             lldb_private::NativeProcessProtocol::NativeDelegate &native_delegate,
+            MainLoop &mainloop,
             NativeProcessProtocolSP &process_sp);
 
         //------------------------------------------------------------------
@@ -983,6 +991,12 @@ class ModuleCache;
         ///     inferior.  Must outlive the NativeProcessProtocol
         ///     instance.
         ///
+        /// @param[in] mainloop
+        ///     The main loop that will deliver the inferior's events.
+        ///     The process must only be used on the thread that runs
+        ///     it, and it must outlive the NativeProcessProtocol
+        ///     instance.
+        ///
         /// @param[out] process_sp
         ///     On successful return from the method, this parameter
         ///     contains the shared pointer to the
@@ -996,6 +1010,7 @@ class ModuleCache;
         virtual Error
         AttachNativeProcess (lldb::pid_t pid,
                              lldb_private::NativeProcessProtocol::NativeDelegate &native_delegate,
+                             MainLoop &mainloop,
                              NativeProcessProtocolSP &process_sp);
 
     protected:
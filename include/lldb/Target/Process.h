@@ -18,6 +18,7 @@
 // C++ Includes
 #include <list>
 #include <iosfwd>
+#include <map>
 #include <vector>
 
 // Other libraries and framework includes
@@ -28,19 +29,23 @@
 #include "lldb/Core/Communication.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Event.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Core/ThreadSafeValue.h"
 #include "lldb/Core/PluginInterface.h"
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Breakpoint/BreakpointSiteList.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/Host/ProcessRunLock.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/Memory.h"
+#include "lldb/Target/MemoryReadRange.h"
 #include "lldb/Target/ProcessInfo.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
 #include "lldb/Target/QueueList.h"
 #include "lldb/Target/ThreadList.h"
+#include "lldb/Target/TracepointRecord.h"
 #include "lldb/Target/InstrumentationRuntime.h"
 
 namespace lldb_private {
@@ -66,6 +71,9 @@ public:
     uint64_t
     GetMemoryCacheLineSize () const;
 
+    uint64_t
+    GetMemoryCacheSize () const;
+
     Args
     GetExtraStartupCommands () const;
 
@@ -856,6 +864,16 @@ public:
                 return m_interrupted;
             }
 
+            //------------------------------------------------------------------
+            /// The time the state change happened, used to measure how long
+            /// it takes to present a stop to the user.
+            //------------------------------------------------------------------
+            const TimeValue &
+            GetCreateTime () const
+            {
+                return m_create_time;
+            }
+
             virtual void
             Dump (Stream *s) const;
 
@@ -924,6 +942,7 @@ public:
             bool m_restarted;  // For "eStateStopped" events, this is true if the target was automatically restarted.
             int m_update_state;
             bool m_interrupted;
+            TimeValue m_create_time;
             DISALLOW_COPY_AND_ASSIGN (ProcessEventData);
 
     };
@@ -2023,6 +2042,21 @@ public:
         return true;
     }
 
+    //------------------------------------------------------------------
+    /// Check if the process plugin can step a thread over a software
+    /// breakpoint without removing the breakpoint, for example by
+    /// executing a copy of the instruction somewhere else.
+    ///
+    /// @return
+    ///     true if a thread can be stepped over an enabled breakpoint
+    ///     while the other threads keep running.
+    //------------------------------------------------------------------
+    virtual bool
+    SupportsDisplacedStepping ()
+    {
+        return false;
+    }
+
     //------------------------------------------------------------------
     /// Actually do the reading of memory from a process.
     ///
@@ -2051,6 +2085,24 @@ public:
                   size_t size,
                   Error &error) = 0;
 
+    //------------------------------------------------------------------
+    /// Actually do the reading of several memory ranges from a process.
+    ///
+    /// Subclasses that can read many ranges in a single request to the
+    /// process should override this. For each range this must fill in
+    /// MemoryReadRange::data_sp with the bytes that were read, which
+    /// may be fewer than requested, or set MemoryReadRange::error if
+    /// nothing could be read. Breakpoint opcodes don't need to be
+    /// removed from the results.
+    ///
+    /// The default implementation reads each range with DoReadMemory.
+    ///
+    /// @param[in,out] ranges
+    ///     The ranges to read.
+    //------------------------------------------------------------------
+    virtual void
+    DoReadMemoryRanges (MemoryReadRanges &ranges);
+
     //------------------------------------------------------------------
     /// Read of memory from a process.
     ///
@@ -2147,7 +2199,45 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Read several, possibly scattered, ranges of memory at once.
+    ///
+    /// Ranges that are already in the memory cache are served from it
+    /// and all others are handed to DoReadMemoryRanges() together so
+    /// that process plug-ins can read them in as few requests as they
+    /// are able to. As with ReadMemory(), any traps that were inserted
+    /// into the memory are removed from the results.
+    ///
+    /// @param[in,out] ranges
+    ///     The ranges to read. On return each range has its data_sp
+    ///     filled in with the bytes that could be read and its error
+    ///     set if the range couldn't be read completely.
+    ///
+    /// @return
+    ///     The number of ranges that were read completely.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryRanges (MemoryReadRanges &ranges);
     
+    //------------------------------------------------------------------
+    /// Get the cache that ReadMemory() reads through.
+    //------------------------------------------------------------------
+    MemoryCache &
+    GetMemoryCache ()
+    {
+        return m_memory_cache;
+    }
+
+    //------------------------------------------------------------------
+    /// Add statistics about the work done for this process to the
+    /// dictionary reported by "statistics dump". Subclasses should call
+    /// through to this and add their own statistics, like the number of
+    /// packets sent to a remote stub.
+    //------------------------------------------------------------------
+    virtual void
+    AddStatistics (StructuredData::Dictionary &dict);
+
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
     /// process memory.
@@ -2624,6 +2714,69 @@ public:
     virtual Error
     DisableSoftwareBreakpoint (BreakpointSite *bp_site);
 
+    //------------------------------------------------------------------
+    /// Enable and disable the breakpoint sites of a batch when it ends.
+    /// Process plug-ins that can change many breakpoints with one request
+    /// override this. The default calls DisableBreakpointSite() and
+    /// EnableBreakpointSite() for each site.
+    ///
+    /// @param[out] enable_errors
+    ///     An error per site in \a enable_sites, set for the sites that
+    ///     couldn't be enabled.
+    //------------------------------------------------------------------
+    virtual void
+    UpdateBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &enable_sites,
+                           const std::vector<lldb::BreakpointSiteSP> &disable_sites,
+                           std::vector<Error> &enable_errors);
+
+    // Called when the owners of an enabled breakpoint site, or the
+    // conditions or tracepoint collect lists of its owners, change.
+    // Process plug-ins that have the conditions evaluated or the
+    // tracepoint data collected where the breakpoint is hit override this
+    // to send the new ones.
+    virtual void
+    BreakpointSiteConditionsChanged (BreakpointSite *bp_site)
+    {
+    }
+
+    //------------------------------------------------------------------
+    /// Tracepoints are breakpoints whose options have a collect list.
+    /// Process plug-ins that support them have the data collected where
+    /// the process runs, without reporting the hits.
+    ///
+    /// @return
+    ///     True if the data of the tracepoints that own \a bp_site is
+    ///     collected that way, so hits that are reported anyway mustn't
+    ///     stop. False if the tracepoints have to behave as breakpoints.
+    //------------------------------------------------------------------
+    virtual bool
+    CollectsTracepointData (BreakpointSite *bp_site)
+    {
+        return false;
+    }
+
+    //------------------------------------------------------------------
+    /// Move the data the tracepoints collected since the last call out of
+    /// the process.
+    ///
+    /// @param[out] records
+    ///     The collected records are appended, oldest first.
+    ///
+    /// @param[out] num_dropped
+    ///     The number of records that had to be dropped since the process
+    ///     started because they weren't fetched in time.
+    ///
+    /// @return
+    ///     An error if the process plug-in doesn't collect tracepoint data.
+    //------------------------------------------------------------------
+    virtual Error
+    GetTracepointData (TracepointRecords &records, uint64_t &num_dropped)
+    {
+        Error error;
+        error.SetErrorString ("tracepoints are not supported by this process");
+        return error;
+    }
+
     BreakpointSiteList &
     GetBreakpointSiteList();
 
@@ -2654,6 +2807,56 @@ public:
                                    lldb::user_id_t owner_loc_id,
                                    lldb::BreakpointSiteSP &bp_site_sp);
 
+    //------------------------------------------------------------------
+    /// Breakpoint sites that are created or lose their last owner
+    /// between BeginBreakpointSiteBatch() and EndBreakpointSiteBatch()
+    /// are enabled and disabled together by UpdateBreakpointSites() when
+    /// the outermost batch ends. Until then new sites are given to their
+    /// owners as if they were enabled, and are taken away again if they
+    /// can't be.
+    ///
+    /// A batch belongs to the thread that began it. Sites changed by other
+    /// threads while it is in progress are enabled and disabled right
+    /// away.
+    ///
+    /// @return
+    ///     False if another thread's batch is in progress, in which case
+    ///     no batch was begun and EndBreakpointSiteBatch() must not be
+    ///     called.
+    //------------------------------------------------------------------
+    bool
+    BeginBreakpointSiteBatch ();
+
+    void
+    EndBreakpointSiteBatch ();
+
+    //------------------------------------------------------------------
+    /// A breakpoint site batch that lasts as long as this is in scope.
+    //------------------------------------------------------------------
+    class BreakpointSiteBatch
+    {
+    public:
+        BreakpointSiteBatch (const lldb::ProcessSP &process_sp) :
+            m_process_sp (process_sp),
+            m_began (false)
+        {
+            if (m_process_sp)
+                m_began = m_process_sp->BeginBreakpointSiteBatch ();
+        }
+
+        ~BreakpointSiteBatch ()
+        {
+            if (m_began)
+                m_process_sp->EndBreakpointSiteBatch ();
+        }
+
+    private:
+        lldb::ProcessSP m_process_sp;
+        bool m_began;
+
+        DISALLOW_COPY_AND_ASSIGN (BreakpointSiteBatch);
+    };
+
     //----------------------------------------------------------------------
     // Process Watchpoints (optional)
     //----------------------------------------------------------------------
@@ -2663,6 +2866,30 @@ public:
     virtual Error
     DisableWatchpoint (Watchpoint *wp, bool notify = true);
 
+    //------------------------------------------------------------------
+    /// Get the cost of a watchpoint that the process watches by
+    /// protecting the pages it is on rather than with a debug register.
+    ///
+    /// @param[out] num_pages
+    ///     The number of pages the watchpoint is on.
+    ///
+    /// @param[out] num_faults
+    ///     The accesses to those pages that stopped the process.
+    ///
+    /// @param[out] num_hits
+    ///     The faults that hit the watchpoint.
+    ///
+    /// @return
+    ///     An error if the watchpoint uses a debug register.
+    //------------------------------------------------------------------
+    virtual Error
+    GetWatchpointOverhead (Watchpoint *wp, uint32_t &num_pages, uint64_t &num_faults, uint64_t &num_hits)
+    {
+        Error error;
+        error.SetErrorString ("Process::GetWatchpointOverhead() not supported");
+        return error;
+    }
+
     //------------------------------------------------------------------
     // Thread Queries
     //------------------------------------------------------------------
@@ -3172,6 +3399,11 @@ protected:
     std::vector<lldb::addr_t>   m_image_tokens;
     Listener                    &m_listener;
     BreakpointSiteList          m_breakpoint_site_list; ///< This is the list of breakpoint locations we intend to insert in the target.
+    Mutex                       m_breakpoint_site_batch_mutex; ///< Guards the breakpoint site batch state, held while sites are created, lose owners or a batch ends
+    lldb::tid_t                 m_breakpoint_site_batch_tid;   ///< The thread whose breakpoint site batch is in progress
+    uint32_t                    m_breakpoint_site_batch_depth; ///< The number of breakpoint site batches in progress
+    std::map<lldb::addr_t, lldb::BreakpointSiteSP> m_batched_enable_sites;  ///< Sites created in the current batch
+    std::map<lldb::addr_t, lldb::BreakpointSiteSP> m_batched_disable_sites; ///< Sites that lost their last owner in the current batch
     lldb::DynamicLoaderUP       m_dyld_ap;
     lldb::JITLoaderListUP       m_jit_loaders_ap;
     lldb::DynamicCheckerFunctionsUP m_dynamic_checkers_ap; ///< The functions used by the expression parser to validate data that expressions use.
@@ -3308,6 +3540,11 @@ private:
     // For Process only
     //------------------------------------------------------------------
     void ControlPrivateStateThread (uint32_t signal);
+
+    // Whether failures to set breakpoint sites are worth a warning in the
+    // current state.
+    bool
+    ShouldReportBreakpointSiteErrors ();
     
     DISALLOW_COPY_AND_ASSIGN (Process);
 
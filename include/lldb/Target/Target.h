@@ -23,7 +23,9 @@
 #include "lldb/Core/Broadcaster.h"
 #include "lldb/Core/Disassembler.h"
 #include "lldb/Core/ModuleList.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Core/UserSettingsController.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Target/ExecutionContextScope.h"
 #include "lldb/Target/PathMappingList.h"
 #include "lldb/Target/ProcessLaunchInfo.h"
@@ -1434,6 +1436,81 @@ public:
     ClangModulesDeclVendor *
     GetClangModulesDeclVendor ();
 
+    //------------------------------------------------------------------
+    /// @class Statistics Target.h "lldb/Target/Target.h"
+    /// @brief Timings of the work done for a target, reported by
+    /// "statistics dump".
+    //------------------------------------------------------------------
+    class Statistics
+    {
+    public:
+        enum Duration
+        {
+            eDurationExpressionParse = 0,   // Parsing expressions with clang
+            eDurationExpressionJIT,         // Generating code for and preparing parsed expressions
+            eDurationExpressionRun,         // Running expressions in the inferior
+            eDurationBreakpointResolve,     // Resolving breakpoints in modules
+            eDurationStopToPrompt,          // From the process stopping to the stop being displayed
+            kNumDurations
+        };
+
+        //--------------------------------------------------------------
+        /// Adds the time from construction to destruction to a duration.
+        //--------------------------------------------------------------
+        class ScopedDuration
+        {
+        public:
+            ScopedDuration (Target *target, Duration duration);
+
+            ~ScopedDuration ();
+
+        private:
+            Target *m_target;
+            Duration m_duration;
+            TimeValue m_start;
+
+            DISALLOW_COPY_AND_ASSIGN (ScopedDuration);
+        };
+
+        Statistics ();
+
+        void
+        AddDuration (Duration duration, uint64_t nanoseconds);
+
+        void
+        Reset ();
+
+        //--------------------------------------------------------------
+        /// Add the count, total and maximum time of each duration.
+        //--------------------------------------------------------------
+        void
+        AddToDictionary (StructuredData::Dictionary &dict) const;
+
+    private:
+        struct DurationStats
+        {
+            uint64_t count;
+            uint64_t total;     // Nanoseconds
+            uint64_t max;       // Nanoseconds
+        };
+
+        mutable Mutex m_mutex;
+        DurationStats m_durations[kNumDurations];
+    };
+
+    Statistics &
+    GetStatistics ()
+    {
+        return m_stats;
+    }
+
+    //------------------------------------------------------------------
+    /// Report what this target's modules, process, expressions and
+    /// breakpoints have cost so it can be seen why a session was slow.
+    //------------------------------------------------------------------
+    StructuredData::DictionarySP
+    ReportStatistics ();
+
     //------------------------------------------------------------------
     // Methods.
     //------------------------------------------------------------------
@@ -1481,6 +1558,7 @@ protected:
     bool                    m_valid;
     bool                    m_suppress_stop_hooks;
     bool                    m_is_dummy_target;
+    Statistics              m_stats;
     
     static void
     ImageSearchPathsChanged (const PathMappingList &path_list,
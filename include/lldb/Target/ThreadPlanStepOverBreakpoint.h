@@ -53,6 +53,7 @@ private:
     lldb::user_id_t m_breakpoint_site_id;
     bool m_auto_continue;
     bool m_reenabled_breakpoint_site;
+    bool m_use_displaced_step;          // The process steps over the breakpoint with its trap still inserted
 
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanStepOverBreakpoint);
 
@@ -0,0 +1,66 @@
+//===-- TracepointRecord.h --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_TracepointRecord_h
+#define lldb_TracepointRecord_h
+
+#include <string>
+#include <vector>
+
+#include "lldb/lldb-private.h"
+#include "lldb/Core/DataBuffer.h"
+
+namespace lldb_private
+{
+    //----------------------------------------------------------------------
+    // The data a tracepoint collected for one hit. There is one value per
+    // item of the breakpoint's collect list, in that order, named after
+    // the item. Values that couldn't be collected have no data. Memory
+    // and registers are in the byte order of the target.
+    //----------------------------------------------------------------------
+    struct TracepointRecord
+    {
+        struct Value
+        {
+            Value () :
+                name (),
+                data_sp ()
+            {
+            }
+
+            bool
+            IsAvailable () const
+            {
+                return data_sp.get() != nullptr;
+            }
+
+            std::string name;
+            lldb::DataBufferSP data_sp;
+        };
+
+        TracepointRecord () :
+            break_id (LLDB_INVALID_BREAK_ID),
+            loc_id (LLDB_INVALID_BREAK_ID),
+            tid (LLDB_INVALID_THREAD_ID),
+            addr (LLDB_INVALID_ADDRESS),
+            values ()
+        {
+        }
+
+        lldb::break_id_t break_id;
+        lldb::break_id_t loc_id;
+        lldb::tid_t tid;
+        lldb::addr_t addr;
+        std::vector<Value> values;
+    };
+
+    typedef std::vector<TracepointRecord> TracepointRecords;
+}
+
+#endif // #ifndef lldb_TracepointRecord_h
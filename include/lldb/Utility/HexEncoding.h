@@ -0,0 +1,89 @@
+//===-- HexEncoding.h -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_HexEncoding_h_
+#define utility_HexEncoding_h_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class HexEncoding HexEncoding.h "lldb/Utility/HexEncoding.h"
+/// @brief Bulk conversion between bytes and ASCII hex.
+///
+/// Memory and register contents go over the gdb-remote protocol as hex,
+/// so at high packet rates converting them shows up in profiles of both
+/// lldb and lldb-server. These routines convert 16 bytes at a time with
+/// SSE2 when it is available and fall back to table lookups otherwise.
+//----------------------------------------------------------------------
+class HexEncoding
+{
+public:
+    //------------------------------------------------------------------
+    /// Convert a single ASCII hex digit to its value.
+    ///
+    /// @return
+    ///     The value of \a ch, or -1 if \a ch isn't a hex digit.
+    //------------------------------------------------------------------
+    static int
+    DecodeDigit (char ch)
+    {
+        return g_digit_values[(uint8_t)ch];
+    }
+
+    //------------------------------------------------------------------
+    /// Encode bytes as lower case hex.
+    ///
+    /// @param[in] src
+    ///     The bytes to encode.
+    ///
+    /// @param[in] src_len
+    ///     The number of bytes to encode.
+    ///
+    /// @param[out] dst
+    ///     A buffer with room for 2 * \a src_len characters. It isn't
+    ///     NULL terminated.
+    //------------------------------------------------------------------
+    static void
+    Encode (const void *src, size_t src_len, char *dst);
+
+    //------------------------------------------------------------------
+    /// Decode pairs of hex digits into bytes.
+    ///
+    /// Decoding stops at the first pair that isn't two hex digits, at
+    /// the end of \a src or when \a dst is full, whichever comes first.
+    ///
+    /// @param[in] src
+    ///     The characters to decode.
+    ///
+    /// @param[in] src_len
+    ///     The number of characters in \a src.
+    ///
+    /// @param[out] dst
+    ///     The buffer to decode into.
+    ///
+    /// @param[in] dst_len
+    ///     The size of \a dst in bytes.
+    ///
+    /// @return
+    ///     The number of bytes that were decoded. Twice as many
+    ///     characters were consumed from \a src.
+    //------------------------------------------------------------------
+    static size_t
+    Decode (const char *src, size_t src_len, void *dst, size_t dst_len);
+
+private:
+    static const int8_t g_digit_values[256];
+};
+
+} // namespace lldb_private
+
+#endif // utility_HexEncoding_h_
@@ -610,6 +610,7 @@ namespace lldb {
         eSectionTypeELFDynamicLinkInfo,   // Elf SHT_DYNAMIC section
         eSectionTypeEHFrame,
         eSectionTypeCompactUnwind,        // compact unwind section in Mach-O, __TEXT,__unwind_info
+        eSectionTypeGNUDebugData,         // Elf .gnu_debugdata section, LZMA compressed MiniDebugInfo ELF file
         eSectionTypeOther
     };
 
@@ -115,6 +115,7 @@ class   IRExecutionUnit;
 class   JITLoader;
 class   JITLoaderList;
 class   LanguageRuntime;
+class   MemoryReadRangeListImpl;
 class   MemoryRegionInfo;
 class   LineTable;
 class   Listener;
@@ -244,6 +245,7 @@ class   ThreadPlanStepThrough;
 class   ThreadPlanTracer;
 class   ThreadSpec;
 class   TimeValue;
+class   TracepointRecordListImpl;
 class   Type;
 class   TypeAndOrName;
 class   TypeCategoryMap;
@@ -104,6 +104,7 @@ HEADER_FILES="${SRC_ROOT}/include/lldb/lldb.h"\
 " ${SRC_ROOT}/include/lldb/API/SBLaunchInfo.h"\
 " ${SRC_ROOT}/include/lldb/API/SBLineEntry.h"\
 " ${SRC_ROOT}/include/lldb/API/SBListener.h"\
+" ${SRC_ROOT}/include/lldb/API/SBMemoryReadRangeList.h"\
 " ${SRC_ROOT}/include/lldb/API/SBModule.h"\
 " ${SRC_ROOT}/include/lldb/API/SBModuleSpec.h"\
 " ${SRC_ROOT}/include/lldb/API/SBProcess.h"\
@@ -119,6 +120,7 @@ HEADER_FILES="${SRC_ROOT}/include/lldb/lldb.h"\
 " ${SRC_ROOT}/include/lldb/API/SBThread.h"\
 " ${SRC_ROOT}/include/lldb/API/SBThreadCollection.h"\
 " ${SRC_ROOT}/include/lldb/API/SBThreadPlan.h"\
+" ${SRC_ROOT}/include/lldb/API/SBTracepointRecordList.h"\
 " ${SRC_ROOT}/include/lldb/API/SBType.h"\
 " ${SRC_ROOT}/include/lldb/API/SBTypeCategory.h"\
 " ${SRC_ROOT}/include/lldb/API/SBTypeFilter.h"\
@@ -159,6 +161,7 @@ INTERFACE_FILES="${SRC_ROOT}/scripts/interface/SBAddress.i"\
 " ${SRC_ROOT}/scripts/interface/SBLaunchInfo.i"\
 " ${SRC_ROOT}/scripts/interface/SBLineEntry.i"\
 " ${SRC_ROOT}/scripts/interface/SBListener.i"\
+" ${SRC_ROOT}/scripts/interface/SBMemoryReadRangeList.i"\
 " ${SRC_ROOT}/scripts/interface/SBModule.i"\
 " ${SRC_ROOT}/scripts/interface/SBModuleSpec.i"\
 " ${SRC_ROOT}/scripts/interface/SBPlatform.i"\
@@ -174,6 +177,7 @@ INTERFACE_FILES="${SRC_ROOT}/scripts/interface/SBAddress.i"\
 " ${SRC_ROOT}/scripts/interface/SBThread.i"\
 " ${SRC_ROOT}/scripts/interface/SBThreadCollection.i"\
 " ${SRC_ROOT}/scripts/interface/SBThreadPlan.i"\
+" ${SRC_ROOT}/scripts/interface/SBTracepointRecordList.i"\
 " ${SRC_ROOT}/scripts/interface/SBType.i"\
 " ${SRC_ROOT}/scripts/interface/SBTypeCategory.i"\
 " ${SRC_ROOT}/scripts/interface/SBTypeFilter.i"\
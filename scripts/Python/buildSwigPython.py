@@ -101,6 +101,7 @@ def get_header_files( vDictArgs ):
 						"/include/lldb/API/SBLaunchInfo.h",
 						"/include/lldb/API/SBLineEntry.h",
 						"/include/lldb/API/SBListener.h",
+						"/include/lldb/API/SBMemoryReadRangeList.h",
 						"/include/lldb/API/SBModule.h",
 						"/include/lldb/API/SBModuleSpec.h",
 						"/include/lldb/API/SBProcess.h",
@@ -113,6 +114,7 @@ def get_header_files( vDictArgs ):
 						"/include/lldb/API/SBTarget.h",
 						"/include/lldb/API/SBThread.h",
 						"/include/lldb/API/SBThreadCollection.h",
+						"/include/lldb/API/SBTracepointRecordList.h",
 						"/include/lldb/API/SBType.h",
 						"/include/lldb/API/SBTypeCategory.h",
 						"/include/lldb/API/SBTypeFilter.h",
@@ -180,6 +182,7 @@ def get_interface_files( vDictArgs ):
 						"/scripts/interface/SBLaunchInfo.i",
 						"/scripts/interface/SBLineEntry.i",
 						"/scripts/interface/SBListener.i",
+						"/scripts/interface/SBMemoryReadRangeList.i",
 						"/scripts/interface/SBModule.i",
 						"/scripts/interface/SBModuleSpec.i",
 						"/scripts/interface/SBProcess.i",
@@ -191,6 +194,7 @@ def get_interface_files( vDictArgs ):
 						"/scripts/interface/SBTarget.i",
 						"/scripts/interface/SBThread.i",
 						"/scripts/interface/SBThreadCollection.i",
+						"/scripts/interface/SBTracepointRecordList.i",
 						"/scripts/interface/SBType.i",
 						"/scripts/interface/SBTypeCategory.i",
 						"/scripts/interface/SBTypeFilter.i",
@@ -153,6 +153,23 @@ public:
     const char *
     GetCondition ();
 
+    %feature("docstring", "
+    //------------------------------------------------------------------
+    /// Make the breakpoint a tracepoint that collects the given registers
+    /// ('$pc'), variables or memory ('<address>@<byte-size>') on each hit
+    /// instead of stopping, or a breakpoint again if the list is empty.
+    /// Get the data with SBProcess.GetTracepointData().
+    //------------------------------------------------------------------
+    ") SetTracepointCollect;
+    void
+    SetTracepointCollect (SBStringList &collect);
+
+    void
+    GetTracepointCollect (SBStringList &collect);
+
+    bool
+    IsTracepoint ();
+
     void
     SetThreadID (lldb::tid_t sb_thread_id);
 
@@ -313,6 +313,13 @@ public:
     bool
     GetDescription (lldb::SBStream &description);
 
+    %feature("docstring", "
+    Get the statistics of all targets as JSON, the same as what the
+    'statistics dump --all-targets' command prints.
+    ") GetStatistics;
+    bool
+    GetStatistics (lldb::SBStream &stats);
+
     uint32_t
     GetTerminalWidth () const;
 
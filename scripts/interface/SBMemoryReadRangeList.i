@@ -0,0 +1,63 @@
+//===-- SWIG Interface for SBMemoryReadRangeList ----------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+namespace lldb {
+
+%feature("docstring",
+"Represents a list of memory ranges to be read at once with
+SBProcess.ReadMemoryRanges().
+
+Append the address and size of each range, read them, and then get the
+bytes and the error for each range by index. For example,
+
+    ranges = lldb.SBMemoryReadRangeList()
+    for node_addr in node_addrs:
+        ranges.Append(node_addr, 16)
+    error = lldb.SBError()
+    num_read = process.ReadMemoryRanges(ranges, error)
+    for i in range(ranges.GetSize()):
+        if ranges.GetErrorAtIndex(i).Success():
+            data = ranges.GetDataAtIndex(i)
+            ...
+") SBMemoryReadRangeList;
+class SBMemoryReadRangeList
+{
+public:
+    SBMemoryReadRangeList ();
+
+    SBMemoryReadRangeList (const lldb::SBMemoryReadRangeList &rhs);
+
+    ~SBMemoryReadRangeList ();
+
+    uint32_t
+    GetSize () const;
+
+    void
+    Append (lldb::addr_t addr, size_t size);
+
+    void
+    Clear ();
+
+    lldb::addr_t
+    GetAddressAtIndex (uint32_t idx) const;
+
+    size_t
+    GetByteSizeAtIndex (uint32_t idx) const;
+
+    lldb::SBData
+    GetDataAtIndex (uint32_t idx) const;
+
+    lldb::SBError
+    GetErrorAtIndex (uint32_t idx) const;
+
+    bool
+    GetDescription (lldb::SBStream &description) const;
+};
+
+} // namespace lldb
@@ -268,6 +268,27 @@ public:
     size_t
     ReadMemory (addr_t addr, void *buf, size_t size, lldb::SBError &error);
 
+    %feature("autodoc", "
+    Reads all of the ranges in an SBMemoryReadRangeList at once and removes
+    any traps that may have been inserted into the memory. Returns the number
+    of ranges that were read completely. Example:
+
+    ranges = lldb.SBMemoryReadRangeList()
+    ranges.Append(addr1, 8)
+    ranges.Append(addr2, 16)
+    num_read = process.ReadMemoryRanges(ranges, error)
+    data = ranges.GetDataAtIndex(1)
+    ") ReadMemoryRanges;
+    size_t
+    ReadMemoryRanges (lldb::SBMemoryReadRangeList &ranges, lldb::SBError &error);
+
+    %feature("autodoc", "
+    Appends the data the tracepoints collected since the last call to an
+    SBTracepointRecordList. This works while the process is running.
+    ") GetTracepointData;
+    lldb::SBError
+    GetTracepointData (lldb::SBTracepointRecordList &records);
+
     %feature("autodoc", "
     Writes memory to the current process's address space and maintains any
     traps that might be present due to software breakpoints. Example:
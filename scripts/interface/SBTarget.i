@@ -722,6 +722,13 @@ public:
 
     bool
     GetDescription (lldb::SBStream &description, lldb::DescriptionLevel description_level);
+
+    %feature("docstring", "
+    Get the statistics of the work done for this target as JSON, the
+    same as what the 'statistics dump' command prints.
+    ") GetStatistics;
+    bool
+    GetStatistics (lldb::SBStream &stats);
     
     lldb::addr_t
     GetStackRedZoneSize();
@@ -0,0 +1,75 @@
+//===-- SWIG Interface for SBTracepointRecordList ---------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+namespace lldb {
+
+%feature("docstring",
+"Represents the data tracepoints collected, as fetched with
+SBProcess.GetTracepointData().
+
+Each record is one hit of a tracepoint location and has one value per item
+of the collect list of the tracepoint. For example,
+
+    bp = target.BreakpointCreateByName('handle_request')
+    collect = lldb.SBStringList()
+    collect.AppendString('request_id')
+    bp.SetTracepointCollect(collect)
+    process.Continue()
+    ...
+    records = lldb.SBTracepointRecordList()
+    error = process.GetTracepointData(records)
+    for i in range(records.GetSize()):
+        data = records.GetValueDataAtIndex(i, 0)
+        if data.IsValid():
+            ...
+") SBTracepointRecordList;
+class SBTracepointRecordList
+{
+public:
+    SBTracepointRecordList ();
+
+    SBTracepointRecordList (const lldb::SBTracepointRecordList &rhs);
+
+    ~SBTracepointRecordList ();
+
+    uint32_t
+    GetSize () const;
+
+    void
+    Clear ();
+
+    lldb::break_id_t
+    GetBreakpointIDAtIndex (uint32_t idx) const;
+
+    lldb::break_id_t
+    GetLocationIDAtIndex (uint32_t idx) const;
+
+    lldb::tid_t
+    GetThreadIDAtIndex (uint32_t idx) const;
+
+    lldb::addr_t
+    GetAddressAtIndex (uint32_t idx) const;
+
+    uint32_t
+    GetNumValuesAtIndex (uint32_t idx) const;
+
+    const char *
+    GetValueNameAtIndex (uint32_t idx, uint32_t value_idx) const;
+
+    lldb::SBData
+    GetValueDataAtIndex (uint32_t idx, uint32_t value_idx) const;
+
+    uint64_t
+    GetNumDropped () const;
+
+    bool
+    GetDescription (lldb::SBStream &description) const;
+};
+
+} // namespace lldb
@@ -332,6 +332,42 @@ SBBreakpoint::GetCondition ()
     return NULL;
 }
 
+void
+SBBreakpoint::SetTracepointCollect (SBStringList &collect)
+{
+    if (m_opaque_sp)
+    {
+        Mutex::Locker api_locker (m_opaque_sp->GetTarget().GetAPIMutex());
+        StringList collect_list;
+        for (uint32_t i = 0; i < collect.GetSize(); ++i)
+            collect_list.AppendString (collect.GetStringAtIndex(i));
+        m_opaque_sp->SetTracepointCollect (collect_list);
+    }
+}
+
+void
+SBBreakpoint::GetTracepointCollect (SBStringList &collect)
+{
+    if (m_opaque_sp)
+    {
+        Mutex::Locker api_locker (m_opaque_sp->GetTarget().GetAPIMutex());
+        const StringList &collect_list = m_opaque_sp->GetTracepointCollect();
+        for (size_t i = 0; i < collect_list.GetSize(); ++i)
+            collect.AppendString (collect_list.GetStringAtIndex(i));
+    }
+}
+
+bool
+SBBreakpoint::IsTracepoint ()
+{
+    if (m_opaque_sp)
+    {
+        Mutex::Locker api_locker (m_opaque_sp->GetTarget().GetAPIMutex());
+        return m_opaque_sp->IsTracepoint();
+    }
+    return false;
+}
+
 uint32_t
 SBBreakpoint::GetHitCount () const
 {
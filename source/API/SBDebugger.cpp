@@ -1201,6 +1201,16 @@ SBDebugger::GetDescription (SBStream &description)
     return true;
 }
 
+bool
+SBDebugger::GetStatistics (SBStream &stats)
+{
+    if (!m_opaque_sp)
+        return false;
+
+    m_opaque_sp->ReportStatistics (true)->Dump (stats.ref());
+    return true;
+}
+
 user_id_t
 SBDebugger::GetID()
 {
@@ -0,0 +1,148 @@
+//===-- SBMemoryReadRangeList.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/API/SBMemoryReadRangeList.h"
+
+#include <inttypes.h>
+
+#include "lldb/API/SBStream.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Target/MemoryReadRange.h"
+#include "lldb/Target/Process.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace lldb_private
+{
+    class MemoryReadRangeListImpl
+    {
+    public:
+        MemoryReadRangeListImpl () :
+            m_ranges (),
+            m_byte_order (eByteOrderInvalid),
+            m_addr_byte_size (0)
+        {
+        }
+
+        MemoryReadRanges m_ranges;
+        // The layout of the process the ranges were last read from so the
+        // data can be extracted properly
+        ByteOrder m_byte_order;
+        uint32_t m_addr_byte_size;
+    };
+}
+
+SBMemoryReadRangeList::SBMemoryReadRangeList () :
+    m_opaque_ap (new MemoryReadRangeListImpl())
+{
+}
+
+SBMemoryReadRangeList::SBMemoryReadRangeList (const SBMemoryReadRangeList &rhs) :
+    m_opaque_ap (new MemoryReadRangeListImpl(*rhs.m_opaque_ap))
+{
+}
+
+SBMemoryReadRangeList::~SBMemoryReadRangeList ()
+{
+}
+
+const SBMemoryReadRangeList &
+SBMemoryReadRangeList::operator = (const SBMemoryReadRangeList &rhs)
+{
+    if (this != &rhs)
+        *m_opaque_ap = *rhs.m_opaque_ap;
+    return *this;
+}
+
+uint32_t
+SBMemoryReadRangeList::GetSize () const
+{
+    return m_opaque_ap->m_ranges.size();
+}
+
+void
+SBMemoryReadRangeList::Append (lldb::addr_t addr, size_t size)
+{
+    m_opaque_ap->m_ranges.push_back (MemoryReadRange (addr, size));
+}
+
+void
+SBMemoryReadRangeList::Clear ()
+{
+    m_opaque_ap->m_ranges.clear();
+}
+
+lldb::addr_t
+SBMemoryReadRangeList::GetAddressAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_ranges.size())
+        return m_opaque_ap->m_ranges[idx].addr;
+    return LLDB_INVALID_ADDRESS;
+}
+
+size_t
+SBMemoryReadRangeList::GetByteSizeAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_ranges.size())
+        return m_opaque_ap->m_ranges[idx].size;
+    return 0;
+}
+
+SBData
+SBMemoryReadRangeList::GetDataAtIndex (uint32_t idx) const
+{
+    SBData sb_data;
+    if (idx < m_opaque_ap->m_ranges.size())
+    {
+        const MemoryReadRange &range = m_opaque_ap->m_ranges[idx];
+        if (range.data_sp)
+            sb_data.SetOpaque (DataExtractorSP (new DataExtractor (range.data_sp,
+                                                                   m_opaque_ap->m_byte_order,
+                                                                   m_opaque_ap->m_addr_byte_size)));
+    }
+    return sb_data;
+}
+
+SBError
+SBMemoryReadRangeList::GetErrorAtIndex (uint32_t idx) const
+{
+    SBError sb_error;
+    if (idx < m_opaque_ap->m_ranges.size())
+        sb_error.SetError (m_opaque_ap->m_ranges[idx].error);
+    else
+        sb_error.SetErrorString ("invalid range index");
+    return sb_error;
+}
+
+bool
+SBMemoryReadRangeList::GetDescription (SBStream &description) const
+{
+    Stream &strm = description.ref();
+    const MemoryReadRanges &ranges = m_opaque_ap->m_ranges;
+    strm.Printf ("%" PRIu64 " ranges:", (uint64_t)ranges.size());
+    for (const MemoryReadRange &range : ranges)
+    {
+        strm.Printf ("\n    [0x%" PRIx64 "-0x%" PRIx64 ")", range.addr, range.addr + range.size);
+        if (range.error.Fail())
+            strm.Printf (" error: %s", range.error.AsCString());
+        else if (range.data_sp)
+            strm.Printf (" %" PRIu64 " bytes read", (uint64_t)range.GetBytesRead());
+    }
+    return true;
+}
+
+size_t
+SBMemoryReadRangeList::ReadMemory (Process &process)
+{
+    m_opaque_ap->m_byte_order = process.GetByteOrder();
+    m_opaque_ap->m_addr_byte_size = process.GetAddressByteSize();
+    return process.ReadMemoryRanges (m_opaque_ap->m_ranges);
+}
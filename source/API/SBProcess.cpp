@@ -35,8 +35,10 @@
 #include "lldb/API/SBDebugger.h"
 #include "lldb/API/SBEvent.h"
 #include "lldb/API/SBFileSpec.h"
+#include "lldb/API/SBMemoryReadRangeList.h"
 #include "lldb/API/SBThread.h"
 #include "lldb/API/SBThreadCollection.h"
+#include "lldb/API/SBTracepointRecordList.h"
 #include "lldb/API/SBStream.h"
 #include "lldb/API/SBStringList.h"
 #include "lldb/API/SBUnixSignals.h"
@@ -1105,6 +1107,67 @@ SBProcess::ReadMemory (addr_t addr, void *dst, size_t dst_len, SBError &sb_error
     return bytes_read;
 }
 
+size_t
+SBProcess::ReadMemoryRanges (SBMemoryReadRangeList &sb_ranges, SBError &sb_error)
+{
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+
+    size_t num_read = 0;
+
+    ProcessSP process_sp(GetSP());
+
+    if (process_sp)
+    {
+        Process::StopLocker stop_locker;
+        if (stop_locker.TryLock(&process_sp->GetRunLock()))
+        {
+            Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+            num_read = sb_ranges.ReadMemory (*process_sp);
+        }
+        else
+        {
+            if (log)
+                log->Printf ("SBProcess(%p)::ReadMemoryRanges() => error: process is running",
+                             static_cast<void*>(process_sp.get()));
+            sb_error.SetErrorString("process is running");
+        }
+    }
+    else
+    {
+        sb_error.SetErrorString ("SBProcess is invalid");
+    }
+
+    if (log)
+        log->Printf ("SBProcess(%p)::ReadMemoryRanges (%u ranges) => %" PRIu64,
+                     static_cast<void*>(process_sp.get()), sb_ranges.GetSize(),
+                     static_cast<uint64_t>(num_read));
+
+    return num_read;
+}
+
+SBError
+SBProcess::GetTracepointData (SBTracepointRecordList &sb_records)
+{
+    SBError sb_error;
+    ProcessSP process_sp(GetSP());
+    if (process_sp)
+    {
+        Mutex::Locker api_locker (process_sp->GetTarget().GetAPIMutex());
+        sb_error.SetError (sb_records.GetTracepointData (*process_sp));
+    }
+    else
+    {
+        sb_error.SetErrorString ("SBProcess is invalid");
+    }
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
+    if (log)
+        log->Printf ("SBProcess(%p)::GetTracepointData () => %u records, error: %s",
+                     static_cast<void*>(process_sp.get()), sb_records.GetSize(),
+                     sb_error.GetCString());
+    return sb_error;
+}
+
 size_t
 SBProcess::ReadCStringFromMemory (addr_t addr, void *buf, size_t size, lldb::SBError &sb_error)
 {
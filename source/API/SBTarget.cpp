@@ -1713,6 +1713,17 @@ SBTarget::GetDescription (SBStream &description, lldb::DescriptionLevel descript
     return true;
 }
 
+bool
+SBTarget::GetStatistics (SBStream &stats)
+{
+    TargetSP target_sp(GetSP());
+    if (!target_sp)
+        return false;
+
+    target_sp->ReportStatistics()->Dump (stats.ref());
+    return true;
+}
+
 lldb::SBSymbolContextList
 SBTarget::FindFunctions (const char *name, uint32_t name_type_mask)
 {
@@ -0,0 +1,178 @@
+//===-- SBTracepointRecordList.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/API/SBTracepointRecordList.h"
+
+#include <inttypes.h>
+
+#include "lldb/API/SBStream.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/TracepointRecord.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace lldb_private
+{
+    class TracepointRecordListImpl
+    {
+    public:
+        TracepointRecordListImpl () :
+            m_records (),
+            m_num_dropped (0),
+            m_byte_order (eByteOrderInvalid),
+            m_addr_byte_size (0)
+        {
+        }
+
+        const TracepointRecord::Value *
+        GetValue (uint32_t idx, uint32_t value_idx) const
+        {
+            if (idx < m_records.size() && value_idx < m_records[idx].values.size())
+                return &m_records[idx].values[value_idx];
+            return NULL;
+        }
+
+        TracepointRecords m_records;
+        uint64_t m_num_dropped;
+        // The layout of the process the records were fetched from so the
+        // data can be extracted properly
+        ByteOrder m_byte_order;
+        uint32_t m_addr_byte_size;
+    };
+}
+
+SBTracepointRecordList::SBTracepointRecordList () :
+    m_opaque_ap (new TracepointRecordListImpl())
+{
+}
+
+SBTracepointRecordList::SBTracepointRecordList (const SBTracepointRecordList &rhs) :
+    m_opaque_ap (new TracepointRecordListImpl(*rhs.m_opaque_ap))
+{
+}
+
+SBTracepointRecordList::~SBTracepointRecordList ()
+{
+}
+
+const SBTracepointRecordList &
+SBTracepointRecordList::operator = (const SBTracepointRecordList &rhs)
+{
+    if (this != &rhs)
+        *m_opaque_ap = *rhs.m_opaque_ap;
+    return *this;
+}
+
+uint32_t
+SBTracepointRecordList::GetSize () const
+{
+    return m_opaque_ap->m_records.size();
+}
+
+void
+SBTracepointRecordList::Clear ()
+{
+    m_opaque_ap->m_records.clear();
+}
+
+lldb::break_id_t
+SBTracepointRecordList::GetBreakpointIDAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_records.size())
+        return m_opaque_ap->m_records[idx].break_id;
+    return LLDB_INVALID_BREAK_ID;
+}
+
+lldb::break_id_t
+SBTracepointRecordList::GetLocationIDAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_records.size())
+        return m_opaque_ap->m_records[idx].loc_id;
+    return LLDB_INVALID_BREAK_ID;
+}
+
+lldb::tid_t
+SBTracepointRecordList::GetThreadIDAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_records.size())
+        return m_opaque_ap->m_records[idx].tid;
+    return LLDB_INVALID_THREAD_ID;
+}
+
+lldb::addr_t
+SBTracepointRecordList::GetAddressAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_records.size())
+        return m_opaque_ap->m_records[idx].addr;
+    return LLDB_INVALID_ADDRESS;
+}
+
+uint32_t
+SBTracepointRecordList::GetNumValuesAtIndex (uint32_t idx) const
+{
+    if (idx < m_opaque_ap->m_records.size())
+        return m_opaque_ap->m_records[idx].values.size();
+    return 0;
+}
+
+const char *
+SBTracepointRecordList::GetValueNameAtIndex (uint32_t idx, uint32_t value_idx) const
+{
+    const TracepointRecord::Value *value = m_opaque_ap->GetValue (idx, value_idx);
+    return value ? value->name.c_str() : NULL;
+}
+
+SBData
+SBTracepointRecordList::GetValueDataAtIndex (uint32_t idx, uint32_t value_idx) const
+{
+    SBData sb_data;
+    const TracepointRecord::Value *value = m_opaque_ap->GetValue (idx, value_idx);
+    if (value && value->IsAvailable())
+        sb_data.SetOpaque (DataExtractorSP (new DataExtractor (value->data_sp,
+                                                               m_opaque_ap->m_byte_order,
+                                                               m_opaque_ap->m_addr_byte_size)));
+    return sb_data;
+}
+
+uint64_t
+SBTracepointRecordList::GetNumDropped () const
+{
+    return m_opaque_ap->m_num_dropped;
+}
+
+bool
+SBTracepointRecordList::GetDescription (SBStream &description) const
+{
+    Stream &strm = description.ref();
+    const TracepointRecords &records = m_opaque_ap->m_records;
+    strm.Printf ("%" PRIu64 " records, %" PRIu64 " dropped:", (uint64_t)records.size(), m_opaque_ap->m_num_dropped);
+    for (const TracepointRecord &record : records)
+    {
+        strm.Printf ("\n    %d.%d tid 0x%" PRIx64 " pc 0x%" PRIx64 ":", record.break_id, record.loc_id, record.tid, record.addr);
+        for (const TracepointRecord::Value &value : record.values)
+        {
+            if (value.IsAvailable())
+                strm.Printf (" %s (%" PRIu64 " bytes)", value.name.c_str(), (uint64_t)value.data_sp->GetByteSize());
+            else
+                strm.Printf (" %s (unavailable)", value.name.c_str());
+        }
+    }
+    return true;
+}
+
+Error
+SBTracepointRecordList::GetTracepointData (Process &process)
+{
+    m_opaque_ap->m_byte_order = process.GetByteOrder();
+    m_opaque_ap->m_addr_byte_size = process.GetAddressByteSize();
+    return process.GetTracepointData (m_opaque_ap->m_records, m_opaque_ap->m_num_dropped);
+}
@@ -19,6 +19,7 @@
 #include "lldb/Breakpoint/BreakpointLocationCollection.h"
 #include "lldb/Breakpoint/BreakpointResolver.h"
 #include "lldb/Breakpoint/BreakpointResolverFileLine.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleList.h"
@@ -29,6 +30,7 @@
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/ThreadSpec.h"
 #include "llvm/Support/Casting.h"
@@ -172,6 +174,7 @@ Breakpoint::SetIgnoreCount (uint32_t n)
         return;
         
     m_options.SetIgnoreCount(n);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeIgnoreChanged);
 }
 
@@ -230,6 +233,7 @@ Breakpoint::SetThreadID (lldb::tid_t thread_id)
         return;
         
     m_options.GetThreadSpec()->SetTID(thread_id);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -249,6 +253,7 @@ Breakpoint::SetThreadIndex (uint32_t index)
         return;
         
     m_options.GetThreadSpec()->SetIndex(index);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -269,6 +274,7 @@ Breakpoint::SetThreadName (const char *thread_name)
         return;
         
     m_options.GetThreadSpec()->SetName (thread_name);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -289,6 +295,7 @@ Breakpoint::SetQueueName (const char *queue_name)
         return;
         
     m_options.GetThreadSpec()->SetQueueName (queue_name);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -305,6 +312,7 @@ void
 Breakpoint::SetCondition (const char *condition)
 {
     m_options.SetCondition (condition);
+    NotifySitesConditionsChanged ();
     SendBreakpointChangedEvent (eBreakpointEventTypeConditionChanged);
 }
 
@@ -314,6 +322,42 @@ Breakpoint::GetConditionText () const
     return m_options.GetConditionText();
 }
 
+void
+Breakpoint::SetTracepointCollect (const StringList &collect)
+{
+    m_options.SetTracepointCollect (collect);
+    NotifySitesConditionsChanged ();
+    SendBreakpointChangedEvent (eBreakpointEventTypeCommandChanged);
+}
+
+const StringList &
+Breakpoint::GetTracepointCollect () const
+{
+    return m_options.GetTracepointCollect();
+}
+
+bool
+Breakpoint::IsTracepoint () const
+{
+    return m_options.IsTracepoint();
+}
+
+void
+Breakpoint::NotifySitesConditionsChanged ()
+{
+    ProcessSP process_sp (m_target.GetProcessSP());
+    if (process_sp)
+    {
+        const size_t num_locations = m_locations.GetSize();
+        for (size_t i = 0; i < num_locations; ++i)
+        {
+            BreakpointSiteSP bp_site_sp (m_locations.GetByIndex(i)->GetBreakpointSite());
+            if (bp_site_sp)
+                process_sp->BreakpointSiteConditionsChanged (bp_site_sp.get());
+        }
+    }
+}
+
 // This function is used when "baton" doesn't need to be freed
 void
 Breakpoint::SetCallback (BreakpointHitCallback callback, void *baton, bool is_synchronous)
@@ -355,7 +399,10 @@ void
 Breakpoint::ResolveBreakpoint ()
 {
     if (m_resolver_sp)
+    {
+        Target::Statistics::ScopedDuration resolve_duration (&m_target, Target::Statistics::eDurationBreakpointResolve);
         m_resolver_sp->ResolveBreakpoint(*m_filter_sp);
+    }
 }
 
 void
@@ -363,7 +410,10 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, BreakpointLocat
 {
     m_locations.StartRecordingNewLocations(new_locations);
     
-    m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+    {
+        Target::Statistics::ScopedDuration resolve_duration (&m_target, Target::Statistics::eDurationBreakpointResolve);
+        m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
+    }
 
     m_locations.StopRecordingNewLocations();
 }
@@ -391,6 +441,7 @@ Breakpoint::ResolveBreakpointInModules (ModuleList &module_list, bool send_event
         }
         else
         {
+            Target::Statistics::ScopedDuration resolve_duration (&m_target, Target::Statistics::eDurationBreakpointResolve);
             m_resolver_sp->ResolveBreakpointInModules(*m_filter_sp, module_list);
         }
     }
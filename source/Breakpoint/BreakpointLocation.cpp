@@ -126,6 +126,7 @@ BreakpointLocation::SetThreadID (lldb::tid_t thread_id)
         if (m_options_ap.get() != NULL)
             m_options_ap->SetThreadID (thread_id);
     }
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -150,6 +151,7 @@ BreakpointLocation::SetThreadIndex (uint32_t index)
         if (m_options_ap.get() != NULL)
             m_options_ap->GetThreadSpec()->SetIndex(index);
     }
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
                         
 }
@@ -175,6 +177,7 @@ BreakpointLocation::SetThreadName (const char *thread_name)
         if (m_options_ap.get() != NULL)
             m_options_ap->GetThreadSpec()->SetName(thread_name);
     }
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -199,6 +202,7 @@ BreakpointLocation::SetQueueName (const char *queue_name)
         if (m_options_ap.get() != NULL)
             m_options_ap->GetThreadSpec()->SetQueueName(queue_name);
     }
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeThreadChanged);
 }
 
@@ -249,6 +253,7 @@ void
 BreakpointLocation::SetCondition (const char *condition)
 {
     GetLocationOptions()->SetCondition (condition);
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeConditionChanged);
 }
 
@@ -379,6 +384,7 @@ void
 BreakpointLocation::SetIgnoreCount (uint32_t n)
 {
     GetLocationOptions()->SetIgnoreCount(n);
+    NotifySiteConditionsChanged ();
     SendBreakpointLocationChangedEvent (eBreakpointEventTypeIgnoreChanged);
 }
 
@@ -739,6 +745,17 @@ BreakpointLocation::SendBreakpointLocationChangedEvent (lldb::BreakpointEventTyp
     }
 }
 
+void
+BreakpointLocation::NotifySiteConditionsChanged ()
+{
+    if (m_bp_site_sp)
+    {
+        ProcessSP process_sp (m_owner.GetTarget().GetProcessSP());
+        if (process_sp)
+            process_sp->BreakpointSiteConditionsChanged (m_bp_site_sp.get());
+    }
+}
+
 void
 BreakpointLocation::SwapLocation (BreakpointLocationSP swap_from)
 {
@@ -19,6 +19,7 @@
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Section.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/SectionLoadList.h"
 #include "lldb/Target/Target.h"
 
@@ -189,6 +190,7 @@ BreakpointLocationList::GetByIndex (size_t i) const
 void
 BreakpointLocationList::ClearAllBreakpointSites ()
 {
+    Process::BreakpointSiteBatch batch (m_owner.GetTarget().GetProcessSP());
     Mutex::Locker locker (m_mutex);
     collection::iterator pos, end = m_locations.end();
     for (pos = m_locations.begin(); pos != end; ++pos)
@@ -198,6 +200,7 @@ BreakpointLocationList::ClearAllBreakpointSites ()
 void
 BreakpointLocationList::ResolveAllBreakpointSites ()
 {
+    Process::BreakpointSiteBatch batch (m_owner.GetTarget().GetProcessSP());
     Mutex::Locker locker (m_mutex);
     collection::iterator pos, end = m_locations.end();
 
@@ -43,7 +43,8 @@ BreakpointOptions::BreakpointOptions() :
     m_ignore_count (0),
     m_thread_spec_ap (),
     m_condition_text (),
-    m_condition_text_hash (0)
+    m_condition_text_hash (0),
+    m_tracepoint_collect ()
 {
 }
 
@@ -57,7 +58,8 @@ BreakpointOptions::BreakpointOptions(const BreakpointOptions& rhs) :
     m_enabled (rhs.m_enabled),
     m_one_shot (rhs.m_one_shot),
     m_ignore_count (rhs.m_ignore_count),
-    m_thread_spec_ap ()
+    m_thread_spec_ap (),
+    m_tracepoint_collect (rhs.m_tracepoint_collect)
 {
     if (rhs.m_thread_spec_ap.get() != NULL)
         m_thread_spec_ap.reset (new ThreadSpec(*rhs.m_thread_spec_ap.get()));
@@ -81,6 +83,7 @@ BreakpointOptions::operator=(const BreakpointOptions& rhs)
         m_thread_spec_ap.reset(new ThreadSpec(*rhs.m_thread_spec_ap.get()));
     m_condition_text = rhs.m_condition_text;
     m_condition_text_hash = rhs.m_condition_text_hash;
+    m_tracepoint_collect = rhs.m_tracepoint_collect;
     return *this;
 }
 
@@ -261,6 +264,14 @@ BreakpointOptions::GetDescription (Stream *s, lldb::DescriptionLevel level) cons
             s->Printf("Condition: %s\n", m_condition_text.c_str());
         }
     }    
+    if (IsTracepoint() && level != eDescriptionLevelBrief)
+    {
+        s->EOL();
+        s->PutCString("Tracepoint collects:");
+        for (size_t i = 0; i < m_tracepoint_collect.GetSize(); ++i)
+            s->Printf(" %s", m_tracepoint_collect.GetStringAtIndex(i));
+        s->EOL();
+    }
 }
 
 void
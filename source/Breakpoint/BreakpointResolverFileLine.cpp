@@ -73,15 +73,14 @@ BreakpointResolverFileLine::SearchCallback
     // So we go through the match list and pull out the sets that have the same file spec in their line_entry
     // and treat each set separately.
     
-    const size_t num_comp_units = context.module_sp->GetNumCompileUnits();
+    // Only visit the compile units whose line tables can mention our file.
+    std::vector<CompUnitSP> cu_list;
+    const size_t num_comp_units = context.module_sp->GetCompileUnitsForFile (m_file_spec, cu_list);
     for (size_t i = 0; i < num_comp_units; i++)
     {
-        CompUnitSP cu_sp (context.module_sp->GetCompileUnitAtIndex (i));
-        if (cu_sp)
-        {
-            if (filter.CompUnitPasses(*cu_sp))
-                cu_sp->ResolveSymbolContext (m_file_spec, m_line_number, m_inlines, m_exact_match, eSymbolContextEverything, sc_list);
-        }
+        CompUnitSP cu_sp (cu_list[i]);
+        if (filter.CompUnitPasses(*cu_sp))
+            cu_sp->ResolveSymbolContext (m_file_spec, m_line_number, m_inlines, m_exact_match, eSymbolContextEverything, sc_list);
     }
     StreamString s;
     s.Printf ("for %s:%d ",
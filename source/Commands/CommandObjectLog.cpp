@@ -16,7 +16,10 @@
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/FileSpec.h"
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/LogRecorder.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Interpreter/Options.h"
 #include "lldb/Core/RegularExpression.h"
@@ -25,6 +28,7 @@
 #include "lldb/Core/Timer.h"
 
 #include "lldb/Core/Debugger.h"
+#include "lldb/Host/Endian.h"
 #include "lldb/Host/StringConvert.h"
 #include "lldb/Interpreter/CommandInterpreter.h"
 #include "lldb/Interpreter/CommandReturnObject.h"
@@ -145,6 +149,8 @@ public:
             case 'n':  log_options |= LLDB_LOG_OPTION_PREPEND_THREAD_NAME;    break;
             case 'S':  log_options |= LLDB_LOG_OPTION_BACKTRACE;              break;
             case 'a':  log_options |= LLDB_LOG_OPTION_APPEND;                 break;
+            case 'A':  log_options |= LLDB_LOG_OPTION_ASYNC;                  break;
+            case 'F':  log_options |= LLDB_LOG_OPTION_FLIGHT_RECORDER;        break;
             default:
                 error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
                 break;
@@ -187,6 +193,12 @@ protected:
         }
         else
         {
+            if ((m_options.log_options & (LLDB_LOG_OPTION_ASYNC | LLDB_LOG_OPTION_FLIGHT_RECORDER)) && !m_options.log_file)
+            {
+                result.AppendError("--async and --flight-recorder require a log file.\n");
+                result.SetStatus (eReturnStatusFailed);
+                return false;
+            }
             std::string channel(args.GetArgumentAtIndex(0));
             args.Shift ();  // Shift off the channel
             char log_file[PATH_MAX];
@@ -223,6 +235,8 @@ CommandObjectLogEnable::CommandOptions::g_option_table[] =
 { LLDB_OPT_SET_1, false, "thread-name",'n', OptionParser::eNoArgument,       NULL, NULL, 0, eArgTypeNone,       "Prepend all log lines with the thread name for the thread that generates the log line." },
 { LLDB_OPT_SET_1, false, "stack",      'S', OptionParser::eNoArgument,       NULL, NULL, 0, eArgTypeNone,       "Append a stack backtrace to each log line." },
 { LLDB_OPT_SET_1, false, "append",     'a', OptionParser::eNoArgument,       NULL, NULL, 0, eArgTypeNone,       "Append to the log file instead of overwriting." },
+{ LLDB_OPT_SET_1, false, "async",      'A', OptionParser::eNoArgument,       NULL, NULL, 0, eArgTypeNone,       "Write the log from a background thread in a binary format that can be read with \"log decode\".  Requires a log file." },
+{ LLDB_OPT_SET_1, false, "flight-recorder", 'F', OptionParser::eNoArgument,  NULL, NULL, 0, eArgTypeNone,       "Only keep the most recent log messages in memory and write them to the log file in a binary format when \"log dump\" is run, when the log is disabled or when lldb crashes.  Requires a log file." },
 { 0, false, NULL,                       0,  0,                 NULL, NULL, 0, eArgTypeNone,       NULL }
 };
 
@@ -301,6 +315,8 @@ protected:
                 else
                     result.AppendErrorWithFormat("Invalid log channel '%s'.\n", args.GetArgumentAtIndex(0));
             }
+            // Write out anything that asynchronous logs still have buffered
+            LogRecorder::Flush();
         }
         return result.Succeeded();
     }
@@ -392,7 +408,7 @@ public:
         CommandObjectParsed (interpreter,
                            "log timers",
                            "Enable, disable, dump, and reset LLDB internal performance timers.",
-                           "log timers < enable <depth> | disable | dump | increment <bool> | reset >")
+                           "log timers < enable <depth> | disable | dump | increment <bool> | reset | trace < enable | disable | dump <file> > >")
     {
     }
 
@@ -436,6 +452,35 @@ protected:
             }
 
         }
+        else if (argc >= 2 && strcasecmp(args.GetArgumentAtIndex(0), "trace") == 0)
+        {
+            const char *trace_command = args.GetArgumentAtIndex(1);
+
+            if (argc == 2 && strcasecmp(trace_command, "enable") == 0)
+            {
+                Timer::SetTracing (true);
+                result.SetStatus(eReturnStatusSuccessFinishNoResult);
+            }
+            else if (argc == 2 && strcasecmp(trace_command, "disable") == 0)
+            {
+                Timer::SetTracing (false);
+                result.SetStatus(eReturnStatusSuccessFinishNoResult);
+            }
+            else if (argc == 3 && strcasecmp(trace_command, "dump") == 0)
+            {
+                FileSpec trace_file (args.GetArgumentAtIndex(2), true);
+                char trace_path[PATH_MAX];
+                trace_file.GetPath (trace_path, sizeof(trace_path));
+                StreamFile trace_stream (trace_path, File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate);
+                if (trace_stream.GetFile().IsValid())
+                {
+                    Timer::DumpChromeTrace (trace_stream);
+                    result.SetStatus(eReturnStatusSuccessFinishNoResult);
+                }
+                else
+                    result.AppendErrorWithFormat("Couldn't open '%s' for writing.\n", trace_path);
+            }
+        }
         else if (argc == 2)
         {
             const char *sub_command = args.GetArgumentAtIndex(0);
@@ -475,6 +520,107 @@ protected:
     }
 };
 
+class CommandObjectLogDump : public CommandObjectParsed
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    CommandObjectLogDump(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "log dump",
+                             "Write the messages recorded by flight recorder logs to their log files.",
+                             "log dump")
+    {
+    }
+
+    virtual
+    ~CommandObjectLogDump()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& args,
+             CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+        const size_t num_records = LogRecorder::DumpFlightRecorders();
+        result.AppendMessageWithFormat("Wrote %" PRIu64 " log messages.\n", (uint64_t)num_records);
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+class CommandObjectLogDecode : public CommandObjectParsed
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    CommandObjectLogDecode(CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "log decode",
+                             "Print a binary log file that was written by a log enabled with --async or --flight-recorder.",
+                             NULL)
+    {
+        CommandArgumentEntry arg;
+        CommandArgumentData file_arg;
+
+        // Define the first (and only) variant of this arg.
+        file_arg.arg_type = eArgTypeFilename;
+        file_arg.arg_repetition = eArgRepeatPlain;
+
+        // There is only one variant this argument could be; put it into the argument entry.
+        arg.push_back (file_arg);
+
+        // Push the data for the first argument into the m_arguments vector.
+        m_arguments.push_back (arg);
+    }
+
+    virtual
+    ~CommandObjectLogDecode()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& args,
+             CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() != 1)
+        {
+            result.AppendErrorWithFormat("%s takes a log file.\n", m_cmd_name.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        FileSpec log_file (args.GetArgumentAtIndex(0), true);
+        Error error;
+        DataBufferSP data_sp (log_file.ReadFileContents (0, SIZE_MAX, &error));
+        if (!data_sp)
+        {
+            result.AppendErrorWithFormat("Couldn't read '%s': %s\n",
+                                         args.GetArgumentAtIndex(0),
+                                         error.Fail() ? error.AsCString() : "empty file");
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        DataExtractor data (data_sp, endian::InlHostByteOrder(), sizeof(void *));
+        if (LogRecorder::Decode (data, result.GetOutputStream()))
+            result.SetStatus(eReturnStatusSuccessFinishResult);
+        else
+            result.SetStatus(eReturnStatusFailed);
+        return result.Succeeded();
+    }
+};
+
 //----------------------------------------------------------------------
 // CommandObjectLog constructor
 //----------------------------------------------------------------------
@@ -488,6 +634,8 @@ CommandObjectLog::CommandObjectLog(CommandInterpreter &interpreter) :
     LoadSubCommand ("disable", CommandObjectSP (new CommandObjectLogDisable (interpreter)));
     LoadSubCommand ("list",    CommandObjectSP (new CommandObjectLogList (interpreter)));
     LoadSubCommand ("timers",  CommandObjectSP (new CommandObjectLogTimer (interpreter)));
+    LoadSubCommand ("dump",    CommandObjectSP (new CommandObjectLogDump (interpreter)));
+    LoadSubCommand ("decode",  CommandObjectSP (new CommandObjectLogDecode (interpreter)));
 }
 
 //----------------------------------------------------------------------
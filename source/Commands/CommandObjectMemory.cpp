@@ -1779,6 +1779,49 @@ protected:
 };
 
 
+//----------------------------------------------------------------------
+// CommandObjectMemoryCache
+//----------------------------------------------------------------------
+class CommandObjectMemoryCache : public CommandObjectParsed
+{
+public:
+
+    CommandObjectMemoryCache (CommandInterpreter &interpreter) :
+    CommandObjectParsed (interpreter,
+                         "memory cache",
+                         "Show statistics for the process memory cache. Pass \"reset\" to reset them.",
+                         "memory cache [reset]",
+                         eCommandRequiresProcess)
+    {
+    }
+
+    virtual
+    ~CommandObjectMemoryCache ()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& command, CommandReturnObject &result)
+    {
+        const size_t argc = command.GetArgumentCount();
+        const bool reset = argc == 1 && ::strcmp (command.GetArgumentAtIndex(0), "reset") == 0;
+        if (argc > 1 || (argc == 1 && !reset))
+        {
+            result.AppendErrorWithFormat ("usage: %s", m_cmd_syntax.c_str());
+            result.SetStatus(eReturnStatusFailed);
+            return false;
+        }
+
+        MemoryCache &memory_cache = m_exe_ctx.GetProcessRef().GetMemoryCache();
+        memory_cache.Dump (result.GetOutputStream());
+        if (reset)
+            memory_cache.ResetStatistics();
+        result.SetStatus(eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
 //-------------------------------------------------------------------------
 // CommandObjectMemory
 //-------------------------------------------------------------------------
@@ -1793,6 +1836,7 @@ CommandObjectMemory::CommandObjectMemory (CommandInterpreter &interpreter) :
     LoadSubCommand ("read",  CommandObjectSP (new CommandObjectMemoryRead (interpreter)));
     LoadSubCommand ("write", CommandObjectSP (new CommandObjectMemoryWrite (interpreter)));
     LoadSubCommand ("history", CommandObjectSP (new CommandObjectMemoryHistory (interpreter)));
+    LoadSubCommand ("cache", CommandObjectSP (new CommandObjectMemoryCache (interpreter)));
 }
 
 CommandObjectMemory::~CommandObjectMemory ()
@@ -0,0 +1,156 @@
+//===-- CommandObjectStats.cpp ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CommandObjectStats.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/StructuredData.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Interpreter/Options.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//-------------------------------------------------------------------------
+// CommandObjectStatsDump
+//-------------------------------------------------------------------------
+
+class CommandObjectStatsDump : public CommandObjectParsed
+{
+public:
+
+    class CommandOptions : public Options
+    {
+    public:
+
+        CommandOptions (CommandInterpreter &interpreter) :
+            Options (interpreter),
+            m_all_targets (false)
+        {
+        }
+
+        virtual
+        ~CommandOptions ()
+        {
+        }
+
+        virtual Error
+        SetOptionValue (uint32_t option_idx, const char *option_arg)
+        {
+            Error error;
+            const int short_option = m_getopt_table[option_idx].val;
+
+            switch (short_option)
+            {
+                case 'a':
+                    m_all_targets = true;
+                    break;
+                default:
+                    error.SetErrorStringWithFormat ("unrecognized option '%c'", short_option);
+                    break;
+            }
+
+            return error;
+        }
+
+        void
+        OptionParsingStarting ()
+        {
+            m_all_targets = false;
+        }
+
+        const OptionDefinition*
+        GetDefinitions ()
+        {
+            return g_option_table;
+        }
+
+        // Options table: Required for subclasses of Options.
+
+        static OptionDefinition g_option_table[];
+
+        // Instance variables to hold the values for command options.
+
+        bool m_all_targets;
+    };
+
+    CommandObjectStatsDump (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "statistics dump",
+                             "Print the statistics of the work done for the selected target as JSON: "
+                             "the time spent parsing symbol tables and indexing debug info in each "
+                             "module, the packets sent to the process and how well the memory cache "
+                             "worked, and how long expressions, breakpoint resolution and showing "
+                             "stops took.",
+                             "statistics dump [--all-targets]"),
+        m_options (interpreter)
+    {
+    }
+
+    virtual
+    ~CommandObjectStatsDump ()
+    {
+    }
+
+    virtual Options *
+    GetOptions ()
+    {
+        return &m_options;
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& args, CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        StructuredData::DictionarySP stats_sp (m_interpreter.GetDebugger().ReportStatistics (m_options.m_all_targets));
+        Stream &strm = result.GetOutputStream();
+        stats_sp->Dump (strm);
+        strm.EOL();
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+
+    CommandOptions m_options;
+};
+
+OptionDefinition
+CommandObjectStatsDump::CommandOptions::g_option_table[] =
+{
+    { LLDB_OPT_SET_1, false, "all-targets", 'a', OptionParser::eNoArgument, NULL, NULL, 0, eArgTypeNone, "Report the statistics of all targets instead of only the selected target."},
+    { 0, false, NULL, 0, 0, NULL, NULL, 0, eArgTypeNone, NULL }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectStats
+//-------------------------------------------------------------------------
+
+CommandObjectStats::CommandObjectStats (CommandInterpreter &interpreter) :
+    CommandObjectMultiword (interpreter,
+                            "statistics",
+                            "A set of commands for reporting where a debug session spent its time.",
+                            "statistics <subcommand> [<subcommand-options>]")
+{
+    LoadSubCommand ("dump", CommandObjectSP (new CommandObjectStatsDump (interpreter)));
+}
+
+CommandObjectStats::~CommandObjectStats ()
+{
+}
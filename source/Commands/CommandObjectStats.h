@@ -0,0 +1,39 @@
+//===-- CommandObjectStats.h ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CommandObjectStats_h_
+#define liblldb_CommandObjectStats_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Interpreter/CommandObjectMultiword.h"
+
+namespace lldb_private {
+
+//-------------------------------------------------------------------------
+// CommandObjectStats
+//-------------------------------------------------------------------------
+
+class CommandObjectStats : public CommandObjectMultiword
+{
+public:
+    CommandObjectStats (CommandInterpreter &interpreter);
+
+    virtual
+    ~CommandObjectStats ();
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (CommandObjectStats);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_CommandObjectStats_h_
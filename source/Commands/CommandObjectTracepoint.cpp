@@ -0,0 +1,188 @@
+//===-- CommandObjectTracepoint.cpp -----------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CommandObjectTracepoint.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/StringList.h"
+#include "lldb/Host/StringConvert.h"
+#include "lldb/Interpreter/CommandInterpreter.h"
+#include "lldb/Interpreter/CommandReturnObject.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/Target.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//-------------------------------------------------------------------------
+// CommandObjectTracepointCollect
+//-------------------------------------------------------------------------
+
+class CommandObjectTracepointCollect : public CommandObjectParsed
+{
+public:
+
+    CommandObjectTracepointCollect (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "tracepoint collect",
+                             "Turn a breakpoint into a tracepoint that collects the given items each time it is hit, "
+                             "or back into a breakpoint if no items are given. Items are registers (\"$pc\"), "
+                             "variables, or \"<address>@<byte-size>\" for memory, where the address uses the syntax "
+                             "of breakpoint conditions. Where the process runs under lldb-server, the data is "
+                             "collected there and the process isn't stopped; hits of tracepoints that can't be "
+                             "collected that way stop like breakpoint hits.",
+                             "tracepoint collect <breakpt-id> [<item> ...]",
+                             eCommandRequiresTarget)
+    {
+    }
+
+    virtual
+    ~CommandObjectTracepointCollect ()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& args, CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() == 0)
+        {
+            result.AppendErrorWithFormat ("%s needs a breakpoint ID.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        bool success = false;
+        const break_id_t break_id = StringConvert::ToSInt32 (args.GetArgumentAtIndex(0), LLDB_INVALID_BREAK_ID, 0, &success);
+        Target *target = m_exe_ctx.GetTargetPtr();
+        BreakpointSP bp_sp;
+        if (success)
+            bp_sp = target->GetBreakpointByID (break_id);
+        if (!bp_sp)
+        {
+            result.AppendErrorWithFormat ("invalid breakpoint ID '%s'.\n", args.GetArgumentAtIndex(0));
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        StringList collect;
+        for (size_t i = 1; i < args.GetArgumentCount(); ++i)
+            collect.AppendString (args.GetArgumentAtIndex(i));
+        bp_sp->SetTracepointCollect (collect);
+        result.SetStatus (eReturnStatusSuccessFinishNoResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectTracepointData
+//-------------------------------------------------------------------------
+
+class CommandObjectTracepointData : public CommandObjectParsed
+{
+public:
+
+    CommandObjectTracepointData (CommandInterpreter &interpreter) :
+        CommandObjectParsed (interpreter,
+                             "tracepoint data",
+                             "Print and discard the data the tracepoints collected since it was last printed.",
+                             "tracepoint data",
+                             eCommandRequiresProcess)
+    {
+    }
+
+    virtual
+    ~CommandObjectTracepointData ()
+    {
+    }
+
+protected:
+    virtual bool
+    DoExecute (Args& args, CommandReturnObject &result)
+    {
+        if (args.GetArgumentCount() != 0)
+        {
+            result.AppendErrorWithFormat ("%s takes no arguments.\n", m_cmd_name.c_str());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        Process *process = m_exe_ctx.GetProcessPtr();
+        TracepointRecords records;
+        uint64_t num_dropped = 0;
+        Error error (process->GetTracepointData (records, num_dropped));
+        if (error.Fail() && records.empty())
+        {
+            result.AppendError (error.AsCString());
+            result.SetStatus (eReturnStatusFailed);
+            return false;
+        }
+
+        const ByteOrder byte_order = process->GetByteOrder();
+        const uint32_t addr_size = process->GetAddressByteSize();
+        Stream &strm = result.GetOutputStream();
+        for (const TracepointRecord &record : records)
+        {
+            strm.Printf ("tracepoint %d.%d thread 0x%" PRIx64 " pc 0x%" PRIx64 ":",
+                         record.break_id, record.loc_id, record.tid, record.addr);
+            for (size_t i = 0; i < record.values.size(); ++i)
+            {
+                const TracepointRecord::Value &value = record.values[i];
+                strm.Printf ("%s %s = ", i > 0 ? "," : "", value.name.c_str());
+                if (!value.IsAvailable())
+                {
+                    strm.PutCString ("<unavailable>");
+                    continue;
+                }
+
+                // Values that fit an integer are shown as one, anything
+                // else as bytes.
+                const size_t byte_size = value.data_sp->GetByteSize();
+                if (byte_size == 1 || byte_size == 2 || byte_size == 4 || byte_size == 8)
+                {
+                    DataExtractor data (value.data_sp, byte_order, addr_size);
+                    lldb::offset_t offset = 0;
+                    strm.Printf ("0x%.*" PRIx64, (int)byte_size * 2, data.GetMaxU64 (&offset, byte_size));
+                }
+                else
+                    strm.PutBytesAsRawHex8 (value.data_sp->GetBytes(), byte_size);
+            }
+            strm.EOL();
+        }
+        if (num_dropped > 0)
+            strm.Printf ("%" PRIu64 " records were dropped because the buffer was full.\n", num_dropped);
+        if (error.Fail())
+            result.AppendWarning (error.AsCString());
+        result.SetStatus (eReturnStatusSuccessFinishResult);
+        return true;
+    }
+};
+
+//-------------------------------------------------------------------------
+// CommandObjectTracepoint
+//-------------------------------------------------------------------------
+
+CommandObjectTracepoint::CommandObjectTracepoint (CommandInterpreter &interpreter) :
+    CommandObjectMultiword (interpreter,
+                            "tracepoint",
+                            "A set of commands for collecting data at breakpoints without stopping the process.",
+                            "tracepoint <subcommand> [<subcommand-options>]")
+{
+    LoadSubCommand ("collect", CommandObjectSP (new CommandObjectTracepointCollect (interpreter)));
+    LoadSubCommand ("data", CommandObjectSP (new CommandObjectTracepointData (interpreter)));
+}
+
+CommandObjectTracepoint::~CommandObjectTracepoint ()
+{
+}
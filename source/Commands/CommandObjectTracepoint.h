@@ -0,0 +1,39 @@
+//===-- CommandObjectTracepoint.h -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_CommandObjectTracepoint_h_
+#define liblldb_CommandObjectTracepoint_h_
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Interpreter/CommandObjectMultiword.h"
+
+namespace lldb_private {
+
+//-------------------------------------------------------------------------
+// CommandObjectTracepoint
+//-------------------------------------------------------------------------
+
+class CommandObjectTracepoint : public CommandObjectMultiword
+{
+public:
+    CommandObjectTracepoint (CommandInterpreter &interpreter);
+
+    virtual
+    ~CommandObjectTracepoint ();
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (CommandObjectTracepoint);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_CommandObjectTracepoint_h_
@@ -16,6 +16,7 @@
 // Project includes
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Breakpoint/WatchpointList.h"
+#include "lldb/Core/State.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObject.h"
 #include "lldb/Core/ValueObjectVariable.h"
@@ -25,6 +26,7 @@
 #include "lldb/Interpreter/CommandCompletions.h"
 #include "lldb/Symbol/Variable.h"
 #include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Process.h"
 #include "lldb/Target/StackFrame.h"
 #include "lldb/Target/Target.h"
 
@@ -40,6 +42,21 @@ AddWatchpointDescription(Stream *s, Watchpoint *wp, lldb::DescriptionLevel level
 {
     s->IndentMore();
     wp->GetDescription(s, level);
+
+    // Watchpoints that the process watches by protecting pages slow it
+    // down by stopping it for every access to those pages.
+    ProcessSP process_sp = wp->GetTarget().GetProcessSP();
+    uint32_t num_pages = 0;
+    uint64_t num_faults = 0;
+    uint64_t num_hits = 0;
+    if (level != eDescriptionLevelBrief && process_sp && StateIsStoppedState(process_sp->GetState(), false) &&
+        process_sp->GetWatchpointOverhead(wp, num_pages, num_faults, num_hits).Success())
+    {
+        s->EOL();
+        s->Indent();
+        s->Printf("software watchpoint on %" PRIu32 " page%s: %" PRIu64 " faults, %" PRIu64 " hits",
+                  num_pages, num_pages == 1 ? "" : "s", num_faults, num_hits);
+    }
     s->IndentLess();
     s->EOL();
 }
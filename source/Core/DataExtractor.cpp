@@ -1186,6 +1186,103 @@ DataExtractor::PeekCStr (offset_t offset) const
     return (const char *)PeekData (offset, 1);
 }
 
+//----------------------------------------------------------------------
+// LEB128 decoding helpers shared by the single value and the batched
+// accessors. "src" must be less than "end".
+//
+// Most LEB128 values in DWARF are a single byte, so that case is
+// checked first. Otherwise, when at least 8 bytes are left, the next 8
+// bytes are loaded as one little endian word: the position of the first
+// byte without the continuation bit gives the length of the value, and
+// the 7 bit groups are packed together with a few shifts and masks
+// instead of a byte at a time loop. Values longer than 8 bytes (more
+// than 56 bits) and values near the end of the data take the byte at a
+// time path.
+//----------------------------------------------------------------------
+static const uint64_t k_leb128_continuation_bits = 0x8080808080808080ULL;
+
+static inline uint64_t
+LoadLEB128Word (const uint8_t *src)
+{
+    if (lldb::endian::InlHostByteOrder() == eByteOrderLittle)
+        return ReadInt64 (src);
+    return ReadSwapInt64 (src);
+}
+
+static inline const uint8_t *
+DecodeULEB128 (const uint8_t *src, const uint8_t *end, uint64_t &value)
+{
+    if (*src < 0x80)
+    {
+        value = *src;
+        return src + 1;
+    }
+
+    if (end - src >= 8)
+    {
+        const uint64_t word = LoadLEB128Word (src);
+        const uint64_t stop_bits = ~word & k_leb128_continuation_bits;
+        if (stop_bits)
+        {
+            const uint32_t length = (llvm::countTrailingZeros (stop_bits) >> 3) + 1;
+            uint64_t bits = word & ~k_leb128_continuation_bits;
+            if (length < 8)
+                bits &= (1ULL << (length * 8)) - 1;
+            // Pack eight 7 bit groups into 56 contiguous bits.
+            bits = ((bits & 0x7f007f007f007f00ULL) >> 1) | (bits & 0x007f007f007f007fULL);
+            bits = ((bits & 0x3fff00003fff0000ULL) >> 2) | (bits & 0x00003fff00003fffULL);
+            bits = ((bits & 0x0fffffff00000000ULL) >> 4) | (bits & 0x000000000fffffffULL);
+            value = bits;
+            return src + length;
+        }
+    }
+
+    uint64_t result = 0;
+    uint32_t shift = 0;
+    while (src < end)
+    {
+        const uint8_t byte = *src++;
+        if (shift < 64)
+            result |= (uint64_t)(byte & 0x7f) << shift;
+        shift += 7;
+        if ((byte & 0x80) == 0)
+            break;
+    }
+    value = result;
+    return src;
+}
+
+static inline const uint8_t *
+DecodeSLEB128 (const uint8_t *src, const uint8_t *end, int64_t &value)
+{
+    uint64_t result;
+    const uint8_t *next = DecodeULEB128 (src, end, result);
+    // Sign bit of the last byte is the 2nd high order bit (0x40)
+    const uint32_t shift = (next - src) * 7;
+    if (shift < 64 && (next[-1] & 0x40))
+        result |= ~0ULL << shift;
+    value = (int64_t)result;
+    return next;
+}
+
+static inline const uint8_t *
+SkipLEB128 (const uint8_t *src, const uint8_t *end)
+{
+    if (*src < 0x80)
+        return src + 1;
+
+    if (end - src >= 8)
+    {
+        const uint64_t stop_bits = ~LoadLEB128Word (src) & k_leb128_continuation_bits;
+        if (stop_bits)
+            return src + (llvm::countTrailingZeros (stop_bits) >> 3) + 1;
+    }
+
+    while (src < end && (*src++ & 0x80))
+        ;
+    return src;
+}
+
 //----------------------------------------------------------------------
 // Extracts an unsigned LEB128 number from this object's data
 // starting at the offset pointed to by "offset_ptr". The offset
@@ -1200,30 +1297,32 @@ DataExtractor::GetULEB128 (offset_t *offset_ptr) const
     const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
     if (src == NULL)
         return 0;
-    
+
+    uint64_t result;
+    *offset_ptr = DecodeULEB128 (src, m_end, result) - m_start;
+    return result;
+}
+
+//----------------------------------------------------------------------
+// Extracts "count" unsigned LEB128 numbers from this object's data
+// starting at the offset pointed to by "offset_ptr" into "dst".
+//
+// Returns the number of values that were extracted, which is less than
+// "count" if the end of the data was reached.
+//----------------------------------------------------------------------
+uint32_t
+DataExtractor::GetULEB128 (offset_t *offset_ptr, uint64_t *dst, uint32_t count) const
+{
+    const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
+    if (src == NULL)
+        return 0;
+
     const uint8_t *end = m_end;
-    
-    if (src < end)
-    {
-        uint64_t result = *src++;
-        if (result >= 0x80)
-        {
-            result &= 0x7f;
-            int shift = 7;
-            while (src < end)
-            {
-                uint8_t byte = *src++;
-                result |= (byte & 0x7f) << shift;
-                if ((byte & 0x80) == 0)
-                    break;
-                shift += 7;
-            }
-        }
-        *offset_ptr = src - m_start;
-        return result;
-    }
-    
-    return 0;
+    uint32_t i;
+    for (i = 0; i < count && src < end; ++i)
+        src = DecodeULEB128 (src, end, dst[i]);
+    *offset_ptr = src - m_start;
+    return i;
 }
 
 //----------------------------------------------------------------------
@@ -1240,36 +1339,32 @@ DataExtractor::GetSLEB128 (offset_t *offset_ptr) const
     const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
     if (src == NULL)
         return 0;
-    
-    const uint8_t *end = m_end;
-    
-    if (src < end)
-    {
-        int64_t result = 0;
-        int shift = 0;
-        int size = sizeof (int64_t) * 8;
-
-        uint8_t byte = 0;
-        int bytecount = 0;
 
-        while (src < end)
-        {
-            bytecount++;
-            byte = *src++;
-            result |= (byte & 0x7f) << shift;
-            shift += 7;
-            if ((byte & 0x80) == 0)
-                break;
-        }
+    int64_t result;
+    *offset_ptr = DecodeSLEB128 (src, m_end, result) - m_start;
+    return result;
+}
 
-        // Sign bit of byte is 2nd high order bit (0x40)
-        if (shift < size && (byte & 0x40))
-            result |= - (1 << shift);
+//----------------------------------------------------------------------
+// Extracts "count" signed LEB128 numbers from this object's data
+// starting at the offset pointed to by "offset_ptr" into "dst".
+//
+// Returns the number of values that were extracted, which is less than
+// "count" if the end of the data was reached.
+//----------------------------------------------------------------------
+uint32_t
+DataExtractor::GetSLEB128 (offset_t *offset_ptr, int64_t *dst, uint32_t count) const
+{
+    const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
+    if (src == NULL)
+        return 0;
 
-        *offset_ptr += bytecount;
-        return result;
-    }
-    return 0;
+    const uint8_t *end = m_end;
+    uint32_t i;
+    for (i = 0; i < count && src < end; ++i)
+        src = DecodeSLEB128 (src, end, dst[i]);
+    *offset_ptr = src - m_start;
+    return i;
 }
 
 //----------------------------------------------------------------------
@@ -1283,21 +1378,36 @@ DataExtractor::GetSLEB128 (offset_t *offset_ptr) const
 uint32_t
 DataExtractor::Skip_LEB128 (offset_t *offset_ptr) const
 {
-    uint32_t bytes_consumed = 0;
     const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
     if (src == NULL)
         return 0;
-        
+
+    const uint8_t *next = SkipLEB128 (src, m_end);
+    *offset_ptr += next - src;
+    // This has always returned the number of continuation bytes
+    return next - src - 1;
+}
+
+//----------------------------------------------------------------------
+// Skips "count" LEB128 numbers (signed or unsigned) from this object's
+// data starting at the offset pointed to by "offset_ptr".
+//
+// Returns the number of values that were skipped, which is less than
+// "count" if the end of the data was reached.
+//----------------------------------------------------------------------
+uint32_t
+DataExtractor::Skip_LEB128 (offset_t *offset_ptr, uint32_t count) const
+{
+    const uint8_t *src = (const uint8_t *)PeekData (*offset_ptr, 1);
+    if (src == NULL)
+        return 0;
+
     const uint8_t *end = m_end;
-    
-    if (src < end)
-    {
-        const uint8_t *src_pos = src;
-        while ((src_pos < end) && (*src_pos++ & 0x80))
-            ++bytes_consumed;
-        *offset_ptr += src_pos - src;
-    }
-    return bytes_consumed;
+    uint32_t i;
+    for (i = 0; i < count && src < end; ++i)
+        src = SkipLEB128 (src, end);
+    *offset_ptr = src - m_start;
+    return i;
 }
 
 static bool
@@ -856,6 +856,33 @@ Debugger::GetSelectedExecutionContext ()
     return exe_ctx;
 }
 
+StructuredData::DictionarySP
+Debugger::ReportStatistics (bool all_targets)
+{
+    StructuredData::DictionarySP stats_sp (new StructuredData::Dictionary());
+    StructuredData::ArraySP targets_sp (new StructuredData::Array());
+    if (all_targets)
+    {
+        const size_t num_targets = m_target_list.GetNumTargets();
+        for (size_t i = 0; i < num_targets; ++i)
+        {
+            TargetSP target_sp (m_target_list.GetTargetAtIndex(i));
+            if (target_sp)
+                targets_sp->AddItem (target_sp->ReportStatistics());
+        }
+    }
+    else
+    {
+        TargetSP target_sp (GetSelectedTarget());
+        if (target_sp)
+            targets_sp->AddItem (target_sp->ReportStatistics());
+    }
+    stats_sp->AddItem ("targets", targets_sp);
+    // Strings are shared by all debuggers and targets
+    stats_sp->AddIntegerItem ("const_string_memory_bytes", ConstString::StaticMemorySize());
+    return stats_sp;
+}
+
 void
 Debugger::DispatchInputInterrupt ()
 {
@@ -1483,6 +1510,20 @@ Debugger::HandleProcessEvent (const EventSP &event_sp)
         output_stream_sp->Flush();
         error_stream_sp->Flush();
 
+        // Record how long it took from the process stopping until the stop
+        // was shown to the user
+        if (got_state_changed && state_is_stopped)
+        {
+            const Process::ProcessEventData *event_data = Process::ProcessEventData::GetEventDataFromEvent (event_sp.get());
+            if (event_data && !event_data->GetRestarted())
+            {
+                const uint64_t create_time = event_data->GetCreateTime().GetAsNanoSecondsSinceJan1_1970();
+                const uint64_t now = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970();
+                if (now > create_time)
+                    process_sp->GetTarget().GetStatistics().AddDuration (Target::Statistics::eDurationStopToPrompt, now - create_time);
+            }
+        }
+
         if (pop_process_io_handler)
             process_sp->PopProcessIOHandler();
     }
@@ -11,6 +11,8 @@
 
 // Project includes
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/SearchFilter.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/LineTable.h"
@@ -47,7 +49,29 @@ FileLineResolver::SearchCallback
     bool containing
 )
 {
-    CompileUnit *cu = context.comp_unit;
+    if (context.comp_unit)
+    {
+        ResolveCompileUnit (*context.comp_unit);
+    }
+    else if (context.module_sp)
+    {
+        // Let the module narrow down the compile units that can refer to
+        // our file so we don't have to parse the support files of all of them.
+        std::vector<CompUnitSP> cu_list;
+        const size_t num_comp_units = context.module_sp->GetCompileUnitsForFile (m_file_spec, cu_list);
+        for (size_t i = 0; i < num_comp_units; i++)
+        {
+            if (filter.CompUnitPasses (*cu_list[i]))
+                ResolveCompileUnit (*cu_list[i]);
+        }
+    }
+    return Searcher::eCallbackReturnContinue;
+}
+
+void
+FileLineResolver::ResolveCompileUnit (CompileUnit &comp_unit)
+{
+    CompileUnit *cu = &comp_unit;
 
     if (m_inlines || m_file_spec.Compare(*cu, m_file_spec, (bool)m_file_spec.GetDirectory()))
     {
@@ -77,13 +101,12 @@ FileLineResolver::SearchCallback
             }
         }
     }
-    return Searcher::eCallbackReturnContinue;
 }
 
 Searcher::Depth
 FileLineResolver::GetDepth()
 {
-    return Searcher::eDepthCompUnit;
+    return Searcher::eDepthModule;
 }
 
 void
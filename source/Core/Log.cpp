@@ -19,6 +19,7 @@
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Log.h"
+#include "lldb/Core/LogRecorder.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/StreamFile.h"
 #include "lldb/Core/StreamString.h"
@@ -38,14 +39,18 @@ using namespace lldb_private;
 Log::Log () :
     m_stream_sp(),
     m_options(0),
-    m_mask_bits(0)
+    m_mask_bits(0),
+    m_recorder_stream(nullptr),
+    m_recorder_sink_id(0)
 {
 }
 
 Log::Log (const StreamSP &stream_sp) :
     m_stream_sp(stream_sp),
     m_options(0),
-    m_mask_bits(0)
+    m_mask_bits(0),
+    m_recorder_stream(nullptr),
+    m_recorder_sink_id(0)
 {
 }
 
@@ -106,7 +111,11 @@ Log::VAPrintf(const char *format, va_list args)
     // Make a copy of our stream shared pointer in case someone disables our
     // log while we are logging and releases the stream
     StreamSP stream_sp(m_stream_sp);
-    if (stream_sp)
+    if (stream_sp && m_options.AnySet (LLDB_LOG_OPTION_ASYNC | LLDB_LOG_OPTION_FLIGHT_RECORDER))
+    {
+        RecordAsync (stream_sp, format, args);
+    }
+    else if (stream_sp)
     {
         static uint32_t g_sequence_id = 0;
         StreamString header;
@@ -161,6 +170,55 @@ Log::VAPrintf(const char *format, va_list args)
     }
 }
 
+//----------------------------------------------------------------------
+// Hand the message to the LogRecorder which will write it out on its own
+// thread. The recorder always records the sequence ID, timestamp and
+// thread ID, so only the message itself is formatted here, into a stack
+// buffer when it fits.
+//----------------------------------------------------------------------
+void
+Log::RecordAsync(const StreamSP &stream_sp, const char *format, va_list args)
+{
+    if (m_recorder_stream.load() != stream_sp.get())
+    {
+        m_recorder_sink_id = LogRecorder::AddSink (stream_sp, m_options.Test (LLDB_LOG_OPTION_FLIGHT_RECORDER));
+        m_recorder_stream = stream_sp.get();
+    }
+
+    char buffer[1024];
+    va_list copy_args;
+    va_copy (copy_args, args);
+    int length = ::vsnprintf (buffer, sizeof(buffer), format, copy_args);
+    va_end (copy_args);
+    if (length < 0)
+        return;
+
+    std::string message;
+    const char *message_cstr = buffer;
+    if ((size_t)length >= sizeof(buffer) || m_options.Test (LLDB_LOG_OPTION_BACKTRACE))
+    {
+        if ((size_t)length >= sizeof(buffer))
+        {
+            message.resize (length + 1);
+            ::vsnprintf (&message[0], message.size(), format, args);
+            message.resize (length);
+        }
+        else
+            message.assign (buffer, length);
+
+        if (m_options.Test (LLDB_LOG_OPTION_BACKTRACE))
+        {
+            message.push_back ('\n');
+            llvm::raw_string_ostream stream (message);
+            llvm::sys::PrintStackTrace (stream);
+            stream.flush();
+        }
+        message_cstr = message.c_str();
+        length = message.size();
+    }
+    LogRecorder::Record (m_recorder_sink_id, message_cstr, length);
+}
+
 //----------------------------------------------------------------------
 // Print debug strings if and only if the global debug option is set to
 // a non-zero value.
@@ -471,6 +529,7 @@ void
 Log::Terminate ()
 {
     DisableAllLogChannels (NULL);
+    LogRecorder::Flush ();
 }
 
 void
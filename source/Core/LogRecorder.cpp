@@ -0,0 +1,796 @@
+//===-- LogRecorder.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#if !defined(_WIN32)
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/SwapByteOrder.h"
+
+// Project includes
+#include "lldb/Core/LogRecorder.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Host/Condition.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/HostThread.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Host/ThreadLauncher.h"
+#include "lldb/Host/TimeValue.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+const char LogRecorder::g_magic[8] = { 'L', 'L', 'D', 'B', 'B', 'L', 'O', 'G' };
+
+namespace {
+
+// Copy to and from a ring of "capacity" bytes, which must be a power of
+// two, at a position that wraps around.
+void
+CopyToRing (uint8_t *ring, size_t capacity, uint64_t pos, const void *src, size_t len)
+{
+    const size_t offset = pos & (capacity - 1);
+    const size_t first = std::min (len, capacity - offset);
+    ::memcpy (ring + offset, src, first);
+    ::memcpy (ring, (const uint8_t *)src + first, len - first);
+}
+
+void
+CopyFromRing (const uint8_t *ring, size_t capacity, uint64_t pos, void *dst, size_t len)
+{
+    const size_t offset = pos & (capacity - 1);
+    const size_t first = std::min (len, capacity - offset);
+    ::memcpy (dst, ring + offset, first);
+    ::memcpy ((uint8_t *)dst + first, ring, len - first);
+}
+
+// Write "len" bytes at a position in a ring without copying them.
+void
+WriteFromRing (Stream &strm, const uint8_t *ring, size_t capacity, uint64_t pos, size_t len)
+{
+    const size_t offset = pos & (capacity - 1);
+    const size_t first = std::min (len, capacity - offset);
+    if (first)
+        strm.Write (ring + offset, first);
+    if (len - first)
+        strm.Write (ring, len - first);
+}
+
+//----------------------------------------------------------------------
+// A single producer, single consumer ring buffer of records. The thread
+// that owns the buffer is the only producer, and the consumer is
+// whichever thread drains the recorder while holding its drain mutex.
+// Buffers are never freed and form a list that only grows at its head,
+// so the crash handler can walk them without taking any locks.
+//----------------------------------------------------------------------
+class ThreadBuffer
+{
+public:
+    struct Entry
+    {
+        uint64_t timestamp;
+        uint64_t thread_id;
+        uint32_t sequence;
+        uint32_t sink_id;
+        uint32_t length;
+        uint32_t padding;
+    };
+
+    static const size_t kCapacity = 256 * 1024; // Must be a power of two
+    static const size_t kMaxMessageLength = kCapacity / 8;
+
+    ThreadBuffer (ThreadBuffer *next) :
+        m_head (0),
+        m_tail (0),
+        m_in_use (true),
+        m_data (new uint8_t[kCapacity]),
+        m_next (next)
+    {
+    }
+
+    // Returns false if there is no room for the entry. "half_full" is set
+    // if this entry made the buffer go over half full so the caller can
+    // wake up the consumer.
+    bool
+    Push (const Entry &entry, const char *message, bool &half_full)
+    {
+        const uint64_t entry_size = GetEntrySize (entry.length);
+        const uint64_t head = m_head.load (std::memory_order_relaxed);
+        const uint64_t tail = m_tail.load (std::memory_order_acquire);
+        const uint64_t used = head - tail;
+        if (kCapacity - used < entry_size)
+            return false;
+        CopyIn (head, &entry, sizeof(entry));
+        CopyIn (head + sizeof(entry), message, entry.length);
+        m_head.store (head + entry_size, std::memory_order_release);
+        half_full = used < kCapacity / 2 && used + entry_size >= kCapacity / 2;
+        return true;
+    }
+
+    template <typename Callback>
+    void
+    Drain (Callback callback)
+    {
+        const uint64_t head = m_head.load (std::memory_order_acquire);
+        uint64_t tail = m_tail.load (std::memory_order_relaxed);
+        std::string message;
+        while (tail != head)
+        {
+            Entry entry;
+            CopyOut (tail, &entry, sizeof(entry));
+            message.resize (entry.length);
+            if (entry.length)
+                CopyOut (tail + sizeof(entry), &message[0], entry.length);
+            callback (entry, message);
+            tail += GetEntrySize (entry.length);
+        }
+        m_tail.store (tail, std::memory_order_release);
+    }
+
+    // Write the records that haven't been drained for a sink, without
+    // draining them or allocating anything, for the crash handler.
+    void
+    WritePending (uint32_t sink_id, Stream &strm) const
+    {
+        const uint64_t head = m_head.load (std::memory_order_acquire);
+        uint64_t tail = m_tail.load (std::memory_order_acquire);
+        while (tail != head)
+        {
+            Entry entry;
+            CopyFromRing (m_data.get(), kCapacity, tail, &entry, sizeof(entry));
+            if (entry.sink_id == sink_id)
+            {
+                LogRecorder::RecordHeader header;
+                header.timestamp = entry.timestamp;
+                header.thread_id = entry.thread_id;
+                header.sequence = entry.sequence;
+                header.length = entry.length;
+                strm.Write (&header, sizeof(header));
+                WriteFromRing (strm, m_data.get(), kCapacity, tail + sizeof(entry), entry.length);
+            }
+            tail += GetEntrySize (entry.length);
+        }
+    }
+
+    // Claim this buffer for the current thread if no thread is using it.
+    bool
+    Acquire ()
+    {
+        bool in_use = false;
+        return m_in_use.compare_exchange_strong (in_use, true, std::memory_order_acquire);
+    }
+
+    void
+    Release ()
+    {
+        m_in_use.store (false, std::memory_order_release);
+    }
+
+    ThreadBuffer *
+    GetNext () const
+    {
+        return m_next;
+    }
+
+private:
+    static uint64_t
+    GetEntrySize (uint32_t length)
+    {
+        return sizeof(Entry) + ((length + 7) & ~7u);
+    }
+
+    void
+    CopyIn (uint64_t pos, const void *src, size_t len)
+    {
+        CopyToRing (m_data.get(), kCapacity, pos, src, len);
+    }
+
+    void
+    CopyOut (uint64_t pos, void *dst, size_t len) const
+    {
+        CopyFromRing (m_data.get(), kCapacity, pos, dst, len);
+    }
+
+    std::atomic<uint64_t> m_head;   // Only written by the producer
+    std::atomic<uint64_t> m_tail;   // Only written by the consumer
+    std::atomic<bool> m_in_use;
+    std::unique_ptr<uint8_t[]> m_data;
+    ThreadBuffer *const m_next;     // The buffer created before this one
+};
+
+const size_t ThreadBuffer::kCapacity;
+const size_t ThreadBuffer::kMaxMessageLength;
+
+//----------------------------------------------------------------------
+// The most recent encoded records of a flight recorder, in a ring that
+// is allocated once so the crash handler can write it out as is. The
+// oldest records are dropped to make room for new ones.
+//----------------------------------------------------------------------
+class FlightRecords
+{
+public:
+    static const size_t kCapacity = 1024 * 1024; // Must be a power of two
+
+    FlightRecords () :
+        m_head (0),
+        m_tail (0),
+        m_num_records (0),
+        m_data (new uint8_t[kCapacity])
+    {
+    }
+
+    void
+    Append (const LogRecorder::RecordHeader &header, const char *message)
+    {
+        const uint64_t record_size = sizeof(header) + header.length;
+        while (kCapacity - (m_head - m_tail) < record_size)
+        {
+            LogRecorder::RecordHeader oldest;
+            CopyFromRing (m_data.get(), kCapacity, m_tail, &oldest, sizeof(oldest));
+            m_tail += sizeof(oldest) + oldest.length;
+            --m_num_records;
+        }
+        CopyToRing (m_data.get(), kCapacity, m_head, &header, sizeof(header));
+        CopyToRing (m_data.get(), kCapacity, m_head + sizeof(header), message, header.length);
+        m_head += record_size;
+        ++m_num_records;
+    }
+
+    void
+    Write (Stream &strm) const
+    {
+        WriteFromRing (strm, m_data.get(), kCapacity, m_tail, m_head - m_tail);
+    }
+
+    void
+    Clear ()
+    {
+        m_tail = m_head;
+        m_num_records = 0;
+    }
+
+    size_t
+    GetNumRecords () const
+    {
+        return m_num_records;
+    }
+
+private:
+    uint64_t m_head;
+    uint64_t m_tail;
+    size_t m_num_records;
+    std::unique_ptr<uint8_t[]> m_data;
+};
+
+const size_t FlightRecords::kCapacity;
+
+#if !defined(_WIN32)
+// The signals that dump the flight recorders, and the actions they had
+// before the recorder installed its handler.
+const int g_crash_signals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT };
+struct sigaction g_previous_crash_actions[llvm::array_lengthof (g_crash_signals)];
+#endif
+
+class Recorder
+{
+public:
+    static Recorder &
+    GetRecorder ()
+    {
+        static Recorder *g_recorder = new Recorder(); // Intentional leak
+        return *g_recorder;
+    }
+
+    Recorder () :
+        m_next_sequence (0),
+        m_num_dropped (0),
+        m_thread_buffer_key (Host::ThreadLocalStorageCreate (ReleaseThreadBuffer)),
+        m_buffers_mutex (Mutex::eMutexTypeNormal),
+        m_first_buffer (NULL),
+        m_drain_mutex (Mutex::eMutexTypeRecursive),
+        m_drain_owner (LLDB_INVALID_THREAD_ID),
+        m_sinks (),
+        m_next_sink_id (1),
+        m_wait_mutex (Mutex::eMutexTypeNormal),
+        m_wait_condition (),
+        m_writer_thread (),
+        m_crashed (false),
+        m_crash_handlers_installed (false)
+    {
+    }
+
+    uint32_t
+    AddSink (const StreamSP &stream_sp, bool flight_recorder)
+    {
+        DrainLocker locker (*this);
+        for (auto &pos : m_sinks)
+        {
+            if (pos.second.stream_sp == stream_sp)
+            {
+                SetFlightRecorder (pos.second, flight_recorder);
+                return pos.first;
+            }
+        }
+
+        const uint32_t sink_id = m_next_sink_id++;
+        Sink &sink = m_sinks[sink_id];
+        sink.stream_sp = stream_sp;
+        SetFlightRecorder (sink, flight_recorder);
+
+        if (!m_writer_thread.IsJoinable())
+            m_writer_thread = ThreadLauncher::LaunchThread ("lldb.log.recorder", WriterThread, this, NULL);
+        return sink_id;
+    }
+
+    void
+    Record (uint32_t sink_id, const char *message, size_t length)
+    {
+        ThreadBuffer *buffer = GetThreadBuffer();
+        ThreadBuffer::Entry entry;
+        entry.timestamp = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970();
+        entry.thread_id = Host::GetCurrentThreadID();
+        entry.sequence = m_next_sequence.fetch_add (1, std::memory_order_relaxed);
+        entry.sink_id = sink_id;
+        entry.length = std::min<size_t> (length, ThreadBuffer::kMaxMessageLength);
+        entry.padding = 0;
+
+        bool half_full = false;
+        if (!buffer->Push (entry, message, half_full))
+            m_num_dropped.fetch_add (1, std::memory_order_relaxed);
+        else if (half_full)
+            m_wait_condition.Signal();
+    }
+
+    void
+    Flush ()
+    {
+        DrainLocker locker (*this);
+        Drain();
+    }
+
+    size_t
+    DumpFlightRecorders ()
+    {
+        DrainLocker locker (*this);
+        Drain();
+        size_t num_records = 0;
+        for (auto &pos : m_sinks)
+            num_records += DumpFlightRecords (pos.second);
+        return num_records;
+    }
+
+private:
+    struct Sink
+    {
+        Sink () :
+            stream_sp (),
+            flight_recorder (false),
+            wrote_file_header (false),
+            reported_dropped (false),
+            flight_records ()
+        {
+        }
+
+        StreamSP stream_sp;
+        // The crash handler reads these without the drain mutex
+        std::atomic<bool> flight_recorder;
+        std::atomic<bool> wrote_file_header;
+        bool reported_dropped;
+        std::unique_ptr<FlightRecords> flight_records;
+    };
+
+    //------------------------------------------------------------------
+    // Locks the drain mutex and publishes which thread holds it. The
+    // crash handler can't take the mutex, it waits until no thread holds
+    // it instead. Once the process has crashed, threads that get the
+    // mutex wait for the process to go away without touching anything.
+    //------------------------------------------------------------------
+    class DrainLocker
+    {
+    public:
+        DrainLocker (Recorder &recorder) :
+            m_recorder (recorder),
+            m_locker (recorder.m_drain_mutex),
+            m_previous_owner (recorder.m_drain_owner.load())
+        {
+            m_recorder.m_drain_owner.store (Host::GetCurrentThreadID());
+#if !defined(_WIN32)
+            if (m_recorder.m_crashed.load())
+            {
+                m_recorder.m_drain_owner.store (m_previous_owner);
+                while (true)
+                    ::pause();
+            }
+#endif
+        }
+
+        ~DrainLocker ()
+        {
+            m_recorder.m_drain_owner.store (m_previous_owner);
+        }
+
+    private:
+        Recorder &m_recorder;
+        Mutex::Locker m_locker;
+        lldb::tid_t m_previous_owner; // Drain can log and add a sink on the same thread
+
+        DISALLOW_COPY_AND_ASSIGN (DrainLocker);
+    };
+
+    // Must be called with a DrainLocker.
+    void
+    Drain ()
+    {
+        // Records from different threads are put back in the order they
+        // were logged in.
+        typedef std::pair<ThreadBuffer::Entry, std::string> PendingRecord;
+        std::vector<PendingRecord> records;
+        for (ThreadBuffer *buffer = m_first_buffer.load (std::memory_order_acquire); buffer; buffer = buffer->GetNext())
+        {
+            buffer->Drain ([&records](const ThreadBuffer::Entry &entry, const std::string &message) {
+                records.push_back (PendingRecord (entry, message));
+            });
+        }
+        std::stable_sort (records.begin(), records.end(), [](const PendingRecord &lhs, const PendingRecord &rhs) {
+            return (int32_t)(lhs.first.sequence - rhs.first.sequence) < 0;
+        });
+
+        const uint64_t num_dropped = m_num_dropped.exchange (0, std::memory_order_relaxed);
+
+        for (const PendingRecord &record : records)
+        {
+            auto pos = m_sinks.find (record.first.sink_id);
+            if (pos == m_sinks.end())
+                continue;
+            Sink &sink = pos->second;
+            if (num_dropped && !sink.reported_dropped)
+            {
+                char note[64];
+                const int note_len = ::snprintf (note, sizeof(note), "LogRecorder: dropped %" PRIu64 " messages", num_dropped);
+                WriteRecord (sink, record.first.timestamp, 0, record.first.sequence, note, note_len);
+                sink.reported_dropped = true;
+            }
+            WriteRecord (sink, record.first.timestamp, record.first.thread_id, record.first.sequence,
+                         record.second.data(), record.second.size());
+        }
+
+        // Flush the streams that were written to and forget about the
+        // streams that no log is using anymore, after writing out what
+        // their flight recorders still hold.
+        auto pos = m_sinks.begin();
+        while (pos != m_sinks.end())
+        {
+            Sink &sink = pos->second;
+            sink.reported_dropped = false;
+            if (sink.stream_sp.unique())
+            {
+                DumpFlightRecords (sink);
+                sink.stream_sp->Flush();
+                pos = m_sinks.erase (pos);
+            }
+            else
+            {
+                if (!sink.flight_recorder)
+                    sink.stream_sp->Flush();
+                ++pos;
+            }
+        }
+    }
+
+    // Must be called with a DrainLocker.
+    void
+    SetFlightRecorder (Sink &sink, bool flight_recorder)
+    {
+        if (flight_recorder && !sink.flight_records)
+            sink.flight_records.reset (new FlightRecords());
+        sink.flight_recorder = flight_recorder;
+        if (flight_recorder)
+            InstallCrashHandlers();
+    }
+
+    ThreadBuffer *
+    GetThreadBuffer ()
+    {
+        ThreadBuffer *thread_buffer = (ThreadBuffer *)Host::ThreadLocalStorageGet (m_thread_buffer_key);
+        if (thread_buffer)
+            return thread_buffer;
+
+        // Reuse the buffer of a thread that has exited if there is one.
+        Mutex::Locker locker (m_buffers_mutex);
+        ThreadBuffer *first_buffer = m_first_buffer.load (std::memory_order_relaxed);
+        for (ThreadBuffer *buffer = first_buffer; buffer; buffer = buffer->GetNext())
+        {
+            if (buffer->Acquire())
+            {
+                thread_buffer = buffer;
+                break;
+            }
+        }
+        if (thread_buffer == NULL)
+        {
+            thread_buffer = new ThreadBuffer(first_buffer);
+            m_first_buffer.store (thread_buffer, std::memory_order_release);
+        }
+        Host::ThreadLocalStorageSet (m_thread_buffer_key, thread_buffer);
+        return thread_buffer;
+    }
+
+    // Returns a thread's buffer to the recorder when the thread exits.
+    static void
+    ReleaseThreadBuffer (void *buffer)
+    {
+        if (buffer)
+            ((ThreadBuffer *)buffer)->Release();
+    }
+
+    static void
+    WriteFileHeader (Stream &strm)
+    {
+        LogRecorder::FileHeader header;
+        ::memcpy (header.magic, LogRecorder::g_magic, sizeof(header.magic));
+        header.version = LogRecorder::eVersion;
+        header.byte_order_mark = LogRecorder::eByteOrderMark;
+        strm.Write (&header, sizeof(header));
+    }
+
+    void
+    WriteRecord (Sink &sink, uint64_t timestamp, uint64_t thread_id, uint32_t sequence, const char *message, size_t length)
+    {
+        LogRecorder::RecordHeader header;
+        header.timestamp = timestamp;
+        header.thread_id = thread_id;
+        header.sequence = sequence;
+        header.length = length;
+        if (sink.flight_recorder)
+        {
+            sink.flight_records->Append (header, message);
+        }
+        else
+        {
+            if (!sink.wrote_file_header)
+            {
+                WriteFileHeader (*sink.stream_sp);
+                sink.wrote_file_header = true;
+            }
+            sink.stream_sp->Write (&header, sizeof(header));
+            sink.stream_sp->Write (message, length);
+        }
+    }
+
+    // Must be called with a DrainLocker. Returns the number of records
+    // that were written.
+    size_t
+    DumpFlightRecords (Sink &sink)
+    {
+        if (!sink.flight_recorder || sink.flight_records->GetNumRecords() == 0)
+            return 0;
+        const size_t num_records = sink.flight_records->GetNumRecords();
+        WriteFileHeader (*sink.stream_sp);
+        sink.flight_records->Write (*sink.stream_sp);
+        sink.stream_sp->Flush();
+        sink.flight_records->Clear();
+        return num_records;
+    }
+
+    static thread_result_t
+    WriterThread (thread_arg_t arg)
+    {
+        Recorder *recorder = (Recorder *)arg;
+        while (true)
+        {
+            {
+                Mutex::Locker locker (recorder->m_wait_mutex);
+                TimeValue timeout = TimeValue::Now();
+                timeout.OffsetWithMicroSeconds (50 * 1000);
+                recorder->m_wait_condition.Wait (recorder->m_wait_mutex, &timeout);
+            }
+            recorder->Flush();
+        }
+        return NULL;
+    }
+
+#if !defined(_WIN32)
+    //------------------------------------------------------------------
+    // Write the flight recorders, and any records that haven't been
+    // drained yet, when the process crashes. Nothing here allocates or
+    // takes a lock: the sinks are only read once no thread holds the
+    // drain mutex, the records are already encoded, and the log file
+    // streams write straight to their file descriptors.
+    //------------------------------------------------------------------
+    void
+    DumpForCrash ()
+    {
+        m_crashed.store (true);
+
+        // A thread that is draining gets a second to finish. If it is the
+        // crashing thread itself, the sinks may be half updated.
+        const lldb::tid_t tid = Host::GetCurrentThreadID();
+        lldb::tid_t owner;
+        for (int retries = 0; (owner = m_drain_owner.load()) != LLDB_INVALID_THREAD_ID; ++retries)
+        {
+            if (owner == tid || retries == 1000)
+                return;
+            const struct timespec delay = { 0, 1000 * 1000 };
+            ::nanosleep (&delay, NULL);
+        }
+
+        for (auto &pos : m_sinks)
+        {
+            Sink &sink = pos.second;
+            const bool flight_recorder = sink.flight_recorder.load();
+            if (flight_recorder || !sink.wrote_file_header.load())
+                WriteFileHeader (*sink.stream_sp);
+            if (flight_recorder)
+                sink.flight_records->Write (*sink.stream_sp);
+            for (ThreadBuffer *buffer = m_first_buffer.load (std::memory_order_acquire); buffer; buffer = buffer->GetNext())
+                buffer->WritePending (pos.first, *sink.stream_sp);
+        }
+    }
+
+    static void
+    CrashHandler (int signo)
+    {
+        static std::atomic<bool> g_handling_crash (false);
+        if (!g_handling_crash.exchange (true))
+            GetRecorder().DumpForCrash();
+
+        // Let the previous handler, or the default action, deal with the
+        // signal.
+        for (size_t i = 0; i < llvm::array_lengthof (g_crash_signals); ++i)
+        {
+            if (g_crash_signals[i] == signo)
+                ::sigaction (signo, &g_previous_crash_actions[i], NULL);
+        }
+        ::raise (signo);
+    }
+#endif
+
+    void
+    InstallCrashHandlers ()
+    {
+        if (m_crash_handlers_installed.exchange (true))
+            return;
+#if !defined(_WIN32)
+        for (size_t i = 0; i < llvm::array_lengthof (g_crash_signals); ++i)
+        {
+            struct sigaction action;
+            ::memset (&action, 0, sizeof(action));
+            action.sa_handler = CrashHandler;
+            ::sigemptyset (&action.sa_mask);
+            action.sa_flags = SA_RESETHAND;
+            ::sigaction (g_crash_signals[i], &action, &g_previous_crash_actions[i]);
+        }
+#endif
+    }
+
+    std::atomic<uint32_t> m_next_sequence;
+    std::atomic<uint64_t> m_num_dropped;
+    lldb::thread_key_t m_thread_buffer_key;     // The current thread's ThreadBuffer
+    Mutex m_buffers_mutex;                      // Serializes taking and creating buffers
+    std::atomic<ThreadBuffer *> m_first_buffer; // Never freed, buffers of exited threads are reused
+    Mutex m_drain_mutex;                        // Protects m_sinks and draining the buffers
+    std::atomic<lldb::tid_t> m_drain_owner;     // The thread holding m_drain_mutex
+    std::map<uint32_t, Sink> m_sinks;
+    uint32_t m_next_sink_id;
+    Mutex m_wait_mutex;
+    Condition m_wait_condition;
+    HostThread m_writer_thread;
+    std::atomic<bool> m_crashed;
+    std::atomic<bool> m_crash_handlers_installed;
+};
+
+} // anonymous namespace
+
+uint32_t
+LogRecorder::AddSink (const StreamSP &stream_sp, bool flight_recorder)
+{
+    return Recorder::GetRecorder().AddSink (stream_sp, flight_recorder);
+}
+
+void
+LogRecorder::Record (uint32_t sink_id, const char *message, size_t length)
+{
+    Recorder::GetRecorder().Record (sink_id, message, length);
+}
+
+void
+LogRecorder::Flush ()
+{
+    Recorder::GetRecorder().Flush();
+}
+
+size_t
+LogRecorder::DumpFlightRecorders ()
+{
+    return Recorder::GetRecorder().DumpFlightRecorders();
+}
+
+bool
+LogRecorder::Decode (const DataExtractor &log_data, Stream &strm)
+{
+    DataExtractor data (log_data);
+    lldb::offset_t offset = 0;
+    bool found_file_header = false;
+    while (data.ValidOffsetForDataOfSize (offset, sizeof(RecordHeader)))
+    {
+        const char *magic = (const char *)data.PeekData (offset, sizeof(g_magic));
+        if (magic && ::memcmp (magic, g_magic, sizeof(g_magic)) == 0)
+        {
+            offset += sizeof(g_magic);
+            uint32_t version = data.GetU32 (&offset);
+            const uint32_t byte_order_mark = data.GetU32 (&offset);
+            if (byte_order_mark == llvm::ByteSwap_32 (eByteOrderMark))
+            {
+                // The log was written by a host with the other byte order.
+                data.SetByteOrder (data.GetByteOrder() == eByteOrderLittle ? eByteOrderBig : eByteOrderLittle);
+                version = llvm::ByteSwap_32 (version);
+            }
+            else if (byte_order_mark != eByteOrderMark)
+            {
+                strm.PutCString ("error: invalid binary log header\n");
+                return false;
+            }
+            if (version != eVersion)
+            {
+                strm.Printf ("error: unsupported binary log version %u\n", version);
+                return false;
+            }
+            found_file_header = true;
+            continue;
+        }
+
+        if (!found_file_header)
+        {
+            strm.PutCString ("error: not a binary log\n");
+            return false;
+        }
+
+        const uint64_t timestamp = data.GetU64 (&offset);
+        const uint64_t thread_id = data.GetU64 (&offset);
+        const uint32_t sequence = data.GetU32 (&offset);
+        const uint32_t length = data.GetU32 (&offset);
+        const char *message = (const char *)data.GetData (&offset, length);
+        if (message == NULL)
+        {
+            strm.PutCString ("error: truncated log record\n");
+            return false;
+        }
+        strm.Printf ("%u %9" PRIu64 ".%09" PRIu64 " [%4.4" PRIx64 "]: ",
+                     sequence,
+                     timestamp / TimeValue::NanoSecPerSec,
+                     timestamp % TimeValue::NanoSecPerSec,
+                     thread_id);
+        strm.Write (message, length);
+        // Messages from Log::Printf() end with a newline already
+        if (length == 0 || message[length - 1] != '\n')
+            strm.EOL();
+    }
+    if (!found_file_header)
+    {
+        strm.PutCString ("error: not a binary log\n");
+        return false;
+    }
+    return true;
+}
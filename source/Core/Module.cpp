@@ -532,6 +532,38 @@ Module::GetCompileUnitAtIndex (size_t index)
     return cu_sp;
 }
 
+size_t
+Module::GetCompileUnitsForFile (const FileSpec &file_spec, std::vector<CompUnitSP> &cu_list)
+{
+    Mutex::Locker locker (m_mutex);
+    cu_list.clear();
+    SymbolVendor *symbols = GetSymbolVendor ();
+    if (symbols == NULL)
+        return 0;
+
+    std::vector<uint32_t> cu_indexes;
+    if (symbols->FindCompileUnitsForFile (file_spec, cu_indexes))
+    {
+        for (uint32_t cu_idx : cu_indexes)
+        {
+            CompUnitSP cu_sp (symbols->GetCompileUnitAtIndex (cu_idx));
+            if (cu_sp)
+                cu_list.push_back (cu_sp);
+        }
+    }
+    else
+    {
+        const size_t num_comp_units = symbols->GetNumCompileUnits();
+        for (size_t i = 0; i < num_comp_units; i++)
+        {
+            CompUnitSP cu_sp (symbols->GetCompileUnitAtIndex (i));
+            if (cu_sp)
+                cu_list.push_back (cu_sp);
+        }
+    }
+    return cu_list.size();
+}
+
 bool
 Module::ResolveFileAddress (lldb::addr_t vm_addr, Address& so_addr)
 {
@@ -13,13 +13,17 @@
 #include <stdint.h>
 
 // C++ Includes
+#include <algorithm>
+#include <map>
 #include <mutex> // std::once
+#include <string>
 
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
 #include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/Condition.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Host/Symbols.h"
 #include "lldb/Symbol/ClangNamespaceDecl.h"
@@ -35,7 +39,11 @@ using namespace lldb_private;
 ModuleList::ModuleList() :
     m_modules(),
     m_modules_mutex (Mutex::eMutexTypeRecursive),
-    m_notifier(NULL)
+    m_notifier(NULL),
+    m_indexed(false),
+    m_uuid_index(),
+    m_file_index(),
+    m_index_keys()
 {
 }
 
@@ -45,7 +53,11 @@ ModuleList::ModuleList() :
 ModuleList::ModuleList(const ModuleList& rhs) :
     m_modules(),
     m_modules_mutex (Mutex::eMutexTypeRecursive),
-    m_notifier(NULL)
+    m_notifier(NULL),
+    m_indexed(false),
+    m_uuid_index(),
+    m_file_index(),
+    m_index_keys()
 {
     Mutex::Locker lhs_locker(m_modules_mutex);
     Mutex::Locker rhs_locker(rhs.m_modules_mutex);
@@ -55,7 +67,11 @@ ModuleList::ModuleList(const ModuleList& rhs) :
 ModuleList::ModuleList (ModuleList::Notifier* notifier) :
     m_modules(),
     m_modules_mutex (Mutex::eMutexTypeRecursive),
-    m_notifier(notifier)
+    m_notifier(notifier),
+    m_indexed(false),
+    m_uuid_index(),
+    m_file_index(),
+    m_index_keys()
 {
 }
 
@@ -82,12 +98,14 @@ ModuleList::operator= (const ModuleList& rhs)
             Mutex::Locker lhs_locker(m_modules_mutex);
             Mutex::Locker rhs_locker(rhs.m_modules_mutex);
             m_modules = rhs.m_modules;
+            RebuildIndexes();
         }
         else
         {
             Mutex::Locker rhs_locker(rhs.m_modules_mutex);
             Mutex::Locker lhs_locker(m_modules_mutex);
             m_modules = rhs.m_modules;
+            RebuildIndexes();
         }
     }
     return *this;
@@ -100,13 +118,119 @@ ModuleList::~ModuleList()
 {
 }
 
+void
+ModuleList::EnableIndexes ()
+{
+    Mutex::Locker locker(m_modules_mutex);
+    if (!m_indexed)
+    {
+        m_indexed = true;
+        RebuildIndexes();
+    }
+}
+
+void
+ModuleList::AddToIndexes (Module *module)
+{
+    IndexKeys keys;
+    const UUID &uuid = module->GetUUID();
+    if (uuid.IsValid())
+    {
+        keys.uuid = uuid.GetAsString();
+        m_uuid_index[keys.uuid].push_back(module);
+    }
+    keys.file_name = module->GetFileSpec().GetFilename().GetCString();
+    m_file_index[keys.file_name].push_back(module);
+    m_index_keys[module] = keys;
+}
+
+void
+ModuleList::RemoveFromIndexes (Module *module)
+{
+    // Use the keys the module was added with in case its file spec changed
+    // since then.
+    IndexKeysMap::iterator keys_pos = m_index_keys.find(module);
+    if (keys_pos == m_index_keys.end())
+        return;
+
+    const IndexKeys &keys = keys_pos->second;
+    if (!keys.uuid.empty())
+    {
+        UUIDIndex::iterator pos = m_uuid_index.find(keys.uuid);
+        if (pos != m_uuid_index.end())
+        {
+            std::vector<Module *> &modules = pos->second;
+            modules.erase(std::remove(modules.begin(), modules.end(), module), modules.end());
+            if (modules.empty())
+                m_uuid_index.erase(pos);
+        }
+    }
+    FileIndex::iterator pos = m_file_index.find(keys.file_name);
+    if (pos != m_file_index.end())
+    {
+        std::vector<Module *> &modules = pos->second;
+        modules.erase(std::remove(modules.begin(), modules.end(), module), modules.end());
+        if (modules.empty())
+            m_file_index.erase(pos);
+    }
+    m_index_keys.erase(keys_pos);
+}
+
+void
+ModuleList::RebuildIndexes ()
+{
+    m_uuid_index.clear();
+    m_file_index.clear();
+    m_index_keys.clear();
+    if (m_indexed)
+    {
+        for (const ModuleSP &module_sp : m_modules)
+            AddToIndexes(module_sp.get());
+    }
+}
+
+bool
+ModuleList::GetIndexedModules (const ModuleSpec &module_spec, std::vector<Module *> &modules) const
+{
+    modules.clear();
+    if (!m_indexed)
+        return false;
+
+    // A valid UUID is all Module::MatchesModuleSpec() looks at, otherwise
+    // any module that matches must have the same file name.
+    const UUID &uuid = module_spec.GetUUID();
+    if (uuid.IsValid())
+    {
+        UUIDIndex::const_iterator pos = m_uuid_index.find(uuid.GetAsString());
+        if (pos != m_uuid_index.end())
+            modules = pos->second;
+        return true;
+    }
+
+    const ConstString &file_name = module_spec.GetFileSpec().GetFilename();
+    if (file_name)
+    {
+        FileIndex::const_iterator pos = m_file_index.find(file_name.GetCString());
+        if (pos != m_file_index.end())
+            modules = pos->second;
+        return true;
+    }
+    return false;
+}
+
 void
 ModuleList::AppendImpl (const ModuleSP &module_sp, bool use_notifier)
 {
     if (module_sp)
     {
+        // Getting the UUID can parse the object file, so don't do it the
+        // first time with the list locked.
+        if (m_indexed)
+            module_sp->GetUUID();
         Mutex::Locker locker(m_modules_mutex);
         m_modules.push_back(module_sp);
+        if (m_indexed)
+            AddToIndexes(module_sp.get());
         if (use_notifier && m_notifier)
             m_notifier->ModuleAdded(*this, module_sp);
     }
@@ -123,6 +247,8 @@ ModuleList::ReplaceEquivalent (const ModuleSP &module_sp)
 {
     if (module_sp)
     {
+        if (m_indexed)
+            module_sp->GetUUID();
         Mutex::Locker locker(m_modules_mutex);
 
         // First remove any equivalent modules. Equivalent modules are modules
@@ -130,14 +256,26 @@ ModuleList::ReplaceEquivalent (const ModuleSP &module_sp)
         ModuleSpec equivalent_module_spec (module_sp->GetFileSpec(), module_sp->GetArchitecture());
         equivalent_module_spec.GetPlatformFileSpec() = module_sp->GetPlatformFileSpec();
 
-        size_t idx = 0;
-        while (idx < m_modules.size())
+        std::vector<Module *> indexed_modules;
+        if (GetIndexedModules (equivalent_module_spec, indexed_modules))
         {
-            ModuleSP module_sp (m_modules[idx]);
-            if (module_sp->MatchesModuleSpec (equivalent_module_spec))
-                RemoveImpl(m_modules.begin() + idx);
-            else
-                ++idx;
+            for (Module *module : indexed_modules)
+            {
+                if (module->MatchesModuleSpec (equivalent_module_spec))
+                    RemoveImpl(module->shared_from_this());
+            }
+        }
+        else
+        {
+            size_t idx = 0;
+            while (idx < m_modules.size())
+            {
+                ModuleSP module_sp (m_modules[idx]);
+                if (module_sp->MatchesModuleSpec (equivalent_module_spec))
+                    RemoveImpl(m_modules.begin() + idx);
+                else
+                    ++idx;
+            }
         }
         // Now add the new module to the list
         Append(module_sp);
@@ -150,12 +288,20 @@ ModuleList::AppendIfNeeded (const ModuleSP &module_sp)
     if (module_sp)
     {
         Mutex::Locker locker(m_modules_mutex);
-        collection::iterator pos, end = m_modules.end();
-        for (pos = m_modules.begin(); pos != end; ++pos)
+        if (m_indexed)
         {
-            if (pos->get() == module_sp.get())
+            if (m_index_keys.count(module_sp.get()))
                 return false; // Already in the list
         }
+        else
+        {
+            collection::iterator pos, end = m_modules.end();
+            for (pos = m_modules.begin(); pos != end; ++pos)
+            {
+                if (pos->get() == module_sp.get())
+                    return false; // Already in the list
+            }
+        }
         // Only push module_sp on the list if it wasn't already in there.
         Append(module_sp);
         return true;
@@ -188,11 +334,15 @@ ModuleList::RemoveImpl (const ModuleSP &module_sp, bool use_notifier)
     if (module_sp)
     {
         Mutex::Locker locker(m_modules_mutex);
+        if (m_indexed && !m_index_keys.count(module_sp.get()))
+            return false;
         collection::iterator pos, end = m_modules.end();
         for (pos = m_modules.begin(); pos != end; ++pos)
         {
             if (pos->get() == module_sp.get())
             {
+                if (m_indexed)
+                    RemoveFromIndexes(module_sp.get());
                 m_modules.erase (pos);
                 if (use_notifier && m_notifier)
                     m_notifier->ModuleRemoved(*this, module_sp);
@@ -207,6 +357,8 @@ ModuleList::collection::iterator
 ModuleList::RemoveImpl (ModuleList::collection::iterator pos, bool use_notifier)
 {
     ModuleSP module_sp(*pos);
+    if (m_indexed)
+        RemoveFromIndexes(module_sp.get());
     collection::iterator retval = m_modules.erase(pos);
     if (use_notifier && m_notifier)
         m_notifier->ModuleRemoved(*this, module_sp);
@@ -320,6 +472,9 @@ ModuleList::ClearImpl (bool use_notifier)
     if (use_notifier && m_notifier)
         m_notifier->WillClearList(*this);
     m_modules.clear();
+    m_uuid_index.clear();
+    m_file_index.clear();
+    m_index_keys.clear();
 }
 
 Module*
@@ -596,6 +751,17 @@ ModuleList::FindModules (const ModuleSpec &module_spec, ModuleList& matching_mod
     size_t existing_matches = matching_module_list.GetSize();
 
     Mutex::Locker locker(m_modules_mutex);
+    std::vector<Module *> indexed_modules;
+    if (GetIndexedModules (module_spec, indexed_modules))
+    {
+        for (Module *module : indexed_modules)
+        {
+            if (module->MatchesModuleSpec (module_spec))
+                matching_module_list.Append(module->shared_from_this());
+        }
+        return matching_module_list.GetSize() - existing_matches;
+    }
+
     collection::const_iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos)
     {
@@ -614,6 +780,13 @@ ModuleList::FindModule (const Module *module_ptr) const
     // Scope for "locker"
     {
         Mutex::Locker locker(m_modules_mutex);
+        if (m_indexed)
+        {
+            if (m_index_keys.count(module_ptr))
+                module_sp = const_cast<Module *>(module_ptr)->shared_from_this();
+            return module_sp;
+        }
+
         collection::const_iterator pos, end = m_modules.end();
 
         for (pos = m_modules.begin(); pos != end; ++pos)
@@ -637,6 +810,14 @@ ModuleList::FindModule (const UUID &uuid) const
     if (uuid.IsValid())
     {
         Mutex::Locker locker(m_modules_mutex);
+        if (m_indexed)
+        {
+            UUIDIndex::const_iterator pos = m_uuid_index.find(uuid.GetAsString());
+            if (pos != m_uuid_index.end() && !pos->second.empty())
+                module_sp = pos->second.front()->shared_from_this();
+            return module_sp;
+        }
+
         collection::const_iterator pos, end = m_modules.end();
         
         for (pos = m_modules.begin(); pos != end; ++pos)
@@ -726,6 +907,17 @@ ModuleList::FindFirstModule (const ModuleSpec &module_spec) const
 {
     ModuleSP module_sp;
     Mutex::Locker locker(m_modules_mutex);
+    std::vector<Module *> indexed_modules;
+    if (GetIndexedModules (module_spec, indexed_modules))
+    {
+        for (Module *module : indexed_modules)
+        {
+            if (module->MatchesModuleSpec (module_spec))
+                return module->shared_from_this();
+        }
+        return module_sp;
+    }
+
     collection::const_iterator pos, end = m_modules.end();
     for (pos = m_modules.begin(); pos != end; ++pos)
     {
@@ -884,6 +1076,9 @@ GetSharedModuleList ()
         // doing a bunch of cleanup that isn't required.
         if (g_shared_module_list == NULL)
             g_shared_module_list = new ModuleList(); // <--- Intentional leak!!!
+        // The shared module list gets large and is searched on every module
+        // load, so keep it indexed by UUID and file name.
+        g_shared_module_list->EnableIndexes();
     });
     return *g_shared_module_list;
 }
@@ -911,6 +1106,138 @@ ModuleList::RemoveOrphanSharedModules (bool mandatory)
     return GetSharedModuleList ().RemoveOrphans(mandatory);
 }
 
+namespace
+{
+    //----------------------------------------------------------------------
+    // Marks the module GetSharedModule is looking for as being created,
+    // by its UUID and its path. Threads that look for the same module wait
+    // until it is in the shared module list instead of creating it again,
+    // while threads that look for other modules go ahead and parse their
+    // object files in parallel.
+    //----------------------------------------------------------------------
+    class SharedModuleCreationLocker
+    {
+    public:
+        SharedModuleCreationLocker (const ModuleSpec &module_spec) :
+            m_keys ()
+        {
+            std::vector<std::string> keys;
+            const UUID *uuid_ptr = module_spec.GetUUIDPtr();
+            if (uuid_ptr)
+                keys.push_back ("uuid:" + uuid_ptr->GetAsString());
+            if (module_spec.GetFileSpec())
+                keys.push_back ("path:" + module_spec.GetFileSpec().GetPath());
+
+            const lldb::tid_t tid = Host::GetCurrentThreadID();
+            Mutex::Locker locker (GetMutex());
+            // Creating a module can look up other modules on the same thread,
+            // e.g. DWO files. Only the outermost lookup waits, so a thread
+            // never waits while other threads wait for it and the lookups
+            // can't deadlock. A nested lookup that races with another thread
+            // at worst parses the object file twice, AddCreatedSharedModule
+            // keeps a single module in the list.
+            if (!IsCreatingModule (tid))
+            {
+                while (IsCreatedByOtherThread (keys, tid))
+                    GetCondition().Wait (GetMutex());
+            }
+            for (const std::string &key : keys)
+            {
+                if (GetKeysInFlight().insert (std::make_pair (key, tid)).second)
+                    m_keys.push_back (key);
+            }
+        }
+
+        ~SharedModuleCreationLocker ()
+        {
+            if (m_keys.empty())
+                return;
+            Mutex::Locker locker (GetMutex());
+            for (const std::string &key : m_keys)
+                GetKeysInFlight().erase (key);
+            GetCondition().Broadcast();
+        }
+
+    private:
+        static bool
+        IsCreatingModule (lldb::tid_t tid)
+        {
+            for (const auto &key_and_tid : GetKeysInFlight())
+            {
+                if (key_and_tid.second == tid)
+                    return true;
+            }
+            return false;
+        }
+
+        static bool
+        IsCreatedByOtherThread (const std::vector<std::string> &keys, lldb::tid_t tid)
+        {
+            for (const std::string &key : keys)
+            {
+                auto pos = GetKeysInFlight().find (key);
+                if (pos != GetKeysInFlight().end() && pos->second != tid)
+                    return true;
+            }
+            return false;
+        }
+
+        static Mutex &
+        GetMutex ()
+        {
+            static Mutex g_mutex;
+            return g_mutex;
+        }
+
+        static Condition &
+        GetCondition ()
+        {
+            static Condition g_condition;
+            return g_condition;
+        }
+
+        static std::map<std::string, lldb::tid_t> &
+        GetKeysInFlight ()
+        {
+            static std::map<std::string, lldb::tid_t> g_keys;
+            return g_keys;
+        }
+
+        std::vector<std::string> m_keys;
+
+        DISALLOW_COPY_AND_ASSIGN (SharedModuleCreationLocker);
+    };
+
+    //----------------------------------------------------------------------
+    // Adds a module that GetSharedModule created to the shared module list.
+    // The list isn't locked while the object file is parsed, so another
+    // thread may have added the same module that it found by a different
+    // path or UUID. In that case \a module_sp is set to the module that is
+    // already in the list and false is returned.
+    //----------------------------------------------------------------------
+    bool
+    AddCreatedSharedModule (ModuleList &shared_module_list, ModuleSP &module_sp)
+    {
+        Mutex::Locker locker (shared_module_list.GetMutex());
+        ModuleSpec module_spec (module_sp->GetFileSpec(), module_sp->GetArchitecture());
+        module_spec.GetUUID() = module_sp->GetUUID();
+        module_spec.GetObjectName() = module_sp->GetObjectName();
+        ModuleList matching_module_list;
+        const size_t num_matching_modules = shared_module_list.FindModules (module_spec, matching_module_list);
+        for (size_t module_idx = 0; module_idx < num_matching_modules; ++module_idx)
+        {
+            ModuleSP matching_module_sp = matching_module_list.GetModuleAtIndex(module_idx);
+            if (matching_module_sp->GetModificationTime() == module_sp->GetModificationTime())
+            {
+                module_sp = matching_module_sp;
+                return false;
+            }
+        }
+        shared_module_list.ReplaceEquivalent(module_sp);
+        return true;
+    }
+}
+
 Error
 ModuleList::GetSharedModule
 (
@@ -923,7 +1250,9 @@ ModuleList::GetSharedModule
 )
 {
     ModuleList &shared_module_list = GetSharedModuleList ();
-    Mutex::Locker locker(shared_module_list.m_modules_mutex);
+    // Only lookups of the same module wait for each other, the shared module
+    // list itself is locked just for each lookup and insertion.
+    SharedModuleCreationLocker creation_locker (module_spec);
     char path[PATH_MAX];
 
     Error error;
@@ -939,9 +1268,6 @@ ModuleList::GetSharedModule
     const FileSpec &module_file_spec = module_spec.GetFileSpec();
     const ArchSpec &arch = module_spec.GetArchitecture();
 
-    // Make sure no one else can try and get or create a module while this
-    // function is actively working on it by doing an extra lock on the
-    // global mutex list.
     if (always_create == false)
     {
         ModuleList matching_module_list;
@@ -991,10 +1317,8 @@ ModuleList::GetSharedModule
             module_sp.reset();
         else
         {
-            if (did_create_ptr)
+            if (AddCreatedSharedModule (shared_module_list, module_sp) && did_create_ptr)
                 *did_create_ptr = true;
-
-            shared_module_list.ReplaceEquivalent(module_sp);
             return error;
         }
     }
@@ -1026,10 +1350,8 @@ ModuleList::GetSharedModule
                     module_sp.reset();
                 else
                 {
-                    if (did_create_ptr)
+                    if (AddCreatedSharedModule (shared_module_list, module_sp) && did_create_ptr)
                         *did_create_ptr = true;
-
-                    shared_module_list.ReplaceEquivalent(module_sp);
                     return Error();
                 }
             }
@@ -1080,9 +1402,6 @@ ModuleList::GetSharedModule
         }
 
 
-        // Make sure no one else can try and get or create a module while this
-        // function is actively working on it by doing an extra lock on the
-        // global mutex list.
         ModuleSpec platform_module_spec(module_spec);
         platform_module_spec.GetFileSpec() = file_spec;
         platform_module_spec.GetPlatformFileSpec() = file_spec;
@@ -1117,10 +1436,8 @@ ModuleList::GetSharedModule
             // By getting the object file we can guarantee that the architecture matches
             if (module_sp && module_sp->GetObjectFile())
             {
-                if (did_create_ptr)
+                if (AddCreatedSharedModule (shared_module_list, module_sp) && did_create_ptr)
                     *did_create_ptr = true;
-
-                shared_module_list.ReplaceEquivalent(module_sp);
             }
             else
             {
@@ -11,12 +11,21 @@
 #include <map>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
 
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamFile.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/ThisThread.h"
+
+#include "llvm/ADT/SmallString.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 
 using namespace lldb_private;
 
@@ -28,6 +37,189 @@ FILE * Timer::g_file = NULL;
 typedef std::vector<Timer *> TimerStack;
 typedef std::map<const char *, uint64_t> TimerCategoryMap;
 static lldb::thread_key_t g_key;
+static lldb::thread_key_t g_trace_buffer_key;
+static std::atomic<bool> g_tracing (false);
+static std::atomic<uint32_t> g_trace_generation (0);
+static std::string g_trace_file;
+
+namespace {
+
+struct TraceEvent
+{
+    const char *name;
+    uint64_t timestamp;
+    bool begin;
+};
+
+//----------------------------------------------------------------------
+// The trace events of one thread. Only the owning thread appends events;
+// they are stored in fixed size chunks that never move so the events can
+// be read by another thread while the owner keeps appending. Starting a
+// new trace bumps g_trace_generation, and the owner drops its old events
+// the next time it appends. When the owner exits the buffer is kept, with
+// its chunks, for a new thread to reuse.
+//----------------------------------------------------------------------
+class TraceBuffer
+{
+public:
+    static const size_t kEventsPerChunk = 16 * 1024;
+    static const size_t kMaxChunks = 64;
+
+    TraceBuffer () :
+        m_thread_id (LLDB_INVALID_THREAD_ID),
+        m_thread_name (),
+        m_generation (0),
+        m_num_events (0)
+    {
+        for (size_t i = 0; i < kMaxChunks; ++i)
+            m_chunks[i] = NULL;
+        SetOwnerToCurrentThread ();
+    }
+
+    // Drops all events and gives the buffer to the calling thread. The
+    // trace buffers mutex must be locked so a dump doesn't read the buffer
+    // while it changes owners.
+    void
+    SetOwnerToCurrentThread ()
+    {
+        m_thread_id = Host::GetCurrentThreadID();
+        llvm::SmallString<32> thread_name;
+        ThisThread::GetName (thread_name);
+        m_thread_name.assign (thread_name.data(), thread_name.size());
+        m_num_events.store (0, std::memory_order_relaxed);
+        m_generation.store (g_trace_generation.load (std::memory_order_acquire), std::memory_order_release);
+    }
+
+    // Returns false if the buffer is full.
+    bool
+    Append (const char *name, bool begin)
+    {
+        const uint32_t generation = g_trace_generation.load (std::memory_order_acquire);
+        if (m_generation.load (std::memory_order_relaxed) != generation)
+        {
+            // Reset the count before publishing the new generation so a
+            // reader never sees old events as part of the new trace.
+            m_num_events.store (0, std::memory_order_relaxed);
+            m_generation.store (generation, std::memory_order_release);
+        }
+        const size_t idx = m_num_events.load (std::memory_order_relaxed);
+        const size_t chunk_idx = idx / kEventsPerChunk;
+        if (chunk_idx >= kMaxChunks)
+            return false;
+        TraceEvent *chunk = m_chunks[chunk_idx].load (std::memory_order_relaxed);
+        if (chunk == NULL)
+        {
+            chunk = new TraceEvent[kEventsPerChunk];
+            m_chunks[chunk_idx].store (chunk, std::memory_order_relaxed);
+        }
+        TraceEvent &event = chunk[idx % kEventsPerChunk];
+        event.name = name;
+        event.timestamp = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970();
+        event.begin = begin;
+        m_num_events.store (idx + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Events from an earlier trace don't count.
+    size_t
+    GetNumEvents () const
+    {
+        if (m_generation.load (std::memory_order_acquire) != g_trace_generation.load (std::memory_order_acquire))
+            return 0;
+        return m_num_events.load (std::memory_order_acquire);
+    }
+
+    const TraceEvent &
+    GetEventAtIndex (size_t idx) const
+    {
+        return m_chunks[idx / kEventsPerChunk].load (std::memory_order_relaxed)[idx % kEventsPerChunk];
+    }
+
+    lldb::tid_t
+    GetThreadID () const
+    {
+        return m_thread_id;
+    }
+
+    const std::string &
+    GetThreadName () const
+    {
+        return m_thread_name;
+    }
+
+private:
+    lldb::tid_t m_thread_id;
+    std::string m_thread_name;
+    std::atomic<uint32_t> m_generation; // The trace the events belong to
+    std::atomic<size_t> m_num_events;
+    std::atomic<TraceEvent *> m_chunks[kMaxChunks];
+};
+
+} // anonymous namespace
+
+static Mutex &
+GetTraceBuffersMutex ()
+{
+    static Mutex g_trace_buffers_mutex(Mutex::eMutexTypeNormal);
+    return g_trace_buffers_mutex;
+}
+
+// Once there are this many buffers, new threads take over the buffers of
+// exited threads even if that drops events from the current trace.
+static const size_t kMaxTraceBuffers = 256;
+
+// All buffers, including those of threads that have exited, so the events
+// of exited threads can still be dumped.
+static std::vector<TraceBuffer *> &
+GetTraceBuffers ()
+{
+    static std::vector<TraceBuffer *> g_trace_buffers;
+    return g_trace_buffers;
+}
+
+// The buffers of exited threads, oldest first.
+static std::vector<TraceBuffer *> &
+GetFreeTraceBuffers ()
+{
+    static std::vector<TraceBuffer *> g_free_trace_buffers;
+    return g_free_trace_buffers;
+}
+
+static void
+ReleaseTraceBuffer (void *p)
+{
+    Mutex::Locker locker (GetTraceBuffersMutex());
+    GetFreeTraceBuffers().push_back ((TraceBuffer *)p);
+}
+
+static TraceBuffer *
+GetTraceBufferForCurrentThread ()
+{
+    TraceBuffer *trace_buffer = (TraceBuffer *)Host::ThreadLocalStorageGet(g_trace_buffer_key);
+    if (trace_buffer == NULL)
+    {
+        Mutex::Locker locker (GetTraceBuffersMutex());
+        std::vector<TraceBuffer *> &free_buffers = GetFreeTraceBuffers();
+        // Prefer a buffer with no events in the current trace.
+        auto pos = std::find_if (free_buffers.begin(), free_buffers.end(),
+                                 [] (const TraceBuffer *buffer) { return buffer->GetNumEvents() == 0; });
+        if (pos == free_buffers.end() && !free_buffers.empty() && GetTraceBuffers().size() >= kMaxTraceBuffers)
+            pos = free_buffers.begin();
+        if (pos != free_buffers.end())
+        {
+            trace_buffer = *pos;
+            free_buffers.erase (pos);
+            trace_buffer->SetOwnerToCurrentThread ();
+        }
+        else
+        {
+            trace_buffer = new TraceBuffer();
+            GetTraceBuffers().push_back (trace_buffer);
+        }
+        Host::ThreadLocalStorageSet(g_trace_buffer_key, trace_buffer);
+    }
+    return trace_buffer;
+}
 
 static Mutex &
 GetCategoryMutex()
@@ -73,6 +265,27 @@ Timer::Initialize ()
 {
     Timer::g_file = stdout;
     g_key = Host::ThreadLocalStorageCreate(ThreadSpecificCleanup);
+    g_trace_buffer_key = Host::ThreadLocalStorageCreate(ReleaseTraceBuffer);
+
+    const char *trace_file = ::getenv ("LLDB_TRACE_FILE");
+    if (trace_file && trace_file[0])
+    {
+        g_trace_file = trace_file;
+        SetTracing (true);
+    }
+}
+
+void
+Timer::Terminate ()
+{
+    if (g_trace_file.empty())
+        return;
+
+    SetTracing (false);
+    StreamFile trace_stream (g_trace_file.c_str(), File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate);
+    if (trace_stream.GetFile().IsValid())
+        DumpChromeTrace (trace_stream);
+    g_trace_file.clear();
 }
 
 Timer::Timer (const char *category, const char *format, ...) :
@@ -80,8 +293,12 @@ Timer::Timer (const char *category, const char *format, ...) :
     m_total_start (),
     m_timer_start (),
     m_total_ticks (0),
-    m_timer_ticks (0)
+    m_timer_ticks (0),
+    m_traced (false)
 {
+    if (g_tracing.load (std::memory_order_relaxed))
+        m_traced = GetTraceBufferForCurrentThread()->Append (m_category, true);
+
     if (g_depth++ < g_display_depth)
     {
         if (g_quiet == false)
@@ -113,6 +330,9 @@ Timer::Timer (const char *category, const char *format, ...) :
 
 Timer::~Timer()
 {
+    if (m_traced)
+        GetTraceBufferForCurrentThread()->Append (m_category, false);
+
     if (m_total_start.IsValid())
     {
         TimeValue stop_time = TimeValue::Now();
@@ -248,3 +468,81 @@ Timer::DumpCategoryTimes (Stream *s)
         s->Printf("%.9f sec for %s\n", timer_nsec / 1000000000.0, sorted_iterators[i]->first);
     }
 }
+
+void
+Timer::SetTracing (bool enable)
+{
+    // Each thread drops its own events from the last trace, clearing them
+    // from here would race with threads that are still appending.
+    if (enable)
+        g_trace_generation.fetch_add (1, std::memory_order_acq_rel);
+    g_tracing.store (enable);
+}
+
+bool
+Timer::GetTracing ()
+{
+    return g_tracing.load();
+}
+
+static void
+DumpJSONString (Stream &s, const char *cstr)
+{
+    s.PutChar ('"');
+    for (const char *p = cstr; p && *p; ++p)
+    {
+        const unsigned char ch = *p;
+        if (ch == '"' || ch == '\\')
+            s.Printf ("\\%c", ch);
+        else if (ch < 0x20)
+            s.Printf ("\\u%4.4x", ch);
+        else
+            s.PutChar (ch);
+    }
+    s.PutChar ('"');
+}
+
+void
+Timer::DumpChromeTrace (Stream &s)
+{
+    const uint64_t pid = Host::GetCurrentProcessID();
+    bool first = true;
+
+    s.PutCString ("{\"traceEvents\":[");
+    Mutex::Locker locker (GetTraceBuffersMutex());
+    for (const TraceBuffer *buffer : GetTraceBuffers())
+    {
+        const size_t num_events = buffer->GetNumEvents();
+        if (num_events == 0)
+            continue;
+
+        const uint64_t tid = buffer->GetThreadID();
+        s.Printf ("%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%" PRIu64 ",\"tid\":%" PRIu64 ",\"args\":{\"name\":",
+                  first ? "" : ",", pid, tid);
+        first = false;
+        if (buffer->GetThreadName().empty())
+        {
+            char thread_name[64];
+            ::snprintf (thread_name, sizeof(thread_name), "thread 0x%" PRIx64, tid);
+            DumpJSONString (s, thread_name);
+        }
+        else
+            DumpJSONString (s, buffer->GetThreadName().c_str());
+        s.PutCString ("}}");
+
+        for (size_t i = 0; i < num_events; ++i)
+        {
+            const TraceEvent &event = buffer->GetEventAtIndex (i);
+            // Chrome trace timestamps are in microseconds
+            s.PutCString (",\n{\"name\":");
+            DumpJSONString (s, event.name);
+            s.Printf (",\"cat\":\"lldb\",\"ph\":\"%c\",\"ts\":%" PRIu64 ".%3.3" PRIu64 ",\"pid\":%" PRIu64 ",\"tid\":%" PRIu64 "}",
+                      event.begin ? 'B' : 'E',
+                      event.timestamp / 1000,
+                      event.timestamp % 1000,
+                      pid,
+                      tid);
+        }
+    }
+    s.PutCString ("\n],\"displayTimeUnit\":\"ns\"}\n");
+}
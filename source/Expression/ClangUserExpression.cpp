@@ -564,7 +564,11 @@ ClangUserExpression::Parse (Stream &error_stream,
 
     ClangExpressionParser parser(exe_scope, *this, generate_debug_info);
 
-    unsigned num_errors = parser.Parse (error_stream);
+    unsigned num_errors;
+    {
+        Target::Statistics::ScopedDuration parse_duration (target, Target::Statistics::eDurationExpressionParse);
+        num_errors = parser.Parse (error_stream);
+    }
 
     if (num_errors)
     {
@@ -579,12 +583,16 @@ ClangUserExpression::Parse (Stream &error_stream,
     // Prepare the output of the parser for execution, evaluating it statically if possible
     //
 
-    Error jit_error = parser.PrepareForExecution (m_jit_start_addr,
-                                                  m_jit_end_addr,
-                                                  m_execution_unit_sp,
-                                                  exe_ctx,
-                                                  m_can_interpret,
-                                                  execution_policy);
+    Error jit_error;
+    {
+        Target::Statistics::ScopedDuration jit_duration (target, Target::Statistics::eDurationExpressionJIT);
+        jit_error = parser.PrepareForExecution (m_jit_start_addr,
+                                                m_jit_end_addr,
+                                                m_execution_unit_sp,
+                                                exe_ctx,
+                                                m_can_interpret,
+                                                execution_policy);
+    }
 
     if (generate_debug_info)
     {
@@ -941,10 +949,14 @@ ClangUserExpression::Execute (Stream &error_stream,
             if (exe_ctx.GetProcessPtr())
                 exe_ctx.GetProcessPtr()->SetRunningUserExpression(true);
 
-            lldb::ExpressionResults execution_result = exe_ctx.GetProcessRef().RunThreadPlan (exe_ctx,
-                                                                                       call_plan_sp,
-                                                                                       options,
-                                                                                       error_stream);
+            lldb::ExpressionResults execution_result;
+            {
+                Target::Statistics::ScopedDuration run_duration (exe_ctx.GetTargetPtr(), Target::Statistics::eDurationExpressionRun);
+                execution_result = exe_ctx.GetProcessRef().RunThreadPlan (exe_ctx,
+                                                                          call_plan_sp,
+                                                                          options,
+                                                                          error_stream);
+            }
 
             if (exe_ctx.GetProcessPtr())
                 exe_ctx.GetProcessPtr()->SetRunningUserExpression(false);
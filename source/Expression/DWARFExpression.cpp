@@ -223,7 +223,8 @@ DWARFExpression::DWARFExpression() :
     m_module_wp(),
     m_data(),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide (LLDB_INVALID_ADDRESS)
+    m_loclist_slide (LLDB_INVALID_ADDRESS),
+    m_compiled_sp ()
 {
 }
 
@@ -231,16 +232,32 @@ DWARFExpression::DWARFExpression(const DWARFExpression& rhs) :
     m_module_wp(rhs.m_module_wp),
     m_data(rhs.m_data),
     m_reg_kind (rhs.m_reg_kind),
-    m_loclist_slide(rhs.m_loclist_slide)
+    m_loclist_slide(rhs.m_loclist_slide),
+    m_compiled_sp(std::atomic_load (&rhs.m_compiled_sp))
 {
 }
 
+DWARFExpression &
+DWARFExpression::operator = (const DWARFExpression& rhs)
+{
+    if (this != &rhs)
+    {
+        m_module_wp = rhs.m_module_wp;
+        m_data = rhs.m_data;
+        m_reg_kind = rhs.m_reg_kind;
+        m_loclist_slide = rhs.m_loclist_slide;
+        std::atomic_store (&m_compiled_sp, std::atomic_load (&rhs.m_compiled_sp));
+    }
+    return *this;
+}
+
 
 DWARFExpression::DWARFExpression(lldb::ModuleSP module_sp, const DataExtractor& data, lldb::offset_t data_offset, lldb::offset_t data_length) :
     m_module_wp(),
     m_data(data, data_offset, data_length),
     m_reg_kind (eRegisterKindDWARF),
-    m_loclist_slide(LLDB_INVALID_ADDRESS)
+    m_loclist_slide(LLDB_INVALID_ADDRESS),
+    m_compiled_sp()
 {
     if (module_sp)
         m_module_wp = module_sp;
@@ -264,6 +281,7 @@ void
 DWARFExpression::SetOpcodeData (const DataExtractor& data)
 {
     m_data = data;
+    ClearCompiledLocation();
 }
 
 void
@@ -273,6 +291,7 @@ DWARFExpression::CopyOpcodeData (lldb::ModuleSP module_sp, const DataExtractor&
     if (bytes)
     {
         m_module_wp = module_sp;
+        ClearCompiledLocation();
         m_data.SetData(DataBufferSP(new DataBufferHeap(bytes, data_length)));
         m_data.SetByteOrder(data.GetByteOrder());
         m_data.SetAddressByteSize(data.GetAddressByteSize());
@@ -287,6 +306,7 @@ DWARFExpression::CopyOpcodeData (const void *data,
 {
     if (data && data_length)
     {
+        ClearCompiledLocation();
         m_data.SetData(DataBufferSP(new DataBufferHeap(data, data_length)));
         m_data.SetByteOrder(byte_order);
         m_data.SetAddressByteSize(addr_byte_size);
@@ -300,6 +320,7 @@ DWARFExpression::CopyOpcodeData (uint64_t const_value,
 {
     if (const_value_byte_size)
     {
+        ClearCompiledLocation();
         m_data.SetData(DataBufferSP(new DataBufferHeap(&const_value, const_value_byte_size)));
         m_data.SetByteOrder(endian::InlHostByteOrder());
         m_data.SetAddressByteSize(addr_byte_size);
@@ -311,6 +332,7 @@ DWARFExpression::SetOpcodeData (lldb::ModuleSP module_sp, const DataExtractor& d
 {
     m_module_wp = module_sp;
     m_data.SetData(data, data_offset, data_length);
+    ClearCompiledLocation();
 }
 
 void
@@ -678,6 +700,7 @@ void
 DWARFExpression::SetLocationListSlide (addr_t slide)
 {
     m_loclist_slide = slide;
+    ClearCompiledLocation();
 }
 
 int
@@ -1121,6 +1144,7 @@ DWARFExpression::Update_DW_OP_addr (lldb::addr_t file_addr)
             // pointer to the heap data so "m_data" will now correctly 
             // manage the heap data.
             m_data.SetData (DataBufferSP (head_data_ap.release()));
+            ClearCompiledLocation();
             return true;
         }
         else
@@ -1232,6 +1256,316 @@ DWARFExpression::DumpLocationForAddress (Stream *s,
     return false;
 }
 
+//----------------------------------------------------------------------
+// A single location expression, classified so that the simple locations
+// that make up the bulk of the variable locations compilers emit can be
+// evaluated without decoding the opcodes again.
+//----------------------------------------------------------------------
+struct DWARFExpression::CompiledExpression
+{
+    enum Kind
+    {
+        eKindGeneral,           // Needs the opcode interpreter
+        eKindAddress,           // DW_OP_addr <address>
+        eKindRegister,          // DW_OP_regN, DW_OP_regx <reg_num>
+        eKindRegisterOffset,    // DW_OP_bregN <offset>, DW_OP_bregx <reg_num> <offset>
+        eKindFrameBaseOffset    // DW_OP_fbreg <offset>
+    };
+
+    CompiledExpression () :
+        kind (eKindGeneral),
+        reg_num (LLDB_INVALID_REGNUM),
+        operand (0),
+        data_offset (0),
+        data_length (0)
+    {
+    }
+
+    Kind kind;
+    uint32_t reg_num;
+    uint64_t operand;           // The address or the signed register/frame base offset
+    lldb::offset_t data_offset; // The opcodes for the interpreter
+    lldb::offset_t data_length;
+};
+
+struct DWARFExpression::CompiledLocation
+{
+    struct Entry
+    {
+        lldb::addr_t lo_pc;     // Relative to the location list slide
+        lldb::addr_t hi_pc;
+        CompiledExpression expr;
+
+        bool
+        operator < (const Entry &rhs) const
+        {
+            return lo_pc < rhs.lo_pc;
+        }
+    };
+
+    CompiledLocation () :
+        expr (),
+        entries (),
+        entries_sorted (false)
+    {
+    }
+
+    CompiledExpression expr;        // The expression if this isn't a location list
+    std::vector<Entry> entries;     // The location list entries with a non-empty expression
+    bool entries_sorted;            // True if "entries" don't overlap and are sorted by address
+};
+
+DWARFExpression::CompiledExpression
+DWARFExpression::CompileExpression (const DataExtractor &data, lldb::offset_t data_offset, lldb::offset_t data_length)
+{
+    CompiledExpression expr;
+    expr.data_offset = data_offset;
+    expr.data_length = data_length;
+    if (data_length == 0 || !data.ValidOffsetForDataOfSize(data_offset, data_length))
+        return expr;
+
+    lldb::offset_t offset = data_offset;
+    const uint8_t op = data.GetU8(&offset);
+    CompiledExpression::Kind kind = CompiledExpression::eKindGeneral;
+    if (op == DW_OP_addr)
+    {
+        kind = CompiledExpression::eKindAddress;
+        expr.operand = data.GetAddress(&offset);
+    }
+    else if (op >= DW_OP_reg0 && op <= DW_OP_reg31)
+    {
+        kind = CompiledExpression::eKindRegister;
+        expr.reg_num = op - DW_OP_reg0;
+    }
+    else if (op == DW_OP_regx)
+    {
+        kind = CompiledExpression::eKindRegister;
+        expr.reg_num = data.GetULEB128(&offset);
+    }
+    else if (op >= DW_OP_breg0 && op <= DW_OP_breg31)
+    {
+        kind = CompiledExpression::eKindRegisterOffset;
+        expr.reg_num = op - DW_OP_breg0;
+        expr.operand = data.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_bregx)
+    {
+        kind = CompiledExpression::eKindRegisterOffset;
+        expr.reg_num = data.GetULEB128(&offset);
+        expr.operand = data.GetSLEB128(&offset);
+    }
+    else if (op == DW_OP_fbreg)
+    {
+        kind = CompiledExpression::eKindFrameBaseOffset;
+        expr.operand = data.GetSLEB128(&offset);
+    }
+
+    // Only use the fast path if the opcode is the entire expression
+    if (offset == data_offset + data_length)
+        expr.kind = kind;
+    return expr;
+}
+
+const DWARFExpression::CompiledLocation &
+DWARFExpression::GetCompiledLocation () const
+{
+    std::shared_ptr<CompiledLocation> current_sp (std::atomic_load (&m_compiled_sp));
+    if (current_sp)
+        return *current_sp;
+
+    std::shared_ptr<CompiledLocation> compiled_sp (new CompiledLocation());
+    if (IsLocationList())
+    {
+        // Decode the location list the same way the opcode interpreter
+        // used to walk it on every evaluation.
+        lldb::offset_t offset = 0;
+        while (m_data.ValidOffset(offset))
+        {
+            CompiledLocation::Entry entry;
+            entry.lo_pc = m_data.GetAddress(&offset);
+            entry.hi_pc = m_data.GetAddress(&offset);
+            if (entry.lo_pc == 0 && entry.hi_pc == 0)
+                break;
+            const lldb::offset_t length = m_data.GetU16(&offset);
+            if (length > 0 && entry.lo_pc < entry.hi_pc)
+            {
+                entry.expr = CompileExpression (m_data, offset, length);
+                compiled_sp->entries.push_back(entry);
+            }
+            offset += length;
+        }
+
+        // Entries are searched in order and the first one that matches
+        // wins, so we can only binary search them if none of them overlap.
+        std::vector<CompiledLocation::Entry> sorted_entries (compiled_sp->entries);
+        std::stable_sort (sorted_entries.begin(), sorted_entries.end());
+        bool overlap = false;
+        for (size_t i = 1; i < sorted_entries.size() && !overlap; ++i)
+            overlap = sorted_entries[i].lo_pc < sorted_entries[i-1].hi_pc;
+        if (!overlap)
+        {
+            compiled_sp->entries.swap (sorted_entries);
+            compiled_sp->entries_sorted = true;
+        }
+    }
+    else
+    {
+        compiled_sp->expr = CompileExpression (m_data, 0, m_data.GetByteSize());
+    }
+
+    // Threads that compile the location at the same time all use the one
+    // that got published first. The location isn't replaced until the
+    // expression itself is changed, so the reference stays valid.
+    if (std::atomic_compare_exchange_strong (&m_compiled_sp, &current_sp, compiled_sp))
+        return *compiled_sp;
+    return *current_sp;
+}
+
+const DWARFExpression::CompiledExpression *
+DWARFExpression::FindCompiledExpression (addr_t loclist_base_addr, addr_t addr) const
+{
+    const CompiledLocation &compiled = GetCompiledLocation();
+    if (!IsLocationList())
+        return &compiled.expr;
+
+    // Location list entries are relative to the location list slide
+    const addr_t slid_addr = addr - (loclist_base_addr - m_loclist_slide);
+    if (compiled.entries_sorted)
+    {
+        CompiledLocation::Entry key;
+        key.lo_pc = slid_addr;
+        std::vector<CompiledLocation::Entry>::const_iterator pos;
+        pos = std::upper_bound (compiled.entries.begin(), compiled.entries.end(), key);
+        if (pos != compiled.entries.begin())
+        {
+            --pos;
+            if (slid_addr < pos->hi_pc)
+                return &pos->expr;
+        }
+        return NULL;
+    }
+
+    for (const CompiledLocation::Entry &entry : compiled.entries)
+    {
+        if (entry.lo_pc <= slid_addr && slid_addr < entry.hi_pc)
+            return &entry.expr;
+    }
+    return NULL;
+}
+
+DWARFExpression::SimpleLocationKind
+DWARFExpression::GetSimpleLocation (addr_t loclist_base_addr,
+                                    addr_t addr,
+                                    uint32_t &reg_num,
+                                    uint64_t &operand) const
+{
+    const CompiledExpression *expr = FindCompiledExpression (loclist_base_addr, addr);
+    if (expr == NULL)
+        return eSimpleLocationNone;
+
+    reg_num = expr->reg_num;
+    operand = expr->operand;
+    switch (expr->kind)
+    {
+        case CompiledExpression::eKindAddress:          return eSimpleLocationAddress;
+        case CompiledExpression::eKindRegister:         return eSimpleLocationRegister;
+        case CompiledExpression::eKindRegisterOffset:   return eSimpleLocationRegisterOffset;
+        case CompiledExpression::eKindFrameBaseOffset:  return eSimpleLocationFrameBaseOffset;
+        case CompiledExpression::eKindGeneral:
+            // Frame bases are usually the CFA, which the fast path leaves
+            // to the interpreter since it needs the unwinder.
+            if (expr->data_length == 1)
+            {
+                lldb::offset_t offset = expr->data_offset;
+                if (m_data.GetU8(&offset) == DW_OP_call_frame_cfa)
+                    return eSimpleLocationCallFrameCFA;
+            }
+            break;
+    }
+    return eSimpleLocationNone;
+}
+
+bool
+DWARFExpression::EvaluateCompiledExpression (const CompiledExpression &expr,
+                                             ExecutionContext *exe_ctx,
+                                             ClangExpressionVariableList *expr_locals,
+                                             ClangExpressionDeclMap *decl_map,
+                                             RegisterContext *reg_ctx,
+                                             const Value* initial_value_ptr,
+                                             Value& result,
+                                             Error *error_ptr) const
+{
+    // Keep using the interpreter for verbose logging so the stack gets dumped
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_EXPRESSIONS));
+    if (expr.kind == CompiledExpression::eKindGeneral || (log && log->GetVerbose()))
+        return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, m_module_wp.lock(), m_data, expr.data_offset, expr.data_length, m_reg_kind, initial_value_ptr, result, error_ptr);
+
+    // The simple expressions below must produce exactly what the opcode
+    // interpreter would for the same opcode.
+    StackFrame *frame = NULL;
+    if (exe_ctx)
+        frame = exe_ctx->GetFramePtr();
+    if (reg_ctx == NULL && frame)
+        reg_ctx = frame->GetRegisterContext().get();
+
+    switch (expr.kind)
+    {
+    case CompiledExpression::eKindAddress:
+        result = Value (Scalar (expr.operand));
+        result.SetValueType (Value::eValueTypeFileAddress);
+        return true;
+
+    case CompiledExpression::eKindRegister:
+        {
+            Value value;
+            if (!ReadRegisterValueAsScalar (reg_ctx, m_reg_kind, expr.reg_num, error_ptr, value))
+                return false;
+            result = value;
+        }
+        return true;
+
+    case CompiledExpression::eKindRegisterOffset:
+        {
+            Value value;
+            if (!ReadRegisterValueAsScalar (reg_ctx, m_reg_kind, expr.reg_num, error_ptr, value))
+                return false;
+            value.ResolveValue(exe_ctx) += expr.operand;
+            value.ClearContext();
+            value.SetValueType (Value::eValueTypeLoadAddress);
+            result = value;
+        }
+        return true;
+
+    case CompiledExpression::eKindFrameBaseOffset:
+        if (exe_ctx == NULL)
+        {
+            if (error_ptr)
+                error_ptr->SetErrorStringWithFormat ("NULL execution context for DW_OP_fbreg.\n");
+            return false;
+        }
+        if (frame == NULL)
+        {
+            if (error_ptr)
+                error_ptr->SetErrorString ("Invalid stack frame in context for DW_OP_fbreg opcode.");
+            return false;
+        }
+        else
+        {
+            Scalar value;
+            if (!frame->GetFrameBaseValue(value, error_ptr))
+                return false;
+            value += (int64_t)expr.operand;
+            result = Value (value);
+            result.SetValueType (Value::eValueTypeLoadAddress);
+        }
+        return true;
+
+    default:
+        break;
+    }
+    return false;
+}
+
 bool
 DWARFExpression::Evaluate
 (
@@ -1261,11 +1595,8 @@ DWARFExpression::Evaluate
     Error *error_ptr
 ) const
 {
-    ModuleSP module_sp = m_module_wp.lock();
-
     if (IsLocationList())
     {
-        lldb::offset_t offset = 0;
         addr_t pc;
         StackFrame *frame = NULL;
         if (reg_ctx)
@@ -1290,31 +1621,9 @@ DWARFExpression::Evaluate
                 return false;
             }
 
-            addr_t curr_loclist_base_load_addr = loclist_base_load_addr;
-
-            while (m_data.ValidOffset(offset))
-            {
-                // We need to figure out what the value is for the location.
-                addr_t lo_pc = m_data.GetAddress(&offset);
-                addr_t hi_pc = m_data.GetAddress(&offset);
-                if (lo_pc == 0 && hi_pc == 0)
-                {
-                    break;
-                }
-                else
-                {
-                    lo_pc += curr_loclist_base_load_addr - m_loclist_slide;
-                    hi_pc += curr_loclist_base_load_addr - m_loclist_slide;
-
-                    uint16_t length = m_data.GetU16(&offset);
-
-                    if (length > 0 && lo_pc <= pc && pc < hi_pc)
-                    {
-                        return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, offset, length, m_reg_kind, initial_value_ptr, result, error_ptr);
-                    }
-                    offset += length;
-                }
-            }
+            const CompiledExpression *expr = FindCompiledExpression (loclist_base_load_addr, pc);
+            if (expr)
+                return EvaluateCompiledExpression (*expr, exe_ctx, expr_locals, decl_map, reg_ctx, initial_value_ptr, result, error_ptr);
         }
         if (error_ptr)
             error_ptr->SetErrorString ("variable not available");
@@ -1322,7 +1631,7 @@ DWARFExpression::Evaluate
     }
 
     // Not a location list, just a single expression.
-    return DWARFExpression::Evaluate (exe_ctx, expr_locals, decl_map, reg_ctx, module_sp, m_data, 0, m_data.GetByteSize(), m_reg_kind, initial_value_ptr, result, error_ptr);
+    return EvaluateCompiledExpression (GetCompiledLocation().expr, exe_ctx, expr_locals, decl_map, reg_ctx, initial_value_ptr, result, error_ptr);
 }
 
 
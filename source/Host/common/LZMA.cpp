@@ -0,0 +1,162 @@
+//===-- LZMA.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string.h>
+
+#include "lldb/Host/LZMA.h"
+
+#if defined( LIBLZMA_DEFINED )
+#include <lzma.h>
+#endif
+
+#include "lldb/Core/DataBufferHeap.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+#if defined( LIBLZMA_DEFINED )
+
+static const char *
+ConvertLZMAErrorToString (lzma_ret code)
+{
+    switch (code)
+    {
+        case LZMA_OK:               return "lzma: no error";
+        case LZMA_STREAM_END:       return "lzma: end of stream";
+        case LZMA_NO_CHECK:         return "lzma: input stream has no integrity check";
+        case LZMA_UNSUPPORTED_CHECK:return "lzma: cannot calculate the integrity check";
+        case LZMA_GET_CHECK:        return "lzma: integrity check type is now available";
+        case LZMA_MEM_ERROR:        return "lzma: cannot allocate memory";
+        case LZMA_MEMLIMIT_ERROR:   return "lzma: memory usage limit was reached";
+        case LZMA_FORMAT_ERROR:     return "lzma: file format not recognized";
+        case LZMA_OPTIONS_ERROR:    return "lzma: invalid or unsupported options";
+        case LZMA_DATA_ERROR:       return "lzma: data is corrupt";
+        case LZMA_BUF_ERROR:        return "lzma: no progress is possible";
+        case LZMA_PROG_ERROR:       return "lzma: programming error";
+        default:                    break;
+    }
+    return "lzma: unknown error";
+}
+
+bool
+lzma::IsAvailable ()
+{
+    return true;
+}
+
+Error
+lzma::GetUncompressedSize (const uint8_t *data,
+                           size_t data_size,
+                           uint64_t &uncompressed_size)
+{
+    Error error;
+    if (data == nullptr || data_size < LZMA_STREAM_HEADER_SIZE)
+    {
+        error.SetErrorStringWithFormat ("lzma: %" PRIu64 " bytes is too small to be an .xz stream", (uint64_t)data_size);
+        return error;
+    }
+
+    // Decode the stream footer which is always the last LZMA_STREAM_HEADER_SIZE
+    // bytes of the stream, it tells us where the index lives.
+    lzma_stream_flags opts;
+    ::memset (&opts, 0, sizeof(opts));
+    lzma_ret xzerr = lzma_stream_footer_decode (&opts, data + data_size - LZMA_STREAM_HEADER_SIZE);
+    if (xzerr != LZMA_OK)
+    {
+        error.SetErrorStringWithFormat ("lzma_stream_footer_decode(): %s", ConvertLZMAErrorToString (xzerr));
+        return error;
+    }
+    if (data_size < (opts.backward_size + LZMA_STREAM_HEADER_SIZE))
+    {
+        error.SetErrorStringWithFormat ("lzma: index of %" PRIu64 " bytes doesn't fit in a %" PRIu64 " byte stream",
+                                        (uint64_t)opts.backward_size,
+                                        (uint64_t)data_size);
+        return error;
+    }
+
+    // Decode the index which contains the uncompressed size of every block.
+    lzma_index *xzindex = nullptr;
+    uint64_t memlimit = UINT64_MAX;
+    size_t in_pos = 0;
+    xzerr = lzma_index_buffer_decode (&xzindex,
+                                      &memlimit,
+                                      nullptr,
+                                      data + data_size - LZMA_STREAM_HEADER_SIZE - opts.backward_size,
+                                      &in_pos,
+                                      opts.backward_size);
+    if (xzerr != LZMA_OK)
+    {
+        error.SetErrorStringWithFormat ("lzma_index_buffer_decode(): %s", ConvertLZMAErrorToString (xzerr));
+        return error;
+    }
+
+    uncompressed_size = lzma_index_uncompressed_size (xzindex);
+    lzma_index_end (xzindex, nullptr);
+    return error;
+}
+
+DataBufferSP
+lzma::Uncompress (const uint8_t *data,
+                  size_t data_size,
+                  Error &error)
+{
+    uint64_t uncompressed_size = 0;
+    error = GetUncompressedSize (data, data_size, uncompressed_size);
+    if (error.Fail())
+        return DataBufferSP();
+
+    DataBufferSP buffer_sp (new DataBufferHeap (uncompressed_size, 0));
+    uint64_t memlimit = UINT64_MAX;
+    size_t in_pos = 0;
+    size_t out_pos = 0;
+    lzma_ret xzerr = lzma_stream_buffer_decode (&memlimit,
+                                                0,
+                                                nullptr,
+                                                data,
+                                                &in_pos,
+                                                data_size,
+                                                buffer_sp->GetBytes(),
+                                                &out_pos,
+                                                buffer_sp->GetByteSize());
+    if (xzerr != LZMA_OK)
+    {
+        error.SetErrorStringWithFormat ("lzma_stream_buffer_decode(): %s", ConvertLZMAErrorToString (xzerr));
+        return DataBufferSP();
+    }
+    return buffer_sp;
+}
+
+#else // #if defined( LIBLZMA_DEFINED )
+
+bool
+lzma::IsAvailable ()
+{
+    return false;
+}
+
+Error
+lzma::GetUncompressedSize (const uint8_t *data,
+                           size_t data_size,
+                           uint64_t &uncompressed_size)
+{
+    Error error;
+    error.SetErrorString ("LLDB was built without LZMA support");
+    return error;
+}
+
+DataBufferSP
+lzma::Uncompress (const uint8_t *data,
+                  size_t data_size,
+                  Error &error)
+{
+    error.SetErrorString ("LLDB was built without LZMA support");
+    return DataBufferSP();
+}
+
+#endif // #if defined( LIBLZMA_DEFINED )
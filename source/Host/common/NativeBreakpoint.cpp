@@ -18,7 +18,9 @@ using namespace lldb_private;
 NativeBreakpoint::NativeBreakpoint (lldb::addr_t addr) :
     m_addr (addr),
     m_ref_count (1),
-    m_enabled (true)
+    m_enabled (true),
+    m_conditions (),
+    m_tracepoint_items ()
 {
     assert (addr != LLDB_INVALID_ADDRESS && "breakpoint set for invalid address");
 }
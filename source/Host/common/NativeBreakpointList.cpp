@@ -129,6 +129,31 @@ NativeBreakpointList::DecRef (lldb::addr_t addr)
     return error;
 }
 
+Error
+NativeBreakpointList::DecRefWithoutDisabling (lldb::addr_t addr, NativeBreakpointSP &breakpoint_sp)
+{
+    breakpoint_sp.reset ();
+    {
+        Mutex::Locker locker (m_mutex);
+
+        auto iter = m_breakpoints.find (addr);
+        if (iter != m_breakpoints.end () && iter->second->m_ref_count == 1 &&
+            iter->second->IsEnabled () && iter->second->IsSoftwareBreakpoint ())
+        {
+            Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+            if (log)
+                log->Printf ("NativeBreakpointList::%s addr = 0x%" PRIx64 " -- removed from breakpoint map, left enabled", __FUNCTION__, addr);
+
+            iter->second->DecRef ();
+            breakpoint_sp = iter->second;
+            m_breakpoints.erase (iter);
+            return Error ();
+        }
+    }
+
+    return DecRef (addr);
+}
+
 Error
 NativeBreakpointList::EnableBreakpoint (lldb::addr_t addr)
 {
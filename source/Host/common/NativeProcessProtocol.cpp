@@ -11,6 +11,7 @@
 
 #include "lldb/lldb-enumerations.h"
 #include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/State.h"
 #include "lldb/Host/Host.h"
@@ -19,6 +20,8 @@
 #include "lldb/Host/common/NativeThreadProtocol.h"
 #include "lldb/Host/common/SoftwareBreakpoint.h"
 
+#include <set>
+
 using namespace lldb;
 using namespace lldb_private;
 
@@ -39,12 +42,29 @@ NativeProcessProtocol::NativeProcessProtocol (lldb::pid_t pid) :
     m_delegates_mutex (Mutex::eMutexTypeRecursive),
     m_delegates (),
     m_breakpoint_list (),
+    m_tracepoint_buffer (),
     m_watchpoint_list (),
+    m_software_watchpoint_list (),
     m_terminal_fd (-1),
-    m_stop_id (0)
+    m_stop_id (0),
+    m_non_stop_mode (false)
 {
 }
 
+lldb_private::Error
+NativeProcessProtocol::SetNonStopMode (bool enable)
+{
+    if (!enable)
+        return Error ();
+    return Error ("non-stop mode is not supported by this process plug-in");
+}
+
+lldb_private::Error
+NativeProcessProtocol::StopThread (lldb::tid_t tid)
+{
+    return Error ("non-stop mode is not supported by this process plug-in");
+}
+
 lldb_private::Error
 NativeProcessProtocol::Interrupt ()
 {
@@ -64,6 +84,53 @@ NativeProcessProtocol::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegion
     return Error ("not implemented");
 }
 
+Error
+NativeProcessProtocol::GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation)
+{
+    // Default: not implemented.
+    return Error ("not implemented");
+}
+
+Error
+NativeProcessProtocol::ReadMemoryRanges (MemoryReadRanges &ranges)
+{
+    for (MemoryReadRange &range : ranges)
+    {
+        DataBufferHeap *heap = new DataBufferHeap (range.size, 0);
+        range.data_sp.reset (heap);
+        size_t bytes_read = 0;
+        if (range.size > 0)
+            range.error = ReadMemory (range.addr, heap->GetBytes (), range.size, bytes_read);
+        heap->SetByteSize (bytes_read);
+    }
+    return Error ();
+}
+
+Error
+NativeProcessProtocol::WriteMemoryBlock (lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
+{
+    return WriteMemory (addr, buf, size, bytes_written);
+}
+
+Error
+NativeProcessProtocol::ReadMemoryRangesWithoutTrap (MemoryReadRanges &ranges)
+{
+    Error error = ReadMemoryRanges (ranges);
+    if (error.Fail ())
+        return error;
+
+    for (MemoryReadRange &range : ranges)
+    {
+        const size_t bytes_read = range.GetBytesRead ();
+        if (bytes_read == 0)
+            continue;
+        Error trap_error = m_breakpoint_list.RemoveTrapsFromBuffer (range.addr, range.data_sp->GetBytes (), bytes_read);
+        if (trap_error.Fail ())
+            range.error = trap_error;
+    }
+    return error;
+}
+
 bool
 NativeProcessProtocol::GetExitStatus (ExitType *exit_type, int *status, std::string &exit_description)
 {
@@ -209,18 +276,25 @@ NativeProcessProtocol::SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t w
     // Update the thread list
     UpdateThreads ();
 
+    // A watchpoint that is set again may not need to be a software one
+    // any more.
+    if (m_software_watchpoint_list.FindWatchpoint (addr))
+    {
+        Error error = RemoveSoftwareWatchpoint (addr);
+        if (error.Fail ())
+            return error;
+    }
+
     // Keep track of the threads we successfully set the watchpoint
     // for.  If one of the thread watchpoint setting operations fails,
     // back off and remove the watchpoint for all the threads that
     // were successfully set so we get back to a consistent state.
     std::vector<NativeThreadProtocolSP> watchpoint_established_threads;
 
-    // Tell each thread to set a watchpoint.  In the event that
-    // hardware watchpoints are requested but the SetWatchpoint fails,
-    // try to set a software watchpoint as a fallback.  It's
-    // conceivable that if there are more threads than hardware
-    // watchpoints available, some of the threads will fail to set
-    // hardware watchpoints while software ones may be available.
+    // Tell each thread to set a watchpoint.  If one of them can't, because
+    // it has run out of debug registers or they can't cover the size, the
+    // watchpoint is watched in software for the whole process instead.
+    Error thread_error;
     Mutex::Locker locker (m_threads_mutex);
     for (auto thread_sp : m_threads)
     {
@@ -228,19 +302,7 @@ NativeProcessProtocol::SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t w
         if (!thread_sp)
             continue;
 
-        Error thread_error = thread_sp->SetWatchpoint (addr, size, watch_flags, hardware);
-        if (thread_error.Fail () && hardware)
-        {
-            // Try software watchpoints since we failed on hardware watchpoint setting
-            // and we may have just run out of hardware watchpoints.
-            thread_error = thread_sp->SetWatchpoint (addr, size, watch_flags, false);
-            if (thread_error.Success ())
-            {
-                if (log)
-                    log->Warning ("hardware watchpoint requested but software watchpoint set"); 
-            }
-        }
-
+        thread_error = thread_sp->SetWatchpoint (addr, size, watch_flags, hardware);
         if (thread_error.Success ())
         {
             // Remember that we set this watchpoint successfully in
@@ -261,16 +323,36 @@ NativeProcessProtocol::SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t w
                             __FUNCTION__, GetID (), unwatch_thread_sp->GetID (), remove_error.AsCString ());
                 }
             }
-
-            return thread_error;
+            break;
         }
     }
-    return m_watchpoint_list.Add (addr, size, watch_flags, hardware);
+    if (thread_error.Success ())
+        return m_watchpoint_list.Add (addr, size, watch_flags, hardware);
+
+    const Error software_error = SetSoftwareWatchpoint (addr, size, watch_flags);
+    if (software_error.Fail ())
+    {
+        if (log)
+            log->Printf ("NativeProcessProtocol::%s (): software watchpoint at 0x%" PRIx64 " failed: %s",
+                         __FUNCTION__, addr, software_error.AsCString ());
+        return thread_error;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s (): hardware watchpoint at 0x%" PRIx64 " failed (%s), watching it in software",
+                     __FUNCTION__, addr, thread_error.AsCString ());
+
+    // New threads get the watchpoints in m_watchpoint_list in their debug
+    // registers, a software watchpoint already covers them.
+    return m_watchpoint_list.Remove (addr);
 }
 
 Error
 NativeProcessProtocol::RemoveWatchpoint (lldb::addr_t addr)
 {
+    if (m_software_watchpoint_list.FindWatchpoint (addr))
+        return RemoveSoftwareWatchpoint (addr);
+
     // Update the thread list
     UpdateThreads ();
 
@@ -297,6 +379,18 @@ NativeProcessProtocol::RemoveWatchpoint (lldb::addr_t addr)
     return overall_error.Fail() ? overall_error : error;
 }
 
+Error
+NativeProcessProtocol::SetSoftwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags)
+{
+    return Error ("software watchpoints are not supported");
+}
+
+Error
+NativeProcessProtocol::RemoveSoftwareWatchpoint (lldb::addr_t addr)
+{
+    return Error ("software watchpoints are not supported");
+}
+
 bool
 NativeProcessProtocol::RegisterNativeDelegate (NativeDelegate &native_delegate)
 {
@@ -360,6 +454,18 @@ NativeProcessProtocol::NotifyDidExec ()
     }
 }
 
+void
+NativeProcessProtocol::NotifyThreadStopped (lldb::tid_t tid)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s - tid %" PRIu64 " stopped", __FUNCTION__, tid);
+
+    Mutex::Locker locker (m_delegates_mutex);
+    for (auto native_delegate: m_delegates)
+        native_delegate->ThreadStopped (this, tid);
+}
+
 
 Error
 NativeProcessProtocol::SetSoftwareBreakpoint (lldb::addr_t addr, uint32_t size_hint)
@@ -379,6 +485,106 @@ NativeProcessProtocol::RemoveBreakpoint (lldb::addr_t addr)
     return m_breakpoint_list.DecRef (addr);
 }
 
+void
+NativeProcessProtocol::UpdateSoftwareBreakpoints (std::vector<SoftwareBreakpointUpdate> &updates)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeProcessProtocol::%s %" PRIu64 " updates", __FUNCTION__, (uint64_t)updates.size ());
+
+    // Drop the references first, and take the traps of the breakpoints
+    // that have none left out together.
+    std::vector<NativeBreakpointSP> removed_breakpoints;
+    std::vector<size_t> removed_indexes;
+    for (size_t i = 0; i < updates.size (); ++i)
+    {
+        SoftwareBreakpointUpdate &update = updates[i];
+        if (update.insert)
+            continue;
+        NativeBreakpointSP breakpoint_sp;
+        update.error = m_breakpoint_list.DecRefWithoutDisabling (update.addr, breakpoint_sp);
+        if (breakpoint_sp)
+        {
+            removed_breakpoints.push_back (breakpoint_sp);
+            removed_indexes.push_back (i);
+        }
+    }
+    if (!removed_breakpoints.empty ())
+    {
+        std::vector<Error> errors;
+        SoftwareBreakpoint::RemoveSoftwareBreakpoints (*this, removed_breakpoints, errors);
+        for (size_t j = 0; j < removed_indexes.size (); ++j)
+            updates[removed_indexes[j]].error = errors[j];
+    }
+
+    // Breakpoints that are already set only get another reference, the
+    // traps of the new ones go in together. An address that is inserted
+    // more than once is referenced again after its breakpoint exists.
+    std::vector<lldb::addr_t> new_addrs;
+    std::vector<size_t> new_size_hints;
+    std::vector<size_t> new_indexes;
+    std::vector<size_t> repeated_indexes;
+    std::set<lldb::addr_t> new_addr_set;
+    for (size_t i = 0; i < updates.size (); ++i)
+    {
+        SoftwareBreakpointUpdate &update = updates[i];
+        if (!update.insert)
+            continue;
+        NativeBreakpointSP breakpoint_sp;
+        if (m_breakpoint_list.GetBreakpoint (update.addr, breakpoint_sp).Success ())
+            update.error = SetSoftwareBreakpoint (update.addr, update.size_hint);
+        else if (!new_addr_set.insert (update.addr).second)
+            repeated_indexes.push_back (i);
+        else
+        {
+            new_addrs.push_back (update.addr);
+            new_size_hints.push_back (update.size_hint);
+            new_indexes.push_back (i);
+        }
+    }
+    if (!new_addrs.empty ())
+    {
+        std::vector<NativeBreakpointSP> breakpoints;
+        std::vector<Error> errors;
+        SoftwareBreakpoint::CreateSoftwareBreakpoints (*this, new_addrs, new_size_hints, breakpoints, errors);
+        for (size_t j = 0; j < new_indexes.size (); ++j)
+        {
+            SoftwareBreakpointUpdate &update = updates[new_indexes[j]];
+            if (errors[j].Fail ())
+            {
+                update.error = errors[j];
+                continue;
+            }
+            const NativeBreakpointSP &new_breakpoint_sp = breakpoints[j];
+            update.error = m_breakpoint_list.AddRef (update.addr, update.size_hint, false,
+                    [&new_breakpoint_sp] (lldb::addr_t addr, size_t size_hint, bool /* hardware */, NativeBreakpointSP &breakpoint_sp)->Error
+                    { breakpoint_sp = new_breakpoint_sp; return Error (); });
+        }
+    }
+    for (size_t i : repeated_indexes)
+        updates[i].error = SetSoftwareBreakpoint (updates[i].addr, updates[i].size_hint);
+}
+
+Error
+NativeProcessProtocol::SetBreakpointConditions (lldb::addr_t addr, std::vector<std::vector<uint8_t>> &&conditions)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Success ())
+        breakpoint_sp->SetConditions (std::move (conditions));
+    return error;
+}
+
+Error
+NativeProcessProtocol::SetTracepoint (lldb::addr_t addr, std::vector<NativeTracepointItem> &&items)
+{
+    NativeBreakpointSP breakpoint_sp;
+    Error error = m_breakpoint_list.GetBreakpoint (addr, breakpoint_sp);
+    if (error.Success ())
+        breakpoint_sp->SetTracepointItems (std::move (items));
+    return error;
+}
+
 Error
 NativeProcessProtocol::EnableBreakpoint (lldb::addr_t addr)
 {
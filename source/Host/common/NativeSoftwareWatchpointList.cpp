@@ -0,0 +1,268 @@
+//===-- NativeSoftwareWatchpointList.cpp ------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/common/NativeSoftwareWatchpointList.h"
+
+#include "lldb/lldb-enumerations.h"
+
+#include <algorithm>
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    const uint32_t k_watch_write = 0x1;
+    const uint32_t k_watch_read = 0x2;
+}
+
+NativeSoftwareWatchpointList::NativeSoftwareWatchpointList (size_t page_size) :
+    m_page_size (page_size),
+    m_watchpoints (),
+    m_pages ()
+{
+}
+
+uint32_t
+NativeSoftwareWatchpointList::GetWatchedPermissions (uint32_t permissions, uint32_t watch_flags)
+{
+    // Nothing can be taken away to see reads but all access.
+    if (watch_flags & k_watch_read)
+        return 0;
+    if (watch_flags & k_watch_write)
+        return permissions & ~ePermissionsWritable;
+    return permissions;
+}
+
+uint32_t
+NativeSoftwareWatchpointList::GetCurrentPermissions (const Page &page) const
+{
+    if (page.num_accesses > 0)
+        return page.permissions;
+    return GetWatchedPermissions (page.permissions, page.watch_flags);
+}
+
+void
+NativeSoftwareWatchpointList::AppendChange (ProtectionChanges &changes, addr_t addr, size_t size, uint32_t permissions)
+{
+    if (!changes.empty ())
+    {
+        ProtectionChange &last = changes.back ();
+        if (last.permissions == permissions && last.addr + last.size == addr)
+        {
+            last.size += size;
+            return;
+        }
+    }
+    changes.push_back ({addr, size, permissions});
+}
+
+Error
+NativeSoftwareWatchpointList::Add (addr_t addr, size_t size, uint32_t watch_flags,
+                                   const GetPermissionsCallback &get_permissions, ProtectionChanges &changes)
+{
+    if (size == 0)
+        return Error ("watchpoint size must not be zero");
+    if (addr + size < addr)
+        return Error ("watchpoint at 0x%" PRIx64 " wraps around the address space", addr);
+    if ((watch_flags & (k_watch_write | k_watch_read)) == 0)
+        return Error ("watchpoint at 0x%" PRIx64 " watches neither reads nor writes", addr);
+
+    if (m_watchpoints.count (addr) > 0)
+    {
+        Error error = Remove (addr, changes);
+        if (error.Fail ())
+            return error;
+    }
+
+    const addr_t first_page = GetPageAddress (addr);
+    const addr_t last_page = GetPageAddress (addr + size - 1);
+
+    // Find the permissions of the pages that aren't watched yet before
+    // touching any of them, so that a failure leaves nothing to undo.
+    std::map<addr_t, uint32_t> new_page_permissions;
+    for (addr_t page_addr = first_page; ; page_addr += m_page_size)
+    {
+        if (m_pages.count (page_addr) == 0)
+        {
+            uint32_t permissions = 0;
+            if (!get_permissions (page_addr, permissions))
+                return Error ("failed to get the permissions of the page at 0x%" PRIx64, page_addr);
+            new_page_permissions[page_addr] = permissions;
+        }
+        if (page_addr == last_page)
+            break;
+    }
+
+    for (addr_t page_addr = first_page; ; page_addr += m_page_size)
+    {
+        auto pos = m_pages.find (page_addr);
+        if (pos == m_pages.end ())
+            pos = m_pages.insert (std::make_pair (page_addr, Page {new_page_permissions[page_addr], 0, 0, 0})).first;
+
+        Page &page = pos->second;
+        const uint32_t old_permissions = GetCurrentPermissions (page);
+        page.watch_flags |= watch_flags;
+        ++page.num_watchpoints;
+        const uint32_t new_permissions = GetCurrentPermissions (page);
+        if (new_permissions != old_permissions)
+            AppendChange (changes, page_addr, m_page_size, new_permissions);
+
+        if (page_addr == last_page)
+            break;
+    }
+
+    m_watchpoints[addr] = {addr, size, watch_flags, 0, 0};
+    return Error ();
+}
+
+Error
+NativeSoftwareWatchpointList::Remove (addr_t addr, ProtectionChanges &changes)
+{
+    auto wp_pos = m_watchpoints.find (addr);
+    if (wp_pos == m_watchpoints.end ())
+        return Error ("no software watchpoint at 0x%" PRIx64, addr);
+    const addr_t first_page = GetPageAddress (addr);
+    const addr_t last_page = GetPageAddress (addr + wp_pos->second.size - 1);
+    m_watchpoints.erase (wp_pos);
+
+    for (addr_t page_addr = first_page; ; page_addr += m_page_size)
+    {
+        auto pos = m_pages.find (page_addr);
+        if (pos != m_pages.end ())
+        {
+            Page &page = pos->second;
+            const uint32_t old_permissions = GetCurrentPermissions (page);
+            uint32_t new_permissions = page.permissions;
+            if (--page.num_watchpoints == 0)
+            {
+                // An access in progress finds the page gone and leaves it
+                // as it is.
+                m_pages.erase (pos);
+            }
+            else
+            {
+                std::vector<Watchpoint *> watchpoints;
+                FindWatchpoints (page_addr, m_page_size, watchpoints);
+                page.watch_flags = 0;
+                for (const Watchpoint *watchpoint : watchpoints)
+                    page.watch_flags |= watchpoint->watch_flags;
+                new_permissions = GetCurrentPermissions (page);
+            }
+            if (new_permissions != old_permissions)
+                AppendChange (changes, page_addr, m_page_size, new_permissions);
+        }
+
+        if (page_addr == last_page)
+            break;
+    }
+    return Error ();
+}
+
+void
+NativeSoftwareWatchpointList::Clear (ProtectionChanges &changes)
+{
+    for (const auto &pair : m_pages)
+    {
+        const Page &page = pair.second;
+        if (GetCurrentPermissions (page) != page.permissions)
+            AppendChange (changes, pair.first, m_page_size, page.permissions);
+    }
+    m_pages.clear ();
+    m_watchpoints.clear ();
+}
+
+uint32_t
+NativeSoftwareWatchpointList::GetPageWatchFlags (addr_t page_addr) const
+{
+    auto pos = m_pages.find (page_addr);
+    return pos == m_pages.end () ? 0 : pos->second.watch_flags;
+}
+
+size_t
+NativeSoftwareWatchpointList::GetNumPages (const Watchpoint &watchpoint) const
+{
+    return (GetPageAddress (watchpoint.addr + watchpoint.size - 1) - GetPageAddress (watchpoint.addr)) / m_page_size + 1;
+}
+
+const NativeSoftwareWatchpointList::Watchpoint *
+NativeSoftwareWatchpointList::FindWatchpoint (addr_t addr) const
+{
+    auto pos = m_watchpoints.find (addr);
+    return pos == m_watchpoints.end () ? nullptr : &pos->second;
+}
+
+void
+NativeSoftwareWatchpointList::FindWatchpoints (addr_t addr, size_t size, std::vector<Watchpoint *> &watchpoints)
+{
+    // Watchpoints may overlap, so any one that starts below the range may
+    // reach into it.
+    const addr_t end_addr = addr + size;
+    for (auto &pair : m_watchpoints)
+    {
+        Watchpoint &watchpoint = pair.second;
+        if (watchpoint.addr >= end_addr)
+            break;
+        if (watchpoint.addr + watchpoint.size > addr)
+            watchpoints.push_back (&watchpoint);
+    }
+}
+
+void
+NativeSoftwareWatchpointList::RecordFault (addr_t page_addr)
+{
+    std::vector<Watchpoint *> watchpoints;
+    FindWatchpoints (page_addr, m_page_size, watchpoints);
+    for (Watchpoint *watchpoint : watchpoints)
+        ++watchpoint->num_faults;
+}
+
+void
+NativeSoftwareWatchpointList::GetUnwatchedRanges (addr_t addr, size_t size, uint32_t permissions, ProtectionChanges &ranges) const
+{
+    const addr_t end_addr = addr + size;
+    addr_t range_addr = addr;
+    for (auto pos = m_pages.lower_bound (GetPageAddress (addr)); pos != m_pages.end () && pos->first < end_addr; ++pos)
+    {
+        if (pos->first > range_addr)
+            AppendChange (ranges, range_addr, pos->first - range_addr, permissions);
+        const addr_t page_addr = std::max (pos->first, range_addr);
+        const addr_t page_end = std::min (pos->first + m_page_size, end_addr);
+        AppendChange (ranges, page_addr, page_end - page_addr, pos->second.permissions);
+        range_addr = page_end;
+    }
+    if (range_addr < end_addr)
+        AppendChange (ranges, range_addr, end_addr - range_addr, permissions);
+}
+
+bool
+NativeSoftwareWatchpointList::BeginAccess (addr_t page_addr, ProtectionChange &change)
+{
+    auto pos = m_pages.find (page_addr);
+    if (pos == m_pages.end ())
+        return false;
+    Page &page = pos->second;
+    const uint32_t old_permissions = GetCurrentPermissions (page);
+    ++page.num_accesses;
+    change = {page_addr, m_page_size, page.permissions};
+    return page.permissions != old_permissions;
+}
+
+bool
+NativeSoftwareWatchpointList::EndAccess (addr_t page_addr, ProtectionChange &change)
+{
+    auto pos = m_pages.find (page_addr);
+    if (pos == m_pages.end () || pos->second.num_accesses == 0)
+        return false;
+    Page &page = pos->second;
+    --page.num_accesses;
+    const uint32_t new_permissions = GetCurrentPermissions (page);
+    change = {page_addr, m_page_size, new_permissions};
+    return new_permissions != page.permissions;
+}
@@ -0,0 +1,61 @@
+//===-- NativeTracepointBuffer.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/common/NativeTracepointBuffer.h"
+
+using namespace lldb_private;
+
+size_t
+NativeTracepointBuffer::Record::GetByteSize () const
+{
+    size_t byte_size = sizeof (Record);
+    for (const std::vector<uint8_t> &value : values)
+        byte_size += sizeof (value) + value.size ();
+    return byte_size;
+}
+
+NativeTracepointBuffer::NativeTracepointBuffer (size_t capacity) :
+    m_capacity (capacity),
+    m_records (),
+    m_byte_size (0),
+    m_num_dropped (0)
+{
+}
+
+void
+NativeTracepointBuffer::Add (Record &&record)
+{
+    const size_t record_size = record.GetByteSize ();
+    if (record_size > m_capacity)
+    {
+        ++m_num_dropped;
+        return;
+    }
+    while (m_byte_size + record_size > m_capacity)
+    {
+        RemoveOldest ();
+        ++m_num_dropped;
+    }
+    m_byte_size += record_size;
+    m_records.push_back (std::move (record));
+}
+
+void
+NativeTracepointBuffer::RemoveOldest ()
+{
+    m_byte_size -= m_records.front ().GetByteSize ();
+    m_records.pop_front ();
+}
+
+void
+NativeTracepointBuffer::Clear ()
+{
+    m_records.clear ();
+    m_byte_size = 0;
+}
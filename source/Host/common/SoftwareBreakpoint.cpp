@@ -12,12 +12,71 @@
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Host/Debug.h"
+#include "lldb/Host/HostInfo.h"
 #include "lldb/Host/Mutex.h"
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 
+#include <algorithm>
+
 using namespace lldb_private;
 
+namespace
+{
+    // Traps on the same page, which are read and written together as the
+    // range from the start of the first one to the end of the last one.
+    struct TrapBlock
+    {
+        lldb::addr_t addr;
+        size_t size;
+        std::vector<size_t> indexes;
+    };
+
+    // Group the traps with "indexes", at "addrs" and "sizes" bytes long,
+    // into blocks by the page they start on.
+    void
+    GetTrapBlocks (const std::vector<lldb::addr_t> &addrs,
+                   const std::vector<size_t> &sizes,
+                   std::vector<size_t> indexes,
+                   std::vector<TrapBlock> &blocks)
+    {
+        const lldb::addr_t page_mask = ~static_cast<lldb::addr_t> (HostInfo::GetPageSize () - 1);
+        std::sort (indexes.begin (), indexes.end (),
+                   [&addrs] (size_t lhs, size_t rhs) { return addrs[lhs] < addrs[rhs]; });
+
+        blocks.clear ();
+        for (size_t index : indexes)
+        {
+            const lldb::addr_t addr = addrs[index];
+            if (blocks.empty () || (blocks.back ().addr & page_mask) != (addr & page_mask))
+                blocks.push_back (TrapBlock {addr, 0, std::vector<size_t> ()});
+            TrapBlock &block = blocks.back ();
+            block.size = std::max<size_t> (block.size, addr + sizes[index] - block.addr);
+            block.indexes.push_back (index);
+        }
+    }
+
+    Error
+    ReadTrapBlocks (NativeProcessProtocol &process, const std::vector<TrapBlock> &blocks, MemoryReadRanges &ranges)
+    {
+        ranges.clear ();
+        for (const TrapBlock &block : blocks)
+            ranges.push_back (MemoryReadRange (block.addr, block.size));
+        return process.ReadMemoryRanges (ranges);
+    }
+
+    Error
+    WriteTrapBlock (NativeProcessProtocol &process, const TrapBlock &block, const uint8_t *bytes)
+    {
+        size_t bytes_written = 0;
+        Error error = process.WriteMemoryBlock (block.addr, bytes, block.size, bytes_written);
+        if (error.Success () && bytes_written != block.size)
+            error.SetErrorStringWithFormat ("tried to write %" PRIu64 " bytes at 0x%" PRIx64 " but only wrote %" PRIu64,
+                                            (uint64_t)block.size, block.addr, (uint64_t)bytes_written);
+        return error;
+    }
+}
+
 // -------------------------------------------------------------------
 // static members
 // -------------------------------------------------------------------
@@ -29,14 +88,45 @@ SoftwareBreakpoint::CreateSoftwareBreakpoint (NativeProcessProtocol &process, ll
     if (log)
         log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64, __FUNCTION__, addr);
 
+    size_t bp_opcode_size = 0;
+    const uint8_t *bp_opcode_bytes = NULL;
+    Error error = GetTrapOpcode (process, addr, size_hint, bp_opcode_size, bp_opcode_bytes);
+    if (error.Fail ())
+        return error;
+
+    // Enable the breakpoint.
+    uint8_t saved_opcode_bytes [MAX_TRAP_OPCODE_SIZE];
+    error = EnableSoftwareBreakpoint (process, addr, bp_opcode_size, bp_opcode_bytes, saved_opcode_bytes);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("SoftwareBreakpoint::%s: failed to enable new breakpoint at 0x%" PRIx64 ": %s", __FUNCTION__, addr, error.AsCString ());
+        return error;
+    }
+
+    if (log)
+        log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- SUCCESS", __FUNCTION__, addr);
+
+    // Set the breakpoint and verified it was written properly.  Now
+    // create a breakpoint remover that understands how to undo this
+    // breakpoint.
+    breakpoint_sp.reset (new SoftwareBreakpoint (process, addr, saved_opcode_bytes, bp_opcode_bytes, bp_opcode_size));
+    return Error ();
+}
+
+Error
+SoftwareBreakpoint::GetTrapOpcode (NativeProcessProtocol &process, lldb::addr_t addr, size_t size_hint, size_t &bp_opcode_size, const uint8_t *&bp_opcode_bytes)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+
     // Validate the address.
     if (addr == LLDB_INVALID_ADDRESS)
         return Error ("SoftwareBreakpoint::%s invalid load address specified.", __FUNCTION__);
 
     // Ask the NativeProcessProtocol subclass to fill in the correct software breakpoint
     // trap for the breakpoint site.
-    size_t bp_opcode_size = 0;
-    const uint8_t *bp_opcode_bytes = NULL;
+    bp_opcode_size = 0;
+    bp_opcode_bytes = NULL;
     Error error = process.GetSoftwareBreakpointTrapOpcode (size_hint, bp_opcode_size, bp_opcode_bytes);
 
     if (error.Fail ())
@@ -69,23 +159,6 @@ SoftwareBreakpoint::CreateSoftwareBreakpoint (NativeProcessProtocol &process, ll
         return Error ("SoftwareBreakpoint::GetSoftwareBreakpointTrapOpcode() returned NULL trap opcode bytes, unable to get breakpoint trap for address 0x%" PRIx64, addr);
     }
 
-    // Enable the breakpoint.
-    uint8_t saved_opcode_bytes [MAX_TRAP_OPCODE_SIZE];
-    error = EnableSoftwareBreakpoint (process, addr, bp_opcode_size, bp_opcode_bytes, saved_opcode_bytes);
-    if (error.Fail ())
-    {
-        if (log)
-            log->Printf ("SoftwareBreakpoint::%s: failed to enable new breakpoint at 0x%" PRIx64 ": %s", __FUNCTION__, addr, error.AsCString ());
-        return error;
-    }
-
-    if (log)
-        log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- SUCCESS", __FUNCTION__, addr);
-
-    // Set the breakpoint and verified it was written properly.  Now
-    // create a breakpoint remover that understands how to undo this
-    // breakpoint.
-    breakpoint_sp.reset (new SoftwareBreakpoint (process, addr, saved_opcode_bytes, bp_opcode_bytes, bp_opcode_size));
     return Error ();
 }
 
@@ -181,6 +254,208 @@ SoftwareBreakpoint::EnableSoftwareBreakpoint (NativeProcessProtocol &process, ll
     return Error ();
 }
 
+void
+SoftwareBreakpoint::CreateSoftwareBreakpoints (NativeProcessProtocol &process,
+                                               const std::vector<lldb::addr_t> &addrs,
+                                               const std::vector<size_t> &size_hints,
+                                               std::vector<NativeBreakpointSP> &breakpoints,
+                                               std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    const size_t num_breakpoints = addrs.size ();
+    if (log)
+        log->Printf ("SoftwareBreakpoint::%s %" PRIu64 " breakpoints", __FUNCTION__, (uint64_t)num_breakpoints);
+
+    breakpoints.assign (num_breakpoints, NativeBreakpointSP ());
+    errors.assign (num_breakpoints, Error ());
+
+    std::vector<size_t> opcode_sizes (num_breakpoints, 0);
+    std::vector<const uint8_t *> trap_opcodes (num_breakpoints, NULL);
+    std::vector<size_t> indexes;
+    for (size_t i = 0; i < num_breakpoints; ++i)
+    {
+        errors[i] = GetTrapOpcode (process, addrs[i], size_hints[i], opcode_sizes[i], trap_opcodes[i]);
+        if (errors[i].Success ())
+            indexes.push_back (i);
+    }
+
+    std::vector<TrapBlock> blocks;
+    GetTrapBlocks (addrs, opcode_sizes, indexes, blocks);
+
+    MemoryReadRanges ranges;
+    Error error = ReadTrapBlocks (process, blocks, ranges);
+    if (error.Fail ())
+    {
+        for (size_t i : indexes)
+            errors[i] = error;
+        return;
+    }
+
+    // Save the original opcodes and put the traps in their place, then
+    // write each block back with a single write.
+    std::vector<uint8_t> saved_opcodes (num_breakpoints * MAX_TRAP_OPCODE_SIZE);
+    std::vector<TrapBlock> written_blocks;
+    std::vector<Error> write_errors;
+    for (size_t b = 0; b < blocks.size (); ++b)
+    {
+        const TrapBlock &block = blocks[b];
+        const MemoryReadRange &range = ranges[b];
+        if (!range.Succeeded ())
+        {
+            for (size_t i : block.indexes)
+                errors[i].SetErrorStringWithFormat ("SoftwareBreakpoint::%s failed to read memory while attempting to set breakpoint at 0x%" PRIx64,
+                                                    __FUNCTION__, addrs[i]);
+            continue;
+        }
+
+        uint8_t *bytes = range.data_sp->GetBytes ();
+        for (size_t i : block.indexes)
+        {
+            uint8_t *opcodes = bytes + (addrs[i] - block.addr);
+            ::memcpy (&saved_opcodes[i * MAX_TRAP_OPCODE_SIZE], opcodes, opcode_sizes[i]);
+            ::memcpy (opcodes, trap_opcodes[i], opcode_sizes[i]);
+        }
+        written_blocks.push_back (block);
+        write_errors.push_back (WriteTrapBlock (process, block, bytes));
+    }
+
+    // Check which traps made it into memory. One that did is a breakpoint
+    // even if the write reported an error, so that it gets taken out again.
+    error = ReadTrapBlocks (process, written_blocks, ranges);
+    for (size_t b = 0; b < written_blocks.size (); ++b)
+    {
+        const TrapBlock &block = written_blocks[b];
+        for (size_t i : block.indexes)
+        {
+            const size_t offset = addrs[i] - block.addr;
+            if (error.Success () && ranges[b].GetBytesRead () >= offset + opcode_sizes[i] &&
+                ::memcmp (ranges[b].data_sp->GetBytes () + offset, trap_opcodes[i], opcode_sizes[i]) == 0)
+            {
+                breakpoints[i].reset (new SoftwareBreakpoint (process, addrs[i], &saved_opcodes[i * MAX_TRAP_OPCODE_SIZE],
+                                                              trap_opcodes[i], opcode_sizes[i]));
+            }
+            else if (write_errors[b].Fail ())
+                errors[i] = write_errors[b];
+            else
+                errors[i].SetErrorStringWithFormat ("SoftwareBreakpoint::%s: verification of software breakpoint writing failed - trap opcodes not successfully read back after writing when setting breakpoint at 0x%" PRIx64,
+                                                    __FUNCTION__, addrs[i]);
+        }
+    }
+
+    if (log)
+    {
+        for (size_t i = 0; i < num_breakpoints; ++i)
+        {
+            if (errors[i].Fail ())
+                log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- FAILED: %s", __FUNCTION__, addrs[i], errors[i].AsCString ());
+        }
+    }
+}
+
+void
+SoftwareBreakpoint::RemoveSoftwareBreakpoints (NativeProcessProtocol &process,
+                                               const std::vector<NativeBreakpointSP> &breakpoints,
+                                               std::vector<Error> &errors)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    const size_t num_breakpoints = breakpoints.size ();
+    if (log)
+        log->Printf ("SoftwareBreakpoint::%s %" PRIu64 " breakpoints", __FUNCTION__, (uint64_t)num_breakpoints);
+
+    errors.assign (num_breakpoints, Error ());
+
+    std::vector<const SoftwareBreakpoint *> software_breakpoints;
+    std::vector<lldb::addr_t> addrs;
+    std::vector<size_t> opcode_sizes;
+    std::vector<size_t> indexes;
+    for (size_t i = 0; i < num_breakpoints; ++i)
+    {
+        assert (breakpoints[i]->IsSoftwareBreakpoint () && "removing the trap of a breakpoint that doesn't have one");
+        const SoftwareBreakpoint *breakpoint = static_cast<const SoftwareBreakpoint *> (breakpoints[i].get ());
+        software_breakpoints.push_back (breakpoint);
+        addrs.push_back (breakpoint->m_addr);
+        opcode_sizes.push_back (breakpoint->m_opcode_size);
+        indexes.push_back (i);
+    }
+
+    std::vector<TrapBlock> blocks;
+    GetTrapBlocks (addrs, opcode_sizes, indexes, blocks);
+
+    MemoryReadRanges ranges;
+    Error error = ReadTrapBlocks (process, blocks, ranges);
+    if (error.Fail ())
+    {
+        errors.assign (num_breakpoints, error);
+        return;
+    }
+
+    // Put the original opcodes back in place of the traps, leaving alone
+    // the ones that have been restored already, and write each block that
+    // changed back with a single write.
+    std::vector<TrapBlock> written_blocks;
+    std::vector<Error> write_errors;
+    for (size_t b = 0; b < blocks.size (); ++b)
+    {
+        const TrapBlock &block = blocks[b];
+        const MemoryReadRange &range = ranges[b];
+        if (!range.Succeeded ())
+        {
+            for (size_t i : block.indexes)
+                errors[i].SetErrorStringWithFormat ("SoftwareBreakpoint::%s failed to read memory while attempting to remove breakpoint at 0x%" PRIx64,
+                                                    __FUNCTION__, addrs[i]);
+            continue;
+        }
+
+        uint8_t *bytes = range.data_sp->GetBytes ();
+        bool changed = false;
+        for (size_t i : block.indexes)
+        {
+            const SoftwareBreakpoint *breakpoint = software_breakpoints[i];
+            uint8_t *opcodes = bytes + (addrs[i] - block.addr);
+            if (::memcmp (opcodes, breakpoint->m_trap_opcodes, opcode_sizes[i]) == 0)
+            {
+                ::memcpy (opcodes, breakpoint->m_saved_opcodes, opcode_sizes[i]);
+                changed = true;
+            }
+            else if (::memcmp (opcodes, breakpoint->m_saved_opcodes, opcode_sizes[i]) != 0)
+                errors[i].SetErrorString ("Original breakpoint trap is no longer in memory.");
+        }
+        if (changed)
+        {
+            written_blocks.push_back (block);
+            write_errors.push_back (WriteTrapBlock (process, block, bytes));
+        }
+    }
+
+    error = ReadTrapBlocks (process, written_blocks, ranges);
+    for (size_t b = 0; b < written_blocks.size (); ++b)
+    {
+        const TrapBlock &block = written_blocks[b];
+        for (size_t i : block.indexes)
+        {
+            if (errors[i].Fail ())
+                continue;
+            const size_t offset = addrs[i] - block.addr;
+            if (error.Success () && ranges[b].GetBytesRead () >= offset + opcode_sizes[i] &&
+                ::memcmp (ranges[b].data_sp->GetBytes () + offset, software_breakpoints[i]->m_saved_opcodes, opcode_sizes[i]) == 0)
+                continue;
+            if (write_errors[b].Fail ())
+                errors[i] = write_errors[b];
+            else
+                errors[i].SetErrorString ("Failed to restore original opcode.");
+        }
+    }
+
+    if (log)
+    {
+        for (size_t i = 0; i < num_breakpoints; ++i)
+        {
+            if (errors[i].Fail ())
+                log->Printf ("SoftwareBreakpoint::%s addr = 0x%" PRIx64 " -- FAILED: %s", __FUNCTION__, addrs[i], errors[i].AsCString ());
+        }
+    }
+}
+
 // -------------------------------------------------------------------
 // instance-level members
 // -------------------------------------------------------------------
@@ -31,6 +31,9 @@
 #ifndef LLDB_DISABLE_POSIX
 #include <termios.h>
 #endif
+#if !defined(__APPLE__) && !defined(_WIN32)
+#include <poll.h>
+#endif
 
 // C++ Includes
 // Other libraries and framework includes
@@ -545,19 +548,21 @@ ConnectionFileDescriptor::GetURI()
     return m_uri;
 }
 
-// This ConnectionFileDescriptor::BytesAvailable() uses select().
+// ConnectionFileDescriptor::BytesAvailable() waits on the connection and on
+// the command pipe with poll() where we can, and falls back to select()
+// elsewhere.
 //
-// PROS:
-//  - select is consistent across most unix platforms
+// select() only supports file descriptors up to FD_SETSIZE on most hosts,
+// which a server that has many connections open easily runs past, so the
+// select() implementation is only used where poll() isn't an option:
 //  - The Apple specific version allows for unlimited fds in the fd_sets by
 //    setting the _DARWIN_UNLIMITED_SELECT define prior to including the
 //    required header files.
-// CONS:
-//  - on non-Apple platforms, only supports file descriptors up to FD_SETSIZE.
-//     This implementation  will assert if it runs into that hard limit to let
-//     users know that another ConnectionFileDescriptor::BytesAvailable() should
-//     be used or a new version of ConnectionFileDescriptor::BytesAvailable()
-//     should be written for the system that is running into the limitations.
+//  - select() is the only option for sockets on Windows.
+
+#if defined(__APPLE__) || defined(_WIN32)
+#define LLDB_CONNECTION_USE_SELECT 1
+#endif
 
 #if defined(__APPLE__)
 #define FD_SET_DATA(fds) fds.data()
@@ -565,16 +570,18 @@ ConnectionFileDescriptor::GetURI()
 #define FD_SET_DATA(fds) &fds
 #endif
 
-ConnectionStatus
-ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr)
+//----------------------------------------------------------------------
+// Wait for up to timeout_usec (UINT32_MAX means forever) for data on
+// handle or pipe_fd, if pipe_fd is valid. Returns the number of ready
+// descriptors like select() and poll() do, or -1 with errno set.
+//----------------------------------------------------------------------
+static int
+WaitForReadableDescriptors (int handle, int pipe_fd, uint32_t timeout_usec, bool &handle_ready, bool &pipe_ready)
 {
-    // Don't need to take the mutex here separately since we are only called from Read.  If we
-    // ever get used more generally we will need to lock here as well.
-
-    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_CONNECTION));
-    if (log)
-        log->Printf("%p ConnectionFileDescriptor::BytesAvailable (timeout_usec = %u)", static_cast<void *>(this), timeout_usec);
+    handle_ready = false;
+    pipe_ready = false;
 
+#if defined(LLDB_CONNECTION_USE_SELECT)
     struct timeval *tv_ptr;
     struct timeval tv;
     if (timeout_usec == UINT32_MAX)
@@ -591,9 +598,79 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
         tv_ptr = &tv;
     }
 
+    const int nfds = std::max<int>(handle, pipe_fd) + 1;
+#if defined(__APPLE__)
+    llvm::SmallVector<fd_set, 1> read_fds;
+    read_fds.resize((nfds / FD_SETSIZE) + 1);
+    for (size_t i = 0; i < read_fds.size(); ++i)
+        FD_ZERO(&read_fds[i]);
+// FD_SET doesn't bounds check, it just happily walks off the end
+// but we have taken care of making the extra storage with our
+// SmallVector of fd_set objects
+#else
+    fd_set read_fds;
+    FD_ZERO(&read_fds);
+#endif
+    FD_SET(handle, FD_SET_DATA(read_fds));
+    if (pipe_fd >= 0)
+        FD_SET(pipe_fd, FD_SET_DATA(read_fds));
+
+    const int num_set_fds = ::select(nfds, FD_SET_DATA(read_fds), NULL, NULL, tv_ptr);
+    if (num_set_fds > 0)
+    {
+        handle_ready = FD_ISSET(handle, FD_SET_DATA(read_fds));
+        pipe_ready = pipe_fd >= 0 && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds));
+    }
+    return num_set_fds;
+#else
+    int timeout_msec = -1;
+    if (timeout_usec != UINT32_MAX)
+        timeout_msec = (timeout_usec + 999) / 1000;
+
+    struct pollfd fds[2];
+    nfds_t nfds = 0;
+    fds[nfds].fd = handle;
+    fds[nfds].events = POLLIN;
+    fds[nfds].revents = 0;
+    ++nfds;
+    if (pipe_fd >= 0)
+    {
+        fds[nfds].fd = pipe_fd;
+        fds[nfds].events = POLLIN;
+        fds[nfds].revents = 0;
+        ++nfds;
+    }
+
+    const int num_set_fds = ::poll(fds, nfds, timeout_msec);
+    if (num_set_fds > 0)
+    {
+        // A closed or reset connection is reported as POLLHUP or POLLERR
+        // rather than POLLIN, but the read will tell us what happened.
+        handle_ready = fds[0].revents != 0;
+        pipe_ready = nfds > 1 && fds[1].revents != 0;
+        if (fds[0].revents & POLLNVAL)
+        {
+            errno = EBADF;
+            return -1;
+        }
+    }
+    return num_set_fds;
+#endif
+}
+
+ConnectionStatus
+ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr)
+{
+    // Don't need to take the mutex here separately since we are only called from Read.  If we
+    // ever get used more generally we will need to lock here as well.
+
+    Log *log(lldb_private::GetLogIfAllCategoriesSet(LIBLLDB_LOG_CONNECTION));
+    if (log)
+        log->Printf("%p ConnectionFileDescriptor::BytesAvailable (timeout_usec = %u)", static_cast<void *>(this), timeout_usec);
+
     // Make a copy of the file descriptors to make sure we don't
     // have another thread change these values out from under us
-    // and cause problems in the loop below where like in FS_SET()
+    // and cause problems in the loop below
     const IOObject::WaitableHandle handle = m_read_sp->GetWaitableHandle();
     const int pipe_fd = m_pipe.GetReadFileDescriptor();
 
@@ -606,7 +683,7 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
         const bool have_pipe_fd = false;
 #else
         const bool have_pipe_fd = pipe_fd >= 0;
-#if !defined(__APPLE__)
+#if defined(LLDB_CONNECTION_USE_SELECT) && !defined(__APPLE__)
         assert(handle < FD_SETSIZE);
         if (have_pipe_fd)
             assert(pipe_fd < FD_SETSIZE);
@@ -614,37 +691,22 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
 #endif
         while (handle == m_read_sp->GetWaitableHandle())
         {
-            const int nfds = std::max<int>(handle, pipe_fd) + 1;
-#if defined(__APPLE__)
-            llvm::SmallVector<fd_set, 1> read_fds;
-            read_fds.resize((nfds / FD_SETSIZE) + 1);
-            for (size_t i = 0; i < read_fds.size(); ++i)
-                FD_ZERO(&read_fds[i]);
-// FD_SET doesn't bounds check, it just happily walks off the end
-// but we have taken care of making the extra storage with our
-// SmallVector of fd_set objects
-#else
-            fd_set read_fds;
-            FD_ZERO(&read_fds);
-#endif
-            FD_SET(handle, FD_SET_DATA(read_fds));
-            if (have_pipe_fd)
-                FD_SET(pipe_fd, FD_SET_DATA(read_fds));
-
             Error error;
 
             if (log)
             {
                 if (have_pipe_fd)
-                    log->Printf(
-                        "%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i, %i}, NULL, NULL, timeout=%p)...",
-                        static_cast<void *>(this), nfds, handle, pipe_fd, static_cast<void *>(tv_ptr));
+                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  waiting (fds={%i, %i}, timeout_usec=%u)...",
+                                static_cast<void *>(this), handle, pipe_fd, timeout_usec);
                 else
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i}, NULL, NULL, timeout=%p)...",
-                                static_cast<void *>(this), nfds, handle, static_cast<void *>(tv_ptr));
+                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  waiting (fds={%i}, timeout_usec=%u)...",
+                                static_cast<void *>(this), handle, timeout_usec);
             }
 
-            const int num_set_fds = ::select(nfds, FD_SET_DATA(read_fds), NULL, NULL, tv_ptr);
+            bool handle_ready = false;
+            bool pipe_ready = false;
+            const int num_set_fds = WaitForReadableDescriptors(handle, have_pipe_fd ? pipe_fd : -1, timeout_usec,
+                                                               handle_ready, pipe_ready);
             if (num_set_fds < 0)
                 error.SetErrorToErrno();
             else
@@ -653,14 +715,13 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
             if (log)
             {
                 if (have_pipe_fd)
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i, %i}, NULL, NULL, timeout=%p) "
+                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  waiting (fds={%i, %i}, timeout_usec=%u) "
                                 "=> %d, error = %s",
-                                static_cast<void *>(this), nfds, handle, pipe_fd, static_cast<void *>(tv_ptr), num_set_fds,
-                                error.AsCString());
+                                static_cast<void *>(this), handle, pipe_fd, timeout_usec, num_set_fds, error.AsCString());
                 else
-                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  ::select (nfds=%i, fds={%i}, NULL, NULL, timeout=%p) => "
+                    log->Printf("%p ConnectionFileDescriptor::BytesAvailable()  waiting (fds={%i}, timeout_usec=%u) => "
                                 "%d, error = %s",
-                                static_cast<void *>(this), nfds, handle, static_cast<void *>(tv_ptr), num_set_fds, error.AsCString());
+                                static_cast<void *>(this), handle, timeout_usec, num_set_fds, error.AsCString());
             }
 
             if (error_ptr)
@@ -692,9 +753,9 @@ ConnectionFileDescriptor::BytesAvailable(uint32_t timeout_usec, Error *error_ptr
             }
             else if (num_set_fds > 0)
             {
-                if (FD_ISSET(handle, FD_SET_DATA(read_fds)))
+                if (handle_ready)
                     return eConnectionStatusSuccess;
-                if (have_pipe_fd && FD_ISSET(pipe_fd, FD_SET_DATA(read_fds)))
+                if (pipe_ready)
                 {
                     // There is an interrupt or exit command in the command pipe
                     // Read the data from that pipe:
@@ -0,0 +1,355 @@
+//===-- MainLoopPosix.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Host/posix/MainLoopPosix.h"
+
+#include <assert.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#else
+#include <poll.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_private;
+
+#if !defined(__linux__)
+// The write end of the self-pipe of the main loop that has signals
+// registered. Signal handlers are process wide, so only one main loop can
+// receive signals at a time on these hosts.
+static int g_signal_pipe_write_fd = -1;
+
+static void
+SignalHandler (int signo)
+{
+    const int saved_errno = errno;
+    const unsigned char signo_byte = static_cast<unsigned char> (signo);
+    if (g_signal_pipe_write_fd >= 0)
+        ::write (g_signal_pipe_write_fd, &signo_byte, sizeof signo_byte);
+    errno = saved_errno;
+}
+#endif
+
+MainLoopPosix::MainLoopPosix () :
+    m_read_fds (),
+    m_signals (),
+    m_signal_fd (-1),
+#if defined(__linux__)
+    m_epoll_fd (::epoll_create1 (EPOLL_CLOEXEC)),
+#else
+    m_signal_pipe_write_fd (-1),
+#endif
+    m_terminate_request (false)
+{
+    sigemptyset (&m_signal_set);
+}
+
+MainLoopPosix::~MainLoopPosix ()
+{
+    assert (m_read_fds.empty () && "read objects outlived the main loop");
+    assert (m_signals.empty () && "signals outlived the main loop");
+
+    if (m_signal_fd >= 0)
+        ::close (m_signal_fd);
+#if defined(__linux__)
+    if (m_epoll_fd >= 0)
+        ::close (m_epoll_fd);
+#else
+    if (m_signal_pipe_write_fd >= 0)
+        ::close (m_signal_pipe_write_fd);
+#endif
+}
+
+Error
+MainLoopPosix::WatchDescriptor (int fd)
+{
+#if defined(__linux__)
+    if (m_epoll_fd < 0)
+        return Error ("epoll_create1 failed");
+
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl (m_epoll_fd, EPOLL_CTL_ADD, fd, &event) == -1)
+        return Error (errno, eErrorTypePOSIX);
+#endif
+    // poll() is given the full set of descriptors on every iteration.
+    return Error ();
+}
+
+MainLoopPosix::ReadHandleUP
+MainLoopPosix::RegisterReadObject (const IOObjectSP &object_sp, const Callback &callback, Error &error)
+{
+    if (!object_sp || !object_sp->IsValid ())
+    {
+        error.SetErrorString ("IO object is not valid.");
+        return nullptr;
+    }
+
+    const IOObject::WaitableHandle handle = object_sp->GetWaitableHandle ();
+    if (m_read_fds.find (handle) != m_read_fds.end ())
+    {
+        error.SetErrorStringWithFormat ("File descriptor %d already monitored.", handle);
+        return nullptr;
+    }
+
+    error = WatchDescriptor (handle);
+    if (error.Fail ())
+        return nullptr;
+
+    m_read_fds[handle] = callback;
+    return CreateReadHandle (object_sp);
+}
+
+void
+MainLoopPosix::UnregisterReadObject (IOObject::WaitableHandle handle)
+{
+    const size_t num_erased = m_read_fds.erase (handle);
+    assert (num_erased == 1 && "unregistering an object that isn't registered");
+    (void)num_erased;
+
+#if defined(__linux__)
+    // This fails with EBADF if the descriptor was closed before its handle
+    // was destroyed, in which case epoll has already forgotten about it.
+    ::epoll_ctl (m_epoll_fd, EPOLL_CTL_DEL, handle, nullptr);
+#endif
+}
+
+MainLoopPosix::SignalHandleUP
+MainLoopPosix::RegisterSignal (int signo, const Callback &callback, Error &error)
+{
+    if (m_signals.find (signo) != m_signals.end ())
+    {
+        error.SetErrorStringWithFormat ("Signal %d already monitored.", signo);
+        return nullptr;
+    }
+
+    SignalInfo info;
+    info.callback = callback;
+
+    sigset_t new_set;
+    sigset_t old_set;
+    sigemptyset (&new_set);
+    sigaddset (&new_set, signo);
+
+#if defined(__linux__)
+    int ret = ::pthread_sigmask (SIG_BLOCK, &new_set, &old_set);
+    if (ret != 0)
+    {
+        error.SetError (ret, eErrorTypePOSIX);
+        return nullptr;
+    }
+    info.was_blocked = sigismember (&old_set, signo);
+
+    sigaddset (&m_signal_set, signo);
+    const bool new_signal_fd = m_signal_fd < 0;
+    const int signal_fd = ::signalfd (m_signal_fd, &m_signal_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd == -1 || (new_signal_fd && (error = WatchDescriptor (signal_fd)).Fail ()))
+    {
+        if (signal_fd == -1)
+            error.SetErrorToErrno ();
+        else
+            ::close (signal_fd);
+        sigdelset (&m_signal_set, signo);
+        if (!info.was_blocked)
+            ::pthread_sigmask (SIG_UNBLOCK, &new_set, nullptr);
+        return nullptr;
+    }
+    m_signal_fd = signal_fd;
+#else
+    if (m_signal_fd < 0)
+    {
+        int fds[2];
+        if (::pipe (fds) == -1)
+        {
+            error.SetErrorToErrno ();
+            return nullptr;
+        }
+        for (int fd : fds)
+        {
+            ::fcntl (fd, F_SETFD, FD_CLOEXEC);
+            ::fcntl (fd, F_SETFL, ::fcntl (fd, F_GETFL) | O_NONBLOCK);
+        }
+        m_signal_fd = fds[0];
+        m_signal_pipe_write_fd = fds[1];
+    }
+    g_signal_pipe_write_fd = m_signal_pipe_write_fd;
+
+    struct sigaction new_action;
+    new_action.sa_handler = SignalHandler;
+    new_action.sa_flags = SA_RESTART;
+    sigemptyset (&new_action.sa_mask);
+    if (::sigaction (signo, &new_action, &info.old_action) == -1)
+    {
+        error.SetErrorToErrno ();
+        return nullptr;
+    }
+
+    // Make sure the signal can be delivered to our handler.
+    ::pthread_sigmask (SIG_UNBLOCK, &new_set, &old_set);
+    info.was_blocked = sigismember (&old_set, signo);
+    sigaddset (&m_signal_set, signo);
+#endif
+
+    m_signals.insert (std::make_pair (signo, info));
+    return SignalHandleUP (new SignalHandle (*this, signo));
+}
+
+void
+MainLoopPosix::UnregisterSignal (int signo)
+{
+    auto pos = m_signals.find (signo);
+    assert (pos != m_signals.end ());
+    if (pos == m_signals.end ())
+        return;
+
+    sigset_t set;
+    sigemptyset (&set);
+    sigaddset (&set, signo);
+    sigdelset (&m_signal_set, signo);
+
+#if defined(__linux__)
+    ::signalfd (m_signal_fd, &m_signal_set, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (!pos->second.was_blocked)
+        ::pthread_sigmask (SIG_UNBLOCK, &set, nullptr);
+#else
+    ::sigaction (signo, &pos->second.old_action, nullptr);
+    if (pos->second.was_blocked)
+        ::pthread_sigmask (SIG_BLOCK, &set, nullptr);
+#endif
+
+    m_signals.erase (pos);
+}
+
+void
+MainLoopPosix::ProcessReadObject (IOObject::WaitableHandle handle)
+{
+    auto pos = m_read_fds.find (handle);
+    if (pos == m_read_fds.end ())
+        return; // Unregistered by an earlier callback.
+
+    // The callback may unregister itself, so don't run it out of the map.
+    Callback callback = pos->second;
+    callback (*this);
+}
+
+void
+MainLoopPosix::ProcessSignal (int signo)
+{
+    auto pos = m_signals.find (signo);
+    if (pos == m_signals.end ())
+        return;
+
+    Callback callback = pos->second.callback;
+    callback (*this);
+}
+
+void
+MainLoopPosix::ProcessSignals ()
+{
+    // Several instances of a signal that arrive before we get to read them
+    // are merged into one, which is fine for all of the signals that we
+    // care about.
+    std::vector<int> signals;
+    while (true)
+    {
+#if defined(__linux__)
+        struct signalfd_siginfo info;
+        const ssize_t size = ::read (m_signal_fd, &info, sizeof info);
+        if (size == -1 && errno == EINTR)
+            continue;
+        if (size != sizeof info)
+            break;
+        const int signo = info.ssi_signo;
+#else
+        unsigned char signo_byte;
+        const ssize_t size = ::read (m_signal_fd, &signo_byte, sizeof signo_byte);
+        if (size == -1 && errno == EINTR)
+            continue;
+        if (size != sizeof signo_byte)
+            break;
+        const int signo = signo_byte;
+#endif
+        if (std::find (signals.begin (), signals.end (), signo) == signals.end ())
+            signals.push_back (signo);
+    }
+
+    for (int signo : signals)
+    {
+        if (m_terminate_request)
+            break;
+        ProcessSignal (signo);
+    }
+}
+
+Error
+MainLoopPosix::Run ()
+{
+    m_terminate_request = false;
+
+    std::vector<int> ready_fds;
+    while (!m_terminate_request)
+    {
+        ready_fds.clear ();
+
+#if defined(__linux__)
+        static const int kMaxEvents = 64;
+        struct epoll_event events[kMaxEvents];
+        const int num_events = ::epoll_wait (m_epoll_fd, events, kMaxEvents, -1);
+        if (num_events == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return Error (errno, eErrorTypePOSIX);
+        }
+
+        for (int i = 0; i < num_events; ++i)
+            ready_fds.push_back (events[i].data.fd);
+#else
+        std::vector<struct pollfd> fds;
+        if (m_signal_fd >= 0)
+            fds.push_back ({ m_signal_fd, POLLIN, 0 });
+        for (const auto &fd_and_callback : m_read_fds)
+            fds.push_back ({ fd_and_callback.first, POLLIN, 0 });
+
+        if (::poll (fds.data (), fds.size (), -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            return Error (errno, eErrorTypePOSIX);
+        }
+
+        for (const struct pollfd &fd : fds)
+        {
+            if (fd.revents != 0)
+                ready_fds.push_back (fd.fd);
+        }
+#endif
+
+        for (int fd : ready_fds)
+        {
+            if (m_terminate_request)
+                break;
+
+            if (fd == m_signal_fd)
+                ProcessSignals ();
+            else
+                ProcessReadObject (fd);
+        }
+    }
+    return Error ();
+}
@@ -183,4 +183,5 @@ SystemInitializerCommon::Terminate()
 #endif
 
     Log::Terminate();
+    Timer::Terminate();
 }
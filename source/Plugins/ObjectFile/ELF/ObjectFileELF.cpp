@@ -23,6 +23,8 @@
 #include "lldb/Core/Section.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/LZMA.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Target/SectionLoadList.h"
@@ -350,6 +352,31 @@ kalimbaSectionType(
     return eSectionTypeOther;
 }
 
+//------------------------------------------------------------------
+// Cache of decompressed .gnu_debugdata (MiniDebugInfo) ELF images keyed
+// by the build-id of the object file that contained them, so that
+// re-creating the same module (e.g. when analyzing many core files of
+// the same binary) doesn't decompress the same data again.
+//
+// The modules own the images; the cache only refers to them, so an
+// image goes away with the last module that uses it.
+//------------------------------------------------------------------
+typedef std::map<lldb_private::UUID, std::weak_ptr<DataBuffer>> GnuDebugDataCache;
+
+static Mutex &
+GetGnuDebugDataCacheMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeNormal);
+    return g_mutex;
+}
+
+static GnuDebugDataCache &
+GetGnuDebugDataCache ()
+{
+    static GnuDebugDataCache g_cache;
+    return g_cache;
+}
+
 // Arbitrary constant used as UUID prefix for core files.
 const uint32_t
 ObjectFileELF::g_core_uuid_magic(0xE210C);
@@ -371,6 +398,9 @@ void
 ObjectFileELF::Terminate()
 {
     PluginManager::UnregisterPlugin(CreateInstance);
+
+    Mutex::Locker locker (GetGnuDebugDataCacheMutex());
+    GetGnuDebugDataCache().clear();
 }
 
 lldb_private::ConstString
@@ -799,7 +829,9 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_gnu_debug_data_object_file_sp(),
+    m_gnu_debug_data_parsed(false)
 {
     if (file)
         m_file = *file;
@@ -820,7 +852,9 @@ ObjectFileELF::ObjectFileELF (const lldb::ModuleSP &module_sp,
     m_dynamic_symbols(),
     m_filespec_ap(),
     m_entry_point_address(),
-    m_arch_spec()
+    m_arch_spec(),
+    m_gnu_debug_data_object_file_sp(),
+    m_gnu_debug_data_parsed(false)
 {
     ::memset(&m_header, 0, sizeof(m_header));
 }
@@ -1599,6 +1633,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             static ConstString g_sect_name_dwarf_debug_ranges (".debug_ranges");
             static ConstString g_sect_name_dwarf_debug_str (".debug_str");
             static ConstString g_sect_name_eh_frame (".eh_frame");
+            static ConstString g_sect_name_gnu_debugdata (".gnu_debugdata");
 
             SectionType sect_type = eSectionTypeOther;
 
@@ -1628,7 +1663,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             // .debug_pubtypes – Lookup table for mapping type names to compilation units
             // .debug_ranges – Address ranges used in DW_AT_ranges attributes
             // .debug_str – String table used in .debug_info
-            // MISSING? .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
+            // .gnu_debugdata - "mini debuginfo / MiniDebugInfo" section, http://sourceware.org/gdb/onlinedocs/gdb/MiniDebugInfo.html
             // MISSING? .debug-index - http://src.chromium.org/viewvc/chrome/trunk/src/build/gdb-add-index?pathrev=144644
             // MISSING? .debug_types - Type descriptions from DWARF 4? See http://gcc.gnu.org/wiki/DwarfSeparateTypeInfo
             else if (name == g_sect_name_dwarf_debug_abbrev)    sect_type = eSectionTypeDWARFDebugAbbrev;
@@ -1643,6 +1678,7 @@ ObjectFileELF::CreateSections(SectionList &unified_section_list)
             else if (name == g_sect_name_dwarf_debug_ranges)    sect_type = eSectionTypeDWARFDebugRanges;
             else if (name == g_sect_name_dwarf_debug_str)       sect_type = eSectionTypeDWARFDebugStr;
             else if (name == g_sect_name_eh_frame)              sect_type = eSectionTypeEHFrame;
+            else if (name == g_sect_name_gnu_debugdata)         sect_type = eSectionTypeGNUDebugData;
 
             switch (header.sh_type)
             {
@@ -2504,6 +2540,25 @@ ObjectFileELF::GetSymtab()
         if (symtab)
             symbol_id += ParseSymbolTable (m_symtab_ap.get(), symbol_id, symtab);
 
+        // Stripped binaries may still carry a MiniDebugInfo .gnu_debugdata
+        // section: an LZMA compressed ELF file whose .symtab contains the
+        // local function symbols that were removed from this file. Merge
+        // those in when we didn't find a full symbol table above.
+        if (symtab == nullptr || symtab->GetType() != eSectionTypeELFSymbolTable)
+        {
+            ObjectFileELF *gdd_obj_file = GetGnuDebugDataObjectFile();
+            if (gdd_obj_file)
+            {
+                SectionList *gdd_section_list = gdd_obj_file->GetSectionList();
+                if (gdd_section_list)
+                {
+                    Section *gdd_symtab = gdd_section_list->FindSectionByType (eSectionTypeELFSymbolTable, true).get();
+                    if (gdd_symtab)
+                        symbol_id += ParseSymbolTable (m_symtab_ap.get(), symbol_id, gdd_symtab);
+                }
+            }
+        }
+
         // DT_JMPREL
         //      If present, this entry's d_ptr member holds the address of relocation
         //      entries associated solely with the procedure linkage table. Separating
@@ -2549,6 +2604,116 @@ ObjectFileELF::GetSymtab()
     return m_symtab_ap.get();
 }
 
+ObjectFileELF *
+ObjectFileELF::GetGnuDebugDataObjectFile()
+{
+    if (m_gnu_debug_data_parsed)
+        return m_gnu_debug_data_object_file_sp.get();
+    m_gnu_debug_data_parsed = true;
+
+    ModuleSP module_sp(GetModule());
+    if (!module_sp)
+        return nullptr;
+
+    SectionList *section_list = GetSectionList();
+    if (!section_list)
+        return nullptr;
+
+    SectionSP gdd_section_sp (section_list->FindSectionByType (eSectionTypeGNUDebugData, true));
+    if (!gdd_section_sp || gdd_section_sp->GetFileSize() == 0)
+        return nullptr;
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_SYMBOLS));
+
+    if (!lzma::IsAvailable())
+    {
+        if (log)
+            log->Printf ("ObjectFileELF::%s ignoring .gnu_debugdata section of %s, LLDB was built without LZMA support",
+                         __FUNCTION__, module_sp->GetFileSpec().GetPath().c_str());
+        return nullptr;
+    }
+
+    lldb_private::UUID uuid;
+    const bool has_uuid = GetUUID (&uuid);
+
+    DataBufferSP gdd_data_sp;
+    if (has_uuid)
+    {
+        Mutex::Locker locker (GetGnuDebugDataCacheMutex());
+        GnuDebugDataCache::const_iterator pos = GetGnuDebugDataCache().find (uuid);
+        if (pos != GetGnuDebugDataCache().end())
+            gdd_data_sp = pos->second.lock();
+        if (gdd_data_sp && log)
+            log->Printf ("ObjectFileELF::%s reusing decompressed .gnu_debugdata for %s",
+                         __FUNCTION__, module_sp->GetFileSpec().GetPath().c_str());
+    }
+
+    if (!gdd_data_sp)
+    {
+        Timer scoped_timer (__PRETTY_FUNCTION__,
+                            "ObjectFileELF::GetGnuDebugDataObjectFile (module = %s)",
+                            module_sp->GetFileSpec().GetPath().c_str());
+
+        DataExtractor compressed_data;
+        if (!ReadSectionData (gdd_section_sp.get(), compressed_data))
+            return nullptr;
+
+        Error error;
+        gdd_data_sp = lzma::Uncompress (compressed_data.GetDataStart(),
+                                        compressed_data.GetByteSize(),
+                                        error);
+        if (!gdd_data_sp)
+        {
+            if (log)
+                log->Printf ("ObjectFileELF::%s failed to decompress .gnu_debugdata section of %s: %s",
+                             __FUNCTION__, module_sp->GetFileSpec().GetPath().c_str(), error.AsCString());
+            return nullptr;
+        }
+
+        if (has_uuid)
+        {
+            // Drop the images of modules that are gone while we are here.
+            Mutex::Locker locker (GetGnuDebugDataCacheMutex());
+            GnuDebugDataCache &cache = GetGnuDebugDataCache();
+            for (GnuDebugDataCache::iterator pos = cache.begin(); pos != cache.end(); )
+            {
+                if (pos->second.expired())
+                    pos = cache.erase (pos);
+                else
+                    ++pos;
+            }
+            cache[uuid] = gdd_data_sp;
+        }
+    }
+
+    if (gdd_data_sp->GetByteSize() <= llvm::ELF::EI_NIDENT ||
+        !ELFHeader::MagicBytesMatch (gdd_data_sp->GetBytes()))
+        return nullptr;
+
+    std::shared_ptr<ObjectFileELF> gdd_obj_file_sp (new ObjectFileELF (module_sp,
+                                                                       gdd_data_sp,
+                                                                       0,
+                                                                       nullptr,
+                                                                       0,
+                                                                       gdd_data_sp->GetByteSize()));
+    if (!gdd_obj_file_sp->ParseHeader())
+        return nullptr;
+
+    // The sections of the MiniDebugInfo file mirror ours, but the ones that
+    // contain code and data are SHT_NOBITS. ParseSymbols() maps symbols in
+    // those back onto the sections of this module by name.
+    SectionList gdd_section_list;
+    gdd_obj_file_sp->CreateSections (gdd_section_list);
+
+    if (log)
+        log->Printf ("ObjectFileELF::%s using %" PRIu64 " bytes of .gnu_debugdata from %s",
+                     __FUNCTION__, (uint64_t)gdd_data_sp->GetByteSize(),
+                     module_sp->GetFileSpec().GetPath().c_str());
+
+    m_gnu_debug_data_object_file_sp = gdd_obj_file_sp;
+    return m_gnu_debug_data_object_file_sp.get();
+}
+
 Symbol *
 ObjectFileELF::ResolveSymbolForAddress(const Address& so_addr, bool verify_unique)
 {
@@ -257,6 +257,12 @@ private:
     /// The address class for each symbol in the elf file
     FileAddressToAddressClassMap m_address_class_map;
 
+    /// The decompressed .gnu_debugdata (MiniDebugInfo) object file, if any.
+    std::shared_ptr<ObjectFileELF> m_gnu_debug_data_object_file_sp;
+
+    /// True once we have looked for a .gnu_debugdata section.
+    bool m_gnu_debug_data_parsed;
+
     /// Returns a 1 based index of the given section header.
     size_t
     SectionIndex(const SectionHeaderCollIter &I);
@@ -336,6 +342,13 @@ private:
                            const ELFSectionHeaderInfo *rela_hdr,
                            lldb::user_id_t section_id);
 
+    /// Returns the object file embedded in the LZMA compressed
+    /// .gnu_debugdata section (MiniDebugInfo) or NULL if there is none or
+    /// it can't be decompressed. Decompressed images are shared by build-id
+    /// between the modules that use them.
+    ObjectFileELF *
+    GetGnuDebugDataObjectFile();
+
     /// Relocates debug sections
     unsigned
     RelocateDebugSections(const elf::ELFSectionHeader *rel_hdr, lldb::user_id_t rel_id);
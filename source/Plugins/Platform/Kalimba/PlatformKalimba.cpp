@@ -327,6 +327,7 @@ Error
 PlatformKalimba::LaunchNativeProcess (
     ProcessLaunchInfo &,
     lldb_private::NativeProcessProtocol::NativeDelegate &,
+    MainLoop &,
     NativeProcessProtocolSP &)
 {
     return Error();
@@ -335,6 +336,7 @@ PlatformKalimba::LaunchNativeProcess (
 Error
 PlatformKalimba::AttachNativeProcess (lldb::pid_t,
                                     lldb_private::NativeProcessProtocol::NativeDelegate &,
+                                    MainLoop &,
                                     NativeProcessProtocolSP &)
 {
     return Error();
@@ -883,6 +883,7 @@ PlatformLinux::CalculateTrapHandlerSymbolNames ()
 Error
 PlatformLinux::LaunchNativeProcess (ProcessLaunchInfo &launch_info,
                                     NativeProcessProtocol::NativeDelegate &native_delegate,
+                                    MainLoop &mainloop,
                                     NativeProcessProtocolSP &process_sp)
 {
 #if !defined(__linux__)
@@ -911,6 +912,7 @@ PlatformLinux::LaunchNativeProcess (ProcessLaunchInfo &launch_info,
         exe_module_sp.get (),
         launch_info,
         native_delegate,
+        mainloop,
         process_sp);
 
     return error;
@@ -920,6 +922,7 @@ PlatformLinux::LaunchNativeProcess (ProcessLaunchInfo &launch_info,
 Error
 PlatformLinux::AttachNativeProcess (lldb::pid_t pid,
                                     NativeProcessProtocol::NativeDelegate &native_delegate,
+                                    MainLoop &mainloop,
                                     NativeProcessProtocolSP &process_sp)
 {
 #if !defined(__linux__)
@@ -929,7 +932,7 @@ PlatformLinux::AttachNativeProcess (lldb::pid_t pid,
         return Error("PlatformLinux::%s (): cannot attach to a debug process when not the host", __FUNCTION__);
 
     // Launch it for debugging
-    return process_linux::NativeProcessLinux::AttachToProcess (pid, native_delegate, process_sp);
+    return process_linux::NativeProcessLinux::AttachToProcess (pid, native_delegate, mainloop, process_sp);
 #endif
 }
 
@@ -11,18 +11,21 @@
 
 // C Includes
 #include <errno.h>
-#include <semaphore.h>
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
 
 // C++ Includes
+#include <algorithm>
+#include <atomic>
 #include <fstream>
 #include <sstream>
 #include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/EmulateInstruction.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/Module.h"
@@ -49,7 +52,9 @@
 
 // System includes - They have to be included after framework includes because they define some
 // macros which collide with variable names in other modules
+#include <fcntl.h>
 #include <linux/unistd.h>
+#include <sys/mman.h>
 #include <sys/socket.h>
 
 #include <sys/types.h>
@@ -59,7 +64,6 @@
 
 #include "lldb/Host/linux/Personality.h"
 #include "lldb/Host/linux/Ptrace.h"
-#include "lldb/Host/linux/Signalfd.h"
 #include "lldb/Host/android/Android.h"
 
 #define LLDB_PERSONALITY_GET_CURRENT_SETTINGS  0xffffffff
@@ -252,6 +256,36 @@ namespace
         return bytes_read;
     }
 
+    //------------------------------------------------------------------------------
+    // process_vm_readv() reads any number of ranges from another process with
+    // a single system call. It isn't available on kernels before 3.2 and older
+    // C libraries don't have a wrapper for it, so call it directly.
+
+    std::atomic<bool> g_process_vm_readv_supported (true);
+
+    ssize_t
+    ProcessVMReadv(
+        lldb::pid_t pid,
+        const struct iovec *local_iov,
+        unsigned long local_count,
+        const struct iovec *remote_iov,
+        unsigned long remote_count)
+    {
+#if defined(__NR_process_vm_readv)
+        return syscall(__NR_process_vm_readv, pid, local_iov, local_count, remote_iov, remote_count, 0UL);
+#else
+        errno = ENOSYS;
+        return -1;
+#endif
+    }
+
+    //------------------------------------------------------------------------------
+    // Writing /proc/<pid>/mem can write read-only pages like ptrace can, but
+    // takes a whole block with one system call instead of one per word.
+    // Kernels before 2.6.39 refuse the writes.
+
+    bool g_proc_mem_write_supported = true;
+
     size_t
     DoWriteMemory(
         lldb::pid_t pid,
@@ -367,7 +401,7 @@ namespace
     void
     ReadOperation::Execute (NativeProcessLinux *process)
     {
-        m_result = DoReadMemory (process->GetID (), m_addr, m_buff, m_size, m_error);
+        m_result = DoReadMemory (process->GetMemoryAccessThreadID (), m_addr, m_buff, m_size, m_error);
     }
 
     //------------------------------------------------------------------------------
@@ -401,7 +435,7 @@ namespace
     void
     WriteOperation::Execute(NativeProcessLinux *process)
     {
-        m_result = DoWriteMemory (process->GetID (), m_addr, m_buff, m_size, m_error);
+        m_result = DoWriteMemory (process->GetMemoryAccessThreadID (), m_addr, m_buff, m_size, m_error);
     }
 
     //------------------------------------------------------------------------------
@@ -525,6 +559,27 @@ namespace
     {
         NativeProcessLinux::PtraceWrapper(PTRACE_DETACH, m_tid, nullptr, 0, 0, m_error);
     }
+
+    uint32_t
+    GetRegionPermissions (const MemoryRegionInfo &region_info)
+    {
+        uint32_t permissions = 0;
+        if (region_info.GetReadable () == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsReadable;
+        if (region_info.GetWritable () == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsWritable;
+        if (region_info.GetExecutable () == MemoryRegionInfo::eYes)
+            permissions |= lldb::ePermissionsExecutable;
+        return permissions;
+    }
+
+    void
+    SetRegionPermissions (MemoryRegionInfo &region_info, uint32_t permissions)
+    {
+        region_info.SetReadable ((permissions & lldb::ePermissionsReadable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetWritable ((permissions & lldb::ePermissionsWritable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetExecutable ((permissions & lldb::ePermissionsExecutable) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+    }
 } // end of anonymous namespace
 
 // Simple helper function to ensure flags are enabled on the given file
@@ -550,235 +605,21 @@ EnsureFDFlags(int fd, int flags)
     return error;
 }
 
-// This class encapsulates the privileged thread which performs all ptrace and wait operations on
-// the inferior. The thread consists of a main loop which waits for events and processes them
-//   - SIGCHLD (delivered over a signalfd file descriptor): These signals notify us of events in
-//     the inferior process. Upon receiving this signal we do a waitpid to get more information
-//     and dispatch to NativeProcessLinux::MonitorCallback.
-//   - requests for ptrace operations: These initiated via the DoOperation method, which funnels
-//     them to the Monitor thread via m_operation member. The Monitor thread is signaled over a
-//     pipe, and the completion of the operation is signalled over the semaphore.
-//   - thread exit event: this is signaled from the Monitor destructor by closing the write end
-//     of the command pipe.
-class NativeProcessLinux::Monitor
-{
-private:
-    // The initial monitor operation (launch or attach). It returns a inferior process id.
-    std::unique_ptr<InitialOperation> m_initial_operation_up;
-
-    ::pid_t                           m_child_pid = -1;
-    NativeProcessLinux              * m_native_process;
-
-    enum { READ, WRITE };
-    int        m_pipefd[2] = {-1, -1};
-    int        m_signal_fd = -1;
-    HostThread m_thread;
-
-    // current operation which must be executed on the priviliged thread
-    Mutex      m_operation_mutex;
-    Operation *m_operation = nullptr;
-    sem_t      m_operation_sem;
-    Error      m_operation_error;
-
-    unsigned   m_operation_nesting_level = 0;
-
-    static constexpr char operation_command   = 'o';
-    static constexpr char begin_block_command = '{';
-    static constexpr char end_block_command   = '}';
-
-    void
-    HandleSignals();
-
-    void
-    HandleWait();
-
-    // Returns true if the thread should exit.
-    bool
-    HandleCommands();
-
-    void
-    MainLoop();
-
-    static void *
-    RunMonitor(void *arg);
-
-    Error
-    WaitForAck();
-
-    void
-    BeginOperationBlock()
-    {
-        write(m_pipefd[WRITE], &begin_block_command, sizeof operation_command);
-        WaitForAck();
-    }
-
-    void
-    EndOperationBlock()
-    {
-        write(m_pipefd[WRITE], &end_block_command, sizeof operation_command);
-        WaitForAck();
-    }
-
-public:
-    Monitor(const InitialOperation &initial_operation,
-            NativeProcessLinux *native_process)
-        : m_initial_operation_up(new InitialOperation(initial_operation)),
-          m_native_process(native_process)
-    {
-        sem_init(&m_operation_sem, 0, 0);
-    }
-
-    ~Monitor();
-
-    Error
-    Initialize();
-
-    void
-    Terminate();
-
-    void
-    DoOperation(Operation *op);
-
-    class ScopedOperationLock {
-        Monitor &m_monitor;
-
-    public:
-        ScopedOperationLock(Monitor &monitor)
-            : m_monitor(monitor)
-        { m_monitor.BeginOperationBlock(); }
-
-        ~ScopedOperationLock()
-        { m_monitor.EndOperationBlock(); }
-    };
-};
-constexpr char NativeProcessLinux::Monitor::operation_command;
-constexpr char NativeProcessLinux::Monitor::begin_block_command;
-constexpr char NativeProcessLinux::Monitor::end_block_command;
-
-Error
-NativeProcessLinux::Monitor::Initialize()
-{
-    Error error;
-
-    // We get a SIGCHLD every time something interesting happens with the inferior. We shall be
-    // listening for these signals over a signalfd file descriptors. This allows us to wait for
-    // multiple kinds of events with select.
-    sigset_t signals;
-    sigemptyset(&signals);
-    sigaddset(&signals, SIGCHLD);
-    m_signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
-    if (m_signal_fd < 0)
-    {
-        return Error("NativeProcessLinux::Monitor::%s failed due to signalfd failure. Monitoring the inferior will be impossible: %s",
-                    __FUNCTION__, strerror(errno));
-
-    }
-
-    if (pipe2(m_pipefd, O_CLOEXEC) == -1)
-    {
-        error.SetErrorToErrno();
-        return error;
-    }
-
-    if ((error = EnsureFDFlags(m_pipefd[READ], O_NONBLOCK)).Fail()) {
-        return error;
-    }
-
-    static const char g_thread_name[] = "lldb.process.nativelinux.monitor";
-    m_thread = ThreadLauncher::LaunchThread(g_thread_name, Monitor::RunMonitor, this, nullptr);
-    if (!m_thread.IsJoinable())
-        return Error("Failed to create monitor thread for NativeProcessLinux.");
-
-    // Wait for initial operation to complete.
-    return WaitForAck();
-}
-
-void
-NativeProcessLinux::Monitor::DoOperation(Operation *op)
-{
-    if (m_thread.EqualsThread(pthread_self())) {
-        // If we're on the Monitor thread, we can simply execute the operation.
-        op->Execute(m_native_process);
-        return;
-    }
-
-    // Otherwise we need to pass the operation to the Monitor thread so it can handle it.
-    Mutex::Locker lock(m_operation_mutex);
-
-    m_operation = op;
-
-    // notify the thread that an operation is ready to be processed
-    write(m_pipefd[WRITE], &operation_command, sizeof operation_command);
-
-    WaitForAck();
-}
-
-void
-NativeProcessLinux::Monitor::Terminate()
-{
-    if (m_pipefd[WRITE] >= 0)
-    {
-        close(m_pipefd[WRITE]);
-        m_pipefd[WRITE] = -1;
-    }
-    if (m_thread.IsJoinable())
-        m_thread.Join(nullptr);
-}
-
-NativeProcessLinux::Monitor::~Monitor()
-{
-    Terminate();
-    if (m_pipefd[READ] >= 0)
-        close(m_pipefd[READ]);
-    if (m_signal_fd >= 0)
-        close(m_signal_fd);
-    sem_destroy(&m_operation_sem);
-}
-
+// Handles the SIGCHLD that we get every time something interesting happens with the inferior:
+// the waitpid events that it signals are reaped and dispatched to MonitorCallback. This runs on
+// the main loop thread, like everything else that touches the inferior, so ptrace requests made
+// in response to the events don't need to be passed to another thread.
 void
-NativeProcessLinux::Monitor::HandleSignals()
+NativeProcessLinux::SigchldHandler()
 {
     Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
 
-    // We don't really care about the content of the SIGCHLD siginfo structure, as we will get
-    // all the information from waitpid(). We just need to read all the signals so that we can
-    // sleep next time we reach select().
-    while (true)
-    {
-        signalfd_siginfo info;
-        ssize_t size = read(m_signal_fd, &info, sizeof info);
-        if (size == -1)
-        {
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
-                break; // We are done.
-            if (errno == EINTR)
-                continue;
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s reading from signalfd file descriptor failed: %s",
-                        __FUNCTION__, strerror(errno));
-            break;
-        }
-        if (size != sizeof info)
-        {
-            // We got incomplete information structure. This should not happen, let's just log
-            // that.
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s reading from signalfd file descriptor returned incomplete data: "
-                        "structure size is %zd, read returned %zd bytes",
-                        __FUNCTION__, sizeof info, size);
-            break;
-        }
-        if (log)
-            log->Printf("NativeProcessLinux::Monitor::%s received signal %s(%d).", __FUNCTION__,
-                Host::GetSignalAsCString(info.ssi_signo), info.ssi_signo);
-    }
-}
-
-void
-NativeProcessLinux::Monitor::HandleWait()
-{
-    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
-    // Process all pending waitpid notifications.
+    // Reap all pending waitpid notifications before dispatching any of them.
+    // When many threads stop at about the same time, the first stop we
+    // dispatch stops all of the other threads, and the ones whose stops are
+    // already in this batch don't need to be sent a SIGSTOP.
+    std::vector<std::pair<::pid_t, int>> events;
+    events.swap (m_deferred_wait_events);
     while (true)
     {
         int status = -1;
@@ -793,11 +634,22 @@ NativeProcessLinux::Monitor::HandleWait()
                 continue;
 
             if (log)
-              log->Printf("NativeProcessLinux::Monitor::%s waitpid (-1, &status, __WALL | __WNOTHREAD | WNOHANG) failed: %s",
+              log->Printf("NativeProcessLinux::%s waitpid (-1, &status, __WALL | __WNOTHREAD | WNOHANG) failed: %s",
                       __FUNCTION__, strerror(errno));
             break;
         }
 
+        events.push_back(std::make_pair(wait_pid, status));
+        if (WIFSTOPPED(status))
+            m_undispatched_stop_tids.insert(wait_pid);
+    }
+
+    for (const auto &event : events)
+    {
+        const ::pid_t wait_pid = event.first;
+        const int status = event.second;
+        m_undispatched_stop_tids.erase(wait_pid);
+
         bool exited = false;
         int signal = 0;
         int exit_status = 0;
@@ -817,7 +669,7 @@ NativeProcessLinux::Monitor::HandleWait()
         {
             signal = WTERMSIG(status);
             status_cstr = "SIGNALED";
-            if (wait_pid == m_child_pid) {
+            if (wait_pid == static_cast< ::pid_t> (GetID ())) {
                 exited = true;
                 exit_status = -1;
             }
@@ -826,128 +678,21 @@ NativeProcessLinux::Monitor::HandleWait()
             status_cstr = "(\?\?\?)";
 
         if (log)
-            log->Printf("NativeProcessLinux::Monitor::%s: waitpid (-1, &status, __WALL | __WNOTHREAD | WNOHANG)"
+            log->Printf("NativeProcessLinux::%s: waitpid (-1, &status, __WALL | __WNOTHREAD | WNOHANG)"
                 "=> pid = %" PRIi32 ", status = 0x%8.8x (%s), signal = %i, exit_state = %i",
                 __FUNCTION__, wait_pid, status, status_cstr, signal, exit_status);
 
-        m_native_process->MonitorCallback (wait_pid, exited, signal, exit_status);
-    }
-}
-
-bool
-NativeProcessLinux::Monitor::HandleCommands()
-{
-    Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
-
-    while (true)
-    {
-        char command = 0;
-        ssize_t size = read(m_pipefd[READ], &command, sizeof command);
-        if (size == -1)
-        {
-            if (errno == EAGAIN || errno == EWOULDBLOCK)
-                return false;
-            if (errno == EINTR)
-                continue;
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s exiting because read from command file descriptor failed: %s", __FUNCTION__, strerror(errno));
-            return true;
-        }
-        if (size == 0) // end of file - write end closed
-        {
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s exit command received, exiting...", __FUNCTION__);
-            assert(m_operation_nesting_level == 0 && "Unbalanced begin/end block commands detected");
-            return true; // We are done.
-        }
-
-        switch (command)
-        {
-        case operation_command:
-            m_operation->Execute(m_native_process);
-            break;
-        case begin_block_command:
-            ++m_operation_nesting_level;
-            break;
-        case end_block_command:
-            assert(m_operation_nesting_level > 0);
-            --m_operation_nesting_level;
-            break;
-        default:
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s received unknown command '%c'",
-                        __FUNCTION__, command);
-        }
-
-        // notify calling thread that the command has been processed
-        sem_post(&m_operation_sem);
-    }
-}
-
-void
-NativeProcessLinux::Monitor::MainLoop()
-{
-    ::pid_t child_pid = (*m_initial_operation_up)(m_operation_error);
-    m_initial_operation_up.reset();
-    m_child_pid = child_pid;
-    sem_post(&m_operation_sem);
-
-    while (true)
-    {
-        fd_set fds;
-        FD_ZERO(&fds);
-        // Only process waitpid events if we are outside of an operation block. Any pending
-        // events will be processed after we leave the block.
-        if (m_operation_nesting_level == 0)
-            FD_SET(m_signal_fd, &fds);
-        FD_SET(m_pipefd[READ], &fds);
-
-        int max_fd = std::max(m_signal_fd, m_pipefd[READ]) + 1;
-        int r = select(max_fd, &fds, nullptr, nullptr, nullptr);
-        if (r < 0)
-        {
-            Log *log(GetLogIfAllCategoriesSet(LIBLLDB_LOG_PROCESS));
-            if (log)
-                log->Printf("NativeProcessLinux::Monitor::%s exiting because select failed: %s",
-                        __FUNCTION__, strerror(errno));
-            return;
-        }
-
-        if (FD_ISSET(m_pipefd[READ], &fds))
-        {
-            if (HandleCommands())
-                return;
-        }
-
-        if (FD_ISSET(m_signal_fd, &fds))
-        {
-            HandleSignals();
-            HandleWait();
-        }
+        MonitorCallback (wait_pid, exited, signal, exit_status);
     }
-}
 
-Error
-NativeProcessLinux::Monitor::WaitForAck()
-{
-    Error error;
-    while (sem_wait(&m_operation_sem) != 0)
+    // Some of the threads we didn't send a SIGSTOP to because they were in
+    // this batch may have been resumed rather than stopped by their event
+    // (thread creation, syscall, ...). Stop them now.
+    if (m_pending_notification_up)
     {
-        if (errno == EINTR)
-            continue;
-
-        error.SetErrorToErrno();
-        return error;
+        Mutex::Locker locker (m_threads_mutex);
+        RequestStopOnWaitedForThreads();
     }
-
-    return m_operation_error;
-}
-
-void *
-NativeProcessLinux::Monitor::RunMonitor(void *arg)
-{
-    static_cast<Monitor *>(arg)->MainLoop();
-    return nullptr;
 }
 
 
@@ -982,6 +727,7 @@ NativeProcessLinux::LaunchProcess (
     Module *exe_module,
     ProcessLaunchInfo &launch_info,
     NativeProcessProtocol::NativeDelegate &native_delegate,
+    MainLoop &mainloop,
     NativeProcessProtocolSP &native_process_sp)
 {
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
@@ -1059,6 +805,13 @@ NativeProcessLinux::LaunchProcess (
         return error;
     }
 
+    error = std::static_pointer_cast<NativeProcessLinux> (native_process_sp)->RegisterSigchldHandler (mainloop);
+    if (error.Fail ())
+    {
+        native_process_sp.reset ();
+        return error;
+    }
+
     std::static_pointer_cast<NativeProcessLinux> (native_process_sp)->LaunchInferior (
             exe_module,
             launch_info.GetArguments ().GetConstArgumentVector (),
@@ -1087,6 +840,7 @@ Error
 NativeProcessLinux::AttachToProcess (
     lldb::pid_t pid,
     NativeProcessProtocol::NativeDelegate &native_delegate,
+    MainLoop &mainloop,
     NativeProcessProtocolSP &native_process_sp)
 {
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
@@ -1113,6 +867,10 @@ NativeProcessLinux::AttachToProcess (
         return error;
     }
 
+    error = native_process_linux_sp->RegisterSigchldHandler (mainloop);
+    if (error.Fail ())
+        return error;
+
     native_process_linux_sp->AttachToInferior (pid, error);
     if (!error.Success ())
         return error;
@@ -1130,13 +888,29 @@ NativeProcessLinux::NativeProcessLinux () :
     m_arch (),
     m_supports_mem_region (eLazyBoolCalculate),
     m_mem_region_cache (),
-    m_mem_region_cache_mutex ()
+    m_mem_region_cache_stale (true),
+    m_mem_region_generation (0),
+    m_mem_region_cache_mutex (),
+    m_displaced_steps (),
+    m_displaced_step_slots_in_use (),
+    m_displaced_step_scratch_addr (LLDB_INVALID_ADDRESS),
+    m_threads_stepping_over_breakpoint ()
+{
+    m_software_watchpoint_list.SetPageSize (::sysconf (_SC_PAGESIZE));
+}
+
+Error
+NativeProcessLinux::RegisterSigchldHandler (MainLoop &mainloop)
 {
+    Error error;
+    m_sigchld_handle = mainloop.RegisterSignal (SIGCHLD,
+            [this] (MainLoopBase &) { SigchldHandler (); }, error);
+    return error;
 }
 
 //------------------------------------------------------------------------------
-// NativeProcessLinux spawns a new thread which performs all operations on the inferior process.
-// Refer to Monitor and Operation classes to see why this is necessary.
+// The inferior is launched and attached to on the calling thread, which must be the thread
+// that runs the main loop. Refer to the Operation class to see why this is necessary.
 //------------------------------------------------------------------------------
 void
 NativeProcessLinux::LaunchInferior (
@@ -1163,9 +937,7 @@ NativeProcessLinux::LaunchInferior (
                        working_dir,
                        launch_info));
 
-    StartMonitorThread ([&] (Error &e) { return Launch(args.get(), e); }, error);
-    if (!error.Success ())
-        return;
+    Launch (args.get (), error);
 }
 
 void
@@ -1212,15 +984,14 @@ NativeProcessLinux::AttachToInferior (lldb::pid_t pid, Error &error)
     m_pid = pid;
     SetState(eStateAttaching);
 
-    StartMonitorThread ([=] (Error &e) { return Attach(pid, e); }, error);
-    if (!error.Success ())
-        return;
+    Attach (pid, error);
 }
 
 void
 NativeProcessLinux::Terminate ()
 {
-    m_monitor_up->Terminate();
+    // Stop handling the inferior's events.
+    m_sigchld_handle.reset ();
 }
 
 ::pid_t
@@ -1259,7 +1030,8 @@ NativeProcessLinux::Launch(LaunchArgs *args, Error &error)
         eDupStderrFailed,
         eChdirFailed,
         eExecFailed,
-        eSetGidFailed
+        eSetGidFailed,
+        eSetSigMaskFailed
     };
 
     // Child process.
@@ -1334,6 +1106,13 @@ NativeProcessLinux::Launch(LaunchArgs *args, Error &error)
             }
         }
 
+        // lldb-server blocks the signals it reads from its main loop, like
+        // SIGCHLD and SIGHUP. Don't let the inferior inherit that mask.
+        sigset_t set;
+        sigemptyset(&set);
+        if (sigprocmask(SIG_SETMASK, &set, NULL) != 0)
+            exit(eSetSigMaskFailed);
+
         // Execute.  We should never return...
         execve(argv[0],
                const_cast<char *const *>(argv),
@@ -1391,6 +1170,9 @@ NativeProcessLinux::Launch(LaunchArgs *args, Error &error)
             case eSetGidFailed:
                 error.SetErrorString("Child setgid failed.");
                 break;
+            case eSetSigMaskFailed:
+                error.SetErrorString("Child failed to set signal mask.");
+                break;
             default:
                 error.SetErrorString("Child returned unknown exit status.");
                 break;
@@ -1649,6 +1431,9 @@ NativeProcessLinux::MonitorCallback(lldb::pid_t pid,
         if (log)
             log->Printf ("NativeProcessLinux::%s() got exit signal(%d) , tid = %"  PRIu64 " (%s main thread)", __FUNCTION__, signal, pid, is_main_thread ? "is" : "is not");
 
+        FinishStepOverBreakpoint (pid, true);
+        FinishWatchedAccessStep (pid, nullptr, true);
+
         // This is a thread that exited.  Ensure we're not tracking it anymore.
         const bool thread_found = StopTrackingThread (pid);
 
@@ -1688,6 +1473,18 @@ NativeProcessLinux::MonitorCallback(lldb::pid_t pid,
     // Get details on the signal raised.
     siginfo_t info;
     const auto err = GetSignalInfo(pid, &info);
+
+    // Any stop ends a step over a breakpoint. An exec takes the scratch
+    // area with it, so that is handled with the rest of the exec.
+    if (!(err.Success() && info.si_signo == SIGTRAP && info.si_code == (SIGTRAP | (PTRACE_EVENT_EXEC << 8))))
+        FinishStepOverBreakpoint(pid, false);
+
+    if (err.Success() && FinishSkippingBreakpoint(pid, &info))
+        return;
+
+    if (err.Success() && info.si_code != (SIGTRAP | (PTRACE_EVENT_EXEC << 8)) && FinishWatchedAccessStep(pid, &info, false))
+        return;
+
     if (err.Success())
     {
         // We have retrieved the signal info.  Dispatch appropriately.
@@ -1758,6 +1555,13 @@ NativeProcessLinux::WaitForNewThread(::pid_t tid)
         return;
     }
 
+    if (m_undispatched_stop_tids.count(tid))
+    {
+        // SigchldHandler already reaped the event on the new thread and will dispatch it to
+        // MonitorSignal after this one, so there's nothing to wait for.
+        return;
+    }
+
     // The thread is not tracked yet, let's wait for it to appear.
     int status = -1;
     ::pid_t wait_pid;
@@ -1868,6 +1672,20 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
         // Exec clears any pending notifications.
         m_pending_notification_up.reset ();
 
+        // Steps over breakpoints went away with the old image.
+        m_displaced_steps.clear ();
+        m_displaced_step_slots_in_use.clear ();
+        m_displaced_step_scratch_addr = LLDB_INVALID_ADDRESS;
+        m_threads_stepping_over_breakpoint.clear ();
+        m_held_thread_resumes.clear ();
+        m_threads_skipping_breakpoint.clear ();
+        m_threads_stopping_for_client.clear ();
+
+        // So did the watched pages.
+        m_watched_access_steps.clear ();
+        NativeSoftwareWatchpointList::ProtectionChanges unused_changes;
+        m_software_watchpoint_list.Clear (unused_changes);
+
         // Remove all but the main thread here.  Linux fork creates a new process which only copies the main thread.  Mutexes are in undefined state.
         if (log)
             log->Printf ("NativeProcessLinux::%s exec received, stop tracking all but main thread", __FUNCTION__);
@@ -1890,10 +1708,12 @@ NativeProcessLinux::MonitorSIGTRAP(const siginfo_t *info, lldb::pid_t pid)
         }
 
         m_threads.clear ();
+        m_threads_by_id.clear ();
 
         if (main_thread_sp)
         {
             m_threads.push_back (main_thread_sp);
+            m_threads_by_id[main_thread_sp->GetID ()] = main_thread_sp;
             SetCurrentThreadID (main_thread_sp->GetID ());
             std::static_pointer_cast<NativeThreadLinux> (main_thread_sp)->SetStoppedByExec ();
         }
@@ -2036,6 +1856,7 @@ NativeProcessLinux::MonitorBreakpoint(lldb::pid_t pid, NativeThreadProtocolSP th
     // Mark the thread as stopped at breakpoint.
     if (thread_sp)
     {
+        const bool was_continuing = thread_sp->GetState() == eStateRunning;
         std::static_pointer_cast<NativeThreadLinux>(thread_sp)->SetStoppedByBreakpoint();
         Error error = FixupBreakpointPCAsNeeded(thread_sp);
         if (error.Fail())
@@ -2045,6 +1866,8 @@ NativeProcessLinux::MonitorBreakpoint(lldb::pid_t pid, NativeThreadProtocolSP th
 
         if (m_threads_stepping_with_breakpoint.find(pid) != m_threads_stepping_with_breakpoint.end())
             std::static_pointer_cast<NativeThreadLinux>(thread_sp)->SetStoppedByTrace();
+        else if (was_continuing && error.Success() && SkipBreakpointHit(thread_sp))
+            return;
     }
     else
         if (log)
@@ -2182,6 +2005,19 @@ NativeProcessLinux::MonitorSignal(const siginfo_t *info, lldb::pid_t pid, bool e
 
                 SetCurrentThreadID (thread_sp->GetID ());
                 ThreadDidStop (thread_sp->GetID (), true);
+
+                // In non-stop mode the only stops we request ourselves are
+                // the ones the client asked for. Any other SIGSTOP was sent
+                // for a request that the thread has since satisfied by
+                // stopping for some other reason, so it keeps running.
+                if (m_non_stop_mode && !m_pending_notification_up)
+                {
+                    auto &context = linux_thread_sp->GetThreadContext ();
+                    if (m_threads_stopping_for_client.count (pid) > 0)
+                        StopRunningThreads (pid);
+                    else if (context.request_resume_function)
+                        context.request_resume_function (pid, true);
+                }
             }
             else
             {
@@ -2210,6 +2046,12 @@ NativeProcessLinux::MonitorSignal(const siginfo_t *info, lldb::pid_t pid, bool e
         return;
     }
 
+    // Accesses to pages of software watchpoints are stepped over and only
+    // reported if they hit a watchpoint.
+    if (thread_sp && signo == SIGSEGV && info->si_code == SEGV_ACCERR &&
+        HandleWatchedPageFault (thread_sp, reinterpret_cast<lldb::addr_t> (info->si_addr)))
+        return;
+
     if (log)
         log->Printf ("NativeProcessLinux::%s() received signal %s", __FUNCTION__, GetUnixSignals ().GetSignalAsCString (signo));
 
@@ -2411,41 +2253,960 @@ NativeProcessLinux::SupportHardwareSingleStepping() const
     return true;
 }
 
-Error
-NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
+namespace
 {
-    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
-    if (log)
-        log->Printf ("NativeProcessLinux::%s called: pid %" PRIu64, __FUNCTION__, GetID ());
+    // The number of threads that can do a displaced step at the same time.
+    // Each one needs a DisplacedStep::kSlotSize slot at the entry point,
+    // which shouldn't run into other code that may still be in use.
+    const size_t k_num_displaced_step_slots = 2;
 
-    bool software_single_step = !SupportHardwareSingleStepping();
+    // The slot after them holds the instruction of injected system calls.
+    const size_t k_syscall_slot = k_num_displaced_step_slots;
 
-    Monitor::ScopedOperationLock monitor_lock(*m_monitor_up);
-    Mutex::Locker locker (m_threads_mutex);
+    // mprotect(2) for 64-bit and 32-bit x86 processes.
+    const uint64_t k_x86_64_mprotect = 10;
+    const uint64_t k_i386_mprotect = 125;
 
-    if (software_single_step)
+    // Watch flags of NativeWatchpoint.
+    const uint32_t k_watch_write = 0x1;
+    const uint32_t k_watch_read = 0x2;
+
+    // AT_ENTRY in the auxiliary vector.
+    const uint64_t k_auxv_entry = 9;
+    const uint64_t k_auxv_null = 0;
+
+    DisplacedStep::ReadRegisterCallback
+    MakeRegisterReader (NativeRegisterContext &reg_ctx)
     {
-        for (auto thread_sp : m_threads)
+        return [&reg_ctx] (const char *reg_name, uint64_t &value)
         {
-            assert (thread_sp && "thread list should not contain NULL threads");
+            const RegisterInfo *reg_info = reg_ctx.GetRegisterInfoByName (reg_name);
+            RegisterValue reg_value;
+            if (reg_info == nullptr || reg_ctx.ReadRegister (reg_info, reg_value).Fail ())
+                return false;
+            value = reg_value.GetAsUInt64 ();
+            return true;
+        };
+    }
+}
 
-            const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
-            if (action == nullptr)
-                continue;
+lldb::addr_t
+NativeProcessLinux::GetDisplacedStepScratchAddress ()
+{
+    if (m_displaced_step_scratch_addr != LLDB_INVALID_ADDRESS)
+        return m_displaced_step_scratch_addr;
 
-            if (action->state == eStateStepping)
-            {
-                Error error = SetupSoftwareSingleStepping(thread_sp);
-                if (error.Fail())
-                    return error;
-            }
-        }
-    }
+    DataBufferSP auxv_sp = ProcFileReader::ReadIntoDataBuffer (GetID (), "auxv");
+    if (!auxv_sp)
+        return LLDB_INVALID_ADDRESS;
 
-    for (auto thread_sp : m_threads)
+    DataExtractor auxv (auxv_sp, m_arch.GetByteOrder (), m_arch.GetAddressByteSize ());
+    lldb::offset_t offset = 0;
+    while (auxv.ValidOffsetForDataOfSize (offset, 2 * auxv.GetAddressByteSize ()))
     {
-        assert (thread_sp && "thread list should not contain NULL threads");
-
+        const uint64_t type = auxv.GetAddress (&offset);
+        const uint64_t value = auxv.GetAddress (&offset);
+        if (type == k_auxv_null)
+            break;
+        if (type == k_auxv_entry)
+        {
+            m_displaced_step_scratch_addr = value;
+            m_displaced_step_slots_in_use.assign (k_num_displaced_step_slots, false);
+            break;
+        }
+    }
+    return m_displaced_step_scratch_addr;
+}
+
+Error
+NativeProcessLinux::PrepareDisplacedStep (const NativeThreadProtocolSP &thread_sp, lldb::addr_t pc)
+{
+    if (!DisplacedStep::SupportsArchitecture (m_arch))
+        return Error ("displaced stepping is not supported for %s", m_arch.GetArchitectureName ());
+
+    const lldb::addr_t scratch_addr = GetDisplacedStepScratchAddress ();
+    if (scratch_addr == LLDB_INVALID_ADDRESS)
+        return Error ("failed to find the entry point for the scratch area");
+
+    auto free_slot_pos = std::find (m_displaced_step_slots_in_use.begin (), m_displaced_step_slots_in_use.end (), false);
+    if (free_slot_pos == m_displaced_step_slots_in_use.end ())
+        return Error ("all displaced stepping slots are in use");
+    const size_t slot = free_slot_pos - m_displaced_step_slots_in_use.begin ();
+    const lldb::addr_t slot_addr = scratch_addr + slot * DisplacedStep::kSlotSize;
+
+    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return Error ("no register context");
+
+    uint8_t insn_bytes[DisplacedStep::kMaxInstructionSize];
+    size_t bytes_read = 0;
+    Error error = ReadMemoryWithoutTrap (pc, insn_bytes, sizeof insn_bytes, bytes_read);
+    if (error.Fail ())
+        return error;
+
+    DisplacedStepInfo info;
+    info.slot = slot;
+    error = info.step.Prepare (m_arch, pc, insn_bytes, bytes_read, slot_addr, MakeRegisterReader (*reg_ctx_sp));
+    if (error.Fail ())
+        return error;
+
+    // Save what the slot holds, traps included, so that it can be put back
+    // exactly as it was.
+    const std::vector<uint8_t> &slot_bytes = info.step.GetSlotBytes ();
+    info.saved_bytes.resize (slot_bytes.size ());
+    error = ReadMemory (slot_addr, info.saved_bytes.data (), info.saved_bytes.size (), bytes_read);
+    if (error.Success () && bytes_read != info.saved_bytes.size ())
+        error.SetErrorString ("failed to read the scratch area");
+    if (error.Fail ())
+        return error;
+
+    size_t bytes_written = 0;
+    error = WriteMemory (slot_addr, slot_bytes.data (), slot_bytes.size (), bytes_written);
+    if (error.Success ())
+        error = reg_ctx_sp->SetPC (slot_addr);
+    if (error.Fail ())
+    {
+        WriteMemory (slot_addr, info.saved_bytes.data (), info.saved_bytes.size (), bytes_written);
+        return error;
+    }
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepping over breakpoint at 0x%" PRIx64 " from 0x%" PRIx64,
+                     __FUNCTION__, thread_sp->GetID (), pc, slot_addr);
+
+    m_displaced_step_slots_in_use[slot] = true;
+    m_displaced_steps[thread_sp->GetID ()] = std::move (info);
+    return Error ();
+}
+
+void
+NativeProcessLinux::PrepareStepOverBreakpoint (const NativeThreadProtocolSP &thread_sp, bool &hold_other_threads)
+{
+    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return;
+    const lldb::addr_t pc = reg_ctx_sp->GetPC ();
+
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint (pc, breakpoint_sp).Fail () ||
+        !breakpoint_sp->IsEnabled () || !breakpoint_sp->IsSoftwareBreakpoint ())
+        return;
+
+    Error error = PrepareDisplacedStep (thread_sp, pc);
+    if (error.Success ())
+        return;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepping over breakpoint at 0x%" PRIx64 " in place: %s",
+                     __FUNCTION__, thread_sp->GetID (), pc, error.AsCString ());
+
+    if (DisableBreakpoint (pc).Fail ())
+        return;
+    m_threads_stepping_over_breakpoint[thread_sp->GetID ()] = pc;
+    hold_other_threads = true;
+}
+
+void
+NativeProcessLinux::FinishStepOverBreakpoint (lldb::tid_t tid, bool exited)
+{
+    auto in_place_pos = m_threads_stepping_over_breakpoint.find (tid);
+    if (in_place_pos != m_threads_stepping_over_breakpoint.end ())
+    {
+        EnableBreakpoint (in_place_pos->second);
+        m_threads_stepping_over_breakpoint.erase (in_place_pos);
+
+        if (m_threads_stepping_over_breakpoint.empty ())
+        {
+            for (const auto &held_thread : m_held_thread_resumes)
+                ResumeThread (held_thread.first, held_thread.second, false);
+            m_held_thread_resumes.clear ();
+        }
+    }
+
+    auto pos = m_displaced_steps.find (tid);
+    if (pos == m_displaced_steps.end ())
+        return;
+    const DisplacedStepInfo info = std::move (pos->second);
+    m_displaced_steps.erase (pos);
+    m_displaced_step_slots_in_use[info.slot] = false;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    NativeThreadProtocolSP thread_sp = GetThreadByID (tid);
+    NativeRegisterContextSP reg_ctx_sp = thread_sp ? thread_sp->GetRegisterContext () : NativeRegisterContextSP ();
+    if (!exited && reg_ctx_sp)
+    {
+        const lldb::addr_t stop_pc = reg_ctx_sp->GetPC ();
+        DisplacedStep::Fixup fixup;
+        info.step.Finish (stop_pc, MakeRegisterReader (*reg_ctx_sp), fixup);
+
+        for (const auto &reg : fixup.registers)
+        {
+            const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoByName (reg.first.c_str ());
+            Error error;
+            if (reg_info == nullptr)
+                error.SetErrorStringWithFormat ("unknown register %s", reg.first.c_str ());
+            else
+                error = reg_ctx_sp->WriteRegisterFromUnsigned (reg_info, reg.second);
+            if (error.Fail () && log)
+                log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to write %s: %s",
+                             __FUNCTION__, tid, reg.first.c_str (), error.AsCString ());
+        }
+
+        if (fixup.memory_addr != LLDB_INVALID_ADDRESS)
+        {
+            // Targets that support displaced stepping have the same byte
+            // order as lldb-server.
+            size_t bytes_written = 0;
+            Error error = WriteMemory (fixup.memory_addr, &fixup.memory_value, m_arch.GetAddressByteSize (), bytes_written);
+            if (error.Fail () && log)
+                log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to write to 0x%" PRIx64 ": %s",
+                             __FUNCTION__, tid, fixup.memory_addr, error.AsCString ());
+        }
+
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepped over breakpoint at 0x%" PRIx64 ", stopped at 0x%" PRIx64 " in the slot, now at 0x%" PRIx64,
+                         __FUNCTION__, tid, info.step.GetInstructionAddress (), stop_pc, reg_ctx_sp->GetPC ());
+    }
+
+    size_t bytes_written = 0;
+    WriteMemory (info.step.GetScratchAddress (), info.saved_bytes.data (), info.saved_bytes.size (), bytes_written);
+}
+
+void
+NativeProcessLinux::GetAgentExpressionCallbacks (const NativeRegisterContextSP &reg_ctx_sp,
+                                                 AgentExpression::ReadRegisterCallback &read_register,
+                                                 AgentExpression::ReadMemoryCallback &read_memory)
+{
+    // Registers are numbered the way qRegisterInfo numbers them.
+    read_register = [reg_ctx_sp] (uint32_t reg_num, uint64_t &value)
+    {
+        const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (reg_num);
+        RegisterValue reg_value;
+        if (reg_info == nullptr || reg_info->byte_size > 8 || reg_ctx_sp->ReadRegister (reg_info, reg_value).Fail ())
+            return false;
+        bool success = false;
+        value = reg_value.GetAsUInt64 (0, &success);
+        return success;
+    };
+    read_memory = [this] (lldb::addr_t addr, void *buf, size_t size)
+    {
+        size_t bytes_read = 0;
+        return ReadMemoryWithoutTrap (addr, buf, size, bytes_read).Success () && bytes_read == size;
+    };
+}
+
+Error
+NativeProcessLinux::EvaluateBreakpointConditions (const NativeThreadProtocolSP &thread_sp, const NativeBreakpoint &breakpoint, bool &conditions_are_false)
+{
+    conditions_are_false = false;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return Error ("thread %" PRIu64 " has no register context", thread_sp->GetID ());
+
+    AgentExpression::ReadRegisterCallback read_register;
+    AgentExpression::ReadMemoryCallback read_memory;
+    GetAgentExpressionCallbacks (reg_ctx_sp, read_register, read_memory);
+
+    for (const std::vector<uint8_t> &condition : breakpoint.GetConditions ())
+    {
+        AgentExpression expr (condition.data (), condition.size ());
+        uint64_t result = 0;
+        Error error = expr.Evaluate (read_register, read_memory, m_arch.GetByteOrder (), result);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to evaluate condition of breakpoint at 0x%" PRIx64 ": %s",
+                             __FUNCTION__, thread_sp->GetID (), breakpoint.GetAddress (), error.AsCString ());
+            return error;
+        }
+        if (result != 0)
+            return Error ();
+    }
+    conditions_are_false = true;
+    return Error ();
+}
+
+void
+NativeProcessLinux::CollectTracepointData (const NativeThreadProtocolSP &thread_sp, const NativeBreakpoint &breakpoint)
+{
+    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return;
+
+    AgentExpression::ReadRegisterCallback read_register;
+    AgentExpression::ReadMemoryCallback read_memory;
+    GetAgentExpressionCallbacks (reg_ctx_sp, read_register, read_memory);
+
+    const std::vector<NativeTracepointItem> &items = breakpoint.GetTracepointItems ();
+    NativeTracepointBuffer::Record record;
+    record.tid = thread_sp->GetID ();
+    record.addr = breakpoint.GetAddress ();
+    record.values.resize (items.size ());
+    record.available.resize (items.size (), false);
+    for (size_t i = 0; i < items.size (); ++i)
+    {
+        const NativeTracepointItem &item = items[i];
+        std::vector<uint8_t> &value = record.values[i];
+        if (item.IsRegister ())
+        {
+            // Registers are stored the way memory would hold them.
+            const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (item.reg_num);
+            RegisterValue reg_value;
+            if (reg_info == nullptr || reg_ctx_sp->ReadRegister (reg_info, reg_value).Fail ())
+                continue;
+            value.resize (reg_info->byte_size);
+            Error error;
+            if (reg_value.GetAsMemoryData (reg_info, value.data (), value.size (), m_arch.GetByteOrder (), error) != value.size ())
+            {
+                value.clear ();
+                continue;
+            }
+        }
+        else
+        {
+            AgentExpression expr (item.address_expr.data (), item.address_expr.size ());
+            uint64_t addr = 0;
+            if (expr.Evaluate (read_register, read_memory, m_arch.GetByteOrder (), addr).Fail ())
+                continue;
+            value.resize (item.byte_size);
+            if (!read_memory (addr, value.data (), value.size ()))
+            {
+                value.clear ();
+                continue;
+            }
+        }
+        record.available[i] = true;
+    }
+    m_tracepoint_buffer.Add (std::move (record));
+}
+
+bool
+NativeProcessLinux::SkipBreakpointHit (const NativeThreadProtocolSP &thread_sp)
+{
+    NativeRegisterContextSP reg_ctx_sp = thread_sp->GetRegisterContext ();
+    if (!reg_ctx_sp)
+        return false;
+    const lldb::addr_t pc = reg_ctx_sp->GetPC ();
+
+    NativeBreakpointSP breakpoint_sp;
+    if (m_breakpoint_list.GetBreakpoint (pc, breakpoint_sp).Fail () || !breakpoint_sp->IsSoftwareBreakpoint ())
+        return false;
+
+    // Tracepoints record the hits that pass the conditions, even the ones
+    // that end up being reported.
+    const bool has_conditions = !breakpoint_sp->GetConditions ().empty ();
+    if (!has_conditions && !breakpoint_sp->IsTracepoint ())
+        return false;
+    bool conditions_are_false = false;
+    if (has_conditions)
+    {
+        // A condition that can't be evaluated here is left to the client,
+        // the hit is reported and nothing is collected.
+        if (EvaluateBreakpointConditions (thread_sp, *breakpoint_sp, conditions_are_false).Fail ())
+            return false;
+    }
+    if (!conditions_are_false)
+    {
+        if (!breakpoint_sp->IsTracepoint ())
+            return false;
+        CollectTracepointData (thread_sp, *breakpoint_sp);
+    }
+
+    // While all threads are being stopped for another event this thread
+    // has to stop as well. Reporting the hit lets the client evaluate the
+    // conditions.
+    if (m_pending_notification_up || !SupportHardwareSingleStepping ())
+        return false;
+
+    // Step over the breakpoint the same way as for a resume, but only if
+    // that doesn't need the other threads, which are still running.
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+    Error error = PrepareDisplacedStep (thread_sp, pc);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " can't step over breakpoint at 0x%" PRIx64 ", reporting it: %s",
+                         __FUNCTION__, thread_sp->GetID (), pc, error.AsCString ());
+        return false;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " not reporting hit of breakpoint at 0x%" PRIx64 ", continuing",
+                     __FUNCTION__, thread_sp->GetID (), pc);
+
+    auto linux_thread_sp = std::static_pointer_cast<NativeThreadLinux> (thread_sp);
+    m_threads_skipping_breakpoint[thread_sp->GetID ()] = linux_thread_sp->GetThreadContext ().request_resume_function;
+    ResumeThread (thread_sp->GetID (),
+                  [=](lldb::tid_t tid_to_step, bool supress_signal)
+                  {
+                      linux_thread_sp->SetStepping ();
+                      return SingleStep (tid_to_step, LLDB_INVALID_SIGNAL_NUMBER);
+                  },
+                  false);
+    return true;
+}
+
+bool
+NativeProcessLinux::FinishSkippingBreakpoint (lldb::tid_t tid, const siginfo_t *info)
+{
+    auto pos = m_threads_skipping_breakpoint.find (tid);
+    if (pos == m_threads_skipping_breakpoint.end ())
+        return false;
+    const NativeThreadLinux::ResumeThreadFunction resume_function = pos->second;
+    m_threads_skipping_breakpoint.erase (pos);
+
+    // Anything but the end of the step is reported as usual, the thread
+    // is back at the breakpoint if the step didn't happen.
+    if (info->si_signo != SIGTRAP || (info->si_code != TRAP_TRACE && info->si_code != 0))
+        return false;
+
+    auto thread_sp = std::static_pointer_cast<NativeThreadLinux> (GetThreadByID (tid));
+    if (!thread_sp)
+        return false;
+
+    // Nothing to report, but an all-stop for another thread may have
+    // started while this one was stepping.
+    thread_sp->SetStoppedBySignal (0);
+    ThreadDidStop (tid, false);
+    if (m_pending_notification_up || !resume_function)
+        return true;
+
+    // Continue the way the thread was continuing before the hit, any
+    // signal it was resumed with has already been delivered.
+    Error error = resume_function (tid, true);
+    if (error.Success ())
+        thread_sp->GetThreadContext ().request_resume_function = resume_function;
+    else
+    {
+        Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to continue: %s",
+                         __FUNCTION__, tid, error.AsCString ());
+    }
+    return true;
+}
+
+Error
+NativeProcessLinux::InjectSyscall (lldb::tid_t tid, uint64_t number, const std::vector<uint64_t> &args, int64_t &result)
+{
+#if defined(__x86_64__)
+    const bool is_i386 = m_arch.GetMachine () == llvm::Triple::x86;
+    if (!is_i386 && m_arch.GetMachine () != llvm::Triple::x86_64)
+        return Error ("injecting system calls is not supported for %s", m_arch.GetArchitectureName ());
+    if (args.size () > 3)
+        return Error ("too many system call arguments");
+
+    const lldb::addr_t scratch_addr = GetDisplacedStepScratchAddress ();
+    if (scratch_addr == LLDB_INVALID_ADDRESS)
+        return Error ("failed to find the entry point for the scratch area");
+    const lldb::addr_t insn_addr = scratch_addr + k_syscall_slot * DisplacedStep::kSlotSize;
+
+    // "syscall" for 64-bit processes and "int $0x80" for 32-bit ones.
+    static const uint8_t k_syscall_opcode[] = { 0x0f, 0x05 };
+    static const uint8_t k_int80_opcode[] = { 0xcd, 0x80 };
+    const uint8_t *opcode = is_i386 ? k_int80_opcode : k_syscall_opcode;
+    const size_t opcode_size = sizeof k_syscall_opcode;
+
+    Error error;
+    struct user_regs_struct saved_regs;
+    PtraceWrapper (PTRACE_GETREGS, tid, nullptr, &saved_regs, sizeof saved_regs, error);
+    if (error.Fail ())
+        return error;
+
+    // Memory goes through the thread itself, the others may be running.
+    uint8_t saved_bytes[sizeof k_syscall_opcode];
+    if (DoReadMemory (tid, insn_addr, saved_bytes, opcode_size, error) != opcode_size)
+        return error.Fail () ? error : Error ("failed to read the scratch area");
+    if (DoWriteMemory (tid, insn_addr, opcode, opcode_size, error) != opcode_size)
+        return error.Fail () ? error : Error ("failed to write the scratch area");
+
+    struct user_regs_struct regs = saved_regs;
+    regs.rip = insn_addr;
+    regs.rax = number;
+    // Keep the kernel from restarting a system call the thread was stopped
+    // in with these registers.
+    regs.orig_rax = -1;
+    if (is_i386)
+    {
+        regs.rbx = args.size () > 0 ? args[0] : 0;
+        regs.rcx = args.size () > 1 ? args[1] : 0;
+        regs.rdx = args.size () > 2 ? args[2] : 0;
+    }
+    else
+    {
+        regs.rdi = args.size () > 0 ? args[0] : 0;
+        regs.rsi = args.size () > 1 ? args[1] : 0;
+        regs.rdx = args.size () > 2 ? args[2] : 0;
+    }
+    PtraceWrapper (PTRACE_SETREGS, tid, nullptr, &regs, sizeof regs, error);
+
+    // Signals that arrive before the instruction runs are sent again once
+    // the thread is back the way it was.
+    std::vector<int> pending_signals;
+    bool thread_exited = false;
+    while (error.Success ())
+    {
+        PtraceWrapper (PTRACE_SINGLESTEP, tid, nullptr, nullptr, 0, error);
+        if (error.Fail ())
+            break;
+
+        int status = 0;
+        ::pid_t wait_pid;
+        do
+            wait_pid = waitpid (tid, &status, __WALL);
+        while (wait_pid == -1 && errno == EINTR);
+        if (wait_pid == -1)
+        {
+            error.SetErrorToErrno ();
+            break;
+        }
+        if (!WIFSTOPPED (status))
+        {
+            m_deferred_wait_events.push_back (std::make_pair (wait_pid, status));
+            thread_exited = true;
+            error.SetErrorStringWithFormat ("thread %" PRIu64 " exited during an injected system call", tid);
+            break;
+        }
+        if (WSTOPSIG (status) == SIGTRAP)
+        {
+            PtraceWrapper (PTRACE_GETREGS, tid, nullptr, &regs, sizeof regs, error);
+            if (error.Success ())
+                result = is_i386 ? static_cast<int32_t> (regs.rax) : static_cast<int64_t> (regs.rax);
+            break;
+        }
+        pending_signals.push_back (WSTOPSIG (status));
+    }
+    if (thread_exited)
+        return error;
+
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    Error restore_error;
+    PtraceWrapper (PTRACE_SETREGS, tid, nullptr, &saved_regs, sizeof saved_regs, restore_error);
+    if (restore_error.Success ())
+        DoWriteMemory (tid, insn_addr, saved_bytes, opcode_size, restore_error);
+    if (restore_error.Fail () && log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to restore the thread: %s",
+                     __FUNCTION__, tid, restore_error.AsCString ());
+
+    for (int signo : pending_signals)
+        syscall (__NR_tgkill, static_cast< ::pid_t> (GetID ()), static_cast< ::pid_t> (tid), signo);
+
+    return error.Fail () ? error : restore_error;
+#else
+    return Error ("injecting system calls is not supported on this host");
+#endif
+}
+
+Error
+NativeProcessLinux::ProtectPages (lldb::tid_t tid, const NativeSoftwareWatchpointList::ProtectionChanges &changes)
+{
+    if (changes.empty ())
+        return Error ();
+
+    uint64_t mprotect_number;
+    switch (m_arch.GetMachine ())
+    {
+        case llvm::Triple::x86_64:
+            mprotect_number = k_x86_64_mprotect;
+            break;
+        case llvm::Triple::x86:
+            mprotect_number = k_i386_mprotect;
+            break;
+        default:
+            return Error ("protecting memory is not supported for %s", m_arch.GetArchitectureName ());
+    }
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    for (const auto &change : changes)
+    {
+        uint64_t prot = PROT_NONE;
+        if (change.permissions & lldb::ePermissionsReadable)
+            prot |= PROT_READ;
+        if (change.permissions & lldb::ePermissionsWritable)
+            prot |= PROT_WRITE;
+        if (change.permissions & lldb::ePermissionsExecutable)
+            prot |= PROT_EXEC;
+
+        int64_t result = 0;
+        Error error = InjectSyscall (tid, mprotect_number, { change.addr, change.size, prot }, result);
+        if (error.Success () && result < 0)
+            error.SetErrorStringWithFormat ("mprotect failed: %s", strerror (-result));
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " mprotect (0x%" PRIx64 ", 0x%zx, 0x%" PRIx64 "): %s",
+                         __FUNCTION__, tid, change.addr, change.size, prot, error.Success () ? "ok" : error.AsCString ());
+        if (error.Fail ())
+            return error;
+    }
+
+    // The permissions in /proc/<pid>/maps changed.
+    Mutex::Locker locker (m_mem_region_cache_mutex);
+    m_mem_region_cache_stale = true;
+    return Error ();
+}
+
+Error
+NativeProcessLinux::GetProtectionThreadID (lldb::tid_t &tid)
+{
+    tid = GetMemoryAccessThreadID ();
+    NativeThreadProtocolSP thread_sp = GetThreadByID (tid);
+    if (!thread_sp || !StateIsStoppedState (thread_sp->GetState (), true))
+        return Error ("software watchpoints can only be changed while a thread is stopped");
+    return Error ();
+}
+
+Error
+NativeProcessLinux::SetSoftwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags)
+{
+    lldb::tid_t tid;
+    Error error = GetProtectionThreadID (tid);
+    if (error.Fail ())
+        return error;
+
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    error = m_software_watchpoint_list.Add (addr, size, watch_flags,
+        [this] (lldb::addr_t page_addr, uint32_t &permissions)
+        {
+            MemoryRegionInfo region_info;
+            if (GetMemoryRegionInfo (page_addr, region_info).Fail ())
+                return false;
+            permissions = GetRegionPermissions (region_info);
+            // Nothing can be watched where nothing is mapped.
+            return permissions != 0;
+        },
+        changes);
+    if (error.Fail ())
+        return error;
+
+    error = ProtectPages (tid, changes);
+    if (error.Fail ())
+    {
+        NativeSoftwareWatchpointList::ProtectionChanges undo_changes;
+        m_software_watchpoint_list.Remove (addr, undo_changes);
+        ProtectPages (tid, undo_changes);
+    }
+    return error;
+}
+
+Error
+NativeProcessLinux::RemoveSoftwareWatchpoint (lldb::addr_t addr)
+{
+    lldb::tid_t tid;
+    Error error = GetProtectionThreadID (tid);
+    if (error.Fail ())
+        return error;
+
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    error = m_software_watchpoint_list.Remove (addr, changes);
+    if (error.Success ())
+        error = ProtectPages (tid, changes);
+    return error;
+}
+
+Error
+NativeProcessLinux::UnprotectWatchedPage (lldb::tid_t tid, lldb::addr_t fault_addr, WatchedAccessStep &step)
+{
+    const size_t page_size = m_software_watchpoint_list.GetPageSize ();
+    const lldb::addr_t page_addr = m_software_watchpoint_list.GetPageAddress (fault_addr);
+
+    // A write can only change what is on the unprotected page, the other
+    // watched pages still fault.
+    std::vector<NativeSoftwareWatchpointList::Watchpoint *> watchpoints;
+    m_software_watchpoint_list.FindWatchpoints (page_addr, page_size, watchpoints);
+    std::vector<WatchedAccessStep::Snapshot> snapshots;
+    for (const auto *watchpoint : watchpoints)
+    {
+        if ((watchpoint->watch_flags & k_watch_write) == 0)
+            continue;
+        WatchedAccessStep::Snapshot snapshot;
+        snapshot.wp_addr = watchpoint->addr;
+        snapshot.addr = std::max (watchpoint->addr, page_addr);
+        const lldb::addr_t end_addr = std::min (watchpoint->addr + watchpoint->size, page_addr + page_size);
+        snapshot.bytes.resize (end_addr - snapshot.addr);
+        Error error;
+        if (DoReadMemory (tid, snapshot.addr, snapshot.bytes.data (), snapshot.bytes.size (), error) != snapshot.bytes.size ())
+            return error.Fail () ? error : Error ("failed to read watched memory at 0x%" PRIx64, snapshot.addr);
+        snapshots.push_back (std::move (snapshot));
+    }
+
+    NativeSoftwareWatchpointList::ProtectionChange change;
+    if (m_software_watchpoint_list.BeginAccess (page_addr, change))
+    {
+        Error error = ProtectPages (tid, { change });
+        if (error.Fail ())
+        {
+            m_software_watchpoint_list.EndAccess (page_addr, change);
+            return error;
+        }
+    }
+
+    step.pages.push_back (page_addr);
+    step.fault_addrs.push_back (fault_addr);
+    for (auto &snapshot : snapshots)
+        step.snapshots.push_back (std::move (snapshot));
+    return Error ();
+}
+
+bool
+NativeProcessLinux::HandleWatchedPageFault (const NativeThreadProtocolSP &thread_sp, lldb::addr_t fault_addr)
+{
+    const lldb::addr_t page_addr = m_software_watchpoint_list.GetPageAddress (fault_addr);
+    if (!m_software_watchpoint_list.IsWatchedPage (page_addr))
+        return false;
+    m_software_watchpoint_list.RecordFault (page_addr);
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    const lldb::tid_t tid = thread_sp->GetID ();
+    auto linux_thread_sp = std::static_pointer_cast<NativeThreadLinux> (thread_sp);
+
+    // While all threads are being stopped for another event this thread
+    // has to stop as well. The access hasn't happened, the thread faults
+    // again when it is resumed.
+    if (m_pending_notification_up)
+    {
+        linux_thread_sp->SetStoppedBySignal (0);
+        ThreadDidStop (tid, false);
+        return true;
+    }
+
+    WatchedAccessStep step;
+    step.resume_function = linux_thread_sp->GetThreadContext ().request_resume_function;
+    step.was_stepping = linux_thread_sp->GetState () == eStateStepping;
+    Error error = UnprotectWatchedPage (tid, fault_addr, step);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " can't step over access to watched page at 0x%" PRIx64 ", reporting it: %s",
+                         __FUNCTION__, tid, page_addr, error.AsCString ());
+        return false;
+    }
+
+    if (log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " stepping over access to 0x%" PRIx64 " in watched page",
+                     __FUNCTION__, tid, fault_addr);
+
+    m_watched_access_steps[tid] = std::move (step);
+    linux_thread_sp->SetStoppedBySignal (0);
+    ResumeThread (tid,
+                  [=](lldb::tid_t tid_to_step, bool supress_signal)
+                  {
+                      linux_thread_sp->SetStepping ();
+                      return SingleStep (tid_to_step, LLDB_INVALID_SIGNAL_NUMBER);
+                  },
+                  false);
+    return true;
+}
+
+bool
+NativeProcessLinux::FinishWatchedAccessStep (lldb::tid_t tid, const siginfo_t *info, bool exited)
+{
+    auto pos = m_watched_access_steps.find (tid);
+    if (pos == m_watched_access_steps.end ())
+        return false;
+
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+    auto thread_sp = std::static_pointer_cast<NativeThreadLinux> (GetThreadByID (tid));
+
+    // An access that spans into another watched page faults there, both
+    // pages stay unprotected for another try.
+    const bool is_page_fault = !exited && info->si_signo == SIGSEGV && info->si_code == SEGV_ACCERR;
+    const lldb::addr_t fault_addr = is_page_fault ? reinterpret_cast<lldb::addr_t> (info->si_addr) : LLDB_INVALID_ADDRESS;
+    const lldb::addr_t fault_page = m_software_watchpoint_list.GetPageAddress (fault_addr);
+    const bool fault_in_step_pages =
+        is_page_fault && std::find (pos->second.pages.begin (), pos->second.pages.end (), fault_page) != pos->second.pages.end ();
+    if (thread_sp && is_page_fault && !fault_in_step_pages && !m_pending_notification_up &&
+        m_software_watchpoint_list.IsWatchedPage (fault_page))
+    {
+        m_software_watchpoint_list.RecordFault (fault_page);
+        if (UnprotectWatchedPage (tid, fault_addr, pos->second).Success ())
+        {
+            thread_sp->SetStoppedBySignal (0);
+            ResumeThread (tid,
+                          [=](lldb::tid_t tid_to_step, bool supress_signal)
+                          {
+                              thread_sp->SetStepping ();
+                              return SingleStep (tid_to_step, LLDB_INVALID_SIGNAL_NUMBER);
+                          },
+                          false);
+            return true;
+        }
+    }
+
+    const WatchedAccessStep step = std::move (pos->second);
+    m_watched_access_steps.erase (pos);
+
+    // Find the hits before the pages are protected again. Reads of a page
+    // fault as well if it is watched for reads, so a fault only tells a
+    // write watchpoint that it was hit if the page only watches writes.
+    std::vector<NativeSoftwareWatchpointList::Watchpoint *> hits;
+    const bool step_done = !exited && info->si_signo == SIGTRAP && (info->si_code == TRAP_TRACE || info->si_code == 0);
+    if (step_done)
+    {
+        for (const lldb::addr_t addr : step.fault_addrs)
+        {
+            const uint32_t page_watch_flags =
+                m_software_watchpoint_list.GetPageWatchFlags (m_software_watchpoint_list.GetPageAddress (addr));
+            std::vector<NativeSoftwareWatchpointList::Watchpoint *> watchpoints;
+            m_software_watchpoint_list.FindWatchpoints (addr, 1, watchpoints);
+            for (auto *watchpoint : watchpoints)
+            {
+                if ((watchpoint->watch_flags & k_watch_read) || (page_watch_flags & k_watch_read) == 0)
+                    hits.push_back (watchpoint);
+            }
+        }
+        for (const auto &snapshot : step.snapshots)
+        {
+            std::vector<uint8_t> bytes (snapshot.bytes.size ());
+            Error error;
+            if (DoReadMemory (tid, snapshot.addr, bytes.data (), bytes.size (), error) == bytes.size () &&
+                bytes == snapshot.bytes)
+                continue;
+            std::vector<NativeSoftwareWatchpointList::Watchpoint *> watchpoints;
+            m_software_watchpoint_list.FindWatchpoints (snapshot.wp_addr, 1, watchpoints);
+            for (auto *watchpoint : watchpoints)
+            {
+                if (watchpoint->addr == snapshot.wp_addr)
+                    hits.push_back (watchpoint);
+            }
+        }
+        std::sort (hits.begin (), hits.end ());
+        hits.erase (std::unique (hits.begin (), hits.end ()), hits.end ());
+        for (auto *watchpoint : hits)
+            ++watchpoint->num_hits;
+    }
+
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    for (const lldb::addr_t page_addr : step.pages)
+    {
+        NativeSoftwareWatchpointList::ProtectionChange change;
+        if (m_software_watchpoint_list.EndAccess (page_addr, change))
+            changes.push_back (change);
+    }
+    lldb::tid_t protect_tid = tid;
+    Error error;
+    if (exited)
+        error = GetProtectionThreadID (protect_tid);
+    if (error.Success ())
+        error = ProtectPages (protect_tid, changes);
+    if (error.Fail () && log)
+        log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to protect watched pages again: %s",
+                     __FUNCTION__, tid, error.AsCString ());
+
+    if (exited || !thread_sp)
+        return false;
+
+    if (!step_done)
+    {
+        // A fault on the page while it was unprotected is a real one.
+        if (fault_in_step_pages)
+        {
+            ThreadDidStop (tid, false);
+            thread_sp->SetStoppedBySignal (SIGSEGV, info);
+            StopRunningThreads (tid);
+            return true;
+        }
+
+        // Anything else is reported as usual, the thread is back at the
+        // access if the step didn't happen.
+        thread_sp->GetThreadContext ().request_resume_function = step.resume_function;
+        return false;
+    }
+
+    if (!hits.empty ())
+    {
+        const NativeSoftwareWatchpointList::Watchpoint *hit = *std::min_element (hits.begin (), hits.end (),
+            [] (const NativeSoftwareWatchpointList::Watchpoint *lhs, const NativeSoftwareWatchpointList::Watchpoint *rhs)
+            {
+                return lhs->addr < rhs->addr;
+            });
+        if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " hit software watchpoint at 0x%" PRIx64,
+                         __FUNCTION__, tid, hit->addr);
+        thread_sp->SetStoppedBySoftwareWatchpoint (hit->addr);
+    }
+    else if (step.was_stepping)
+        thread_sp->SetStoppedByTrace ();
+    else
+    {
+        // Nothing to report, continue the way the thread was continuing
+        // before the access, as for a skipped breakpoint hit.
+        thread_sp->SetStoppedBySignal (0);
+        ThreadDidStop (tid, false);
+        if (m_pending_notification_up || !step.resume_function)
+            return true;
+        error = step.resume_function (tid, true);
+        if (error.Success ())
+            thread_sp->GetThreadContext ().request_resume_function = step.resume_function;
+        else if (log)
+            log->Printf ("NativeProcessLinux::%s tid %" PRIu64 " failed to continue: %s",
+                         __FUNCTION__, tid, error.AsCString ());
+        return true;
+    }
+
+    ThreadDidStop (tid, false);
+    if (!m_pending_notification_up)
+    {
+        SetCurrentThreadID (tid);
+        StopRunningThreads (tid);
+    }
+    return true;
+}
+
+Error
+NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
+{
+    Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+    if (log)
+        log->Printf ("NativeProcessLinux::%s called: pid %" PRIu64, __FUNCTION__, GetID ());
+
+    bool software_single_step = !SupportHardwareSingleStepping();
+
+    Mutex::Locker locker (m_threads_mutex);
+
+    if (software_single_step)
+    {
+        for (auto thread_sp : m_threads)
+        {
+            assert (thread_sp && "thread list should not contain NULL threads");
+
+            const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
+            if (action == nullptr)
+                continue;
+
+            if (action->state == eStateStepping)
+            {
+                Error error = SetupSoftwareSingleStepping(thread_sp);
+                if (error.Fail())
+                    return error;
+            }
+        }
+    }
+
+    // A thread that steps over a software breakpoint steps a displaced copy
+    // of the instruction if it can, so that the breakpoint stays inserted
+    // for the other threads. If it can't, the breakpoint is disabled for the
+    // step and the other threads wait for it.
+    bool hold_other_threads = false;
+    for (auto thread_sp : m_threads)
+    {
+        const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
+        if (action == nullptr || action->state != eStateStepping)
+            continue;
+
+        // A signal handler would run with the PC in the slot.
+        if (action->signal > 0 && action->signal != LLDB_INVALID_SIGNAL_NUMBER)
+            continue;
+
+        PrepareStepOverBreakpoint (thread_sp, hold_other_threads);
+    }
+
+    for (auto thread_sp : m_threads)
+    {
+        assert (thread_sp && "thread list should not contain NULL threads");
+
         const ResumeAction *const action = resume_actions.GetActionForThread (thread_sp->GetID (), true);
 
         if (action == nullptr)
@@ -2468,7 +3229,7 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
         {
             // Run the thread, possibly feeding it the signal.
             const int signo = action->signal;
-            ResumeThread(thread_sp->GetID (),
+            NativeThreadLinux::ResumeThreadFunction resume_function =
                     [=](lldb::tid_t tid_to_resume, bool supress_signal)
                     {
                         std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetRunning ();
@@ -2477,8 +3238,22 @@ NativeProcessLinux::Resume (const ResumeActionList &resume_actions)
                         if (resume_result.Success())
                             SetState(eStateRunning, true);
                         return resume_result;
-                    },
-                    false);
+                    };
+
+            // A thread that is already running in non-stop mode can't be
+            // held, it is past the point where it could be stopped here.
+            if (hold_other_threads && StateIsStoppedState (thread_sp->GetState (), true))
+            {
+                // In all-stop mode the held threads are reported along with
+                // the stepping thread. In non-stop mode they aren't reported
+                // at all, they start running once the step is done.
+                std::static_pointer_cast<NativeThreadLinux> (thread_sp)->SetStoppedBySignal (0);
+                if (m_non_stop_mode)
+                    m_held_thread_resumes[thread_sp->GetID ()] = resume_function;
+                break;
+            }
+
+            ResumeThread(thread_sp->GetID (), resume_function, false);
             break;
         }
 
@@ -2530,17 +3305,90 @@ NativeProcessLinux::Halt ()
     return error;
 }
 
+Error
+NativeProcessLinux::SetNonStopMode (bool enable)
+{
+    Mutex::Locker locker (m_threads_mutex);
+
+    // A stop that is being coordinated in one mode can't be finished in the
+    // other one.
+    if (m_pending_notification_up)
+        return Error ("can't change the stop mode while threads are stopping");
+
+    m_non_stop_mode = enable;
+    return Error ();
+}
+
+Error
+NativeProcessLinux::StopThread (lldb::tid_t tid)
+{
+    if (!m_non_stop_mode)
+        return Error ("threads can only be stopped individually in non-stop mode");
+
+    Mutex::Locker locker (m_threads_mutex);
+
+    auto thread_sp = std::static_pointer_cast<NativeThreadLinux> (GetThreadByID (tid));
+    if (!thread_sp)
+        return Error ("no thread with tid %" PRIu64, tid);
+
+    if (StateIsStoppedState (thread_sp->GetState (), true))
+        return Error ();
+
+    m_threads_stopping_for_client.insert (tid);
+
+    // A SIGSTOP that is already on its way will do.
+    if (thread_sp->GetThreadContext ().stop_requested)
+        return Error ();
+    return thread_sp->RequestStop ();
+}
+
+lldb::tid_t
+NativeProcessLinux::GetMemoryAccessThreadID ()
+{
+    Mutex::Locker locker (m_threads_mutex);
+    NativeThreadProtocolSP main_thread_sp = GetThreadByIDUnlocked (GetID ());
+    if (main_thread_sp && StateIsStoppedState (main_thread_sp->GetState (), true))
+        return GetID ();
+
+    for (const auto &thread_sp : m_threads)
+    {
+        if (StateIsStoppedState (thread_sp->GetState (), true))
+            return thread_sp->GetID ();
+    }
+
+    // Nothing is stopped, ptrace will fail whichever thread we pick.
+    return GetID ();
+}
+
 Error
 NativeProcessLinux::Detach ()
 {
     Error error;
 
+    // Give the pages of software watchpoints their permissions back.
+    if (!m_software_watchpoint_list.IsEmpty ())
+    {
+        NativeSoftwareWatchpointList::ProtectionChanges changes;
+        m_software_watchpoint_list.Clear (changes);
+        lldb::tid_t tid;
+        error = GetProtectionThreadID (tid);
+        if (error.Success ())
+            error = ProtectPages (tid, changes);
+        if (error.Fail ())
+        {
+            Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_WATCHPOINTS));
+            if (log)
+                log->Printf ("NativeProcessLinux::%s failed to unprotect watched pages: %s", __FUNCTION__, error.AsCString ());
+            error.Clear ();
+        }
+    }
+
     // Tell ptrace to detach from the process.
     if (GetID () != LLDB_INVALID_PROCESS_ID)
         error = Detach (GetID ());
 
     // Stop monitoring the inferior.
-    m_monitor_up->Terminate();
+    m_sigchld_handle.reset ();
 
     // No error.
     return error;
@@ -2575,7 +3423,6 @@ NativeProcessLinux::Interrupt ()
     if (log)
         log->Printf ("NativeProcessLinux::%s selecting running thread for interrupt target", __FUNCTION__);
 
-    Monitor::ScopedOperationLock monitor_lock(*m_monitor_up);
     Mutex::Locker locker (m_threads_mutex);
 
     for (auto thread_sp : m_threads)
@@ -2730,16 +3577,8 @@ ParseMemoryRegionInfoFromProcMapsLine (const std::string &maps_line, MemoryRegio
 }
 
 Error
-NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
+NativeProcessLinux::UpdateMemoryRegionCache ()
 {
-    // FIXME review that the final memory region returned extends to the end of the virtual address space,
-    // with no perms if it is not mapped.
-
-    // Use an approach that reads memory regions from /proc/{pid}/maps.
-    // Assume proc maps entries are in ascending order.
-    // FIXME assert if we find differently.
-    Mutex::Locker locker (m_mem_region_cache_mutex);
-
     Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
     Error error;
 
@@ -2750,96 +3589,159 @@ NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInf
         return error;
     }
 
-    // If our cache is empty, pull the latest.  There should always be at least one memory region
-    // if memory region handling is supported.
-    if (m_mem_region_cache.empty ())
+    // Nothing to do if the process hasn't run since we last read the maps.
+    if (!m_mem_region_cache_stale && !m_mem_region_cache.empty ())
     {
-        error = ProcFileReader::ProcessLineByLine (GetID (), "maps",
-             [&] (const std::string &line) -> bool
-             {
-                 MemoryRegionInfo info;
-                 const Error parse_error = ParseMemoryRegionInfoFromProcMapsLine (line, info);
-                 if (parse_error.Success ())
-                 {
-                     m_mem_region_cache.push_back (info);
-                     return true;
-                 }
-                 else
-                 {
-                     if (log)
-                         log->Printf ("NativeProcessLinux::%s failed to parse proc maps line '%s': %s", __FUNCTION__, line.c_str (), error.AsCString ());
-                     return false;
-                 }
-             });
-
-        // If we had an error, we'll mark unsupported.
-        if (error.Fail ())
-        {
-            m_supports_mem_region = LazyBool::eLazyBoolNo;
-            return error;
-        }
-        else if (m_mem_region_cache.empty ())
-        {
-            // No entries after attempting to read them.  This shouldn't happen if /proc/{pid}/maps
-            // is supported.  Assume we don't support map entries via procfs.
-            if (log)
-                log->Printf ("NativeProcessLinux::%s failed to find any procfs maps entries, assuming no support for memory region metadata retrieval", __FUNCTION__);
-            m_supports_mem_region = LazyBool::eLazyBoolNo;
-            error.SetErrorString ("not supported");
-            return error;
-        }
-
         if (log)
-            log->Printf ("NativeProcessLinux::%s read %" PRIu64 " memory region entries from /proc/%" PRIu64 "/maps", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()), GetID ());
+            log->Printf ("NativeProcessLinux::%s reusing %" PRIu64 " cached memory region entries", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+        return error;
+    }
+
+    // Use an approach that reads memory regions from /proc/{pid}/maps.
+    // There should always be at least one memory region if memory region
+    // handling is supported.
+    std::vector<MemoryRegionInfo> regions;
+    error = ProcFileReader::ProcessLineByLine (GetID (), "maps",
+         [&] (const std::string &line) -> bool
+         {
+             MemoryRegionInfo info;
+             const Error parse_error = ParseMemoryRegionInfoFromProcMapsLine (line, info);
+             if (parse_error.Success ())
+             {
+                 regions.push_back (info);
+                 return true;
+             }
+             else
+             {
+                 if (log)
+                     log->Printf ("NativeProcessLinux::%s failed to parse proc maps line '%s': %s", __FUNCTION__, line.c_str (), parse_error.AsCString ());
+                 return false;
+             }
+         });
 
-        // We support memory retrieval, remember that.
-        m_supports_mem_region = LazyBool::eLazyBoolYes;
+    // If we had an error, we'll mark unsupported.
+    if (error.Fail ())
+    {
+        m_supports_mem_region = LazyBool::eLazyBoolNo;
+        return error;
     }
-    else
+    else if (regions.empty ())
     {
+        // No entries after attempting to read them.  This shouldn't happen if /proc/{pid}/maps
+        // is supported.  Assume we don't support map entries via procfs.
         if (log)
-            log->Printf ("NativeProcessLinux::%s reusing %" PRIu64 " cached memory region entries", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+            log->Printf ("NativeProcessLinux::%s failed to find any procfs maps entries, assuming no support for memory region metadata retrieval", __FUNCTION__);
+        m_supports_mem_region = LazyBool::eLazyBoolNo;
+        error.SetErrorString ("not supported");
+        return error;
     }
 
-    lldb::addr_t prev_base_address = 0;
+    // Watching memory isn't a change of the map for clients.
+    if (!m_software_watchpoint_list.IsEmpty ())
+        RestoreWatchedPagePermissions (regions);
 
-    // FIXME start by finding the last region that is <= target address using binary search.  Data is sorted.
-    // There can be a ton of regions on pthreads apps with lots of threads.
-    for (auto it = m_mem_region_cache.begin(); it != m_mem_region_cache.end (); ++it)
+    // Lookups binary search the regions, so they need to be in ascending
+    // order, which is how the kernel lists them.
+    assert (std::is_sorted (regions.begin (), regions.end (),
+                            [] (const MemoryRegionInfo &lhs, const MemoryRegionInfo &rhs) -> bool
+                            {
+                                return lhs.GetRange ().GetRangeBase () < rhs.GetRange ().GetRangeBase ();
+                            }) && "descending /proc/pid/maps entries detected, unexpected");
+
+    // Only start a new generation if the mappings really changed so clients
+    // holding a copy of the map can keep using it.
+    if (regions != m_mem_region_cache)
     {
-        MemoryRegionInfo &proc_entry_info = *it;
+        m_mem_region_cache.swap (regions);
+        ++m_mem_region_generation;
+    }
+    m_mem_region_cache_stale = false;
 
-        // Sanity check assumption that /proc/{pid}/maps entries are ascending.
-        assert ((proc_entry_info.GetRange ().GetRangeBase () >= prev_base_address) && "descending /proc/pid/maps entries detected, unexpected");
-        prev_base_address = proc_entry_info.GetRange ().GetRangeBase ();
+    if (log)
+        log->Printf ("NativeProcessLinux::%s read %" PRIu64 " memory region entries from /proc/%" PRIu64 "/maps, generation %" PRIu32, __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()), GetID (), m_mem_region_generation);
 
-        // If the target address comes before this entry, indicate distance to next region.
-        if (load_addr < proc_entry_info.GetRange ().GetRangeBase ())
-        {
-            range_info.GetRange ().SetRangeBase (load_addr);
-            range_info.GetRange ().SetByteSize (proc_entry_info.GetRange ().GetRangeBase () - load_addr);
-            range_info.SetReadable (MemoryRegionInfo::OptionalBool::eNo);
-            range_info.SetWritable (MemoryRegionInfo::OptionalBool::eNo);
-            range_info.SetExecutable (MemoryRegionInfo::OptionalBool::eNo);
+    // We support memory retrieval, remember that.
+    m_supports_mem_region = LazyBool::eLazyBoolYes;
+    return error;
+}
 
-            return error;
-        }
-        else if (proc_entry_info.GetRange ().Contains (load_addr))
+void
+NativeProcessLinux::RestoreWatchedPagePermissions (std::vector<MemoryRegionInfo> &regions) const
+{
+    const size_t page_size = m_software_watchpoint_list.GetPageSize ();
+    std::vector<MemoryRegionInfo> restored;
+    restored.reserve (regions.size ());
+    for (const MemoryRegionInfo &region_info : regions)
+    {
+        NativeSoftwareWatchpointList::ProtectionChanges ranges;
+        m_software_watchpoint_list.GetUnwatchedRanges (region_info.GetRange ().GetRangeBase (),
+                                                      region_info.GetRange ().GetByteSize (),
+                                                      GetRegionPermissions (region_info),
+                                                      ranges);
+        for (const auto &range : ranges)
         {
-            // The target address is within the memory region we're processing here.
-            range_info = proc_entry_info;
-            return error;
+            // mprotect splits a mapping where the protection changes, put
+            // the pieces back together where they meet at a watched page.
+            if (!restored.empty ())
+            {
+                MemoryRegionInfo &last = restored.back ();
+                if (last.GetRange ().GetRangeEnd () == range.addr &&
+                    GetRegionPermissions (last) == range.permissions &&
+                    (m_software_watchpoint_list.IsWatchedPage (range.addr) ||
+                     m_software_watchpoint_list.IsWatchedPage (range.addr - page_size)))
+                {
+                    last.GetRange ().SetByteSize (last.GetRange ().GetByteSize () + range.size);
+                    continue;
+                }
+            }
+
+            MemoryRegionInfo range_info;
+            range_info.GetRange ().SetRangeBase (range.addr);
+            range_info.GetRange ().SetByteSize (range.size);
+            SetRegionPermissions (range_info, range.permissions);
+            restored.push_back (range_info);
         }
+    }
+    regions.swap (restored);
+}
+
+Error
+NativeProcessLinux::GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info)
+{
+    // FIXME review that the final memory region returned extends to the end of the virtual address space,
+    // with no perms if it is not mapped.
+    Mutex::Locker locker (m_mem_region_cache_mutex);
+
+    Error error = UpdateMemoryRegionCache ();
+    if (error.Fail ())
+        return error;
+
+    // There can be a ton of regions on pthreads apps with lots of threads,
+    // so binary search for the one that contains the address.
+    if (!MemoryRegionInfo::FindRegion (m_mem_region_cache, load_addr, range_info))
+    {
+        // We didn't find an entry that contained the given address.
+        error.SetErrorString ("address comes after final region");
 
-        // The target memory address comes somewhere after the region we just parsed.
+        Log *log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+        if (log)
+            log->Printf ("NativeProcessLinux::%s failed to find map entry for address 0x%" PRIx64 ": %s", __FUNCTION__, load_addr, error.AsCString ());
     }
 
-    // If we made it here, we didn't find an entry that contained the given address.
-    error.SetErrorString ("address comes after final region");
+    return error;
+}
 
-    if (log)
-        log->Printf ("NativeProcessLinux::%s failed to find map entry for address 0x%" PRIx64 ": %s", __FUNCTION__, load_addr, error.AsCString ());
+Error
+NativeProcessLinux::GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation)
+{
+    Mutex::Locker locker (m_mem_region_cache_mutex);
 
+    Error error = UpdateMemoryRegionCache ();
+    if (error.Success ())
+    {
+        regions = m_mem_region_cache;
+        generation = m_mem_region_generation;
+    }
     return error;
 }
 
@@ -2851,10 +3753,12 @@ NativeProcessLinux::DoStopIDBumped (uint32_t newBumpId)
         log->Printf ("NativeProcessLinux::%s(newBumpId=%" PRIu32 ") called", __FUNCTION__, newBumpId);
 
     {
+        // Keep the entries around so the next read of the maps can tell
+        // whether anything changed.
         Mutex::Locker locker (m_mem_region_cache_mutex);
         if (log)
-            log->Printf ("NativeProcessLinux::%s clearing %" PRIu64 " entries from the cache", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
-        m_mem_region_cache.clear ();
+            log->Printf ("NativeProcessLinux::%s marking %" PRIu64 " cached memory region entries stale", __FUNCTION__, static_cast<uint64_t> (m_mem_region_cache.size ()));
+        m_mem_region_cache_stale = true;
     }
 }
 
@@ -2950,9 +3854,8 @@ NativeProcessLinux::GetSharedLibraryInfoAddress ()
 size_t
 NativeProcessLinux::UpdateThreads ()
 {
-    // The NativeProcessLinux monitoring threads are always up to date
-    // with respect to thread state and they keep the thread list
-    // populated properly. All this method needs to do is return the
+    // The SIGCHLD handler keeps the thread list up to date with respect
+    // to thread state, so all this method needs to do is return the
     // thread count.
     Mutex::Locker locker (m_threads_mutex);
     return m_threads.size ();
@@ -3224,29 +4127,11 @@ NativeProcessLinux::GetCrashReasonForSIGBUS(const siginfo_t *info)
 }
 #endif
 
-Error
-NativeProcessLinux::SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware)
-{
-    // The base SetWatchpoint will end up executing monitor operations. Let's lock the monitor
-    // for it.
-    Monitor::ScopedOperationLock monitor_lock(*m_monitor_up);
-    return NativeProcessProtocol::SetWatchpoint(addr, size, watch_flags, hardware);
-}
-
-Error
-NativeProcessLinux::RemoveWatchpoint (lldb::addr_t addr)
-{
-    // The base RemoveWatchpoint will end up executing monitor operations. Let's lock the monitor
-    // for it.
-    Monitor::ScopedOperationLock monitor_lock(*m_monitor_up);
-    return NativeProcessProtocol::RemoveWatchpoint(addr);
-}
-
 Error
 NativeProcessLinux::ReadMemory (lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read)
 {
     ReadOperation op(addr, buf, size, bytes_read);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError ();
 }
 
@@ -3258,14 +4143,155 @@ NativeProcessLinux::ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t s
     return m_breakpoint_list.RemoveTrapsFromBuffer(addr, buf, size);
 }
 
+Error
+NativeProcessLinux::ReadMemoryRanges (MemoryReadRanges &ranges)
+{
+    // The kernel won't take more than this many iovecs in one call (IOV_MAX)
+    static const size_t k_max_iovecs = 1024;
+
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+
+    const size_t num_ranges = ranges.size();
+    std::vector<DataBufferHeap *> buffers (num_ranges, nullptr);
+    std::vector<size_t> bytes_read (num_ranges, 0);
+    std::vector<struct iovec> local_iovs;
+    std::vector<struct iovec> remote_iovs;
+    std::vector<size_t> iov_range_indexes;
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        MemoryReadRange &range = ranges[i];
+        buffers[i] = new DataBufferHeap (range.size, 0);
+        range.data_sp.reset (buffers[i]);
+        range.error.Clear ();
+        if (range.size == 0)
+            continue;
+
+        struct iovec local_iov = { buffers[i]->GetBytes (), range.size };
+        struct iovec remote_iov = { reinterpret_cast<void *>(range.addr), range.size };
+        local_iovs.push_back (local_iov);
+        remote_iovs.push_back (remote_iov);
+        iov_range_indexes.push_back (i);
+    }
+
+    // Read everything we can with process_vm_readv(). This reads all of the
+    // ranges with one system call instead of a ptrace call per word. It
+    // stops at the first range that can't be read, so skip past that range
+    // and keep going with the rest.
+    const size_t num_iovs = local_iovs.size ();
+    size_t iov_idx = 0;
+    while (iov_idx < num_iovs && g_process_vm_readv_supported)
+    {
+        const size_t iov_count = std::min (num_iovs - iov_idx, k_max_iovecs);
+        const ssize_t result = ProcessVMReadv (GetID (), &local_iovs[iov_idx], iov_count, &remote_iovs[iov_idx], iov_count);
+        if (result < 0)
+        {
+            const int err = errno;
+            if (log)
+                log->Printf ("NativeProcessLinux::%s process_vm_readv of %" PRIu64 " ranges failed: %s", __FUNCTION__, (uint64_t)iov_count, strerror (err));
+            if (err == ENOSYS)
+                g_process_vm_readv_supported = false;
+            if (err != EFAULT)
+                break;
+            ++iov_idx;
+            continue;
+        }
+
+        size_t bytes_left = result;
+        const size_t end_iov_idx = iov_idx + iov_count;
+        while (iov_idx < end_iov_idx && bytes_left >= local_iovs[iov_idx].iov_len)
+        {
+            bytes_read[iov_range_indexes[iov_idx]] = local_iovs[iov_idx].iov_len;
+            bytes_left -= local_iovs[iov_idx].iov_len;
+            ++iov_idx;
+        }
+        if (iov_idx < end_iov_idx)
+        {
+            bytes_read[iov_range_indexes[iov_idx]] = bytes_left;
+            ++iov_idx;
+        }
+    }
+
+    // ptrace can read memory that process_vm_readv can't, like pages the
+    // inferior itself isn't allowed to read, so use it for whatever is left.
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        MemoryReadRange &range = ranges[i];
+        if (bytes_read[i] < range.size)
+        {
+            size_t ptrace_bytes_read = 0;
+            range.error = ReadMemory (range.addr + bytes_read[i],
+                                      buffers[i]->GetBytes () + bytes_read[i],
+                                      range.size - bytes_read[i],
+                                      ptrace_bytes_read);
+            bytes_read[i] += ptrace_bytes_read;
+        }
+        buffers[i]->SetByteSize (bytes_read[i]);
+    }
+
+    return Error ();
+}
+
 Error
 NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
 {
     WriteOperation op(addr, buf, size, bytes_written);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError ();
 }
 
+Error
+NativeProcessLinux::WriteMemoryBlock (lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written)
+{
+    Log *log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+    const uint8_t *bytes = static_cast<const uint8_t *>(buf);
+
+    bytes_written = 0;
+    if (g_proc_mem_write_supported && size > 0)
+    {
+        // Open the file for each write, a descriptor that was opened before
+        // an exec keeps referring to the memory of the old image.
+        char mem_path[64];
+        ::snprintf (mem_path, sizeof (mem_path), "/proc/%" PRIu64 "/mem", GetID ());
+        const int fd = ::open (mem_path, O_WRONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            if (log)
+                log->Printf ("NativeProcessLinux::%s failed to open %s: %s", __FUNCTION__, mem_path, strerror (errno));
+        }
+        else
+        {
+            while (bytes_written < size)
+            {
+                const ssize_t result = ::pwrite64 (fd, bytes + bytes_written, size - bytes_written, addr + bytes_written);
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                {
+                    const int err = result < 0 ? errno : 0;
+                    if (log)
+                        log->Printf ("NativeProcessLinux::%s writing %" PRIu64 " bytes at 0x%" PRIx64 " failed: %s",
+                                     __FUNCTION__, (uint64_t)(size - bytes_written), addr + bytes_written, strerror (err));
+                    if (err == EINVAL)
+                        g_proc_mem_write_supported = false;
+                    break;
+                }
+                bytes_written += result;
+            }
+            ::close (fd);
+        }
+    }
+
+    // ptrace can write what's left.
+    if (bytes_written < size)
+    {
+        size_t ptrace_bytes_written = 0;
+        Error error = WriteMemory (addr + bytes_written, bytes + bytes_written, size - bytes_written, ptrace_bytes_written);
+        bytes_written += ptrace_bytes_written;
+        return error;
+    }
+    return Error ();
+}
+
 Error
 NativeProcessLinux::Resume (lldb::tid_t tid, uint32_t signo)
 {
@@ -3275,7 +4301,7 @@ NativeProcessLinux::Resume (lldb::tid_t tid, uint32_t signo)
         log->Printf ("NativeProcessLinux::%s() resuming thread = %"  PRIu64 " with signal %s", __FUNCTION__, tid,
                                  GetUnixSignals().GetSignalAsCString (signo));
     ResumeOperation op (tid, signo);
-    m_monitor_up->DoOperation (&op);
+    DoOperation (&op);
     if (log)
         log->Printf ("NativeProcessLinux::%s() resuming thread = %"  PRIu64 " result = %s", __FUNCTION__, tid, op.GetError().Success() ? "true" : "false");
     return op.GetError();
@@ -3285,7 +4311,7 @@ Error
 NativeProcessLinux::SingleStep(lldb::tid_t tid, uint32_t signo)
 {
     SingleStepOperation op(tid, signo);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError();
 }
 
@@ -3293,7 +4319,7 @@ Error
 NativeProcessLinux::GetSignalInfo(lldb::tid_t tid, void *siginfo)
 {
     SiginfoOperation op(tid, siginfo);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError();
 }
 
@@ -3301,7 +4327,7 @@ Error
 NativeProcessLinux::GetEventMessage(lldb::tid_t tid, unsigned long *message)
 {
     EventMessageOperation op(tid, message);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError();
 }
 
@@ -3312,7 +4338,7 @@ NativeProcessLinux::Detach(lldb::tid_t tid)
         return Error();
 
     DetachOperation op(tid);
-    m_monitor_up->DoOperation(&op);
+    DoOperation(&op);
     return op.GetError();
 }
 
@@ -3330,47 +4356,29 @@ NativeProcessLinux::DupDescriptor(const FileSpec &file_spec, int fd, int flags)
     return (close(target_fd) == -1) ? false : true;
 }
 
-void
-NativeProcessLinux::StartMonitorThread(const InitialOperation &initial_operation, Error &error)
-{
-    m_monitor_up.reset(new Monitor(initial_operation, this));
-    error = m_monitor_up->Initialize();
-    if (error.Fail()) {
-        m_monitor_up.reset();
-    }
-}
-
 bool
 NativeProcessLinux::HasThreadNoLock (lldb::tid_t thread_id)
 {
-    for (auto thread_sp : m_threads)
-    {
-        assert (thread_sp && "thread list should not contain NULL threads");
-        if (thread_sp->GetID () == thread_id)
-        {
-            // We have this thread.
-            return true;
-        }
-    }
-
-    // We don't have this thread.
-    return false;
+    return m_threads_by_id.find (thread_id) != m_threads_by_id.end ();
 }
 
 NativeThreadProtocolSP
 NativeProcessLinux::MaybeGetThreadNoLock (lldb::tid_t thread_id)
 {
-    // CONSIDER organize threads by map - we can do better than linear.
-    for (auto thread_sp : m_threads)
-    {
-        if (thread_sp->GetID () == thread_id)
-            return thread_sp;
-    }
+    auto pos = m_threads_by_id.find (thread_id);
+    if (pos != m_threads_by_id.end ())
+        return pos->second;
 
     // We don't have this thread.
     return NativeThreadProtocolSP ();
 }
 
+NativeThreadProtocolSP
+NativeProcessLinux::GetThreadByIDUnlocked (lldb::tid_t tid)
+{
+    return MaybeGetThreadNoLock (tid);
+}
+
 bool
 NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
 {
@@ -3391,6 +4399,10 @@ NativeProcessLinux::StopTrackingThread (lldb::tid_t thread_id)
             break;
         }
     }
+    m_threads_by_id.erase (thread_id);
+    m_threads_stopping_for_client.erase (thread_id);
+    m_held_thread_resumes.erase (thread_id);
+    m_threads_skipping_breakpoint.erase (thread_id);
 
     // If we have a pending notification, remove this from the set.
     if (m_pending_notification_up)
@@ -3425,6 +4437,7 @@ NativeProcessLinux::AddThread (lldb::tid_t thread_id)
 
     NativeThreadProtocolSP thread_sp (new NativeThreadLinux (this, thread_id));
     m_threads.push_back (thread_sp);
+    m_threads_by_id[thread_id] = thread_sp;
 
     return thread_sp;
 }
@@ -3637,7 +4650,10 @@ NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
                 __FUNCTION__, triggering_tid);
     }
 
-    DoStopThreads(PendingNotificationUP(new PendingNotification(triggering_tid)));
+    if (m_non_stop_mode)
+        ReportThreadStopped(triggering_tid);
+    else
+        DoStopThreads(PendingNotificationUP(new PendingNotification(triggering_tid)));
 
     if (log)
     {
@@ -3645,6 +4661,45 @@ NativeProcessLinux::StopRunningThreads(const lldb::tid_t triggering_tid)
     }
 }
 
+void
+NativeProcessLinux::ReportThreadStopped(lldb::tid_t tid)
+{
+    Log *log(GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_BREAKPOINTS));
+
+    // Whatever stopped the thread also satisfies a stop request from the
+    // client.
+    m_threads_stopping_for_client.erase(tid);
+
+    // Clear the temporary breakpoint used to single step this thread.
+    auto pos = m_threads_stepping_with_breakpoint.find(tid);
+    if (pos != m_threads_stepping_with_breakpoint.end())
+    {
+        Error error = RemoveBreakpoint (pos->second);
+        if (error.Fail())
+            if (log)
+                log->Printf("NativeProcessLinux::%s() pid = %" PRIu64 " remove stepping breakpoint: %s",
+                        __FUNCTION__, tid, error.AsCString());
+        m_threads_stepping_with_breakpoint.erase(pos);
+    }
+
+    // The process as a whole only stops once all of its threads have.
+    // Nobody is notified of that, the stop of each thread is reported on
+    // its own.
+    bool all_threads_stopped = true;
+    for (const auto &thread_sp: m_threads)
+    {
+        if (!StateIsStoppedState(thread_sp->GetState(), true))
+        {
+            all_threads_stopped = false;
+            break;
+        }
+    }
+    if (all_threads_stopped)
+        SetState(StateType::eStateStopped, false);
+
+    NotifyThreadStopped(tid);
+}
+
 void
 NativeProcessLinux::SignalIfAllThreadsStopped()
 {
@@ -3677,19 +4732,52 @@ NativeProcessLinux::RequestStopOnAllRunningThreads()
     // and are not already known to be stopped.  Keep a list of all the
     // threads from which we still need to hear a stop reply.
 
-    ThreadIDSet sent_tids;
+    ThreadIDSet wait_for_stop_tids;
     for (const auto &thread_sp: m_threads)
     {
         // We only care about running threads
         if (StateIsStoppedState(thread_sp->GetState(), true))
             continue;
 
-        static_pointer_cast<NativeThreadLinux>(thread_sp)->RequestStop();
-        sent_tids.insert (thread_sp->GetID());
+        wait_for_stop_tids.insert (thread_sp->GetID());
+    }
+
+    // Set the wait list to the set of tids we need to hear from.
+    m_pending_notification_up->wait_for_stop_tids.swap (wait_for_stop_tids);
+
+    RequestStopOnWaitedForThreads();
+}
+
+void
+NativeProcessLinux::RequestStopOnWaitedForThreads()
+{
+    Log *const log = GetLogIfAllCategoriesSet (LIBLLDB_LOG_THREAD);
+
+    size_t num_stops_sent = 0;
+    for (const lldb::tid_t tid : m_pending_notification_up->wait_for_stop_tids)
+    {
+        auto thread_sp = std::static_pointer_cast<NativeThreadLinux>(MaybeGetThreadNoLock(tid));
+        if (!thread_sp || StateIsStoppedState(thread_sp->GetState(), true))
+            continue;
+
+        // A SIGSTOP we sent for an earlier notification is still on its way.
+        // Sending another one would stop the thread again after the next
+        // resume.
+        if (thread_sp->GetThreadContext().stop_requested)
+            continue;
+
+        // The thread is already stopped, we just haven't processed its event.
+        if (m_undispatched_stop_tids.count(tid))
+            continue;
+
+        thread_sp->RequestStop();
+        ++num_stops_sent;
     }
 
-    // Set the wait list to the set of tids for which we requested stops.
-    m_pending_notification_up->wait_for_stop_tids.swap (sent_tids);
+    if (log)
+        log->Printf("NativeProcessLinux::%s sent %" PRIu64 " stop requests, waiting for %" PRIu64 " threads",
+                __FUNCTION__, static_cast<uint64_t>(num_stops_sent),
+                static_cast<uint64_t>(m_pending_notification_up->wait_for_stop_tids.size()));
 }
 
 
@@ -3778,7 +4866,7 @@ NativeProcessLinux::ThreadWasCreated (lldb::tid_t tid)
 Error
 NativeProcessLinux::DoOperation(Operation* op)
 {
-    m_monitor_up->DoOperation(op);
+    op->Execute(this);
     return op->GetError();
 }
 
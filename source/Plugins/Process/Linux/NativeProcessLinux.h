@@ -11,6 +11,7 @@
 #define liblldb_NativeProcessLinux_H_
 
 // C++ Includes
+#include <unordered_map>
 #include <unordered_set>
 
 // Other libraries and framework includes
@@ -19,11 +20,14 @@
 #include "lldb/Host/Debug.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Host/HostThread.h"
+#include "lldb/Host/MainLoop.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Target/MemoryRegionInfo.h"
 
 #include "lldb/Host/common/NativeProcessProtocol.h"
 #include "NativeThreadLinux.h"
+#include "Plugins/Process/Utility/AgentExpression.h"
+#include "Plugins/Process/Utility/DisplacedStep.h"
 
 namespace lldb_private {
     class Error;
@@ -47,12 +51,14 @@ namespace process_linux {
             Module *exe_module,
             ProcessLaunchInfo &launch_info,
             NativeProcessProtocol::NativeDelegate &native_delegate,
+            MainLoop &mainloop,
             NativeProcessProtocolSP &native_process_sp);
 
         static Error
         AttachToProcess (
             lldb::pid_t pid,
             NativeProcessProtocol::NativeDelegate &native_delegate,
+            MainLoop &mainloop,
             NativeProcessProtocolSP &native_process_sp);
 
         //------------------------------------------------------------------------------
@@ -60,12 +66,12 @@ namespace process_linux {
         /// @brief Represents a NativeProcessLinux operation.
         ///
         /// Under Linux, it is not possible to ptrace() from any other thread but the
-        /// one that spawned or attached to the process from the start.  Therefore, when
-        /// a NativeProcessLinux is asked to deliver or change the state of an inferior
-        /// process the operation must be "funneled" to a specific thread to perform the
-        /// task.  The Operation class provides an abstract base for all services the
-        /// NativeProcessLinux must perform via the single virtual function Execute, thus
-        /// encapsulating the code that needs to run in the privileged context.
+        /// one that spawned or attached to the process from the start.  All of the
+        /// work on a NativeProcessLinux, including handling the inferior's events, is
+        /// done on the thread that runs the MainLoop the process was created with, so
+        /// operations are executed directly by DoOperation.  The Operation class
+        /// provides an abstract base for all services the NativeProcessLinux must
+        /// perform via the single virtual function Execute.
         class Operation
         {
         public:
@@ -107,18 +113,33 @@ namespace process_linux {
         Error
         Kill () override;
 
+        Error
+        SetNonStopMode (bool enable) override;
+
+        Error
+        StopThread (lldb::tid_t tid) override;
+
         Error
         GetMemoryRegionInfo (lldb::addr_t load_addr, MemoryRegionInfo &range_info) override;
 
+        Error
+        GetMemoryRegions (std::vector<MemoryRegionInfo> &regions, uint32_t &generation) override;
+
         Error
         ReadMemory(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
         Error
         ReadMemoryWithoutTrap(lldb::addr_t addr, void *buf, size_t size, size_t &bytes_read) override;
 
+        Error
+        ReadMemoryRanges (MemoryReadRanges &ranges) override;
+
         Error
         WriteMemory(lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) override;
 
+        Error
+        WriteMemoryBlock (lldb::addr_t addr, const void *buf, size_t size, size_t &bytes_written) override;
+
         Error
         AllocateMemory(size_t size, uint32_t permissions, lldb::addr_t &addr) override;
 
@@ -137,12 +158,6 @@ namespace process_linux {
         Error
         SetBreakpoint (lldb::addr_t addr, uint32_t size, bool hardware) override;
 
-        Error
-        SetWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags, bool hardware) override;
-
-        Error
-        RemoveWatchpoint (lldb::addr_t addr) override;
-
         void
         DoStopIDBumped (uint32_t newBumpId) override;
 
@@ -164,6 +179,13 @@ namespace process_linux {
         static long
         PtraceWrapper(int req, lldb::pid_t pid, void *addr, void *data, size_t data_size, Error& error);
 
+        // The thread to access memory through with ptrace, which only works
+        // on a stopped thread. While the other threads are running (in
+        // non-stop mode, or while evaluating breakpoint conditions) that may
+        // not be the main thread.
+        lldb::tid_t
+        GetMemoryAccessThreadID ();
+
     protected:
         // ---------------------------------------------------------------------
         // NativeProcessProtocol protected interface
@@ -171,26 +193,52 @@ namespace process_linux {
         Error
         GetSoftwareBreakpointTrapOpcode (size_t trap_opcode_size_hint, size_t &actual_opcode_size, const uint8_t *&trap_opcode_bytes) override;
 
-    private:
+        NativeThreadProtocolSP
+        GetThreadByIDUnlocked (lldb::tid_t tid) override;
 
-        class Monitor;
+        Error
+        SetSoftwareWatchpoint (lldb::addr_t addr, size_t size, uint32_t watch_flags) override;
 
-        ArchSpec m_arch;
+        Error
+        RemoveSoftwareWatchpoint (lldb::addr_t addr) override;
 
-        std::unique_ptr<Monitor> m_monitor_up;
+    private:
+
+        MainLoop::SignalHandleUP m_sigchld_handle;
+        ArchSpec m_arch;
 
         LazyBool m_supports_mem_region;
         std::vector<MemoryRegionInfo> m_mem_region_cache;
+        bool m_mem_region_cache_stale;      // The process has run since m_mem_region_cache was read
+        uint32_t m_mem_region_generation;   // Bumped whenever m_mem_region_cache changes
         Mutex m_mem_region_cache_mutex;
 
         // List of thread ids stepping with a breakpoint with the address of
         // the relevan breakpoint
         std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_with_breakpoint;
 
+        // Threads that are stepping over a software breakpoint from a
+        // scratch slot, so that the breakpoint can stay inserted while the
+        // other threads run.
+        struct DisplacedStepInfo
+        {
+            DisplacedStep step;
+            size_t slot;
+            std::vector<uint8_t> saved_bytes;   // What the slot held before
+        };
+        std::map<lldb::tid_t, DisplacedStepInfo> m_displaced_steps;
+        std::vector<bool> m_displaced_step_slots_in_use;
+        lldb::addr_t m_displaced_step_scratch_addr;
+
+        // Threads that are stepping over a software breakpoint that was
+        // disabled for the step because it couldn't be displaced, with the
+        // address of the breakpoint.
+        std::map<lldb::tid_t, lldb::addr_t> m_threads_stepping_over_breakpoint;
+
         /// @class LauchArgs
         ///
-        /// @brief Simple structure to pass data to the thread responsible for
-        /// launching a child process.
+        /// @brief Simple structure to pass the parameters of a launch to
+        /// Launch().
         struct LaunchArgs
         {
             LaunchArgs(Module *module,
@@ -214,8 +262,6 @@ namespace process_linux {
             const ProcessLaunchInfo &m_launch_info;
         };
 
-        typedef std::function<::pid_t(Error &)> InitialOperation;
-
         // ---------------------------------------------------------------------
         // Private Instance Methods
         // ---------------------------------------------------------------------
@@ -240,9 +286,6 @@ namespace process_linux {
         void
         AttachToInferior (lldb::pid_t pid, Error &error);
 
-        void
-        StartMonitorThread(const InitialOperation &operation, Error &error);
-
         ::pid_t
         Launch(LaunchArgs *args, Error &error);
 
@@ -258,6 +301,12 @@ namespace process_linux {
         static void *
         MonitorThread(void *baton);
 
+        Error
+        RegisterSigchldHandler(MainLoop &mainloop);
+
+        void
+        SigchldHandler();
+
         void
         MonitorCallback(lldb::pid_t pid, bool exited, int signal, int status);
 
@@ -285,6 +334,94 @@ namespace process_linux {
         Error
         SetupSoftwareSingleStepping(NativeThreadProtocolSP thread_sp);
 
+        // Set up a step of the thread over the software breakpoint at its
+        // PC, if there is one. Sets hold_other_threads if the step can't be
+        // displaced and has to happen with the breakpoint disabled and the
+        // other threads stopped.
+        void
+        PrepareStepOverBreakpoint(const NativeThreadProtocolSP &thread_sp, bool &hold_other_threads);
+
+        Error
+        PrepareDisplacedStep(const NativeThreadProtocolSP &thread_sp, lldb::addr_t pc);
+
+        // Called for each event of a thread that may be stepping over a
+        // breakpoint, before the event is dispatched.
+        void
+        FinishStepOverBreakpoint(lldb::tid_t tid, bool exited);
+
+        // Make callbacks for AgentExpression::Evaluate() that read the
+        // registers of a thread and the memory of the process.
+        void
+        GetAgentExpressionCallbacks(const NativeRegisterContextSP &reg_ctx_sp,
+                                    AgentExpression::ReadRegisterCallback &read_register,
+                                    AgentExpression::ReadMemoryCallback &read_memory);
+
+        // Sets conditions_are_false if all conditions of the breakpoint
+        // evaluate to false for the thread. Fails if one of them can't be
+        // evaluated.
+        Error
+        EvaluateBreakpointConditions(const NativeThreadProtocolSP &thread_sp, const NativeBreakpoint &breakpoint, bool &conditions_are_false);
+
+        // Add a record of the tracepoint items of the breakpoint for the
+        // thread that hit it to the tracepoint buffer.
+        void
+        CollectTracepointData(const NativeThreadProtocolSP &thread_sp, const NativeBreakpoint &breakpoint);
+
+        // Called for a thread that was continuing and just hit a breakpoint.
+        // Records the hit if it is a tracepoint and, if the hit doesn't have
+        // to be reported, steps the thread over the breakpoint, to be
+        // continued by FinishSkippingBreakpoint(), and returns true.
+        bool
+        SkipBreakpointHit(const NativeThreadProtocolSP &thread_sp);
+
+        // Called for each event of a thread, returns true if the event ended
+        // the step of a skipped breakpoint hit and has been handled.
+        bool
+        FinishSkippingBreakpoint(lldb::tid_t tid, const siginfo_t *info);
+
+        // The start of the area that displaced steps are done in: the entry
+        // point of the executable, which isn't run again once the process
+        // has started.
+        lldb::addr_t
+        GetDisplacedStepScratchAddress();
+
+        // Make a thread that is in a ptrace-stop run the system call
+        // "number" with "args" from the scratch area, and put what it
+        // returns in "result". The thread is left as it was.
+        Error
+        InjectSyscall(lldb::tid_t tid, uint64_t number, const std::vector<uint64_t> &args, int64_t &result);
+
+        // Apply protection changes for software watchpoints with mprotect
+        // calls injected into a thread.
+        Error
+        ProtectPages(lldb::tid_t tid, const NativeSoftwareWatchpointList::ProtectionChanges &changes);
+
+        // The thread that protection changes are made through when no
+        // thread in particular caused them. It has to be stopped.
+        Error
+        GetProtectionThreadID(lldb::tid_t &tid);
+
+        // Called for a SEGV_ACCERR fault, returns true if it was an access
+        // to a page protected for software watchpoints and has been handled
+        // by unprotecting the page and stepping the thread over the access.
+        bool
+        HandleWatchedPageFault(const NativeThreadProtocolSP &thread_sp, lldb::addr_t fault_addr);
+
+        struct WatchedAccessStep;
+
+        // Take the protection off a watched page for a step of a thread, and
+        // keep what the write watchpoints on the page cover to find out
+        // whether the step changes it.
+        Error
+        UnprotectWatchedPage(lldb::tid_t tid, lldb::addr_t fault_addr, WatchedAccessStep &step);
+
+        // Called for each event of a thread, protects the pages a step over
+        // a watched access unprotected again and returns true if the event
+        // ended the step and has been handled. Hits of the watchpoints are
+        // reported, otherwise the thread continues.
+        bool
+        FinishWatchedAccessStep(lldb::tid_t tid, const siginfo_t *info, bool exited);
+
 #if 0
         static ::ProcessMessage::CrashReason
         GetCrashReasonForSIGSEGV(const siginfo_t *info);
@@ -344,6 +481,17 @@ namespace process_linux {
         Error
         Detach(lldb::tid_t tid);
 
+        // Re-read /proc/{pid}/maps into m_mem_region_cache if the process
+        // has run since it was last read. m_mem_region_cache_mutex must be
+        // held.
+        Error
+        UpdateMemoryRegionCache ();
+
+        // Give the pages of software watchpoints in "regions", read from
+        // /proc/{pid}/maps, the permissions they had before they were
+        // watched, joining the pieces of mappings that watching split.
+        void
+        RestoreWatchedPagePermissions (std::vector<MemoryRegionInfo> &regions) const;
 
         // Typedefs.
         typedef std::unordered_set<lldb::tid_t> ThreadIDSet;
@@ -354,6 +502,11 @@ namespace process_linux {
         void
         StopRunningThreads(lldb::tid_t triggering_tid);
 
+        // Report the stop of a single thread in non-stop mode, without
+        // stopping any of the others.
+        void
+        ReportThreadStopped(lldb::tid_t tid);
+
         struct PendingNotification
         {
             PendingNotification (lldb::tid_t triggering_tid):
@@ -373,6 +526,12 @@ namespace process_linux {
         void
         RequestStopOnAllRunningThreads();
 
+        // Send a SIGSTOP to each thread the pending notification is waiting
+        // for, unless one is already on its way or the thread is already in
+        // a ptrace-stop that the monitor hasn't dispatched yet.
+        void
+        RequestStopOnWaitedForThreads();
+
         Error
         ThreadDidStop(lldb::tid_t tid, bool initiated_by_llgs);
 
@@ -391,6 +550,49 @@ namespace process_linux {
 
         // Member variables.
         PendingNotificationUP m_pending_notification_up;
+
+        // Threads by ID, so looking up the thread for each waitpid event
+        // doesn't have to search all of m_threads. Guarded by m_threads_mutex.
+        std::unordered_map<lldb::tid_t, NativeThreadProtocolSP> m_threads_by_id;
+
+        // Threads that are in a ptrace-stop that SigchldHandler has reaped
+        // with waitpid but hasn't dispatched yet.
+        ThreadIDSet m_undispatched_stop_tids;
+
+        // Threads that the client asked to stop in non-stop mode and whose
+        // SIGSTOP hasn't arrived yet.
+        ThreadIDSet m_threads_stopping_for_client;
+
+        // In non-stop mode, the threads held while another thread steps over
+        // a disabled breakpoint, with how to resume them once it's done.
+        std::map<lldb::tid_t, NativeThreadLinux::ResumeThreadFunction> m_held_thread_resumes;
+
+        // Threads stepping over a breakpoint whose conditions were false,
+        // with how to continue them once they are past it.
+        std::map<lldb::tid_t, NativeThreadLinux::ResumeThreadFunction> m_threads_skipping_breakpoint;
+
+        // Threads stepping over an access to pages protected for software
+        // watchpoints, with the pages unprotected.
+        struct WatchedAccessStep
+        {
+            struct Snapshot
+            {
+                lldb::addr_t wp_addr;
+                lldb::addr_t addr;
+                std::vector<uint8_t> bytes;
+            };
+
+            std::vector<lldb::addr_t> pages;
+            std::vector<lldb::addr_t> fault_addrs;
+            std::vector<Snapshot> snapshots;    // Of the write watchpoints on the pages
+            NativeThreadLinux::ResumeThreadFunction resume_function;
+            bool was_stepping;
+        };
+        std::map<lldb::tid_t, WatchedAccessStep> m_watched_access_steps;
+
+        // Exits of threads that InjectSyscall() reaped with waitpid, for
+        // SigchldHandler to dispatch.
+        std::vector<std::pair< ::pid_t, int>> m_deferred_wait_events;
     };
 
 } // namespace process_linux
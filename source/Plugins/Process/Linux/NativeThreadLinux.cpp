@@ -336,6 +336,21 @@ NativeThreadLinux::SetStoppedByWatchpoint (uint32_t wp_index)
     m_stop_info.details.signal.signo = SIGTRAP;
 }
 
+void
+NativeThreadLinux::SetStoppedBySoftwareWatchpoint (lldb::addr_t wp_addr)
+{
+    const StateType new_state = StateType::eStateStopped;
+    MaybeLogStateChange (new_state);
+    m_state = new_state;
+
+    std::ostringstream ostr;
+    ostr << wp_addr;
+    m_stop_description = ostr.str();
+
+    m_stop_info.reason = StopReason::eStopReasonWatchpoint;
+    m_stop_info.details.signal.signo = SIGTRAP;
+}
+
 bool
 NativeThreadLinux::IsStoppedAtBreakpoint ()
 {
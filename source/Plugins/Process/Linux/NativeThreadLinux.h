@@ -77,6 +77,11 @@ namespace process_linux {
         void
         SetStoppedByWatchpoint (uint32_t wp_index);
 
+        // Stopped by the software watchpoint at wp_addr, which has no
+        // debug register index.
+        void
+        SetStoppedBySoftwareWatchpoint (lldb::addr_t wp_addr);
+
         bool
         IsStoppedAtBreakpoint ();
 
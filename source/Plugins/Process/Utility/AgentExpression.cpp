@@ -0,0 +1,344 @@
+//===-- AgentExpression.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "AgentExpression.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Jumps can go backwards, so bound the work a buggy or hostile
+    // expression can make us do.
+    const size_t kMaxSteps = 10000;
+    const size_t kMaxStackDepth = 256;
+
+    uint64_t
+    SignExtend (uint64_t value, unsigned bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        const uint64_t sign_bit = 1ull << (bits - 1);
+        value &= (sign_bit << 1) - 1;
+        return (value ^ sign_bit) - sign_bit;
+    }
+
+    uint64_t
+    ZeroExtend (uint64_t value, unsigned bits)
+    {
+        if (bits == 0 || bits >= 64)
+            return value;
+        return value & ((1ull << bits) - 1);
+    }
+}
+
+AgentExpression::AgentExpression () :
+    m_bytes ()
+{
+}
+
+AgentExpression::AgentExpression (const uint8_t *bytes, size_t size) :
+    m_bytes (bytes, bytes + size)
+{
+}
+
+void
+AgentExpression::AppendBigEndian (uint64_t value, size_t byte_size)
+{
+    for (size_t i = byte_size; i > 0; --i)
+        m_bytes.push_back (static_cast<uint8_t> (value >> ((i - 1) * 8)));
+}
+
+bool
+AgentExpression::ReadBigEndian (size_t &offset, size_t byte_size, uint64_t &value) const
+{
+    if (offset + byte_size > m_bytes.size ())
+        return false;
+    value = 0;
+    for (size_t i = 0; i < byte_size; ++i)
+        value = (value << 8) | m_bytes[offset++];
+    return true;
+}
+
+void
+AgentExpression::AppendOpcode (Opcode op)
+{
+    m_bytes.push_back (op);
+}
+
+void
+AgentExpression::AppendConstant (uint64_t value)
+{
+    if (value <= UINT8_MAX)
+    {
+        AppendOpcode (eOpConst8);
+        AppendBigEndian (value, 1);
+    }
+    else if (value <= UINT16_MAX)
+    {
+        AppendOpcode (eOpConst16);
+        AppendBigEndian (value, 2);
+    }
+    else if (value <= UINT32_MAX)
+    {
+        AppendOpcode (eOpConst32);
+        AppendBigEndian (value, 4);
+    }
+    else
+    {
+        AppendOpcode (eOpConst64);
+        AppendBigEndian (value, 8);
+    }
+}
+
+void
+AgentExpression::AppendRegister (uint32_t reg_num)
+{
+    AppendOpcode (eOpReg);
+    AppendBigEndian (reg_num, 2);
+}
+
+void
+AgentExpression::AppendExtend (bool is_signed, uint8_t bits)
+{
+    if (bits >= 64)
+        return;
+    AppendOpcode (is_signed ? eOpExt : eOpZeroExt);
+    AppendBigEndian (bits, 1);
+}
+
+bool
+AgentExpression::AppendReference (size_t byte_size)
+{
+    switch (byte_size)
+    {
+        case 1: AppendOpcode (eOpRef8);  return true;
+        case 2: AppendOpcode (eOpRef16); return true;
+        case 4: AppendOpcode (eOpRef32); return true;
+        case 8: AppendOpcode (eOpRef64); return true;
+    }
+    return false;
+}
+
+size_t
+AgentExpression::AppendJump (Opcode op)
+{
+    const size_t jump_offset = m_bytes.size ();
+    AppendOpcode (op);
+    AppendBigEndian (0, 2);
+    return jump_offset;
+}
+
+void
+AgentExpression::PatchJump (size_t jump_offset)
+{
+    const size_t target = m_bytes.size ();
+    m_bytes[jump_offset + 1] = static_cast<uint8_t> (target >> 8);
+    m_bytes[jump_offset + 2] = static_cast<uint8_t> (target);
+}
+
+Error
+AgentExpression::Evaluate (const ReadRegisterCallback &read_register,
+                           const ReadMemoryCallback &read_memory,
+                           ByteOrder byte_order,
+                           uint64_t &result) const
+{
+    std::vector<uint64_t> stack;
+    size_t pc = 0;
+
+    for (size_t steps = 0; steps < kMaxSteps; ++steps)
+    {
+        if (pc >= m_bytes.size ())
+            return Error ("agent expression ends without an end opcode");
+
+        const size_t op_offset = pc;
+        const uint8_t op = m_bytes[pc++];
+
+        // Check the stack for all of the opcodes up front.
+        size_t num_pops = 0;
+        switch (op)
+        {
+            case eOpAdd: case eOpSub: case eOpMul:
+            case eOpDivSigned: case eOpDivUnsigned:
+            case eOpRemSigned: case eOpRemUnsigned:
+            case eOpLsh: case eOpRshSigned: case eOpRshUnsigned:
+            case eOpBitAnd: case eOpBitOr: case eOpBitXor:
+            case eOpEqual: case eOpLessSigned: case eOpLessUnsigned:
+            case eOpSwap:
+                num_pops = 2;
+                break;
+            case eOpLogNot: case eOpBitNot: case eOpExt: case eOpZeroExt:
+            case eOpRef8: case eOpRef16: case eOpRef32: case eOpRef64:
+            case eOpIfGoto: case eOpEnd: case eOpDup: case eOpPop:
+                num_pops = 1;
+                break;
+        }
+        if (stack.size () < num_pops)
+            return Error ("agent expression stack underflow at offset %" PRIu64, (uint64_t)op_offset);
+        if (stack.size () >= kMaxStackDepth)
+            return Error ("agent expression stack overflow at offset %" PRIu64, (uint64_t)op_offset);
+
+        uint64_t operand = 0;
+        switch (op)
+        {
+            case eOpAdd:
+            case eOpSub:
+            case eOpMul:
+            case eOpDivSigned:
+            case eOpDivUnsigned:
+            case eOpRemSigned:
+            case eOpRemUnsigned:
+            case eOpLsh:
+            case eOpRshSigned:
+            case eOpRshUnsigned:
+            case eOpBitAnd:
+            case eOpBitOr:
+            case eOpBitXor:
+            case eOpEqual:
+            case eOpLessSigned:
+            case eOpLessUnsigned:
+            {
+                const uint64_t b = stack.back ();
+                stack.pop_back ();
+                const uint64_t a = stack.back ();
+                uint64_t value = 0;
+                switch (op)
+                {
+                    case eOpAdd:         value = a + b; break;
+                    case eOpSub:         value = a - b; break;
+                    case eOpMul:         value = a * b; break;
+                    case eOpLsh:         value = b < 64 ? a << b : 0; break;
+                    case eOpRshUnsigned: value = b < 64 ? a >> b : 0; break;
+                    case eOpRshSigned:
+                        value = static_cast<uint64_t> (static_cast<int64_t> (a) >> (b < 64 ? b : 63));
+                        break;
+                    case eOpBitAnd:      value = a & b; break;
+                    case eOpBitOr:       value = a | b; break;
+                    case eOpBitXor:      value = a ^ b; break;
+                    case eOpEqual:       value = a == b; break;
+                    case eOpLessSigned:  value = static_cast<int64_t> (a) < static_cast<int64_t> (b); break;
+                    case eOpLessUnsigned: value = a < b; break;
+                    default:
+                        if (b == 0)
+                            return Error ("agent expression divides by zero at offset %" PRIu64, (uint64_t)op_offset);
+                        if (op == eOpDivUnsigned)
+                            value = a / b;
+                        else if (op == eOpRemUnsigned)
+                            value = a % b;
+                        else if (static_cast<int64_t> (b) == -1)
+                            // INT64_MIN / -1 overflows.
+                            value = op == eOpDivSigned ? 0 - a : 0;
+                        else if (op == eOpDivSigned)
+                            value = static_cast<uint64_t> (static_cast<int64_t> (a) / static_cast<int64_t> (b));
+                        else
+                            value = static_cast<uint64_t> (static_cast<int64_t> (a) % static_cast<int64_t> (b));
+                        break;
+                }
+                stack.back () = value;
+                break;
+            }
+
+            case eOpLogNot:
+                stack.back () = stack.back () == 0;
+                break;
+
+            case eOpBitNot:
+                stack.back () = ~stack.back ();
+                break;
+
+            case eOpExt:
+            case eOpZeroExt:
+                if (!ReadBigEndian (pc, 1, operand))
+                    return Error ("agent expression truncated at offset %" PRIu64, (uint64_t)op_offset);
+                if (op == eOpExt)
+                    stack.back () = SignExtend (stack.back (), operand);
+                else
+                    stack.back () = ZeroExtend (stack.back (), operand);
+                break;
+
+            case eOpRef8:
+            case eOpRef16:
+            case eOpRef32:
+            case eOpRef64:
+            {
+                const size_t byte_size = 1u << (op - eOpRef8);
+                const addr_t addr = stack.back ();
+                uint8_t buf[8];
+                if (!read_memory || !read_memory (addr, buf, byte_size))
+                    return Error ("agent expression failed to read %" PRIu64 " bytes at 0x%" PRIx64,
+                                  (uint64_t)byte_size, addr);
+                uint64_t value = 0;
+                for (size_t i = 0; i < byte_size; ++i)
+                {
+                    const size_t index = byte_order == eByteOrderLittle ? byte_size - 1 - i : i;
+                    value = (value << 8) | buf[index];
+                }
+                stack.back () = value;
+                break;
+            }
+
+            case eOpIfGoto:
+            case eOpGoto:
+            {
+                if (!ReadBigEndian (pc, 2, operand))
+                    return Error ("agent expression truncated at offset %" PRIu64, (uint64_t)op_offset);
+                bool jump = true;
+                if (op == eOpIfGoto)
+                {
+                    jump = stack.back () != 0;
+                    stack.pop_back ();
+                }
+                if (jump)
+                    pc = operand;
+                break;
+            }
+
+            case eOpConst8:
+            case eOpConst16:
+            case eOpConst32:
+            case eOpConst64:
+                if (!ReadBigEndian (pc, 1u << (op - eOpConst8), operand))
+                    return Error ("agent expression truncated at offset %" PRIu64, (uint64_t)op_offset);
+                stack.push_back (operand);
+                break;
+
+            case eOpReg:
+            {
+                if (!ReadBigEndian (pc, 2, operand))
+                    return Error ("agent expression truncated at offset %" PRIu64, (uint64_t)op_offset);
+                uint64_t value = 0;
+                if (!read_register || !read_register (static_cast<uint32_t> (operand), value))
+                    return Error ("agent expression failed to read register %" PRIu64, operand);
+                stack.push_back (value);
+                break;
+            }
+
+            case eOpEnd:
+                result = stack.back ();
+                return Error ();
+
+            case eOpDup:
+                stack.push_back (stack.back ());
+                break;
+
+            case eOpPop:
+                stack.pop_back ();
+                break;
+
+            case eOpSwap:
+                std::swap (stack[stack.size () - 1], stack[stack.size () - 2]);
+                break;
+
+            default:
+                return Error ("unsupported agent expression opcode 0x%2.2x at offset %" PRIu64, op, (uint64_t)op_offset);
+        }
+    }
+
+    return Error ("agent expression took more than %" PRIu64 " steps", (uint64_t)kMaxSteps);
+}
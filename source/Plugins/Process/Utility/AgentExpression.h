@@ -0,0 +1,177 @@
+//===-- AgentExpression.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_AgentExpression_h_
+#define liblldb_AgentExpression_h_
+
+// C Includes
+// C++ Includes
+#include <functional>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class AgentExpression AgentExpression.h "Plugins/Process/Utility/AgentExpression.h"
+/// @brief A bytecode expression that a remote stub evaluates by itself.
+///
+/// The encoding is the stack machine bytecode of the GDB agent
+/// expressions, as used by the "X" conditions of the "Z" packets. Only
+/// the integer opcodes are supported. All values are 64 bits wide,
+/// register operands are numbered the way the stub numbers its
+/// registers, and jump targets are offsets from the start of the
+/// expression.
+//----------------------------------------------------------------------
+class AgentExpression
+{
+public:
+    enum Opcode
+    {
+        eOpAdd          = 0x02,
+        eOpSub          = 0x03,
+        eOpMul          = 0x04,
+        eOpDivSigned    = 0x05,
+        eOpDivUnsigned  = 0x06,
+        eOpRemSigned    = 0x07,
+        eOpRemUnsigned  = 0x08,
+        eOpLsh          = 0x09,
+        eOpRshSigned    = 0x0a,
+        eOpRshUnsigned  = 0x0b,
+        eOpLogNot       = 0x0e,
+        eOpBitAnd       = 0x0f,
+        eOpBitOr        = 0x10,
+        eOpBitXor       = 0x11,
+        eOpBitNot       = 0x12,
+        eOpEqual        = 0x13,
+        eOpLessSigned   = 0x14,
+        eOpLessUnsigned = 0x15,
+        eOpExt          = 0x16,     // <bits>
+        eOpRef8         = 0x17,
+        eOpRef16        = 0x18,
+        eOpRef32        = 0x19,
+        eOpRef64        = 0x1a,
+        eOpIfGoto       = 0x20,     // <offset:16>
+        eOpGoto         = 0x21,     // <offset:16>
+        eOpConst8       = 0x22,     // <value:8>
+        eOpConst16      = 0x23,     // <value:16>
+        eOpConst32      = 0x24,     // <value:32>
+        eOpConst64      = 0x25,     // <value:64>
+        eOpReg          = 0x26,     // <reg_num:16>
+        eOpEnd          = 0x27,
+        eOpDup          = 0x28,
+        eOpPop          = 0x29,
+        eOpZeroExt      = 0x2a,     // <bits>
+        eOpSwap         = 0x2b
+    };
+
+    typedef std::function<bool (uint32_t reg_num, uint64_t &value)> ReadRegisterCallback;
+    typedef std::function<bool (lldb::addr_t addr, void *buf, size_t size)> ReadMemoryCallback;
+
+    // Expressions are sent in a single packet, and anything longer than
+    // this is better evaluated by the debugger.
+    static const size_t kMaxSize = 1024;
+
+    AgentExpression ();
+
+    AgentExpression (const uint8_t *bytes, size_t size);
+
+    const std::vector<uint8_t> &
+    GetBytes () const
+    {
+        return m_bytes;
+    }
+
+    size_t
+    GetSize () const
+    {
+        return m_bytes.size ();
+    }
+
+    //------------------------------------------------------------------
+    // Building expressions. Operands are written in big endian order.
+    //------------------------------------------------------------------
+    void
+    AppendOpcode (Opcode op);
+
+    //------------------------------------------------------------------
+    /// Push \a value using the shortest of the constant opcodes.
+    //------------------------------------------------------------------
+    void
+    AppendConstant (uint64_t value);
+
+    void
+    AppendRegister (uint32_t reg_num);
+
+    //------------------------------------------------------------------
+    /// Sign or zero extend the top of the stack from \a bits bits.
+    //------------------------------------------------------------------
+    void
+    AppendExtend (bool is_signed, uint8_t bits);
+
+    //------------------------------------------------------------------
+    /// Replace the address on top of the stack with the \a byte_size
+    /// byte value stored there.
+    ///
+    /// @return
+    ///     False if there is no opcode for values of that size.
+    //------------------------------------------------------------------
+    bool
+    AppendReference (size_t byte_size);
+
+    //------------------------------------------------------------------
+    /// Append a jump with a target to be filled in later by
+    /// PatchJump(). Returns the offset of the jump.
+    //------------------------------------------------------------------
+    size_t
+    AppendJump (Opcode op);
+
+    //------------------------------------------------------------------
+    /// Make the jump at \a jump_offset go to the current end of the
+    /// expression.
+    //------------------------------------------------------------------
+    void
+    PatchJump (size_t jump_offset);
+
+    //------------------------------------------------------------------
+    /// Run the expression.
+    ///
+    /// @param[in] byte_order
+    ///     The byte order of values in the memory of the process.
+    ///
+    /// @param[out] result
+    ///     The value on top of the stack when the expression ended.
+    ///
+    /// @return
+    ///     An error if the expression is malformed, runs for too long or
+    ///     couldn't read a register or memory.
+    //------------------------------------------------------------------
+    Error
+    Evaluate (const ReadRegisterCallback &read_register,
+              const ReadMemoryCallback &read_memory,
+              lldb::ByteOrder byte_order,
+              uint64_t &result) const;
+
+private:
+    void
+    AppendBigEndian (uint64_t value, size_t byte_size);
+
+    bool
+    ReadBigEndian (size_t &offset, size_t byte_size, uint64_t &value) const;
+
+    std::vector<uint8_t> m_bytes;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_AgentExpression_h_
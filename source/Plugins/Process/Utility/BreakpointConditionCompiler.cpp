@@ -0,0 +1,761 @@
+//===-- BreakpointConditionCompiler.cpp -------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "BreakpointConditionCompiler.h"
+
+// C Includes
+#include <ctype.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Module.h"
+#include "lldb/Expression/DWARFExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/CompileUnit.h"
+#include "lldb/Symbol/FuncUnwinders.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/Type.h"
+#include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
+#include "lldb/Symbol/Variable.h"
+#include "lldb/Symbol/VariableList.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Thread.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Binary operators from the loosest to the tightest binding, as in C.
+    int
+    GetPrecedence (const std::string &op)
+    {
+        static const struct
+        {
+            const char *op;
+            int precedence;
+        } g_operators[] =
+        {
+            { "||", 1 },
+            { "&&", 2 },
+            { "|",  3 },
+            { "^",  4 },
+            { "&",  5 },
+            { "==", 6 }, { "!=", 6 },
+            { "<",  7 }, { "<=", 7 }, { ">",  7 }, { ">=", 7 },
+            { "<<", 8 }, { ">>", 8 },
+            { "+",  9 }, { "-",  9 },
+            { "*", 10 }, { "/", 10 }, { "%", 10 }
+        };
+        for (const auto &entry : g_operators)
+        {
+            if (op == entry.op)
+                return entry.precedence;
+        }
+        return 0;
+    }
+}
+
+BreakpointConditionCompiler::BreakpointConditionCompiler (Thread &thread, const Address &address) :
+    m_thread (thread),
+    m_address (address),
+    m_sc (),
+    m_expr (NULL),
+    m_error (),
+    m_pos (NULL),
+    m_token_kind (eTokenEnd),
+    m_token (),
+    m_token_value (0),
+    m_token_type ()
+{
+    m_address.CalculateSymbolContext (&m_sc);
+}
+
+Error
+BreakpointConditionCompiler::Compile (const char *condition, AgentExpression &expr)
+{
+    m_expr = &expr;
+    m_error.Clear ();
+    m_pos = condition;
+    NextToken ();
+
+    OperandType type;
+    if (!ParseBinary (1, type))
+        return m_error;
+    if (m_token_kind != eTokenEnd)
+    {
+        SetError ("unexpected '%s' in condition", m_token.c_str ());
+        return m_error;
+    }
+
+    EmitEnd ();
+    return m_error;
+}
+
+Error
+BreakpointConditionCompiler::CompileCollect (const char *item, uint32_t &reg_num, AgentExpression &address_expr, uint32_t &byte_size)
+{
+    m_expr = &address_expr;
+    m_error.Clear ();
+    reg_num = LLDB_INVALID_REGNUM;
+    byte_size = 0;
+
+    // "<address>@<byte-size>" collects memory at any address.
+    const std::string text (item);
+    const size_t at_pos = text.rfind ('@');
+    if (at_pos != std::string::npos)
+    {
+        const std::string address (text, 0, at_pos);
+        char *end = NULL;
+        const unsigned long long size = ::strtoull (text.c_str () + at_pos + 1, &end, 0);
+        while (isspace (*end))
+            ++end;
+        if (*end != '\0' || size == 0 || size > kMaxCollectSize)
+        {
+            SetError ("the byte size in '%s' must be between 1 and %u", item, kMaxCollectSize);
+            return m_error;
+        }
+
+        m_pos = address.c_str ();
+        NextToken ();
+        OperandType type;
+        if (!ParseBinary (1, type))
+            return m_error;
+        if (m_token_kind != eTokenEnd)
+        {
+            SetError ("unexpected '%s' in address", m_token.c_str ());
+            return m_error;
+        }
+        byte_size = size;
+        EmitEnd ();
+        return m_error;
+    }
+
+    m_pos = item;
+    NextToken ();
+    const std::string name (m_token);
+    const TokenKind kind = m_token_kind;
+    NextToken ();
+    if (m_token_kind != eTokenEnd || (kind != eTokenRegister && kind != eTokenIdentifier))
+    {
+        SetError ("'%s' isn't a register, a variable or <address>@<byte-size>", item);
+        return m_error;
+    }
+
+    if (kind == eTokenRegister)
+    {
+        // The stub collects registers of any size.
+        RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext ());
+        const RegisterInfo *reg_info = reg_ctx_sp ? reg_ctx_sp->GetRegisterInfoByName (name.c_str ()) : NULL;
+        if (reg_info == NULL)
+            SetError ("no register named '%s'", name.c_str ());
+        else
+        {
+            reg_num = reg_info->kinds[eRegisterKindLLDB];
+            byte_size = reg_info->byte_size;
+        }
+        return m_error;
+    }
+
+    ClangASTType clang_type;
+    uint32_t stub_reg_num;
+    if (!EmitVariableLocation (name.c_str (), clang_type, stub_reg_num))
+        return m_error;
+    if (stub_reg_num != LLDB_INVALID_REGNUM)
+    {
+        RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext ());
+        reg_num = stub_reg_num;
+        byte_size = reg_ctx_sp->GetRegisterInfoAtIndex (stub_reg_num)->byte_size;
+        return m_error;
+    }
+
+    const uint64_t type_size = clang_type.GetByteSize (NULL);
+    if (type_size == 0 || type_size > kMaxCollectSize)
+    {
+        SetError ("'%s' has %" PRIu64 " bytes, at most %u can be collected", name.c_str (), type_size, kMaxCollectSize);
+        return m_error;
+    }
+    byte_size = type_size;
+    EmitEnd ();
+    return m_error;
+}
+
+void
+BreakpointConditionCompiler::EmitEnd ()
+{
+    m_expr->AppendOpcode (AgentExpression::eOpEnd);
+    if (m_expr->GetSize () > AgentExpression::kMaxSize)
+        SetError ("expression compiles to more than %" PRIu64 " bytes", (uint64_t)AgentExpression::kMaxSize);
+}
+
+bool
+BreakpointConditionCompiler::SetError (const char *format, ...)
+{
+    va_list args;
+    va_start (args, format);
+    m_error.SetErrorStringWithVarArg (format, args);
+    va_end (args);
+    return false;
+}
+
+void
+BreakpointConditionCompiler::NextToken ()
+{
+    while (isspace (*m_pos))
+        ++m_pos;
+
+    const char *start = m_pos;
+    m_token.clear ();
+    if (*m_pos == '\0')
+    {
+        m_token_kind = eTokenEnd;
+        return;
+    }
+
+    if (isdigit (*m_pos))
+    {
+        char *end = NULL;
+        errno = 0;
+        m_token_value = ::strtoull (m_pos, &end, 0);
+        m_pos = end;
+        bool has_unsigned_suffix = false;
+        bool has_long_suffix = false;
+        while (*m_pos == 'u' || *m_pos == 'U' || *m_pos == 'l' || *m_pos == 'L')
+        {
+            if (*m_pos == 'u' || *m_pos == 'U')
+                has_unsigned_suffix = true;
+            else
+                has_long_suffix = true;
+            ++m_pos;
+        }
+        m_token.assign (start, m_pos);
+        if (errno == ERANGE || isalnum (*m_pos) || *m_pos == '_')
+        {
+            m_token_kind = eTokenInvalid;
+            return;
+        }
+
+        // The first of int, unsigned int (for hex and octal literals
+        // only), long and unsigned long that can hold the value.
+        const bool is_decimal = start[0] != '0';
+        m_token_type = OperandType ();
+        if (has_long_suffix || m_token_value > (has_unsigned_suffix || !is_decimal ? UINT32_MAX : INT32_MAX))
+            m_token_type.byte_size = 8;
+        m_token_type.is_signed = !has_unsigned_suffix;
+        if (m_token_type.byte_size == 4 && m_token_value > INT32_MAX)
+            m_token_type.is_signed = false;
+        else if (m_token_value > INT64_MAX)
+            m_token_type.is_signed = false;
+        m_token_kind = eTokenNumber;
+        return;
+    }
+
+    if (isalpha (*m_pos) || *m_pos == '_' || *m_pos == '$')
+    {
+        m_token_kind = *m_pos == '$' ? eTokenRegister : eTokenIdentifier;
+        if (*m_pos == '$')
+            start = ++m_pos;
+        while (isalnum (*m_pos) || *m_pos == '_')
+            ++m_pos;
+        m_token.assign (start, m_pos);
+        if (m_token.empty ())
+            m_token_kind = eTokenInvalid;
+        return;
+    }
+
+    static const char *g_two_char_operators[] = { "||", "&&", "==", "!=", "<=", ">=", "<<", ">>" };
+    for (const char *op : g_two_char_operators)
+    {
+        if (m_pos[0] == op[0] && m_pos[1] == op[1])
+        {
+            m_pos += 2;
+            m_token.assign (start, m_pos);
+            m_token_kind = eTokenOperator;
+            return;
+        }
+    }
+
+    m_token.assign (start, ++m_pos);
+    if (::strchr ("+-*/%&|^!~<>()", m_token[0]) != NULL)
+        m_token_kind = eTokenOperator;
+    else
+        m_token_kind = eTokenInvalid;
+}
+
+BreakpointConditionCompiler::OperandType
+BreakpointConditionCompiler::GetCommonType (const OperandType &lhs, const OperandType &rhs)
+{
+    // The usual arithmetic conversions. Pointers only get here to be
+    // compared, where they behave like unsigned integers.
+    OperandType type;
+    if (lhs.byte_size != rhs.byte_size)
+        return lhs.byte_size > rhs.byte_size ? lhs : rhs;
+    type.byte_size = lhs.byte_size;
+    type.is_signed = lhs.is_signed && rhs.is_signed;
+    return type;
+}
+
+void
+BreakpointConditionCompiler::EmitConversion (const OperandType &from, const OperandType &to)
+{
+    // Converting an int to a long or an unsigned long keeps the sign
+    // extended value, and an unsigned int is already zero extended. Only
+    // a negative int that becomes an unsigned int changes.
+    if (from.is_signed && !to.is_signed && from.byte_size == 4 && to.byte_size == 4)
+        m_expr->AppendExtend (false, 32);
+}
+
+void
+BreakpointConditionCompiler::EmitNormalize (const OperandType &type)
+{
+    // Wrap the result of an operation on int sized values.
+    if (type.byte_size < 8)
+        m_expr->AppendExtend (type.is_signed, type.byte_size * 8);
+}
+
+bool
+BreakpointConditionCompiler::ParseBinary (int min_precedence, OperandType &type)
+{
+    if (!ParseUnary (type))
+        return false;
+
+    while (m_token_kind == eTokenOperator)
+    {
+        const std::string op (m_token);
+        const int precedence = GetPrecedence (op);
+        if (precedence == 0 || precedence < min_precedence)
+            break;
+        NextToken ();
+
+        OperandType rhs;
+        if (op == "&&" || op == "||")
+        {
+            // Short circuit, and leave 0 or 1 behind like C does.
+            size_t short_circuit;
+            if (op == "&&")
+            {
+                m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+                short_circuit = m_expr->AppendJump (AgentExpression::eOpIfGoto);
+            }
+            else
+            {
+                short_circuit = m_expr->AppendJump (AgentExpression::eOpIfGoto);
+            }
+            if (!ParseBinary (precedence + 1, rhs))
+                return false;
+            m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+            m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+            const size_t to_end = m_expr->AppendJump (AgentExpression::eOpGoto);
+            m_expr->PatchJump (short_circuit);
+            m_expr->AppendConstant (op == "&&" ? 0 : 1);
+            m_expr->PatchJump (to_end);
+            type = OperandType ();
+            continue;
+        }
+
+        if (!ParseBinary (precedence + 1, rhs))
+            return false;
+
+        const bool is_comparison = precedence == 6 || precedence == 7;
+        if (!is_comparison && (type.pointee_type.IsValid () || rhs.pointee_type.IsValid ()))
+            return SetError ("pointer arithmetic isn't supported");
+
+        if (op == "<<" || op == ">>")
+        {
+            // The result has the type of the left operand.
+            if (op == "<<")
+                m_expr->AppendOpcode (AgentExpression::eOpLsh);
+            else if (type.is_signed)
+                m_expr->AppendOpcode (AgentExpression::eOpRshSigned);
+            else
+                m_expr->AppendOpcode (AgentExpression::eOpRshUnsigned);
+            EmitNormalize (type);
+            continue;
+        }
+
+        const OperandType common = GetCommonType (type, rhs);
+        EmitConversion (rhs, common);
+        if (type.is_signed && !common.is_signed && type.byte_size == common.byte_size)
+        {
+            m_expr->AppendOpcode (AgentExpression::eOpSwap);
+            EmitConversion (type, common);
+            m_expr->AppendOpcode (AgentExpression::eOpSwap);
+        }
+
+        const AgentExpression::Opcode less = common.is_signed ? AgentExpression::eOpLessSigned
+                                                              : AgentExpression::eOpLessUnsigned;
+        if (is_comparison)
+        {
+            if (op == "==" || op == "!=")
+            {
+                m_expr->AppendOpcode (AgentExpression::eOpEqual);
+                if (op == "!=")
+                    m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+            }
+            else
+            {
+                // a > b is b < a, a <= b is !(b < a) and a >= b is !(a < b).
+                if (op == ">" || op == "<=")
+                    m_expr->AppendOpcode (AgentExpression::eOpSwap);
+                m_expr->AppendOpcode (less);
+                if (op == "<=" || op == ">=")
+                    m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+            }
+            type = OperandType ();
+            continue;
+        }
+
+        switch (op[0])
+        {
+            case '|': m_expr->AppendOpcode (AgentExpression::eOpBitOr); break;
+            case '^': m_expr->AppendOpcode (AgentExpression::eOpBitXor); break;
+            case '&': m_expr->AppendOpcode (AgentExpression::eOpBitAnd); break;
+            case '+': m_expr->AppendOpcode (AgentExpression::eOpAdd); break;
+            case '-': m_expr->AppendOpcode (AgentExpression::eOpSub); break;
+            case '*': m_expr->AppendOpcode (AgentExpression::eOpMul); break;
+            case '/':
+                m_expr->AppendOpcode (common.is_signed ? AgentExpression::eOpDivSigned : AgentExpression::eOpDivUnsigned);
+                break;
+            case '%':
+                m_expr->AppendOpcode (common.is_signed ? AgentExpression::eOpRemSigned : AgentExpression::eOpRemUnsigned);
+                break;
+        }
+        type = common;
+        EmitNormalize (type);
+    }
+    return true;
+}
+
+bool
+BreakpointConditionCompiler::ParseUnary (OperandType &type)
+{
+    if (m_token_kind != eTokenOperator || m_token.size () != 1 || ::strchr ("+-~!*", m_token[0]) == NULL)
+        return ParsePrimary (type);
+
+    const char op = m_token[0];
+    NextToken ();
+    if (!ParseUnary (type))
+        return false;
+
+    switch (op)
+    {
+        case '!':
+            m_expr->AppendOpcode (AgentExpression::eOpLogNot);
+            type = OperandType ();
+            return true;
+
+        case '*':
+            if (!type.pointee_type.IsValid ())
+                return SetError ("only pointers can be dereferenced");
+            return EmitLoad (type.pointee_type, false, type);
+    }
+
+    if (type.pointee_type.IsValid ())
+        return SetError ("pointer arithmetic isn't supported");
+    if (op == '-')
+    {
+        m_expr->AppendConstant (0);
+        m_expr->AppendOpcode (AgentExpression::eOpSwap);
+        m_expr->AppendOpcode (AgentExpression::eOpSub);
+        EmitNormalize (type);
+    }
+    else if (op == '~')
+    {
+        m_expr->AppendOpcode (AgentExpression::eOpBitNot);
+        EmitNormalize (type);
+    }
+    return true;
+}
+
+bool
+BreakpointConditionCompiler::ParsePrimary (OperandType &type)
+{
+    const std::string token (m_token);
+    switch (m_token_kind)
+    {
+        case eTokenNumber:
+            m_expr->AppendConstant (m_token_value);
+            type = m_token_type;
+            NextToken ();
+            return true;
+
+        case eTokenIdentifier:
+            NextToken ();
+            return EmitVariable (token.c_str (), type);
+
+        case eTokenRegister:
+            NextToken ();
+            return EmitRegister (token.c_str (), type);
+
+        case eTokenOperator:
+            if (token == "(")
+            {
+                NextToken ();
+                if (!ParseBinary (1, type))
+                    return false;
+                if (!IsOperator (")"))
+                    return SetError ("expected ')' in condition");
+                NextToken ();
+                return true;
+            }
+            break;
+
+        case eTokenEnd:
+            return SetError ("unexpected end of condition");
+
+        case eTokenInvalid:
+            break;
+    }
+    return SetError ("unexpected '%s' in condition", token.c_str ());
+}
+
+bool
+BreakpointConditionCompiler::MapRegister (RegisterKind kind, uint32_t reg_num, uint32_t &stub_reg_num)
+{
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext ());
+    if (!reg_ctx_sp)
+        return SetError ("no register context");
+
+    // Process plug-ins number their registers the way the stub does.
+    const uint32_t lldb_reg_num = reg_ctx_sp->ConvertRegisterKindToRegisterNumber (kind, reg_num);
+    const RegisterInfo *reg_info = reg_ctx_sp->GetRegisterInfoAtIndex (lldb_reg_num);
+    if (reg_info == NULL || reg_info->byte_size > 8 || lldb_reg_num > UINT16_MAX)
+        return SetError ("register %u of kind %u can't be read by the stub", reg_num, kind);
+
+    stub_reg_num = lldb_reg_num;
+    return true;
+}
+
+bool
+BreakpointConditionCompiler::EmitRegister (const char *name, OperandType &type)
+{
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext ());
+    const RegisterInfo *reg_info = reg_ctx_sp ? reg_ctx_sp->GetRegisterInfoByName (name) : NULL;
+    if (reg_info == NULL)
+        return SetError ("no register named '%s'", name);
+    if (reg_info->encoding != eEncodingUint && reg_info->encoding != eEncodingSint)
+        return SetError ("register '%s' isn't an integer register", name);
+
+    uint32_t stub_reg_num;
+    if (!MapRegister (eRegisterKindLLDB, reg_info->kinds[eRegisterKindLLDB], stub_reg_num))
+        return false;
+    m_expr->AppendRegister (stub_reg_num);
+
+    type = OperandType ();
+    type.is_signed = reg_info->encoding == eEncodingSint;
+    if (reg_info->byte_size < 8)
+        m_expr->AppendExtend (type.is_signed, reg_info->byte_size * 8);
+    if (reg_info->byte_size < 4)
+        type.is_signed = true;
+    else
+        type.byte_size = reg_info->byte_size;
+    return true;
+}
+
+bool
+BreakpointConditionCompiler::EmitFrameBase ()
+{
+    if (m_sc.function == NULL)
+        return SetError ("no function at the breakpoint");
+
+    DWARFExpression &frame_base = m_sc.function->GetFrameBaseExpression ();
+    const addr_t func_file_addr = m_sc.function->GetAddressRange ().GetBaseAddress ().GetFileAddress ();
+    const addr_t loclist_base_addr = frame_base.IsLocationList () ? func_file_addr : LLDB_INVALID_ADDRESS;
+    uint32_t reg_num = LLDB_INVALID_REGNUM;
+    uint64_t operand = 0;
+    uint32_t stub_reg_num;
+    switch (frame_base.GetSimpleLocation (loclist_base_addr, m_address.GetFileAddress (), reg_num, operand))
+    {
+        case DWARFExpression::eSimpleLocationRegister:
+            if (!MapRegister ((RegisterKind)frame_base.GetRegisterKind (), reg_num, stub_reg_num))
+                return false;
+            m_expr->AppendRegister (stub_reg_num);
+            return true;
+
+        case DWARFExpression::eSimpleLocationRegisterOffset:
+            if (!MapRegister ((RegisterKind)frame_base.GetRegisterKind (), reg_num, stub_reg_num))
+                return false;
+            m_expr->AppendRegister (stub_reg_num);
+            m_expr->AppendConstant (operand);
+            m_expr->AppendOpcode (AgentExpression::eOpAdd);
+            return true;
+
+        case DWARFExpression::eSimpleLocationCallFrameCFA:
+        {
+            // Find the CFA rule at the breakpoint the way the unwinder
+            // does for the frame that is executing.
+            ObjectFile *objfile = m_sc.module_sp ? m_sc.module_sp->GetObjectFile () : NULL;
+            if (objfile == NULL)
+                return SetError ("no unwind information at the breakpoint");
+            SymbolContext sc (m_sc);
+            FuncUnwindersSP func_unwinders_sp (objfile->GetUnwindTable ().GetFuncUnwindersContainingAddress (m_address, sc));
+            const int func_offset = m_address.GetFileAddress () - func_file_addr;
+            UnwindPlanSP unwind_plan_sp;
+            if (func_unwinders_sp)
+                unwind_plan_sp = func_unwinders_sp->GetUnwindPlanAtNonCallSite (m_thread.GetProcess ()->GetTarget (), m_thread, func_offset);
+            UnwindPlan::RowSP row_sp;
+            if (unwind_plan_sp)
+                row_sp = unwind_plan_sp->GetRowForFunctionOffset (func_offset);
+            if (!row_sp || !row_sp->GetCFAValue ().IsRegisterPlusOffset ())
+                return SetError ("no simple CFA rule at the breakpoint");
+            if (!MapRegister (unwind_plan_sp->GetRegisterKind (), row_sp->GetCFAValue ().GetRegisterNumber (), stub_reg_num))
+                return false;
+            m_expr->AppendRegister (stub_reg_num);
+            m_expr->AppendConstant (static_cast<int64_t> (row_sp->GetCFAValue ().GetOffset ()));
+            m_expr->AppendOpcode (AgentExpression::eOpAdd);
+            return true;
+        }
+
+        default:
+            break;
+    }
+    return SetError ("the frame base is too complex to compute in the stub");
+}
+
+bool
+BreakpointConditionCompiler::EmitVariable (const char *name, OperandType &type)
+{
+    ClangASTType clang_type;
+    uint32_t stub_reg_num;
+    if (!EmitVariableLocation (name, clang_type, stub_reg_num))
+        return false;
+    if (stub_reg_num != LLDB_INVALID_REGNUM)
+    {
+        m_expr->AppendRegister (stub_reg_num);
+        return EmitLoad (clang_type, true, type);
+    }
+    return EmitLoad (clang_type, false, type);
+}
+
+bool
+BreakpointConditionCompiler::EmitVariableLocation (const char *name, ClangASTType &clang_type, uint32_t &stub_reg_num)
+{
+    stub_reg_num = LLDB_INVALID_REGNUM;
+    const ConstString var_name (name);
+    VariableSP var_sp;
+
+    // Locals and arguments in scope at the breakpoint, innermost first.
+    if (m_sc.block)
+    {
+        VariableList variables;
+        m_sc.block->AppendVariables (true, true, true, &variables);
+        const size_t num_variables = variables.GetSize ();
+        for (size_t i = 0; i < num_variables && !var_sp; ++i)
+        {
+            VariableSP candidate_sp (variables.GetVariableAtIndex (i));
+            if (candidate_sp->GetName () == var_name && candidate_sp->LocationIsValidForAddress (m_address))
+                var_sp = candidate_sp;
+        }
+    }
+    if (!var_sp && m_sc.comp_unit)
+    {
+        VariableListSP globals_sp (m_sc.comp_unit->GetVariableList (true));
+        if (globals_sp)
+            var_sp = globals_sp->FindVariable (var_name);
+    }
+    if (!var_sp && m_sc.module_sp)
+    {
+        VariableList globals;
+        if (m_sc.module_sp->FindGlobalVariables (var_name, NULL, true, 1, globals) > 0)
+            var_sp = globals.GetVariableAtIndex (0);
+    }
+    if (!var_sp || var_sp->GetType () == NULL)
+        return SetError ("no variable named '%s' at the breakpoint", name);
+
+    DWARFExpression &location = var_sp->LocationExpression ();
+    addr_t loclist_base_addr = LLDB_INVALID_ADDRESS;
+    if (location.IsLocationList ())
+    {
+        if (m_sc.function == NULL)
+            return SetError ("no function at the breakpoint");
+        loclist_base_addr = m_sc.function->GetAddressRange ().GetBaseAddress ().GetFileAddress ();
+    }
+
+    clang_type = var_sp->GetType ()->GetClangFullType ();
+    uint32_t reg_num = LLDB_INVALID_REGNUM;
+    uint64_t operand = 0;
+    switch (location.GetSimpleLocation (loclist_base_addr, m_address.GetFileAddress (), reg_num, operand))
+    {
+        case DWARFExpression::eSimpleLocationAddress:
+        {
+            Address so_addr;
+            Target &target = m_thread.GetProcess ()->GetTarget ();
+            if (!m_sc.module_sp || !m_sc.module_sp->ResolveFileAddress (operand, so_addr) ||
+                so_addr.GetLoadAddress (&target) == LLDB_INVALID_ADDRESS)
+                return SetError ("'%s' isn't loaded", name);
+            m_expr->AppendConstant (so_addr.GetLoadAddress (&target));
+            return true;
+        }
+
+        case DWARFExpression::eSimpleLocationRegister:
+            return MapRegister ((RegisterKind)location.GetRegisterKind (), reg_num, stub_reg_num);
+
+        case DWARFExpression::eSimpleLocationRegisterOffset:
+        {
+            uint32_t base_reg_num;
+            if (!MapRegister ((RegisterKind)location.GetRegisterKind (), reg_num, base_reg_num))
+                return false;
+            m_expr->AppendRegister (base_reg_num);
+            m_expr->AppendConstant (operand);
+            m_expr->AppendOpcode (AgentExpression::eOpAdd);
+            return true;
+        }
+
+        case DWARFExpression::eSimpleLocationFrameBaseOffset:
+            if (!EmitFrameBase ())
+                return false;
+            m_expr->AppendConstant (operand);
+            m_expr->AppendOpcode (AgentExpression::eOpAdd);
+            return true;
+
+        default:
+            break;
+    }
+    return SetError ("the location of '%s' is too complex to compute in the stub", name);
+}
+
+bool
+BreakpointConditionCompiler::EmitLoad (const ClangASTType &clang_type, bool from_register, OperandType &type)
+{
+    const ClangASTType canonical_type (clang_type.GetCanonicalType ());
+    const uint32_t type_info = canonical_type.GetTypeInfo ();
+    const bool is_pointer = (type_info & eTypeIsPointer) != 0;
+    if (!is_pointer && (type_info & eTypeIsInteger) == 0)
+        return SetError ("only integer and pointer values can be used in the stub");
+
+    const uint64_t byte_size = canonical_type.GetByteSize (NULL);
+    if (byte_size == 0 || byte_size > 8)
+        return SetError ("values of %" PRIu64 " bytes can't be used in the stub", byte_size);
+    if (!from_register && !m_expr->AppendReference (byte_size))
+        return SetError ("values of %" PRIu64 " bytes can't be used in the stub", byte_size);
+
+    // Memory reads are zero extended and registers may hold more than
+    // the value, so bring the value to its 64 bit form.
+    const bool is_signed = !is_pointer && (type_info & eTypeIsSigned) != 0;
+    if (byte_size < 8 && (from_register || is_signed))
+        m_expr->AppendExtend (is_signed, byte_size * 8);
+
+    type = OperandType ();
+    if (byte_size >= 4)
+    {
+        type.byte_size = byte_size;
+        type.is_signed = is_signed;
+    }
+    if (is_pointer)
+        type.pointee_type = canonical_type.GetPointeeType ();
+    return true;
+}
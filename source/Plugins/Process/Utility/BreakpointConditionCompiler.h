@@ -0,0 +1,177 @@
+//===-- BreakpointConditionCompiler.h ---------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_BreakpointConditionCompiler_h_
+#define liblldb_BreakpointConditionCompiler_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+#include "lldb/Symbol/ClangASTType.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "AgentExpression.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class BreakpointConditionCompiler BreakpointConditionCompiler.h "Plugins/Process/Utility/BreakpointConditionCompiler.h"
+/// @brief Translates simple breakpoint conditions and tracepoint collect
+/// items into an AgentExpression.
+///
+/// Only conditions built from integer and pointer variables, registers
+/// ("$name"), integer literals, dereferences and the C arithmetic,
+/// comparison and logical operators are handled, with the C integer
+/// promotions. Variables must be in memory or registers at the
+/// breakpoint address in a way that doesn't need the DWARF expression
+/// interpreter. Anything else fails to compile and the condition is
+/// left to the expression parser when the breakpoint is hit.
+//----------------------------------------------------------------------
+class BreakpointConditionCompiler
+{
+public:
+    //------------------------------------------------------------------
+    /// @param[in] thread
+    ///     A thread of the process, used to map register numbers to the
+    ///     numbers the stub uses and to find the unwind information.
+    ///
+    /// @param[in] address
+    ///     The address of the breakpoint.
+    //------------------------------------------------------------------
+    BreakpointConditionCompiler (Thread &thread, const Address &address);
+
+    // The most bytes of memory one tracepoint item can collect.
+    static const uint32_t kMaxCollectSize = 4096;
+
+    Error
+    Compile (const char *condition, AgentExpression &expr);
+
+    //------------------------------------------------------------------
+    /// Translate a tracepoint collect item.
+    ///
+    /// @param[in] item
+    ///     "$name" for a register, the name of a variable, or
+    ///     "<address>@<byte-size>" with an address in the syntax of the
+    ///     conditions for memory.
+    ///
+    /// @param[out] reg_num
+    ///     The register to collect if \a address_expr is left empty.
+    ///
+    /// @param[out] address_expr
+    ///     Computes the address of the memory to collect.
+    ///
+    /// @param[out] byte_size
+    ///     The number of bytes that get collected.
+    //------------------------------------------------------------------
+    Error
+    CompileCollect (const char *item, uint32_t &reg_num, AgentExpression &address_expr, uint32_t &byte_size);
+
+private:
+    // The type of a value on the expression stack. Values are kept sign
+    // or zero extended to 64 bits according to their type, and have
+    // already gone through the integer promotions so they are 4 or 8
+    // bytes.
+    struct OperandType
+    {
+        OperandType () :
+            is_signed (true),
+            byte_size (4),
+            pointee_type ()
+        {
+        }
+
+        bool is_signed;
+        uint32_t byte_size;
+        ClangASTType pointee_type;  // Valid if the value is a pointer
+    };
+
+    enum TokenKind
+    {
+        eTokenEnd,
+        eTokenNumber,
+        eTokenIdentifier,
+        eTokenRegister,
+        eTokenOperator,
+        eTokenInvalid
+    };
+
+    void
+    NextToken ();
+
+    bool
+    IsOperator (const char *op) const
+    {
+        return m_token_kind == eTokenOperator && m_token == op;
+    }
+
+    bool
+    ParseBinary (int min_precedence, OperandType &type);
+
+    bool
+    ParseUnary (OperandType &type);
+
+    bool
+    ParsePrimary (OperandType &type);
+
+    bool
+    EmitVariable (const char *name, OperandType &type);
+
+    // Emits the address of a variable in memory, or sets "stub_reg_num"
+    // to the register that holds it without emitting anything.
+    bool
+    EmitVariableLocation (const char *name, ClangASTType &clang_type, uint32_t &stub_reg_num);
+
+    bool
+    EmitRegister (const char *name, OperandType &type);
+
+    bool
+    EmitFrameBase ();
+
+    bool
+    EmitLoad (const ClangASTType &clang_type, bool from_register, OperandType &type);
+
+    bool
+    MapRegister (lldb::RegisterKind kind, uint32_t reg_num, uint32_t &stub_reg_num);
+
+    void
+    EmitConversion (const OperandType &from, const OperandType &to);
+
+    static OperandType
+    GetCommonType (const OperandType &lhs, const OperandType &rhs);
+
+    void
+    EmitNormalize (const OperandType &type);
+
+    void
+    EmitEnd ();
+
+    bool
+    SetError (const char *format, ...) __attribute__ ((format (printf, 2, 3)));
+
+    Thread &m_thread;
+    Address m_address;
+    SymbolContext m_sc;
+    AgentExpression *m_expr;
+    Error m_error;
+
+    const char *m_pos;
+    TokenKind m_token_kind;
+    std::string m_token;
+    uint64_t m_token_value;
+    OperandType m_token_type;   // The type of a number token
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_BreakpointConditionCompiler_h_
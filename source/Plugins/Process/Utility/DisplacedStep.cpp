@@ -0,0 +1,679 @@
+//===-- DisplacedStep.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DisplacedStep.h"
+
+// C Includes
+#include <assert.h>
+#include <stdio.h>
+#include <string.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "InstructionUtils.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    //------------------------------------------------------------------
+    // The layout of an x86-64 instruction, as much of it as is needed to
+    // find its length and any RIP-relative displacement or relative
+    // branch target in it.
+    //------------------------------------------------------------------
+    struct X86Instruction
+    {
+        size_t length;
+        bool operand_size_prefix;   // 0x66
+        bool address_size_prefix;   // 0x67
+        bool rex_w;
+        bool vex;                   // VEX or EVEX encoded
+        int map;                    // 0: one byte, 1: 0F, 2: 0F 38, 3: 0F 3A
+        uint8_t opcode;
+        bool has_modrm;
+        uint8_t modrm;
+        size_t disp_offset;
+        size_t disp_size;
+        bool rip_relative;
+        size_t imm_offset;
+        size_t imm_size;
+    };
+
+    bool
+    IsInvalidOneByteOpcode (uint8_t op)
+    {
+        switch (op)
+        {
+        case 0x06: case 0x07: case 0x0e: case 0x16: case 0x17: case 0x1e:
+        case 0x1f: case 0x27: case 0x2f: case 0x37: case 0x3f: case 0x60:
+        case 0x61: case 0x82: case 0x9a: case 0xce: case 0xd4: case 0xd5:
+        case 0xd6: case 0xea:
+            return true;
+        }
+        return false;
+    }
+
+    bool
+    OneByteOpcodeHasModRM (uint8_t op)
+    {
+        if (op < 0x40)
+            return (op & 7) < 4;
+        switch (op)
+        {
+        case 0x63: case 0x69: case 0x6b:
+        case 0xc0: case 0xc1: case 0xc6: case 0xc7:
+        case 0xd0: case 0xd1: case 0xd2: case 0xd3:
+        case 0xf6: case 0xf7: case 0xfe: case 0xff:
+            return true;
+        }
+        return (op >= 0x80 && op <= 0x8f) || (op >= 0xd8 && op <= 0xdf);
+    }
+
+    size_t
+    OneByteOpcodeImmediateSize (const X86Instruction &insn)
+    {
+        const size_t imm_z = insn.operand_size_prefix ? 2 : 4;
+        const uint8_t op = insn.opcode;
+        if (op < 0x40)
+        {
+            if ((op & 7) == 4)
+                return 1;
+            if ((op & 7) == 5)
+                return imm_z;
+            return 0;
+        }
+        if ((op >= 0x70 && op <= 0x7f) || (op >= 0xb0 && op <= 0xb7) || (op >= 0xe0 && op <= 0xe7))
+            return 1;
+        if (op >= 0xa0 && op <= 0xa3)
+            return insn.address_size_prefix ? 4 : 8;
+        if (op >= 0xb8 && op <= 0xbf)
+            return insn.rex_w ? 8 : imm_z;
+        switch (op)
+        {
+        case 0x6a: case 0x6b: case 0x80: case 0x83: case 0xa8: case 0xc0:
+        case 0xc1: case 0xc6: case 0xcd: case 0xeb:
+            return 1;
+        case 0xc2: case 0xca:
+            return 2;
+        case 0xc8:
+            return 3;
+        case 0x68: case 0x69: case 0x81: case 0xa9: case 0xc7:
+            return imm_z;
+        case 0xe8: case 0xe9:
+            return 4;
+        case 0xf6:
+        case 0xf7:
+            // Only TEST has an immediate.
+            if (((insn.modrm >> 3) & 7) < 2)
+                return op == 0xf6 ? 1 : imm_z;
+            return 0;
+        }
+        return 0;
+    }
+
+    bool
+    IsInvalidTwoByteOpcode (uint8_t op)
+    {
+        switch (op)
+        {
+        case 0x04: case 0x0a: case 0x0c: case 0x0f: case 0x24: case 0x25:
+        case 0x26: case 0x27: case 0x36: case 0x39: case 0x3b: case 0x3c:
+        case 0x3d: case 0x3e: case 0x3f:
+            return true;
+        }
+        return false;
+    }
+
+    bool
+    TwoByteOpcodeHasModRM (uint8_t op)
+    {
+        if ((op >= 0x30 && op <= 0x37) || (op >= 0x80 && op <= 0x8f) || (op >= 0xc8 && op <= 0xcf))
+            return false;
+        switch (op)
+        {
+        case 0x05: case 0x06: case 0x07: case 0x08: case 0x09: case 0x0b:
+        case 0x0e: case 0x77: case 0xa0: case 0xa1: case 0xa2: case 0xa8:
+        case 0xa9: case 0xaa:
+            return false;
+        }
+        return true;
+    }
+
+    size_t
+    TwoByteOpcodeImmediateSize (uint8_t op, bool vex)
+    {
+        if (op >= 0x70 && op <= 0x73)
+            return 1;
+        switch (op)
+        {
+        case 0xc2: case 0xc4: case 0xc5: case 0xc6:
+            return 1;
+        case 0xa4: case 0xac: case 0xba:
+            return vex ? 0 : 1;
+        }
+        if (op >= 0x80 && op <= 0x8f && !vex)
+            return 4;
+        return 0;
+    }
+
+    Error
+    DecodeX86Instruction (const uint8_t *bytes, size_t size, X86Instruction &insn)
+    {
+        memset (&insn, 0, sizeof insn);
+
+        size_t i = 0;
+        for (; i < size; ++i)
+        {
+            const uint8_t b = bytes[i];
+            if (b == 0x66)
+                insn.operand_size_prefix = true;
+            else if (b == 0x67)
+                insn.address_size_prefix = true;
+            else if (b != 0xf0 && b != 0xf2 && b != 0xf3 && b != 0x2e && b != 0x36 &&
+                     b != 0x3e && b != 0x26 && b != 0x64 && b != 0x65)
+                break;
+        }
+        if (i < size && (bytes[i] & 0xf0) == 0x40)
+        {
+            insn.rex_w = (bytes[i] & 0x08) != 0;
+            ++i;
+        }
+
+        if (i >= size)
+            return Error ("instruction is truncated");
+        const uint8_t first = bytes[i++];
+        if (first == 0xc4 || first == 0xc5 || first == 0x62)
+        {
+            // VEX and EVEX. In 64-bit mode these bytes are always prefixes.
+            insn.vex = true;
+            const size_t payload_size = first == 0xc5 ? 1 : (first == 0xc4 ? 2 : 3);
+            if (i + payload_size >= size)
+                return Error ("instruction is truncated");
+            if (first == 0xc5)
+                insn.map = 1;
+            else if (first == 0xc4)
+            {
+                insn.map = bytes[i] & 0x1f;
+                insn.rex_w = (bytes[i + 1] & 0x80) != 0;
+            }
+            else
+                insn.map = bytes[i] & 0x07;
+            i += payload_size;
+
+            if (insn.map < 1 || insn.map > 3)
+                return Error ("unsupported opcode map %d", insn.map);
+            insn.opcode = bytes[i++];
+            // VZEROUPPER and VZEROALL are the only VEX instructions without
+            // a ModRM byte.
+            insn.has_modrm = !(first != 0x62 && insn.map == 1 && insn.opcode == 0x77);
+            if (insn.map == 3)
+                insn.imm_size = 1;
+            else if (insn.map == 1)
+                insn.imm_size = TwoByteOpcodeImmediateSize (insn.opcode, true);
+        }
+        else if (first == 0x0f)
+        {
+            if (i >= size)
+                return Error ("instruction is truncated");
+            const uint8_t second = bytes[i++];
+            if (second == 0x38 || second == 0x3a)
+            {
+                insn.map = second == 0x38 ? 2 : 3;
+                if (i >= size)
+                    return Error ("instruction is truncated");
+                insn.opcode = bytes[i++];
+                insn.has_modrm = true;
+                insn.imm_size = insn.map == 3 ? 1 : 0;
+            }
+            else
+            {
+                if (IsInvalidTwoByteOpcode (second))
+                    return Error ("unsupported opcode 0x0f 0x%2.2x", second);
+                insn.map = 1;
+                insn.opcode = second;
+                insn.has_modrm = TwoByteOpcodeHasModRM (second);
+                insn.imm_size = TwoByteOpcodeImmediateSize (second, false);
+            }
+        }
+        else
+        {
+            if (IsInvalidOneByteOpcode (first))
+                return Error ("invalid opcode 0x%2.2x", first);
+            // 0x8f with a non-zero reg field is an XOP prefix.
+            if (first == 0x8f && i < size && (bytes[i] & 0x38) != 0)
+                return Error ("XOP instructions are not supported");
+            insn.map = 0;
+            insn.opcode = first;
+            insn.has_modrm = OneByteOpcodeHasModRM (first);
+        }
+
+        if (insn.has_modrm)
+        {
+            if (i >= size)
+                return Error ("instruction is truncated");
+            insn.modrm = bytes[i++];
+            const uint8_t mod = insn.modrm >> 6;
+            const uint8_t rm = insn.modrm & 7;
+            if (mod != 3)
+            {
+                if (rm == 4)
+                {
+                    if (i >= size)
+                        return Error ("instruction is truncated");
+                    const uint8_t sib = bytes[i++];
+                    if (mod == 0 && (sib & 7) == 5)
+                        insn.disp_size = 4;
+                }
+                else if (mod == 0 && rm == 5)
+                {
+                    insn.disp_size = 4;
+                    insn.rip_relative = true;
+                }
+                if (mod == 1)
+                    insn.disp_size = 1;
+                else if (mod == 2)
+                    insn.disp_size = 4;
+            }
+            insn.disp_offset = i;
+            i += insn.disp_size;
+        }
+
+        if (insn.map == 0)
+            insn.imm_size = OneByteOpcodeImmediateSize (insn);
+        insn.imm_offset = i;
+        i += insn.imm_size;
+
+        if (i > size)
+            return Error ("instruction is truncated");
+        if (i > DisplacedStep::kMaxInstructionSize)
+            return Error ("instruction is longer than %u bytes", (unsigned)DisplacedStep::kMaxInstructionSize);
+        insn.length = i;
+        return Error ();
+    }
+
+    int64_t
+    ReadSignedLittleEndian (const uint8_t *bytes, size_t size)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < size; ++i)
+            value |= (uint64_t)bytes[i] << (8 * i);
+        const unsigned shift = 64 - 8 * size;
+        return (int64_t)(value << shift) >> shift;
+    }
+
+    bool
+    EvaluateX86Condition (uint8_t cc, uint64_t rflags)
+    {
+        const bool cf = (rflags >> 0) & 1;
+        const bool pf = (rflags >> 2) & 1;
+        const bool zf = (rflags >> 6) & 1;
+        const bool sf = (rflags >> 7) & 1;
+        const bool of = (rflags >> 11) & 1;
+
+        bool result = false;
+        switch (cc >> 1)
+        {
+        case 0: result = of; break;
+        case 1: result = cf; break;
+        case 2: result = zf; break;
+        case 3: result = cf || zf; break;
+        case 4: result = sf; break;
+        case 5: result = pf; break;
+        case 6: result = sf != of; break;
+        case 7: result = zf || sf != of; break;
+        }
+        return (cc & 1) ? !result : result;
+    }
+
+    bool
+    EvaluateARM64Condition (uint32_t cond, uint64_t cpsr)
+    {
+        const bool n = (cpsr >> 31) & 1;
+        const bool z = (cpsr >> 30) & 1;
+        const bool c = (cpsr >> 29) & 1;
+        const bool v = (cpsr >> 28) & 1;
+
+        bool result = true;
+        switch (cond >> 1)
+        {
+        case 0: result = z; break;
+        case 1: result = c; break;
+        case 2: result = n; break;
+        case 3: result = v; break;
+        case 4: result = c && !z; break;
+        case 5: result = n == v; break;
+        case 6: result = !z && n == v; break;
+        case 7: return true; // AL and NV
+        }
+        return (cond & 1) ? !result : result;
+    }
+
+    bool
+    ReadARM64Register (const DisplacedStep::ReadRegisterCallback &read_register, uint32_t reg, uint64_t &value)
+    {
+        // Register 31 is the zero register in the instructions that we
+        // read registers for.
+        if (reg == 31)
+        {
+            value = 0;
+            return true;
+        }
+        char reg_name[8];
+        ::snprintf (reg_name, sizeof reg_name, "x%u", reg);
+        return read_register (reg_name, value);
+    }
+}
+
+DisplacedStep::DisplacedStep () :
+    m_kind (eKindNone),
+    m_machine (llvm::Triple::UnknownArch),
+    m_insn_addr (LLDB_INVALID_ADDRESS),
+    m_insn_size (0),
+    m_scratch_addr (LLDB_INVALID_ADDRESS),
+    m_slot_bytes (),
+    m_is_indirect_call (false),
+    m_emulated ()
+{
+}
+
+bool
+DisplacedStep::SupportsArchitecture (const ArchSpec &arch)
+{
+    return arch.GetMachine () == llvm::Triple::x86_64 || arch.GetMachine () == llvm::Triple::aarch64;
+}
+
+const char *
+DisplacedStep::GetPCRegisterName () const
+{
+    return m_machine == llvm::Triple::x86_64 ? "rip" : "pc";
+}
+
+Error
+DisplacedStep::Prepare (const ArchSpec &arch,
+                        lldb::addr_t insn_addr,
+                        const uint8_t *insn_bytes,
+                        size_t insn_bytes_size,
+                        lldb::addr_t scratch_addr,
+                        const ReadRegisterCallback &read_register)
+{
+    m_kind = eKindNone;
+    m_machine = arch.GetMachine ();
+    m_insn_addr = insn_addr;
+    m_insn_size = 0;
+    m_scratch_addr = scratch_addr;
+    m_slot_bytes.clear ();
+    m_is_indirect_call = false;
+    m_emulated = Fixup ();
+
+    Error error;
+    switch (m_machine)
+    {
+    case llvm::Triple::x86_64:
+        error = PrepareX86_64 (insn_bytes, insn_bytes_size, read_register);
+        break;
+    case llvm::Triple::aarch64:
+        error = PrepareARM64 (insn_bytes, insn_bytes_size, read_register);
+        break;
+    default:
+        error.SetErrorStringWithFormat ("displaced stepping is not supported for %s", arch.GetArchitectureName ());
+        break;
+    }
+
+    if (error.Fail ())
+        m_kind = eKindNone;
+    assert (error.Fail () || m_slot_bytes.size () <= kSlotSize);
+    return error;
+}
+
+Error
+DisplacedStep::PrepareX86_64 (const uint8_t *insn_bytes, size_t insn_bytes_size, const ReadRegisterCallback &read_register)
+{
+    X86Instruction insn;
+    Error error = DecodeX86Instruction (insn_bytes, insn_bytes_size, insn);
+    if (error.Fail ())
+        return error;
+    m_insn_size = insn.length;
+
+    if (insn.map == 0 && (insn.opcode == 0xcc || insn.opcode == 0xcd || insn.opcode == 0xf1))
+        return Error ("software interrupts are stepped in place");
+    if (insn.map == 1 && !insn.vex && (insn.opcode == 0x05 || insn.opcode == 0x34))
+        return Error ("system calls are stepped in place");
+    if (insn.map == 0 && insn.opcode == 0xff)
+    {
+        const uint8_t reg = (insn.modrm >> 3) & 7;
+        if (reg == 3 || reg == 5)
+            return Error ("far branches are stepped in place");
+        m_is_indirect_call = reg == 2;
+    }
+
+    const bool is_relative_branch = insn.map == 0 ?
+        ((insn.opcode >= 0x70 && insn.opcode <= 0x7f) || (insn.opcode >= 0xe0 && insn.opcode <= 0xe3) ||
+         insn.opcode == 0xe8 || insn.opcode == 0xe9 || insn.opcode == 0xeb) :
+        (insn.map == 1 && !insn.vex && insn.opcode >= 0x80 && insn.opcode <= 0x8f);
+
+    if (is_relative_branch)
+    {
+        if (insn.operand_size_prefix)
+            return Error ("branches with a 16-bit operand size are stepped in place");
+
+        const addr_t next_addr = m_insn_addr + insn.length;
+        const addr_t target_addr = next_addr + ReadSignedLittleEndian (insn_bytes + insn.imm_offset, insn.imm_size);
+        bool taken = true;
+
+        if (insn.map == 1 || (insn.opcode >= 0x70 && insn.opcode <= 0x7f))
+        {
+            uint64_t rflags = 0;
+            if (!read_register ("rflags", rflags))
+                return Error ("failed to read rflags");
+            taken = EvaluateX86Condition (insn.opcode & 0x0f, rflags);
+        }
+        else if (insn.opcode >= 0xe0 && insn.opcode <= 0xe3)
+        {
+            if (insn.address_size_prefix)
+                return Error ("loops with a 32-bit address size are stepped in place");
+            uint64_t rcx = 0;
+            if (!read_register ("rcx", rcx))
+                return Error ("failed to read rcx");
+            if (insn.opcode == 0xe3)
+                taken = rcx == 0;
+            else
+            {
+                --rcx;
+                m_emulated.registers.push_back (std::make_pair ("rcx", rcx));
+                taken = rcx != 0;
+                if (insn.opcode != 0xe2)
+                {
+                    uint64_t rflags = 0;
+                    if (!read_register ("rflags", rflags))
+                        return Error ("failed to read rflags");
+                    const bool zf = (rflags >> 6) & 1;
+                    taken = taken && (insn.opcode == 0xe1 ? zf : !zf);
+                }
+            }
+        }
+        else if (insn.opcode == 0xe8)
+        {
+            uint64_t rsp = 0;
+            if (!read_register ("rsp", rsp))
+                return Error ("failed to read rsp");
+            rsp -= 8;
+            m_emulated.registers.push_back (std::make_pair ("rsp", rsp));
+            m_emulated.memory_addr = rsp;
+            m_emulated.memory_value = next_addr;
+        }
+
+        m_emulated.registers.push_back (std::make_pair (GetPCRegisterName (), taken ? target_addr : next_addr));
+        m_slot_bytes.push_back (0x90); // nop
+        m_kind = eKindEmulated;
+        return Error ();
+    }
+
+    m_slot_bytes.assign (insn_bytes, insn_bytes + insn.length);
+    if (insn.rip_relative)
+    {
+        if (insn.address_size_prefix)
+            return Error ("EIP-relative operands are stepped in place");
+
+        // Keep the operand pointing at the same address when the
+        // instruction executes from the slot.
+        const int64_t disp = ReadSignedLittleEndian (insn_bytes + insn.disp_offset, 4);
+        const addr_t operand_addr = m_insn_addr + insn.length + disp;
+        const int64_t new_disp = (int64_t)(operand_addr - (m_scratch_addr + insn.length));
+        if (new_disp < INT32_MIN || new_disp > INT32_MAX)
+            return Error ("RIP-relative operand is out of range of the scratch area");
+        for (size_t i = 0; i < 4; ++i)
+            m_slot_bytes[insn.disp_offset + i] = (uint8_t)((uint64_t)new_disp >> (8 * i));
+    }
+    m_kind = eKindCopy;
+    return Error ();
+}
+
+Error
+DisplacedStep::PrepareARM64 (const uint8_t *insn_bytes, size_t insn_bytes_size, const ReadRegisterCallback &read_register)
+{
+    if (insn_bytes_size < 4)
+        return Error ("instruction is truncated");
+
+    // A64 instructions are always little endian.
+    const uint32_t opcode = (uint32_t)insn_bytes[0] | (uint32_t)insn_bytes[1] << 8 |
+                            (uint32_t)insn_bytes[2] << 16 | (uint32_t)insn_bytes[3] << 24;
+    m_insn_size = 4;
+    const addr_t next_addr = m_insn_addr + 4;
+
+    if ((opcode & 0xff000000) == 0xd4000000)
+        return Error ("exception generating instructions are stepped in place");
+    if ((opcode & 0x3b000000) == 0x18000000)
+        return Error ("literal loads are stepped in place");
+
+    bool is_emulated = true;
+    bool taken = false;
+    int64_t offset = 0;
+    if ((opcode & 0x7c000000) == 0x14000000)
+    {
+        // B, BL
+        offset = SignedBits (opcode, 25, 0) * 4;
+        taken = true;
+        if (opcode & 0x80000000)
+            m_emulated.registers.push_back (std::make_pair ("lr", next_addr));
+    }
+    else if ((opcode & 0xff000010) == 0x54000000)
+    {
+        // B.cond
+        uint64_t cpsr = 0;
+        if (!read_register ("cpsr", cpsr))
+            return Error ("failed to read cpsr");
+        offset = SignedBits (opcode, 23, 5) * 4;
+        taken = EvaluateARM64Condition (Bits32 (opcode, 3, 0), cpsr);
+    }
+    else if ((opcode & 0x7e000000) == 0x34000000)
+    {
+        // CBZ, CBNZ
+        uint64_t value = 0;
+        if (!ReadARM64Register (read_register, Bits32 (opcode, 4, 0), value))
+            return Error ("failed to read x%u", Bits32 (opcode, 4, 0));
+        if (Bit32 (opcode, 31) == 0)
+            value &= 0xffffffffull;
+        offset = SignedBits (opcode, 23, 5) * 4;
+        taken = Bit32 (opcode, 24) ? value != 0 : value == 0;
+    }
+    else if ((opcode & 0x7e000000) == 0x36000000)
+    {
+        // TBZ, TBNZ
+        uint64_t value = 0;
+        if (!ReadARM64Register (read_register, Bits32 (opcode, 4, 0), value))
+            return Error ("failed to read x%u", Bits32 (opcode, 4, 0));
+        const uint32_t bit = Bit32 (opcode, 31) << 5 | Bits32 (opcode, 23, 19);
+        const bool is_set = (value >> bit) & 1;
+        offset = SignedBits (opcode, 18, 5) * 4;
+        taken = Bit32 (opcode, 24) ? is_set : !is_set;
+    }
+    else if ((opcode & 0x1f000000) == 0x10000000)
+    {
+        // ADR, ADRP
+        const int64_t imm = SignedBits (opcode, 23, 5) * 4 + Bits32 (opcode, 30, 29);
+        const uint32_t rd = Bits32 (opcode, 4, 0);
+        const addr_t value = (opcode & 0x80000000) ?
+            (m_insn_addr & ~(addr_t)0xfff) + ((uint64_t)imm << 12) :
+            m_insn_addr + imm;
+        if (rd != 31)
+        {
+            char reg_name[8];
+            ::snprintf (reg_name, sizeof reg_name, "x%u", rd);
+            m_emulated.registers.push_back (std::make_pair (reg_name, value));
+        }
+    }
+    else
+    {
+        is_emulated = false;
+        // BLR leaves a return address that points into the slot.
+        m_is_indirect_call = (opcode & 0xfffffc1f) == 0xd63f0000;
+    }
+
+    if (is_emulated)
+    {
+        m_emulated.registers.push_back (std::make_pair (GetPCRegisterName (), taken ? m_insn_addr + offset : next_addr));
+        static const uint8_t g_nop[] = { 0x1f, 0x20, 0x03, 0xd5 };
+        m_slot_bytes.assign (g_nop, g_nop + sizeof g_nop);
+        m_kind = eKindEmulated;
+    }
+    else
+    {
+        m_slot_bytes.assign (insn_bytes, insn_bytes + 4);
+        m_kind = eKindCopy;
+    }
+    return Error ();
+}
+
+void
+DisplacedStep::Finish (lldb::addr_t stop_pc,
+                       const ReadRegisterCallback &read_register,
+                       Fixup &fixup) const
+{
+    fixup = Fixup ();
+    const addr_t slot_end = m_scratch_addr + m_slot_bytes.size ();
+
+    // A thread that is still at the start of the slot didn't execute the
+    // instruction, for example because a signal arrived first. Neither did
+    // an emulated instruction unless the no-op after it completed.
+    if (m_kind == eKindNone || stop_pc == m_scratch_addr ||
+        (m_kind == eKindEmulated && stop_pc != slot_end))
+    {
+        fixup.registers.push_back (std::make_pair (GetPCRegisterName (), m_insn_addr));
+        return;
+    }
+
+    if (m_kind == eKindEmulated)
+    {
+        fixup = m_emulated;
+        return;
+    }
+
+    // The copy fell through to the end of the slot. Anything else that
+    // left the slot was an absolute branch, which went to the right place.
+    if (stop_pc > m_scratch_addr && stop_pc <= slot_end)
+        fixup.registers.push_back (std::make_pair (GetPCRegisterName (), m_insn_addr + (stop_pc - m_scratch_addr)));
+
+    if (m_is_indirect_call)
+    {
+        const addr_t return_addr = m_insn_addr + m_insn_size;
+        if (m_machine == llvm::Triple::x86_64)
+        {
+            uint64_t rsp = 0;
+            if (read_register ("rsp", rsp))
+            {
+                fixup.memory_addr = rsp;
+                fixup.memory_value = return_addr;
+            }
+        }
+        else
+            fixup.registers.push_back (std::make_pair ("lr", return_addr));
+    }
+}
@@ -0,0 +1,178 @@
+//===-- DisplacedStep.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_DisplacedStep_h_
+#define liblldb_DisplacedStep_h_
+
+// C Includes
+// C++ Includes
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private {
+
+//----------------------------------------------------------------------
+/// @class DisplacedStep DisplacedStep.h "Plugins/Process/Utility/DisplacedStep.h"
+/// @brief Steps a copy of an instruction at a scratch address.
+///
+/// Stepping a thread over a software breakpoint normally means removing
+/// the trap, stepping with all other threads stopped so that they can't
+/// run past the missing trap, and inserting the trap again. A displaced
+/// step leaves the trap in place: the original instruction is copied to
+/// a scratch slot, the thread steps the copy, and its registers are then
+/// fixed up as if the instruction had executed at its original address.
+///
+/// Instructions that depend on their own address are handled one of two
+/// ways. x86-64 RIP-relative memory operands are rewritten so that they
+/// still refer to the same address from the slot. Relative branches and
+/// calls, and the ARM64 PC-relative address computations, are emulated
+/// up front and a no-op is stepped in the slot instead. Instructions that
+/// can't be handled either way (system calls, which could create a thread
+/// that starts executing in the slot, and ARM64 literal loads) make
+/// Prepare() fail, and the caller has to step them in place.
+///
+/// This class only decides what to do, the caller owns the scratch
+/// memory and applies the results to the thread.
+//----------------------------------------------------------------------
+class DisplacedStep
+{
+public:
+    typedef std::function<bool (const char *reg_name, uint64_t &value)> ReadRegisterCallback;
+
+    //------------------------------------------------------------------
+    /// What has to be written to a thread after it stepped in the slot
+    /// to make it look like it stepped the original instruction.
+    //------------------------------------------------------------------
+    struct Fixup
+    {
+        Fixup () :
+            registers (),
+            memory_addr (LLDB_INVALID_ADDRESS),
+            memory_value (0)
+        {
+        }
+
+        // Register names and their new values. Always includes the PC.
+        std::vector<std::pair<std::string, uint64_t> > registers;
+        // A pointer sized value to store, LLDB_INVALID_ADDRESS if none.
+        lldb::addr_t memory_addr;
+        uint64_t memory_value;
+    };
+
+    // The longest instruction for any supported architecture and the
+    // smallest slot that any instruction can be displaced into.
+    static const size_t kMaxInstructionSize = 15;
+    static const size_t kSlotSize = 16;
+
+    DisplacedStep ();
+
+    //------------------------------------------------------------------
+    /// Returns true if displaced stepping is implemented for \a arch.
+    //------------------------------------------------------------------
+    static bool
+    SupportsArchitecture (const ArchSpec &arch);
+
+    //------------------------------------------------------------------
+    /// Work out how to step the instruction at \a insn_addr from the
+    /// slot at \a scratch_addr.
+    ///
+    /// @param[in] insn_bytes
+    ///     The bytes at \a insn_addr with any breakpoint traps removed.
+    ///     This should be kMaxInstructionSize bytes unless the memory
+    ///     ends sooner.
+    ///
+    /// @param[in] read_register
+    ///     Reads the current value of one of the thread's registers.
+    ///     Used to evaluate the branches that are emulated.
+    ///
+    /// @return
+    ///     An error if the instruction has to be stepped in place.
+    //------------------------------------------------------------------
+    Error
+    Prepare (const ArchSpec &arch,
+             lldb::addr_t insn_addr,
+             const uint8_t *insn_bytes,
+             size_t insn_bytes_size,
+             lldb::addr_t scratch_addr,
+             const ReadRegisterCallback &read_register);
+
+    //------------------------------------------------------------------
+    /// The bytes to write to the slot before stepping. At most
+    /// kSlotSize bytes.
+    //------------------------------------------------------------------
+    const std::vector<uint8_t> &
+    GetSlotBytes () const
+    {
+        return m_slot_bytes;
+    }
+
+    lldb::addr_t
+    GetInstructionAddress () const
+    {
+        return m_insn_addr;
+    }
+
+    lldb::addr_t
+    GetScratchAddress () const
+    {
+        return m_scratch_addr;
+    }
+
+    //------------------------------------------------------------------
+    /// Compute the fixup for a thread that stopped at \a stop_pc after
+    /// it was stepped from the slot. If the thread stopped before the
+    /// instruction executed (for example because a signal arrived) the
+    /// fixup just moves the PC back to the original instruction.
+    //------------------------------------------------------------------
+    void
+    Finish (lldb::addr_t stop_pc,
+            const ReadRegisterCallback &read_register,
+            Fixup &fixup) const;
+
+private:
+    enum Kind
+    {
+        eKindNone,
+        eKindCopy,      // Step a (possibly rewritten) copy of the instruction.
+        eKindEmulated   // The instruction was emulated, step a no-op.
+    };
+
+    Error
+    PrepareX86_64 (const uint8_t *insn_bytes, size_t insn_bytes_size, const ReadRegisterCallback &read_register);
+
+    Error
+    PrepareARM64 (const uint8_t *insn_bytes, size_t insn_bytes_size, const ReadRegisterCallback &read_register);
+
+    const char *
+    GetPCRegisterName () const;
+
+    Kind m_kind;
+    llvm::Triple::ArchType m_machine;
+    lldb::addr_t m_insn_addr;
+    size_t m_insn_size;
+    lldb::addr_t m_scratch_addr;
+    std::vector<uint8_t> m_slot_bytes;
+    // eKindCopy: the instruction is an indirect call whose return address
+    // points into the slot.
+    bool m_is_indirect_call;
+    // eKindEmulated: the state of the thread after the instruction.
+    Fixup m_emulated;
+};
+
+} // namespace lldb_private
+
+#endif // liblldb_DisplacedStep_h_
@@ -15,6 +15,10 @@
 #include <string.h>
 #include <sys/stat.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 // C++ Includes
 // Other libraries and framework includes
 #include "lldb/Core/Log.h"
@@ -32,6 +36,7 @@
 #include "lldb/Host/TimeValue.h"
 #include "lldb/Target/Process.h"
 #include "llvm/ADT/SmallString.h"
+#include "llvm/Support/MathExtras.h"
 
 // Project includes
 #include "ProcessGDBRemoteLog.h"
@@ -77,7 +82,7 @@ GDBRemoteCommunication::History::AddPacket (char packet_char,
 }
 
 void
-GDBRemoteCommunication::History::AddPacket (const std::string &src,
+GDBRemoteCommunication::History::AddPacket (const char *src,
                                             uint32_t src_len,
                                             PacketType type,
                                             uint32_t bytes_transmitted)
@@ -86,7 +91,7 @@ GDBRemoteCommunication::History::AddPacket (const std::string &src,
     if (size > 0)
     {
         const uint32_t idx = GetNextIndex();
-        m_packets[idx].packet.assign (src, 0, src_len);
+        m_packets[idx].packet.assign (src, src_len);
         m_packets[idx].type = type;
         m_packets[idx].bytes_transmitted = bytes_transmitted;
         m_packets[idx].packet_idx = m_total_packet_count;
@@ -157,7 +162,13 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_history (512),
+    m_packet_stats_mutex (Mutex::eMutexTypeNormal),
+    m_packet_stats (),
+    m_last_sent_packet_type (),
+    m_last_sent_packet_time (),
     m_send_acks (true),
+    m_notifications_mutex (Mutex::eMutexTypeNormal),
+    m_notifications (),
     m_listen_url ()
 {
 }
@@ -176,10 +187,22 @@ GDBRemoteCommunication::~GDBRemoteCommunication()
 char
 GDBRemoteCommunication::CalculcateChecksum (const char *payload, size_t payload_length)
 {
-    int checksum = 0;
+    const uint8_t *bytes = (const uint8_t *)payload;
+    uint32_t checksum = 0;
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    // Summing the absolute differences against zero adds up each group of
+    // 8 bytes into a 64 bit lane.
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (; i + 16 <= payload_length; i += 16)
+        sums = _mm_add_epi64 (sums, _mm_sad_epu8 (_mm_loadu_si128 ((const __m128i *)(bytes + i)), zero));
+    checksum = _mm_cvtsi128_si32 (sums) + _mm_cvtsi128_si32 (_mm_unpackhi_epi64 (sums, sums));
+#endif
 
-    for (size_t i = 0; i < payload_length; ++i)
-        checksum += payload[i];
+    for (; i < payload_length; ++i)
+        checksum += bytes[i];
 
     return checksum & 255;
 }
@@ -272,7 +295,8 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
                 log->Printf("<%4" PRIu64 "> send packet: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
         }
 
-        m_history.AddPacket (packet.GetString(), packet_length, History::ePacketTypeSend, bytes_written);
+        m_history.AddPacket (packet_data, packet_length, History::ePacketTypeSend, bytes_written);
+        RecordSentPacket (payload, payload_length, bytes_written);
 
 
         if (bytes_written == packet_length)
@@ -291,11 +315,49 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
     return PacketResult::ErrorSendFailed;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::SendNotificationPacketNoLock (const char *notify_type, const char *payload, size_t payload_length)
+{
+    if (!IsConnected())
+        return PacketResult::ErrorSendFailed;
+
+    StreamString content;
+    content.PutCString (notify_type);
+    content.PutChar (':');
+    content.Write (payload, payload_length);
+
+    StreamString packet(0, 4, eByteOrderBig);
+    packet.PutChar('%');
+    packet.Write (content.GetData(), content.GetSize());
+    packet.PutChar('#');
+    packet.PutHex8(CalculcateChecksum (content.GetData(), content.GetSize()));
+
+    ConnectionStatus status = eConnectionStatusSuccess;
+    const char *packet_data = packet.GetData();
+    const size_t packet_length = packet.GetSize();
+    size_t bytes_written = Write (packet_data, packet_length, status, NULL);
+
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+    if (log)
+        log->Printf("<%4" PRIu64 "> send notification: %.*s", (uint64_t)bytes_written, (int)packet_length, packet_data);
+    m_history.AddPacket (packet_data, packet_length, History::ePacketTypeSend, bytes_written);
+
+    if (bytes_written != packet_length)
+        return PacketResult::ErrorSendFailed;
+    return PacketResult::Success;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunication::GetAck ()
+{
+    return GetAck (GetPacketTimeoutInMicroSeconds ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunication::GetAck (uint32_t timeout_usec)
 {
     StringExtractorGDBRemote packet;
-    PacketResult result = WaitForPacketWithTimeoutMicroSecondsNoLock (packet, GetPacketTimeoutInMicroSeconds (), false);
+    PacketResult result = WaitForPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec, false);
     if (result == PacketResult::Success)
     {
         if (packet.GetResponseType() == StringExtractorGDBRemote::ResponseType::eAck)
@@ -324,15 +386,18 @@ GDBRemoteCommunication::WaitForNotRunningPrivate (const TimeValue *timeout_ptr)
 }
 
 GDBRemoteCommunication::PacketResult
-GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec, bool sync_on_timeout)
+GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &packet, uint32_t timeout_usec, bool sync_on_timeout, bool return_notifications)
 {
     uint8_t buffer[8192];
     Error error;
 
     Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS | GDBR_LOG_VERBOSE));
 
+    if (return_notifications && GetNotification (packet))
+        return PacketResult::Success;
+
     // Check for a packet from our cache first without trying any reading...
-    if (CheckForPacket(NULL, 0, packet) != PacketType::Invalid)
+    if (CheckForReplyPacket(NULL, 0, packet, return_notifications))
         return PacketResult::Success;
 
     bool timed_out = false;
@@ -352,7 +417,7 @@ GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtrac
 
         if (bytes_read > 0)
         {
-            if (CheckForPacket(buffer, bytes_read, packet) != PacketType::Invalid)
+            if (CheckForReplyPacket(buffer, bytes_read, packet, return_notifications))
                 return PacketResult::Success;
         }
         else
@@ -484,6 +549,130 @@ GDBRemoteCommunication::WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtrac
         return PacketResult::ErrorReplyFailed;
 }
 
+//----------------------------------------------------------------------
+// Notifications can arrive at any time, also while we wait for the reply
+// to a packet that has nothing to do with them. Unless the caller wants
+// them, queue them and look at the packet after them.
+//----------------------------------------------------------------------
+bool
+GDBRemoteCommunication::CheckForReplyPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet, bool return_notifications)
+{
+    PacketType packet_type = CheckForPacket (src, src_len, packet);
+    while (packet_type == PacketType::Notify && !return_notifications)
+    {
+        {
+            Mutex::Locker locker (m_notifications_mutex);
+            m_notifications.push_back (packet.GetStringRef ());
+        }
+        BroadcastEvent (eBroadcastBitNotification, NULL);
+        packet_type = CheckForPacket (NULL, 0, packet);
+    }
+    return packet_type != PacketType::Invalid;
+}
+
+bool
+GDBRemoteCommunication::GetNotification (StringExtractorGDBRemote &notification)
+{
+    Mutex::Locker locker (m_notifications_mutex);
+    if (m_notifications.empty ())
+        return false;
+    notification.GetStringRef ().swap (m_notifications.front ());
+    notification.SetFilePos (0);
+    m_notifications.pop_front ();
+    return true;
+}
+
+std::string
+GDBRemoteCommunication::GetPacketStatisticsType (const char *payload, size_t payload_length)
+{
+    if (payload_length == 0)
+        return std::string();
+    // Most packets are identified by their first character. Query and
+    // extension packets like "qSymbol", "vCont" and "jThreadsInfo" are
+    // identified by their name, which ends at the first character that
+    // isn't a letter or an underscore.
+    switch (payload[0])
+    {
+        case 'q':
+        case 'Q':
+        case 'v':
+        case 'j':
+        case '_':
+            {
+                size_t len = 1;
+                while (len < payload_length && (isalpha(payload[len]) || payload[len] == '_'))
+                    ++len;
+                return std::string (payload, len);
+            }
+        default:
+            return std::string (payload, 1);
+    }
+}
+
+void
+GDBRemoteCommunication::RecordSentPacket (const char *payload, size_t payload_length, size_t bytes_written)
+{
+    std::string packet_type (GetPacketStatisticsType (payload, payload_length));
+    Mutex::Locker locker (m_packet_stats_mutex);
+    PacketStatistics &stats = m_packet_stats[packet_type];
+    ++stats.num_sent;
+    stats.bytes_sent += bytes_written;
+    m_last_sent_packet_type.swap (packet_type);
+    m_last_sent_packet_time = TimeValue::Now();
+}
+
+void
+GDBRemoteCommunication::RecordReceivedPacket (size_t bytes_read)
+{
+    Mutex::Locker locker (m_packet_stats_mutex);
+    // Responses are attributed to the last packet that was sent. Only the
+    // first packet received after a send is timed, so extra packets like
+    // asynchronous stop replies are counted but don't skew the times.
+    PacketStatistics &stats = m_packet_stats[m_last_sent_packet_type];
+    ++stats.num_received;
+    stats.bytes_received += bytes_read;
+    if (m_last_sent_packet_time.IsValid())
+    {
+        const uint64_t response_time = TimeValue::Now().GetAsNanoSecondsSinceJan1_1970() - m_last_sent_packet_time.GetAsNanoSecondsSinceJan1_1970();
+        stats.total_response_time += response_time;
+        if (response_time > stats.max_response_time)
+            stats.max_response_time = response_time;
+        m_last_sent_packet_time.Clear();
+    }
+}
+
+void
+GDBRemoteCommunication::AddPacketStatistics (StructuredData::Dictionary &dict)
+{
+    Mutex::Locker locker (m_packet_stats_mutex);
+    uint64_t total_sent = 0;
+    uint64_t total_bytes_sent = 0;
+    uint64_t total_received = 0;
+    uint64_t total_bytes_received = 0;
+    StructuredData::DictionarySP packets_sp (new StructuredData::Dictionary());
+    for (const auto &pos : m_packet_stats)
+    {
+        const PacketStatistics &stats = pos.second;
+        StructuredData::DictionarySP packet_dict_sp (new StructuredData::Dictionary());
+        packet_dict_sp->AddIntegerItem ("sent", stats.num_sent);
+        packet_dict_sp->AddIntegerItem ("bytes_sent", stats.bytes_sent);
+        packet_dict_sp->AddIntegerItem ("received", stats.num_received);
+        packet_dict_sp->AddIntegerItem ("bytes_received", stats.bytes_received);
+        packet_dict_sp->AddFloatItem ("total_response_time", (double)stats.total_response_time / TimeValue::NanoSecPerSec);
+        packet_dict_sp->AddFloatItem ("max_response_time", (double)stats.max_response_time / TimeValue::NanoSecPerSec);
+        packets_sp->AddItem (pos.first.empty() ? "<unsolicited>" : pos.first.c_str(), packet_dict_sp);
+        total_sent += stats.num_sent;
+        total_bytes_sent += stats.bytes_sent;
+        total_received += stats.num_received;
+        total_bytes_received += stats.bytes_received;
+    }
+    dict.AddIntegerItem ("packets_sent", total_sent);
+    dict.AddIntegerItem ("bytes_sent", total_bytes_sent);
+    dict.AddIntegerItem ("packets_received", total_received);
+    dict.AddIntegerItem ("bytes_received", total_bytes_received);
+    dict.AddItem ("packets", packets_sp);
+}
+
 GDBRemoteCommunication::PacketType
 GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, StringExtractorGDBRemote &packet)
 {
@@ -503,13 +692,68 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                          (uint32_t)src_len, 
                          src);
         }
+
+        if (m_bytes.empty())
+        {
+            // Nothing is buffered, so parse the packet straight out of
+            // the receive buffer and only buffer what is left over
+            size_t bytes_consumed = 0;
+            const PacketType packet_type = ParsePacket ((const char *)src, src_len, packet, bytes_consumed);
+            m_bytes.append ((const char *)src + bytes_consumed, src_len - bytes_consumed);
+            return packet_type;
+        }
         m_bytes.append ((const char *)src, src_len);
     }
 
+    size_t bytes_consumed = 0;
+    const PacketType packet_type = ParsePacket (m_bytes.data(), m_bytes.size(), packet, bytes_consumed);
+    m_bytes.erase (0, bytes_consumed);
+    return packet_type;
+}
+
+//----------------------------------------------------------------------
+// Returns a pointer to the first escape (0x7d) or run length encoding
+// ('*') character in [begin, end), or end if there isn't one.
+//----------------------------------------------------------------------
+static inline const char *
+FindEscapeOrRunLength (const char *begin, const char *end)
+{
+    const char *pos = begin;
+#if defined(__SSE2__)
+    const __m128i escape = _mm_set1_epi8 (0x7d);
+    const __m128i run_length = _mm_set1_epi8 ('*');
+    for (; end - pos >= 16; pos += 16)
+    {
+        const __m128i chars = _mm_loadu_si128 ((const __m128i *)pos);
+        const int matches = _mm_movemask_epi8 (_mm_or_si128 (_mm_cmpeq_epi8 (chars, escape),
+                                                             _mm_cmpeq_epi8 (chars, run_length)));
+        if (matches)
+            return pos + llvm::countTrailingZeros ((uint32_t)matches);
+    }
+#endif
+    for (; pos < end; ++pos)
+    {
+        if (*pos == 0x7d || *pos == '*')
+            return pos;
+    }
+    return end;
+}
+
+//----------------------------------------------------------------------
+// Parses the first packet in [bytes, bytes + bytes_len) into "packet".
+// "bytes_consumed" is set to the number of bytes that the caller should
+// discard: the packet itself or any junk before the next packet.
+//----------------------------------------------------------------------
+GDBRemoteCommunication::PacketType
+GDBRemoteCommunication::ParsePacket (const char *bytes, size_t bytes_len, StringExtractorGDBRemote &packet, size_t &bytes_consumed)
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PACKETS));
+
     bool isNotifyPacket = false;
+    bytes_consumed = 0;
 
     // Parse up the packets into gdb remote packets
-    if (!m_bytes.empty())
+    if (bytes_len > 0)
     {
         // end_idx must be one past the last valid packet byte. Start
         // it off with an invalid value that is the same as the current
@@ -519,7 +763,7 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         size_t total_length = 0;
         size_t checksum_idx = std::string::npos;
 
-        switch (m_bytes[0])
+        switch (bytes[0])
         {
             case '+':       // Look for ack
             case '-':       // Look for cancel
@@ -534,10 +778,11 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
             case '$':
                 // Look for a standard gdb packet?
                 {
-                    size_t hash_pos = m_bytes.find('#');
-                    if (hash_pos != std::string::npos)
+                    const char *hash = (const char *)::memchr (bytes, '#', bytes_len);
+                    if (hash != NULL)
                     {
-                        if (hash_pos + 2 < m_bytes.size())
+                        const size_t hash_pos = hash - bytes;
+                        if (hash_pos + 2 < bytes_len)
                         {
                             checksum_idx = hash_pos + 1;
                             // Skip the dollar sign
@@ -559,16 +804,15 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
             default:
                 {
                     // We have an unexpected byte and we need to flush all bad 
-                    // data that is in m_bytes, so we need to find the first
+                    // data that is in the buffer, so we need to find the first
                     // byte that is a '+' (ACK), '-' (NACK), \x03 (CTRL+C interrupt),
                     // or '$' character (start of packet header) or of course,
-                    // the end of the data in m_bytes...
-                    const size_t bytes_len = m_bytes.size();
+                    // the end of the data in the buffer...
                     bool done = false;
                     uint32_t idx;
                     for (idx = 1; !done && idx < bytes_len; ++idx)
                     {
-                        switch (m_bytes[idx])
+                        switch (bytes[idx])
                         {
                         case '+':
                         case '-':
@@ -584,8 +828,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                     }
                     if (log)
                         log->Printf ("GDBRemoteCommunication::%s tossing %u junk bytes: '%.*s'",
-                                     __FUNCTION__, idx - 1, idx - 1, m_bytes.c_str());
-                    m_bytes.erase(0, idx - 1);
+                                     __FUNCTION__, idx - 1, idx - 1, bytes);
+                    bytes_consumed = idx - 1;
                 }
                 break;
         }
@@ -599,8 +843,8 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
         {
 
             // We have a valid packet...
-            assert (content_length <= m_bytes.size());
-            assert (total_length <= m_bytes.size());
+            assert (content_length <= bytes_len);
+            assert (total_length <= bytes_len);
             assert (content_length <= total_length);
             const size_t content_end = content_start + content_length;
 
@@ -619,11 +863,11 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 
                 bool binary = false;
                 // Only detect binary for packets that start with a '$' and have a '#CC' checksum
-                if (m_bytes[0] == '$' && total_length > 4)
+                if (bytes[0] == '$' && total_length > 4)
                 {
                     for (size_t i=0; !binary && i<total_length; ++i)
                     {
-                        if (isprint(m_bytes[i]) == 0)
+                        if (isprint(bytes[i]) == 0)
                             binary = true;
                     }
                 }
@@ -631,16 +875,16 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 {
                     StreamString strm;
                     // Packet header...
-                    strm.Printf("<%4" PRIu64 "> read packet: %c", (uint64_t)total_length, m_bytes[0]);
+                    strm.Printf("<%4" PRIu64 "> read packet: %c", (uint64_t)total_length, bytes[0]);
                     for (size_t i=content_start; i<content_end; ++i)
                     {
                         // Remove binary escaped bytes when displaying the packet...
-                        const char ch = m_bytes[i];
+                        const char ch = bytes[i];
                         if (ch == 0x7d)
                         {
                             // 0x7d is the escape character.  The next character is to
                             // be XOR'd with 0x20.
-                            const char escapee = m_bytes[++i] ^ 0x20;
+                            const char escapee = bytes[++i] ^ 0x20;
                             strm.Printf("%2.2x", escapee);
                         }
                         else
@@ -649,69 +893,77 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                         }
                     }
                     // Packet footer...
-                    strm.Printf("%c%c%c", m_bytes[total_length-3], m_bytes[total_length-2], m_bytes[total_length-1]);
+                    strm.Printf("%c%c%c", bytes[total_length-3], bytes[total_length-2], bytes[total_length-1]);
                     log->PutCString(strm.GetString().c_str());
                 }
                 else
                 {
-                    log->Printf("<%4" PRIu64 "> read packet: %.*s", (uint64_t)total_length, (int)(total_length), m_bytes.c_str());
+                    log->Printf("<%4" PRIu64 "> read packet: %.*s", (uint64_t)total_length, (int)(total_length), bytes);
                 }
             }
 
-            m_history.AddPacket (m_bytes.c_str(), total_length, History::ePacketTypeRecv, total_length);
+            m_history.AddPacket (bytes, total_length, History::ePacketTypeRecv, total_length);
+            if (bytes[0] == '$')
+                RecordReceivedPacket (total_length);
 
-            // Clear packet_str in case there is some existing data in it.
+            // Copy the packet contents into packet_str expanding the
+            // run-length encoding and escaped bytes in the process. Most
+            // packets have neither, so the bytes between them are copied
+            // in bulk.
             packet_str.clear();
-            // Copy the packet from m_bytes to packet_str expanding the
-            // run-length encoding in the process.
-            // Reserve enough byte for the most common case (no RLE used)
-            packet_str.reserve(m_bytes.length());
-            for (std::string::const_iterator c = m_bytes.begin() + content_start; c != m_bytes.begin() + content_end; ++c)
+            packet_str.reserve(content_length);
+            const char *content_pos = bytes + content_start;
+            const char *content_end_pos = bytes + content_end;
+            while (content_pos < content_end_pos)
             {
-                if (*c == '*')
+                const char *special = FindEscapeOrRunLength (content_pos, content_end_pos);
+                packet_str.append (content_pos, special);
+                // Both '*' and 0x7d are followed by one more byte
+                if (special + 1 >= content_end_pos)
+                    break;
+                if (*special == '*')
                 {
                     // '*' indicates RLE. Next character will give us the
                     // repeat count and previous character is what is to be
                     // repeated.
-                    char char_to_repeat = packet_str.back();
-                    // Number of time the previous character is repeated
-                    int repeat_count = *++c + 3 - ' ';
-                    // We have the char_to_repeat and repeat_count. Now push
-                    // it in the packet.
-                    for (int i = 0; i < repeat_count; ++i)
-                        packet_str.push_back(char_to_repeat);
+                    if (!packet_str.empty())
+                    {
+                        // Number of time the previous character is repeated
+                        const int repeat_count = special[1] + 3 - ' ';
+                        if (repeat_count > 0)
+                            packet_str.append (repeat_count, packet_str.back());
+                    }
                 }
-                else if (*c == 0x7d)
+                else
                 {
                     // 0x7d is the escape character.  The next character is to
                     // be XOR'd with 0x20.
-                    char escapee = *++c ^ 0x20;
-                    packet_str.push_back(escapee);
-                }
-                else
-                {
-                    packet_str.push_back(*c);
+                    packet_str.push_back (special[1] ^ 0x20);
                 }
+                content_pos = special + 2;
             }
 
-            if (m_bytes[0] == '$' || m_bytes[0] == '%')
+            if (bytes[0] == '$' || bytes[0] == '%')
             {
-                assert (checksum_idx < m_bytes.size());
-                if (::isxdigit (m_bytes[checksum_idx+0]) || 
-                    ::isxdigit (m_bytes[checksum_idx+1]))
+                assert (checksum_idx < bytes_len);
+                if (::isxdigit (bytes[checksum_idx+0]) || 
+                    ::isxdigit (bytes[checksum_idx+1]))
                 {
-                    if (GetSendAcks ())
+                    // Notifications aren't acknowledged.
+                    if (GetSendAcks () && !isNotifyPacket)
                     {
-                        const char *packet_checksum_cstr = &m_bytes[checksum_idx];
+                        const char packet_checksum_cstr[3] = { bytes[checksum_idx], bytes[checksum_idx + 1], '\0' };
                         char packet_checksum = strtol (packet_checksum_cstr, NULL, 16);
-                        char actual_checksum = CalculcateChecksum (packet_str.c_str(), packet_str.size());
+                        // The checksum covers the packet contents as they
+                        // were sent, before escapes and RLE are expanded
+                        char actual_checksum = CalculcateChecksum (bytes + content_start, content_length);
                         success = packet_checksum == actual_checksum;
                         if (!success)
                         {
                             if (log)
                                 log->Printf ("error: checksum mismatch: %.*s expected 0x%2.2x, got 0x%2.2x", 
                                              (int)(total_length), 
-                                             m_bytes.c_str(),
+                                             bytes,
                                              (uint8_t)packet_checksum,
                                              (uint8_t)actual_checksum);
                         }
@@ -726,11 +978,11 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                 {
                     success = false;
                     if (log)
-                        log->Printf ("error: invalid checksum in packet: '%s'\n", m_bytes.c_str());
+                        log->Printf ("error: invalid checksum in packet: '%.*s'\n", (int)total_length, bytes);
                 }
             }
             
-            m_bytes.erase(0, total_length);
+            bytes_consumed = total_length;
             packet.SetFilePos(0);
 
             if (isNotifyPacket)
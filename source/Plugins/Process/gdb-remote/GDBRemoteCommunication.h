@@ -12,7 +12,9 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
 #include <list>
+#include <map>
 #include <string>
 
 // Other libraries and framework includes
@@ -20,6 +22,7 @@
 #include "lldb/lldb-public.h"
 #include "lldb/Core/Communication.h"
 #include "lldb/Core/Listener.h"
+#include "lldb/Core/StructuredData.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/Predicate.h"
@@ -47,7 +50,8 @@ class GDBRemoteCommunication : public Communication
 public:
     enum
     {
-        eBroadcastBitRunPacketSent = kLoUserBroadcastBit
+        eBroadcastBitRunPacketSent = kLoUserBroadcastBit,
+        eBroadcastBitNotification  = kLoUserBroadcastBit << 1
     };
 
     enum class PacketType
@@ -95,6 +99,9 @@ public:
     PacketResult
     GetAck ();
 
+    PacketResult
+    GetAck (uint32_t timeout_usec);
+
     size_t
     SendAck ();
 
@@ -112,6 +119,15 @@ public:
     CheckForPacket (const uint8_t *src, 
                     size_t src_len, 
                     StringExtractorGDBRemote &packet);
+
+    //------------------------------------------------------------------
+    // Take the oldest "%" notification that arrived while we were waiting
+    // for the reply to another packet. The payload starts with the type
+    // of the notification, like "Stop:". eBroadcastBitNotification is
+    // broadcast whenever one is queued.
+    //------------------------------------------------------------------
+    bool
+    GetNotification (StringExtractorGDBRemote &notification);
     bool
     IsRunning() const
     {
@@ -163,9 +179,48 @@ public:
 
     void
     DumpHistory(Stream &strm);
+
+    //------------------------------------------------------------------
+    // Add the number of packets and bytes that were sent and received
+    // for each type of packet, and how long the responses took, to
+    // \a dict for "statistics dump".
+    //------------------------------------------------------------------
+    void
+    AddPacketStatistics (StructuredData::Dictionary &dict);
     
 protected:
 
+    struct PacketStatistics
+    {
+        PacketStatistics () :
+            num_sent (0),
+            bytes_sent (0),
+            num_received (0),
+            bytes_received (0),
+            total_response_time (0),
+            max_response_time (0)
+        {
+        }
+
+        uint64_t num_sent;
+        uint64_t bytes_sent;
+        uint64_t num_received;
+        uint64_t bytes_received;
+        uint64_t total_response_time;   // Nanoseconds
+        uint64_t max_response_time;     // Nanoseconds
+    };
+
+    typedef std::map<std::string, PacketStatistics> PacketStatisticsMap;
+
+    static std::string
+    GetPacketStatisticsType (const char *payload, size_t payload_length);
+
+    void
+    RecordSentPacket (const char *payload, size_t payload_length, size_t bytes_written);
+
+    void
+    RecordReceivedPacket (size_t bytes_read);
+
     class History
     {
     public:
@@ -213,7 +268,7 @@ protected:
                    PacketType type,
                    uint32_t bytes_transmitted);
         void
-        AddPacket (const std::string &src,
+        AddPacket (const char *src,
                    uint32_t src_len,
                    PacketType type,
                    uint32_t bytes_transmitted);
@@ -279,10 +334,21 @@ protected:
     SendPacketNoLock (const char *payload, 
                       size_t payload_length);
 
+    // Send an asynchronous notification, "%<notify_type>:<payload>". The
+    // other side never acknowledges notifications.
+    PacketResult
+    SendNotificationPacketNoLock (const char *notify_type,
+                                  const char *payload,
+                                  size_t payload_length);
+
+    // Notifications are queued for GetNotification() and the wait goes on
+    // for a regular packet, unless "return_notifications" is true, then a
+    // notification, queued or new, is returned like any other packet.
     PacketResult
     WaitForPacketWithTimeoutMicroSecondsNoLock (StringExtractorGDBRemote &response, 
                                                 uint32_t timeout_usec,
-                                                bool sync_on_timeout);
+                                                bool sync_on_timeout,
+                                                bool return_notifications = false);
 
     bool
     WaitForNotRunningPrivate (const TimeValue *timeout_ptr);
@@ -301,10 +367,16 @@ protected:
     Predicate<bool> m_public_is_running;
     Predicate<bool> m_private_is_running;
     History m_history;
+    Mutex m_packet_stats_mutex;
+    PacketStatisticsMap m_packet_stats;
+    std::string m_last_sent_packet_type;    // The type of the packet that is waiting for a response
+    TimeValue m_last_sent_packet_time;
     bool m_send_acks;
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
+    Mutex m_notifications_mutex;
+    std::deque<std::string> m_notifications; // Notifications that arrived while waiting for a reply
     
 
     Error
@@ -317,6 +389,18 @@ protected:
     ListenThread (lldb::thread_arg_t arg);
 
 private:
+    bool
+    CheckForReplyPacket (const uint8_t *src,
+                         size_t src_len,
+                         StringExtractorGDBRemote &packet,
+                         bool return_notifications);
+
+    PacketType
+    ParsePacket (const char *bytes,
+                 size_t bytes_len,
+                 StringExtractorGDBRemote &packet,
+                 size_t &bytes_consumed);
+
     HostThread m_listen_thread;
     std::string m_listen_url;
 
@@ -22,6 +22,7 @@
 #include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/ModuleSpec.h"
 #include "lldb/Core/State.h"
@@ -81,6 +82,13 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient() :
     m_supports_qXfer_libraries_svr4_read (eLazyBoolCalculate),
     m_supports_qXfer_features_read (eLazyBoolCalculate),
     m_supports_augmented_libraries_svr4_read (eLazyBoolCalculate),
+    m_supports_qReadMemoryRanges (eLazyBoolCalculate),
+    m_supports_qMemoryRegionMap (eLazyBoolCalculate),
+    m_supports_displaced_stepping (eLazyBoolCalculate),
+    m_supports_conditional_breakpoints (eLazyBoolCalculate),
+    m_supports_tracepoints (eLazyBoolCalculate),
+    m_supports_software_watchpoints (eLazyBoolCalculate),
+    m_supports_breakpoint_batches (eLazyBoolCalculate),
     m_supports_jThreadExtendedInfo (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
@@ -353,6 +361,13 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolCalculate;
     m_supports_qXfer_features_read = eLazyBoolCalculate;
     m_supports_augmented_libraries_svr4_read = eLazyBoolCalculate;
+    m_supports_qReadMemoryRanges = eLazyBoolCalculate;
+    m_supports_qMemoryRegionMap = eLazyBoolCalculate;
+    m_supports_displaced_stepping = eLazyBoolCalculate;
+    m_supports_conditional_breakpoints = eLazyBoolCalculate;
+    m_supports_tracepoints = eLazyBoolCalculate;
+    m_supports_software_watchpoints = eLazyBoolCalculate;
+    m_supports_breakpoint_batches = eLazyBoolCalculate;
 
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
@@ -391,6 +406,13 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
     m_supports_qXfer_libraries_svr4_read = eLazyBoolNo;
     m_supports_augmented_libraries_svr4_read = eLazyBoolNo;
     m_supports_qXfer_features_read = eLazyBoolNo;
+    m_supports_qReadMemoryRanges = eLazyBoolNo;
+    m_supports_qMemoryRegionMap = eLazyBoolNo;
+    m_supports_displaced_stepping = eLazyBoolNo;
+    m_supports_conditional_breakpoints = eLazyBoolNo;
+    m_supports_tracepoints = eLazyBoolNo;
+    m_supports_software_watchpoints = eLazyBoolNo;
+    m_supports_breakpoint_batches = eLazyBoolNo;
     m_max_packet_size = UINT64_MAX;  // It's supposed to always be there, but if not, we assume no limit
 
     // build the qSupported packet
@@ -423,6 +445,27 @@ GDBRemoteCommunicationClient::GetRemoteQSupported ()
         if (::strstr (response_cstr, "qXfer:features:read+"))
             m_supports_qXfer_features_read = eLazyBoolYes;
 
+        if (::strstr (response_cstr, "qReadMemoryRanges+"))
+            m_supports_qReadMemoryRanges = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "qMemoryRegionMap+"))
+            m_supports_qMemoryRegionMap = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "displaced-stepping+"))
+            m_supports_displaced_stepping = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "ConditionalBreakpoints+"))
+            m_supports_conditional_breakpoints = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "QTracepoint+"))
+            m_supports_tracepoints = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "SoftwareWatchpoints+"))
+            m_supports_software_watchpoints = eLazyBoolYes;
+
+        if (::strstr (response_cstr, "QBreakpoints+"))
+            m_supports_breakpoint_batches = eLazyBoolYes;
+
         if (::strstr (response_cstr, "qEcho"))
             m_supports_qEcho = eLazyBoolYes;
         else
@@ -562,6 +605,330 @@ GDBRemoteCommunicationClient::GetThreadExtendedInfoSupported ()
     return m_supports_jThreadExtendedInfo;
 }
 
+bool
+GDBRemoteCommunicationClient::GetReadMemoryRangesSupported ()
+{
+    if (m_supports_qReadMemoryRanges == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_qReadMemoryRanges == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::ReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges)
+{
+    if (num_ranges == 0 || !GetReadMemoryRangesSupported())
+        return false;
+
+    // qReadMemoryRanges:<addr>,<size>[;<addr>,<size>...]
+    StreamString packet;
+    packet.PutCString ("qReadMemoryRanges:");
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        if (i > 0)
+            packet.PutChar (';');
+        packet.Printf ("%" PRIx64 ",%" PRIx64, (uint64_t)ranges[i].addr, (uint64_t)ranges[i].size);
+    }
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        return false;
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_qReadMemoryRanges = eLazyBoolNo;
+        return false;
+    }
+
+    if (response.IsErrorResponse())
+    {
+        for (size_t i = 0; i < num_ranges; ++i)
+            ranges[i].error.SetErrorStringWithFormat ("memory read failed for 0x%" PRIx64, ranges[i].addr);
+        return true;
+    }
+
+    // The response has one entry per range, separated by ';'. Each entry is
+    // either "<byte-count>:<hex-bytes>" or "E<error>" for a range that
+    // couldn't be read at all.
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        MemoryReadRange &range = ranges[i];
+        if (i > 0 && response.GetChar() != ';')
+        {
+            for (; i < num_ranges; ++i)
+                ranges[i].error.SetErrorStringWithFormat ("invalid qReadMemoryRanges response for 0x%" PRIx64, ranges[i].addr);
+            break;
+        }
+
+        const char *entry = response.Peek();
+        if (entry && *entry == 'E')
+        {
+            response.GetChar();
+            response.GetHexU8();
+            range.error.SetErrorStringWithFormat ("memory read failed for 0x%" PRIx64, range.addr);
+            continue;
+        }
+
+        // Don't accept more data than we asked for in case the remote debug
+        // server gave us too much for some reason.
+        const uint64_t byte_count = response.GetHexMaxU64 (false, UINT64_MAX);
+        if (byte_count > range.size || response.GetChar() != ':')
+        {
+            for (; i < num_ranges; ++i)
+                ranges[i].error.SetErrorStringWithFormat ("invalid qReadMemoryRanges response for 0x%" PRIx64, ranges[i].addr);
+            break;
+        }
+
+        DataBufferHeap *heap = new DataBufferHeap (byte_count, 0);
+        range.data_sp.reset (heap);
+        if (response.GetHexBytes (heap->GetBytes(), heap->GetByteSize(), '\xdd') != byte_count)
+            heap->SetByteSize (0);
+    }
+    return true;
+}
+
+bool
+GDBRemoteCommunicationClient::GetMemoryRegionMapSupported ()
+{
+    if (m_supports_qMemoryRegionMap == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_qMemoryRegionMap == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetDisplacedSteppingSupported ()
+{
+    if (m_supports_displaced_stepping == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_displaced_stepping == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetConditionalBreakpointsSupported ()
+{
+    if (m_supports_conditional_breakpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_conditional_breakpoints == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::GetTracepointsSupported ()
+{
+    if (m_supports_tracepoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_tracepoints == eLazyBoolYes;
+}
+
+Error
+GDBRemoteCommunicationClient::SetTracepoint (lldb::addr_t addr, const std::vector<TracepointItem> &items)
+{
+    Error error;
+    if (!GetTracepointsSupported())
+    {
+        error.SetErrorString ("remote stub doesn't support tracepoints");
+        return error;
+    }
+
+    // QTracepoint:<addr>[;R<reg>][;M<size>,<len>,<bytecode>]...
+    StreamGDBRemote packet;
+    packet.Printf ("QTracepoint:%" PRIx64, addr);
+    for (const TracepointItem &item : items)
+    {
+        if (item.address_expr.empty())
+            packet.Printf (";R%" PRIx32, item.reg_num);
+        else
+        {
+            packet.Printf (";M%" PRIx32 ",%" PRIx64 ",", item.byte_size, (uint64_t)item.address_expr.size());
+            packet.PutBytesAsRawHex8 (item.address_expr.data(), item.address_expr.size());
+        }
+    }
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        error.SetErrorString ("failed to send QTracepoint packet");
+    else if (response.IsUnsupportedResponse())
+    {
+        m_supports_tracepoints = eLazyBoolNo;
+        error.SetErrorString ("remote stub doesn't support tracepoints");
+    }
+    else if (!response.IsOKResponse())
+        error.SetErrorStringWithFormat ("failed to set tracepoint at 0x%" PRIx64, addr);
+    return error;
+}
+
+Error
+GDBRemoteCommunicationClient::GetTracepointData (std::vector<TracepointData> &records, uint64_t &num_dropped)
+{
+    Error error;
+    if (!GetTracepointsSupported())
+    {
+        error.SetErrorString ("remote stub doesn't support tracepoints");
+        return error;
+    }
+
+    // Each response holds as many records as fit in a packet, keep asking
+    // until one comes back without records.
+    uint64_t max_size = GetRemoteMaxPacketSize();
+    if (max_size == 0 || max_size > 64 * 1024)
+        max_size = 64 * 1024;
+    StreamString packet;
+    packet.Printf ("qTracepointData:%" PRIx64, max_size);
+    while (true)
+    {
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        {
+            error.SetErrorString ("failed to send qTracepointData packet");
+            break;
+        }
+        if (response.IsUnsupportedResponse() || response.IsErrorResponse())
+        {
+            error.SetErrorString ("failed to get tracepoint data");
+            break;
+        }
+
+        // dropped:<count>;[<tid>,<addr>[,<hex-bytes>|,E]...;]...
+        std::string name;
+        std::string value;
+        if (!response.GetNameColonValue (name, value) || name != "dropped" || value.empty())
+        {
+            error.SetErrorString ("invalid qTracepointData response");
+            break;
+        }
+        num_dropped = StringConvert::ToUInt64 (value.c_str(), 0, 16);
+
+        const size_t num_records = records.size();
+        while (response.GetBytesLeft() > 0 && error.Success())
+        {
+            TracepointData record;
+            record.tid = response.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+            if (response.GetChar() != ',')
+            {
+                error.SetErrorString ("invalid qTracepointData response");
+                break;
+            }
+            record.addr = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+            while (response.GetBytesLeft() > 0)
+            {
+                const char separator = response.GetChar();
+                if (separator == ';')
+                    break;
+                if (separator != ',')
+                {
+                    error.SetErrorString ("invalid qTracepointData response");
+                    break;
+                }
+                if (response.Peek() && *response.Peek() == 'E')
+                {
+                    response.GetChar();
+                    record.values.push_back (lldb::DataBufferSP());
+                    continue;
+                }
+                std::string bytes;
+                while (response.GetBytesLeft() >= 2 && ::isxdigit (*response.Peek()))
+                    bytes.push_back (response.GetHexU8());
+                DataBufferHeap *heap = new DataBufferHeap (bytes.data(), bytes.size());
+                record.values.push_back (lldb::DataBufferSP (heap));
+            }
+            records.push_back (std::move (record));
+        }
+        if (error.Fail() || records.size() == num_records)
+            break;
+    }
+    return error;
+}
+
+bool
+GDBRemoteCommunicationClient::GetMemoryRegionMap (std::vector<MemoryRegionInfo> &regions, uint32_t &generation)
+{
+    if (!GetMemoryRegionMapSupported())
+        return false;
+
+    // qMemoryRegionMap[:<generation>]
+    StreamString packet;
+    packet.PutCString ("qMemoryRegionMap");
+    if (!regions.empty())
+        packet.Printf (":%" PRIx32, generation);
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+        return false;
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_qMemoryRegionMap = eLazyBoolNo;
+        return false;
+    }
+
+    if (response.IsErrorResponse())
+        return false;
+
+    // The response starts with "generation:<generation>;" followed by
+    // either "unchanged;" or "<start>,<size>,<permissions>;" for each region.
+    std::string name;
+    std::string value;
+    if (!response.GetNameColonValue (name, value) || name.compare ("generation") != 0)
+        return false;
+    bool success = false;
+    const uint32_t new_generation = StringConvert::ToUInt32 (value.c_str(), 0, 16, &success);
+    if (!success)
+        return false;
+
+    const char *entries = response.Peek();
+    if (entries && ::strcmp (entries, "unchanged;") == 0)
+    {
+        if (regions.empty())
+            return false;
+        generation = new_generation;
+        return true;
+    }
+
+    std::vector<MemoryRegionInfo> new_regions;
+    while (response.GetBytesLeft() > 0)
+    {
+        const addr_t start = response.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+        if (start == LLDB_INVALID_ADDRESS || response.GetChar() != ',')
+            return false;
+        const addr_t size = response.GetHexMaxU64 (false, 0);
+        if (response.GetChar() != ',')
+            return false;
+
+        MemoryRegionInfo region_info;
+        region_info.GetRange().SetRangeBase (start);
+        region_info.GetRange().SetByteSize (size);
+        region_info.SetReadable (MemoryRegionInfo::eNo);
+        region_info.SetWritable (MemoryRegionInfo::eNo);
+        region_info.SetExecutable (MemoryRegionInfo::eNo);
+
+        char perm;
+        while ((perm = response.GetChar()) != ';')
+        {
+            if (perm == 'r')
+                region_info.SetReadable (MemoryRegionInfo::eYes);
+            else if (perm == 'w')
+                region_info.SetWritable (MemoryRegionInfo::eYes);
+            else if (perm == 'x')
+                region_info.SetExecutable (MemoryRegionInfo::eYes);
+            else
+                return false;
+        }
+        new_regions.push_back (region_info);
+    }
+
+    regions.swap (new_regions);
+    generation = new_generation;
+    return true;
+}
+
 bool
 GDBRemoteCommunicationClient::GetxPacketSupported ()
 {
@@ -884,6 +1251,8 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
     const auto sigint_signo = process->GetUnixSignals().GetSignalNumberFromName("SIGINT");
 
     bool got_async_packet = false;
+    const bool non_stop = process->GetTarget().GetNonStopModeEnabled();
+    bool got_resumed_ack = false;
     
     while (state == eStateRunning)
     {
@@ -895,6 +1264,7 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
                 state = eStateInvalid;
             else
                 m_interrupt_sent = false;
+            got_resumed_ack = false;
         
             m_private_is_running.SetValue (true, eBroadcastAlways);
         }
@@ -904,12 +1274,27 @@ GDBRemoteCommunicationClient::SendContinuePacketAndWaitForResponse
         if (log)
             log->Printf ("GDBRemoteCommunicationClient::%s () WaitForPacket(%s)", __FUNCTION__, continue_packet.c_str());
 
-        if (WaitForPacketWithTimeoutMicroSecondsNoLock(response, UINT32_MAX, false) == PacketResult::Success)
+        // In non-stop mode the stop is a notification that comes after the
+        // OK for the continue packet. One may have been queued already while
+        // we waited for the OK.
+        const bool return_notifications = non_stop && got_resumed_ack;
+        if (WaitForPacketWithTimeoutMicroSecondsNoLock(response, UINT32_MAX, false, return_notifications) == PacketResult::Success)
         {
             if (response.Empty())
                 state = eStateInvalid;
+            else if (non_stop && !got_resumed_ack && response.IsOKResponse())
+            {
+                // In non-stop mode the stub acknowledges the continue
+                // packet right away and sends a notification when a thread
+                // stops.
+                got_resumed_ack = true;
+                got_async_packet = true;
+            }
             else
             {
+                // A "%Stop:" notification carries a regular stop reply.
+                if (non_stop && response.GetStringRef().compare(0, 5, "Stop:") == 0)
+                    response.GetStringRef().erase(0, 5);
                 const char stop_type = response.GetChar();
                 if (log)
                     log->Printf ("GDBRemoteCommunicationClient::%s () got packet: %s", __FUNCTION__, response.GetStringRef().c_str());
@@ -2196,6 +2581,57 @@ GDBRemoteCommunicationClient::GetWatchpointSupportInfo (uint32_t &num)
 
 }
 
+bool
+GDBRemoteCommunicationClient::GetSoftwareWatchpointsSupported ()
+{
+    if (m_supports_software_watchpoints == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_software_watchpoints == eLazyBoolYes;
+}
+
+Error
+GDBRemoteCommunicationClient::GetWatchpointOverhead (lldb::addr_t addr, uint32_t &num_pages, uint64_t &num_faults, uint64_t &num_hits)
+{
+    Error error;
+    if (!GetSoftwareWatchpointsSupported())
+    {
+        error.SetErrorString ("remote stub doesn't support software watchpoints");
+        return error;
+    }
+
+    StreamGDBRemote packet;
+    packet.Printf ("qWatchpointOverhead:%" PRIx64, addr);
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) != PacketResult::Success)
+    {
+        error.SetErrorString ("failed to send qWatchpointOverhead packet");
+        return error;
+    }
+    if (!response.IsNormalResponse())
+    {
+        error.SetErrorStringWithFormat ("no software watchpoint at 0x%" PRIx64, addr);
+        return error;
+    }
+
+    num_pages = 0;
+    num_faults = 0;
+    num_hits = 0;
+    std::string name;
+    std::string value;
+    while (response.GetNameColonValue (name, value))
+    {
+        if (name.compare ("pages") == 0)
+            num_pages = StringConvert::ToUInt32 (value.c_str(), 0, 16);
+        else if (name.compare ("faults") == 0)
+            num_faults = StringConvert::ToUInt64 (value.c_str(), 0, 16);
+        else if (name.compare ("hits") == 0)
+            num_hits = StringConvert::ToUInt64 (value.c_str(), 0, 16);
+    }
+    return error;
+}
+
 lldb_private::Error
 GDBRemoteCommunicationClient::GetWatchpointSupportInfo (uint32_t &num, bool& after)
 {
@@ -3151,7 +3587,8 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (lldb::tid_t tid, StringExtracto
 
 
 uint8_t
-GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
+GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length,
+                                                          const std::vector<std::vector<uint8_t>> *conditions)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
     if (log)
@@ -3162,19 +3599,20 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     if (!SupportsGDBStoppointPacket(type))
         return UINT8_MAX;
     // Construct the breakpoint packet
-    char packet[64];
-    const int packet_len = ::snprintf (packet, 
-                                       sizeof(packet), 
-                                       "%c%i,%" PRIx64 ",%x",
-                                       insert ? 'Z' : 'z', 
-                                       type, 
-                                       addr, 
-                                       length);
-    // Check we haven't overwritten the end of the packet buffer
-    assert (packet_len + 1 < (int)sizeof(packet));
+    StreamString packet;
+    packet.Printf ("%c%i,%" PRIx64 ",%x", insert ? 'Z' : 'z', type, addr, length);
+    // Append the conditions the stub should evaluate, ";X<len>,<bytecode>" each
+    if (insert && conditions)
+    {
+        for (const std::vector<uint8_t> &condition : *conditions)
+        {
+            packet.Printf (";X%" PRIx64 ",", (uint64_t)condition.size());
+            packet.PutBytesAsRawHex8 (condition.data(), condition.size());
+        }
+    }
     StringExtractorGDBRemote response;
     // Try to send the breakpoint packet, and check that it was correctly sent
-    if (SendPacketAndWaitForResponse(packet, packet_len, response, true) == PacketResult::Success)
+    if (SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true) == PacketResult::Success)
     {
         // Receive and OK packet when the breakpoint successfully placed
         if (response.IsOKResponse())
@@ -3203,6 +3641,70 @@ GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type,
     return UINT8_MAX;
 }
 
+bool
+GDBRemoteCommunicationClient::GetBreakpointBatchesSupported ()
+{
+    if (m_supports_breakpoint_batches == eLazyBoolCalculate)
+    {
+        GetRemoteQSupported();
+    }
+    return m_supports_breakpoint_batches == eLazyBoolYes;
+}
+
+bool
+GDBRemoteCommunicationClient::SendBreakpointUpdates (BreakpointUpdate *updates, size_t num_updates)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("GDBRemoteCommunicationClient::%s() %" PRIu64 " breakpoints", __FUNCTION__, (uint64_t)num_updates);
+
+    if (num_updates == 0 || !GetBreakpointBatchesSupported() || !SupportsGDBStoppointPacket(eBreakpointSoftware))
+        return false;
+
+    // QBreakpoints:<Z0 or z0>,<addr>,<length>[;<Z0 or z0>,<addr>,<length>...]
+    StreamString packet;
+    packet.PutCString ("QBreakpoints:");
+    for (size_t i = 0; i < num_updates; ++i)
+    {
+        if (i > 0)
+            packet.PutChar (';');
+        packet.Printf ("%c0,%" PRIx64 ",%x", updates[i].insert ? 'Z' : 'z', updates[i].addr, updates[i].length);
+        updates[i].applied = false;
+    }
+
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, true) != PacketResult::Success)
+        return false;
+
+    if (response.IsUnsupportedResponse())
+    {
+        m_supports_breakpoint_batches = eLazyBoolNo;
+        return false;
+    }
+
+    // "OK" if everything was applied, otherwise the updates that failed
+    // are listed by their index, "failed:<index>[,<index>...];". Anything
+    // else, like an error, means nothing was changed.
+    const bool all_applied = response.IsOKResponse();
+    const char *failed_prefix = "failed:";
+    if (!all_applied && response.GetStringRef().compare (0, strlen (failed_prefix), failed_prefix) != 0)
+        return true;
+
+    for (size_t i = 0; i < num_updates; ++i)
+        updates[i].applied = true;
+    if (all_applied)
+        return true;
+
+    response.SetFilePos (strlen (failed_prefix));
+    do
+    {
+        const uint64_t index = response.GetHexMaxU64 (false, UINT64_MAX);
+        if (index < num_updates)
+            updates[index].applied = false;
+    } while (response.GetChar() == ',');
+    return true;
+}
+
 size_t
 GDBRemoteCommunicationClient::GetCurrentThreadIDs (std::vector<lldb::tid_t> &thread_ids, 
                                                    bool &sequence_mutex_unavailable)
@@ -286,6 +286,23 @@ public:
     Error
     GetWatchpointsTriggerAfterInstruction (bool &after);
 
+    //------------------------------------------------------------------
+    /// Returns true if the remote stub watches memory by protecting its
+    /// pages when it runs out of debug registers, so that there is no
+    /// limit on the number or the size of watchpoints.
+    //------------------------------------------------------------------
+    bool
+    GetSoftwareWatchpointsSupported ();
+
+    //------------------------------------------------------------------
+    /// Get the cost of the software watchpoint at \a addr with a
+    /// "qWatchpointOverhead" packet: the number of pages it protects,
+    /// the faults taken on them and the hits among those faults. Fails
+    /// for watchpoints in debug registers.
+    //------------------------------------------------------------------
+    Error
+    GetWatchpointOverhead (lldb::addr_t addr, uint32_t &num_pages, uint64_t &num_faults, uint64_t &num_hits);
+
     const ArchSpec &
     GetHostArchitecture ();
     
@@ -394,7 +411,39 @@ public:
     SendGDBStoppointTypePacket (GDBStoppointType type,   // Type of breakpoint or watchpoint
                                 bool insert,              // Insert or remove?
                                 lldb::addr_t addr,        // Address of breakpoint or watchpoint
-                                uint32_t length);         // Byte Size of breakpoint or watchpoint
+                                uint32_t length,          // Byte Size of breakpoint or watchpoint
+                                const std::vector<std::vector<uint8_t>> *conditions = nullptr); // Agent expressions the stub should evaluate on a hit
+
+    //------------------------------------------------------------------
+    /// Returns true if the remote stub can insert and remove many
+    /// software breakpoints with one "QBreakpoints" packet.
+    //------------------------------------------------------------------
+    bool
+    GetBreakpointBatchesSupported ();
+
+    struct BreakpointUpdate
+    {
+        bool insert;            // Insert or remove?
+        lldb::addr_t addr;
+        uint32_t length;        // Byte size of the breakpoint
+        bool applied;           // Filled in from the response
+    };
+
+    //------------------------------------------------------------------
+    /// Insert and remove software breakpoints with one "QBreakpoints"
+    /// packet, which stands for a "Z0" or "z0" packet per breakpoint
+    /// without conditions. The stub applies the removals first.
+    ///
+    /// The caller is responsible for keeping the packet within the
+    /// remote stub's maximum packet size.
+    ///
+    /// @return
+    ///     True if the remote stub answered the packet, in which case
+    ///     each update has "applied" filled in, false if the packet
+    ///     couldn't be sent or isn't supported.
+    //------------------------------------------------------------------
+    bool
+    SendBreakpointUpdates (BreakpointUpdate *updates, size_t num_updates);
 
     bool
     SetNonStopMode (const bool enable);
@@ -435,6 +484,114 @@ public:
     bool
     GetAugmentedLibrariesSVR4ReadSupported ();
 
+    bool
+    GetReadMemoryRangesSupported ();
+
+    //------------------------------------------------------------------
+    /// Read several memory ranges with one "qReadMemoryRanges" packet.
+    ///
+    /// The caller is responsible for keeping the combined response for
+    /// all ranges within the remote stub's maximum packet size.
+    ///
+    /// @return
+    ///     True if the remote stub answered the packet in which case
+    ///     each range has either its data or its error filled in,
+    ///     false if the packet couldn't be sent or isn't supported.
+    //------------------------------------------------------------------
+    bool
+    ReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges);
+
+    bool
+    GetMemoryRegionMapSupported ();
+
+    //------------------------------------------------------------------
+    /// Returns true if the remote stub steps threads over software
+    /// breakpoints that are still inserted, so the other threads don't
+    /// have to be stopped while one steps over a breakpoint.
+    //------------------------------------------------------------------
+    bool
+    GetDisplacedSteppingSupported ();
+
+    //------------------------------------------------------------------
+    /// Returns true if the remote stub can evaluate breakpoint conditions
+    /// sent as agent expressions with the "Z0" packet, and only reports
+    /// the hits where one of them is true.
+    //------------------------------------------------------------------
+    bool
+    GetConditionalBreakpointsSupported ();
+
+    //------------------------------------------------------------------
+    /// Something a tracepoint collects: the register "reg_num" if
+    /// "address_expr" is empty, otherwise "byte_size" bytes at the
+    /// address the agent expression "address_expr" computes.
+    //------------------------------------------------------------------
+    struct TracepointItem
+    {
+        TracepointItem () :
+            reg_num (UINT32_MAX),
+            byte_size (0),
+            address_expr ()
+        {
+        }
+
+        uint32_t reg_num;
+        uint32_t byte_size;
+        std::vector<uint8_t> address_expr;
+    };
+
+    //------------------------------------------------------------------
+    /// The data collected for one hit, with one entry per item. Items
+    /// that couldn't be collected have no data.
+    //------------------------------------------------------------------
+    struct TracepointData
+    {
+        lldb::tid_t tid;
+        lldb::addr_t addr;
+        std::vector<lldb::DataBufferSP> values;
+    };
+
+    //------------------------------------------------------------------
+    /// Returns true if the remote stub can collect data for breakpoints
+    /// with the "QTracepoint" packet, without reporting their hits.
+    //------------------------------------------------------------------
+    bool
+    GetTracepointsSupported ();
+
+    //------------------------------------------------------------------
+    /// Make the software breakpoint at \a addr, which must have been set
+    /// with a "Z0" packet, collect \a items on each hit whose conditions
+    /// are true. No items turns it back into a plain breakpoint.
+    //------------------------------------------------------------------
+    Error
+    SetTracepoint (lldb::addr_t addr, const std::vector<TracepointItem> &items);
+
+    //------------------------------------------------------------------
+    /// Fetch all the data the tracepoints collected since the last call
+    /// with "qTracepointData" packets.
+    //------------------------------------------------------------------
+    Error
+    GetTracepointData (std::vector<TracepointData> &records, uint64_t &num_dropped);
+
+    //------------------------------------------------------------------
+    /// Get the whole memory map of the process with one
+    /// "qMemoryRegionMap" packet.
+    ///
+    /// @param[in,out] regions
+    ///     If not empty, a map the caller got earlier. It is left alone
+    ///     if the remote stub says the map hasn't changed since, and
+    ///     replaced with the current map otherwise.
+    ///
+    /// @param[in,out] generation
+    ///     The generation of the map in \a regions. Updated to the
+    ///     generation of the current map.
+    ///
+    /// @return
+    ///     True if \a regions holds the current memory map, false if the
+    ///     packet isn't supported or failed.
+    //------------------------------------------------------------------
+    bool
+    GetMemoryRegionMap (std::vector<MemoryRegionInfo> &regions, uint32_t &generation);
+
     bool
     GetQXferFeaturesReadSupported ();
 
@@ -596,6 +753,13 @@ protected:
     LazyBool m_supports_qXfer_libraries_svr4_read;
     LazyBool m_supports_qXfer_features_read;
     LazyBool m_supports_augmented_libraries_svr4_read;
+    LazyBool m_supports_qReadMemoryRanges;
+    LazyBool m_supports_qMemoryRegionMap;
+    LazyBool m_supports_displaced_stepping;
+    LazyBool m_supports_conditional_breakpoints;
+    LazyBool m_supports_tracepoints;
+    LazyBool m_supports_software_watchpoints;
+    LazyBool m_supports_breakpoint_batches;
     LazyBool m_supports_jThreadExtendedInfo;
 
     bool
@@ -51,35 +51,20 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
 {
     StringExtractorGDBRemote packet;
 
-    PacketResult packet_result = WaitForPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec, false);
+    PacketResult packet_result = GetPacket (timeout_usec, packet, error, quit);
     if (packet_result == PacketResult::Success)
-    {
-        const StringExtractorGDBRemote::ServerPacketType packet_type = packet.GetServerPacketType ();
-        switch (packet_type)
-        {
-        case StringExtractorGDBRemote::eServerPacketType_nack:
-        case StringExtractorGDBRemote::eServerPacketType_ack:
-            break;
-
-        case StringExtractorGDBRemote::eServerPacketType_invalid:
-            error.SetErrorString("invalid packet");
-            quit = true;
-            break;
+        packet_result = HandlePacket (packet, error, interrupt, quit);
+    return packet_result;
+}
 
-        case StringExtractorGDBRemote::eServerPacketType_unimplemented:
-            packet_result = SendUnimplementedResponse (packet.GetStringRef().c_str());
-            break;
-
-        default:
-            auto handler_it = m_packet_handlers.find(packet_type);
-            if (handler_it == m_packet_handlers.end())
-                packet_result = SendUnimplementedResponse (packet.GetStringRef().c_str());
-            else
-                packet_result = handler_it->second (packet, error, interrupt, quit);
-            break;
-        }
-    }
-    else
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServer::GetPacket (uint32_t timeout_usec,
+                                         StringExtractorGDBRemote &packet,
+                                         Error &error,
+                                         bool &quit)
+{
+    PacketResult packet_result = WaitForPacketWithTimeoutMicroSecondsNoLock (packet, timeout_usec, false);
+    if (packet_result != PacketResult::Success)
     {
         if (!IsConnected())
         {
@@ -99,6 +84,45 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
     return packet_result;
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServer::HandlePacket (StringExtractorGDBRemote &packet,
+                                            Error &error,
+                                            bool &interrupt,
+                                            bool &quit)
+{
+    PacketResult packet_result = PacketResult::Success;
+    const StringExtractorGDBRemote::ServerPacketType packet_type = packet.GetServerPacketType ();
+    switch (packet_type)
+    {
+    case StringExtractorGDBRemote::eServerPacketType_nack:
+    case StringExtractorGDBRemote::eServerPacketType_ack:
+        break;
+
+    case StringExtractorGDBRemote::eServerPacketType_invalid:
+        error.SetErrorString("invalid packet");
+        quit = true;
+        break;
+
+    case StringExtractorGDBRemote::eServerPacketType_unimplemented:
+        packet_result = SendUnimplementedResponse (packet.GetStringRef().c_str());
+        break;
+
+    default:
+        auto handler_it = m_packet_handlers.find(packet_type);
+        if (handler_it == m_packet_handlers.end())
+            packet_result = SendUnimplementedResponse (packet.GetStringRef().c_str());
+        else
+            packet_result = handler_it->second (packet, error, interrupt, quit);
+        break;
+    }
+
+    // Check if anything occurred that would force us to want to exit.
+    if (m_exit_now)
+        quit = true;
+
+    return packet_result;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServer::SendUnimplementedResponse (const char *)
 {
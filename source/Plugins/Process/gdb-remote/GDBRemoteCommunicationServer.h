@@ -51,6 +51,20 @@ public:
                               bool &interrupt, 
                               bool &quit);
 
+    // GetPacketAndSendResponse() in two steps, for callers that want to
+    // decide where a packet is handled before handling it.
+    PacketResult
+    GetPacket (uint32_t timeout_usec,
+               StringExtractorGDBRemote &packet,
+               Error &error,
+               bool &quit);
+
+    PacketResult
+    HandlePacket (StringExtractorGDBRemote &packet,
+                  Error &error,
+                  bool &interrupt,
+                  bool &quit);
+
     // After connecting, do a little handshake with the client to make sure
     // we are at least communicating
     bool
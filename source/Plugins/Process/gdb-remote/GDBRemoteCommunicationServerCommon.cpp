@@ -809,8 +809,9 @@ GDBRemoteCommunicationServerCommon::Handle_qPlatform_shell (StringExtractorGDBRe
                 packet.GetHexByteString(working_dir);
             int status, signo;
             std::string output;
+            const FileSpec working_dir_spec = working_dir.empty() ? GetDefaultWorkingDirectory() : FileSpec{working_dir, true};
             Error err = Host::RunShellCommand(path.c_str(),
-                                              FileSpec{working_dir, true},
+                                              working_dir_spec,
                                               &status, &signo, &output, timeout);
             StreamGDBRemote response;
             if (err.Fail())
@@ -920,11 +921,24 @@ GDBRemoteCommunicationServerCommon::Handle_qSupported (StringExtractorGDBRemote
     response.PutCString (";qEcho+");
 #if defined(__linux__)
     response.PutCString (";qXfer:auxv:read+");
+    response.PutCString (";qMemoryRegionMap+");
+    response.PutCString (";displaced-stepping+");
+    response.PutCString (";QNonStop+");
+    response.PutCString (";ConditionalBreakpoints+");
+    response.PutCString (";QTracepoint+");
+    response.PutCString (";SoftwareWatchpoints+");
+    response.PutCString (";QBreakpoints+");
 #endif
+    AppendSupportedFeatures (response);
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+void
+GDBRemoteCommunicationServerCommon::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerCommon::Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet)
 {
@@ -1325,6 +1339,12 @@ GDBRemoteCommunicationServerCommon::CreateProcessInfoResponse_DebugServerStyle (
     }
 }
 
+FileSpec
+GDBRemoteCommunicationServerCommon::GetDefaultWorkingDirectory()
+{
+    return FileSpec();
+}
+
 FileSpec
 GDBRemoteCommunicationServerCommon::FindModuleFile(const std::string& module_path,
                                                    const ArchSpec& arch)
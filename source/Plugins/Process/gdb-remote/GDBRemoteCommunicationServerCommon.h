@@ -16,6 +16,7 @@
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
+#include "lldb/Core/StreamGDBRemote.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Target/Process.h"
 
@@ -208,6 +209,21 @@ protected:
 
     virtual FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch);
+
+    //------------------------------------------------------------------
+    /// Append the qSupported features that only this kind of server
+    /// handles to \a response, each one preceded by a ';'.
+    //------------------------------------------------------------------
+    virtual void
+    AppendSupportedFeatures (StreamGDBRemote &response);
+
+    //------------------------------------------------------------------
+    /// The directory that qPlatform_shell commands run in when the
+    /// packet doesn't specify one. An empty FileSpec means the working
+    /// directory of the server process.
+    //------------------------------------------------------------------
+    virtual FileSpec
+    GetDefaultWorkingDirectory ();
 };
 
 } // namespace process_gdb_remote
@@ -74,9 +74,12 @@ namespace
 // GDBRemoteCommunicationServerLLGS constructor
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
-        const lldb::PlatformSP& platform_sp) :
+        const lldb::PlatformSP& platform_sp,
+        MainLoop &mainloop) :
     GDBRemoteCommunicationServerCommon ("gdb-remote.server", "gdb-remote.server.rx_packet"),
     m_platform_sp (platform_sp),
+    m_mainloop (mainloop),
+    m_network_handle_up (),
     m_async_thread (LLDB_INVALID_HOST_THREAD),
     m_current_tid (LLDB_INVALID_THREAD_ID),
     m_continue_tid (LLDB_INVALID_THREAD_ID),
@@ -87,7 +90,9 @@ GDBRemoteCommunicationServerLLGS::GDBRemoteCommunicationServerLLGS(
     m_active_auxv_buffer_sp (),
     m_saved_registers_mutex (),
     m_saved_registers_map (),
-    m_next_saved_registers_id (1)
+    m_next_saved_registers_id (1),
+    m_non_stop_mode (false),
+    m_pending_stop_replies ()
 {
     assert(platform_sp);
     RegisterPacketHandlers();
@@ -130,6 +135,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_p);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_P,
                                   &GDBRemoteCommunicationServerLLGS::Handle_P);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QBreakpoints,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QBreakpoints);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qC,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qC);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qfThreadInfo,
@@ -140,6 +147,12 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qMemoryRegionInfoSupported,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfoSupported);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qMemoryRegionMap,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionMap);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QNonStop,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QNonStop);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qReadMemoryRanges,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qReadMemoryRanges);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qProcessInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qProcessInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qRegisterInfo,
@@ -156,6 +169,12 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_qsThreadInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qThreadStopInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qThreadStopInfo);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_QTracepoint,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_QTracepoint);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qTracepointData,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qTracepointData);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointOverhead,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointOverhead);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qWatchpointSupportInfo,
                                   &GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qXfer_auxv_read,
@@ -170,6 +189,8 @@ GDBRemoteCommunicationServerLLGS::RegisterPacketHandlers()
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vCont_actions,
                                   &GDBRemoteCommunicationServerLLGS::Handle_vCont_actions);
+    RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_vStopped,
+                                  &GDBRemoteCommunicationServerLLGS::Handle_vStopped);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_Z,
                                   &GDBRemoteCommunicationServerLLGS::Handle_Z);
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_z,
@@ -218,6 +239,7 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
         error = m_platform_sp->LaunchNativeProcess (
             m_process_launch_info,
             *this,
+            m_mainloop,
             m_debugged_process_sp);
     }
 
@@ -227,6 +249,13 @@ GDBRemoteCommunicationServerLLGS::LaunchProcess ()
         return error;
     }
 
+    if (m_non_stop_mode)
+    {
+        error = m_debugged_process_sp->SetNonStopMode (true);
+        if (error.Fail ())
+            return error;
+    }
+
     // Handle mirroring of inferior stdout/stderr over the gdb-remote protocol
     // as needed.
     // llgs local-process debugging may specify PTY paths, which will make these
@@ -303,13 +332,20 @@ GDBRemoteCommunicationServerLLGS::AttachToProcess (lldb::pid_t pid)
         }
 
         // Try to attach.
-        error = m_platform_sp->AttachNativeProcess (pid, *this, m_debugged_process_sp);
+        error = m_platform_sp->AttachNativeProcess (pid, *this, m_mainloop, m_debugged_process_sp);
         if (!error.Success ())
         {
             fprintf (stderr, "%s: failed to attach to process %" PRIu64 ": %s", __FUNCTION__, pid, error.AsCString ());
             return error;
         }
 
+        if (m_non_stop_mode)
+        {
+            error = m_debugged_process_sp->SetNonStopMode (true);
+            if (error.Fail ())
+                return error;
+        }
+
         // Setup stdout/stderr mapping from inferior.
         auto terminal_fd = m_debugged_process_sp->GetTerminalFileDescriptor ();
         if (terminal_fd >= 0)
@@ -350,8 +386,8 @@ GDBRemoteCommunicationServerLLGS::InitializeDelegate (NativeProcessProtocol *pro
     }
 }
 
-GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
+void
+GDBRemoteCommunicationServerLLGS::PrepareWResponse (NativeProcessProtocol *process, StreamString &response)
 {
     assert (process && "process cannot be NULL");
     Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
@@ -367,18 +403,14 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", failed to retrieve process exit status", __FUNCTION__, process->GetID ());
 
-        StreamGDBRemote response;
         response.PutChar ('E');
         response.PutHex8 (GDBRemoteServerError::eErrorExitStatus);
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
     else
     {
         if (log)
             log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ", returning exit type %d, return code %d [%s]", __FUNCTION__, process->GetID (), exit_type, return_code, exit_description.c_str ());
 
-        StreamGDBRemote response;
-
         char return_type_code;
         switch (exit_type)
         {
@@ -399,25 +431,27 @@ GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
 
         // POSIX exit status limited to unsigned 8 bits.
         response.PutHex8 (return_code);
-
-        return SendPacketNoLock(response.GetData(), response.GetSize());
     }
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendWResponse (NativeProcessProtocol *process)
+{
+    StreamGDBRemote response;
+    PrepareWResponse (process, response);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 static void
 AppendHexValue (StreamString &response, const uint8_t* buf, uint32_t buf_size, bool swap)
 {
-    int64_t i;
     if (swap)
     {
-        for (i = buf_size-1; i >= 0; i--)
+        for (int64_t i = buf_size-1; i >= 0; i--)
             response.PutHex8 (buf[i]);
     }
     else
-    {
-        for (i = 0; i < buf_size; i++)
-            response.PutHex8 (buf[i]);
-    }
+        response.PutBytesAsRawHex8 (buf, buf_size);
 }
 
 static void
@@ -450,14 +484,14 @@ WriteRegisterValueInHexFixedWidth (StreamString &response,
     }
 }
 
-GDBRemoteCommunication::PacketResult
-GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
+uint8_t
+GDBRemoteCommunicationServerLLGS::PrepareStopReplyPacketForThread (lldb::tid_t tid, StreamString &response)
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
 
     // Ensure we have a debugged process.
     if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
-        return SendErrorResponse (50);
+        return 50;
 
     if (log)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s preparing packet for pid %" PRIu64 " tid %" PRIu64,
@@ -466,13 +500,13 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     // Ensure we can get info on the given thread.
     NativeThreadProtocolSP thread_sp (m_debugged_process_sp->GetThreadByID (tid));
     if (!thread_sp)
-        return SendErrorResponse (51);
+        return 51;
 
     // Grab the reason this thread stopped.
     struct ThreadStopInfo tid_stop_info;
     std::string description;
     if (!thread_sp->GetStopReason (tid_stop_info, description))
-        return SendErrorResponse (52);
+        return 52;
 
     // FIXME implement register handling for exec'd inferiors.
     // if (tid_stop_info.reason == eStopReasonExec)
@@ -481,7 +515,6 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
     //     InitializeRegisters(force);
     // }
 
-    StreamString response;
     // Output the T packet with the thread
     response.PutChar ('T');
     int signum = tid_stop_info.details.signal.signo;
@@ -646,9 +679,41 @@ GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
         }
     }
 
+    return 0;
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendStopReplyPacketForThread (lldb::tid_t tid)
+{
+    StreamString response;
+    const uint8_t error_code = PrepareStopReplyPacketForThread (tid, response);
+    if (error_code != 0)
+        return SendErrorResponse (error_code);
     return SendPacketNoLock (response.GetData(), response.GetSize());
 }
 
+void
+GDBRemoteCommunicationServerLLGS::QueueStopReply (const std::string &stop_reply)
+{
+    m_pending_stop_replies.push_back (stop_reply);
+
+    // Only one notification is outstanding at a time, the client collects
+    // the replies queued behind it with vStopped.
+    if (m_pending_stop_replies.size () == 1)
+        SendNotificationPacketNoLock ("Stop", stop_reply.c_str (), stop_reply.size ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::SendResumedResponse ()
+{
+    // In all-stop mode the reply to a resume packet is the stop reply that
+    // comes once the process stops again. In non-stop mode stops are
+    // notifications, so the packet is acknowledged right away.
+    if (m_non_stop_mode)
+        return SendOKResponse ();
+    return PacketResult::Success;
+}
+
 void
 GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited (NativeProcessProtocol *process)
 {
@@ -661,7 +726,15 @@ GDBRemoteCommunicationServerLLGS::HandleInferiorState_Exited (NativeProcessProto
     // Send the exit result, and don't flush output.
     // Note: flushing output here would join the inferior stdio reflection thread, which
     // would gunk up the waitpid monitor thread that is calling this.
-    PacketResult result = SendStopReasonForState (StateType::eStateExited, false);
+    PacketResult result = PacketResult::Success;
+    if (m_non_stop_mode)
+    {
+        StreamGDBRemote response;
+        PrepareWResponse (process, response);
+        QueueStopReply (response.GetString ());
+    }
+    else
+        result = SendStopReasonForState (StateType::eStateExited, false);
     if (result != PacketResult::Success)
     {
         if (log)
@@ -779,6 +852,82 @@ GDBRemoteCommunicationServerLLGS::DidExec (NativeProcessProtocol *process)
     ClearProcessSpecificData ();
 }
 
+void
+GDBRemoteCommunicationServerLLGS::ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid)
+{
+    assert (process && "process cannot be NULL");
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS | LIBLLDB_LOG_THREAD));
+
+    // Send the output the thread wrote before it stopped first, like
+    // ProcessStateChanged() does.
+    m_stdio_communication.SynchronizeWithReadThread();
+
+    StreamString response;
+    const uint8_t error_code = PrepareStopReplyPacketForThread (tid, response);
+    if (error_code != 0)
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to prepare stop reply for pid %" PRIu64 " tid %" PRIu64 ": error %u",
+                         __FUNCTION__, process->GetID (), tid, error_code);
+        return;
+    }
+    QueueStopReply (response.GetString ());
+}
+
+void
+GDBRemoteCommunicationServerLLGS::DataAvailableCallback ()
+{
+    Log *log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_COMM));
+
+    // Handle every packet that has arrived, including the ones that are
+    // already buffered, without waiting for more.
+    bool interrupt = false;
+    bool done = false;
+    Error error;
+    while (true)
+    {
+        const PacketResult result = GetPacketAndSendResponse (0, error, interrupt, done);
+        if (result == PacketResult::ErrorReplyTimeout && !done && !interrupt)
+            break; // No more packets in the queue
+
+        // A handler that sets "interrupt" wants the packet loop to end, the
+        // same as "done".
+        if (result != PacketResult::Success || done || interrupt)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s stopped handling packets (result %d%s): %s",
+                             __FUNCTION__, static_cast<int> (result), interrupt ? ", interrupted" : "", error.AsCString ());
+            m_network_handle_up.reset ();
+            m_mainloop.RequestTermination ();
+            break;
+        }
+    }
+}
+
+Error
+GDBRemoteCommunicationServerLLGS::InitializeConnection (std::unique_ptr<Connection> &&connection)
+{
+    IOObjectSP read_object_sp = connection->GetReadObject ();
+    SetConnection (connection.release ());
+
+    Error error;
+    if (!HandshakeWithClient (&error))
+    {
+        if (error.Success ())
+            error.SetErrorString ("handshake with client failed");
+        return error;
+    }
+
+    m_network_handle_up = m_mainloop.RegisterReadObject (read_object_sp,
+            [this] (MainLoopBase &) { DataAvailableCallback (); }, error);
+    if (error.Fail ())
+        return error;
+
+    // The client may have sent packets along with its ack.
+    DataAvailableCallback ();
+    return error;
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::SendONotification (const char *buffer, uint32_t len)
 {
@@ -1052,7 +1201,7 @@ GDBRemoteCommunicationServerLLGS::Handle_C (StringExtractorGDBRemote &packet)
     }
 
     // Don't send an "OK" packet; response is the stopped/exited message.
-    return PacketResult::Success;
+    return SendResumedResponse ();
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1101,7 +1250,7 @@ GDBRemoteCommunicationServerLLGS::Handle_c (StringExtractorGDBRemote &packet)
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
     // No response required from continue.
-    return PacketResult::Success;
+    return SendResumedResponse ();
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1109,6 +1258,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont_actions (StringExtractorGDBRemote
 {
     StreamString response;
     response.Printf("vCont;c;C;s;S");
+    if (m_non_stop_mode)
+        response.PutCString (";t");
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -1152,6 +1303,8 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
     }
 
     ResumeActionList thread_actions;
+    std::vector<lldb::tid_t> stop_tids;
+    bool stop_other_threads = false;
 
     while (packet.GetBytesLeft () && *packet.Peek () == ';')
     {
@@ -1189,6 +1342,13 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 thread_action.state = eStateStepping;
                 break;
 
+            case 't':
+                // Stop, only in non-stop mode.
+                if (!m_non_stop_mode)
+                    return SendIllFormedResponse (packet, "vCont t action requires non-stop mode");
+                thread_action.state = eStateSuspended;
+                break;
+
             default:
                 return SendIllFormedResponse (packet, "Unsupported vCont action");
                 break;
@@ -1205,9 +1365,45 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
                 return SendIllFormedResponse (packet, "Could not parse thread number in vCont packet");
         }
 
+        if (thread_action.state == eStateSuspended)
+        {
+            if (thread_action.tid == LLDB_INVALID_THREAD_ID)
+                stop_other_threads = true;
+            else
+                stop_tids.push_back (thread_action.tid);
+            continue;
+        }
+
         thread_actions.Append (thread_action);
     }
 
+    // A 't' without a thread id stops every thread that isn't given another
+    // action.
+    if (stop_other_threads)
+    {
+        NativeThreadProtocolSP thread_sp;
+        for (uint32_t thread_index = 0; (thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index)); ++thread_index)
+        {
+            if (thread_actions.GetActionForThread (thread_sp->GetID (), true) == nullptr)
+                stop_tids.push_back (thread_sp->GetID ());
+        }
+    }
+
+    for (lldb::tid_t tid : stop_tids)
+    {
+        Error error = m_debugged_process_sp->StopThread (tid);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to stop tid %" PRIu64 ": %s",
+                             __FUNCTION__, tid, error.AsCString ());
+            return SendErrorResponse (GDBRemoteServerError::eErrorResume);
+        }
+    }
+
+    if (thread_actions.IsEmpty ())
+        return SendResumedResponse ();
+
     Error error = m_debugged_process_sp->Resume (thread_actions);
     if (error.Fail ())
     {
@@ -1225,7 +1421,7 @@ GDBRemoteCommunicationServerLLGS::Handle_vCont (StringExtractorGDBRemote &packet
         log->Printf ("GDBRemoteCommunicationServerLLGS::%s continued process %" PRIu64, __FUNCTION__, m_debugged_process_sp->GetID ());
 
     // No response required from vCont.
-    return PacketResult::Success;
+    return SendResumedResponse ();
 }
 
 void
@@ -1259,7 +1455,81 @@ GDBRemoteCommunicationServerLLGS::Handle_stop_reason (StringExtractorGDBRemote &
     if (!m_debugged_process_sp)
         return SendErrorResponse (02);
 
-    return SendStopReasonForState (m_debugged_process_sp->GetState (), true);
+    if (!m_non_stop_mode)
+        return SendStopReasonForState (m_debugged_process_sp->GetState (), true);
+
+    // In non-stop mode, report every stopped thread: the first one now and
+    // the others in reply to vStopped. This replaces whatever stops were
+    // still waiting to be acknowledged.
+    m_pending_stop_replies.clear ();
+    if (m_debugged_process_sp->GetState () == eStateExited)
+    {
+        StreamGDBRemote response;
+        PrepareWResponse (m_debugged_process_sp.get (), response);
+        m_pending_stop_replies.push_back (response.GetString ());
+    }
+    else
+    {
+        NativeThreadProtocolSP thread_sp;
+        for (uint32_t thread_index = 0; (thread_sp = m_debugged_process_sp->GetThreadAtIndex (thread_index)); ++thread_index)
+        {
+            if (!StateIsStoppedState (thread_sp->GetState (), true))
+                continue;
+
+            StreamString response;
+            if (PrepareStopReplyPacketForThread (thread_sp->GetID (), response) == 0)
+                m_pending_stop_replies.push_back (response.GetString ());
+        }
+    }
+
+    if (m_pending_stop_replies.empty ())
+        return SendOKResponse ();
+    const std::string &stop_reply = m_pending_stop_replies.front ();
+    return SendPacketNoLock (stop_reply.c_str (), stop_reply.size ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QNonStop (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    packet.SetFilePos (::strlen ("QNonStop:"));
+    const uint32_t enable = packet.GetU32 (UINT32_MAX);
+    if (enable > 1 || packet.GetBytesLeft () > 0)
+        return SendIllFormedResponse (packet, "QNonStop expects 0 or 1");
+
+    if (m_debugged_process_sp)
+    {
+        Error error = m_debugged_process_sp->SetNonStopMode (enable == 1);
+        if (error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed to %s non-stop mode: %s",
+                             __FUNCTION__, enable ? "enable" : "disable", error.AsCString ());
+            return SendErrorResponse (0x53);
+        }
+    }
+
+    m_non_stop_mode = enable == 1;
+    m_pending_stop_replies.clear ();
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_vStopped (StringExtractorGDBRemote &packet)
+{
+    if (!m_non_stop_mode)
+        return SendUnimplementedResponse (packet.GetStringRef ().c_str ());
+
+    // The client has seen the stop reply at the front of the queue, send it
+    // the next one.
+    if (!m_pending_stop_replies.empty ())
+        m_pending_stop_replies.pop_front ();
+
+    if (m_pending_stop_replies.empty ())
+        return SendOKResponse ();
+    const std::string &stop_reply = m_pending_stop_replies.front ();
+    return SendPacketNoLock (stop_reply.c_str (), stop_reply.size ());
 }
 
 GDBRemoteCommunication::PacketResult
@@ -1560,8 +1830,7 @@ GDBRemoteCommunicationServerLLGS::Handle_p (StringExtractorGDBRemote &packet)
     }
 
     // FIXME flip as needed to get data in big/little endian format for this host.
-    for (uint32_t i = 0; i < reg_value.GetByteSize (); ++i)
-        response.PutHex8 (data[i]);
+    response.PutBytesAsRawHex8 (data, reg_value.GetByteSize ());
 
     return SendPacketNoLock (response.GetData (), response.GetSize ());
 }
@@ -1859,8 +2128,77 @@ GDBRemoteCommunicationServerLLGS::Handle_m (StringExtractorGDBRemote &packet)
     }
 
     StreamGDBRemote response;
-    for (size_t i = 0; i < bytes_read; ++i)
-        response.PutHex8(buf[i]);
+    response.PutBytesAsRawHex8(buf.data(), bytes_read);
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qReadMemoryRanges (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the <addr>,<length> pairs separated by ';'.
+    packet.SetFilePos (strlen("qReadMemoryRanges:"));
+    MemoryReadRanges ranges;
+    while (packet.GetBytesLeft() > 0)
+    {
+        if (!ranges.empty() && packet.GetChar() != ';')
+            return SendIllFormedResponse(packet, "Semicolon sep missing in qReadMemoryRanges packet");
+
+        const lldb::addr_t read_addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+        if (read_addr == LLDB_INVALID_ADDRESS)
+            return SendIllFormedResponse(packet, "Address missing in qReadMemoryRanges packet");
+
+        if ((packet.GetBytesLeft() < 1) || (packet.GetChar() != ','))
+            return SendIllFormedResponse(packet, "Comma sep missing in qReadMemoryRanges packet");
+
+        if (packet.GetBytesLeft() < 1)
+            return SendIllFormedResponse(packet, "Length missing in qReadMemoryRanges packet");
+
+        const uint64_t byte_count = packet.GetHexMaxU64(false, 0);
+        ranges.push_back (MemoryReadRange (read_addr, byte_count));
+    }
+
+    if (ranges.empty())
+        return SendIllFormedResponse(packet, "No ranges in qReadMemoryRanges packet");
+
+    Error error = m_debugged_process_sp->ReadMemoryRangesWithoutTrap (ranges);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to read %" PRIu64 " ranges. Error: %s", __FUNCTION__, m_debugged_process_sp->GetID (), (uint64_t)ranges.size(), error.AsCString ());
+        return SendErrorResponse (0x08);
+    }
+
+    // Answer with "<bytes-read>:<hex-bytes>" for each range, or "E08" for
+    // ranges where nothing could be read, separated by ';'.
+    StreamGDBRemote response;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        const MemoryReadRange &range = ranges[i];
+        if (i > 0)
+            response.PutChar (';');
+
+        const size_t bytes_read = range.GetBytesRead();
+        if (bytes_read == 0 && range.size > 0)
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " mem 0x%" PRIx64 ": read 0 of %" PRIu64 " requested bytes: %s", __FUNCTION__, m_debugged_process_sp->GetID (), range.addr, (uint64_t)range.size, range.error.AsCString ("unknown error"));
+            response.PutCString ("E08");
+            continue;
+        }
+
+        response.Printf ("%" PRIx64 ":", (uint64_t)bytes_read);
+        response.PutBytesAsRawHex8 (range.data_sp->GetBytes(), bytes_read);
+    }
 
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
@@ -2032,6 +2370,67 @@ GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionInfo (StringExtractorGDBRe
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qMemoryRegionMap (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_PROCESS));
+
+    // Ensure we have a process.
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the generation of the map the client already has, if any.
+    packet.SetFilePos (strlen("qMemoryRegionMap"));
+    bool have_known_generation = false;
+    uint32_t known_generation = 0;
+    if (packet.GetBytesLeft() > 0)
+    {
+        if (packet.GetChar() != ':' || packet.GetBytesLeft() < 1)
+            return SendIllFormedResponse(packet, "Malformed qMemoryRegionMap packet, expecting ':<generation>'");
+        known_generation = packet.GetHexMaxU32(false, 0);
+        have_known_generation = true;
+    }
+
+    std::vector<MemoryRegionInfo> regions;
+    uint32_t generation = 0;
+    const Error error = m_debugged_process_sp->GetMemoryRegions (regions, generation);
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 ": failed to get memory regions: %s", __FUNCTION__, m_debugged_process_sp->GetID (), error.AsCString ());
+        return SendErrorResponse (0x01);
+    }
+
+    StreamGDBRemote response;
+    response.Printf ("generation:%" PRIx32 ";", generation);
+
+    // Don't send the map again if the client already has this generation.
+    if (have_known_generation && known_generation == generation)
+    {
+        response.PutCString ("unchanged;");
+        return SendPacketNoLock(response.GetData(), response.GetSize());
+    }
+
+    // Send "<start>,<size>,<permissions>;" for each region.
+    for (const MemoryRegionInfo &region_info : regions)
+    {
+        response.Printf ("%" PRIx64 ",%" PRIx64 ",", region_info.GetRange ().GetRangeBase (), region_info.GetRange ().GetByteSize ());
+        if (region_info.GetReadable () == MemoryRegionInfo::eYes)
+            response.PutChar ('r');
+        if (region_info.GetWritable () == MemoryRegionInfo::eYes)
+            response.PutChar ('w');
+        if (region_info.GetExecutable () == MemoryRegionInfo::eYes)
+            response.PutChar ('x');
+        response.PutChar (';');
+    }
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
 {
@@ -2087,10 +2486,28 @@ GDBRemoteCommunicationServerLLGS::Handle_Z (StringExtractorGDBRemote &packet)
     if (size == std::numeric_limits<uint32_t>::max ())
         return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse size argument");
 
+    // Parse out the breakpoint conditions, ";X<len>,<bytecode>" each.
+    std::vector<std::vector<uint8_t>> conditions;
+    while (want_breakpoint && packet.GetBytesLeft () > 0)
+    {
+        if (packet.GetChar () != ';' || packet.GetChar () != 'X')
+            return SendIllFormedResponse(packet, "Malformed Z packet, expecting ;X before a condition");
+        const uint32_t condition_size = packet.GetHexMaxU32 (false, 0);
+        if (condition_size == 0 || packet.GetChar () != ',' || condition_size > packet.GetBytesLeft () / 2)
+            return SendIllFormedResponse(packet, "Malformed Z packet, failed to parse condition size");
+        std::vector<uint8_t> condition (condition_size);
+        if (packet.GetHexBytes (condition.data (), condition_size, 0) != condition_size)
+            return SendIllFormedResponse(packet, "Malformed Z packet, condition is shorter than its size");
+        conditions.push_back (std::move (condition));
+    }
+
     if (want_breakpoint)
     {
-        // Try to set the breakpoint.
-        const Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
+        // Try to set the breakpoint. The conditions replace any that were
+        // sent for it before.
+        Error error = m_debugged_process_sp->SetBreakpoint (addr, size, want_hardware);
+        if (error.Success ())
+            error = m_debugged_process_sp->SetBreakpointConditions (addr, std::move (conditions));
         if (error.Success ())
             return SendOKResponse ();
         Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
@@ -2208,6 +2625,206 @@ GDBRemoteCommunicationServerLLGS::Handle_z (StringExtractorGDBRemote &packet)
     }
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QBreakpoints (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the software breakpoints to insert, "Z0,<addr>,<kind>", and
+    // to remove, "z0,<addr>,<kind>", separated by ';'. Nothing is changed
+    // unless the whole packet parses.
+    packet.SetFilePos (strlen("QBreakpoints:"));
+    std::vector<NativeProcessProtocol::SoftwareBreakpointUpdate> updates;
+    while (true)
+    {
+        const char type = packet.GetChar ();
+        if ((type != 'Z' && type != 'z') || packet.GetChar () != '0' || packet.GetChar () != ',')
+            return SendIllFormedResponse(packet, "Malformed QBreakpoints packet, expecting Z0 or z0");
+
+        NativeProcessProtocol::SoftwareBreakpointUpdate update;
+        update.insert = type == 'Z';
+        update.addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+        if (update.addr == LLDB_INVALID_ADDRESS || packet.GetChar () != ',')
+            return SendIllFormedResponse(packet, "Malformed QBreakpoints packet, failed to parse address");
+        update.size_hint = packet.GetHexMaxU32 (false, std::numeric_limits<uint32_t>::max ());
+        if (update.size_hint == std::numeric_limits<uint32_t>::max ())
+            return SendIllFormedResponse(packet, "Malformed QBreakpoints packet, failed to parse size argument");
+        updates.push_back (update);
+
+        if (packet.GetBytesLeft () == 0)
+            break;
+        if (packet.GetChar () != ';')
+            return SendIllFormedResponse(packet, "Malformed QBreakpoints packet, expecting ; between breakpoints");
+    }
+
+    m_debugged_process_sp->UpdateSoftwareBreakpoints (updates);
+
+    // Report the breakpoints that couldn't be changed by their index.
+    // Inserting one replaces any conditions that were sent for it before,
+    // as a Z0 packet without conditions does.
+    StreamString failed;
+    for (size_t i = 0; i < updates.size (); ++i)
+    {
+        NativeProcessProtocol::SoftwareBreakpointUpdate &update = updates[i];
+        if (update.error.Success () && update.insert)
+            update.error = m_debugged_process_sp->SetBreakpointConditions (update.addr, std::vector<std::vector<uint8_t>> ());
+        if (update.error.Fail ())
+        {
+            if (log)
+                log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to %s breakpoint at 0x%" PRIx64 ": %s",
+                             __FUNCTION__, m_debugged_process_sp->GetID (), update.insert ? "set" : "remove",
+                             update.addr, update.error.AsCString ());
+            failed.Printf (failed.GetSize () == 0 ? "%" PRIx64 : ",%" PRIx64, (uint64_t)i);
+        }
+    }
+
+    if (failed.GetSize () == 0)
+        return SendOKResponse ();
+
+    StreamString response;
+    response.Printf ("failed:%s;", failed.GetData ());
+    return SendPacketNoLock (response.GetData (), response.GetSize ());
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_QTracepoint (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // Parse out the breakpoint address followed by the items to collect,
+    // ";R<reg>" for a register and ";M<size>,<len>,<bytecode>" for <size>
+    // bytes at the address the bytecode computes.
+    packet.SetFilePos (strlen("QTracepoint:"));
+    if (packet.GetBytesLeft() < 1)
+        return SendIllFormedResponse(packet, "Too short QTracepoint packet, missing address");
+    const lldb::addr_t addr = packet.GetHexMaxU64(false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS)
+        return SendIllFormedResponse(packet, "Malformed QTracepoint packet, failed to parse address");
+
+    // Keep a single hit from taking over the buffer.
+    const uint32_t max_item_size = 4096;
+
+    std::vector<NativeTracepointItem> items;
+    while (packet.GetBytesLeft () > 0)
+    {
+        if (packet.GetChar () != ';')
+            return SendIllFormedResponse(packet, "Malformed QTracepoint packet, expecting ; before an item");
+
+        NativeTracepointItem item;
+        switch (packet.GetChar ())
+        {
+            case 'R':
+                item.reg_num = packet.GetHexMaxU32 (false, UINT32_MAX);
+                if (item.reg_num == UINT32_MAX)
+                    return SendIllFormedResponse(packet, "Malformed QTracepoint packet, failed to parse register");
+                break;
+
+            case 'M':
+            {
+                item.byte_size = packet.GetHexMaxU32 (false, 0);
+                if (item.byte_size == 0 || item.byte_size > max_item_size || packet.GetChar () != ',')
+                    return SendIllFormedResponse(packet, "Malformed QTracepoint packet, failed to parse memory size");
+                const uint32_t expr_size = packet.GetHexMaxU32 (false, 0);
+                if (expr_size == 0 || packet.GetChar () != ',' || expr_size > packet.GetBytesLeft () / 2)
+                    return SendIllFormedResponse(packet, "Malformed QTracepoint packet, failed to parse expression size");
+                item.address_expr.resize (expr_size);
+                if (packet.GetHexBytes (item.address_expr.data (), expr_size, 0) != expr_size)
+                    return SendIllFormedResponse(packet, "Malformed QTracepoint packet, expression is shorter than its size");
+                break;
+            }
+
+            default:
+                return SendIllFormedResponse(packet, "Malformed QTracepoint packet, unknown item kind");
+        }
+        items.push_back (std::move (item));
+    }
+
+    // The breakpoint must have been set with a Z packet, no items turn it
+    // back into a plain breakpoint.
+    const Error error = m_debugged_process_sp->SetTracepoint (addr, std::move (items));
+    if (error.Fail ())
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s pid %" PRIu64 " failed to set tracepoint at 0x%" PRIx64 ": %s",
+                         __FUNCTION__, m_debugged_process_sp->GetID (), addr, error.AsCString ());
+        return SendErrorResponse (0x09);
+    }
+    return SendOKResponse ();
+}
+
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qTracepointData (StringExtractorGDBRemote &packet)
+{
+    Log *log (GetLogIfAnyCategoriesSet(LIBLLDB_LOG_BREAKPOINTS));
+
+    if (!m_debugged_process_sp || (m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID))
+    {
+        if (log)
+            log->Printf ("GDBRemoteCommunicationServerLLGS::%s failed, no process available", __FUNCTION__);
+        return SendErrorResponse (0x15);
+    }
+
+    // The client can limit the size of the response, what doesn't fit is
+    // returned by the next packet.
+    packet.SetFilePos (strlen("qTracepointData"));
+    size_t max_size = 64 * 1024;
+    if (packet.GetBytesLeft () > 0)
+    {
+        if (packet.GetChar () != ':')
+            return SendIllFormedResponse(packet, "Malformed qTracepointData packet, expecting : before the size");
+        max_size = packet.GetHexMaxU64 (false, 0);
+        if (max_size == 0)
+            return SendIllFormedResponse(packet, "Malformed qTracepointData packet, failed to parse size");
+    }
+
+    // Answer with "dropped:<count>;" followed by "<tid>,<addr>" and
+    // ",<hex-bytes>" or ",E" for each collected item of each record, with
+    // the records separated by ';'. At least one record is sent so that
+    // a small size can't stall the client.
+    NativeTracepointBuffer &buffer = m_debugged_process_sp->GetTracepointBuffer ();
+    StreamGDBRemote response;
+    response.Printf ("dropped:%" PRIx64 ";", buffer.GetNumDropped ());
+    StreamGDBRemote record_stream;
+    bool sent_record = false;
+    while (buffer.GetNumRecords () > 0)
+    {
+        const NativeTracepointBuffer::Record &record = buffer.GetOldest ();
+        record_stream.Clear ();
+        record_stream.Printf ("%" PRIx64 ",%" PRIx64, record.tid, record.addr);
+        for (size_t i = 0; i < record.values.size (); ++i)
+        {
+            record_stream.PutChar (',');
+            if (record.available[i])
+                record_stream.PutBytesAsRawHex8 (record.values[i].data (), record.values[i].size ());
+            else
+                record_stream.PutChar ('E');
+        }
+        record_stream.PutChar (';');
+
+        if (sent_record && response.GetSize () + record_stream.GetSize () > max_size)
+            break;
+        response.Write (record_stream.GetData (), record_stream.GetSize ());
+        buffer.RemoveOldest ();
+        sent_record = true;
+    }
+
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
 {
@@ -2253,7 +2870,7 @@ GDBRemoteCommunicationServerLLGS::Handle_s (StringExtractorGDBRemote &packet)
     }
 
     // No response here - the stop or exit will come from the resulting action.
-    return PacketResult::Success;
+    return SendResumedResponse ();
 }
 
 GDBRemoteCommunication::PacketResult
@@ -2600,6 +3217,31 @@ GDBRemoteCommunicationServerLLGS::Handle_qWatchpointSupportInfo (StringExtractor
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
+GDBRemoteCommunication::PacketResult
+GDBRemoteCommunicationServerLLGS::Handle_qWatchpointOverhead (StringExtractorGDBRemote &packet)
+{
+    // Fail if we don't have a current process.
+    if (!m_debugged_process_sp ||
+            m_debugged_process_sp->GetID () == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (68);
+
+    packet.SetFilePos (strlen("qWatchpointOverhead:"));
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS)
+        return SendIllFormedResponse(packet, "Malformed qWatchpointOverhead packet, failed to parse address");
+
+    // Watchpoints in debug registers have no overhead to report.
+    const NativeSoftwareWatchpointList &list = m_debugged_process_sp->GetSoftwareWatchpointList ();
+    const NativeSoftwareWatchpointList::Watchpoint *watchpoint = list.FindWatchpoint (addr);
+    if (!watchpoint)
+        return SendErrorResponse (0x02);
+
+    StreamGDBRemote response;
+    response.Printf ("pages:%" PRIx64 ";faults:%" PRIx64 ";hits:%" PRIx64 ";",
+                     static_cast<uint64_t> (list.GetNumPages (*watchpoint)), watchpoint->num_faults, watchpoint->num_hits);
+    return SendPacketNoLock(response.GetData(), response.GetSize());
+}
+
 void
 GDBRemoteCommunicationServerLLGS::FlushInferiorOutput ()
 {
@@ -2754,3 +3396,10 @@ GDBRemoteCommunicationServerLLGS::FindModuleFile(const std::string& module_path,
 
     return GDBRemoteCommunicationServerCommon::FindModuleFile(module_path, arch);
 }
+
+void
+GDBRemoteCommunicationServerLLGS::AppendSupportedFeatures (StreamGDBRemote &response)
+{
+    // Only a debugged process has memory to read.
+    response.PutCString (";qReadMemoryRanges+");
+}
@@ -12,11 +12,14 @@
 
 // C Includes
 // C++ Includes
+#include <deque>
+#include <string>
 #include <unordered_map>
 
 // Other libraries and framework includes
 #include "lldb/lldb-private-forward.h"
 #include "lldb/Core/Communication.h"
+#include "lldb/Host/MainLoop.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Host/common/NativeProcessProtocol.h"
 
@@ -38,7 +41,8 @@ public:
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
-    GDBRemoteCommunicationServerLLGS(const lldb::PlatformSP& platform_sp);
+    GDBRemoteCommunicationServerLLGS(const lldb::PlatformSP& platform_sp,
+                                     MainLoop &mainloop);
 
     virtual
     ~GDBRemoteCommunicationServerLLGS();
@@ -99,6 +103,18 @@ public:
     Error
     AttachToProcess (lldb::pid_t pid);
 
+    //------------------------------------------------------------------
+    /// Take ownership of the connection to the client, wait for its
+    /// initial ack and handle its packets from the main loop from then
+    /// on.
+    ///
+    /// Packets are handled on the main loop thread, the same thread
+    /// that handles the events of the debugged process, so the packet
+    /// handlers can call ptrace directly.
+    //------------------------------------------------------------------
+    Error
+    InitializeConnection (std::unique_ptr<Connection> &&connection);
+
     //------------------------------------------------------------------
     // NativeProcessProtocol::NativeDelegate overrides
     //------------------------------------------------------------------
@@ -111,8 +127,13 @@ public:
     void
     DidExec (NativeProcessProtocol *process) override;
 
+    void
+    ThreadStopped (NativeProcessProtocol *process, lldb::tid_t tid) override;
+
 protected:
     lldb::PlatformSP m_platform_sp;
+    MainLoop &m_mainloop;
+    MainLoop::ReadHandleUP m_network_handle_up;
     lldb::thread_t m_async_thread;
     lldb::tid_t m_current_tid;
     lldb::tid_t m_continue_tid;
@@ -124,16 +145,37 @@ protected:
     Mutex m_saved_registers_mutex;
     std::unordered_map<uint32_t, lldb::DataBufferSP> m_saved_registers_map;
     uint32_t m_next_saved_registers_id;
+    bool m_non_stop_mode;
+    // In non-stop mode, the stop replies the client hasn't acknowledged
+    // with vStopped yet. The first one has already been sent.
+    std::deque<std::string> m_pending_stop_replies;
 
     PacketResult
     SendONotification (const char *buffer, uint32_t len);
 
+    void
+    PrepareWResponse (NativeProcessProtocol *process, StreamString &response);
+
     PacketResult
     SendWResponse (NativeProcessProtocol *process);
 
+    // Build the stop reply packet for a thread. Returns zero, or the error
+    // number to reply with instead if there is no stop reply.
+    uint8_t
+    PrepareStopReplyPacketForThread (lldb::tid_t tid, StreamString &response);
+
     PacketResult
     SendStopReplyPacketForThread (lldb::tid_t tid);
 
+    // Send a stop reply in non-stop mode, as a notification if the client
+    // has acknowledged all of the earlier ones.
+    void
+    QueueStopReply (const std::string &stop_reply);
+
+    // The reply to a packet that resumed the process.
+    PacketResult
+    SendResumedResponse ();
+
     PacketResult
     SendStopReasonForState (lldb::StateType process_state, bool flush_on_exit);
 
@@ -170,6 +212,12 @@ protected:
     PacketResult
     Handle_stop_reason (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QNonStop (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_vStopped (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qRegisterInfo (StringExtractorGDBRemote &packet);
 
@@ -200,18 +248,33 @@ protected:
     PacketResult
     Handle_M (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qReadMemoryRanges (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_qMemoryRegionInfoSupported (StringExtractorGDBRemote &packet);
 
     PacketResult
     Handle_qMemoryRegionInfo (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qMemoryRegionMap (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_Z (StringExtractorGDBRemote &packet);
 
     PacketResult
     Handle_z (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_QBreakpoints (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_QTracepoint (StringExtractorGDBRemote &packet);
+
+    PacketResult
+    Handle_qTracepointData (StringExtractorGDBRemote &packet);
+
     PacketResult
     Handle_s (StringExtractorGDBRemote &packet);
 
@@ -236,6 +299,9 @@ protected:
     PacketResult
     Handle_qWatchpointSupportInfo (StringExtractorGDBRemote &packet);
 
+    PacketResult
+    Handle_qWatchpointOverhead (StringExtractorGDBRemote &packet);
+
     void
     SetCurrentThreadID (lldb::tid_t tid);
 
@@ -257,7 +323,13 @@ protected:
     FileSpec
     FindModuleFile (const std::string& module_path, const ArchSpec& arch) override;
 
+    void
+    AppendSupportedFeatures (StreamGDBRemote &response) override;
+
 private:
+    void
+    DataAvailableCallback ();
+
     bool
     DebuggedProcessReaped (lldb::pid_t pid);
 
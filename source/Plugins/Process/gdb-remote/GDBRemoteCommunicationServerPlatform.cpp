@@ -15,6 +15,7 @@
 // C++ Includes
 #include <cstring>
 #include <chrono>
+#include <map>
 
 // Other libraries and framework includes
 #include "lldb/Core/Log.h"
@@ -26,6 +27,7 @@
 #include "lldb/Target/FileAction.h"
 #include "lldb/Target/Platform.h"
 #include "lldb/Target/Process.h"
+#include "llvm/Support/Path.h"
 
 // Project includes
 #include "Utility/StringExtractorGDBRemote.h"
@@ -35,14 +37,61 @@ using namespace lldb;
 using namespace lldb_private;
 using namespace lldb_private::process_gdb_remote;
 
+namespace
+{
+    // A debugserver or inferior that a platform session spawned. The
+    // process is reaped on its own monitor thread, possibly after the
+    // session that spawned it is gone, so the port map is kept alive here
+    // and the session is cleared when it is destroyed.
+    struct SpawnedProcessInfo
+    {
+        GDBRemoteCommunicationServerPlatform *server;
+        GDBRemoteCommunicationServerPlatform::PortMapSP port_map_sp;
+    };
+}
+
+//----------------------------------------------------------------------
+// Protects the port maps and the spawned processes of all the platform
+// sessions in this process. Lock it before any m_spawned_pids_mutex.
+//----------------------------------------------------------------------
+static Mutex &
+GetSessionStateMutex ()
+{
+    static Mutex g_mutex (Mutex::eMutexTypeRecursive);
+    return g_mutex;
+}
+
+static std::map<lldb::pid_t, SpawnedProcessInfo> &
+GetSpawnedProcesses ()
+{
+    static std::map<lldb::pid_t, SpawnedProcessInfo> g_spawned_processes;
+    return g_spawned_processes;
+}
+
+static bool
+FreePortForProcessInMap (GDBRemoteCommunicationServerPlatform::PortMap &port_map, lldb::pid_t pid)
+{
+    for (auto &pair : port_map)
+    {
+        if (pair.second == pid)
+        {
+            pair.second = LLDB_INVALID_PROCESS_ID;
+            return true;
+        }
+    }
+    return false;
+}
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationServerPlatform constructor
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform() :
     GDBRemoteCommunicationServerCommon ("gdb-remote.server", "gdb-remote.server.rx_packet"),
     m_platform_sp (Platform::GetHostPlatform ()),
-    m_port_map (),
-    m_port_offset(0)
+    m_port_map_sp (new PortMap ()),
+    m_port_offset(0),
+    m_session_scoped_working_dir (false),
+    m_working_dir ()
 {
     RegisterMemberFunctionHandler(StringExtractorGDBRemote::eServerPacketType_qC,
                                   &GDBRemoteCommunicationServerPlatform::Handle_qC);
@@ -72,6 +121,13 @@ GDBRemoteCommunicationServerPlatform::GDBRemoteCommunicationServerPlatform() :
 //----------------------------------------------------------------------
 GDBRemoteCommunicationServerPlatform::~GDBRemoteCommunicationServerPlatform()
 {
+    // Processes we spawned may outlive this session.
+    Mutex::Locker locker (GetSessionStateMutex ());
+    for (auto &pair : GetSpawnedProcesses ())
+    {
+        if (pair.second.server == this)
+            pair.second.server = nullptr;
+    }
 }
 
 GDBRemoteCommunication::PacketResult
@@ -123,6 +179,8 @@ GDBRemoteCommunicationServerPlatform::Handle_qLaunchGDBServer (StringExtractorGD
     // platform closes.
     debugserver_launch_info.SetLaunchInSeparateProcessGroup(false);
     debugserver_launch_info.SetMonitorProcessCallback(ReapDebugserverProcess, this, false);
+    if (m_working_dir)
+        debugserver_launch_info.SetWorkingDirectory(m_working_dir);
 
     std::string platform_scheme;
     std::string platform_ip;
@@ -141,10 +199,7 @@ GDBRemoteCommunicationServerPlatform::Handle_qLaunchGDBServer (StringExtractorGD
 
     if (debugserver_pid != LLDB_INVALID_PROCESS_ID)
     {
-        Mutex::Locker locker (m_spawned_pids_mutex);
-        m_spawned_pids.insert(debugserver_pid);
-        if (port > 0)
-            AssociatePortWithProcess(port, debugserver_pid);
+        TrackSpawnedProcess(debugserver_pid, port);
     }
     else
     {
@@ -199,14 +254,22 @@ GDBRemoteCommunicationServerPlatform::Handle_qProcessInfo (StringExtractorGDBRem
 GDBRemoteCommunication::PacketResult
 GDBRemoteCommunicationServerPlatform::Handle_qGetWorkingDir (StringExtractorGDBRemote &packet)
 {
-    // If this packet is sent to a platform, then change the current working directory
+    // If this packet is sent to a platform, then report the working directory
+    // of this session
 
-    char cwd[PATH_MAX];
-    if (getcwd(cwd, sizeof(cwd)) == NULL)
-        return SendErrorResponse(errno);
+    std::string cwd;
+    if (m_working_dir)
+        cwd = m_working_dir.GetPath();
+    else
+    {
+        char buffer[PATH_MAX];
+        if (getcwd(buffer, sizeof(buffer)) == NULL)
+            return SendErrorResponse(errno);
+        cwd = buffer;
+    }
 
     StreamString response;
-    response.PutBytesAsRawHex8(cwd, strlen(cwd));
+    response.PutBytesAsRawHex8(cwd.c_str(), cwd.size());
     return SendPacketNoLock(response.GetData(), response.GetSize());
 }
 
@@ -217,9 +280,28 @@ GDBRemoteCommunicationServerPlatform::Handle_QSetWorkingDir (StringExtractorGDBR
     std::string path;
     packet.GetHexByteString (path);
 
-    // If this packet is sent to a platform, then change the current working directory
-    if (::chdir(path.c_str()) != 0)
-        return SendErrorResponse (errno);
+    // If this packet is sent to a platform that serves one session, then
+    // change the current working directory
+    if (!m_session_scoped_working_dir)
+    {
+        if (::chdir(path.c_str()) != 0)
+            return SendErrorResponse (errno);
+        return SendOKResponse ();
+    }
+
+    // Otherwise change the working directory of this session. Relative
+    // paths are relative to the previous one.
+    FileSpec working_dir;
+    if (m_working_dir && llvm::sys::path::is_relative(path))
+        working_dir = m_working_dir.CopyByAppendingPathComponent(path.c_str());
+    else
+        working_dir.SetFile(path.c_str(), false);
+    working_dir.ResolvePath();
+    if (!working_dir.Exists())
+        return SendErrorResponse (ENOENT);
+    if (!working_dir.IsDirectory())
+        return SendErrorResponse (ENOTDIR);
+    m_working_dir = working_dir;
     return SendOKResponse ();
 }
 
@@ -251,11 +333,32 @@ GDBRemoteCommunicationServerPlatform::Handle_qC (StringExtractorGDBRemote &packe
     return SendPacketNoLock (response.GetData(), response.GetSize());
 }
 
+FileSpec
+GDBRemoteCommunicationServerPlatform::GetDefaultWorkingDirectory ()
+{
+    return m_working_dir;
+}
+
+void
+GDBRemoteCommunicationServerPlatform::TrackSpawnedProcess (lldb::pid_t pid, uint16_t port)
+{
+    Mutex::Locker locker (GetSessionStateMutex ());
+    {
+        Mutex::Locker spawned_pids_locker (m_spawned_pids_mutex);
+        m_spawned_pids.insert(pid);
+    }
+    if (port > 0)
+        AssociatePortWithProcess(port, pid);
+
+    SpawnedProcessInfo &info = GetSpawnedProcesses ()[pid];
+    info.server = this;
+    info.port_map_sp = m_port_map_sp;
+}
+
 bool
 GDBRemoteCommunicationServerPlatform::DebugserverProcessReaped (lldb::pid_t pid)
 {
     Mutex::Locker locker (m_spawned_pids_mutex);
-    FreePortForProcess(pid);
     return m_spawned_pids.erase(pid) > 0;
 }
 
@@ -266,8 +369,18 @@ GDBRemoteCommunicationServerPlatform::ReapDebugserverProcess (void *callback_bat
                                                    int signal,    // Zero for no signal
                                                    int status)    // Exit value of process if signal is zero
 {
-    GDBRemoteCommunicationServerPlatform *server = (GDBRemoteCommunicationServerPlatform *)callback_baton;
-    server->DebugserverProcessReaped (pid);
+    // Don't use callback_baton, the session that spawned the process may
+    // have been destroyed by now.
+    Mutex::Locker locker (GetSessionStateMutex ());
+    auto &spawned_processes = GetSpawnedProcesses ();
+    auto pos = spawned_processes.find (pid);
+    if (pos == spawned_processes.end ())
+        return true;
+
+    FreePortForProcessInMap (*pos->second.port_map_sp, pid);
+    if (pos->second.server)
+        pos->second.server->DebugserverProcessReaped (pid);
+    spawned_processes.erase (pos);
     return true;
 }
 
@@ -282,6 +395,8 @@ GDBRemoteCommunicationServerPlatform::LaunchProcess ()
     // processes.
     if (!m_process_launch_info.GetMonitorProcessCallback ())
         m_process_launch_info.SetMonitorProcessCallback(ReapDebugserverProcess, this, false);
+    if (!m_process_launch_info.GetWorkingDirectory () && m_working_dir)
+        m_process_launch_info.SetWorkingDirectory (m_working_dir);
 
     Error error = m_platform_sp->LaunchProcess (m_process_launch_info);
     if (!error.Success ())
@@ -298,8 +413,7 @@ GDBRemoteCommunicationServerPlatform::LaunchProcess ()
     if (pid != LLDB_INVALID_PROCESS_ID)
     {
         // add to spawned pids
-        Mutex::Locker locker (m_spawned_pids_mutex);
-        m_spawned_pids.insert(pid);
+        TrackSpawnedProcess(pid, 0);
     }
 
     return error;
@@ -308,16 +422,25 @@ GDBRemoteCommunicationServerPlatform::LaunchProcess ()
 void
 GDBRemoteCommunicationServerPlatform::SetPortMap (PortMap &&port_map)
 {
-    m_port_map = port_map;
+    Mutex::Locker locker (GetSessionStateMutex ());
+    m_port_map_sp.reset (new PortMap (std::move (port_map)));
+}
+
+void
+GDBRemoteCommunicationServerPlatform::SetPortMap (const PortMapSP &port_map_sp)
+{
+    Mutex::Locker locker (GetSessionStateMutex ());
+    m_port_map_sp = port_map_sp;
 }
 
 uint16_t
 GDBRemoteCommunicationServerPlatform::GetNextAvailablePort ()
 {
-    if (m_port_map.empty())
+    Mutex::Locker locker (GetSessionStateMutex ());
+    if (m_port_map_sp->empty())
         return 0; // Bind to port zero and get a port, we didn't have any limitations
 
-    for (auto &pair : m_port_map)
+    for (auto &pair : *m_port_map_sp)
     {
         if (pair.second == LLDB_INVALID_PROCESS_ID)
         {
@@ -331,8 +454,9 @@ GDBRemoteCommunicationServerPlatform::GetNextAvailablePort ()
 bool
 GDBRemoteCommunicationServerPlatform::AssociatePortWithProcess (uint16_t port, lldb::pid_t pid)
 {
-    PortMap::iterator pos = m_port_map.find(port);
-    if (pos != m_port_map.end())
+    Mutex::Locker locker (GetSessionStateMutex ());
+    PortMap::iterator pos = m_port_map_sp->find(port);
+    if (pos != m_port_map_sp->end())
     {
         pos->second = pid;
         return true;
@@ -343,8 +467,9 @@ GDBRemoteCommunicationServerPlatform::AssociatePortWithProcess (uint16_t port, l
 bool
 GDBRemoteCommunicationServerPlatform::FreePort (uint16_t port)
 {
-    PortMap::iterator pos = m_port_map.find(port);
-    if (pos != m_port_map.end())
+    Mutex::Locker locker (GetSessionStateMutex ());
+    PortMap::iterator pos = m_port_map_sp->find(port);
+    if (pos != m_port_map_sp->end())
     {
         pos->second = LLDB_INVALID_PROCESS_ID;
         return true;
@@ -355,18 +480,8 @@ GDBRemoteCommunicationServerPlatform::FreePort (uint16_t port)
 bool
 GDBRemoteCommunicationServerPlatform::FreePortForProcess (lldb::pid_t pid)
 {
-    if (!m_port_map.empty())
-    {
-        for (auto &pair : m_port_map)
-        {
-            if (pair.second == pid)
-            {
-                pair.second = LLDB_INVALID_PROCESS_ID;
-                return true;
-            }
-        }
-    }
-    return false;
+    Mutex::Locker locker (GetSessionStateMutex ());
+    return FreePortForProcessInMap (*m_port_map_sp, pid);
 }
 
 void
@@ -374,3 +489,22 @@ GDBRemoteCommunicationServerPlatform::SetPortOffset (uint16_t port_offset)
 {
     m_port_offset = port_offset;
 }
+
+void
+GDBRemoteCommunicationServerPlatform::SetSessionScopedWorkingDirectory (bool session_scoped)
+{
+    m_session_scoped_working_dir = session_scoped;
+}
+
+bool
+GDBRemoteCommunicationServerPlatform::IsBlockingPacket (StringExtractorGDBRemote::ServerPacketType packet_type)
+{
+    switch (packet_type)
+    {
+    case StringExtractorGDBRemote::eServerPacketType_qLaunchGDBServer:
+    case StringExtractorGDBRemote::eServerPacketType_qPlatform_shell:
+        return true;
+    default:
+        return false;
+    }
+}
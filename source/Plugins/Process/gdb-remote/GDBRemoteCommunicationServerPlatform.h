@@ -10,6 +10,14 @@
 #ifndef liblldb_GDBRemoteCommunicationServerPlatform_h_
 #define liblldb_GDBRemoteCommunicationServerPlatform_h_
 
+// C Includes
+// C++ Includes
+#include <memory>
+
+// Other libraries and framework includes
+#include "lldb/Host/FileSpec.h"
+
+// Project includes
 #include "GDBRemoteCommunicationServerCommon.h"
 
 namespace lldb_private {
@@ -20,6 +28,7 @@ class GDBRemoteCommunicationServerPlatform :
 {
 public:
     typedef std::map<uint16_t, lldb::pid_t> PortMap;
+    typedef std::shared_ptr<PortMap> PortMapSP;
 
     GDBRemoteCommunicationServerPlatform();
 
@@ -34,6 +43,15 @@ public:
     void
     SetPortMap (PortMap &&port_map);
 
+    //----------------------------------------------------------------------
+    // Use a port map that is shared with other platform sessions. A
+    // lldb-platform that serves several clients from one process must
+    // share the map between its sessions so that two sessions never hand
+    // out the same port.
+    //----------------------------------------------------------------------
+    void
+    SetPortMap (const PortMapSP &port_map_sp);
+
     //----------------------------------------------------------------------
     // If we are using a port map where we can only use certain ports,
     // get the next available port.
@@ -58,12 +76,35 @@ public:
     void
     SetPortOffset (uint16_t port_offset);
 
+    //----------------------------------------------------------------------
+    // Keep the working directory set with QSetWorkingDir in this session
+    // instead of changing the working directory of the process. Set this
+    // when one process serves more than one session.
+    //----------------------------------------------------------------------
+    void
+    SetSessionScopedWorkingDirectory (bool session_scoped);
+
+    //----------------------------------------------------------------------
+    // Returns true for the packets whose handlers wait for another process
+    // to finish or to start listening before they reply, which can take
+    // seconds. A process that serves more than one session should handle
+    // them off the thread that serves the other sessions.
+    //----------------------------------------------------------------------
+    static bool
+    IsBlockingPacket (StringExtractorGDBRemote::ServerPacketType packet_type);
+
 protected:
     lldb::PlatformSP m_platform_sp;
 
-    PortMap m_port_map;
+    PortMapSP m_port_map_sp;
     uint16_t m_port_offset;
 
+    // The working directory that was set with QSetWorkingDir when it is
+    // kept per session instead of changing the working directory of the
+    // whole lldb-platform process, which may be serving other sessions.
+    bool m_session_scoped_working_dir;
+    FileSpec m_working_dir;
+
     PacketResult
     Handle_qLaunchGDBServer (StringExtractorGDBRemote &packet);
 
@@ -79,7 +120,13 @@ protected:
     PacketResult
     Handle_qC (StringExtractorGDBRemote &packet);
 
+    FileSpec
+    GetDefaultWorkingDirectory () override;
+
 private:
+    void
+    TrackSpawnedProcess (lldb::pid_t pid, uint16_t port);
+
     bool
     DebugserverProcessReaped (lldb::pid_t pid);
 
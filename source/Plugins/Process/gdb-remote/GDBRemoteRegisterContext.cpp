@@ -172,6 +172,11 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
     if (process == NULL || thread == NULL)
         return false;
 
+    // The registers of a thread that is still running in non-stop mode
+    // can't be read or written.
+    if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+        return false;
+
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 
     InvalidateIfNeeded(false);
@@ -325,6 +330,8 @@ GDBRemoteRegisterContext::WriteRegisterBytes (const RegisterInfo *reg_info, Data
     Thread *thread = exe_ctx.GetThreadPtr();
     if (process == NULL || thread == NULL)
         return false;
+    if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+        return false;
 
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 // FIXME: This check isn't right because IsRunning checks the Public state, but this
@@ -469,6 +476,8 @@ GDBRemoteRegisterContext::ReadAllRegisterValues (RegisterCheckpoint &reg_checkpo
     Thread *thread = exe_ctx.GetThreadPtr();
     if (process == NULL || thread == NULL)
         return false;
+    if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+        return false;
     
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 
@@ -498,6 +507,8 @@ GDBRemoteRegisterContext::WriteAllRegisterValues (const RegisterCheckpoint &reg_
         Thread *thread = exe_ctx.GetThreadPtr();
         if (process == NULL || thread == NULL)
             return false;
+        if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+            return false;
         
         GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
         
@@ -518,6 +529,8 @@ GDBRemoteRegisterContext::ReadAllRegisterValues (lldb::DataBufferSP &data_sp)
     Thread *thread = exe_ctx.GetThreadPtr();
     if (process == NULL || thread == NULL)
         return false;
+    if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+        return false;
 
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 
@@ -628,6 +641,8 @@ GDBRemoteRegisterContext::WriteAllRegisterValues (const lldb::DataBufferSP &data
     Thread *thread = exe_ctx.GetThreadPtr();
     if (process == NULL || thread == NULL)
         return false;
+    if (static_cast<ThreadGDBRemote *>(thread)->IsRunningInNonStopMode())
+        return false;
 
     GDBRemoteCommunicationClient &gdb_comm (((ProcessGDBRemote *)process)->GetGDBRemote());
 
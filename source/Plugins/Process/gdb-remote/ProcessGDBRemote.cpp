@@ -25,6 +25,8 @@
 #include <map>
 #include <mutex>
 
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Core/ArchSpec.h"
@@ -59,12 +61,14 @@
 #include "lldb/Target/DynamicLoader.h"
 #include "lldb/Target/Target.h"
 #include "lldb/Target/TargetList.h"
+#include "lldb/Target/ThreadSpec.h"
 #include "lldb/Target/ThreadPlanCallFunction.h"
 #include "lldb/Target/SystemRuntime.h"
 #include "lldb/Utility/PseudoTerminal.h"
 
 // Project includes
 #include "lldb/Host/Host.h"
+#include "Plugins/Process/Utility/BreakpointConditionCompiler.h"
 #include "Plugins/Process/Utility/FreeBSDSignals.h"
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "Plugins/Process/Utility/LinuxSignals.h"
@@ -385,12 +389,19 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_max_memory_size (0),
     m_remote_stub_max_memory_size (0),
     m_addr_to_mmap_size (),
+    m_memory_region_map (),
+    m_memory_region_map_generation (0),
+    m_memory_region_map_stop_id (UINT32_MAX),
+    m_memory_region_map_mutex (),
     m_thread_create_bp_sp (),
     m_waiting_for_attach (false),
     m_destroy_tried_resuming (false),
     m_command_sp (),
     m_breakpoint_pc_offset (0),
-    m_initial_tid (LLDB_INVALID_THREAD_ID)
+    m_initial_tid (LLDB_INVALID_THREAD_ID),
+    m_tracepoint_layouts (),
+    m_tracepoint_records (),
+    m_tracepoint_num_dropped (0)
 {
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncThreadShouldExit,   "async thread should exit");
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncContinue,           "async thread continue");
@@ -1696,6 +1707,64 @@ ProcessGDBRemote::HandleStopReplySequence ()
     }
 }
 
+//----------------------------------------------------------------------
+// In non-stop mode other threads keep running while the process is
+// stopped, and when one of them stops the stub sends a "%Stop"
+// notification, even while we wait for the reply to another packet.
+// GDBRemoteCommunication queues those for us. Give the thread its stop
+// info, as if it had stopped together with the thread that stopped the
+// process, and fetch the stop replies queued behind the notification.
+//----------------------------------------------------------------------
+void
+ProcessGDBRemote::HandleStopNotifications ()
+{
+    // While the process is running, the notification is the reply to the
+    // continue packet and SendContinuePacketAndWaitForResponse() takes it.
+    if (!StateIsStoppedState (GetPrivateState (), false))
+        return;
+
+    StringExtractorGDBRemote notification;
+    while (m_gdb_comm.GetNotification (notification))
+    {
+        if (notification.GetStringRef ().compare (0, 5, "Stop:") != 0)
+            continue;
+        notification.GetStringRef ().erase (0, 5);
+
+        std::vector<StringExtractorGDBRemote> stop_packets (1, notification);
+        while (true)
+        {
+            StringExtractorGDBRemote response;
+            if (m_gdb_comm.SendPacketAndWaitForResponse ("vStopped", response, false) != GDBRemoteCommunication::PacketResult::Success)
+                break;
+            // OK represents end of signal list
+            if (response.IsOKResponse () || !response.IsNormalResponse ())
+                break;
+            stop_packets.push_back (response);
+        }
+
+        Mutex::Locker locker (m_thread_list_real.GetMutex ());
+        for (StringExtractorGDBRemote &stop_packet : stop_packets)
+            SetThreadStopInfo (stop_packet);
+    }
+}
+
+//----------------------------------------------------------------------
+// In non-stop mode only the threads that the stub reported are stopped,
+// the others keep running while we look at those. Mark the running ones
+// so that we don't ask the stub for their stop info or resume them.
+//----------------------------------------------------------------------
+void
+ProcessGDBRemote::SetNonStopThreadState (Thread &thread)
+{
+    if (m_non_stop_stopped_tids.count (thread.GetProtocolID ()) == 0)
+    {
+        thread.SetStopInfo (StopInfoSP ());
+        thread.SetState (eStateRunning);
+    }
+    else
+        thread.SetState (eStateStopped);
+}
+
 void
 ProcessGDBRemote::ClearThreadIDList ()
 {
@@ -1744,6 +1813,8 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
             if (!thread_sp)
             {
                 thread_sp.reset (new ThreadGDBRemote (*this, tid));
+                if (GetTarget().GetNonStopModeEnabled())
+                    SetNonStopThreadState (*thread_sp);
                 if (log && log->GetMask().Test(GDBR_LOG_VERBOSE))
                     log->Printf(
                             "ProcessGDBRemote::%s Making new thread: %p for thread ID: 0x%" PRIx64 ".\n",
@@ -1955,6 +2026,16 @@ ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
 
             if (thread_sp)
             {
+                if (GetTarget().GetNonStopModeEnabled())
+                {
+                    // A thread that was running couldn't be unwound, don't
+                    // keep the frames from back then.
+                    if (thread_sp->GetState () == eStateRunning)
+                        thread_sp->ClearStackFrames ();
+                    m_non_stop_stopped_tids.insert (thread_sp->GetProtocolID ());
+                    thread_sp->SetState (eStateStopped);
+                }
+
                 // Clear the stop info just in case we don't set it to anything
                 thread_sp->SetStopInfo (StopInfoSP());
 
@@ -2157,6 +2238,13 @@ ProcessGDBRemote::RefreshStateAfterStop ()
         m_initial_tid = LLDB_INVALID_THREAD_ID;
     }
 
+    if (GetTarget().GetNonStopModeEnabled())
+    {
+        const uint32_t num_threads = m_thread_list_real.GetSize (false);
+        for (uint32_t i = 0; i < num_threads; ++i)
+            SetNonStopThreadState (*m_thread_list_real.GetThreadAtIndex (i, false));
+    }
+
     // Let all threads recover from stopping and do any clean up based
     // on the previous thread state (if any).
     m_thread_list_real.RefreshStateAfterStop();
@@ -2423,6 +2511,7 @@ ProcessGDBRemote::SetLastStopPacket (const StringExtractorGDBRemote &response)
 
         m_thread_list_real.Clear();
         m_thread_list.Clear();
+        m_non_stop_stopped_tids.clear();
         BuildDynamicRegisterInfo (true);
         m_gdb_comm.ResetDiscoverableSettings();
     }
@@ -2449,6 +2538,12 @@ ProcessGDBRemote::IsAlive ()
     return m_gdb_comm.IsConnected() && m_private_state.GetValue() != eStateExited;
 }
 
+bool
+ProcessGDBRemote::SupportsDisplacedStepping ()
+{
+    return m_gdb_comm.GetDisplacedSteppingSupported();
+}
+
 addr_t
 ProcessGDBRemote::GetImageInfoAddress()
 {
@@ -2533,6 +2628,74 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
     return 0;
 }
 
+void
+ProcessGDBRemote::AddStatistics (StructuredData::Dictionary &dict)
+{
+    Process::AddStatistics (dict);
+
+    StructuredData::DictionarySP gdb_remote_dict_sp (new StructuredData::Dictionary());
+    m_gdb_comm.AddPacketStatistics (*gdb_remote_dict_sp);
+    dict.AddItem ("gdb_remote", gdb_remote_dict_sp);
+}
+
+void
+ProcessGDBRemote::DoReadMemoryRanges (MemoryReadRanges &ranges)
+{
+    if (!m_gdb_comm.GetReadMemoryRangesSupported())
+    {
+        Process::DoReadMemoryRanges (ranges);
+        return;
+    }
+
+    GetMaxMemorySize ();
+
+    // Each range costs its hex encoded bytes plus a byte count and
+    // separators in the response, and its address and size in the
+    // request. Pack as many ranges as fit into each qReadMemoryRanges
+    // packet and read anything too large to share a packet on its own.
+    const size_t range_overhead = 40;
+    const size_t num_ranges = ranges.size();
+    MemoryReadRanges batch;
+    std::vector<size_t> batch_indexes;
+    size_t batch_byte_size = 0;
+    for (size_t i = 0; i <= num_ranges; ++i)
+    {
+        size_t range_byte_size = 0;
+        if (i < num_ranges)
+        {
+            range_byte_size = ranges[i].size * 2 + range_overhead;
+            if (range_byte_size > m_max_memory_size)
+            {
+                MemoryReadRanges large_range (1, ranges[i]);
+                Process::DoReadMemoryRanges (large_range);
+                ranges[i] = large_range[0];
+                continue;
+            }
+        }
+
+        if (i == num_ranges || batch_byte_size + range_byte_size > m_max_memory_size)
+        {
+            if (!batch.empty())
+            {
+                if (!m_gdb_comm.ReadMemoryRanges (&batch[0], batch.size()))
+                    Process::DoReadMemoryRanges (batch);
+                for (size_t j = 0; j < batch.size(); ++j)
+                    ranges[batch_indexes[j]] = batch[j];
+                batch.clear();
+                batch_indexes.clear();
+                batch_byte_size = 0;
+            }
+        }
+
+        if (i < num_ranges)
+        {
+            batch.push_back (ranges[i]);
+            batch_indexes.push_back (i);
+            batch_byte_size += range_byte_size;
+        }
+    }
+}
+
 size_t
 ProcessGDBRemote::DoWriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
 {
@@ -2575,6 +2738,9 @@ ProcessGDBRemote::DoAllocateMemory (size_t size, uint32_t permissions, Error &er
 {
     Log *log (GetLogIfAnyCategoriesSet (LIBLLDB_LOG_PROCESS|LIBLLDB_LOG_EXPRESSIONS));
     addr_t allocated_addr = LLDB_INVALID_ADDRESS;
+
+    // Allocating memory changes the memory map.
+    InvalidateMemoryRegionMap();
     
     LazyBool supported = m_gdb_comm.SupportsAllocDeallocMemory();
     switch (supported)
@@ -2618,11 +2784,38 @@ Error
 ProcessGDBRemote::GetMemoryRegionInfo (addr_t load_addr, 
                                        MemoryRegionInfo &region_info)
 {
-    
+    // If the stub can send its whole memory map, answer from a copy of it.
+    // The copy is checked at most once per stop, and the stub only sends
+    // the map again when the mappings have changed.
+    if (m_gdb_comm.GetMemoryRegionMapSupported())
+    {
+        Mutex::Locker locker (m_memory_region_map_mutex);
+        const uint32_t stop_id = GetStopID();
+        if (m_memory_region_map_stop_id != stop_id)
+        {
+            if (!m_gdb_comm.GetMemoryRegionMap (m_memory_region_map, m_memory_region_map_generation))
+                m_memory_region_map.clear();
+            m_memory_region_map_stop_id = stop_id;
+        }
+
+        // Let the stub answer for addresses past the end of the map.
+        region_info.Clear();
+        if (MemoryRegionInfo::FindRegion (m_memory_region_map, load_addr, region_info))
+            return Error();
+    }
+
     Error error (m_gdb_comm.GetMemoryRegionInfo (load_addr, region_info));
     return error;
 }
 
+void
+ProcessGDBRemote::InvalidateMemoryRegionMap ()
+{
+    // Keep the map itself so the stub can tell us if it's still current.
+    Mutex::Locker locker (m_memory_region_map_mutex);
+    m_memory_region_map_stop_id = UINT32_MAX;
+}
+
 Error
 ProcessGDBRemote::GetWatchpointSupportInfo (uint32_t &num)
 {
@@ -2638,10 +2831,25 @@ ProcessGDBRemote::GetWatchpointSupportInfo (uint32_t &num, bool& after)
     return error;
 }
 
+Error
+ProcessGDBRemote::GetWatchpointOverhead (Watchpoint *wp, uint32_t &num_pages, uint64_t &num_faults, uint64_t &num_hits)
+{
+    if (wp == nullptr || !wp->IsEnabled ())
+    {
+        Error error;
+        error.SetErrorString ("watchpoint is not enabled");
+        return error;
+    }
+    return m_gdb_comm.GetWatchpointOverhead (wp->GetLoadAddress (), num_pages, num_faults, num_hits);
+}
+
 Error
 ProcessGDBRemote::DoDeallocateMemory (lldb::addr_t addr)
 {
     Error error; 
+
+    // Deallocating memory changes the memory map.
+    InvalidateMemoryRegionMap();
     LazyBool supported = m_gdb_comm.SupportsAllocDeallocMemory();
 
     switch (supported)
@@ -2729,12 +2937,20 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     // skip over software breakpoints.
     if (m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && (!bp_site->HardwareRequired()))
     {
+        // Let the stub skip the hits where the conditions are false,
+        // instead of stopping and reporting each of them to us.
+        std::vector<std::vector<uint8_t>> conditions;
+        const bool has_conditions = m_gdb_comm.GetConditionalBreakpointsSupported() &&
+                                    GetBreakpointSiteConditions(bp_site, conditions);
+
         // Try to send off a software breakpoint packet ($Z0)
-        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size) == 0)
+        if (m_gdb_comm.SendGDBStoppointTypePacket(eBreakpointSoftware, true, addr, bp_op_size,
+                                                  has_conditions ? &conditions : nullptr) == 0)
         {
             // The breakpoint was placed successfully
             bp_site->SetEnabled(true);
             bp_site->SetType(BreakpointSite::eExternal);
+            SetBreakpointSiteTracepoint(bp_site, has_conditions);
             return error;
         }
 
@@ -2798,6 +3014,295 @@ ProcessGDBRemote::EnableBreakpointSite (BreakpointSite *bp_site)
     return EnableSoftwareBreakpoint(bp_site);
 }
 
+void
+ProcessGDBRemote::UpdateBreakpointSites (const std::vector<BreakpointSiteSP> &enable_sites,
+                                         const std::vector<BreakpointSiteSP> &disable_sites,
+                                         std::vector<Error> &enable_errors)
+{
+    if (!m_gdb_comm.GetBreakpointBatchesSupported())
+    {
+        Process::UpdateBreakpointSites (enable_sites, disable_sites, enable_errors);
+        return;
+    }
+
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+
+    // Plain software breakpoints, the ones EnableBreakpointSite() sets with
+    // a "Z0" packet without conditions, are changed together with
+    // "QBreakpoints" packets, removals first. The stub keeps more than the
+    // breakpoint for the others, so they are changed one at a time.
+    std::vector<GDBRemoteCommunicationClient::BreakpointUpdate> updates;
+    std::vector<BreakpointSite *> update_sites;
+    std::vector<size_t> update_enable_indexes;  // Into enable_sites, for the insertions
+    std::vector<BreakpointSite *> single_disable_sites;
+    std::vector<size_t> single_enable_indexes;
+    for (const BreakpointSiteSP &bp_site_sp : disable_sites)
+    {
+        BreakpointSite *bp_site = bp_site_sp.get();
+        const addr_t addr = bp_site->GetLoadAddress();
+        if (bp_site->IsEnabled() && bp_site->GetType() == BreakpointSite::eExternal && !bp_site->IsHardware() &&
+            m_tracepoint_layouts.find(addr) == m_tracepoint_layouts.end())
+        {
+            GDBRemoteCommunicationClient::BreakpointUpdate update = { false, addr, (uint32_t)GetSoftwareBreakpointTrapOpcode(bp_site), false };
+            updates.push_back(update);
+            update_sites.push_back(bp_site);
+            update_enable_indexes.push_back(UINT32_MAX);
+        }
+        else
+            single_disable_sites.push_back(bp_site);
+    }
+
+    enable_errors.assign(enable_sites.size(), Error());
+    for (size_t i = 0; i < enable_sites.size(); ++i)
+    {
+        BreakpointSite *bp_site = enable_sites[i].get();
+        std::vector<std::vector<uint8_t>> conditions;
+        if (!bp_site->IsEnabled() && m_gdb_comm.SupportsGDBStoppointPacket(eBreakpointSoftware) && !bp_site->HardwareRequired() &&
+            !(m_gdb_comm.GetConditionalBreakpointsSupported() && GetBreakpointSiteConditions(bp_site, conditions)))
+        {
+            GDBRemoteCommunicationClient::BreakpointUpdate update = { true, bp_site->GetLoadAddress(), (uint32_t)GetSoftwareBreakpointTrapOpcode(bp_site), false };
+            updates.push_back(update);
+            update_sites.push_back(bp_site);
+            update_enable_indexes.push_back(i);
+        }
+        else
+            single_enable_indexes.push_back(i);
+    }
+
+    if (log)
+        log->Printf("ProcessGDBRemote::%s %" PRIu64 " breakpoint changes in batches, %" PRIu64 " one at a time", __FUNCTION__,
+                    (uint64_t)updates.size(), (uint64_t)(single_disable_sites.size() + single_enable_indexes.size()));
+
+    for (BreakpointSite *bp_site : single_disable_sites)
+        DisableBreakpointSite(bp_site);
+
+    // Each update takes at most "Z0,<16 hex digits>,<kind>;" in the packet.
+    GetMaxMemorySize ();
+    const size_t update_byte_size = 24;
+    const size_t max_batch_size = std::max<size_t>(m_max_memory_size / update_byte_size, 1);
+    for (size_t start = 0; start < updates.size(); start += max_batch_size)
+    {
+        const size_t batch_size = std::min(updates.size() - start, max_batch_size);
+        const bool sent = m_gdb_comm.SendBreakpointUpdates(&updates[start], batch_size);
+        for (size_t i = start; i < start + batch_size; ++i)
+        {
+            const bool applied = sent && updates[i].applied;
+            BreakpointSite *bp_site = update_sites[i];
+            if (!updates[i].insert)
+            {
+                if (applied)
+                    bp_site->SetEnabled(false);
+                else
+                    DisableBreakpointSite(bp_site);
+            }
+            else if (applied)
+            {
+                bp_site->SetEnabled(true);
+                bp_site->SetType(BreakpointSite::eExternal);
+                SetBreakpointSiteTracepoint(bp_site, false);
+            }
+            else
+                enable_errors[update_enable_indexes[i]] = EnableBreakpointSite(bp_site);
+        }
+    }
+
+    for (size_t i : single_enable_indexes)
+        enable_errors[i] = EnableBreakpointSite(enable_sites[i].get());
+}
+
+// Clearing a breakpoint's thread leaves an empty thread spec behind.
+static bool
+HasThreadSpecification (const BreakpointOptions *options)
+{
+    const ThreadSpec *thread_spec = options->GetThreadSpecNoCreate();
+    return thread_spec != nullptr && thread_spec->HasSpecification();
+}
+
+bool
+ProcessGDBRemote::GetBreakpointSiteConditions (BreakpointSite *bp_site,
+                                               std::vector<std::vector<uint8_t>> &conditions)
+{
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+
+    ThreadSP thread_sp (GetThreadList().GetThreadAtIndex(0, false));
+    if (!thread_sp)
+        return false;
+
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    if (num_owners == 0)
+        return false;
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp (bp_site->GetOwnerAtIndex(i));
+        if (!location_sp)
+            return false;
+
+        // Ignore counts and thread specific breakpoints are handled when
+        // the stop is reported, and need to see every hit.
+        Breakpoint &breakpoint = location_sp->GetBreakpoint();
+        const char *condition = location_sp->GetConditionText();
+        if (condition == nullptr || condition[0] == '\0' ||
+            location_sp->GetIgnoreCount() > 0 || breakpoint.GetIgnoreCount() > 0 ||
+            HasThreadSpecification(location_sp->GetOptionsNoCreate()) ||
+            HasThreadSpecification(breakpoint.GetOptions()))
+            return false;
+
+        AgentExpression expr;
+        BreakpointConditionCompiler compiler (*thread_sp, location_sp->GetAddress());
+        Error error (compiler.Compile(condition, expr));
+        if (error.Fail())
+        {
+            if (log)
+                log->Printf ("ProcessGDBRemote::%s condition \"%s\" of breakpoint %d is checked by the debugger: %s",
+                             __FUNCTION__, condition, breakpoint.GetID(), error.AsCString());
+            return false;
+        }
+        conditions.push_back(expr.GetBytes());
+    }
+    return true;
+}
+
+void
+ProcessGDBRemote::SetBreakpointSiteTracepoint (BreakpointSite *bp_site, bool has_conditions)
+{
+    Log *log(ProcessGDBRemoteLog::GetLogIfAllCategoriesSet(GDBR_LOG_BREAKPOINTS));
+
+    const size_t num_owners = bp_site->GetNumberOfOwners();
+    if (num_owners == 0 || !m_gdb_comm.GetTracepointsSupported())
+        return;
+    ThreadSP thread_sp (GetThreadList().GetThreadAtIndex(0, false));
+    if (!thread_sp)
+        return;
+
+    // The stub doesn't report the hits of tracepoints, so every owner has
+    // to be one, and must not need to see the hits to check conditions,
+    // ignore counts or threads.
+    std::vector<TracepointLayout> layouts;
+    std::vector<GDBRemoteCommunicationClient::TracepointItem> items;
+    for (size_t i = 0; i < num_owners; ++i)
+    {
+        BreakpointLocationSP location_sp (bp_site->GetOwnerAtIndex(i));
+        if (!location_sp || !location_sp->GetBreakpoint().IsTracepoint())
+            return;
+        Breakpoint &breakpoint = location_sp->GetBreakpoint();
+        const char *condition = location_sp->GetConditionText();
+        if ((condition != nullptr && condition[0] != '\0' && !has_conditions) ||
+            location_sp->GetIgnoreCount() > 0 || breakpoint.GetIgnoreCount() > 0 ||
+            HasThreadSpecification(location_sp->GetOptionsNoCreate()) ||
+            HasThreadSpecification(breakpoint.GetOptions()))
+        {
+            if (log)
+                log->Printf ("ProcessGDBRemote::%s tracepoint %d stops at each hit, its options are checked by the debugger",
+                             __FUNCTION__, breakpoint.GetID());
+            return;
+        }
+
+        TracepointLayout layout;
+        layout.break_id = breakpoint.GetID();
+        layout.loc_id = location_sp->GetID();
+        const StringList &collect = breakpoint.GetTracepointCollect();
+        for (size_t j = 0; j < collect.GetSize(); ++j)
+        {
+            const char *name = collect.GetStringAtIndex(j);
+            GDBRemoteCommunicationClient::TracepointItem item;
+            AgentExpression address_expr;
+            BreakpointConditionCompiler compiler (*thread_sp, location_sp->GetAddress());
+            Error error (compiler.CompileCollect(name, item.reg_num, address_expr, item.byte_size));
+            layout.names.push_back(name);
+            if (error.Fail())
+            {
+                // Leave the item out, it is reported as unavailable.
+                if (log)
+                    log->Printf ("ProcessGDBRemote::%s can't collect \"%s\" for tracepoint %d: %s",
+                                 __FUNCTION__, name, breakpoint.GetID(), error.AsCString());
+                layout.item_indexes.push_back(-1);
+                continue;
+            }
+            item.address_expr = address_expr.GetBytes();
+            layout.item_indexes.push_back(items.size());
+            items.push_back(item);
+        }
+        layouts.push_back(layout);
+    }
+    if (items.empty())
+        return;
+
+    const addr_t addr = bp_site->GetLoadAddress();
+    Error error (m_gdb_comm.SetTracepoint(addr, items));
+    if (error.Fail())
+    {
+        if (log)
+            log->Printf ("ProcessGDBRemote::%s 0x%" PRIx64 ": %s", __FUNCTION__, addr, error.AsCString());
+        return;
+    }
+    m_tracepoint_layouts[addr] = std::move(layouts);
+}
+
+void
+ProcessGDBRemote::BreakpointSiteConditionsChanged (BreakpointSite *bp_site)
+{
+    if (!bp_site->IsEnabled() || bp_site->GetType() != BreakpointSite::eExternal || bp_site->IsHardware() ||
+        (!m_gdb_comm.GetConditionalBreakpointsSupported() && !m_gdb_comm.GetTracepointsSupported()))
+        return;
+
+    // Insert the breakpoint again to replace the conditions and tracepoint
+    // items the stub has.
+    DisableBreakpointSite(bp_site);
+    if (!bp_site->IsEnabled())
+        EnableBreakpointSite(bp_site);
+}
+
+bool
+ProcessGDBRemote::CollectsTracepointData (BreakpointSite *bp_site)
+{
+    return m_tracepoint_layouts.find(bp_site->GetLoadAddress()) != m_tracepoint_layouts.end();
+}
+
+Error
+ProcessGDBRemote::FetchTracepointData ()
+{
+    std::vector<GDBRemoteCommunicationClient::TracepointData> raw_records;
+    Error error (m_gdb_comm.GetTracepointData(raw_records, m_tracepoint_num_dropped));
+
+    // The stub sends the items of all owners of a site together, split
+    // them up into a record per tracepoint location.
+    for (const GDBRemoteCommunicationClient::TracepointData &raw_record : raw_records)
+    {
+        TracepointLayoutMap::const_iterator pos = m_tracepoint_layouts.find(raw_record.addr);
+        if (pos == m_tracepoint_layouts.end())
+            continue;
+        for (const TracepointLayout &layout : pos->second)
+        {
+            TracepointRecord record;
+            record.break_id = layout.break_id;
+            record.loc_id = layout.loc_id;
+            record.tid = raw_record.tid;
+            record.addr = raw_record.addr;
+            for (size_t i = 0; i < layout.names.size(); ++i)
+            {
+                TracepointRecord::Value value;
+                value.name = layout.names[i];
+                const int32_t index = layout.item_indexes[i];
+                if (index >= 0 && static_cast<size_t>(index) < raw_record.values.size())
+                    value.data_sp = raw_record.values[index];
+                record.values.push_back(value);
+            }
+            m_tracepoint_records.push_back(record);
+        }
+    }
+    return error;
+}
+
+Error
+ProcessGDBRemote::GetTracepointData (TracepointRecords &records, uint64_t &num_dropped)
+{
+    Error error (FetchTracepointData());
+    records.insert(records.end(), m_tracepoint_records.begin(), m_tracepoint_records.end());
+    m_tracepoint_records.clear();
+    num_dropped = m_tracepoint_num_dropped;
+    return error;
+}
+
 Error
 ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
 {
@@ -2832,6 +3337,15 @@ ProcessGDBRemote::DisableBreakpointSite (BreakpointSite *bp_site)
                     stoppoint_type = eBreakpointHardware;
                 else
                     stoppoint_type = eBreakpointSoftware;
+
+                // Get what the stub collected with the current layout
+                // before the items go away with the breakpoint.
+                TracepointLayoutMap::iterator pos = m_tracepoint_layouts.find(addr);
+                if (pos != m_tracepoint_layouts.end())
+                {
+                    FetchTracepointData();
+                    m_tracepoint_layouts.erase(pos);
+                }
                 
                 if (m_gdb_comm.SendGDBStoppointTypePacket(stoppoint_type, false, addr, bp_op_size))
                 error.SetErrorToGenericError();
@@ -3239,7 +3753,8 @@ ProcessGDBRemote::AsyncThread (void *arg)
 
     if (listener.StartListeningForEvents (&process->m_async_broadcaster, desired_event_mask) == desired_event_mask)
     {
-        listener.StartListeningForEvents (&process->m_gdb_comm, Communication::eBroadcastBitReadThreadDidExit);
+        listener.StartListeningForEvents (&process->m_gdb_comm, Communication::eBroadcastBitReadThreadDidExit |
+                                                                GDBRemoteCommunication::eBroadcastBitNotification);
     
         bool done = false;
         while (!done)
@@ -3284,6 +3799,10 @@ ProcessGDBRemote::AsyncThread (void *arg)
                                     case eStateCrashed:
                                     case eStateSuspended:
                                         process->SetLastStopPacket (response);
+                                        // In non-stop mode the stop that ended the continue came
+                                        // as a notification, fetch any others that are queued.
+                                        if (process->GetTarget().GetNonStopModeEnabled())
+                                            process->HandleStopReplySequence ();
                                         process->SetPrivateState (stop_state);
                                         break;
 
@@ -3347,6 +3866,8 @@ ProcessGDBRemote::AsyncThread (void *arg)
                         process->SetExitStatus (-1, "lost connection");
                         done = true;
                     }
+                    else if (event_type & GDBRemoteCommunication::eBroadcastBitNotification)
+                        process->HandleStopNotifications ();
                 }
             }
             else
@@ -14,6 +14,8 @@
 
 // C++ Includes
 #include <list>
+#include <map>
+#include <set>
 #include <vector>
 
 // Other libraries and framework includes
@@ -27,6 +29,7 @@
 #include "lldb/Core/ThreadSafeValue.h"
 #include "lldb/Host/HostThread.h"
 #include "lldb/lldb-private-forward.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/Thread.h"
 
@@ -158,15 +161,24 @@ public:
     bool
     IsAlive () override;
 
+    bool
+    SupportsDisplacedStepping () override;
+
     lldb::addr_t
     GetImageInfoAddress() override;
 
+    void
+    AddStatistics (StructuredData::Dictionary &dict) override;
+
     //------------------------------------------------------------------
     // Process Memory
     //------------------------------------------------------------------
     size_t
     DoReadMemory (lldb::addr_t addr, void *buf, size_t size, Error &error) override;
 
+    void
+    DoReadMemoryRanges (MemoryReadRanges &ranges) override;
+
     size_t
     DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, Error &error) override;
 
@@ -194,6 +206,20 @@ public:
     Error
     DisableBreakpointSite (BreakpointSite *bp_site) override;
 
+    void
+    UpdateBreakpointSites (const std::vector<lldb::BreakpointSiteSP> &enable_sites,
+                           const std::vector<lldb::BreakpointSiteSP> &disable_sites,
+                           std::vector<Error> &enable_errors) override;
+
+    void
+    BreakpointSiteConditionsChanged (BreakpointSite *bp_site) override;
+
+    bool
+    CollectsTracepointData (BreakpointSite *bp_site) override;
+
+    Error
+    GetTracepointData (TracepointRecords &records, uint64_t &num_dropped) override;
+
     //----------------------------------------------------------------------
     // Process Watchpoints
     //----------------------------------------------------------------------
@@ -208,6 +234,9 @@ public:
     
     Error
     GetWatchpointSupportInfo (uint32_t &num, bool& after) override;
+
+    Error
+    GetWatchpointOverhead (Watchpoint *wp, uint32_t &num_pages, uint64_t &num_faults, uint64_t &num_hits) override;
     
     bool
     StartNoticingNewThreads() override;
@@ -308,6 +337,30 @@ protected:
     void
     SetLastStopPacket (const StringExtractorGDBRemote &response);
 
+    //------------------------------------------------------------------
+    /// Compile the conditions of the owners of \a bp_site for the stub.
+    ///
+    /// @return
+    ///     False if any owner would stop without a condition, or has a
+    ///     condition or options the stub can't check. The conditions
+    ///     are then left to be checked when the stop is reported.
+    //------------------------------------------------------------------
+    bool
+    GetBreakpointSiteConditions (BreakpointSite *bp_site,
+                                 std::vector<std::vector<uint8_t>> &conditions);
+
+    //------------------------------------------------------------------
+    /// Have the stub collect the data of the tracepoints that own
+    /// \a bp_site, which was just inserted with a "Z0" packet, if all
+    /// of its owners are tracepoints whose hits the stub can filter.
+    //------------------------------------------------------------------
+    void
+    SetBreakpointSiteTracepoint (BreakpointSite *bp_site, bool has_conditions);
+
+    // Move the data the stub collected into m_tracepoint_records.
+    Error
+    FetchTracepointData ();
+
     bool
     ParsePythonTargetDefinition(const FileSpec &target_definition_fspec);
 
@@ -320,6 +373,11 @@ protected:
     void
     GetMaxMemorySize();
 
+    // Make the next GetMemoryRegionInfo() check with the stub that the
+    // memory map hasn't changed.
+    void
+    InvalidateMemoryRegionMap ();
+
     //------------------------------------------------------------------
     /// Broadcaster event bits definitions.
     //------------------------------------------------------------------
@@ -347,9 +405,14 @@ protected:
     tid_sig_collection m_continue_C_tids; // 'C' for continue with signal
     tid_collection m_continue_s_tids;                  // 's' for step
     tid_sig_collection m_continue_S_tids; // 'S' for step with signal
+    std::set<lldb::tid_t> m_non_stop_stopped_tids; // Non-stop mode: threads the stub reported stopped that haven't been resumed since
     uint64_t m_max_memory_size;       // The maximum number of bytes to read/write when reading and writing memory
     uint64_t m_remote_stub_max_memory_size;    // The maximum memory size the remote gdb stub can handle
     MMapMap m_addr_to_mmap_size;
+    std::vector<MemoryRegionInfo> m_memory_region_map; // Memory map from the stub, sorted by address
+    uint32_t m_memory_region_map_generation;   // The stub's generation number for m_memory_region_map
+    uint32_t m_memory_region_map_stop_id;      // The stop ID m_memory_region_map is current for
+    Mutex m_memory_region_map_mutex;
     lldb::BreakpointSP m_thread_create_bp_sp;
     bool m_waiting_for_attach;
     bool m_destroy_tried_resuming;
@@ -357,6 +420,20 @@ protected:
     int64_t m_breakpoint_pc_offset;
     lldb::tid_t m_initial_tid; // The inital thread ID, given by stub on attach
 
+    // How the items the stub collects at a breakpoint site map to the
+    // collect lists of the tracepoints that own it.
+    struct TracepointLayout
+    {
+        lldb::break_id_t break_id;
+        lldb::break_id_t loc_id;
+        std::vector<std::string> names;
+        std::vector<int32_t> item_indexes; // -1 for items the stub can't collect
+    };
+    typedef std::map<lldb::addr_t, std::vector<TracepointLayout>> TracepointLayoutMap;
+    TracepointLayoutMap m_tracepoint_layouts; // Breakpoint sites the stub collects data for
+    TracepointRecords m_tracepoint_records;   // Fetched, but not yet handed out
+    uint64_t m_tracepoint_num_dropped;
+
     bool
     StartAsyncThread ();
 
@@ -379,6 +456,12 @@ protected:
     void
     HandleStopReplySequence ();
 
+    void
+    HandleStopNotifications ();
+
+    void
+    SetNonStopThreadState (Thread &thread);
+
     void
     ClearThreadIDList ();
 
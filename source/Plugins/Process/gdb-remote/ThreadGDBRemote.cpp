@@ -174,6 +174,13 @@ ThreadGDBRemote::WillResume (StateType resume_state)
     if (process_sp)
     {
         ProcessGDBRemote *gdb_process = static_cast<ProcessGDBRemote *>(process_sp.get());
+        // In non-stop mode a thread that the stub didn't report is still
+        // running, there's nothing to resume.
+        if (IsRunningInNonStopMode())
+            return;
+        const bool non_stop = gdb_process->GetTarget().GetNonStopModeEnabled();
+        if (non_stop && (resume_state == eStateRunning || resume_state == eStateStepping))
+            gdb_process->m_non_stop_stopped_tids.erase(tid);
         switch (resume_state)
         {
         case eStateSuspended:
@@ -279,6 +286,13 @@ ThreadGDBRemote::PrivateSetRegisterValue (uint32_t reg, StringExtractor &respons
     return gdb_reg_ctx->PrivateSetRegisterValue (reg, response);
 }
 
+bool
+ThreadGDBRemote::IsRunningInNonStopMode ()
+{
+    ProcessSP process_sp (GetProcess());
+    return process_sp && process_sp->GetTarget().GetNonStopModeEnabled() && GetState() == eStateRunning;
+}
+
 bool
 ThreadGDBRemote::CalculateStopInfo ()
 {
@@ -287,6 +301,9 @@ ThreadGDBRemote::CalculateStopInfo ()
     {
         StringExtractorGDBRemote stop_packet;
         ProcessGDBRemote *gdb_process = static_cast<ProcessGDBRemote *>(process_sp.get());
+        // A thread that is still running in non-stop mode has no stop info.
+        if (IsRunningInNonStopMode())
+            return false;
         if (gdb_process->GetGDBRemote().GetThreadStopInfo(GetProtocolID(), stop_packet))
             return gdb_process->SetThreadStopInfo (stop_packet) == eStateStopped;
     }
@@ -94,6 +94,11 @@ public:
     StructuredData::ObjectSP
     FetchThreadExtendedInfo () override;
 
+    // True if the process is in non-stop mode and this thread wasn't
+    // reported as stopped, its registers and frames can't be read.
+    bool
+    IsRunningInNonStopMode ();
+
 protected:
     
     friend class ProcessGDBRemote;
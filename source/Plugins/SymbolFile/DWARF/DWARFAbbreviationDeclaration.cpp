@@ -49,8 +49,13 @@ DWARFAbbreviationDeclaration::Extract(const DWARFDataExtractor& data, lldb::offs
 
         while (data.ValidOffset(*offset_ptr))
         {
-            dw_attr_t attr = data.GetULEB128(offset_ptr);
-            dw_form_t form = data.GetULEB128(offset_ptr);
+            // Each attribute is an attribute and form pair of ULEB128s
+            uint64_t attr_and_form[2];
+            if (data.GetULEB128(offset_ptr, attr_and_form, 2) != 2)
+                break;
+
+            dw_attr_t attr = attr_and_form[0];
+            dw_form_t form = attr_and_form[1];
 
             if (attr && form)
                 m_attributes.push_back(DWARFAttribute(attr, form));
@@ -373,6 +373,28 @@ DWARFCompileUnit::SetDefaultAddressSize(uint8_t addr_size)
     g_default_addr_size = addr_size;
 }
 
+//----------------------------------------------------------------------
+// Get the address ranges described by the compile unit DIE itself
+// (DW_AT_ranges, or DW_AT_low_pc/DW_AT_high_pc) without extracting any
+// of its children. Returns zero if the compile unit DIE doesn't
+// describe its address ranges and the DIEs need to be parsed.
+//
+// Only the compile unit DIE of this compile unit is modified, so this
+// can be called on different compile units from multiple threads as
+// long as the .debug_info and .debug_ranges data have been loaded.
+//----------------------------------------------------------------------
+size_t
+DWARFCompileUnit::GetCompileUnitDIEAddressRanges (SymbolFileDWARF* dwarf2Data,
+                                                  DWARFDebugRanges::RangeList &ranges)
+{
+    ranges.Clear();
+    const DWARFDebugInfoEntry* die = GetCompileUnitDIEOnly();
+    if (die == NULL)
+        return 0;
+    const bool check_hi_lo_pc = true;
+    return die->GetAttributeAddressRanges(dwarf2Data, this, ranges, check_hi_lo_pc);
+}
+
 void
 DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                           DWARFDebugAranges* debug_aranges)
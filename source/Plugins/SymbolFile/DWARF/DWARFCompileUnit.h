@@ -54,8 +54,12 @@ public:
     uint8_t     GetAddressByteSize() const { return m_addr_size; }
     dw_addr_t   GetBaseAddress() const { return m_base_addr; }
     void        ClearDIEs(bool keep_compile_unit_die);
+    size_t      GetNumDIEs() const { return m_die_array.size(); }
+    size_t      GetDIEMemorySize() const { return m_die_array.capacity() * sizeof(DWARFDebugInfoEntry); }
     void        BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
                                         DWARFDebugAranges* debug_aranges);
+    size_t      GetCompileUnitDIEAddressRanges (SymbolFileDWARF* dwarf2Data,
+                                                DWARFDebugRanges::RangeList &ranges);
 
     void
     SetBaseAddress(dw_addr_t base_addr)
@@ -14,6 +14,7 @@
 
 #include <algorithm>
 
+#include "lldb/Core/DataExtractor.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Core/Timer.h"
@@ -105,6 +106,47 @@ DWARFDebugAranges::Generate(SymbolFileDWARF* dwarf2Data)
     return !IsEmpty();
 }
 
+//----------------------------------------------------------------------
+// Encode
+//
+// Each range is written as a 64 bit base address, a 32 bit size and a
+// 32 bit compile unit offset, preceded by the number of ranges.
+//----------------------------------------------------------------------
+void
+DWARFDebugAranges::Encode (Stream &strm) const
+{
+    const size_t num_entries = m_aranges.GetSize();
+    strm.PutHex32 (num_entries);
+    for (size_t i=0; i<num_entries; ++i)
+    {
+        const RangeToDIE::Entry *entry = m_aranges.GetEntryAtIndex(i);
+        strm.PutHex64 (entry->GetRangeBase());
+        strm.PutHex32 (entry->GetByteSize());
+        strm.PutHex32 (entry->data);
+    }
+}
+
+//----------------------------------------------------------------------
+// Decode
+//----------------------------------------------------------------------
+bool
+DWARFDebugAranges::Decode (const DataExtractor &data, lldb::offset_t *offset_ptr)
+{
+    Clear();
+    const uint32_t num_entries = data.GetU32 (offset_ptr);
+    const size_t entry_size = sizeof(uint64_t) + 2 * sizeof(uint32_t);
+    if (!data.ValidOffsetForDataOfSize (*offset_ptr, (uint64_t)num_entries * entry_size))
+        return false;
+
+    for (uint32_t i=0; i<num_entries; ++i)
+    {
+        const dw_addr_t base = data.GetU64 (offset_ptr);
+        const uint32_t size = data.GetU32 (offset_ptr);
+        const dw_offset_t cu_offset = data.GetU32 (offset_ptr);
+        m_aranges.Append (RangeToDIE::Entry (base, size, cu_offset));
+    }
+    return true;
+}
 
 void
 DWARFDebugAranges::Dump (Log *log) const
@@ -39,6 +39,17 @@ public:
 
     bool
     Generate(SymbolFileDWARF* dwarf2Data);
+
+    //------------------------------------------------------------------
+    // Serialize the (sorted) ranges into a host byte order binary blob
+    // that can be saved to disk and read back with Decode().
+    //------------------------------------------------------------------
+    void
+    Encode (lldb_private::Stream &strm) const;
+
+    bool
+    Decode (const lldb_private::DataExtractor &data,
+            lldb::offset_t *offset_ptr);
     
                 // Use append range multiple times and then call sort
     void
@@ -9,12 +9,26 @@
 
 #include "SymbolFileDWARF.h"
 
+#include <string.h>
+
 #include <algorithm>
+#include <atomic>
 #include <set>
+#include <thread>
 
+#include "lldb/Core/DataBuffer.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/Endian.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSystem.h"
+#include "lldb/Host/HostInfo.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Platform.h"
+#include "llvm/Support/FileSystem.h"
 
 #include "DWARFDebugAranges.h"
 #include "DWARFDebugInfo.h"
@@ -57,6 +71,14 @@ DWARFDebugInfo::GetCompileUnitAranges ()
         Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_ARANGES));
 
         m_cu_aranges_ap.reset (new DWARFDebugAranges());
+        if (ReadCachedCompileUnitAranges ())
+        {
+            if (log)
+                log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" from the module cache",
+                             m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
+            return *m_cu_aranges_ap.get();
+        }
+
         const DWARFDataExtractor &debug_aranges_data = m_dwarf2Data->get_debug_aranges_data();
         if (debug_aranges_data.GetByteSize() > 0)
         {
@@ -76,33 +98,228 @@ DWARFDebugInfo::GetCompileUnitAranges ()
                 cus_with_data.insert (offset);
         }
 
-        // Manually build arange data for everything that wasn't in the .debug_aranges table.
-        bool printed = false;
+        std::vector<DWARFCompileUnit*> cus_without_data;
         const size_t num_compile_units = GetNumCompileUnits();
         for (size_t idx = 0; idx < num_compile_units; ++idx)
         {
             DWARFCompileUnit* cu = GetCompileUnitAtIndex(idx);
+            if (cus_with_data.find(cu->GetOffset()) == cus_with_data.end())
+                cus_without_data.push_back(cu);
+        }
 
-            dw_offset_t offset = cu->GetOffset();
-            if (cus_with_data.find(offset) == cus_with_data.end())
+        if (!cus_without_data.empty())
+        {
+            // Most compilers describe the address ranges of a compile unit
+            // right in the compile unit DIE, so try that first before
+            // resorting to parsing all of the DIEs in a compile unit.
+            if (log)
+                log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" from %" PRIu64 " compile unit DIEs",
+                             m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str(),
+                             (uint64_t)cus_without_data.size());
+            AppendCompileUnitDIEAranges (cus_without_data);
+        }
+
+        // Manually build arange data for everything that we still don't have
+        // ranges for.
+        bool printed = false;
+        for (DWARFCompileUnit* cu : cus_without_data)
+        {
+            if (log)
             {
-                if (log)
-                {
-                    if (!printed)
-                        log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" by parsing",
-                                     m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
-                    printed = true;
-                }
-                cu->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get());
+                if (!printed)
+                    log->Printf ("DWARFDebugInfo::GetCompileUnitAranges() for \"%s\" by parsing",
+                                 m_dwarf2Data->GetObjectFile()->GetFileSpec().GetPath().c_str());
+                printed = true;
             }
+            cu->BuildAddressRangeTable (m_dwarf2Data, m_cu_aranges_ap.get());
         }
 
         const bool minimize = true;
         m_cu_aranges_ap->Sort (minimize);
+
+        // Only bother saving the table if we had to compute some of it.
+        if (cus_with_data.size() < num_compile_units)
+            WriteCachedCompileUnitAranges ();
     }
     return *m_cu_aranges_ap.get();
 }
 
+//----------------------------------------------------------------------
+// AppendCompileUnitDIEAranges
+//
+// Add the ranges described by the compile unit DIEs of "compile_units"
+// to the compile unit address range table. The compile unit DIEs are
+// extracted in parallel since each one only touches its own compile
+// unit. On return "compile_units" contains only the compile units whose
+// DIEs didn't describe any address ranges.
+//----------------------------------------------------------------------
+void
+DWARFDebugInfo::AppendCompileUnitDIEAranges (std::vector<DWARFCompileUnit*>& compile_units)
+{
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "%s for %" PRIu64 " compile units",
+                        __PRETTY_FUNCTION__,
+                        (uint64_t)compile_units.size());
+
+    // Load everything the worker threads will read from before spawning
+    // them, the section data and the tables parsed from it are lazily
+    // loaded and not thread safe.
+    m_dwarf2Data->get_debug_info_data();
+    m_dwarf2Data->get_debug_abbrev_data();
+    m_dwarf2Data->get_debug_ranges_data();
+    m_dwarf2Data->get_debug_str_data();
+    m_dwarf2Data->DebugAbbrev();
+    m_dwarf2Data->DebugRanges();
+
+    const size_t num_compile_units = compile_units.size();
+    std::vector<DWARFDebugRanges::RangeList> cu_ranges (num_compile_units);
+    std::atomic<size_t> next_cu_idx (0);
+    auto parse_compile_unit_dies = [&]()
+    {
+        size_t cu_idx;
+        while ((cu_idx = next_cu_idx++) < num_compile_units)
+            compile_units[cu_idx]->GetCompileUnitDIEAddressRanges (m_dwarf2Data, cu_ranges[cu_idx]);
+    };
+
+    const size_t num_threads = std::min<size_t> (HostInfo::GetNumberCPUS(), num_compile_units);
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < num_threads; ++i)
+        threads.push_back (std::thread (parse_compile_unit_dies));
+    parse_compile_unit_dies ();
+    for (std::thread &thread : threads)
+        thread.join();
+
+    size_t num_remaining = 0;
+    for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+    {
+        const DWARFDebugRanges::RangeList &ranges = cu_ranges[cu_idx];
+        const size_t num_ranges = ranges.GetSize();
+        if (num_ranges == 0)
+        {
+            compile_units[num_remaining++] = compile_units[cu_idx];
+            continue;
+        }
+        const dw_offset_t cu_offset = compile_units[cu_idx]->GetOffset();
+        for (size_t i = 0; i < num_ranges; ++i)
+        {
+            const DWARFDebugRanges::RangeList::Entry &range = ranges.GetEntryRef(i);
+            m_cu_aranges_ap->AppendRange (cu_offset, range.GetRangeBase(), range.GetRangeEnd());
+        }
+    }
+    compile_units.resize (num_remaining);
+}
+
+//----------------------------------------------------------------------
+// Compile unit address range tables that had to be computed are saved
+// in the module cache directory, keyed by the UUID of the object file,
+// so the next debug session doesn't need to compute them again:
+//
+//     ${MODULE_CACHE_DIR}/.aranges/${UUID}
+//
+// The file starts with the UUID, modification time and .debug_info size
+// of the object file, and is only used if they all still match.
+//----------------------------------------------------------------------
+static const uint32_t k_aranges_cache_magic = 0x41524e47; // 'ARNG'
+static const uint32_t k_aranges_cache_version = 2;
+
+void
+DWARFDebugInfo::GetCompileUnitArangesCacheHeader (Stream& strm)
+{
+    ObjectFile *obj_file = m_dwarf2Data->GetObjectFile();
+    UUID uuid;
+    obj_file->GetUUID (&uuid);
+
+    strm.PutHex32 (k_aranges_cache_magic);
+    strm.PutHex32 (k_aranges_cache_version);
+    strm.PutHex32 (uuid.GetByteSize());
+    strm.Write (uuid.GetBytes(), uuid.GetByteSize());
+    strm.PutHex64 (obj_file->GetFileSpec().GetModificationTime().GetAsNanoSecondsSinceJan1_1970());
+    strm.PutHex64 (m_dwarf2Data->get_debug_info_data().GetByteSize());
+}
+
+bool
+DWARFDebugInfo::GetCompileUnitArangesCacheFile (FileSpec& cache_file)
+{
+    // OSO object files in a debug map don't have UUIDs and their ranges
+    // depend on the debug map, so they are never cached.
+    if (m_dwarf2Data->GetDebugMapSymfile())
+        return false;
+
+    PlatformPropertiesSP properties_sp = Platform::GetGlobalPlatformProperties ();
+    if (!properties_sp || !properties_sp->GetUseModuleCache ())
+        return false;
+
+    UUID uuid;
+    if (!m_dwarf2Data->GetObjectFile()->GetUUID (&uuid) || !uuid.IsValid())
+        return false;
+
+    cache_file = properties_sp->GetModuleCacheDirectory ();
+    if (!cache_file)
+        return false;
+    cache_file.AppendPathComponent (".aranges");
+    cache_file.AppendPathComponent (uuid.GetAsString ().c_str());
+    return true;
+}
+
+bool
+DWARFDebugInfo::ReadCachedCompileUnitAranges ()
+{
+    FileSpec cache_file;
+    if (!GetCompileUnitArangesCacheFile (cache_file) || !cache_file.Exists())
+        return false;
+
+    DataBufferSP data_sp (cache_file.ReadFileContents ());
+    if (!data_sp)
+        return false;
+
+    StreamString header (Stream::eBinary, sizeof(uint64_t), endian::InlHostByteOrder());
+    GetCompileUnitArangesCacheHeader (header);
+    if (data_sp->GetByteSize() < header.GetSize() ||
+        ::memcmp (data_sp->GetBytes(), header.GetData(), header.GetSize()) != 0)
+        return false;
+
+    DataExtractor data (data_sp, endian::InlHostByteOrder(), sizeof(uint64_t));
+    lldb::offset_t offset = header.GetSize();
+
+    if (!m_cu_aranges_ap->Decode (data, &offset))
+    {
+        m_cu_aranges_ap->Clear();
+        return false;
+    }
+    return true;
+}
+
+void
+DWARFDebugInfo::WriteCachedCompileUnitAranges ()
+{
+    FileSpec cache_file;
+    if (!GetCompileUnitArangesCacheFile (cache_file))
+        return;
+
+    FileSpec cache_dir (cache_file.GetDirectory().AsCString(), false);
+    if (!cache_dir.Exists() &&
+        FileSystem::MakeDirectory (cache_dir, eFilePermissionsDirectoryDefault).Fail())
+        return;
+
+    StreamString strm (Stream::eBinary, sizeof(uint64_t), endian::InlHostByteOrder());
+    GetCompileUnitArangesCacheHeader (strm);
+    m_cu_aranges_ap->Encode (strm);
+
+    // Write to a temporary file and rename it so other debug sessions never
+    // see a partially written cache file.
+    FileSpec tmp_file (cache_file.GetPath() + ".temp", false);
+    File file (tmp_file.GetPath().c_str(),
+               File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate,
+               lldb::eFilePermissionsFileDefault);
+    if (!file.IsValid())
+        return;
+
+    size_t num_bytes = strm.GetSize();
+    const bool wrote = file.Write (strm.GetData(), num_bytes).Success() && num_bytes == strm.GetSize();
+    file.Close();
+    if (!wrote || llvm::sys::fs::rename (tmp_file.GetPath().c_str(), cache_file.GetPath().c_str()))
+        FileSystem::Unlink (tmp_file);
+}
 
 //----------------------------------------------------------------------
 // LookupAddress
@@ -83,6 +83,12 @@ private:
     // All parsing needs to be done partially any managed by this class as accessors are called.
     void ParseCompileUnitHeadersIfNeeded();
 
+    void AppendCompileUnitDIEAranges(std::vector<DWARFCompileUnit*>& compile_units);
+    bool GetCompileUnitArangesCacheFile(lldb_private::FileSpec& cache_file);
+    void GetCompileUnitArangesCacheHeader(lldb_private::Stream& strm);
+    bool ReadCachedCompileUnitAranges();
+    void WriteCachedCompileUnitAranges();
+
     DISALLOW_COPY_AND_ASSIGN (DWARFDebugInfo);
 };
 
@@ -34,7 +34,11 @@ using namespace lldb_private;
 using namespace std;
 extern int g_verbose;
 
-
+static inline bool
+IsLEB128Form (dw_form_t form)
+{
+    return form == DW_FORM_sdata || form == DW_FORM_udata || form == DW_FORM_ref_udata;
+}
 
 DWARFDebugInfoEntry::Attributes::Attributes() :
     m_infos()
@@ -229,7 +233,20 @@ DWARFDebugInfoEntry::FastExtract
                     case DW_FORM_sdata       :
                     case DW_FORM_udata       :
                     case DW_FORM_ref_udata   :
-                        debug_info_data.Skip_LEB128 (&offset);
+                        {
+                            // Runs of LEB 128 attributes (DW_AT_decl_file,
+                            // DW_AT_decl_line, DW_AT_const_value...) are
+                            // common, so skip all of them at once
+                            uint32_t num_leb128_values = 1;
+                            if (abbrevDecl->GetFormByIndexUnchecked (i) != DW_FORM_indirect)
+                            {
+                                while (i + num_leb128_values < numAttributes &&
+                                       IsLEB128Form (abbrevDecl->GetFormByIndexUnchecked (i + num_leb128_values)))
+                                    ++num_leb128_values;
+                            }
+                            debug_info_data.Skip_LEB128 (&offset, num_leb128_values);
+                            i += num_leb128_values - 1;
+                        }
                         break;
 
                     case DW_FORM_indirect    :
@@ -239,10 +256,7 @@ DWARFDebugInfoEntry::FastExtract
 
                     case DW_FORM_strp        :
                     case DW_FORM_sec_offset  :
-                        if (cu->IsDWARF64 ())
-                            debug_info_data.GetU64 (offset_ptr);
-                        else
-                            debug_info_data.GetU32 (offset_ptr);
+                        form_size = cu->IsDWARF64() ? 8 : 4;
                         break;
 
                     default:
@@ -12,6 +12,8 @@
 //#define ENABLE_DEBUG_PRINTF   // DO NOT LEAVE THIS DEFINED: DEBUG ONLY!!!
 #include <assert.h>
 
+#include <algorithm>
+
 #include "lldb/Core/FileSpecList.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Module.h"
@@ -403,6 +405,27 @@ DWARFDebugLine::Parse(const DWARFDataExtractor& debug_line_data, DWARFDebugLine:
 }
 
 
+//----------------------------------------------------------------------
+// DWARFDebugLine::GetSequenceIndex
+//
+// Get the sequence index for the line table at offset, scanning the
+// line table the first time it is requested.
+//----------------------------------------------------------------------
+DWARFDebugLine::SequenceIndex::shared_ptr
+DWARFDebugLine::GetSequenceIndex(const DWARFDataExtractor& debug_line_data, const dw_offset_t offset)
+{
+    SequenceIndexConstIter pos = m_sequenceIndexMap.find(offset);
+    if (pos != m_sequenceIndexMap.end())
+        return pos->second;
+
+    SequenceIndex::shared_ptr sequence_index_sp(new SequenceIndex);
+    if (!ParseSequenceIndex(debug_line_data, offset, sequence_index_sp.get()))
+        sequence_index_sp.reset();
+    // Remember failures too so we don't scan a bad line table again
+    m_sequenceIndexMap[offset] = sequence_index_sp;
+    return sequence_index_sp;
+}
+
 //----------------------------------------------------------------------
 // DWARFDebugLine::ParsePrologue
 //----------------------------------------------------------------------
@@ -548,47 +571,23 @@ DWARFDebugLine::ParseSupportFiles (const lldb::ModuleSP &module_sp,
 }
 
 //----------------------------------------------------------------------
-// ParseStatementTable
+// ParseStatementTableOpcodes
 //
-// Parse a single line table (prologue and all rows) and call the
-// callback function once for the prologue (row in state will be zero)
-// and each time a row is to be added to the line table.
+// Run the statement program opcodes found between *offset_ptr and
+// end_offset through the line table state machine. If
+// stop_after_end_sequence is true, stop after the first
+// DW_LNE_end_sequence so that a single sequence can be decoded.
 //----------------------------------------------------------------------
-bool
-DWARFDebugLine::ParseStatementTable
+static void
+ParseStatementTableOpcodes
 (
     const DWARFDataExtractor& debug_line_data,
     lldb::offset_t* offset_ptr,
-    DWARFDebugLine::State::Callback callback,
-    void* userData
+    const dw_offset_t end_offset,
+    DWARFDebugLine::State& state,
+    bool stop_after_end_sequence
 )
 {
-    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
-    Prologue::shared_ptr prologue(new Prologue());
-
-
-    const dw_offset_t debug_line_offset = *offset_ptr;
-
-    Timer scoped_timer (__PRETTY_FUNCTION__,
-                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
-                        debug_line_offset);
-
-    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
-    {
-        if (log)
-            log->Error ("failed to parse DWARF line table prologue");
-        // Restore our offset and return false to indicate failure!
-        *offset_ptr = debug_line_offset;
-        return false;
-    }
-
-    if (log)
-        prologue->Dump (log);
-
-    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
-
-    State state(prologue, log, callback, userData);
-
     while (*offset_ptr < end_offset)
     {
         //DEBUG_PRINTF("0x%8.8x: ", *offset_ptr);
@@ -617,6 +616,8 @@ DWARFDebugLine::ParseStatementTable
                 state.end_sequence = true;
                 state.AppendRowToMatrix(*offset_ptr);
                 state.Reset();
+                if (stop_after_end_sequence)
+                    return;
                 break;
 
             case DW_LNE_set_address:
@@ -653,7 +654,7 @@ DWARFDebugLine::ParseStatementTable
                 // the DW_LNE_define_file instruction. These numbers are used in the
                 // file register of the state machine.
                 {
-                    FileNameEntry fileEntry;
+                    DWARFDebugLine::FileNameEntry fileEntry;
                     fileEntry.name      = debug_line_data.GetCStr(offset_ptr);
                     fileEntry.dir_idx   = debug_line_data.GetULEB128(offset_ptr);
                     fileEntry.mod_time  = debug_line_data.GetULEB128(offset_ptr);
@@ -669,7 +670,7 @@ DWARFDebugLine::ParseStatementTable
                 break;
             }
         }
-        else if (opcode < prologue->opcode_base)
+        else if (opcode < state.prologue->opcode_base)
         {
             switch (opcode)
             {
@@ -685,7 +686,7 @@ DWARFDebugLine::ParseStatementTable
                 // Takes a single unsigned LEB128 operand, multiplies it by the
                 // min_inst_length field of the prologue, and adds the
                 // result to the address register of the state machine.
-                state.address += debug_line_data.GetULEB128(offset_ptr) * prologue->min_inst_length;
+                state.address += debug_line_data.GetULEB128(offset_ptr) * state.prologue->min_inst_length;
                 break;
 
             case DW_LNS_advance_line:
@@ -731,8 +732,8 @@ DWARFDebugLine::ParseStatementTable
                 // than twice that range will it need to use both DW_LNS_advance_pc
                 // and a special opcode, requiring three or more bytes.
                 {
-                    uint8_t adjust_opcode = 255 - prologue->opcode_base;
-                    dw_addr_t addr_offset = (adjust_opcode / prologue->line_range) * prologue->min_inst_length;
+                    uint8_t adjust_opcode = 255 - state.prologue->opcode_base;
+                    dw_addr_t addr_offset = (adjust_opcode / state.prologue->line_range) * state.prologue->min_inst_length;
                     state.address += addr_offset;
                 }
                 break;
@@ -774,8 +775,8 @@ DWARFDebugLine::ParseStatementTable
                 // as a multiple of LEB128 operands for each opcode.
                 {
                     uint8_t i;
-                    assert (static_cast<size_t>(opcode - 1) < prologue->standard_opcode_lengths.size());
-                    const uint8_t opcode_length = prologue->standard_opcode_lengths[opcode - 1];
+                    assert (static_cast<size_t>(opcode - 1) < state.prologue->standard_opcode_lengths.size());
+                    const uint8_t opcode_length = state.prologue->standard_opcode_lengths[opcode - 1];
                     for (i=0; i<opcode_length; ++i)
                         debug_line_data.Skip_LEB128(offset_ptr);
                 }
@@ -815,15 +816,61 @@ DWARFDebugLine::ParseStatementTable
             //
             // line increment = line_base + (adjusted opcode % line_range)
 
-            uint8_t adjust_opcode = opcode - prologue->opcode_base;
-            dw_addr_t addr_offset = (adjust_opcode / prologue->line_range) * prologue->min_inst_length;
-            int32_t line_offset = prologue->line_base + (adjust_opcode % prologue->line_range);
+            uint8_t adjust_opcode = opcode - state.prologue->opcode_base;
+            dw_addr_t addr_offset = (adjust_opcode / state.prologue->line_range) * state.prologue->min_inst_length;
+            int32_t line_offset = state.prologue->line_base + (adjust_opcode % state.prologue->line_range);
             state.line += line_offset;
             state.address += addr_offset;
             state.AppendRowToMatrix(*offset_ptr);
         }
     }
 
+}
+
+//----------------------------------------------------------------------
+// ParseStatementTable
+//
+// Parse a single line table (prologue and all rows) and call the
+// callback function once for the prologue (row in state will be zero)
+// and each time a row is to be added to the line table.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementTable
+(
+    const DWARFDataExtractor& debug_line_data,
+    lldb::offset_t* offset_ptr,
+    DWARFDebugLine::State::Callback callback,
+    void* userData
+)
+{
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    Prologue::shared_ptr prologue(new Prologue());
+
+
+    const dw_offset_t debug_line_offset = *offset_ptr;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "DWARFDebugLine::ParseStatementTable (.debug_line[0x%8.8x])",
+                        debug_line_offset);
+
+    if (!ParsePrologue(debug_line_data, offset_ptr, prologue.get()))
+    {
+        if (log)
+            log->Error ("failed to parse DWARF line table prologue");
+        // Restore our offset and return false to indicate failure!
+        *offset_ptr = debug_line_offset;
+        return false;
+    }
+
+    if (log)
+        prologue->Dump (log);
+
+    const dw_offset_t end_offset = debug_line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
+
+    State state(prologue, log, callback, userData);
+
+    ParseStatementTableOpcodes(debug_line_data, offset_ptr, end_offset, state, false);
+
     state.Finalize( *offset_ptr );
 
     return end_offset;
@@ -866,6 +913,151 @@ DWARFDebugLine::ParseStatementTable(const DWARFDataExtractor& debug_line_data, l
     return ParseStatementTable(debug_line_data, offset_ptr, ParseStatementTableCallback, line_table);
 }
 
+//----------------------------------------------------------------------
+// ParseSequenceIndexCallback
+//----------------------------------------------------------------------
+namespace {
+    struct ParseSequenceIndexInfo
+    {
+        DWARFDebugLine::SequenceIndex *sequence_index;
+        dw_offset_t sequence_offset;    // Offset of the first opcode of the current sequence
+        dw_addr_t sequence_low_pc;
+        bool in_sequence;
+    };
+}
+
+static void
+ParseSequenceIndexCallback(dw_offset_t offset, const DWARFDebugLine::State& state, void* userData)
+{
+    if (state.row == DWARFDebugLine::State::StartParsingLineTable ||
+        state.row == DWARFDebugLine::State::DoneParsingLineTable)
+        return;
+
+    ParseSequenceIndexInfo* info = (ParseSequenceIndexInfo*)userData;
+    if (!info->in_sequence)
+    {
+        info->in_sequence = true;
+        info->sequence_low_pc = state.address;
+    }
+    else if (state.address < info->sequence_low_pc)
+    {
+        info->sequence_low_pc = state.address;
+    }
+
+    if (state.end_sequence)
+    {
+        // The offset we are given is the offset just past the opcode that
+        // created this row, which is where the next sequence starts.
+        if (info->sequence_low_pc < state.address)
+            info->sequence_index->sequences.push_back(DWARFDebugLine::Sequence(info->sequence_low_pc, state.address, info->sequence_offset));
+        info->sequence_offset = offset;
+        info->in_sequence = false;
+    }
+}
+
+static bool
+SequenceLowPCLessThan (const DWARFDebugLine::Sequence& a, const DWARFDebugLine::Sequence& b)
+{
+    return a.low_pc < b.low_pc;
+}
+
+//----------------------------------------------------------------------
+// ParseSequenceIndex
+//
+// Scan the line table at line_offset once and record where each
+// sequence starts in .debug_line and which addresses it covers. No
+// rows are created, so this is much cheaper than building the full
+// line table when only a single address needs to be looked up.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseSequenceIndex(const DWARFDataExtractor& debug_line_data, dw_offset_t line_offset, SequenceIndex* sequence_index)
+{
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "DWARFDebugLine::ParseSequenceIndex (.debug_line[0x%8.8x])",
+                        line_offset);
+
+    Prologue::shared_ptr prologue(new Prologue());
+    lldb::offset_t offset = line_offset;
+    if (!ParsePrologue(debug_line_data, &offset, prologue.get()))
+        return false;
+
+    const dw_offset_t end_offset = line_offset + prologue->total_length + (debug_line_data.GetDWARFSizeofInitialLength());
+    const size_t num_prologue_files = prologue->file_names.size();
+
+    ParseSequenceIndexInfo info;
+    info.sequence_index = sequence_index;
+    info.sequence_offset = offset;
+    info.sequence_low_pc = 0;
+    info.in_sequence = false;
+
+    sequence_index->sequences.clear();
+    {
+        State state(prologue, NULL, ParseSequenceIndexCallback, &info);
+        ParseStatementTableOpcodes(debug_line_data, &offset, end_offset, state, false);
+        state.Finalize(offset);
+    }
+
+    // DW_LNE_define_file opcodes add files to the prologue as the program
+    // runs, so later sequences can't be decoded on their own.
+    sequence_index->has_define_file = prologue->file_names.size() != num_prologue_files;
+    sequence_index->prologue = prologue;
+    sequence_index->end_offset = end_offset;
+    std::stable_sort (sequence_index->sequences.begin(), sequence_index->sequences.end(), SequenceLowPCLessThan);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// ParseStatementSequence
+//
+// Decode only the rows of a single sequence that was found by
+// ParseSequenceIndex() calling the callback for each row.
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseStatementSequence(const DWARFDataExtractor& debug_line_data, const SequenceIndex& sequence_index, const Sequence& sequence, State::Callback callback, void* userData)
+{
+    if (!sequence_index.prologue || sequence_index.has_define_file)
+        return false;
+
+    if (sequence.offset == DW_INVALID_OFFSET || sequence.offset >= sequence_index.end_offset)
+        return false;
+
+    Log *log (LogChannelDWARF::GetLogIfAll(DWARF_LOG_DEBUG_LINE));
+    // The state machine only reads from the prologue when there are no
+    // DW_LNE_define_file opcodes, so sharing it is safe.
+    Prologue::shared_ptr prologue (sequence_index.prologue);
+    lldb::offset_t offset = sequence.offset;
+    State state(prologue, log, callback, userData);
+    ParseStatementTableOpcodes(debug_line_data, &offset, sequence_index.end_offset, state, true);
+    state.Finalize(offset);
+    return true;
+}
+
+//----------------------------------------------------------------------
+// DWARFDebugLine::SequenceIndex::FindSequenceContainingAddress
+//----------------------------------------------------------------------
+const DWARFDebugLine::Sequence *
+DWARFDebugLine::SequenceIndex::FindSequenceContainingAddress(dw_addr_t address) const
+{
+    Sequence key(address, address, DW_INVALID_OFFSET);
+    Sequence::const_iterator pos = std::upper_bound (sequences.begin(), sequences.end(), key, SequenceLowPCLessThan);
+    if (pos == sequences.begin())
+        return NULL;
+    --pos;
+
+    // Dead-stripped functions can leave several sequences that start at
+    // the same address, so check all of them.
+    const dw_addr_t low_pc = pos->low_pc;
+    while (pos->low_pc == low_pc)
+    {
+        if (pos->Contains(address))
+            return &(*pos);
+        if (pos == sequences.begin())
+            break;
+        --pos;
+    }
+    return NULL;
+}
+
 
 inline bool
 DWARFDebugLine::Prologue::IsValid() const
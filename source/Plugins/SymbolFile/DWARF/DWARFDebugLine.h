@@ -155,6 +155,66 @@ public:
         Row::collection rows;
     };
 
+    //------------------------------------------------------------------
+    // Sequence
+    //
+    // The location of a single statement program sequence, from its
+    // first opcode up to and including its DW_LNE_end_sequence.
+    //------------------------------------------------------------------
+    struct Sequence
+    {
+        typedef std::vector<Sequence>       collection;
+        typedef collection::iterator        iterator;
+        typedef collection::const_iterator  const_iterator;
+
+        Sequence() :
+            low_pc(0),
+            high_pc(0),
+            offset(DW_INVALID_OFFSET)
+        {
+        }
+
+        Sequence(dw_addr_t low, dw_addr_t high, dw_offset_t off) :
+            low_pc(low),
+            high_pc(high),
+            offset(off)
+        {
+        }
+
+        bool Contains(dw_addr_t address) const { return low_pc <= address && address < high_pc; }
+
+        dw_addr_t   low_pc;     // The address of the first row in the sequence.
+        dw_addr_t   high_pc;    // The address of the DW_LNE_end_sequence row (one past the last instruction).
+        dw_offset_t offset;     // The .debug_line offset of the first opcode of the sequence.
+    };
+
+    //------------------------------------------------------------------
+    // SequenceIndex
+    //
+    // An address index of the sequences in a single line table. It is
+    // built by scanning the statement program once without creating any
+    // rows and allows decoding only the sequence containing an address.
+    //------------------------------------------------------------------
+    struct SequenceIndex
+    {
+        typedef std::shared_ptr<SequenceIndex> shared_ptr;
+
+        SequenceIndex() :
+            prologue(),
+            sequences(),
+            end_offset(DW_INVALID_OFFSET),
+            has_define_file(false)
+        {
+        }
+
+        const Sequence *FindSequenceContainingAddress(dw_addr_t address) const;
+
+        Prologue::shared_ptr prologue;
+        Sequence::collection sequences; // Sorted by low_pc
+        dw_offset_t end_offset;         // The offset of the end of the line table.
+        bool has_define_file;           // True if DW_LNE_define_file is used, which makes sequences depend on each other.
+    };
+
     //------------------------------------------------------------------
     // State
     //------------------------------------------------------------------
@@ -200,24 +260,33 @@ public:
     static dw_offset_t DumpStatementTable(lldb_private::Log *log, const lldb_private::DWARFDataExtractor& debug_line_data, const dw_offset_t line_offset);
     static dw_offset_t DumpStatementOpcodes(lldb_private::Log *log, const lldb_private::DWARFDataExtractor& debug_line_data, const dw_offset_t line_offset, uint32_t flags);
     static bool ParseStatementTable(const lldb_private::DWARFDataExtractor& debug_line_data, lldb::offset_t *offset_ptr, LineTable* line_table);
+    static bool ParseSequenceIndex(const lldb_private::DWARFDataExtractor& debug_line_data, dw_offset_t line_offset, SequenceIndex* sequence_index);
+    static bool ParseStatementSequence(const lldb_private::DWARFDataExtractor& debug_line_data, const SequenceIndex& sequence_index, const Sequence& sequence, State::Callback callback, void* userData);
     static void Parse(const lldb_private::DWARFDataExtractor& debug_line_data, DWARFDebugLine::State::Callback callback, void* userData);
 //  static void AppendLineTableData(const DWARFDebugLine::Prologue* prologue, const DWARFDebugLine::Row::collection& state_coll, const uint32_t addr_size, BinaryStreamBuf &debug_line_data);
 
     DWARFDebugLine() :
-        m_lineTableMap()
+        m_lineTableMap(),
+        m_sequenceIndexMap()
     {
     }
 
     void Parse(const lldb_private::DWARFDataExtractor& debug_line_data);
     void ParseIfNeeded(const lldb_private::DWARFDataExtractor& debug_line_data);
     LineTable::shared_ptr GetLineTable(const dw_offset_t offset) const;
+    SequenceIndex::shared_ptr GetSequenceIndex(const lldb_private::DWARFDataExtractor& debug_line_data, const dw_offset_t offset);
 
 protected:
     typedef std::map<dw_offset_t, LineTable::shared_ptr> LineTableMap;
     typedef LineTableMap::iterator LineTableIter;
     typedef LineTableMap::const_iterator LineTableConstIter;
 
+    typedef std::map<dw_offset_t, SequenceIndex::shared_ptr> SequenceIndexMap;
+    typedef SequenceIndexMap::iterator SequenceIndexIter;
+    typedef SequenceIndexMap::const_iterator SequenceIndexConstIter;
+
     LineTableMap m_lineTableMap;
+    SequenceIndexMap m_sequenceIndexMap;
 };
 
 #endif  // SymbolFileDWARF_DWARFDebugLine_h_
@@ -517,11 +517,15 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
+    m_file_to_cu_index(),
     m_indexed (false),
     m_is_external_ast_source (false),
     m_using_apple_tables (false),
     m_fetched_external_modules (false),
+    m_file_to_cu_indexed (false),
     m_supports_DW_AT_APPLE_objc_complete_type (eLazyBoolCalculate),
+    m_index_time (0),
+    m_line_sequences (),
     m_ranges(),
     m_unique_ast_type_map ()
 {
@@ -938,6 +942,17 @@ SymbolFileDWARF::DebugRanges()
     return m_ranges.get();
 }
 
+DWARFDebugLine*
+SymbolFileDWARF::DebugLine()
+{
+    if (m_line.get() == NULL)
+    {
+        if (get_debug_line_data().GetByteSize() > 0)
+            m_line.reset(new DWARFDebugLine());
+    }
+    return m_line.get();
+}
+
 const DWARFDebugRanges*
 SymbolFileDWARF::DebugRanges() const
 {
@@ -1326,6 +1341,60 @@ ParseDWARFLineTableCallback(dw_offset_t offset, const DWARFDebugLine::State& sta
     }
 }
 
+//----------------------------------------------------------------------
+// Look up the line entry for a single address by decoding only the
+// line table sequence that contains it. This avoids building the
+// complete line table for a compile unit when all we need is a single
+// address, like when symbolicating a backtrace. Decoded sequences are
+// kept until the compile unit's full line table gets parsed.
+//----------------------------------------------------------------------
+bool
+SymbolFileDWARF::ResolveLineEntryFromSequenceIndex (const SymbolContext &sc,
+                                                    DWARFCompileUnit* dwarf_cu,
+                                                    const Address &so_addr,
+                                                    LineEntry &line_entry)
+{
+    // Line tables in .o files need to be linked by the debug map first.
+    if (m_debug_map_symfile)
+        return false;
+
+    DWARFDebugLine *debug_line = DebugLine();
+    if (debug_line == NULL)
+        return false;
+
+    const DWARFDebugInfoEntry *dwarf_cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+    if (dwarf_cu_die == NULL)
+        return false;
+
+    const dw_offset_t cu_line_offset = dwarf_cu_die->GetAttributeValueAsUnsigned(this, dwarf_cu, DW_AT_stmt_list, DW_INVALID_OFFSET);
+    if (cu_line_offset == DW_INVALID_OFFSET)
+        return false;
+
+    DWARFDebugLine::SequenceIndex::shared_ptr sequence_index_sp (debug_line->GetSequenceIndex (get_debug_line_data(), cu_line_offset));
+    if (!sequence_index_sp || sequence_index_sp->has_define_file)
+        return false;
+
+    const DWARFDebugLine::Sequence *sequence = sequence_index_sp->FindSequenceContainingAddress (so_addr.GetFileAddress());
+    if (sequence == NULL)
+        return false;
+
+    std::unique_ptr<LineTable> &sequence_line_table_ap = m_line_sequences[sequence->offset];
+    if (!sequence_line_table_ap)
+    {
+        std::unique_ptr<LineTable> line_table_ap (new LineTable (sc.comp_unit));
+        ParseDWARFLineTableCallbackInfo info;
+        info.line_table = line_table_ap.get();
+        if (!DWARFDebugLine::ParseStatementSequence (get_debug_line_data(), *sequence_index_sp, *sequence, ParseDWARFLineTableCallback, &info))
+        {
+            m_line_sequences.erase (sequence->offset);
+            return false;
+        }
+        sequence_line_table_ap.swap (line_table_ap);
+    }
+
+    return sequence_line_table_ap->FindLineEntryByAddress (so_addr, line_entry);
+}
+
 bool
 SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
 {
@@ -1360,6 +1429,11 @@ SymbolFileDWARF::ParseCompileUnitLineTable (const SymbolContext &sc)
                     else
                     {
                         sc.comp_unit->SetLineTable(line_table_ap.release());
+
+                        // The sequences decoded on their own aren't needed anymore.
+                        LineSequenceMap::iterator pos = m_line_sequences.lower_bound (cu_line_offset);
+                        while (pos != m_line_sequences.end() && pos->second->GetCompileUnit() == sc.comp_unit)
+                            pos = m_line_sequences.erase (pos);
                         return true;
                     }
                 }
@@ -3074,7 +3148,15 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
                         
                         if ((resolve_scope & eSymbolContextLineEntry) || force_check_line_table)
                         {
-                            LineTable *line_table = sc.comp_unit->GetLineTable();
+                            // If nobody has needed the whole line table yet, try to decode
+                            // only the sequence that contains this address.
+                            if (sc.comp_unit->GetLineTableIfParsed() == NULL &&
+                                ResolveLineEntryFromSequenceIndex (sc, dwarf_cu, so_addr, sc.line_entry))
+                            {
+                                resolved |= eSymbolContextLineEntry;
+                            }
+
+                            LineTable *line_table = (resolved & eSymbolContextLineEntry) ? NULL : sc.comp_unit->GetLineTable();
                             if (line_table != NULL)
                             {
                                 // And address that makes it into this function should be in terms
@@ -3120,6 +3202,85 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
 
 
 
+//----------------------------------------------------------------------
+// Build an index from the basename of each file mentioned in a line
+// table prologue to the compile units using that line table. Only the
+// compile unit DIEs and the line table prologues are read.
+//----------------------------------------------------------------------
+void
+SymbolFileDWARF::IndexCompileUnitFiles ()
+{
+    if (m_file_to_cu_indexed)
+        return;
+    m_file_to_cu_indexed = true;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::IndexCompileUnitFiles (%s)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return;
+
+    const DWARFDataExtractor& debug_line_data = get_debug_line_data();
+    const uint32_t num_compile_units = debug_info->GetNumCompileUnits();
+    for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+    {
+        DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+        if (dwarf_cu == NULL)
+            continue;
+
+        const DWARFDebugInfoEntry *cu_die = dwarf_cu->GetCompileUnitDIEOnly();
+        if (cu_die == NULL)
+            continue;
+
+        std::set<ConstString> basenames;
+
+        const char *cu_name = cu_die->GetAttributeValueAsString(this, dwarf_cu, DW_AT_name, NULL);
+        if (cu_name && cu_name[0])
+            basenames.insert(FileSpec(cu_name, false).GetFilename());
+
+        const dw_offset_t stmt_list = cu_die->GetAttributeValueAsUnsigned(this, dwarf_cu, DW_AT_stmt_list, DW_INVALID_OFFSET);
+        if (stmt_list != DW_INVALID_OFFSET && debug_line_data.ValidOffset(stmt_list))
+        {
+            lldb::offset_t offset = stmt_list;
+            DWARFDebugLine::Prologue prologue;
+            if (DWARFDebugLine::ParsePrologue(debug_line_data, &offset, &prologue))
+            {
+                for (const DWARFDebugLine::FileNameEntry &file_entry : prologue.file_names)
+                    basenames.insert(FileSpec(file_entry.name.c_str(), false).GetFilename());
+            }
+        }
+
+        for (const ConstString &basename : basenames)
+        {
+            if (basename)
+                m_file_to_cu_index.Append(basename.GetCString(), cu_idx);
+        }
+    }
+    m_file_to_cu_index.Sort();
+    m_file_to_cu_index.SizeToFit();
+}
+
+bool
+SymbolFileDWARF::FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    // The .o files of a debug map have a single compile unit, nothing to gain.
+    if (m_debug_map_symfile)
+        return false;
+
+    const ConstString &basename = file_spec.GetFilename();
+    if (!basename)
+        return false;
+
+    IndexCompileUnitFiles ();
+
+    cu_indexes.clear();
+    m_file_to_cu_index.GetValues(basename.GetCString(), cu_indexes);
+    std::sort(cu_indexes.begin(), cu_indexes.end());
+    return true;
+}
+
 uint32_t
 SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list)
 {
@@ -3129,11 +3290,19 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
         DWARFDebugInfo* debug_info = DebugInfo();
         if (debug_info)
         {
-            uint32_t cu_idx;
-            DWARFCompileUnit* dwarf_cu = NULL;
+            // Only look at the compile units whose line table prologues
+            // mention a file with the same basename.
+            std::vector<uint32_t> cu_indexes;
+            const bool use_cu_indexes = FindCompileUnitsForFile (file_spec, cu_indexes);
+            const size_t num_cus = use_cu_indexes ? cu_indexes.size() : debug_info->GetNumCompileUnits();
 
-            for (cu_idx = 0; (dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+            for (size_t i = 0; i < num_cus; ++i)
             {
+                const uint32_t cu_idx = use_cu_indexes ? cu_indexes[i] : i;
+                DWARFCompileUnit* dwarf_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+                if (dwarf_cu == NULL)
+                    continue;
+
                 CompileUnit *dc_cu = GetCompUnitForDWARFCompUnit(dwarf_cu, cu_idx);
                 const bool full_match = (bool)file_spec.GetDirectory();
                 bool file_spec_matches_cu_file_spec = dc_cu != NULL && FileSpec::Equal(file_spec, *dc_cu, full_match);
@@ -3241,6 +3410,7 @@ SymbolFileDWARF::Index ()
     Timer scoped_timer (__PRETTY_FUNCTION__,
                         "SymbolFileDWARF::Index (%s)",
                         GetObjectFile()->GetFileSpec().GetFilename().AsCString("<Unknown>"));
+    const TimeValue start_time (TimeValue::Now());
 
     DWARFDebugInfo* debug_info = DebugInfo();
     if (debug_info)
@@ -3292,6 +3462,53 @@ SymbolFileDWARF::Index ()
         s.Printf("\nNamepaces:\n");             m_namespace_index.Dump (&s);
 #endif
     }
+    m_index_time = TimeValue::Now() - start_time;
+}
+
+void
+SymbolFileDWARF::AddStatistics (StructuredData::Dictionary &stats)
+{
+    stats.AddFloatItem ("debug_info_index_time", m_index_time / 1000000000.0);
+    stats.AddBooleanItem ("debug_info_indexed", m_indexed);
+    stats.AddBooleanItem ("using_apple_tables", m_using_apple_tables);
+
+    // The bytes of each DWARF section that have been loaded
+    const DWARFDataExtractor *sections[] = {
+        &m_data_debug_abbrev,
+        &m_data_debug_aranges,
+        &m_data_debug_frame,
+        &m_data_debug_info,
+        &m_data_debug_line,
+        &m_data_debug_loc,
+        &m_data_debug_ranges,
+        &m_data_debug_str,
+        &m_data_apple_names,
+        &m_data_apple_types,
+        &m_data_apple_namespaces,
+        &m_data_apple_objc
+    };
+    uint64_t debug_info_byte_size = 0;
+    for (const DWARFDataExtractor *section : sections)
+        debug_info_byte_size += section->GetByteSize();
+    stats.AddIntegerItem ("debug_info_byte_size", debug_info_byte_size);
+
+    uint64_t num_dies = 0;
+    uint64_t die_memory_size = 0;
+    if (m_info)
+    {
+        const size_t num_compile_units = m_info->GetNumCompileUnits();
+        for (size_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        {
+            const DWARFCompileUnit *dwarf_cu = m_info->GetCompileUnitAtIndex (cu_idx);
+            num_dies += dwarf_cu->GetNumDIEs();
+            die_memory_size += dwarf_cu->GetDIEMemorySize();
+        }
+    }
+    stats.AddIntegerItem ("die_count", num_dies);
+    stats.AddIntegerItem ("die_memory_byte_size", die_memory_size);
+    stats.AddIntegerItem ("type_count", m_die_to_type.size());
+    stats.AddIntegerItem ("decl_context_count", m_die_to_decl_ctx.size());
+    stats.AddIntegerItem ("variable_count", m_die_to_variable_sp.size());
 }
 
 bool
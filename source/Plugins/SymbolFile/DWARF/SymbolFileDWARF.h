@@ -67,6 +67,7 @@ public:
     friend class SymbolFileDWARFDebugMap;
     friend class DebugMapModule;
     friend class DWARFCompileUnit;
+    friend class DWARFDebugInfo;
     //------------------------------------------------------------------
     // Static Functions
     //------------------------------------------------------------------
@@ -117,6 +118,8 @@ public:
 
     virtual uint32_t        ResolveSymbolContext (const lldb_private::Address& so_addr, uint32_t resolve_scope, lldb_private::SymbolContext& sc);
     virtual uint32_t        ResolveSymbolContext (const lldb_private::FileSpec& file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, lldb_private::SymbolContextList& sc_list);
+    virtual bool            FindCompileUnitsForFile (const lldb_private::FileSpec &file_spec, std::vector<uint32_t> &cu_indexes);
+    virtual void            AddStatistics (lldb_private::StructuredData::Dictionary &stats);
     virtual uint32_t        FindGlobalVariables(const lldb_private::ConstString &name, const lldb_private::ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, lldb_private::VariableList& variables);
     virtual uint32_t        FindGlobalVariables(const lldb_private::RegularExpression& regex, bool append, uint32_t max_matches, lldb_private::VariableList& variables);
     virtual uint32_t        FindFunctions(const lldb_private::ConstString &name, const lldb_private::ClangNamespaceDecl *namespace_decl, uint32_t name_type_mask, bool include_inlines, bool append, lldb_private::SymbolContextList& sc_list);
@@ -217,6 +220,8 @@ public:
     DWARFDebugRanges*       DebugRanges();
     const DWARFDebugRanges* DebugRanges() const;
 
+    DWARFDebugLine*         DebugLine();
+
     const lldb_private::DWARFDataExtractor&
     GetCachedSectionData (uint32_t got_flag, 
                           lldb::SectionType sect_type, 
@@ -444,6 +449,8 @@ protected:
     uint32_t                FindTypes(std::vector<dw_offset_t> die_offsets, uint32_t max_matches, lldb_private::TypeList& types);
 
     void                    Index();
+
+    void                    IndexCompileUnitFiles();
     
     void                    DumpIndexes();
 
@@ -547,6 +554,12 @@ protected:
     bool
     FixupAddress (lldb_private::Address &addr);
 
+    bool
+    ResolveLineEntryFromSequenceIndex (const lldb_private::SymbolContext &sc,
+                                       DWARFCompileUnit* dwarf_cu,
+                                       const lldb_private::Address &so_addr,
+                                       lldb_private::LineEntry &line_entry);
+
     typedef std::set<lldb_private::Type *> TypeSet;
     
     typedef struct {
@@ -609,11 +622,16 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
+    lldb_private::UniqueCStringMap<uint32_t> m_file_to_cu_index;    // Source file basename to compile unit index
     bool                                m_indexed:1,
                                         m_is_external_ast_source:1,
                                         m_using_apple_tables:1,
-                                        m_fetched_external_modules:1;
+                                        m_fetched_external_modules:1,
+                                        m_file_to_cu_indexed:1;
     lldb_private::LazyBool              m_supports_DW_AT_APPLE_objc_complete_type;
+    uint64_t                            m_index_time;   // Nanoseconds spent in Index()
+    typedef std::map<dw_offset_t, std::unique_ptr<lldb_private::LineTable> > LineSequenceMap;
+    LineSequenceMap                     m_line_sequences;   // Line table sequences decoded on their own, by .debug_line offset
 
     std::unique_ptr<DWARFDebugRanges>     m_ranges;
     UniqueDWARFASTTypeMap m_unique_ast_type_map;
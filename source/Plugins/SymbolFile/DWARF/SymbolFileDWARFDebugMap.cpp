@@ -583,6 +583,52 @@ SymbolFileDWARFDebugMap::GetSymbolFileByOSOIndex (uint32_t oso_idx)
     return NULL;
 }
 
+void
+SymbolFileDWARFDebugMap::AddStatistics (StructuredData::Dictionary &stats)
+{
+    // Add up the statistics of the .o files that have been loaded without
+    // loading any others.
+    static const char *g_integer_keys[] = {
+        "debug_info_byte_size",
+        "die_count",
+        "die_memory_byte_size",
+        "type_count",
+        "decl_context_count",
+        "variable_count"
+    };
+    const size_t num_integer_keys = llvm::array_lengthof(g_integer_keys);
+    uint64_t totals[num_integer_keys] = { 0 };
+    double index_time = 0;
+    uint64_t num_loaded = 0;
+    for (CompileUnitInfo &comp_unit_info : m_compile_unit_infos)
+    {
+        if (!comp_unit_info.oso_sp || !comp_unit_info.oso_sp->module_sp)
+            continue;
+        SymbolVendor *sym_vendor = comp_unit_info.oso_sp->module_sp->GetSymbolVendor (false);
+        if (sym_vendor == NULL || sym_vendor->GetSymbolFile() == NULL)
+            continue;
+
+        StructuredData::Dictionary oso_stats;
+        sym_vendor->GetSymbolFile()->AddStatistics (oso_stats);
+        ++num_loaded;
+        for (size_t i = 0; i < num_integer_keys; ++i)
+        {
+            uint64_t value = 0;
+            if (oso_stats.GetValueForKeyAsInteger (g_integer_keys[i], value))
+                totals[i] += value;
+        }
+        StructuredData::ObjectSP index_time_sp (oso_stats.GetValueForKey ("debug_info_index_time"));
+        if (index_time_sp && index_time_sp->GetAsFloat())
+            index_time += index_time_sp->GetAsFloat()->GetValue();
+    }
+
+    stats.AddIntegerItem ("object_file_count", m_compile_unit_infos.size());
+    stats.AddIntegerItem ("loaded_object_file_count", num_loaded);
+    stats.AddFloatItem ("debug_info_index_time", index_time);
+    for (size_t i = 0; i < num_integer_keys; ++i)
+        stats.AddIntegerItem (g_integer_keys[i], totals[i]);
+}
+
 SymbolFileDWARF *
 SymbolFileDWARFDebugMap::GetSymbolFileAsSymbolFileDWARF (SymbolFile *sym_file)
 {
@@ -93,6 +93,7 @@ public:
     size_t          GetTypes (lldb_private::SymbolContextScope *sc_scope,
                               uint32_t type_mask,
                               lldb_private::TypeList &type_list) override;
+    void            AddStatistics (lldb_private::StructuredData::Dictionary &stats) override;
 
 
     //------------------------------------------------------------------
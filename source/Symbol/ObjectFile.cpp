@@ -368,6 +368,7 @@ ObjectFile::GetAddressClass (addr_t file_addr)
                     case eSectionTypeDWARFAppleTypes:
                     case eSectionTypeDWARFAppleNamespaces:
                     case eSectionTypeDWARFAppleObjC:
+                    case eSectionTypeGNUDebugData:
                         return eAddressClassDebug;
                     case eSectionTypeEHFrame:
                     case eSectionTypeCompactUnwind:
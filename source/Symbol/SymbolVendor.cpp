@@ -16,6 +16,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/Stream.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Symbol/CompileUnit.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/SymbolFile.h"
@@ -65,7 +66,9 @@ SymbolVendor::SymbolVendor(const lldb::ModuleSP &module_sp) :
     ModuleChild (module_sp),
     m_type_list(),
     m_compile_units(),
-    m_sym_file_ap()
+    m_sym_file_ap(),
+    m_symtab_parse_time(0),
+    m_symtab_parsed(false)
 {
 }
 
@@ -292,6 +295,19 @@ SymbolVendor::ResolveSymbolContext (const FileSpec& file_spec, uint32_t line, bo
     return 0;
 }
 
+bool
+SymbolVendor::FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    ModuleSP module_sp(GetModule());
+    if (module_sp)
+    {
+        lldb_private::Mutex::Locker locker(module_sp->GetMutex());
+        if (m_sym_file_ap.get())
+            return m_sym_file_ap->FindCompileUnitsForFile(file_spec, cu_indexes);
+    }
+    return false;
+}
+
 size_t
 SymbolVendor::FindGlobalVariables (const ConstString &name, const ClangNamespaceDecl *namespace_decl, bool append, size_t max_matches, VariableList& variables)
 {
@@ -477,8 +493,21 @@ SymbolVendor::GetSymtab ()
         ObjectFile *objfile = module_sp->GetObjectFile();
         if (objfile)
         {
+            Mutex::Locker locker(module_sp->GetMutex());
+            if (m_symtab_parsed)
+                return objfile->GetSymtab ();
+
+            // Time the first call since the symbol table was last cleared,
+            // which is the one that parses it, for "statistics dump".
+            TimeValue start_time (TimeValue::Now());
+            Symtab *symtab = objfile->GetSymtab ();
+            if (!m_symtab_parsed)
+            {
+                m_symtab_parse_time += TimeValue::Now() - start_time;
+                m_symtab_parsed = true;
+            }
             // Get symbol table from unified section list.
-            return objfile->GetSymtab ();
+            return symtab;
         }
     }
     return nullptr;
@@ -493,8 +522,10 @@ SymbolVendor::ClearSymtab()
         ObjectFile *objfile = module_sp->GetObjectFile();
         if (objfile)
         {
+            Mutex::Locker locker(module_sp->GetMutex());
             // Clear symbol table from unified section list.
             objfile->ClearSymtab ();
+            m_symtab_parsed = false;
         }
     }
 }
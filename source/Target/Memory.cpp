@@ -11,25 +11,39 @@
 // C Includes
 #include <inttypes.h>
 // C++ Includes
+#include <algorithm>
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Target/MemoryRegionInfo.h"
 #include "lldb/Target/Process.h"
 
 using namespace lldb;
 using namespace lldb_private;
 
+// The most cache lines a single sequential miss will read at once
+static const uint32_t k_max_read_ahead_lines = 16;
+
 //----------------------------------------------------------------------
 // MemoryCache constructor
 //----------------------------------------------------------------------
 MemoryCache::MemoryCache(Process &process) :
     m_process (process),
     m_cache_line_byte_size (process.GetMemoryCacheLineSize()),
+    m_cache_max_byte_size (process.GetMemoryCacheSize()),
+    m_cache_byte_size (0),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_cache (),
-    m_invalid_ranges ()
+    m_lru (),
+    m_invalid_ranges (),
+    m_region_permissions (),
+    m_region_info_supported (true),
+    m_read_ahead_addr (LLDB_INVALID_ADDRESS),
+    m_read_ahead_lines (1),
+    m_stats ()
 {
 }
 
@@ -40,14 +54,62 @@ MemoryCache::~MemoryCache()
 {
 }
 
+void
+MemoryCache::UpdateSettings ()
+{
+    m_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+    m_cache_max_byte_size = m_process.GetMemoryCacheSize();
+}
+
 void
 MemoryCache::Clear(bool clear_invalid_ranges)
 {
     Mutex::Locker locker (m_mutex);
     m_cache.clear();
+    m_lru.clear();
+    m_cache_byte_size = 0;
+    m_region_permissions.Clear();
+    m_read_ahead_addr = LLDB_INVALID_ADDRESS;
+    m_read_ahead_lines = 1;
     if (clear_invalid_ranges)
+    {
         m_invalid_ranges.Clear();
-    m_cache_line_byte_size = m_process.GetMemoryCacheLineSize();
+        m_region_info_supported = true;
+    }
+    UpdateSettings ();
+}
+
+void
+MemoryCache::ClearWritableMemory ()
+{
+    Mutex::Locker locker (m_mutex);
+
+    // If the cache line size changed we can't keep anything
+    if (m_cache_line_byte_size != m_process.GetMemoryCacheLineSize())
+    {
+        Clear ();
+        return;
+    }
+
+    BlockMap::iterator pos = m_cache.begin();
+    while (pos != m_cache.end())
+    {
+        if (pos->second.read_only)
+        {
+            // The region may have been remapped or made writable while
+            // the process ran, so check it again before the line is used.
+            pos->second.needs_recheck = true;
+            ++pos;
+        }
+        else
+            RemoveCacheLine (pos++);
+    }
+
+    // The memory map may change while the process runs
+    m_region_permissions.Clear();
+    m_read_ahead_addr = LLDB_INVALID_ADDRESS;
+    m_read_ahead_lines = 1;
+    UpdateSettings ();
 }
 
 void
@@ -79,7 +141,7 @@ MemoryCache::Flush (addr_t addr, size_t size)
     {
         BlockMap::iterator pos = m_cache.find (curr_addr);
         if (pos != m_cache.end())
-            m_cache.erase(pos);
+            RemoveCacheLine (pos);
     }
 }
 
@@ -112,7 +174,244 @@ MemoryCache::RemoveInvalidRange (lldb::addr_t base_addr, lldb::addr_t byte_size)
     return false;
 }
 
+MemoryCache::Statistics
+MemoryCache::GetStatistics () const
+{
+    Mutex::Locker locker (m_mutex);
+    return m_stats;
+}
+
+void
+MemoryCache::ResetStatistics ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_stats = Statistics();
+}
+
+void
+MemoryCache::Dump (Stream &strm) const
+{
+    Mutex::Locker locker (m_mutex);
+    size_t num_read_only_lines = 0;
+    for (BlockMap::const_iterator pos = m_cache.begin(), end = m_cache.end(); pos != end; ++pos)
+    {
+        if (pos->second.read_only)
+            ++num_read_only_lines;
+    }
+
+    const uint64_t num_lookups = m_stats.hits + m_stats.misses;
+    strm.Printf ("Memory cache: %" PRIu64 " lines (%" PRIu64 " read-only) of %u bytes, %" PRIu64 " of %" PRIu64 " bytes used\n",
+                 (uint64_t)m_cache.size(),
+                 (uint64_t)num_read_only_lines,
+                 m_cache_line_byte_size,
+                 m_cache_byte_size,
+                 m_cache_max_byte_size);
+    strm.Printf ("  hits:             %" PRIu64 " (%.1f%%)\n",
+                 m_stats.hits,
+                 num_lookups ? (100.0 * m_stats.hits) / num_lookups : 0.0);
+    strm.Printf ("  misses:           %" PRIu64 "\n", m_stats.misses);
+    strm.Printf ("  read-ahead lines: %" PRIu64 "\n", m_stats.read_ahead_lines);
+    strm.Printf ("  evicted lines:    %" PRIu64 "\n", m_stats.evicted_lines);
+    strm.Printf ("  uncached reads:   %" PRIu64 "\n", m_stats.uncached_reads);
+    strm.Printf ("  bytes read:       %" PRIu64 "\n", m_stats.bytes_read);
+}
 
+void
+MemoryCache::InsertCacheLine (addr_t line_addr,
+                              const uint8_t *bytes,
+                              size_t byte_size,
+                              addr_t region_base,
+                              addr_t region_end,
+                              bool read_only)
+{
+    BlockMap::iterator pos = m_cache.find (line_addr);
+    if (pos != m_cache.end())
+        RemoveCacheLine (pos);
+
+    CacheLine &line = m_cache[line_addr];
+    line.data_sp.reset (new DataBufferHeap (bytes, byte_size));
+    line.lru_pos = m_lru.insert (m_lru.begin(), line_addr);
+    line.region_base = region_base;
+    line.region_end = region_end;
+    line.read_only = read_only;
+    line.needs_recheck = false;
+    m_cache_byte_size += byte_size;
+
+    // Evict the least recently used lines, but never the one we just added
+    while (m_cache_byte_size > m_cache_max_byte_size && m_lru.size() > 1)
+    {
+        RemoveCacheLine (m_cache.find (m_lru.back()));
+        ++m_stats.evicted_lines;
+    }
+}
+
+void
+MemoryCache::RemoveCacheLine (BlockMap::iterator pos)
+{
+    m_cache_byte_size -= pos->second.data_sp->GetByteSize();
+    m_lru.erase (pos->second.lru_pos);
+    m_cache.erase (pos);
+}
+
+//----------------------------------------------------------------------
+// Check a read-only line that was kept across a stop against the region
+// info of the current stop. The line is removed and false is returned if
+// its region moved, changed size or is no longer read-only.
+//----------------------------------------------------------------------
+bool
+MemoryCache::RecheckCacheLine (BlockMap::iterator pos)
+{
+    CacheLine &line = pos->second;
+    if (!line.needs_recheck)
+        return true;
+
+    uint32_t permissions = 0;
+    addr_t region_base = LLDB_INVALID_ADDRESS;
+    addr_t region_end = LLDB_INVALID_ADDRESS;
+    if (GetRegionPermissions (pos->first, permissions, region_base, region_end) &&
+        (permissions & ePermissionsReadable) &&
+        !(permissions & ePermissionsWritable) &&
+        region_base == line.region_base &&
+        region_end == line.region_end)
+    {
+        line.needs_recheck = false;
+        return true;
+    }
+    RemoveCacheLine (pos);
+    return false;
+}
+
+//----------------------------------------------------------------------
+// Get the permissions of the memory region that contains "addr" and the
+// end address of that region. Regions are looked up with
+// Process::GetMemoryRegionInfo() and remembered until the process
+// resumes.
+//----------------------------------------------------------------------
+bool
+MemoryCache::GetRegionPermissions (addr_t addr, uint32_t &permissions, addr_t &region_base, addr_t &region_end)
+{
+    const RegionPermissions::Entry *entry = m_region_permissions.FindEntryThatContains (addr);
+    if (entry == NULL)
+    {
+        if (!m_region_info_supported)
+            return false;
+
+        MemoryRegionInfo region_info;
+        Error error = m_process.GetMemoryRegionInfo (addr, region_info);
+        if (error.Fail())
+        {
+            // Don't keep asking a process that doesn't support this
+            m_region_info_supported = false;
+            return false;
+        }
+
+        const MemoryRegionInfo::RangeType &range = region_info.GetRange();
+        if (!range.Contains (addr))
+            return false;
+
+        uint32_t region_permissions = 0;
+        if (region_info.GetReadable() == MemoryRegionInfo::eYes)
+            region_permissions |= ePermissionsReadable;
+        if (region_info.GetWritable() != MemoryRegionInfo::eNo)
+            region_permissions |= ePermissionsWritable;
+        if (region_info.GetExecutable() == MemoryRegionInfo::eYes)
+            region_permissions |= ePermissionsExecutable;
+
+        m_region_permissions.Append (RegionPermissions::Entry (range.GetRangeBase(), range.GetByteSize(), region_permissions));
+        m_region_permissions.Sort ();
+        entry = m_region_permissions.FindEntryThatContains (addr);
+        if (entry == NULL)
+            return false;
+    }
+    permissions = entry->data;
+    region_base = entry->GetRangeBase();
+    region_end = entry->GetRangeEnd();
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Read the cache line at "line_addr" from the process along with any
+// lines we want to read ahead, and return the cache line at "line_addr".
+//----------------------------------------------------------------------
+MemoryCache::BlockMap::iterator
+MemoryCache::FillCacheLines (addr_t line_addr, Error &error)
+{
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+
+    // Double the read-ahead window each time a read misses on the line
+    // right after the lines we read last time.
+    if (line_addr == m_read_ahead_addr)
+        m_read_ahead_lines = std::min<uint32_t> (m_read_ahead_lines * 2, k_max_read_ahead_lines);
+    else
+        m_read_ahead_lines = 1;
+
+    uint64_t num_lines = m_read_ahead_lines;
+
+    // Don't let one read take up more than a quarter of the cache
+    const uint64_t max_lines = std::max<uint64_t> (m_cache_max_byte_size / (4 * cache_line_byte_size), 1);
+    if (num_lines > max_lines)
+        num_lines = max_lines;
+
+    uint32_t permissions = 0;
+    addr_t region_base = LLDB_INVALID_ADDRESS;
+    addr_t region_end = LLDB_INVALID_ADDRESS;
+    const bool have_region = GetRegionPermissions (line_addr, permissions, region_base, region_end);
+    const bool read_only = have_region &&
+                           (permissions & ePermissionsReadable) &&
+                           !(permissions & ePermissionsWritable);
+
+    // Don't read ahead past the end of the region or into an invalid range
+    for (uint64_t i = 1; i < num_lines; ++i)
+    {
+        const addr_t next_line_addr = line_addr + i * cache_line_byte_size;
+        if ((have_region && next_line_addr >= region_end) ||
+            m_invalid_ranges.FindEntryThatContains (next_line_addr))
+        {
+            num_lines = i;
+            break;
+        }
+    }
+
+    const size_t read_size = num_lines * cache_line_byte_size;
+    DataBufferHeap buffer (read_size, 0);
+    size_t bytes_read = m_process.ReadMemoryFromInferior (line_addr, buffer.GetBytes(), read_size, error);
+    if (bytes_read == 0 && num_lines > 1)
+    {
+        // Some processes fail the whole read if any of it isn't readable,
+        // so try just the line we need.
+        error.Clear();
+        num_lines = 1;
+        bytes_read = m_process.ReadMemoryFromInferior (line_addr, buffer.GetBytes(), cache_line_byte_size, error);
+    }
+    if (bytes_read == 0)
+    {
+        m_read_ahead_addr = LLDB_INVALID_ADDRESS;
+        return m_cache.end();
+    }
+
+    m_stats.bytes_read += bytes_read;
+    ++m_stats.misses;
+
+    // Insert the lines from last to first so the line that was asked for is
+    // the most recently used one.
+    const uint64_t num_lines_read = (bytes_read + cache_line_byte_size - 1) / cache_line_byte_size;
+    for (uint64_t i = num_lines_read; i > 0; --i)
+    {
+        const size_t line_offset = (i - 1) * cache_line_byte_size;
+        const size_t line_size = std::min<size_t> (bytes_read - line_offset, cache_line_byte_size);
+        const addr_t curr_line_addr = line_addr + line_offset;
+        const bool line_read_only = read_only && (curr_line_addr + cache_line_byte_size <= region_end);
+        InsertCacheLine (curr_line_addr, buffer.GetBytes() + line_offset, line_size, region_base, region_end, line_read_only);
+    }
+    m_stats.read_ahead_lines += num_lines_read - 1;
+
+    if (bytes_read == num_lines * cache_line_byte_size)
+        m_read_ahead_addr = line_addr + bytes_read;
+    else
+        m_read_ahead_addr = LLDB_INVALID_ADDRESS;
+
+    return m_cache.find (line_addr);
+}
 
 size_t
 MemoryCache::Read (addr_t addr,  
@@ -131,7 +430,11 @@ MemoryCache::Read (addr_t addr,
     // it in the cache.
     if (dst && dst_len > m_cache_line_byte_size)
     {
-        return m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        const size_t bytes_read = m_process.ReadMemoryFromInferior (addr, dst, dst_len, error);
+        Mutex::Locker locker (m_mutex);
+        ++m_stats.uncached_reads;
+        m_stats.bytes_read += bytes_read;
+        return bytes_read;
     }
 
     if (dst && bytes_left > 0)
@@ -150,74 +453,102 @@ MemoryCache::Read (addr_t addr,
                 return dst_len - bytes_left;
             }
 
-            BlockMap::const_iterator pos = m_cache.find (curr_addr);
-            BlockMap::const_iterator end = m_cache.end ();
-            
-            if (pos != end)
+            BlockMap::iterator pos = m_cache.find (curr_addr);
+            if (pos != m_cache.end () && RecheckCacheLine (pos))
             {
-                size_t curr_read_size = cache_line_byte_size - cache_offset;
-                if (curr_read_size > bytes_left)
-                    curr_read_size = bytes_left;
-                
-                memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes() + cache_offset, curr_read_size);
-                
-                bytes_left -= curr_read_size;
-                curr_addr += curr_read_size + cache_offset;
-                cache_offset = 0;
-                
-                if (bytes_left > 0)
-                {
-                    // Get sequential cache page hits
-                    for (++pos; (pos != end) && (bytes_left > 0); ++pos)
-                    {
-                        assert ((curr_addr % cache_line_byte_size) == 0);
-                        
-                        if (pos->first != curr_addr)
-                            break;
-                        
-                        curr_read_size = pos->second->GetByteSize();
-                        if (curr_read_size > bytes_left)
-                            curr_read_size = bytes_left;
-                        
-                        memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes(), curr_read_size);
-                        
-                        bytes_left -= curr_read_size;
-                        curr_addr += curr_read_size;
-                        
-                        // We have a cache page that succeeded to read some bytes
-                        // but not an entire page. If this happens, we must cap
-                        // off how much data we are able to read...
-                        if (pos->second->GetByteSize() != cache_line_byte_size)
-                            return dst_len - bytes_left;
-                    }
-                }
+                ++m_stats.hits;
+                m_lru.splice (m_lru.begin(), m_lru, pos->second.lru_pos);
             }
-            
-            // We need to read from the process
-            
-            if (bytes_left > 0)
+            else
             {
-                assert ((curr_addr % cache_line_byte_size) == 0);
-                std::unique_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
+                pos = FillCacheLines (curr_addr, error);
+                if (pos == m_cache.end ())
                     return dst_len - bytes_left;
-                
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
-                // We have read data and put it into the cache, continue through the
-                // loop again to get the data out of the cache...
             }
+
+            // We have a cache line that only has some of the bytes we need
+            const DataBufferSP &data_sp = pos->second.data_sp;
+            const size_t line_byte_size = data_sp->GetByteSize();
+            if (cache_offset >= line_byte_size)
+                return dst_len - bytes_left;
+
+            size_t curr_read_size = line_byte_size - cache_offset;
+            if (curr_read_size > bytes_left)
+                curr_read_size = bytes_left;
+
+            memcpy (dst_buf + dst_len - bytes_left, data_sp->GetBytes() + cache_offset, curr_read_size);
+            bytes_left -= curr_read_size;
+
+            // If the process could only read part of this cache line we must
+            // cap off how much data we are able to read...
+            if (line_byte_size != cache_line_byte_size)
+                return dst_len - bytes_left;
+
+            curr_addr += cache_line_byte_size;
+            cache_offset = 0;
         }
     }
     
     return dst_len - bytes_left;
 }
 
+bool
+MemoryCache::ReadIfCached (addr_t addr, void *dst, size_t dst_len)
+{
+    if (dst == NULL || dst_len == 0)
+        return false;
+
+    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
+    uint8_t *dst_buf = (uint8_t *)dst;
+    addr_t curr_addr = addr - (addr % cache_line_byte_size);
+    addr_t cache_offset = addr - curr_addr;
+    size_t bytes_left = dst_len;
+    Mutex::Locker locker (m_mutex);
+
+    // Make sure all of the lines are here before touching the LRU list or
+    // the statistics so a partial hit doesn't count as anything.
+    std::vector<BlockMap::iterator> lines;
+    while (bytes_left > 0)
+    {
+        if (m_invalid_ranges.FindEntryThatContains(curr_addr))
+            return false;
+        BlockMap::iterator pos = m_cache.find (curr_addr);
+        if (pos == m_cache.end ())
+            return false;
+        // Checking the region would talk to the process
+        if (pos->second.needs_recheck)
+            return false;
+        const size_t line_byte_size = pos->second.data_sp->GetByteSize();
+        if (cache_offset >= line_byte_size)
+            return false;
+        size_t curr_read_size = line_byte_size - cache_offset;
+        if (curr_read_size > bytes_left)
+            curr_read_size = bytes_left;
+        else if (line_byte_size != cache_line_byte_size && curr_read_size < bytes_left)
+            return false;
+        lines.push_back (pos);
+        bytes_left -= curr_read_size;
+        curr_addr += cache_line_byte_size;
+        cache_offset = 0;
+    }
+
+    cache_offset = addr % cache_line_byte_size;
+    bytes_left = dst_len;
+    for (BlockMap::iterator pos : lines)
+    {
+        const DataBufferSP &data_sp = pos->second.data_sp;
+        size_t curr_read_size = data_sp->GetByteSize() - cache_offset;
+        if (curr_read_size > bytes_left)
+            curr_read_size = bytes_left;
+        memcpy (dst_buf + dst_len - bytes_left, data_sp->GetBytes() + cache_offset, curr_read_size);
+        bytes_left -= curr_read_size;
+        cache_offset = 0;
+        ++m_stats.hits;
+        m_lru.splice (m_lru.begin(), m_lru, pos->second.lru_pos);
+    }
+    return true;
+}
+
 
 
 AllocatedBlock::AllocatedBlock (lldb::addr_t addr, 
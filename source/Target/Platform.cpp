@@ -1540,6 +1540,7 @@ Error
 Platform::LaunchNativeProcess (
     ProcessLaunchInfo &launch_info,
     lldb_private::NativeProcessProtocol::NativeDelegate &native_delegate,
+    MainLoop &mainloop,
     NativeProcessProtocolSP &process_sp)
 {
     // Platforms should override this implementation if they want to
@@ -1550,6 +1551,7 @@ Platform::LaunchNativeProcess (
 Error
 Platform::AttachNativeProcess (lldb::pid_t pid,
                                lldb_private::NativeProcessProtocol::NativeDelegate &native_delegate,
+                               MainLoop &mainloop,
                                NativeProcessProtocolSP &process_sp)
 {
     // Platforms should override this implementation if they want to
@@ -115,6 +115,7 @@ g_properties[] =
     { "stop-on-sharedlibrary-events" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, stop when a shared library is loaded or unloaded." },
     { "detach-keeps-stopped" , OptionValue::eTypeBoolean, true, false, NULL, NULL, "If true, detach will attempt to keep the process stopped." },
     { "memory-cache-line-size" , OptionValue::eTypeUInt64, false, 512, NULL, NULL, "The memory cache line size" },
+    { "memory-cache-size" , OptionValue::eTypeUInt64, false, 8 * 1024 * 1024, NULL, NULL, "The maximum number of bytes of process memory to keep in the memory cache." },
     {  NULL                  , OptionValue::eTypeInvalid, false, 0, NULL, NULL, NULL  }
 };
 
@@ -126,7 +127,8 @@ enum {
     ePropertyPythonOSPluginPath,
     ePropertyStopOnSharedLibraryEvents,
     ePropertyDetachKeepsStopped,
-    ePropertyMemCacheLineSize
+    ePropertyMemCacheLineSize,
+    ePropertyMemCacheSize
 };
 
 ProcessProperties::ProcessProperties (lldb_private::Process *process) :
@@ -176,6 +178,13 @@ ProcessProperties::GetMemoryCacheLineSize() const
     return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
 }
 
+uint64_t
+ProcessProperties::GetMemoryCacheSize() const
+{
+    const uint32_t idx = ePropertyMemCacheSize;
+    return m_collection_sp->GetPropertyAtIndexAsUInt64 (NULL, idx, g_properties[idx].default_uint_value);
+}
+
 Args
 ProcessProperties::GetExtraStartupCommands () const
 {
@@ -728,6 +737,11 @@ Process::Process(Target &target, Listener &listener, const UnixSignalsSP &unix_s
     m_image_tokens (),
     m_listener (listener),
     m_breakpoint_site_list (),
+    m_breakpoint_site_batch_mutex (Mutex::eMutexTypeRecursive),
+    m_breakpoint_site_batch_tid (LLDB_INVALID_THREAD_ID),
+    m_breakpoint_site_batch_depth (0),
+    m_batched_enable_sites (),
+    m_batched_disable_sites (),
     m_dynamic_checkers_ap (),
     m_unix_signals_sp (unix_signals_sp),
     m_abi_sp (),
@@ -1822,7 +1836,7 @@ Process::SetPrivateState (StateType new_state)
             m_mod_id.BumpStopID();
             if (!m_mod_id.IsLastResumeForUserExpression())
                 m_mod_id.SetStopEventForLastNaturalStopID(event_sp);
-            m_memory_cache.Clear();
+            m_memory_cache.ClearWritableMemory();
             if (log)
                 log->Printf("Process::SetPrivateState (%s) stop_id = %u", StateAsCString(new_state), m_mod_id.GetStopID());
         }
@@ -2209,12 +2223,9 @@ Process::EnableBreakpointSiteByID (lldb::user_id_t break_id)
     return error;
 }
 
-lldb::break_id_t
-Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardware)
+bool
+Process::ShouldReportBreakpointSiteErrors ()
 {
-    addr_t load_addr = LLDB_INVALID_ADDRESS;
-    
-    bool show_error = true;
     switch (GetState())
     {
         case eStateInvalid:
@@ -2224,17 +2235,24 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
         case eStateLaunching:
         case eStateDetached:
         case eStateExited:
-            show_error = false;
-            break;
+            return false;
             
         case eStateStopped:
         case eStateRunning:
         case eStateStepping:
         case eStateCrashed:
         case eStateSuspended:
-            show_error = IsAlive();
-            break;
+            return IsAlive();
     }
+    return true;
+}
+
+lldb::break_id_t
+Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardware)
+{
+    addr_t load_addr = LLDB_INVALID_ADDRESS;
+    
+    const bool show_error = ShouldReportBreakpointSiteErrors();
 
     // Reset the IsIndirect flag here, in case the location changes from
     // pointing to a indirect symbol to a regular symbol.
@@ -2268,6 +2286,7 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
     
     if (load_addr != LLDB_INVALID_ADDRESS)
     {
+        Mutex::Locker batch_locker (m_breakpoint_site_batch_mutex);
         BreakpointSiteSP bp_site_sp;
 
         // Look up this breakpoint site.  If it exists, then add this new owner, otherwise
@@ -2277,13 +2296,24 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
 
         if (bp_site_sp)
         {
+            // The site stays if it lost its last owner earlier in the batch.
+            m_batched_disable_sites.erase (load_addr);
             bp_site_sp->AddOwner (owner);
             owner->SetBreakpointSite (bp_site_sp);
+            BreakpointSiteConditionsChanged (bp_site_sp.get());
             return bp_site_sp->GetID();
         }
         else
         {
             bp_site_sp.reset (new BreakpointSite (&m_breakpoint_site_list, owner, load_addr, use_hardware));
+            if (bp_site_sp && m_breakpoint_site_batch_depth > 0 &&
+                m_breakpoint_site_batch_tid == Host::GetCurrentThreadID())
+            {
+                // Enabled with the rest of the batch when it ends.
+                m_batched_enable_sites[load_addr] = bp_site_sp;
+                owner->SetBreakpointSite (bp_site_sp);
+                return m_breakpoint_site_list.Add (bp_site_sp);
+            }
             if (bp_site_sp)
             {
                 Error error = EnableBreakpointSite (bp_site_sp.get());
@@ -2315,16 +2345,123 @@ Process::CreateBreakpointSite (const BreakpointLocationSP &owner, bool use_hardw
 void
 Process::RemoveOwnerFromBreakpointSite (lldb::user_id_t owner_id, lldb::user_id_t owner_loc_id, BreakpointSiteSP &bp_site_sp)
 {
+    Mutex::Locker batch_locker (m_breakpoint_site_batch_mutex);
     uint32_t num_owners = bp_site_sp->RemoveOwner (owner_id, owner_loc_id);
     if (num_owners == 0)
     {
-        // Don't try to disable the site if we don't have a live process anymore.
-        if (IsAlive())
+        // A site of a batch that hasn't been enabled yet just goes away,
+        // even if another thread took its last owner.
+        const addr_t load_addr = bp_site_sp->GetLoadAddress();
+        if (m_batched_enable_sites.erase (load_addr) == 0 &&
+            m_breakpoint_site_batch_depth > 0 && m_breakpoint_site_batch_tid == Host::GetCurrentThreadID() &&
+            bp_site_sp->IsEnabled() && IsAlive())
+        {
+            // Disable the site with the rest of the batch when it ends, and
+            // keep it in the list until then in case it gets a new owner.
+            m_batched_disable_sites[load_addr] = bp_site_sp;
+            return;
+        }
+
+        // Don't try to disable the site if we don't have a live process anymore,
+        // or if it never got enabled.
+        if (IsAlive() && bp_site_sp->IsEnabled())
             DisableBreakpointSite (bp_site_sp.get());
-        m_breakpoint_site_list.RemoveByAddress(bp_site_sp->GetLoadAddress());
+        m_breakpoint_site_list.RemoveByAddress(load_addr);
+    }
+    else if (IsAlive())
+        BreakpointSiteConditionsChanged (bp_site_sp.get());
+}
+
+bool
+Process::BeginBreakpointSiteBatch ()
+{
+    Mutex::Locker batch_locker (m_breakpoint_site_batch_mutex);
+    const lldb::tid_t tid = Host::GetCurrentThreadID();
+    if (m_breakpoint_site_batch_depth > 0 && m_breakpoint_site_batch_tid != tid)
+        return false;
+    m_breakpoint_site_batch_tid = tid;
+    ++m_breakpoint_site_batch_depth;
+    return true;
+}
+
+void
+Process::EndBreakpointSiteBatch ()
+{
+    // Other threads wait to change sites until the batch's sites are
+    // enabled and disabled.
+    Mutex::Locker batch_locker (m_breakpoint_site_batch_mutex);
+    assert (m_breakpoint_site_batch_depth > 0 && "breakpoint site batch ended without being begun");
+    assert (m_breakpoint_site_batch_tid == Host::GetCurrentThreadID() && "breakpoint site batch ended by another thread");
+    if (m_breakpoint_site_batch_depth == 0 || --m_breakpoint_site_batch_depth > 0)
+        return;
+    if (m_batched_enable_sites.empty() && m_batched_disable_sites.empty())
+        return;
+
+    std::vector<BreakpointSiteSP> enable_sites;
+    std::vector<BreakpointSiteSP> disable_sites;
+    for (const auto &pair : m_batched_enable_sites)
+        enable_sites.push_back (pair.second);
+    for (const auto &pair : m_batched_disable_sites)
+        disable_sites.push_back (pair.second);
+    m_batched_enable_sites.clear();
+    m_batched_disable_sites.clear();
+
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
+    if (log)
+        log->Printf ("Process::%s enabling %" PRIu64 " and disabling %" PRIu64 " breakpoint sites",
+                     __FUNCTION__, (uint64_t)enable_sites.size(), (uint64_t)disable_sites.size());
+
+    // Don't try to disable the sites if we don't have a live process anymore.
+    std::vector<Error> enable_errors;
+    if (IsAlive())
+        UpdateBreakpointSites (enable_sites, disable_sites, enable_errors);
+    else
+        UpdateBreakpointSites (enable_sites, std::vector<BreakpointSiteSP>(), enable_errors);
+    for (const BreakpointSiteSP &bp_site_sp : disable_sites)
+        m_breakpoint_site_list.RemoveByAddress (bp_site_sp->GetLoadAddress());
+
+    // Take the sites that couldn't be enabled away from their owners, which
+    // takes them out of the list.
+    const bool show_error = ShouldReportBreakpointSiteErrors();
+    for (size_t i = 0; i < enable_sites.size(); ++i)
+    {
+        const BreakpointSiteSP &bp_site_sp = enable_sites[i];
+        if (i < enable_errors.size() && enable_errors[i].Success())
+            continue;
+
+        const char *error_cstr = i < enable_errors.size() ? enable_errors[i].AsCString() : NULL;
+        std::vector<BreakpointLocationSP> owners;
+        for (size_t j = 0; j < bp_site_sp->GetNumberOfOwners(); ++j)
+            owners.push_back (bp_site_sp->GetOwnerAtIndex (j));
+        for (const BreakpointLocationSP &owner : owners)
+        {
+            if (show_error)
+            {
+                // Report error for setting breakpoint...
+                m_target.GetDebugger().GetErrorFile()->Printf ("warning: failed to set breakpoint site at 0x%" PRIx64 " for breakpoint %i.%i: %s\n",
+                                                               bp_site_sp->GetLoadAddress(),
+                                                               owner->GetBreakpoint().GetID(),
+                                                               owner->GetID(),
+                                                               error_cstr ? error_cstr : "unknown error");
+            }
+            owner->ClearBreakpointSite();
+        }
     }
 }
 
+void
+Process::UpdateBreakpointSites (const std::vector<BreakpointSiteSP> &enable_sites,
+                                const std::vector<BreakpointSiteSP> &disable_sites,
+                                std::vector<Error> &enable_errors)
+{
+    for (const BreakpointSiteSP &bp_site_sp : disable_sites)
+        DisableBreakpointSite (bp_site_sp.get());
+
+    enable_errors.clear();
+    for (const BreakpointSiteSP &bp_site_sp : enable_sites)
+        enable_errors.push_back (EnableBreakpointSite (bp_site_sp.get()));
+}
+
 
 size_t
 Process::RemoveBreakpointOpcodesFromBuffer (addr_t bp_addr, size_t size, uint8_t *buf) const
@@ -2335,7 +2472,8 @@ Process::RemoveBreakpointOpcodesFromBuffer (addr_t bp_addr, size_t size, uint8_t
     if (m_breakpoint_site_list.FindInRange (bp_addr, bp_addr + size, bp_sites_in_range))
     {
         bp_sites_in_range.ForEach([bp_addr, size, buf, &bytes_removed](BreakpointSite *bp_site) -> void {
-            if (bp_site->GetType() == BreakpointSite::eSoftware)
+            // Sites of a batch in progress aren't in memory yet.
+            if (bp_site->GetType() == BreakpointSite::eSoftware && bp_site->IsEnabled())
             {
                 addr_t intersect_addr;
                 size_t intersect_size;
@@ -2739,6 +2877,120 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+void
+Process::DoReadMemoryRanges (MemoryReadRanges &ranges)
+{
+    for (MemoryReadRange &range : ranges)
+    {
+        DataBufferHeap *heap = new DataBufferHeap (range.size, 0);
+        DataBufferSP data_sp (heap);
+        size_t bytes_read = 0;
+        while (bytes_read < range.size)
+        {
+            const size_t curr_size = range.size - bytes_read;
+            const size_t curr_bytes_read = DoReadMemory (range.addr + bytes_read,
+                                                         heap->GetBytes() + bytes_read,
+                                                         curr_size,
+                                                         range.error);
+            bytes_read += curr_bytes_read;
+            if (curr_bytes_read == curr_size || curr_bytes_read == 0)
+                break;
+        }
+        heap->SetByteSize (bytes_read);
+        range.data_sp = data_sp;
+    }
+}
+
+void
+Process::AddStatistics (StructuredData::Dictionary &dict)
+{
+    const MemoryCache::Statistics cache_stats (m_memory_cache.GetStatistics());
+    StructuredData::DictionarySP cache_dict_sp (new StructuredData::Dictionary());
+    cache_dict_sp->AddIntegerItem ("hits", cache_stats.hits);
+    cache_dict_sp->AddIntegerItem ("misses", cache_stats.misses);
+    const uint64_t lookups = cache_stats.hits + cache_stats.misses;
+    cache_dict_sp->AddFloatItem ("hit_ratio", lookups ? (double)cache_stats.hits / lookups : 0.0);
+    cache_dict_sp->AddIntegerItem ("read_ahead_lines", cache_stats.read_ahead_lines);
+    cache_dict_sp->AddIntegerItem ("evicted_lines", cache_stats.evicted_lines);
+    cache_dict_sp->AddIntegerItem ("uncached_reads", cache_stats.uncached_reads);
+    cache_dict_sp->AddIntegerItem ("bytes_read", cache_stats.bytes_read);
+    dict.AddItem ("memory_cache", cache_dict_sp);
+    dict.AddIntegerItem ("stop_id", GetStopID());
+}
+
+size_t
+Process::ReadMemoryRanges (MemoryReadRanges &ranges)
+{
+    Log *log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+
+    // Serve what we can from the memory cache and collect the rest so they
+    // can be read from the process all at once
+    MemoryReadRanges uncached_ranges;
+    std::vector<size_t> uncached_indexes;
+    const bool use_cache = !GetDisableMemoryCache();
+    const size_t num_ranges = ranges.size();
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        MemoryReadRange &range = ranges[i];
+        range.error.Clear();
+        range.data_sp.reset();
+        if (range.size == 0)
+        {
+            range.data_sp.reset (new DataBufferHeap ());
+            continue;
+        }
+        if (use_cache)
+        {
+            DataBufferSP data_sp (new DataBufferHeap (range.size, 0));
+            if (m_memory_cache.ReadIfCached (range.addr, data_sp->GetBytes(), range.size))
+            {
+                range.data_sp = data_sp;
+                continue;
+            }
+        }
+        uncached_indexes.push_back (i);
+        uncached_ranges.push_back (MemoryReadRange (range.addr, range.size));
+    }
+
+    if (log)
+        log->Printf ("Process::ReadMemoryRanges (%" PRIu64 " ranges) %" PRIu64 " read from the cache",
+                     (uint64_t)num_ranges, (uint64_t)(num_ranges - uncached_ranges.size()));
+
+    if (!uncached_ranges.empty())
+    {
+        DoReadMemoryRanges (uncached_ranges);
+
+        for (size_t i = 0; i < uncached_ranges.size(); ++i)
+        {
+            MemoryReadRange &range = ranges[uncached_indexes[i]];
+            range.data_sp = uncached_ranges[i].data_sp;
+            range.error = uncached_ranges[i].error;
+
+            // Replace any software breakpoint opcodes that fall into this
+            // range back into the results
+            const size_t bytes_read = range.GetBytesRead();
+            if (bytes_read > 0)
+                RemoveBreakpointOpcodesFromBuffer (range.addr, bytes_read, range.data_sp->GetBytes());
+        }
+    }
+
+    size_t num_read = 0;
+    for (MemoryReadRange &range : ranges)
+    {
+        if (range.Succeeded())
+        {
+            range.error.Clear();
+            ++num_read;
+        }
+        else if (range.error.Success())
+        {
+            range.error.SetErrorStringWithFormat ("only read %" PRIu64 " of %" PRIu64 " bytes at 0x%" PRIx64,
+                                                  (uint64_t)range.GetBytesRead(), (uint64_t)range.size, range.addr);
+        }
+    }
+    return num_read;
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -4647,7 +4899,8 @@ Process::ProcessEventData::ProcessEventData () :
     m_state (eStateInvalid),
     m_restarted (false),
     m_update_state (0),
-    m_interrupted (false)
+    m_interrupted (false),
+    m_create_time (TimeValue::Now())
 {
 }
 
@@ -4657,7 +4910,8 @@ Process::ProcessEventData::ProcessEventData (const ProcessSP &process_sp, StateT
     m_state (state),
     m_restarted (false),
     m_update_state (0),
-    m_interrupted (false)
+    m_interrupted (false),
+    m_create_time (TimeValue::Now())
 {
     if (process_sp)
         m_process_wp = process_sp;
@@ -6468,6 +6722,10 @@ Process::ResolveIndirectFunction(const Address *address, Error &error)
 void
 Process::ModulesDidLoad (ModuleList &module_list)
 {
+    // Newly loaded modules may be mapped over memory we still have cached
+    // from a module that was unloaded.
+    m_memory_cache.Clear();
+
     SystemRuntime *sys_runtime = GetSystemRuntime();
     if (sys_runtime)
     {
@@ -514,6 +514,11 @@ protected:
                             }
                         }
 
+                        // Tracepoints were recorded where the process runs, they only get here when the
+                        // hit had to be reported anyway.
+                        if (bp_loc_sp->GetBreakpoint().IsTracepoint() && process->CollectsTracepointData (bp_site_sp.get()))
+                            continue;
+
                         bool callback_says_stop;
 
                         // FIXME: For now the callbacks have to run in async mode - the first time we restart we need
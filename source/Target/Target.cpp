@@ -44,6 +44,8 @@
 #include "lldb/Interpreter/Property.h"
 #include "lldb/Symbol/ClangASTContext.h"
 #include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Symbol/SymbolFile.h"
+#include "lldb/Symbol/SymbolVendor.h"
 #include "lldb/Target/LanguageRuntime.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
 #include "lldb/Target/Process.h"
@@ -91,7 +93,8 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_stop_hook_next_id (0),
     m_valid (true),
     m_suppress_stop_hooks (false),
-    m_is_dummy_target(is_dummy_target)
+    m_is_dummy_target(is_dummy_target),
+    m_stats()
 
 {
     SetEventName (eBroadcastBitBreakpointChanged, "breakpoint-changed");
@@ -1283,7 +1286,10 @@ Target::ModulesDidLoad (ModuleList &module_list)
 {
     if (m_valid && module_list.GetSize())
     {
-        m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        {
+            Process::BreakpointSiteBatch batch (m_process_sp);
+            m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        }
         if (m_process_sp)
         {
             m_process_sp->ModulesDidLoad (module_list);
@@ -1307,7 +1313,10 @@ Target::SymbolsDidLoad (ModuleList &module_list)
             }
         }
         
-        m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        {
+            Process::BreakpointSiteBatch batch (m_process_sp);
+            m_breakpoint_list.UpdateBreakpoints (module_list, true, false);
+        }
         BroadcastEvent (eBroadcastBitSymbolsLoaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -1318,7 +1327,10 @@ Target::ModulesDidUnload (ModuleList &module_list, bool delete_locations)
     if (m_valid && module_list.GetSize())
     {
         UnloadModuleSections (module_list);
-        m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+        {
+            Process::BreakpointSiteBatch batch (m_process_sp);
+            m_breakpoint_list.UpdateBreakpoints (module_list, false, delete_locations);
+        }
         BroadcastEvent (eBroadcastBitModulesUnloaded, new TargetEventData (this->shared_from_this(), module_list));
     }
 }
@@ -2146,6 +2158,131 @@ Target::GetClangModulesDeclVendor ()
     return m_clang_modules_decl_vendor_ap.get();
 }
 
+//----------------------------------------------------------------------
+// Target::Statistics
+//----------------------------------------------------------------------
+Target::Statistics::Statistics () :
+    m_mutex (Mutex::eMutexTypeNormal)
+{
+    Reset ();
+}
+
+void
+Target::Statistics::AddDuration (Duration duration, uint64_t nanoseconds)
+{
+    if (duration >= kNumDurations)
+        return;
+    Mutex::Locker locker (m_mutex);
+    DurationStats &stats = m_durations[duration];
+    ++stats.count;
+    stats.total += nanoseconds;
+    if (nanoseconds > stats.max)
+        stats.max = nanoseconds;
+}
+
+void
+Target::Statistics::Reset ()
+{
+    Mutex::Locker locker (m_mutex);
+    for (uint32_t i = 0; i < kNumDurations; ++i)
+    {
+        m_durations[i].count = 0;
+        m_durations[i].total = 0;
+        m_durations[i].max = 0;
+    }
+}
+
+void
+Target::Statistics::AddToDictionary (StructuredData::Dictionary &dict) const
+{
+    static const char *g_duration_names[kNumDurations] =
+    {
+        "expression_parse",
+        "expression_jit",
+        "expression_run",
+        "breakpoint_resolve",
+        "stop_to_prompt"
+    };
+
+    Mutex::Locker locker (m_mutex);
+    for (uint32_t i = 0; i < kNumDurations; ++i)
+    {
+        const DurationStats &stats = m_durations[i];
+        StructuredData::DictionarySP duration_dict_sp (new StructuredData::Dictionary());
+        duration_dict_sp->AddIntegerItem ("count", stats.count);
+        duration_dict_sp->AddFloatItem ("total_time", (double)stats.total / TimeValue::NanoSecPerSec);
+        duration_dict_sp->AddFloatItem ("max_time", (double)stats.max / TimeValue::NanoSecPerSec);
+        dict.AddItem (g_duration_names[i], duration_dict_sp);
+    }
+}
+
+Target::Statistics::ScopedDuration::ScopedDuration (Target *target, Duration duration) :
+    m_target (target),
+    m_duration (duration),
+    m_start (TimeValue::Now())
+{
+}
+
+Target::Statistics::ScopedDuration::~ScopedDuration ()
+{
+    if (m_target)
+    {
+        TimeValue end (TimeValue::Now());
+        m_target->GetStatistics().AddDuration (m_duration, end.GetAsNanoSecondsSinceJan1_1970() - m_start.GetAsNanoSecondsSinceJan1_1970());
+    }
+}
+
+StructuredData::DictionarySP
+Target::ReportStatistics ()
+{
+    StructuredData::DictionarySP stats_sp (new StructuredData::Dictionary());
+
+    ModuleSP exe_module_sp (GetExecutableModule());
+    if (exe_module_sp)
+        stats_sp->AddStringItem ("executable", exe_module_sp->GetFileSpec().GetPath());
+
+    StructuredData::ArraySP modules_sp (new StructuredData::Array());
+    const size_t num_modules = m_images.GetSize();
+    for (size_t i = 0; i < num_modules; ++i)
+    {
+        ModuleSP module_sp (m_images.GetModuleAtIndex(i));
+        if (!module_sp)
+            continue;
+        StructuredData::DictionarySP module_dict_sp (new StructuredData::Dictionary());
+        module_dict_sp->AddStringItem ("path", module_sp->GetFileSpec().GetPath());
+        if (module_sp->GetUUID().IsValid())
+            module_dict_sp->AddStringItem ("uuid", module_sp->GetUUID().GetAsString());
+        // Don't create symbol vendors just to report on them
+        SymbolVendor *sym_vendor = module_sp->GetSymbolVendor (false);
+        if (sym_vendor)
+        {
+            // The symbol file walks its DIEs and type maps, which other
+            // threads only change with the module locked.
+            Mutex::Locker locker (module_sp->GetMutex());
+            module_dict_sp->AddFloatItem ("symtab_parse_time", (double)sym_vendor->GetSymtabParseTime() / TimeValue::NanoSecPerSec);
+            SymbolFile *sym_file = sym_vendor->GetSymbolFile();
+            if (sym_file)
+                sym_file->AddStatistics (*module_dict_sp);
+        }
+        modules_sp->AddItem (module_dict_sp);
+    }
+    stats_sp->AddItem ("modules", modules_sp);
+
+    StructuredData::DictionarySP durations_sp (new StructuredData::Dictionary());
+    m_stats.AddToDictionary (*durations_sp);
+    stats_sp->AddItem ("durations", durations_sp);
+
+    ProcessSP process_sp (m_process_sp);
+    if (process_sp)
+    {
+        StructuredData::DictionarySP process_dict_sp (new StructuredData::Dictionary());
+        process_sp->AddStatistics (*process_dict_sp);
+        stats_sp->AddItem ("process", process_dict_sp);
+    }
+
+    return stats_sp;
+}
+
 Target::StopHookSP
 Target::CreateStopHook ()
 {
@@ -34,11 +34,19 @@ ThreadPlanStepOverBreakpoint::ThreadPlanStepOverBreakpoint (Thread &thread) :
                             // over a breakpoint
     m_breakpoint_addr (LLDB_INVALID_ADDRESS),
     m_auto_continue(false),
-    m_reenabled_breakpoint_site (false)
+    m_reenabled_breakpoint_site (false),
+    m_use_displaced_step (false)
 
 {
     m_breakpoint_addr = m_thread.GetRegisterContext()->GetPC();
     m_breakpoint_site_id =  m_thread.GetProcess()->GetBreakpointSiteList().FindIDByAddress (m_breakpoint_addr);
+
+    // If the process can step over a software breakpoint without removing
+    // it, the other threads can't run past the breakpoint while we step
+    // and don't need to be stopped.
+    BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
+    if (bp_site_sp && bp_site_sp->GetType() == BreakpointSite::eSoftware)
+        m_use_displaced_step = m_thread.GetProcess()->SupportsDisplacedStepping();
 }
 
 ThreadPlanStepOverBreakpoint::~ThreadPlanStepOverBreakpoint ()
@@ -103,6 +111,13 @@ ThreadPlanStepOverBreakpoint::ShouldStop (Event *event_ptr)
 bool
 ThreadPlanStepOverBreakpoint::StopOthers ()
 {
+    if (m_use_displaced_step)
+    {
+        // Let the other threads do whatever the plan we are stepping for
+        // would let them do.
+        ThreadPlan *prev_plan = GetPreviousPlan ();
+        return prev_plan ? prev_plan->StopOthers () : false;
+    }
     return true;
 }
 
@@ -115,7 +130,7 @@ ThreadPlanStepOverBreakpoint::GetPlanRunState ()
 bool
 ThreadPlanStepOverBreakpoint::DoWillResume (StateType resume_state, bool current_plan)
 {
-    if (current_plan)
+    if (current_plan && !m_use_displaced_step)
     {
         BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
         if (bp_site_sp  && bp_site_sp->IsEnabled())
@@ -157,7 +172,7 @@ ThreadPlanStepOverBreakpoint::MischiefManaged ()
 void
 ThreadPlanStepOverBreakpoint::ReenableBreakpointSite ()
 {
-    if (!m_reenabled_breakpoint_site)
+    if (!m_reenabled_breakpoint_site && !m_use_displaced_step)
     {
         m_reenabled_breakpoint_site = true;
         BreakpointSiteSP bp_site_sp (m_thread.GetProcess()->GetBreakpointSiteList().FindByAddress (m_breakpoint_addr));
@@ -103,6 +103,8 @@ lldb_private::GetSectionTypeAsCString(lldb::SectionType sect_type)
             return "eh-frame";
         case eSectionTypeCompactUnwind:
             return "compact-unwind";
+        case eSectionTypeGNUDebugData:
+            return "gnu-debugdata";
         case eSectionTypeOther:
             return "regular";
     }
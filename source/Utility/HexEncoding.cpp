@@ -0,0 +1,133 @@
+//===-- HexEncoding.cpp -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Utility/HexEncoding.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lldb_private;
+
+const int8_t HexEncoding::g_digit_values[256] =
+{
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+     0,  1,  2,  3,  4,  5,  6,  7,  8,  9, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, 10, 11, 12, 13, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+    -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
+
+static const char g_hex_chars[] = "0123456789abcdef";
+
+#if defined(__SSE2__)
+
+//----------------------------------------------------------------------
+// Converts 16 nibbles (0-15) to their lower case hex digits.
+//----------------------------------------------------------------------
+static inline __m128i
+NibblesToHexDigits (__m128i nibbles)
+{
+    // '0' + nibble, plus ('a' - '0' - 10) for nibbles over 9
+    const __m128i letters = _mm_and_si128 (_mm_cmpgt_epi8 (nibbles, _mm_set1_epi8 (9)),
+                                           _mm_set1_epi8 ('a' - '0' - 10));
+    return _mm_add_epi8 (_mm_add_epi8 (nibbles, _mm_set1_epi8 ('0')), letters);
+}
+
+//----------------------------------------------------------------------
+// Decodes 16 hex digits into 8 bytes. Returns false, without writing
+// anything, if any of the characters isn't a hex digit.
+//----------------------------------------------------------------------
+static inline bool
+DecodeHexDigits16 (const char *src, uint8_t *dst)
+{
+    const __m128i chars = _mm_loadu_si128 ((const __m128i *)src);
+
+    // SSE2 has no unsigned byte compare, but min(x, limit) == x is x <= limit.
+    const __m128i digits = _mm_sub_epi8 (chars, _mm_set1_epi8 ('0'));
+    const __m128i is_digit = _mm_cmpeq_epi8 (_mm_min_epu8 (digits, _mm_set1_epi8 (9)), digits);
+    const __m128i letters = _mm_sub_epi8 (_mm_or_si128 (chars, _mm_set1_epi8 (0x20)), _mm_set1_epi8 ('a'));
+    const __m128i is_letter = _mm_cmpeq_epi8 (_mm_min_epu8 (letters, _mm_set1_epi8 (5)), letters);
+    if (_mm_movemask_epi8 (_mm_or_si128 (is_digit, is_letter)) != 0xffff)
+        return false;
+
+    const __m128i nibbles = _mm_or_si128 (_mm_and_si128 (is_digit, digits),
+                                          _mm_and_si128 (is_letter, _mm_add_epi8 (letters, _mm_set1_epi8 (10))));
+
+    // Each 16 bit lane holds a high nibble in its low byte and a low
+    // nibble in its high byte: combine them and pack the lanes to bytes.
+    const __m128i high = _mm_slli_epi16 (_mm_and_si128 (nibbles, _mm_set1_epi16 (0x00ff)), 4);
+    const __m128i low = _mm_srli_epi16 (nibbles, 8);
+    const __m128i bytes = _mm_packus_epi16 (_mm_or_si128 (high, low), _mm_setzero_si128());
+    _mm_storel_epi64 ((__m128i *)dst, bytes);
+    return true;
+}
+
+#endif // defined(__SSE2__)
+
+void
+HexEncoding::Encode (const void *src_void, size_t src_len, char *dst)
+{
+    const uint8_t *src = (const uint8_t *)src_void;
+    size_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 16 <= src_len; i += 16, dst += 32)
+    {
+        const __m128i bytes = _mm_loadu_si128 ((const __m128i *)(src + i));
+        const __m128i low_mask = _mm_set1_epi8 (0x0f);
+        const __m128i high = _mm_and_si128 (_mm_srli_epi16 (bytes, 4), low_mask);
+        const __m128i low = _mm_and_si128 (bytes, low_mask);
+        // Interleave the nibbles so each byte becomes its two digits.
+        _mm_storeu_si128 ((__m128i *)dst, NibblesToHexDigits (_mm_unpacklo_epi8 (high, low)));
+        _mm_storeu_si128 ((__m128i *)(dst + 16), NibblesToHexDigits (_mm_unpackhi_epi8 (high, low)));
+    }
+#endif
+    for (; i < src_len; ++i)
+    {
+        *dst++ = g_hex_chars[src[i] >> 4];
+        *dst++ = g_hex_chars[src[i] & 0xf];
+    }
+}
+
+size_t
+HexEncoding::Decode (const char *src, size_t src_len, void *dst_void, size_t dst_len)
+{
+    uint8_t *dst = (uint8_t *)dst_void;
+    const size_t max_bytes = src_len / 2 < dst_len ? src_len / 2 : dst_len;
+    size_t i = 0;
+#if defined(__SSE2__)
+    // Stop at the first block with a character that isn't a hex digit
+    // and let the loop below find exactly where the digits end.
+    for (; i + 8 <= max_bytes; i += 8)
+    {
+        if (!DecodeHexDigits16 (src + i * 2, dst + i))
+            break;
+    }
+#endif
+    for (; i < max_bytes; ++i)
+    {
+        const int high = DecodeDigit (src[i * 2]);
+        const int low = DecodeDigit (src[i * 2 + 1]);
+        if (high < 0 || low < 0)
+            break;
+        dst[i] = (uint8_t)((high << 4) | low);
+    }
+    return i;
+}
@@ -15,18 +15,9 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Utility/HexEncoding.h"
 
-static inline int
-xdigit_to_sint (char ch)
-{
-    if (ch >= 'a' && ch <= 'f')
-        return 10 + ch - 'a';
-    if (ch >= 'A' && ch <= 'F')
-        return 10 + ch - 'A';
-    if (ch >= '0' && ch <= '9')
-        return ch - '0';
-    return -1;
-}
+using namespace lldb_private;
 
 //----------------------------------------------------------------------
 // StringExtractor constructor
@@ -108,8 +99,8 @@ StringExtractor::DecodeHexU8()
     {
         return -1;
     }
-    const int hi_nibble = xdigit_to_sint(m_packet[m_index]);
-    const int lo_nibble = xdigit_to_sint(m_packet[m_index+1]);
+    const int hi_nibble = HexEncoding::DecodeDigit (m_packet[m_index]);
+    const int lo_nibble = HexEncoding::DecodeDigit (m_packet[m_index+1]);
     if (hi_nibble == -1 || lo_nibble == -1)
     {
         return -1;
@@ -222,7 +213,7 @@ StringExtractor::GetHexMaxU32 (bool little_endian, uint32_t fail_value)
     if (little_endian)
     {
         uint32_t shift_amount = 0;
-        while (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+        while (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
         {
             // Make sure we don't exceed the size of a uint32_t...
             if (nibble_count >= (sizeof(uint32_t) * 2))
@@ -232,11 +223,11 @@ StringExtractor::GetHexMaxU32 (bool little_endian, uint32_t fail_value)
             }
 
             uint8_t nibble_lo;
-            uint8_t nibble_hi = xdigit_to_sint (m_packet[m_index]);
+            uint8_t nibble_hi = HexEncoding::DecodeDigit (m_packet[m_index]);
             ++m_index;
-            if (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+            if (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
             {
-                nibble_lo = xdigit_to_sint (m_packet[m_index]);
+                nibble_lo = HexEncoding::DecodeDigit (m_packet[m_index]);
                 ++m_index;
                 result |= ((uint32_t)nibble_hi << (shift_amount + 4));
                 result |= ((uint32_t)nibble_lo << shift_amount);
@@ -254,7 +245,7 @@ StringExtractor::GetHexMaxU32 (bool little_endian, uint32_t fail_value)
     }
     else
     {
-        while (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+        while (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
         {
             // Make sure we don't exceed the size of a uint32_t...
             if (nibble_count >= (sizeof(uint32_t) * 2))
@@ -263,7 +254,7 @@ StringExtractor::GetHexMaxU32 (bool little_endian, uint32_t fail_value)
                 return fail_value;
             }
 
-            uint8_t nibble = xdigit_to_sint (m_packet[m_index]);
+            uint8_t nibble = HexEncoding::DecodeDigit (m_packet[m_index]);
             // Big Endian
             result <<= 4;
             result |= nibble;
@@ -284,7 +275,7 @@ StringExtractor::GetHexMaxU64 (bool little_endian, uint64_t fail_value)
     if (little_endian)
     {
         uint32_t shift_amount = 0;
-        while (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+        while (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
         {
             // Make sure we don't exceed the size of a uint64_t...
             if (nibble_count >= (sizeof(uint64_t) * 2))
@@ -294,11 +285,11 @@ StringExtractor::GetHexMaxU64 (bool little_endian, uint64_t fail_value)
             }
 
             uint8_t nibble_lo;
-            uint8_t nibble_hi = xdigit_to_sint (m_packet[m_index]);
+            uint8_t nibble_hi = HexEncoding::DecodeDigit (m_packet[m_index]);
             ++m_index;
-            if (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+            if (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
             {
-                nibble_lo = xdigit_to_sint (m_packet[m_index]);
+                nibble_lo = HexEncoding::DecodeDigit (m_packet[m_index]);
                 ++m_index;
                 result |= ((uint64_t)nibble_hi << (shift_amount + 4));
                 result |= ((uint64_t)nibble_lo << shift_amount);
@@ -316,7 +307,7 @@ StringExtractor::GetHexMaxU64 (bool little_endian, uint64_t fail_value)
     }
     else
     {
-        while (m_index < m_packet.size() && ::isxdigit (m_packet[m_index]))
+        while (m_index < m_packet.size() && HexEncoding::DecodeDigit (m_packet[m_index]) >= 0)
         {
             // Make sure we don't exceed the size of a uint64_t...
             if (nibble_count >= (sizeof(uint64_t) * 2))
@@ -325,7 +316,7 @@ StringExtractor::GetHexMaxU64 (bool little_endian, uint64_t fail_value)
                 return fail_value;
             }
 
-            uint8_t nibble = xdigit_to_sint (m_packet[m_index]);
+            uint8_t nibble = HexEncoding::DecodeDigit (m_packet[m_index]);
             // Big Endian
             result <<= 4;
             result |= nibble;
@@ -342,13 +333,15 @@ StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_
 {
     uint8_t *dst = (uint8_t*)dst_void;
     size_t bytes_extracted = 0;
-    while (bytes_extracted < dst_len && GetBytesLeft ())
+    const size_t bytes_left = GetBytesLeft ();
+    if (bytes_left)
     {
-        dst[bytes_extracted] = GetHexU8 (fail_fill_value);
-        if (IsGood())
-            ++bytes_extracted;
-        else
-            break;
+        bytes_extracted = HexEncoding::Decode (m_packet.data() + m_index, bytes_left, dst, dst_len);
+        m_index += bytes_extracted * 2;
+        // Running into anything other than a hex byte before filling
+        // the buffer is an error
+        if (bytes_extracted < dst_len && GetBytesLeft ())
+            m_index = UINT64_MAX;
     }
 
     for (size_t i = bytes_extracted; i < dst_len; ++i)
@@ -366,17 +359,11 @@ StringExtractor::GetHexBytes (void *dst_void, size_t dst_len, uint8_t fail_fill_
 size_t
 StringExtractor::GetHexBytesAvail (void *dst_void, size_t dst_len)
 {
-    uint8_t *dst = (uint8_t*)dst_void;
-    size_t bytes_extracted = 0;
-    while (bytes_extracted < dst_len)
-    {
-        int decode = DecodeHexU8();
-        if (decode == -1)
-        {
-            break;
-        }
-        dst[bytes_extracted++] = (uint8_t)decode;
-    }
+    const size_t bytes_left = GetBytesLeft ();
+    if (bytes_left == 0)
+        return 0;
+    const size_t bytes_extracted = HexEncoding::Decode (m_packet.data() + m_index, bytes_left, dst_void, dst_len);
+    m_index += bytes_extracted * 2;
     return bytes_extracted;
 }
 
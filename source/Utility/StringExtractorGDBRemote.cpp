@@ -87,6 +87,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
 
         switch (packet_cstr[1])
         {
+        case 'B':
+            if (PACKET_STARTS_WITH ("QBreakpoints:"))           return eServerPacketType_QBreakpoints;
+            break;
+
         case 'E':
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment;
             if (PACKET_STARTS_WITH ("QEnvironmentHexEncoded:")) return eServerPacketType_QEnvironmentHexEncoded;
@@ -113,12 +117,17 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_MATCHES("QListThreadsInStopReply"))        return eServerPacketType_QListThreadsInStopReply;
             break;
 
+        case 'N':
+            if (PACKET_STARTS_WITH ("QNonStop:"))                 return eServerPacketType_QNonStop;
+            break;
+
         case 'R':
             if (PACKET_STARTS_WITH ("QRestoreRegisterState:"))    return eServerPacketType_QRestoreRegisterState;
             break;
 
         case 'T':
             if (PACKET_MATCHES ("QThreadSuffixSupported"))        return eServerPacketType_QThreadSuffixSupported;
+            if (PACKET_STARTS_WITH ("QTracepoint:"))              return eServerPacketType_QTracepoint;
             break;
         }
         break;
@@ -168,6 +177,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         case 'M':
             if (PACKET_STARTS_WITH ("qMemoryRegionInfo:"))      return eServerPacketType_qMemoryRegionInfo;
             if (PACKET_MATCHES ("qMemoryRegionInfo"))           return eServerPacketType_qMemoryRegionInfoSupported;
+            if (PACKET_STARTS_WITH ("qMemoryRegionMap"))        return eServerPacketType_qMemoryRegionMap;
             if (PACKET_STARTS_WITH ("qModuleInfo:"))             return eServerPacketType_qModuleInfo;
             break;
 
@@ -181,6 +191,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
                 
         case 'R':
             if (PACKET_STARTS_WITH ("qRcmd,"))                  return eServerPacketType_qRcmd;
+            if (PACKET_STARTS_WITH ("qReadMemoryRanges:"))      return eServerPacketType_qReadMemoryRanges;
             if (PACKET_STARTS_WITH ("qRegisterInfo"))           return eServerPacketType_qRegisterInfo;
             break;
 
@@ -195,6 +206,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
         case 'T':
             if (PACKET_STARTS_WITH ("qThreadExtraInfo,"))       return eServerPacketType_qThreadExtraInfo;
             if (PACKET_STARTS_WITH ("qThreadStopInfo"))         return eServerPacketType_qThreadStopInfo;
+            if (PACKET_STARTS_WITH ("qTracepointData"))         return eServerPacketType_qTracepointData;
             break;
 
         case 'U':
@@ -206,6 +218,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
             break;
 
         case 'W':
+            if (PACKET_STARTS_WITH ("qWatchpointOverhead:"))    return eServerPacketType_qWatchpointOverhead;
             if (PACKET_STARTS_WITH ("qWatchpointSupportInfo:")) return eServerPacketType_qWatchpointSupportInfo;
             if (PACKET_MATCHES ("qWatchpointSupportInfo"))      return eServerPacketType_qWatchpointSupportInfoSupported;
             break;
@@ -237,6 +250,7 @@ StringExtractorGDBRemote::GetServerPacketType () const
               if (PACKET_STARTS_WITH ("vAttachName;"))          return eServerPacketType_vAttachName;
               if (PACKET_STARTS_WITH("vCont;"))                 return eServerPacketType_vCont;
               if (PACKET_MATCHES ("vCont?"))                    return eServerPacketType_vCont_actions;
+              if (PACKET_MATCHES ("vStopped"))                  return eServerPacketType_vStopped;
             }
             break;
       case '_':
@@ -85,8 +85,10 @@ public:
         eServerPacketType_vFile_symlink,
         eServerPacketType_vFile_unlink,
       // debug server packages
+        eServerPacketType_QBreakpoints,
         eServerPacketType_QEnvironmentHexEncoded,
         eServerPacketType_QListThreadsInStopReply,
+        eServerPacketType_QNonStop,
         eServerPacketType_QRestoreRegisterState,
         eServerPacketType_QSaveRegisterState,
         eServerPacketType_QSetLogging,
@@ -95,6 +97,7 @@ public:
         eServerPacketType_QSetEnableAsyncProfiling,
         eServerPacketType_QSyncThreadState,
         eServerPacketType_QThreadSuffixSupported,
+        eServerPacketType_QTracepoint,
 
         eServerPacketType_qsThreadInfo,
         eServerPacketType_qfThreadInfo,
@@ -103,8 +106,10 @@ public:
         eServerPacketType_qGDBServerVersion,
         eServerPacketType_qMemoryRegionInfo,
         eServerPacketType_qMemoryRegionInfoSupported,
+        eServerPacketType_qMemoryRegionMap,
         eServerPacketType_qProcessInfo,
         eServerPacketType_qRcmd,
+        eServerPacketType_qReadMemoryRanges,
         eServerPacketType_qRegisterInfo,
         eServerPacketType_qShlibInfoAddr,
         eServerPacketType_qStepPacketSupported,
@@ -112,7 +117,9 @@ public:
         eServerPacketType_qSyncThreadStateSupported,
         eServerPacketType_qThreadExtraInfo,
         eServerPacketType_qThreadStopInfo,
+        eServerPacketType_qTracepointData,
         eServerPacketType_qVAttachOrWaitSupported,
+        eServerPacketType_qWatchpointOverhead,
         eServerPacketType_qWatchpointSupportInfo,
         eServerPacketType_qWatchpointSupportInfoSupported,
         eServerPacketType_qXfer_auxv_read,
@@ -123,6 +130,7 @@ public:
         eServerPacketType_vAttachName,
         eServerPacketType_vCont,
         eServerPacketType_vCont_actions, // vCont?
+        eServerPacketType_vStopped,
 
         eServerPacketType_stop_reason, // '?'
 
@@ -0,0 +1,69 @@
+"""
+Test breakpoints that are inserted and removed together.
+"""
+
+import os, time
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class BreakpointBatchesTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_FUNCTIONS = 8
+
+    @python_api_test
+    @dwarf_test
+    def test_breakpoint_batches_with_dwarf(self):
+        """Test that breakpoints set and cleared together all take effect."""
+        self.buildDwarf()
+        self.breakpoint_batches()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def breakpoint_batches(self):
+        """Test that breakpoints set and cleared together all take effect."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        # The sites of a breakpoint set before launch get inserted together
+        # when the executable loads.
+        functions_breakpoint = target.BreakpointCreateByRegex("^batch_function_[0-9]+$")
+        self.assertTrue(functions_breakpoint, VALID_BREAKPOINT)
+        self.assertEqual(functions_breakpoint.GetNumLocations(), self.NUM_FUNCTIONS)
+
+        line_breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(line_breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, line_breakpoint)
+        self.assertTrue(thread, "There should be a thread stopped at the breakpoint")
+
+        for i in range(self.NUM_FUNCTIONS):
+            process.Continue()
+            thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, functions_breakpoint)
+            self.assertTrue(thread, "There should be a thread stopped in batch_function_%d" % i)
+            self.assertEqual(thread.GetFrameAtIndex(0).GetFunctionName(), "batch_function_%d" % i)
+
+        # Disabling the breakpoint removes all of its sites together, and
+        # the original instructions have to be back for the second round
+        # of calls to run.
+        self.assertTrue(functions_breakpoint.SetEnabled(False))
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+        self.assertEqual(process.GetExitStatus(), 3 * self.NUM_FUNCTIONS)
+        self.assertEqual(functions_breakpoint.GetHitCount(), self.NUM_FUNCTIONS)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,43 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int g_count = 0;
+
+#define BATCH_FUNCTION(n) \
+    int __attribute__((noinline)) batch_function_##n (int i) { g_count += i; return g_count; }
+
+BATCH_FUNCTION(0)
+BATCH_FUNCTION(1)
+BATCH_FUNCTION(2)
+BATCH_FUNCTION(3)
+BATCH_FUNCTION(4)
+BATCH_FUNCTION(5)
+BATCH_FUNCTION(6)
+BATCH_FUNCTION(7)
+
+static void
+call_all (int i)
+{
+    batch_function_0 (i);
+    batch_function_1 (i);
+    batch_function_2 (i);
+    batch_function_3 (i);
+    batch_function_4 (i);
+    batch_function_5 (i);
+    batch_function_6 (i);
+    batch_function_7 (i);
+}
+
+int
+main (int argc, char const *argv[])
+{
+    call_all (1); // Set break point at this line.
+    call_all (2);
+    return g_count;
+}
@@ -0,0 +1,73 @@
+"""
+Test file and line breakpoints in a program with several compile units,
+which only look at the compile units whose line tables mention the file.
+"""
+
+import os
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class FileLineIndexTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @python_api_test
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that file and line breakpoints find the compile units that use the file."""
+        self.buildDwarf()
+        self.file_line_breakpoints()
+
+    def check_locations(self, target, file_spec, line, expected_functions):
+        breakpoint = target.BreakpointCreateByLocation(file_spec, line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+        functions = []
+        for location in breakpoint:
+            functions.append(location.GetAddress().GetFunction().GetName())
+        self.assertEqual(sorted(functions), sorted(expected_functions),
+                         "locations of %s:%d" % (file_spec.GetFilename(), line))
+
+    def file_line_breakpoints(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        for name, function in [("main.c", "main"), ("a.c", "a_function"), ("b.c", "b_function")]:
+            line = line_number(name, '// Set break point in %s' % name)
+            self.check_locations(target, lldb.SBFileSpec(name), line, [function])
+
+        # The header is only a support file of the compile units that include
+        # it, and each of them has a copy of the function.
+        line = line_number('shared.h', '// Set break point in shared.h')
+        self.check_locations(target, lldb.SBFileSpec("shared.h"), line, ["shared_function", "shared_function"])
+        self.check_locations(target, lldb.SBFileSpec(os.path.join(os.getcwd(), "shared.h")), line,
+                             ["shared_function", "shared_function"])
+
+        # A full path still has to match, not just the basename.
+        self.check_locations(target, lldb.SBFileSpec(os.path.join(os.getcwd(), "missing", "a.c")),
+                             line_number('a.c', '// Set break point in a.c'), [])
+        self.check_locations(target, lldb.SBFileSpec("missing.c"), 1, [])
+
+        # The locations are where the program stops.
+        breakpoint = target.BreakpointCreateByLocation("shared.h", line)
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(len(threads), 1, "stopped in shared_function")
+        caller = threads[0].GetFrameAtIndex(1).GetFunctionName()
+        self.assertEqual(caller, "a_function")
+        process.Continue()
+        threads = lldbutil.get_threads_stopped_at_breakpoint(process, breakpoint)
+        self.assertEqual(len(threads), 1, "stopped in shared_function")
+        caller = threads[0].GetFrameAtIndex(1).GetFunctionName()
+        self.assertEqual(caller, "b_function")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,16 @@
+//===-- a.c -----------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "shared.h"
+
+int
+a_function (int i)
+{
+    return shared_function (i) + 1; // Set break point in a.c
+}
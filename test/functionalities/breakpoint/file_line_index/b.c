@@ -0,0 +1,16 @@
+//===-- b.c -----------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "shared.h"
+
+int
+b_function (int i)
+{
+    return shared_function (i) + 2; // Set break point in b.c
+}
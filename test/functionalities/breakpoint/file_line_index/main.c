@@ -0,0 +1,17 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int a_function (int i);
+int b_function (int i);
+
+int
+main (int argc, char const *argv[])
+{
+    return a_function (argc) + b_function (argc); // Set break point in main.c
+}
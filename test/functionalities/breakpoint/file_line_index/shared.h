@@ -0,0 +1,15 @@
+//===-- shared.h ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Each compile unit that includes this gets a copy of the function.
+static int __attribute__((noinline, used))
+shared_function (int i)
+{
+    return i * 3; // Set break point in shared.h
+}
@@ -0,0 +1,118 @@
+"""
+Test breakpoint conditions that lldb-server evaluates.
+"""
+
+import os, time
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class ServerConditionsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    # Conditions that compile to agent expressions, and the value of "i" at
+    # the first hit after the previous one where each is true. They are
+    # set one after the other on the same breakpoint.
+    CONDITIONS = [
+        ("!(i < 10) || i == 3", 3),
+        ("i == 5", 5),
+        ("*ptr == 49", 7),
+        ("i * 3 > 20 && i % 2 == 0", 8),
+        ("(i << 1) - 1 == 17", 9),
+    ]
+
+    @python_api_test
+    @dwarf_test
+    @skipUnlessPlatform(['linux'])
+    def test_server_conditions_with_dwarf(self):
+        """Test that conditions evaluated by lldb-server stop at the right hits."""
+        self.buildDwarf()
+        self.server_conditions()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set the breakpoint here.')
+        self.log_file = os.path.join(os.getcwd(), "server-conditions-packets.log")
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+        def cleanup():
+            self.runCmd("log disable gdb-remote packets", check=False)
+            if os.path.exists(self.log_file):
+                os.remove(self.log_file)
+        self.addTearDownHook(cleanup)
+
+    def last_breakpoint_packet(self):
+        """Return the last Z0 packet that was sent to the stub."""
+        with open(self.log_file, "r") as f:
+            packets = [line for line in f if "$Z0," in line and "send packet" in line]
+        self.assertTrue(len(packets) > 0, "No breakpoint was inserted")
+        return packets[-1]
+
+    def continue_to_breakpoint(self, process, breakpoint):
+        process.Continue()
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(thread, "There should be a thread stopped at the breakpoint")
+        return thread.GetFrameAtIndex(0).FindVariable("i").GetValueAsSigned()
+
+    def server_conditions(self):
+        """Test that conditions evaluated by lldb-server stop at the right hits."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+        breakpoint.SetCondition("i == 1")
+
+        self.runCmd("log enable -f '%s' gdb-remote packets" % self.log_file)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(thread, "There should be a thread stopped at the breakpoint")
+        self.assertEqual(thread.GetFrameAtIndex(0).FindVariable("i").GetValueAsSigned(), 1)
+
+        # Changing the condition inserts the breakpoint again with the new
+        # bytecode.
+        for condition, expected_i in self.CONDITIONS:
+            breakpoint.SetCondition(condition)
+            self.assertTrue(";X" in self.last_breakpoint_packet(),
+                            "Condition '%s' should be sent to the stub" % condition)
+            self.assertEqual(self.continue_to_breakpoint(process, breakpoint), expected_i,
+                             "Condition '%s' stopped at the wrong hit" % condition)
+
+        # Ignore counts need to see every hit, so the stub no longer gets
+        # the condition. The first even hit after 9 is ignored.
+        breakpoint.SetCondition("i % 2 == 0")
+        self.assertTrue(";X" in self.last_breakpoint_packet())
+        breakpoint.SetIgnoreCount(1)
+        self.assertFalse(";X" in self.last_breakpoint_packet(),
+                         "Setting an ignore count should insert the breakpoint without conditions")
+        self.assertEqual(self.continue_to_breakpoint(process, breakpoint), 12)
+
+        # So do thread specific breakpoints.
+        breakpoint.SetThreadID(thread.GetThreadID())
+        self.assertFalse(";X" in self.last_breakpoint_packet())
+        self.assertEqual(self.continue_to_breakpoint(process, breakpoint), 14)
+
+        # Clearing the thread hands the condition back to the stub.
+        breakpoint.SetThreadID(lldb.LLDB_INVALID_THREAD_ID)
+        self.assertTrue(";X" in self.last_breakpoint_packet())
+
+        # Conditions that need the expression parser are evaluated by the
+        # debugger.
+        breakpoint.SetCondition("(int)sizeof(int) * 0 + i == 15")
+        self.assertFalse(";X" in self.last_breakpoint_packet())
+        self.assertEqual(self.continue_to_breakpoint(process, breakpoint), 15)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,31 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int g_checks = 0;
+
+void
+check (int i, int *ptr)
+{
+    g_checks += *ptr - i * i; // Set the breakpoint here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int values[16];
+    int i;
+    for (i = 0; i < 16; i++)
+    {
+        values[i] = i * i;
+        check (i, &values[i]);
+    }
+    printf ("checks = %d\n", g_checks);
+    return 0;
+}
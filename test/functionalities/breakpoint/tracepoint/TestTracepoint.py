@@ -0,0 +1,152 @@
+"""
+Test tracepoints, breakpoints that collect data without stopping.
+"""
+
+import os, time
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class TracepointTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @dwarf_test
+    @skipUnlessPlatform(['linux'])
+    def test_tracepoint_with_dwarf_and_run_command(self):
+        """Exercise 'tracepoint collect' and 'tracepoint data'."""
+        self.buildDwarf()
+        self.tracepoint_commands()
+
+    @python_api_test
+    @dwarf_test
+    @skipUnlessPlatform(['linux'])
+    def test_tracepoint_with_dwarf_and_python_api(self):
+        """Use Python APIs to set tracepoints and read their data."""
+        self.buildDwarf()
+        self.tracepoint_python()
+
+    @python_api_test
+    @dwarf_test
+    @skipUnlessPlatform(['linux'])
+    def test_tracepoint_ignore_count_with_dwarf(self):
+        """Test that a tracepoint given an ignore count stops again."""
+        self.buildDwarf()
+        self.tracepoint_ignore_count()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.trace_line = line_number('main.c', '// Set the tracepoint here.')
+        self.break_line = line_number('main.c', '// Set the breakpoint here.')
+
+    def tracepoint_commands(self):
+        """Exercise 'tracepoint collect' and 'tracepoint data'."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.trace_line, num_expected_locations=1, loc_exact=True)
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.break_line, num_expected_locations=1, loc_exact=True)
+        self.runCmd("tracepoint collect 1 val")
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The tracepoint never stops the process, only breakpoint 2 does.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint 2.1'])
+
+        self.expect("tracepoint data",
+            substrs = ['tracepoint 1.1', 'val = 0x00000001', 'val = 0x0000000a'])
+
+        # The records were drained by the previous command.
+        self.expect("tracepoint data", matching=False,
+            substrs = ['tracepoint 1.1'])
+
+    def tracepoint_python(self):
+        """Use Python APIs to set tracepoints and read their data."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        tracepoint = target.BreakpointCreateByLocation("main.c", self.trace_line)
+        self.assertTrue(tracepoint, VALID_BREAKPOINT)
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.break_line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        collect = lldb.SBStringList()
+        collect.AppendString("val")
+        tracepoint.SetTracepointCollect(collect)
+        self.assertTrue(tracepoint.IsTracepoint())
+        self.assertFalse(breakpoint.IsTracepoint())
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint")
+        self.assertTrue(thread.GetStopReasonDataAtIndex(0) == breakpoint.GetID())
+
+        records = lldb.SBTracepointRecordList()
+        error = process.GetTracepointData(records)
+        self.assertTrue(error.Success(), "GetTracepointData failed: %s" % error.GetCString())
+        if self.TraceOn():
+            stream = lldb.SBStream()
+            records.GetDescription(stream)
+            print "tracepoint data:", stream.GetData()
+
+        self.assertTrue(records.GetSize() + records.GetNumDropped() == 10)
+        for i in range(records.GetSize()):
+            self.assertTrue(records.GetBreakpointIDAtIndex(i) == tracepoint.GetID())
+            self.assertTrue(records.GetNumValuesAtIndex(i) == 1)
+            self.assertTrue(records.GetValueNameAtIndex(i, 0) == "val")
+            data = records.GetValueDataAtIndex(i, 0)
+            self.assertTrue(data.IsValid())
+            data.SetByteOrder(process.GetByteOrder())
+            error = lldb.SBError()
+            self.assertTrue(data.GetSignedInt32(error, 0) == i + 1)
+
+        # Turning the tracepoint back into a breakpoint makes it stop again.
+        tracepoint.SetTracepointCollect(lldb.SBStringList())
+        self.assertFalse(tracepoint.IsTracepoint())
+
+        process.Continue()
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint")
+        self.assertTrue(thread.GetStopReasonDataAtIndex(0) == tracepoint.GetID())
+        self.assertTrue(thread.GetFrameAtIndex(0).FindVariable("val").GetValueAsSigned() == 0)
+
+    def tracepoint_ignore_count(self):
+        """Test that a tracepoint given an ignore count stops again."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        tracepoint = target.BreakpointCreateByLocation("main.c", self.trace_line)
+        self.assertTrue(tracepoint, VALID_BREAKPOINT)
+        main_breakpoint = target.BreakpointCreateByName("main")
+        self.assertTrue(main_breakpoint, VALID_BREAKPOINT)
+
+        collect = lldb.SBStringList()
+        collect.AppendString("val")
+        tracepoint.SetTracepointCollect(collect)
+
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, main_breakpoint)
+        self.assertTrue(thread, "There should be a thread stopped at main")
+
+        # The stub doesn't report tracepoint hits, so the ignore count can
+        # only be honored if the site is inserted as a plain breakpoint.
+        tracepoint.SetIgnoreCount(2)
+        process.Continue()
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, tracepoint)
+        self.assertTrue(thread, "There should be a thread stopped at the tracepoint")
+        self.assertTrue(thread.GetFrameAtIndex(0).FindVariable("val").GetValueAsSigned() == 3)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
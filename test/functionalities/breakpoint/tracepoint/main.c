@@ -0,0 +1,28 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int total = 0;
+
+void
+add (int val)
+{
+    total += val; // Set the tracepoint here.
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int i;
+    for (i = 1; i <= 10; i++)
+        add (i);
+    printf ("total = %d\n", total); // Set the breakpoint here.
+    add (0);
+    return 0;
+}
@@ -0,0 +1,92 @@
+"""
+Test the 'memory cache' command and that read-only memory stays cached
+across stops.
+"""
+
+import os, time
+import re
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class MemoryCacheTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipUnlessDarwin
+    @dsym_test
+    def test_memory_cache_with_dsym(self):
+        """Test the 'memory cache' command."""
+        self.buildDsym()
+        self.memory_cache_command()
+
+    @dwarf_test
+    def test_memory_cache_with_dwarf(self):
+        """Test the 'memory cache' command."""
+        self.buildDwarf()
+        self.memory_cache_command()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+        self.second_line = line_number('main.cpp', '// Set second break point at this line.')
+
+    def get_cache_stat(self, name):
+        self.runCmd("memory cache")
+        match = re.search(r"^\s*%s:\s+(\d+)" % name, self.res.GetOutput(), re.MULTILINE)
+        self.assertTrue(match, "'memory cache' output contains '%s'" % name)
+        return int(match.group(1))
+
+    def memory_cache_command(self):
+        """Test the 'memory cache' command."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.line, num_expected_locations=1, loc_exact=True)
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.second_line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_FAILED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        self.runCmd("memory cache reset")
+
+        # The second read of the same bytes must come from the cache.
+        self.runCmd("memory read -f c -c 4 `&g_const_string`")
+        self.runCmd("memory read -f c -c 4 `&g_const_string`")
+        self.assertTrue(self.get_cache_stat("hits") >= 1)
+
+        # Stop again. The read-only line is kept, checked against the
+        # region info of the new stop and read from the cache.
+        self.runCmd("continue")
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        frame = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread().GetSelectedFrame()
+        addr = frame.EvaluateExpression("&g_const_string").GetValueAsUnsigned()
+        self.assertTrue(addr != 0)
+
+        self.runCmd("memory cache reset")
+        self.expect("memory read -f c -c 4 0x%x" % addr,
+            substrs = ['read'])
+        self.assertEqual(self.get_cache_stat("misses"), 0)
+        self.assertTrue(self.get_cache_stat("hits") >= 1)
+
+        # Memory that was written since the last stop must be read again.
+        self.expect("expression count", substrs = ['= 1'])
+
+        self.expect("memory cache", substrs = ['misses:', 'read-ahead lines:', 'evicted lines:', 'bytes read:'])
+
+        # Anything other than "reset" is an error.
+        self.expect("memory cache bogus", error=True)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,20 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+static const char g_const_string[] = "read-only data that should stay cached";
+
+int main (int argc, char const *argv[])
+{
+    int count = 0;
+    printf("%s\n", g_const_string); // Set break point at this line.
+    count++;
+    printf("%d\n", count); // Set second break point at this line.
+    return 0;
+}
@@ -0,0 +1,90 @@
+"""
+Test the 'statistics dump' command and SBTarget.GetStatistics().
+"""
+
+import os, time
+import json
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class StatisticsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipUnlessDarwin
+    @dsym_test
+    def test_statistics_with_dsym(self):
+        """Test the 'statistics dump' command."""
+        self.buildDsym()
+        self.statistics_dump()
+
+    @dwarf_test
+    def test_statistics_with_dwarf(self):
+        """Test the 'statistics dump' command."""
+        self.buildDwarf()
+        self.statistics_dump()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def get_stats(self, command):
+        self.runCmd(command)
+        return json.loads(self.res.GetOutput())
+
+    def statistics_dump(self):
+        """Test the 'statistics dump' command."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.c", self.line, num_expected_locations=1, loc_exact=True)
+
+        self.runCmd("run", RUN_FAILED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        self.expect("expression g_value + 1", substrs = ['13'])
+
+        stats = self.get_stats("statistics dump")
+        self.assertTrue(stats["const_string_memory_bytes"] > 0)
+        self.assertEqual(len(stats["targets"]), 1)
+        target_stats = stats["targets"][0]
+
+        exe_stats = None
+        for module_stats in target_stats["modules"]:
+            if module_stats["path"] == exe:
+                exe_stats = module_stats
+        self.assertTrue(exe_stats, "the executable is in the module statistics")
+        self.assertTrue("symtab_parse_time" in exe_stats)
+
+        durations = target_stats["durations"]
+        self.assertTrue(durations["breakpoint_resolve"]["count"] >= 1)
+        self.assertTrue(durations["expression_parse"]["count"] >= 1)
+        self.assertTrue(durations["expression_run"]["count"] + durations["expression_jit"]["count"] >= 1)
+
+        self.assertTrue("memory_cache" in target_stats["process"])
+
+        # The SB API reports the same thing as JSON.
+        stream = lldb.SBStream()
+        self.assertTrue(target.GetStatistics(stream))
+        sb_stats = json.loads(stream.GetData())
+        self.assertTrue("modules" in sb_stats)
+
+        stats = self.get_stats("statistics dump --all-targets")
+        self.assertEqual(len(stats["targets"]), 1)
+
+        # Arguments are an error.
+        self.expect("statistics dump bogus", error=True)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,139 @@
+"""
+Test that threads which keep running in non-stop mode can't be unwound and
+don't have their registers read, and that a thread which stops while the
+debugger talks to the stub about another one gets its stop reason.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class NonStopThreadsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipUnlessPlatform(['linux'])
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that a running thread isn't unwound while another is stopped."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.non_stop_threads_test()
+
+    @skipUnlessPlatform(['linux'])
+    @dwarf_test
+    def test_stop_while_reading_memory_with_dwarf(self):
+        """Test that a thread stopping while memory is read doesn't garble the replies."""
+        self.buildDwarf(dictionary=self.getBuildFlags())
+        self.stop_while_reading_memory_test()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers for our breakpoints.
+        self.breakpoint = line_number('main.cpp', '// Set breakpoint here')
+        self.worker_breakpoint = line_number('main.cpp', '// Set worker breakpoint here')
+
+    def set_up_non_stop_target(self):
+        # Non-stop mode is only implemented by lldb-server.
+        self.runCmd('settings show platform.plugin.linux.use-llgs-for-local')
+        if not 'true' in self.res.GetOutput():
+            self.skipTest("non-stop mode requires lldb-server")
+
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+        self.runCmd("settings set target.non-stop-mode true")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.non-stop-mode"))
+
+    def non_stop_threads_test(self):
+        """Test that a running thread isn't unwound while another is stopped."""
+        self.set_up_non_stop_target()
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+
+        self.runCmd("run", RUN_FAILED)
+
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        self.assertTrue(process.GetNumThreads() == 2, 'Number of expected threads and actual threads do not match.')
+
+        stopped_thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertIsNotNone(stopped_thread, "Main thread didn't stop at the breakpoint")
+        running_thread = None
+        for thread in process:
+            if thread.GetThreadID() != stopped_thread.GetThreadID():
+                running_thread = thread
+        self.assertIsNotNone(running_thread)
+
+        # The stopped thread unwinds as usual.
+        self.assertTrue(stopped_thread.GetNumFrames() > 0)
+        self.assertEqual(stopped_thread.GetFrameAtIndex(0).GetFunctionName(), "main")
+
+        # The worker is still spinning, it has no frames and no registers.
+        self.assertEqual(running_thread.GetNumFrames(), 0)
+        self.expect("bt all", matching=False,
+            substrs = ['spin_thread_func'])
+
+        self.runCmd("thread select %d" % running_thread.GetIndexID())
+        self.expect("register read pc", error=True)
+
+        # Let the worker finish and the process exit.
+        self.runCmd("thread select %d" % stopped_thread.GetIndexID())
+        self.runCmd("process continue")
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+
+    def stop_while_reading_memory_test(self):
+        """Test that a thread stopping while memory is read doesn't garble the replies."""
+        self.set_up_non_stop_target()
+        # Every read has to go to the stub.
+        self.runCmd("settings set target.process.disable-memory-cache true")
+        self.addTearDownHook(lambda: self.runCmd("settings clear target.process.disable-memory-cache"))
+
+        lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.breakpoint, num_expected_locations=1)
+        worker_bp_id = lldbutil.run_break_set_by_file_and_line (self, "main.cpp", self.worker_breakpoint, num_expected_locations=1)
+
+        self.runCmd("run stop-worker", RUN_FAILED)
+
+        target = self.dbg.GetSelectedTarget()
+        worker_bp = target.FindBreakpointByID(worker_bp_id)
+        process = target.GetProcess()
+        stopped_thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertIsNotNone(stopped_thread, "Main thread didn't stop at the breakpoint")
+        self.assertEqual(stopped_thread.GetFrameAtIndex(0).GetFunctionName(), "main")
+
+        value = target.FindFirstGlobalVariable("g_value")
+        self.assertTrue(value.IsValid())
+        value_addr = value.GetLoadAddress()
+
+        # The worker hits its breakpoint while we keep reading memory and
+        # registers of the main thread. Its stop notification must not be
+        # taken for the reply to one of those reads.
+        worker_thread = None
+        for i in range(100):
+            for j in range(10):
+                error = lldb.SBError()
+                self.assertEqual(process.ReadUnsignedFromMemory(value_addr, 4, error), 0x12345678)
+                self.assertTrue(error.Success(), error.GetCString())
+            self.assertTrue(stopped_thread.GetFrameAtIndex(0).FindRegister("pc").IsValid())
+            threads = lldbutil.get_threads_stopped_at_breakpoint(process, worker_bp)
+            if threads:
+                worker_thread = threads[0]
+                break
+            time.sleep(0.05)
+        self.assertIsNotNone(worker_thread, "Worker thread didn't report its stop")
+        self.assertEqual(worker_thread.GetFrameAtIndex(0).GetFunctionName(), "stop_thread_func")
+        self.assertEqual(worker_thread.GetFrameAtIndex(0).GetLineEntry().GetLine(), self.worker_breakpoint)
+
+        # The main thread is still where it was.
+        self.assertEqual(stopped_thread.GetStopReason(), lldb.eStopReasonBreakpoint)
+        self.assertEqual(stopped_thread.GetFrameAtIndex(0).GetFunctionName(), "main")
+
+        # Both threads resume and the process exits.
+        self.runCmd("process continue")
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,60 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// The main thread stops at a breakpoint while the worker thread keeps
+// spinning. In non-stop mode only the main thread should be stopped.
+//
+// With the "stop-worker" argument the worker hits a breakpoint of its own
+// shortly after the main thread has stopped.
+
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+
+std::atomic_bool g_worker_started(false);
+std::atomic_bool g_main_stopping(false);
+std::atomic_bool g_done(false);
+unsigned g_value = 0x12345678;
+
+void *
+spin_thread_func (void *input)
+{
+    g_worker_started = true;
+    while (!g_done)
+        ;
+    return NULL;
+}
+
+void *
+stop_thread_func (void *input)
+{
+    g_worker_started = true;
+    while (!g_main_stopping)
+        ;
+    usleep (200000);
+    g_value = 0; // Set worker breakpoint here
+    return NULL;
+}
+
+int main (int argc, char const *argv[])
+{
+    const bool stop_worker = argc > 1 && strcmp (argv[1], "stop-worker") == 0;
+    pthread_t worker;
+    pthread_create (&worker, NULL, stop_worker ? stop_thread_func : spin_thread_func, NULL);
+
+    while (!g_worker_started)
+        ;
+
+    g_main_stopping = true;
+    g_done = true; // Set breakpoint here
+
+    pthread_join (worker, NULL);
+    return 0;
+}
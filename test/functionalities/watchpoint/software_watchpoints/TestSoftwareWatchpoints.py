@@ -0,0 +1,86 @@
+"""
+Test watchpoints that lldb-server watches by protecting pages once the
+debug registers run out.
+"""
+
+import os, time
+import unittest2
+import lldb, lldbutil
+from lldbtest import *
+
+class SoftwareWatchpointsTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    NUM_WATCHPOINTS = 6
+
+    @python_api_test
+    @dwarf_test
+    @skipUnlessPlatform(['linux'])
+    @skipTestIfFn(lambda self: self.getArchitecture() not in ['i386', 'x86_64'], skipReason="software watchpoints are only supported on x86")
+    def test_software_watchpoints_with_dwarf(self):
+        """Test that more watchpoints than debug registers all stop on their writes."""
+        self.buildDwarf()
+        self.software_watchpoints()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        self.line = line_number('main.c', '// Set break point at this line.')
+
+    def software_watchpoints(self):
+        """Test that more watchpoints than debug registers all stop on their writes."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, self.get_process_working_directory())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = lldbutil.get_one_thread_stopped_at_breakpoint(process, breakpoint)
+        self.assertTrue(thread, "There should be a thread stopped at the breakpoint")
+
+        watchpoint_ids = []
+        watched_values = []
+        for i in range(self.NUM_WATCHPOINTS):
+            value = target.FindFirstGlobalVariable("g_watched_%d" % i)
+            self.assertTrue(value.IsValid(), "Found g_watched_%d" % i)
+            error = lldb.SBError()
+            watchpoint = value.Watch(True, False, True, error)
+            self.assertTrue(error.Success() and watchpoint.IsValid(),
+                            "Watched g_watched_%d: %s" % (i, error.GetCString()))
+            watchpoint_ids.append(watchpoint.GetID())
+            watched_values.append(value)
+            self.assertEqual(value.GetValueAsSigned(), 0)
+
+        # The watchpoints that didn't get a debug register describe the
+        # pages they protect.
+        self.expect("watchpoint list -v",
+            substrs = ['software watchpoint on 1 page'])
+
+        # Each write stops once, on its own watchpoint, and none of the
+        # writes to the other variables on the page do. The protected page
+        # still counts as writable memory, so the new value is read rather
+        # than one cached before the write.
+        for watchpoint_id, value in zip(watchpoint_ids, watched_values):
+            process.Continue()
+            thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonWatchpoint)
+            self.assertTrue(thread, "There should be a thread stopped by a watchpoint")
+            self.assertEqual(thread.GetStopReasonDataAtIndex(0), watchpoint_id)
+            self.assertEqual(target.FindFirstGlobalVariable(value.GetName()).GetValueAsSigned(), 1)
+
+        process.Continue()
+        self.assertEqual(process.GetState(), lldb.eStateExited)
+
+        for watchpoint_id in watchpoint_ids:
+            self.assertEqual(target.FindWatchpointByID(watchpoint_id).GetHitCount(), 1)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
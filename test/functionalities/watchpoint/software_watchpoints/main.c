@@ -0,0 +1,36 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+// More watchpoints than x86 has debug registers, on the same page as
+// variables that aren't watched.
+int g_unwatched_before;
+int g_watched_0;
+int g_watched_1;
+int g_watched_2;
+int g_watched_3;
+int g_watched_4;
+int g_watched_5;
+int g_unwatched_after;
+
+int
+main (int argc, char const *argv[])
+{
+    printf ("Set watchpoints now.\n"); // Set break point at this line.
+    g_unwatched_before = 1;
+    g_watched_0 = 1;
+    g_unwatched_after = 1;
+    g_watched_1 = 1;
+    g_watched_2 = 1;
+    g_watched_3 = 1;
+    g_unwatched_before = g_unwatched_after + 1;
+    g_watched_4 = 1;
+    g_watched_5 = 1;
+    return 0;
+}
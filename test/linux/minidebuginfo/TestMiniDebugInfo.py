@@ -0,0 +1,102 @@
+"""
+Test that lldb reads the symbols of the MiniDebugInfo (.gnu_debugdata)
+section of a stripped ELF executable.
+"""
+
+import os, shutil
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class MiniDebugInfoTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    @skipUnlessPlatform(['linux'])
+    @skipUnlessLZMA
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that a stripped executable gets local symbols from .gnu_debugdata."""
+        self.buildDwarf()
+        self.mini_debug_info_symbols(os.path.join(os.getcwd(), "a.out.mini"))
+
+    @skipUnlessPlatform(['linux'])
+    @skipUnlessLZMA
+    @dwarf_test
+    def test_cache_with_dwarf(self):
+        """Test that modules with the same build-id share the decompressed .gnu_debugdata while one of them is alive."""
+        self.buildDwarf()
+        self.mini_debug_info_cache()
+
+    def mini_debug_info_cache(self):
+        exe = os.path.join(os.getcwd(), "a.out.mini")
+
+        # Copies of the executable have its build-id but are modules of
+        # their own.
+        copies = [exe + ".copy1", exe + ".copy2"]
+        for copy in copies:
+            shutil.copy(exe, copy)
+        def remove_copies():
+            for copy in copies:
+                os.remove(copy)
+        self.addTearDownHook(remove_copies)
+
+        log_file = os.path.join(os.getcwd(), "minidebuginfo-cache.log")
+        if os.path.exists(log_file):
+            os.remove(log_file)
+        self.runCmd("log enable -f '%s' lldb symbol" % log_file)
+
+        target = self.mini_debug_info_symbols(exe)
+        if not target.FindModule(target.GetExecutable()).GetUUIDString():
+            self.runCmd("log disable lldb symbol")
+            self.skipTest("toolchain didn't give the executable a build-id")
+        copy_target = self.mini_debug_info_symbols(copies[0])
+
+        # Once no module uses the decompressed section anymore it has to be
+        # decompressed again.
+        self.assertTrue(self.dbg.DeleteTarget(target))
+        self.assertTrue(self.dbg.DeleteTarget(copy_target))
+        target = None
+        copy_target = None
+        lldb.SBDebugger.MemoryPressureDetected()
+        self.mini_debug_info_symbols(copies[1])
+
+        self.runCmd("log disable lldb symbol")
+        with open(log_file, "r") as f:
+            log = f.read()
+        os.remove(log_file)
+
+        self.assertFalse("reusing decompressed .gnu_debugdata for %s\n" % exe in log)
+        self.assertTrue("reusing decompressed .gnu_debugdata for %s\n" % copies[0] in log,
+                        "the copy reused the decompressed .gnu_debugdata of the executable")
+        self.assertFalse("reusing decompressed .gnu_debugdata for %s\n" % copies[1] in log,
+                         "the decompressed .gnu_debugdata went away with its modules")
+
+    def mini_debug_info_symbols(self, exe):
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        module = target.FindModule(target.GetExecutable())
+        self.assertTrue(module.IsValid())
+
+        if not module.FindSection(".gnu_debugdata").IsValid():
+            self.skipTest("toolchain didn't produce a .gnu_debugdata section")
+
+        # 'multiplyByThree' is a static function so it is only present in
+        # the compressed .symtab of the MiniDebugInfo section.
+        symbols = module.FindSymbols("multiplyByThree")
+        self.assertTrue(symbols.GetSize() == 1, "found 'multiplyByThree' in .gnu_debugdata")
+
+        symbol = symbols.GetContextAtIndex(0).GetSymbol()
+        self.assertTrue(symbol.GetType() == lldb.eSymbolTypeCode)
+
+        breakpoint = target.BreakpointCreateByName("multiplyByThree")
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        return target
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
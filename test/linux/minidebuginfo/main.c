@@ -0,0 +1,20 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+static int __attribute__((noinline))
+multiplyByThree (int num)
+{
+    return num * 3;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    return multiplyByThree (argc); // Set break point at this line.
+}
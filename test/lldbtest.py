@@ -988,6 +988,28 @@ def skipUnlessCompilerRt(func):
             func(*args, **kwargs)
     return wrapper
 
+def lldbHasLZMA():
+    """Returns true if the LLDB library links against liblzma."""
+    lldb_lib = os.path.join(os.path.dirname(lldb.__file__), "_lldb.so")
+    if not os.path.exists(lldb_lib) or not which("readelf"):
+        return False
+    dynamic_section = Popen(["readelf", "-d", os.path.realpath(lldb_lib)], stdout=PIPE).communicate()[0]
+    return "liblzma" in dynamic_section
+
+def skipUnlessLZMA(func):
+    """Decorate the item to skip tests that need LLDB to be built with liblzma."""
+    if isinstance(func, type) and issubclass(func, unittest2.TestCase):
+        raise Exception("@skipUnlessLZMA can only be used to decorate a test method")
+    @wraps(func)
+    def wrapper(*args, **kwargs):
+        from unittest2 import case
+        if not lldbHasLZMA():
+            self = args[0]
+            self.skipTest("skip because LLDB was built without LZMA support")
+        else:
+            func(*args, **kwargs)
+    return wrapper
+
 class _PlatformContext(object):
     """Value object class which contains platform-specific options."""
 
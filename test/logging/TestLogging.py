@@ -12,6 +12,9 @@ class LogTestCase(TestBase):
     mydir = TestBase.compute_mydir(__file__)
     append_log_file = "lldb-commands-log-append.txt"
     truncate_log_file = "lldb-commands-log-truncate.txt"
+    async_log_file = "lldb-commands-log-async.bin"
+    flight_recorder_log_file = "lldb-commands-log-flight-recorder.bin"
+    timer_trace_file = "lldb-timer-trace.json"
 
 
     @classmethod
@@ -19,6 +22,9 @@ class LogTestCase(TestBase):
         """Cleanup the test byproducts."""
         cls.RemoveTempFile(cls.truncate_log_file)
         cls.RemoveTempFile(cls.append_log_file)
+        cls.RemoveTempFile(cls.async_log_file)
+        cls.RemoveTempFile(cls.flight_recorder_log_file)
+        cls.RemoveTempFile(cls.timer_trace_file)
 
     @skipUnlessDarwin
     @dsym_test
@@ -106,6 +112,73 @@ class LogTestCase(TestBase):
         # check that it is still there
         self.assertTrue(string.find(contents, "bacon") == 0)
 
+    # Check that asynchronous logs are written in the binary format and can
+    # be decoded
+    def test_log_async (self):
+        if (os.path.exists (self.async_log_file)):
+            os.remove (self.async_log_file)
+
+        self.runCmd ("log enable -A -f '%s' lldb commands" % (self.async_log_file))
+        self.runCmd ("help log")
+        self.runCmd ("log disable lldb")
+
+        self.assertTrue (os.path.isfile (self.async_log_file))
+        with open(self.async_log_file, "rb") as f:
+            contents = f.read ()
+        self.assertTrue(contents.startswith("LLDBBLOG"))
+
+        self.expect ("log decode '%s'" % (self.async_log_file),
+                     substrs = ["Processing command: help log"])
+
+    # Check that flight recorder logs are only written when dumped
+    def test_log_flight_recorder (self):
+        if (os.path.exists (self.flight_recorder_log_file)):
+            os.remove (self.flight_recorder_log_file)
+
+        self.runCmd ("log enable -F -f '%s' lldb commands" % (self.flight_recorder_log_file))
+        self.runCmd ("help log")
+        self.assertTrue (os.path.getsize (self.flight_recorder_log_file) == 0)
+
+        self.runCmd ("log dump")
+        self.runCmd ("log disable lldb")
+
+        self.expect ("log decode '%s'" % (self.flight_recorder_log_file),
+                     substrs = ["Processing command: help log"])
+
+    # Check that disabling a flight recorder log writes out what it holds
+    def test_log_flight_recorder_disable (self):
+        if (os.path.exists (self.flight_recorder_log_file)):
+            os.remove (self.flight_recorder_log_file)
+
+        self.runCmd ("log enable -F -f '%s' lldb commands" % (self.flight_recorder_log_file))
+        self.runCmd ("help log")
+        self.runCmd ("log disable lldb")
+
+        self.expect ("log decode '%s'" % (self.flight_recorder_log_file),
+                     substrs = ["Processing command: help log"])
+    # Check that timer traces are written as Chrome trace JSON
+    @dwarf_test
+    def test_timer_trace (self):
+        import json
+        self.buildDwarf ()
+        if (os.path.exists (self.timer_trace_file)):
+            os.remove (self.timer_trace_file)
+
+        self.runCmd ("log timers trace enable")
+        exe = os.path.join (os.getcwd(), "a.out")
+        self.runCmd ("file " + exe)
+        self.runCmd ("breakpoint set -n main")
+        self.runCmd ("log timers trace disable")
+        self.runCmd ("log timers trace dump '%s'" % (self.timer_trace_file))
+
+        with open(self.timer_trace_file, "r") as f:
+            trace = json.load (f)
+        events = trace["traceEvents"]
+        self.assertTrue (any(event["ph"] == "M" and event["name"] == "thread_name" for event in events))
+        begin_events = [event for event in events if event["ph"] == "B"]
+        end_events = [event for event in events if event["ph"] == "E"]
+        self.assertTrue (len(begin_events) > 0, "Timer scopes were traced.")
+        self.assertTrue (len(begin_events) == len(end_events), "Every traced timer scope was closed.")
 
 if __name__ == '__main__':
     import atexit
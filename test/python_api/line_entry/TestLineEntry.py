@@ -0,0 +1,64 @@
+"""
+Test resolving addresses to line entries, before and after the line table
+of the compile unit has been parsed as a whole.
+"""
+
+import os
+import unittest2
+import lldb
+from lldbtest import *
+
+class LineEntryTestCase(TestBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    FUNCTIONS = ["first", "second", "third", "main"]
+
+    @python_api_test
+    @dwarf_test
+    def test_with_dwarf(self):
+        """Test that addresses resolve to the same line entries with and without the full line table."""
+        self.buildDwarf()
+        self.line_entries()
+
+    def resolve_functions(self, target):
+        """Resolve the start address of each function to its line."""
+        lines = {}
+        for name in self.FUNCTIONS:
+            symbols = target.FindSymbols(name, lldb.eSymbolTypeCode)
+            self.assertEqual(symbols.GetSize(), 1, "found symbol '%s'" % name)
+            address = symbols.GetContextAtIndex(0).GetSymbol().GetStartAddress()
+            sc = target.ResolveSymbolContextForAddress(address, lldb.eSymbolContextLineEntry)
+            line_entry = sc.GetLineEntry()
+            self.assertTrue(line_entry.IsValid(), "'%s' has a line entry" % name)
+            self.assertEqual(line_entry.GetFileSpec().GetFilename(), "main.c")
+            lines[name] = line_entry.GetLine()
+        return lines
+
+    def line_entries(self):
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        expected = {}
+        for name in self.FUNCTIONS:
+            expected[name] = line_number('main.c', '// %s function' % name)
+
+        # Nothing needs the whole line table yet, so only the sequences
+        # that contain the addresses get decoded, and the second time
+        # around they have already been.
+        self.assertEqual(self.resolve_functions(target), expected)
+        self.assertEqual(self.resolve_functions(target), expected)
+
+        # A file and line breakpoint parses the whole line table.
+        breakpoint = target.BreakpointCreateByLocation("main.c", expected["second"] + 1)
+        self.assertTrue(breakpoint.GetNumLocations() == 1, VALID_BREAKPOINT)
+        self.assertEqual(self.resolve_functions(target), expected)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
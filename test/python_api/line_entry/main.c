@@ -0,0 +1,24 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int first (int i) { // first function
+    return i + 1;
+}
+
+int second (int i) { // second function
+    return i * 2;
+}
+
+int third (int i) { // third function
+    return i - 3;
+}
+
+int main (int argc, char const *argv[]) { // main function
+    return first (argc) + second (argc) + third (argc);
+}
@@ -1,5 +1,5 @@
 """
-Test SBProcess APIs, including ReadMemory(), WriteMemory(), and others.
+Test SBProcess APIs, including ReadMemory(), ReadMemoryRanges(), WriteMemory(), and others.
 """
 
 import os, time
@@ -27,6 +27,21 @@ class ProcessAPITestCase(TestBase):
         self.buildDwarf()
         self.read_memory()
 
+    @skipUnlessDarwin
+    @python_api_test
+    @dsym_test
+    def test_read_memory_ranges_with_dsym(self):
+        """Test Python SBProcess.ReadMemoryRanges() API."""
+        self.buildDsym()
+        self.read_memory_ranges()
+
+    @python_api_test
+    @dwarf_test
+    def test_read_memory_ranges_with_dwarf(self):
+        """Test Python SBProcess.ReadMemoryRanges() API."""
+        self.buildDwarf()
+        self.read_memory_ranges()
+
     @skipUnlessDarwin
     @python_api_test
     @dsym_test
@@ -156,6 +171,63 @@ class ProcessAPITestCase(TestBase):
         if my_uint32 != 12345:
             self.fail("Result from SBProcess.ReadUnsignedFromMemory() does not match our expected output")
 
+    def read_memory_ranges(self):
+        """Test Python SBProcess.ReadMemoryRanges() API."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.cpp", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        # Launch the process, and do not stop at the entry point.
+        process = target.LaunchSimple (None, None, self.get_process_working_directory())
+
+        thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread.IsValid(), "There should be a thread stopped due to breakpoint")
+        frame = thread.GetFrameAtIndex(0)
+
+        my_char_addr = frame.FindValue("my_char", lldb.eValueTypeVariableGlobal).AddressOf().GetValueAsUnsigned()
+        my_cstring_addr = frame.FindValue("my_cstring", lldb.eValueTypeVariableGlobal).AddressOf().GetValueAsUnsigned()
+        my_uint32_addr = frame.FindValue("my_uint32", lldb.eValueTypeVariableGlobal).AddressOf().GetValueAsUnsigned()
+        my_cstring = "lldb.SBProcess.ReadCStringFromMemory() works!"
+
+        # Read the globals and one range that can't be read all at once.
+        ranges = lldb.SBMemoryReadRangeList()
+        ranges.Append(my_char_addr, 1)
+        ranges.Append(my_cstring_addr, len(my_cstring) + 1)
+        ranges.Append(0, 4)
+        ranges.Append(my_uint32_addr, 4)
+        self.assertTrue(ranges.GetSize() == 4)
+
+        error = lldb.SBError()
+        num_read = process.ReadMemoryRanges(ranges, error)
+        if not error.Success():
+            self.fail("SBProcess.ReadMemoryRanges() failed")
+        if self.TraceOn():
+            stream = lldb.SBStream()
+            ranges.GetDescription(stream)
+            print "ranges read:", stream.GetData()
+
+        self.assertTrue(num_read == 3, "Three of the four ranges should have been read")
+
+        self.assertTrue(ranges.GetErrorAtIndex(0).Success())
+        data = ranges.GetDataAtIndex(0)
+        self.assertTrue(data.GetUnsignedInt8(error, 0) == ord('x'))
+
+        self.assertTrue(ranges.GetErrorAtIndex(1).Success())
+        data = ranges.GetDataAtIndex(1)
+        self.assertTrue(data.GetString(error, 0) == my_cstring)
+
+        # Nothing should be readable at address zero, and that shouldn't stop
+        # the ranges after it from being read.
+        self.assertTrue(ranges.GetErrorAtIndex(2).Fail())
+
+        self.assertTrue(ranges.GetErrorAtIndex(3).Success())
+        data = ranges.GetDataAtIndex(3)
+        self.assertTrue(data.GetUnsignedInt32(error, 0) == 12345)
+
     def write_memory(self):
         """Test Python SBProcess.WriteMemory() API."""
         exe = os.path.join(os.getcwd(), "a.out")
@@ -0,0 +1,133 @@
+import unittest2
+
+import gdbremote_testcase
+from lldbtest import *
+
+class TestGdbRemoteNonStop(gdbremote_testcase.GdbRemoteTestCaseBase):
+
+    mydir = TestBase.compute_mydir(__file__)
+
+    ENABLE_NON_STOP_ENTRIES = [
+        "read packet: $QNonStop:1#8d",
+        "send packet: $OK#00",
+    ]
+
+    def start_non_stop_inferior(self):
+        # The new thread segfaults right away while the main thread sleeps.
+        procs = self.prep_debug_monitor_and_inferior(inferior_args=["thread:segfault", "thread:new", "sleep:10"])
+        self.test_sequence.add_log_lines([
+            "read packet: $?#00",
+            {"direction":"send", "regex":r"^\$T[0-9a-fA-F]{2}thread:([0-9a-fA-F]+);", "capture":{1:"main_thread_id"} },
+            ], True)
+        self.test_sequence.add_log_lines(self.ENABLE_NON_STOP_ENTRIES, True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertIsNotNone(context.get("main_thread_id"))
+        return context.get("main_thread_id")
+
+    def run_until_thread_stops(self):
+        # Resume packets are acknowledged with OK, the stop comes in as a
+        # %Stop notification that is drained with vStopped.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $vCont;c#a8",
+            "send packet: $OK#00",
+            {"direction":"send", "regex":r"^%Stop:T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} },
+            "read packet: $vStopped#55",
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        return context
+
+    def non_stop_thread_stop_is_notified(self):
+        main_thread_id = self.start_non_stop_inferior()
+        context = self.run_until_thread_stops()
+
+        self.assertEquals(int(context.get("stop_signo"), 16), lldbutil.get_signal_number('SIGSEGV'))
+        self.assertNotEqual(int(context.get("stop_thread_id"), 16), int(main_thread_id, 16))
+
+    @llgs_test
+    @dwarf_test
+    def test_non_stop_thread_stop_is_notified_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.non_stop_thread_stop_is_notified()
+
+    def non_stop_query_reports_only_stopped_threads(self):
+        main_thread_id = self.start_non_stop_inferior()
+        stop_thread_id = self.run_until_thread_stops().get("stop_thread_id")
+
+        # The main thread is still running, so ? reports only the thread
+        # that segfaulted.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $?#00",
+            {"direction":"send", "regex":r"^\$T[0-9a-fA-F]{2}thread:([0-9a-fA-F]+);", "capture":{1:"query_thread_id"} },
+            "read packet: $vStopped#55",
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertEquals(int(context.get("query_thread_id"), 16), int(stop_thread_id, 16))
+
+    @llgs_test
+    @dwarf_test
+    def test_non_stop_query_reports_only_stopped_threads_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.non_stop_query_reports_only_stopped_threads()
+
+    def non_stop_vCont_t_stops_thread(self):
+        main_thread_id = self.start_non_stop_inferior()
+        self.run_until_thread_stops()
+
+        # Stop the running main thread.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines([
+            "read packet: $vCont?#49",
+            {"direction":"send", "regex":r"^\$vCont((;[cCsSt])+)#[0-9a-fA-F]{2}$", "capture":{1:"vCont_actions"} },
+            "read packet: $vCont;t:{}#00".format(main_thread_id),
+            "send packet: $OK#00",
+            {"direction":"send", "regex":r"^%Stop:T[0-9a-fA-F]{2}thread:([0-9a-fA-F]+);", "capture":{1:"stop_thread_id"} },
+            "read packet: $vStopped#55",
+            "send packet: $OK#00",
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertTrue(";t" in context.get("vCont_actions"))
+        self.assertEquals(int(context.get("stop_thread_id"), 16), int(main_thread_id, 16))
+
+    @llgs_test
+    @dwarf_test
+    def test_non_stop_vCont_t_stops_thread_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.non_stop_vCont_t_stops_thread()
+
+    def vCont_t_requires_non_stop(self):
+        procs = self.prep_debug_monitor_and_inferior()
+        self.test_sequence.add_log_lines([
+            "read packet: $vCont?#49",
+            {"direction":"send", "regex":r"^\$vCont((;[cCsSt])+)#[0-9a-fA-F]{2}$", "capture":{1:"vCont_actions"} },
+            "read packet: $vCont;t#b7",
+            {"direction":"send", "regex":r"^\$E([0-9a-fA-F]{2})#[0-9a-fA-F]{2}$"},
+            ], True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        self.assertFalse(";t" in context.get("vCont_actions"))
+
+    @llgs_test
+    @dwarf_test
+    def test_vCont_t_requires_non_stop_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.vCont_t_requires_non_stop()
+
+
+if __name__ == '__main__':
+    unittest2.main()
@@ -947,6 +947,65 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.m_packet_reads_memory()
 
+    def qReadMemoryRanges_reads_memory(self):
+        # This is the memory we will write into the inferior and then ensure we can read back in pieces.
+        MEMORY_CONTENTS = "Test contents 0123456789 ABCDEFGHIJKLMNOPQRSTUVWXYZ abcdefghijklmnopqrstuvwxyz"
+
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["set-message:%s" % MEMORY_CONTENTS, "get-data-address-hex:g_message", "sleep:5"])
+
+        # Run the process
+        self.test_sequence.add_log_lines(
+            [
+             # Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the message buffer within the inferior.
+             # Note we require launch-only testing so we can get inferior otuput.
+             { "type":"output_match", "regex":r"^data address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"message_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(03)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Grab the message address.
+        self.assertIsNotNone(context.get("message_address"))
+        message_address = int(context.get("message_address"), 16)
+
+        # Read the message in two pieces with an unreadable range in between.
+        first_size = 10
+        second_size = len(MEMORY_CONTENTS) - first_size
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $qReadMemoryRanges:{0:x},{1:x};0,4;{2:x},{3:x}#00".format(
+                message_address, first_size, message_address + first_size, second_size),
+             {"direction":"send", "regex":r"^\$([0-9a-fA-F]+):([0-9a-fA-F]+);(E[0-9a-fA-F]{2});([0-9a-fA-F]+):([0-9a-fA-F]+)#[0-9a-fA-F]{2}$",
+              "capture":{1:"first_count", 2:"first_contents", 3:"error", 4:"second_count", 5:"second_contents"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Ensure what we read from inferior memory is what we wrote.
+        self.assertEquals(int(context.get("first_count"), 16), first_size)
+        self.assertEquals(int(context.get("second_count"), 16), second_size)
+        read_contents = context.get("first_contents").decode("hex") + context.get("second_contents").decode("hex")
+        self.assertEquals(read_contents, MEMORY_CONTENTS)
+
+    @llgs_test
+    @dwarf_test
+    def test_qReadMemoryRanges_reads_memory_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.qReadMemoryRanges_reads_memory()
+
     def qMemoryRegionInfo_is_supported(self):
         # Start up the inferior.
         procs = self.prep_debug_monitor_and_inferior()
@@ -1164,6 +1223,78 @@ class LldbGdbServerTestCase(gdbremote_testcase.GdbRemoteTestCaseBase):
         self.set_inferior_startup_launch()
         self.qMemoryRegionInfo_reports_heap_address_as_readable_writeable()
 
+    def qMemoryRegionMap_reports_code_address_as_executable(self):
+        # Start up the inferior.
+        procs = self.prep_debug_monitor_and_inferior(
+            inferior_args=["get-code-address-hex:hello", "sleep:5"])
+
+        # Run the process
+        self.test_sequence.add_log_lines(
+            [
+             # Start running after initial stop.
+             "read packet: $c#63",
+             # Match output line that prints the memory address of the function within the inferior.
+             # Note we require launch-only testing so we can get inferior otuput.
+             { "type":"output_match", "regex":r"^code address: 0x([0-9a-fA-F]+)\r\n$", "capture":{ 1:"code_address"} },
+             # Now stop the inferior.
+             "read packet: {}".format(chr(03)),
+             # And wait for the stop notification.
+             {"direction":"send", "regex":r"^\$T([0-9a-fA-F]{2})thread:([0-9a-fA-F]+);", "capture":{1:"stop_signo", 2:"stop_thread_id"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+        # Grab the code address.
+        self.assertIsNotNone(context.get("code_address"))
+        code_address = int(context.get("code_address"), 16)
+
+        # Grab the whole memory map from the inferior.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $qMemoryRegionMap#00",
+             {"direction":"send", "regex":r"^\$generation:([0-9a-fA-F]+);((?:[0-9a-fA-F]+,[0-9a-fA-F]+,r?w?x?;)+)#[0-9a-fA-F]{2}$",
+              "capture":{1:"generation", 2:"regions"} }],
+            True)
+
+        # Run the packet stream.
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+        generation = int(context.get("generation"), 16)
+
+        # Ensure the regions are sorted and one of them is the readable, executable region holding the code address.
+        found_code_region = False
+        prev_end = 0
+        for entry in context.get("regions").split(";")[:-1]:
+            (start, size, permissions) = entry.split(",")
+            start = int(start, 16)
+            end = start + int(size, 16)
+            self.assertTrue(start >= prev_end)
+            prev_end = end
+            if start <= code_address < end:
+                self.assertTrue("r" in permissions)
+                self.assertTrue("x" in permissions)
+                found_code_region = True
+        self.assertTrue(found_code_region)
+
+        # Ask again with the generation we got, the map can't have changed while the inferior is stopped.
+        self.reset_test_sequence()
+        self.test_sequence.add_log_lines(
+            ["read packet: $qMemoryRegionMap:{0:x}#00".format(generation),
+             "send packet: $generation:{0:x};unchanged;#00".format(generation)],
+            True)
+        context = self.expect_gdbremote_sequence()
+        self.assertIsNotNone(context)
+
+    @llgs_test
+    @dwarf_test
+    def test_qMemoryRegionMap_reports_code_address_as_executable_llgs_dwarf(self):
+        self.init_llgs_test()
+        self.buildDwarf()
+        self.set_inferior_startup_launch()
+        self.qMemoryRegionMap_reports_code_address_as_executable()
+
     def software_breakpoint_set_and_remove_work(self):
         # Start up the inferior.
         procs = self.prep_debug_monitor_and_inferior(
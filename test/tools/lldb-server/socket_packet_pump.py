@@ -32,7 +32,9 @@ class SocketPacketPump(object):
     content into the two queues.
     """
 
-    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^\$([^\#]*)#[0-9a-fA-F]{2}')
+    # Matches both regular '$' packets and '%' asynchronous notifications
+    # (e.g. non-stop mode %Stop notifications).
+    _GDB_REMOTE_PACKET_REGEX = re.compile(r'^[\$%]([^\#]*)#[0-9a-fA-F]{2}')
 
     def __init__(self, pump_socket, logger=None):
         if not pump_socket:
@@ -121,14 +123,16 @@ class SocketPacketPump(object):
                 if packet_match:
                     # Our receive buffer matches a packet at the
                     # start of the receive buffer.
-                    new_output_content = _handle_output_packet_string(
-                        packet_match.group(1))
+                    new_output_content = None
+                    if packet_match.group(0)[0] == "$":
+                        new_output_content = _handle_output_packet_string(
+                            packet_match.group(1))
                     if new_output_content:
                         # This was an $O packet with new content.
                         self._accumulated_output += new_output_content
                         self._output_queue.put(self._accumulated_output)
                     else:
-                        # Any packet other than $O.
+                        # Any packet other than $O, including % notifications.
                         self._packet_queue.put(packet_match.group(0))
 
                     # Remove the parsed packet from the receive
@@ -1,11 +1,10 @@
-#include <CoreFoundation/CoreFoundation.h>
-
 #include "lldb-perf/lib/Timer.h"
 #include "lldb-perf/lib/Metric.h"
 #include "lldb-perf/lib/Measurement.h"
 #include "lldb-perf/lib/TestCase.h"
 #include "lldb-perf/lib/Xcode.h"
 
+#include <string.h>
 #include <unistd.h>
 #include <string>
 #include <getopt.h>
@@ -92,6 +91,9 @@ public:
         }
         results_dict.AddDouble ("total-time", "Total time spent stepping.", m_time_measurements.GetMetric().GetSum());
         results_dict.AddDouble ("stddev-time", "StdDev of time spent stepping.", m_time_measurements.GetMetric().GetStandardDeviation());
+        const double total_time = m_time_measurements.GetMetric().GetSum();
+        if (total_time > 0)
+            results_dict.AddDouble ("steps-per-second", "The number of steps that can be done in a second.", num_time_measurements / total_time);
 
         results.Write(m_out_path.c_str());
     }
@@ -10,16 +10,23 @@
 #include "MemoryGauge.h"
 #include "lldb/lldb-forward.h"
 #include <assert.h>
+#include <inttypes.h>
+#include <stdio.h>
 #include <cmath>
+#if defined(__APPLE__)
 #include <mach/mach.h>
 #include <mach/task.h>
 #include <mach/mach_traps.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
 
 using namespace lldb_perf;
 
-MemoryStats::MemoryStats (mach_vm_size_t virtual_size,
-                          mach_vm_size_t resident_size,
-                          mach_vm_size_t max_resident_size) :
+MemoryStats::MemoryStats (uint64_t virtual_size,
+                          uint64_t resident_size,
+                          uint64_t max_resident_size) :
     m_virtual_size (virtual_size),
     m_resident_size (resident_size),
     m_max_resident_size (max_resident_size)
@@ -93,6 +100,7 @@ Results::ResultSP
 MemoryStats::GetResult (const char *name, const char *description) const
 {
     std::unique_ptr<Results::Dictionary> dict_ap (new Results::Dictionary (name, NULL));
+    dict_ap->AddUnsigned("virtual", NULL, GetVirtualSize());
     dict_ap->AddUnsigned("resident", NULL, GetResidentSize());
     dict_ap->AddUnsigned("max_resident", NULL, GetMaxResidentSize());
     return Results::ResultSP(dict_ap.release());
@@ -101,6 +109,7 @@ MemoryStats::GetResult (const char *name, const char *description) const
 MemoryGauge::ValueType
 MemoryGauge::Now ()
 {
+#if defined(__APPLE__)
     task_t task = mach_task_self();
     mach_task_basic_info_data_t taskBasicInfo;
     mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
@@ -109,6 +118,31 @@ MemoryGauge::Now ()
         return MemoryStats(taskBasicInfo.virtual_size, taskBasicInfo.resident_size, taskBasicInfo.resident_size_max);
     }
     return 0;
+#else
+    // The first two fields of /proc/self/statm are the virtual and resident
+    // sizes in pages
+    uint64_t virtual_pages = 0;
+    uint64_t resident_pages = 0;
+    FILE *statm = ::fopen ("/proc/self/statm", "r");
+    if (statm)
+    {
+        if (::fscanf (statm, "%" SCNu64 " %" SCNu64, &virtual_pages, &resident_pages) != 2)
+        {
+            virtual_pages = 0;
+            resident_pages = 0;
+        }
+        ::fclose (statm);
+    }
+    const uint64_t page_size = ::sysconf (_SC_PAGESIZE);
+
+    // The kernel keeps track of the peak resident size for us, in kilobytes
+    uint64_t max_resident_size = 0;
+    struct rusage usage;
+    if (::getrusage (RUSAGE_SELF, &usage) == 0)
+        max_resident_size = (uint64_t)usage.ru_maxrss * 1024;
+
+    return MemoryStats (virtual_pages * page_size, resident_pages * page_size, max_resident_size);
+#endif
 }
 
 MemoryGauge::MemoryGauge () :
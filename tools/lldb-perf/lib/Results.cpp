@@ -9,6 +9,10 @@
 
 #include "Results.h"
 #include <assert.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
 
 #ifdef __APPLE__
 #include "CFCMutableArray.h"
@@ -19,6 +23,8 @@
 
 using namespace lldb_perf;
 
+#ifdef __APPLE__
+
 static void
 AddResultToArray (CFCMutableArray &array, Results::Result *result);
 
@@ -154,8 +160,249 @@ AddResultToDictionary (CFCMutableDictionary &parent_dict, const char *key, Resul
         break;
     }
 }
+#else // #ifdef __APPLE__
+
+static void
+Indent (FILE *out, int depth)
+{
+    for (int i = 0; i < depth; ++i)
+        fputc ('\t', out);
+}
+
+static void
+WriteXMLString (FILE *out, const char *str)
+{
+    if (str == NULL)
+        return;
+    for (const char *p = str; *p; ++p)
+    {
+        switch (*p)
+        {
+            case '<':   fputs ("&lt;", out);    break;
+            case '>':   fputs ("&gt;", out);    break;
+            case '&':   fputs ("&amp;", out);   break;
+            default:    fputc (*p, out);        break;
+        }
+    }
+}
+
+static void
+WritePlistValue (FILE *out, Results::Result *result, int depth);
+
+static void
+WritePlistDictionary (FILE *out, Results::Result *result, int depth)
+{
+    Indent (out, depth);
+    fputs ("<dict>\n", out);
+    result->GetAsDictionary()->ForEach([out, depth](const std::string &key, const Results::ResultSP &value_sp) -> bool
+                                       {
+                                           Indent (out, depth + 1);
+                                           fputs ("<key>", out);
+                                           WriteXMLString (out, key.c_str());
+                                           fputs ("</key>\n", out);
+                                           WritePlistValue (out, value_sp.get(), depth + 1);
+                                           return true;
+                                       });
+    if (result->GetDescription())
+    {
+        Indent (out, depth + 1);
+        fputs ("<key>description</key>\n", out);
+        Indent (out, depth + 1);
+        fputs ("<string>", out);
+        WriteXMLString (out, result->GetDescription());
+        fputs ("</string>\n", out);
+    }
+    Indent (out, depth);
+    fputs ("</dict>\n", out);
+}
+
+static void
+WritePlistValue (FILE *out, Results::Result *result, int depth)
+{
+    switch (result->GetType())
+    {
+    case Results::Result::Type::Invalid:
+        break;
+
+    case Results::Result::Type::Array:
+        Indent (out, depth);
+        fputs ("<array>\n", out);
+        result->GetAsArray()->ForEach([out, depth](const Results::ResultSP &value_sp) -> bool
+                                      {
+                                          WritePlistValue (out, value_sp.get(), depth + 1);
+                                          return true;
+                                      });
+        Indent (out, depth);
+        fputs ("</array>\n", out);
+        break;
+
+    case Results::Result::Type::Dictionary:
+        WritePlistDictionary (out, result, depth);
+        break;
+
+    case Results::Result::Type::Double:
+        Indent (out, depth);
+        fprintf (out, "<real>%.17g</real>\n", result->GetAsDouble()->GetValue());
+        break;
+
+    case Results::Result::Type::String:
+        Indent (out, depth);
+        fputs ("<string>", out);
+        WriteXMLString (out, result->GetAsString()->GetValue());
+        fputs ("</string>\n", out);
+        break;
+
+    case Results::Result::Type::Unsigned:
+        Indent (out, depth);
+        fprintf (out, "<integer>%" PRIu64 "</integer>\n", result->GetAsUnsigned()->GetValue());
+        break;
+
+    default:
+        assert (!"unhandled result");
+        break;
+    }
+}
+
+#endif // #ifdef __APPLE__
+
+static void
+WriteJSONString (FILE *out, const char *str)
+{
+    fputc ('"', out);
+    if (str)
+    {
+        for (const char *p = str; *p; ++p)
+        {
+            const unsigned char ch = *p;
+            switch (ch)
+            {
+                case '"':   fputs ("\\\"", out); break;
+                case '\\':  fputs ("\\\\", out); break;
+                case '\n':  fputs ("\\n", out);  break;
+                case '\r':  fputs ("\\r", out);  break;
+                case '\t':  fputs ("\\t", out);  break;
+                default:
+                    if (ch < 0x20)
+                        fprintf (out, "\\u%4.4x", ch);
+                    else
+                        fputc (ch, out);
+                    break;
+            }
+        }
+    }
+    fputc ('"', out);
+}
+
+static void
+WriteJSONValue (FILE *out, Results::Result *result, int depth)
+{
+    switch (result->GetType())
+    {
+    case Results::Result::Type::Invalid:
+        fputs ("null", out);
+        break;
+
+    case Results::Result::Type::Array:
+        {
+            bool first = true;
+            fputc ('[', out);
+            result->GetAsArray()->ForEach([out, depth, &first](const Results::ResultSP &value_sp) -> bool
+                                          {
+                                              fprintf (out, "%s\n%*s", first ? "" : ",", (depth + 1) * 2, "");
+                                              WriteJSONValue (out, value_sp.get(), depth + 1);
+                                              first = false;
+                                              return true;
+                                          });
+            if (!first)
+                fprintf (out, "\n%*s", depth * 2, "");
+            fputc (']', out);
+        }
+        break;
+
+    case Results::Result::Type::Dictionary:
+        {
+            bool first = true;
+            fputc ('{', out);
+            result->GetAsDictionary()->ForEach([out, depth, &first](const std::string &key, const Results::ResultSP &value_sp) -> bool
+                                               {
+                                                   fprintf (out, "%s\n%*s", first ? "" : ",", (depth + 1) * 2, "");
+                                                   WriteJSONString (out, key.c_str());
+                                                   fputs (": ", out);
+                                                   WriteJSONValue (out, value_sp.get(), depth + 1);
+                                                   first = false;
+                                                   return true;
+                                               });
+            if (result->GetDescription())
+            {
+                fprintf (out, "%s\n%*s\"description\": ", first ? "" : ",", (depth + 1) * 2, "");
+                WriteJSONString (out, result->GetDescription());
+                first = false;
+            }
+            if (!first)
+                fprintf (out, "\n%*s", depth * 2, "");
+            fputc ('}', out);
+        }
+        break;
+
+    case Results::Result::Type::Double:
+        {
+            const double d = result->GetAsDouble()->GetValue();
+            // JSON has no representation for NaN or infinity
+            if (isfinite (d))
+                fprintf (out, "%.17g", d);
+            else
+                fputs ("null", out);
+        }
+        break;
+
+    case Results::Result::Type::String:
+        WriteJSONString (out, result->GetAsString()->GetValue());
+        break;
+
+    case Results::Result::Type::Unsigned:
+        fprintf (out, "%" PRIu64, result->GetAsUnsigned()->GetValue());
+        break;
+
+    default:
+        assert (!"unhandled result");
+        break;
+    }
+}
+
+static FILE *
+OpenResultsFile (const char *out_path)
+{
+    if (out_path == NULL)
+        return stdout;
+    FILE *out = fopen (out_path, "w");
+    if (out == NULL)
+        fprintf (stderr, "error: couldn't open '%s' to write the results\n", out_path);
+    return out;
+}
+
+static void
+CloseResultsFile (FILE *out)
+{
+    if (out == stdout)
+        fflush (out);
+    else
+        fclose (out);
+}
+
 void
 Results::Write (const char *out_path)
+{
+    const char *json_extension = ".json";
+    const size_t json_extension_len = strlen (json_extension);
+    const size_t out_path_len = out_path ? strlen (out_path) : 0;
+    if (out_path_len > json_extension_len && strcmp (out_path + out_path_len - json_extension_len, json_extension) == 0)
+        WriteJSON (out_path);
+    else
+        WritePlist (out_path);
+}
+
+bool
+Results::WritePlist (const char *out_path)
 {
 #ifdef __APPLE__
     CFCMutableDictionary dict;
@@ -172,10 +419,33 @@ Results::Write (const char *out_path)
 
     CFURLRef file = CFURLCreateFromFileSystemRepresentation(NULL, (const UInt8*)out_path, strlen(out_path), FALSE);
     
-    CFURLWriteDataAndPropertiesToResource(file, xmlData, NULL, NULL);
+    return CFURLWriteDataAndPropertiesToResource(file, xmlData, NULL, NULL);
+#else
+    FILE *out = OpenResultsFile (out_path);
+    if (out == NULL)
+        return false;
+    fputs ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+           "<!DOCTYPE plist PUBLIC \"-//Apple//DTD PLIST 1.0//EN\" \"http://www.apple.com/DTDs/PropertyList-1.0.dtd\">\n"
+           "<plist version=\"1.0\">\n", out);
+    WritePlistDictionary (out, &m_results, 0);
+    fputs ("</plist>\n", out);
+    CloseResultsFile (out);
+    return true;
 #endif
 }
 
+bool
+Results::WriteJSON (const char *out_path)
+{
+    FILE *out = OpenResultsFile (out_path);
+    if (out == NULL)
+        return false;
+    WriteJSONValue (out, &m_results, 0);
+    fputc ('\n', out);
+    CloseResultsFile (out);
+    return true;
+}
+
 Results::ResultSP
 Results::Dictionary::AddUnsigned (const char *name, const char *description, uint64_t value)
 {
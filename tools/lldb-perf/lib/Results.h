@@ -11,7 +11,9 @@
 #define __PerfTestDriver_Results_h__
 
 #include "lldb/lldb-forward.h"
+#include <functional>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -301,8 +303,17 @@ public:
         return m_results;
     }
 
+    // Writes the results to "path", or to stdout if "path" is NULL. Paths
+    // that end in ".json" get JSON so results can be tracked by regression
+    // tools, anything else gets an XML property list.
     void
     Write (const char *path);
+
+    bool
+    WritePlist (const char *path);
+
+    bool
+    WriteJSON (const char *path);
     
 protected:
     Dictionary m_results;
@@ -9,17 +9,31 @@
 
 #include "Timer.h"
 #include <assert.h>
+#if defined(__APPLE__)
+#include <chrono>
+#else
+#include <time.h>
+#endif
 
 using namespace lldb_perf;
 
 TimeGauge::TimeType
 TimeGauge::Now ()
 {
-	return high_resolution_clock::now();
+#if defined(__APPLE__)
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+#else
+    struct timespec ts;
+    ::clock_gettime (CLOCK_MONOTONIC, &ts);
+    return (TimeType)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+#endif
 }
 
 TimeGauge::TimeGauge () :
-    m_start(),
+    m_start(0),
+    m_stop(0),
+    m_delta(0),
     m_state(TimeGauge::State::eNeverUsed)
 {
 }
@@ -37,20 +51,20 @@ TimeGauge::Stop ()
 	m_stop = Now();
 	assert(m_state == TimeGauge::State::eCounting && "cannot stop a non-started clock");
 	m_state = TimeGauge::State::eStopped;
-    m_delta = duration_cast<duration<double>>(m_stop-m_start).count();
+    m_delta = (double)(m_stop - m_start) / 1e9;
 	return m_delta;
 }
 
 double
 TimeGauge::GetStartValue () const
 {
-    return (double)m_start.time_since_epoch().count() * (double)system_clock::period::num / (double)system_clock::period::den;
+    return (double)m_start / 1e9;
 }
 
 double
 TimeGauge::GetStopValue () const
 {
-    return (double)m_stop.time_since_epoch().count() * (double)system_clock::period::num / (double)system_clock::period::den;
+    return (double)m_stop / 1e9;
 }
 
 double
@@ -12,9 +12,7 @@
 
 #include "Gauge.h"
 
-#include <chrono>
-
-using namespace std::chrono;
+#include <stdint.h>
 
 namespace lldb_perf
 {
@@ -51,7 +49,8 @@ private:
         eStopped
     };
     
-    typedef high_resolution_clock::time_point TimeType;
+    // Nanoseconds from a monotonic clock
+    typedef uint64_t TimeType;
     TimeType m_start;
     TimeType m_stop;
     double m_delta;
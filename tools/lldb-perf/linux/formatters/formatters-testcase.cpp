@@ -0,0 +1,47 @@
+//===-- formatters-testcase.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stdio.h>
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#define NUM_ITERATIONS 10
+
+int main (int argc, char const *argv[])
+{
+    std::vector<int> vector;
+    std::list<int> list;
+    std::map<int, std::string> map;
+    std::unordered_map<std::string, int> unordered_map;
+    std::set<std::string> set;
+    std::string string;
+
+    for (int iteration = 0; iteration < NUM_ITERATIONS; ++iteration)
+    {
+        // Grow the containers so each stop has something new to show
+        for (int i = 0; i < 100; ++i)
+        {
+            const int value = iteration * 100 + i;
+            char name[32];
+            snprintf (name, sizeof(name), "element %d", value);
+            vector.push_back (value);
+            list.push_back (value);
+            map[value] = name;
+            unordered_map[name] = value;
+            set.insert (name);
+            string.append (name);
+        }
+        printf ("%d elements\n", (int)vector.size()); // Set break point at this line.
+    }
+    return 0;
+}
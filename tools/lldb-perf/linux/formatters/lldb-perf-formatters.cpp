@@ -0,0 +1,181 @@
+//===-- lldb-perf-formatters.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+#include <getopt.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures showing STL containers with the data formatters, with
+// formatters-testcase.cpp as the inferior. The containers grow each time
+// the breakpoint is hit.
+class FormattersTest : public TestCase
+{
+public:
+    FormattersTest () :
+        TestCase(),
+        m_main_source ("formatters-testcase.cpp"),
+        m_exe_path (),
+        m_out_path ()
+    {
+        m_dump_std_vector_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,1,false);
+        }, "std-vector", "time to dump an std::vector");
+        m_dump_std_list_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,1,false);
+        }, "std-list", "time to dump an std::list");
+        m_dump_std_map_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,1,false);
+        }, "std-map", "time to dump an std::map");
+        m_dump_std_unordered_map_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,1,false);
+        }, "std-unordered-map", "time to dump an std::unordered_map");
+        m_dump_std_set_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,1,false);
+        }, "std-set", "time to dump an std::set");
+        m_dump_std_string_measurement = CreateTimeMeasurement([] (SBValue value) -> void {
+            lldb_perf::Xcode::FetchVariable (value,0,false);
+        }, "std-string", "time to dump an std::string");
+        m_frame_variable_measurement = CreateTimeMeasurement([this] () -> void {
+            lldb_perf::Xcode::RunCommand (m_debugger, "frame variable", false);
+        }, "frame-variable", "time to run 'frame variable' with all of the containers in scope");
+    }
+
+    virtual
+    ~FormattersTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+            return false;
+        }
+        m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+        m_target.BreakpointCreateBySourceRegex("Set break point at this line.", m_main_source);
+        return Launch ({ m_exe_path.c_str() });
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",      no_argument,            NULL, 'v' },
+            { "test-file",    required_argument,      NULL, 't' },
+            { "out-file",     required_argument,      NULL, 'o' },
+            { NULL,           0,                      NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose (true);
+                return true;
+            case 't':
+                if (SBFileSpec(optarg).Exists())
+                {
+                    m_exe_path = optarg;
+                    return true;
+                }
+                fprintf (stderr, "error: file specified in --test-file (-t) option doesn't exist: '%s'\n", optarg);
+                return false;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void
+    DoTest ()
+    {
+        SBFrame frame_zero(m_thread.GetFrameAtIndex(0));
+
+        m_dump_std_vector_measurement(frame_zero.FindVariable("vector", lldb::eDynamicCanRunTarget));
+        m_dump_std_list_measurement(frame_zero.FindVariable("list", lldb::eDynamicCanRunTarget));
+        m_dump_std_map_measurement(frame_zero.FindVariable("map", lldb::eDynamicCanRunTarget));
+        m_dump_std_unordered_map_measurement(frame_zero.FindVariable("unordered_map", lldb::eDynamicCanRunTarget));
+        m_dump_std_set_measurement(frame_zero.FindVariable("set", lldb::eDynamicCanRunTarget));
+        m_dump_std_string_measurement(frame_zero.FindVariable("string", lldb::eDynamicCanRunTarget));
+        m_frame_variable_measurement();
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        // Every stop is at the breakpoint until the process exits
+        DoTest ();
+        next_action.Continue();
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        m_dump_std_vector_measurement.WriteAverageAndStandardDeviation(results);
+        m_dump_std_list_measurement.WriteAverageAndStandardDeviation(results);
+        m_dump_std_map_measurement.WriteAverageAndStandardDeviation(results);
+        m_dump_std_unordered_map_measurement.WriteAverageAndStandardDeviation(results);
+        m_dump_std_set_measurement.WriteAverageAndStandardDeviation(results);
+        m_dump_std_string_measurement.WriteAverageAndStandardDeviation(results);
+        m_frame_variable_measurement.WriteAverageAndStandardDeviation(results);
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+private:
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_vector_measurement;
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_list_measurement;
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_map_measurement;
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_unordered_map_measurement;
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_set_measurement;
+    TimeMeasurement<std::function<void(SBValue)>> m_dump_std_string_measurement;
+    TimeMeasurement<std::function<void()>> m_frame_variable_measurement;
+    SBFileSpec m_main_source;
+    std::string m_exe_path;
+    std::string m_out_path;
+};
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 2)
+    {
+        puts(R"(
+NAME
+    lldb-perf-formatters -- a tool that measures LLDB performance showing STL containers.
+
+SYNOPSIS
+    lldb-perf-formatters --test-file=PATH [--out-file=PATH --verbose]
+
+DESCRIPTION
+    Launches the formatters test case program and times showing each of its
+    STL containers, and "frame variable", every time it stops.
+    Results are written as JSON if the output file ends in ".json" and as a
+    plist otherwise.
+)");
+        return 1;
+    }
+
+    FormattersTest test;
+    return TestCase::Run(test, argc, argv);
+}
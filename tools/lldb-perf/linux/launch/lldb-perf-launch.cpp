@@ -0,0 +1,207 @@
+//===-- lldb-perf-launch.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+#include <getopt.h>
+#include <string>
+
+using namespace lldb_perf;
+
+// Measures how long it takes to get a large C++ program, like clang or
+// lldb itself, to its first breakpoint: creating the target, setting a
+// breakpoint by name, launching, and hitting the breakpoint.
+class LaunchTest : public TestCase
+{
+public:
+    LaunchTest () :
+        TestCase(),
+        m_time_create_target ([this] () -> void
+                              {
+                                  m_memory_change_create_target.Start();
+                                  m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+                                  m_memory_change_create_target.Stop();
+                              }, "time-create-target", "The time it takes to create a target."),
+        m_time_set_bp_main ([this] () -> void
+                            {
+                                m_memory_change_break_main.Start();
+                                m_target.BreakpointCreateByName("main");
+                                m_memory_change_break_main.Stop();
+                            }, "time-set-break-main", "The time it takes to set a breakpoint at 'main' by name."),
+        m_time_first_bt ([this] () -> void
+                         {
+                             Xcode::RunCommand(m_debugger, "bt", false);
+                         }, "time-first-bt", "The time it takes to backtrace the thread that hit the first breakpoint."),
+        m_memory_change_create_target (),
+        m_memory_change_break_main (),
+        m_memory_total (),
+        m_time_launch_stop_main (),
+        m_time_total (),
+        m_exe_path (),
+        m_out_path (),
+        m_launch_info (NULL)
+    {
+    }
+
+    virtual
+    ~LaunchTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--executable=PATH' option is mandatory\n");
+            return false;
+        }
+        // Anything after the options is passed to the program, the target
+        // supplies the executable as argv[0]
+        std::vector<const char *> args;
+        for (int i = 0; i < argc; ++i)
+            args.push_back (argv[i]);
+        args.push_back (NULL);
+        m_launch_info.SetArguments (&args[0], false);
+        return true;
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",    no_argument,            NULL, 'v' },
+            { "executable", required_argument,      NULL, 'e' },
+            { "out-file",   required_argument,      NULL, 'o' },
+            { NULL,         0,                      NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose (true);
+                return true;
+            case 'e':
+                if (SBFileSpec(optarg).Exists())
+                {
+                    m_exe_path = optarg;
+                    return true;
+                }
+                fprintf (stderr, "error: file specified in --executable (-e) option doesn't exist: '%s'\n", optarg);
+                return false;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        switch (counter)
+        {
+            case 0:
+                m_memory_total.Start();
+                m_time_total.Start();
+                m_time_create_target();
+                m_time_set_bp_main();
+                m_time_launch_stop_main.Start();
+                Launch (m_launch_info);
+                next_action.None(); // Wait for the breakpoint at main
+                break;
+
+            case 1:
+                m_time_launch_stop_main.Stop();
+                m_time_total.Stop();
+                m_memory_total.Stop();
+                m_time_first_bt();
+                next_action.Kill();
+                break;
+
+            default:
+                next_action.Kill();
+                break;
+        }
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        m_time_create_target.WriteAverageValue(results);
+        m_time_set_bp_main.WriteAverageValue(results);
+        m_time_first_bt.WriteAverageValue(results);
+        results_dict.Add ("memory-change-create-target",
+                          "Memory increase that occurs due to creating the target.",
+                          m_memory_change_create_target.GetDeltaValue().GetResult(NULL, NULL));
+        results_dict.Add ("memory-change-break-main",
+                          "Memory increase that occurs due to setting a breakpoint at main by name.",
+                          m_memory_change_break_main.GetDeltaValue().GetResult(NULL, NULL));
+        results_dict.Add ("memory-total-break-main",
+                          "The total memory that lldb is using after stopping at main.",
+                          m_memory_total.GetStopValue().GetResult(NULL, NULL));
+        results_dict.AddDouble ("time-launch-stop-main",
+                                "The time it takes to launch the process and stop at main.",
+                                m_time_launch_stop_main.GetDeltaValue());
+        results_dict.AddDouble ("time-total",
+                                "The time it takes to create the target, set a breakpoint at main, launch and hit the breakpoint.",
+                                m_time_total.GetDeltaValue());
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+private:
+    TimeMeasurement<std::function<void()>> m_time_create_target;
+    TimeMeasurement<std::function<void()>> m_time_set_bp_main;
+    TimeMeasurement<std::function<void()>> m_time_first_bt;
+    MemoryGauge m_memory_change_create_target;
+    MemoryGauge m_memory_change_break_main;
+    MemoryGauge m_memory_total;
+    TimeGauge m_time_launch_stop_main;
+    TimeGauge m_time_total;
+    std::string m_exe_path;
+    std::string m_out_path;
+    SBLaunchInfo m_launch_info;
+};
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 2)
+    {
+        puts(R"(
+NAME
+    lldb-perf-launch -- a tool that measures how long LLDB takes to get a program to its first breakpoint.
+
+SYNOPSIS
+    lldb-perf-launch --executable=PATH [--out-file=PATH --verbose] [-- program arguments]
+
+DESCRIPTION
+    Creates a target for a large C++ program, sets a breakpoint at main,
+    launches the program and times each step until the breakpoint is hit.
+    Results are written as JSON if the output file ends in ".json" and as a
+    plist otherwise.
+)");
+        return 1;
+    }
+
+    LaunchTest test;
+    return TestCase::Run(test, argc, argv);
+}
@@ -0,0 +1,217 @@
+//===-- lldb-perf-stop-latency.cpp ------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/API/LLDB.h"
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Results.h"
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+using namespace lldb;
+using namespace lldb_perf;
+
+// Measures how long it takes to resume a process and get it stopped again
+// at a breakpoint as the number of threads grows. Every stop has to stop
+// all of the other threads of the process, so this shows how all-stop
+// coordination in lldb-server scales.
+//
+// This doesn't use TestCase::Loop() because that describes the top frame of
+// every thread on every stop, which would dwarf the stop itself with
+// thousands of threads. The debugger runs in synchronous mode instead, so
+// SBProcess::Continue() returns once the process has stopped again.
+
+static void
+usage ()
+{
+    puts(R"(
+NAME
+    lldb-perf-stop-latency -- a tool that measures how stopping a process
+    scales with its number of threads.
+
+SYNOPSIS
+    lldb-perf-stop-latency --test-file=PATH [--thread-counts=N,N,... --stops=N
+                           --spin --out-file=PATH --verbose]
+
+DESCRIPTION
+    Launches the stop latency test case program once for each thread count
+    (1,10,100,1000,4000 by default) and times continuing from one breakpoint
+    hit to the next, --stops times (10 by default). The threads block on a
+    condition variable, or busy-wait if --spin is given so that every one of
+    them has to be interrupted.
+    Results are written as JSON if the output file ends in ".json" and as a
+    plist otherwise.
+)");
+}
+
+static bool
+MeasureStopLatency (SBDebugger &debugger,
+                    const char *exe_path,
+                    uint32_t num_threads,
+                    uint32_t num_stops,
+                    bool spin,
+                    bool verbose,
+                    Metric<double> &metric)
+{
+    SBTarget target = debugger.CreateTarget (exe_path);
+    if (!target.IsValid())
+    {
+        fprintf (stderr, "error: couldn't create a target for '%s'\n", exe_path);
+        return false;
+    }
+    target.BreakpointCreateByName ("stop_here");
+
+    std::string num_threads_str (std::to_string (num_threads));
+    // One more stop than we measure: the first one is where we start from
+    std::string num_stops_str (std::to_string (num_stops + 1));
+    const char *args[] = { num_threads_str.c_str(), num_stops_str.c_str(), spin ? "spin" : NULL, NULL };
+
+    SBLaunchInfo launch_info (args);
+    SBError error;
+    SBProcess process = target.Launch (launch_info, error);
+    if (!process.IsValid() || error.Fail() || process.GetState() != eStateStopped)
+    {
+        fprintf (stderr, "error: couldn't launch '%s': %s\n", exe_path,
+                 error.GetCString() ? error.GetCString() : "the process didn't stop at 'stop_here'");
+        debugger.DeleteTarget (target);
+        return false;
+    }
+
+    bool success = true;
+    for (uint32_t i = 0; i < num_stops; ++i)
+    {
+        TimeGauge gauge;
+        gauge.Start();
+        error = process.Continue();
+        gauge.Stop();
+        if (error.Fail() || process.GetState() != eStateStopped)
+        {
+            fprintf (stderr, "error: the process didn't stop again with %u threads\n", num_threads);
+            success = false;
+            break;
+        }
+        metric.Append (gauge.GetDeltaValue());
+    }
+
+    if (verbose)
+        printf ("%u threads (%u in the process): %.6f seconds per stop\n",
+                num_threads, process.GetNumThreads(), metric.GetAverage());
+
+    process.Kill();
+    debugger.DeleteTarget (target);
+    return success;
+}
+
+int main(int argc, const char * argv[])
+{
+    static struct option g_long_options[] = {
+        { "verbose",       no_argument,            NULL, 'v' },
+        { "test-file",     required_argument,      NULL, 't' },
+        { "thread-counts", required_argument,      NULL, 'n' },
+        { "stops",         required_argument,      NULL, 's' },
+        { "spin",          no_argument,            NULL, 'p' },
+        { "out-file",      required_argument,      NULL, 'o' },
+        { NULL,            0,                      NULL,  0  }
+    };
+
+    std::string exe_path;
+    std::string out_path;
+    std::vector<uint32_t> thread_counts;
+    uint32_t num_stops = 10;
+    bool spin = false;
+    bool verbose = false;
+
+    int short_option;
+    while ((short_option = ::getopt_long_only (argc, const_cast<char **>(argv), "vt:n:s:po:", g_long_options, NULL)) != -1)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                verbose = true;
+                break;
+            case 't':
+                exe_path = optarg;
+                break;
+            case 'n':
+                for (const char *p = optarg; *p; )
+                {
+                    char *end = NULL;
+                    const unsigned long count = strtoul (p, &end, 0);
+                    if (end == p)
+                    {
+                        fprintf (stderr, "error: invalid thread count list: '%s'\n", optarg);
+                        return 1;
+                    }
+                    thread_counts.push_back (count);
+                    p = *end == ',' ? end + 1 : end;
+                }
+                break;
+            case 's':
+                num_stops = strtoul (optarg, NULL, 0);
+                break;
+            case 'p':
+                spin = true;
+                break;
+            case 'o':
+                out_path = optarg;
+                break;
+            default:
+                usage ();
+                return 1;
+        }
+    }
+
+    if (exe_path.empty() || num_stops == 0)
+    {
+        usage ();
+        return 1;
+    }
+    if (!SBFileSpec(exe_path.c_str()).Exists())
+    {
+        fprintf (stderr, "error: file specified in --test-file (-t) option doesn't exist: '%s'\n", exe_path.c_str());
+        return 1;
+    }
+    if (thread_counts.empty())
+        thread_counts = { 1, 10, 100, 1000, 4000 };
+
+    SBDebugger::Initialize();
+    SBDebugger debugger = SBDebugger::Create(false);
+    debugger.SetAsync (false);
+
+    Results results;
+    Results::Dictionary& results_dict = results.GetDictionary();
+    results_dict.AddUnsigned ("num-stops",
+                              "The number of stops that were timed for each thread count.",
+                              num_stops);
+    bool success = true;
+    for (uint32_t num_threads : thread_counts)
+    {
+        Metric<double> metric;
+        if (!MeasureStopLatency (debugger, exe_path.c_str(), num_threads, num_stops, spin, verbose, metric))
+        {
+            success = false;
+            break;
+        }
+
+        const std::string name ("time-stop-" + std::to_string (num_threads) + "-threads");
+        const std::string description ("The average time it takes to continue to the next breakpoint with " +
+                                       std::to_string (num_threads) + " other threads.");
+        auto dictionary = (Results::Dictionary*)results_dict.AddDouble (name.c_str(), description.c_str(), metric.GetAverage()).get();
+        if (dictionary)
+            dictionary->AddDouble ("stddev", NULL, metric.GetStandardDeviation());
+    }
+    results.Write (out_path.empty() ? NULL : out_path.c_str());
+
+    SBDebugger::Destroy (debugger);
+    SBDebugger::Terminate();
+    return success ? 0 : 1;
+}
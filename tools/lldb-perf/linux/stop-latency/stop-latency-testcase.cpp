@@ -0,0 +1,86 @@
+//===-- stop-latency-testcase.cpp -------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_ready_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_release_cond = PTHREAD_COND_INITIALIZER;
+static int g_num_ready = 0;
+static volatile bool g_release = false;
+static bool g_spin = false;
+
+static void *
+thread_func (void *arg)
+{
+    pthread_mutex_lock (&g_mutex);
+    ++g_num_ready;
+    pthread_cond_signal (&g_ready_cond);
+    if (g_spin)
+    {
+        // Keep running so every stop has to interrupt the thread
+        pthread_mutex_unlock (&g_mutex);
+        while (!g_release)
+            ;
+        return NULL;
+    }
+    while (!g_release)
+        pthread_cond_wait (&g_release_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+    return NULL;
+}
+
+void
+stop_here (int iteration)
+{
+    printf ("stop %d\n", iteration); // The debugger stops here
+}
+
+// Usage: stop-latency-testcase <num-threads> <num-stops> [spin]
+int main (int argc, char const *argv[])
+{
+    const int num_threads = argc > 1 ? atoi (argv[1]) : 1000;
+    const int num_stops = argc > 2 ? atoi (argv[2]) : 10;
+    g_spin = argc > 3 && strcmp (argv[3], "spin") == 0;
+
+    pthread_attr_t attr;
+    pthread_attr_init (&attr);
+    pthread_attr_setstacksize (&attr, 64 * 1024);
+
+    std::vector<pthread_t> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, &attr, thread_func, NULL) != 0)
+            break;
+        threads.push_back (thread);
+    }
+    pthread_attr_destroy (&attr);
+
+    pthread_mutex_lock (&g_mutex);
+    while (g_num_ready < (int)threads.size())
+        pthread_cond_wait (&g_ready_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+
+    for (int i = 0; i < num_stops; ++i)
+        stop_here (i);
+
+    pthread_mutex_lock (&g_mutex);
+    g_release = true;
+    pthread_cond_broadcast (&g_release_cond);
+    pthread_mutex_unlock (&g_mutex);
+
+    for (pthread_t thread : threads)
+        pthread_join (thread, NULL);
+    return 0;
+}
@@ -0,0 +1,202 @@
+//===-- lldb-perf-threads.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb-perf/lib/Timer.h"
+#include "lldb-perf/lib/Metric.h"
+#include "lldb-perf/lib/Measurement.h"
+#include "lldb-perf/lib/Results.h"
+#include "lldb-perf/lib/TestCase.h"
+#include "lldb-perf/lib/Xcode.h"
+#include <getopt.h>
+#include <stdlib.h>
+#include <string>
+
+using namespace lldb_perf;
+
+#define NUM_BT_ITERATIONS 5
+
+// Measures backtracing all threads of a process with many threads, and
+// resuming and stopping it, with threads-testcase.cpp as the inferior.
+class ThreadsTest : public TestCase
+{
+public:
+    ThreadsTest () :
+        TestCase(),
+        m_time_first_bt_all ([this] () -> void
+                             {
+                                 Xcode::RunCommand(m_debugger, "bt all", false);
+                             }, "time-first-bt-all", "The time it takes to backtrace all threads the first time after a stop."),
+        m_time_bt_all ([this] () -> void
+                       {
+                           Xcode::RunCommand(m_debugger, "bt all", false);
+                       }, "time-bt-all", "The time it takes to backtrace all threads again during the same stop."),
+        m_time_resume_stop (),
+        m_time_launch_stop (),
+        m_memory_total (),
+        m_num_threads ("1000"),
+        m_num_threads_stopped (0),
+        m_exe_path (),
+        m_out_path ()
+    {
+    }
+
+    virtual
+    ~ThreadsTest ()
+    {
+    }
+
+    virtual bool
+    Setup (int& argc, const char**& argv)
+    {
+        TestCase::Setup (argc, argv);
+        if (m_exe_path.empty())
+        {
+            fprintf (stderr, "error: the '--test-file=PATH' option is mandatory\n");
+            return false;
+        }
+        return true;
+    }
+
+    virtual struct option*
+    GetLongOptions ()
+    {
+        static struct option g_long_options[] = {
+            { "verbose",      no_argument,            NULL, 'v' },
+            { "test-file",    required_argument,      NULL, 't' },
+            { "num-threads",  required_argument,      NULL, 'n' },
+            { "out-file",     required_argument,      NULL, 'o' },
+            { NULL,           0,                      NULL,  0  }
+        };
+        return g_long_options;
+    }
+
+    virtual bool
+    ParseOption (int short_option, const char* optarg)
+    {
+        switch (short_option)
+        {
+            case 'v':
+                SetVerbose (true);
+                return true;
+            case 't':
+                if (SBFileSpec(optarg).Exists())
+                {
+                    m_exe_path = optarg;
+                    return true;
+                }
+                fprintf (stderr, "error: file specified in --test-file (-t) option doesn't exist: '%s'\n", optarg);
+                return false;
+            case 'n':
+                m_num_threads = optarg;
+                return true;
+            case 'o':
+                m_out_path = optarg;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    virtual void
+    TestStep (int counter, ActionWanted &next_action)
+    {
+        switch (counter)
+        {
+            case 0:
+                {
+                    m_memory_total.Start();
+                    m_target = m_debugger.CreateTarget(m_exe_path.c_str());
+                    m_target.BreakpointCreateByName("all_threads_ready");
+                    m_time_launch_stop.Start();
+                    Launch ({ m_num_threads.c_str() });
+                    next_action.None(); // Wait for all of the threads to be created
+                }
+                break;
+
+            case 1:
+                m_time_launch_stop.Stop();
+                m_time_first_bt_all();
+                for (int i = 0; i < NUM_BT_ITERATIONS; ++i)
+                    m_time_bt_all();
+                m_time_resume_stop.Start();
+                next_action.Continue();
+                break;
+
+            case 2:
+                m_time_resume_stop.Stop();
+                m_time_first_bt_all();
+                m_memory_total.Stop();
+                // The process is gone by the time WriteResults is called
+                m_num_threads_stopped = m_process.GetNumThreads();
+                next_action.Kill();
+                break;
+
+            default:
+                next_action.Kill();
+                break;
+        }
+    }
+
+    virtual void
+    WriteResults (Results &results)
+    {
+        Results::Dictionary& results_dict = results.GetDictionary();
+
+        results_dict.AddUnsigned ("num-threads",
+                                  "The number of threads in the process.",
+                                  m_num_threads_stopped);
+        m_time_first_bt_all.WriteAverageAndStandardDeviation(results);
+        m_time_bt_all.WriteAverageAndStandardDeviation(results);
+        results_dict.AddDouble ("time-launch-stop",
+                                "The time it takes to launch the process and stop once all threads are created.",
+                                m_time_launch_stop.GetDeltaValue());
+        results_dict.AddDouble ("time-resume-stop",
+                                "The time it takes to resume the process and stop at the next breakpoint with all threads alive.",
+                                m_time_resume_stop.GetDeltaValue());
+        results_dict.Add ("memory-total",
+                          "The total memory that lldb is using after backtracing all threads.",
+                          m_memory_total.GetStopValue().GetResult(NULL, NULL));
+        results.Write(m_out_path.empty() ? NULL : m_out_path.c_str());
+    }
+
+private:
+    TimeMeasurement<std::function<void()>> m_time_first_bt_all;
+    TimeMeasurement<std::function<void()>> m_time_bt_all;
+    TimeGauge m_time_resume_stop;
+    TimeGauge m_time_launch_stop;
+    MemoryGauge m_memory_total;
+    std::string m_num_threads;
+    uint32_t m_num_threads_stopped;
+    std::string m_exe_path;
+    std::string m_out_path;
+};
+
+int main(int argc, const char * argv[])
+{
+    if (argc < 2)
+    {
+        puts(R"(
+NAME
+    lldb-perf-threads -- a tool that measures LLDB performance with many threads.
+
+SYNOPSIS
+    lldb-perf-threads --test-file=PATH [--num-threads=N --out-file=PATH --verbose]
+
+DESCRIPTION
+    Launches the threads test case program, which starts N threads (1000 by
+    default), and times "bt all" and resuming and stopping the process.
+    Results are written as JSON if the output file ends in ".json" and as a
+    plist otherwise.
+)");
+        return 1;
+    }
+
+    ThreadsTest test;
+    return TestCase::Run(test, argc, argv);
+}
@@ -0,0 +1,86 @@
+//===-- threads-testcase.cpp ------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+static pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_ready_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t g_release_cond = PTHREAD_COND_INITIALIZER;
+static int g_num_ready = 0;
+static bool g_release = false;
+
+// A few frames on every thread so backtraces have some work to do
+static int
+wait_for_release (int depth)
+{
+    if (depth > 0)
+        return wait_for_release (depth - 1) + 1;
+
+    pthread_mutex_lock (&g_mutex);
+    ++g_num_ready;
+    pthread_cond_signal (&g_ready_cond);
+    while (!g_release)
+        pthread_cond_wait (&g_release_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+    return 0;
+}
+
+static void *
+thread_func (void *arg)
+{
+    wait_for_release ((int)(long)arg % 8);
+    return NULL;
+}
+
+void
+all_threads_ready (int num_threads)
+{
+    printf ("%d threads are waiting\n", num_threads); // The debugger stops here
+}
+
+int main (int argc, char const *argv[])
+{
+    const int num_threads = argc > 1 ? atoi (argv[1]) : 1000;
+
+    pthread_attr_t attr;
+    pthread_attr_init (&attr);
+    pthread_attr_setstacksize (&attr, 64 * 1024);
+
+    std::vector<pthread_t> threads;
+    for (int i = 0; i < num_threads; ++i)
+    {
+        pthread_t thread;
+        if (pthread_create (&thread, &attr, thread_func, (void *)(long)i) != 0)
+            break;
+        threads.push_back (thread);
+    }
+    pthread_attr_destroy (&attr);
+
+    pthread_mutex_lock (&g_mutex);
+    while (g_num_ready < (int)threads.size())
+        pthread_cond_wait (&g_ready_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+
+    // Stop twice so the cost of stopping with all of the threads alive can
+    // be measured as well
+    all_threads_ready ((int)threads.size());
+    all_threads_ready ((int)threads.size());
+
+    pthread_mutex_lock (&g_mutex);
+    g_release = true;
+    pthread_cond_broadcast (&g_release_cond);
+    pthread_mutex_unlock (&g_mutex);
+
+    for (pthread_t thread : threads)
+        pthread_join (thread, NULL);
+    return 0;
+}
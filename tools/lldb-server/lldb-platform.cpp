@@ -20,13 +20,20 @@
 #include <sys/wait.h>
 
 // C++ Includes
+#include <map>
+#include <memory>
 
 // Other libraries and framework includes
 #include "lldb/Core/Error.h"
 #include "lldb/Host/ConnectionFileDescriptor.h"
+#include "lldb/Host/File.h"
 #include "lldb/Host/HostGetOpt.h"
+#include "lldb/Host/HostThread.h"
+#include "lldb/Host/MainLoop.h"
 #include "lldb/Host/OptionParser.h"
+#include "lldb/Host/Pipe.h"
 #include "lldb/Host/Socket.h"
+#include "lldb/Host/ThreadLauncher.h"
 #include "LLDBServerUtilities.h"
 #include "Plugins/Process/gdb-remote/GDBRemoteCommunicationServerPlatform.h"
 #include "Plugins/Process/gdb-remote/ProcessGDBRemoteLog.h"
@@ -44,6 +51,7 @@ using namespace llvm;
 static int g_debug = 0;
 static int g_verbose = 0;
 static int g_server = 0;
+static int g_multi_session = 0;
 
 static struct option g_long_options[] =
 {
@@ -57,6 +65,7 @@ static struct option g_long_options[] =
     { "min-gdbserver-port", required_argument,  NULL,               'm' },
     { "max-gdbserver-port", required_argument,  NULL,               'M' },
     { "server",             no_argument,        &g_server,          1   },
+    { "multi-session",      no_argument,        &g_multi_session,   1   },
     { NULL,                 0,                  NULL,               0   }
 };
 
@@ -89,10 +98,338 @@ signal_handler(int signo)
 static void
 display_usage (const char *progname, const char *subcommand)
 {
-    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] --server --listen port\n", progname, subcommand);
+    fprintf(stderr, "Usage:\n  %s %s [--log-file log-file-name] [--log-channels log-channel-list] [--server [--multi-session]] --listen port\n", progname, subcommand);
     exit(0);
 }
 
+namespace
+{
+//----------------------------------------------------------------------
+// Serves all client connections from this process, each one with its
+// own GDBRemoteCommunicationServerPlatform session, by multiplexing them
+// on one main loop instead of forking a child process per connection.
+// The debugservers that the sessions launch are still separate
+// processes.
+//
+// Packets that wait for another process, like qPlatform_shell and
+// qLaunchGDBServer, are handled on a thread of their own so they don't
+// hold up the other sessions. The session isn't read from until that
+// thread has sent the reply, and the thread wakes up the main loop
+// through a pipe when it is done.
+//----------------------------------------------------------------------
+class PlatformSessionServer
+{
+public:
+    PlatformSessionServer (MainLoop &mainloop,
+                           const std::string &listen_host_port,
+                           GDBRemoteCommunicationServerPlatform::PortMap &&port_map,
+                           uint16_t port_offset) :
+        m_mainloop (mainloop),
+        m_listen_host_port (listen_host_port),
+        m_port_map_sp (new GDBRemoteCommunicationServerPlatform::PortMap (std::move (port_map))),
+        m_port_offset (port_offset),
+        m_listening_socket_sp (),
+        m_listen_handle_up (),
+        m_finished_pipe (),
+        m_finished_handle_up (),
+        m_sessions (),
+        m_next_session_id (0)
+    {
+    }
+
+    ~PlatformSessionServer ()
+    {
+        // The threads that handle blocking packets use their sessions.
+        for (auto &pair : m_sessions)
+        {
+            if (pair.second.blocking_thread.IsJoinable ())
+                pair.second.blocking_thread.Join (nullptr);
+        }
+    }
+
+    Error
+    Start (std::unique_ptr<Socket> &&listening_socket_up)
+    {
+        m_listening_socket_sp.reset (listening_socket_up.release ());
+
+        Error error = m_finished_pipe.CreateNew (false);
+        if (error.Fail ())
+            return error;
+        IOObjectSP finished_object_sp (new File (m_finished_pipe.GetReadFileDescriptor (), false));
+        m_finished_handle_up = m_mainloop.RegisterReadObject (finished_object_sp,
+                [this] (MainLoopBase &) { FinishBlockingPacket (); }, error);
+        if (error.Fail ())
+            return error;
+
+        m_listen_handle_up = m_mainloop.RegisterReadObject (m_listening_socket_sp,
+                [this] (MainLoopBase &) { AcceptConnection (); }, error);
+        return error;
+    }
+
+private:
+    //------------------------------------------------------------------
+    // A packet that is being handled on its own thread, and the results
+    // of handling it.
+    //------------------------------------------------------------------
+    struct BlockingPacket
+    {
+        BlockingPacket (PlatformSessionServer &server,
+                        uint32_t session_id,
+                        GDBRemoteCommunicationServerPlatform &platform,
+                        const StringExtractorGDBRemote &packet) :
+            server (server),
+            session_id (session_id),
+            platform (platform),
+            packet (packet),
+            result (GDBRemoteCommunication::PacketResult::Success),
+            error (),
+            interrupt (false),
+            quit (false)
+        {
+        }
+
+        PlatformSessionServer &server;
+        const uint32_t session_id;
+        GDBRemoteCommunicationServerPlatform &platform;
+        StringExtractorGDBRemote packet;
+        GDBRemoteCommunication::PacketResult result;
+        Error error;
+        bool interrupt;
+        bool quit;
+    };
+
+    struct Session
+    {
+        Session () :
+            platform_up (),
+            read_object_sp (),
+            read_handle_up (),
+            got_ack (false),
+            blocking_thread (),
+            blocking_packet_up ()
+        {
+        }
+
+        std::unique_ptr<GDBRemoteCommunicationServerPlatform> platform_up;
+        IOObjectSP read_object_sp;
+        MainLoopBase::ReadHandleUP read_handle_up;
+        bool got_ack; // True once the client's initial ack has arrived
+        HostThread blocking_thread;
+        std::unique_ptr<BlockingPacket> blocking_packet_up;
+    };
+
+
+    void
+    AcceptConnection ()
+    {
+        // Nothing is launched with the accepted sockets open, they would
+        // keep the connections of other sessions alive.
+        const bool children_inherit_accept_socket = false;
+        Socket *socket = nullptr;
+        Error error = m_listening_socket_sp->BlockingAccept (m_listen_host_port.c_str(), children_inherit_accept_socket, socket);
+        if (error.Fail ())
+        {
+            // Keep serving the sessions that we already have.
+            fprintf (stderr, "error: %s\n", error.AsCString ());
+            return;
+        }
+        printf ("Connection established.\n");
+
+        std::unique_ptr<GDBRemoteCommunicationServerPlatform> platform_up (new GDBRemoteCommunicationServerPlatform ());
+        if (m_port_offset > 0)
+            platform_up->SetPortOffset (m_port_offset);
+        platform_up->SetPortMap (m_port_map_sp);
+        platform_up->SetSessionScopedWorkingDirectory (true);
+
+        ConnectionFileDescriptor *connection = new ConnectionFileDescriptor (socket);
+        IOObjectSP read_object_sp = connection->GetReadObject ();
+        platform_up->SetConnection (connection);
+
+        // The initial ack from the client is read by HandlePackets() when
+        // it arrives, waiting for it here would block the other sessions.
+        const uint32_t session_id = m_next_session_id++;
+        Session &session = m_sessions[session_id];
+        session.platform_up = std::move (platform_up);
+        session.read_object_sp = read_object_sp;
+        error = RegisterSession (session_id);
+        if (error.Fail ())
+        {
+            fprintf (stderr, "error: %s\n", error.AsCString ());
+            m_sessions.erase (session_id);
+            return;
+        }
+
+        // The client may have sent its ack already.
+        HandlePackets (session_id);
+    }
+
+    Error
+    RegisterSession (uint32_t session_id)
+    {
+        Error error;
+        Session &session = m_sessions[session_id];
+        session.read_handle_up = m_mainloop.RegisterReadObject (session.read_object_sp,
+                [this, session_id] (MainLoopBase &) { HandlePackets (session_id); }, error);
+        return error;
+    }
+
+    void
+    HandlePackets (uint32_t session_id)
+    {
+        auto pos = m_sessions.find (session_id);
+        if (pos == m_sessions.end ())
+            return;
+
+        // Handle every packet that has arrived without waiting for more,
+        // other sessions may have packets waiting too.
+        Session &session = pos->second;
+        GDBRemoteCommunicationServerPlatform &platform = *session.platform_up;
+        if (!session.got_ack)
+        {
+            const GDBRemoteCommunication::PacketResult result = platform.GetAck (0);
+            if (result == GDBRemoteCommunication::PacketResult::ErrorReplyTimeout && platform.IsConnected ())
+                return;
+            if (result != GDBRemoteCommunication::PacketResult::Success)
+            {
+                fprintf (stderr, "error: handshake with client failed\n");
+                m_sessions.erase (pos);
+                return;
+            }
+            session.got_ack = true;
+        }
+
+        bool interrupt = false;
+        bool done = false;
+        Error error;
+        while (true)
+        {
+            StringExtractorGDBRemote packet;
+            GDBRemoteCommunication::PacketResult result = platform.GetPacket (0, packet, error, done);
+            if (result == GDBRemoteCommunication::PacketResult::ErrorReplyTimeout && !done)
+                return;
+
+            if (result == GDBRemoteCommunication::PacketResult::Success && !done)
+            {
+                if (GDBRemoteCommunicationServerPlatform::IsBlockingPacket (packet.GetServerPacketType ()) &&
+                    StartBlockingPacket (session_id, packet))
+                    return;
+                result = platform.HandlePacket (packet, error, interrupt, done);
+            }
+
+            if (result != GDBRemoteCommunication::PacketResult::Success || interrupt || done)
+            {
+                if (error.Fail ())
+                    fprintf (stderr, "error: %s\n", error.AsCString ());
+
+                // This closes the connection and unregisters it from the
+                // main loop, which is fine to do from its own callback.
+                m_sessions.erase (pos);
+                return;
+            }
+        }
+    }
+
+    //------------------------------------------------------------------
+    // Handle \a packet on a thread of its own. Returns false if the
+    // thread couldn't be launched, the caller handles the packet then.
+    //------------------------------------------------------------------
+    bool
+    StartBlockingPacket (uint32_t session_id, const StringExtractorGDBRemote &packet)
+    {
+        Session &session = m_sessions[session_id];
+        session.blocking_packet_up.reset (new BlockingPacket (*this, session_id, *session.platform_up, packet));
+
+        Error error;
+        session.blocking_thread = ThreadLauncher::LaunchThread ("lldb.platform.blocking-packet",
+                                                                BlockingPacketThread,
+                                                                session.blocking_packet_up.get (),
+                                                                &error);
+        if (error.Fail () || !session.blocking_thread.IsJoinable ())
+        {
+            session.blocking_packet_up.reset ();
+            return false;
+        }
+
+        // The client doesn't send another packet before the reply, but it
+        // may close the connection, which must not destroy the session
+        // while the thread uses it.
+        session.read_handle_up.reset ();
+        return true;
+    }
+
+    static lldb::thread_result_t
+    BlockingPacketThread (lldb::thread_arg_t arg)
+    {
+        BlockingPacket *blocking_packet = static_cast<BlockingPacket *> (arg);
+        blocking_packet->result = blocking_packet->platform.HandlePacket (blocking_packet->packet,
+                                                                          blocking_packet->error,
+                                                                          blocking_packet->interrupt,
+                                                                          blocking_packet->quit);
+
+        // Writes of this size to a pipe are atomic, so the ids of threads
+        // that finish at the same time don't get mixed up.
+        size_t bytes_written = 0;
+        blocking_packet->server.m_finished_pipe.Write (&blocking_packet->session_id,
+                                                       sizeof (blocking_packet->session_id),
+                                                       bytes_written);
+        return nullptr;
+    }
+
+    void
+    FinishBlockingPacket ()
+    {
+        // Called once for every id in the pipe.
+        uint32_t session_id = 0;
+        size_t bytes_read = 0;
+        Error error = m_finished_pipe.Read (&session_id, sizeof (session_id), bytes_read);
+        if (error.Fail () || bytes_read != sizeof (session_id))
+            return;
+
+        auto pos = m_sessions.find (session_id);
+        if (pos == m_sessions.end ())
+            return;
+
+        Session &session = pos->second;
+        session.blocking_thread.Join (nullptr);
+        session.blocking_thread.Reset ();
+        std::unique_ptr<BlockingPacket> blocking_packet_up (std::move (session.blocking_packet_up));
+
+        if (blocking_packet_up->result != GDBRemoteCommunication::PacketResult::Success ||
+            blocking_packet_up->interrupt || blocking_packet_up->quit)
+        {
+            if (blocking_packet_up->error.Fail ())
+                fprintf (stderr, "error: %s\n", blocking_packet_up->error.AsCString ());
+            m_sessions.erase (pos);
+            return;
+        }
+
+        error = RegisterSession (session_id);
+        if (error.Fail ())
+        {
+            fprintf (stderr, "error: %s\n", error.AsCString ());
+            m_sessions.erase (pos);
+            return;
+        }
+
+        // Packets that arrived in the meantime may be buffered already.
+        HandlePackets (session_id);
+    }
+
+    MainLoop &m_mainloop;
+    std::string m_listen_host_port;
+    GDBRemoteCommunicationServerPlatform::PortMapSP m_port_map_sp;
+    uint16_t m_port_offset;
+    std::shared_ptr<Socket> m_listening_socket_sp;
+    MainLoopBase::ReadHandleUP m_listen_handle_up;
+    Pipe m_finished_pipe; // Ids of the sessions whose blocking packet was handled
+    MainLoopBase::ReadHandleUP m_finished_handle_up;
+    std::map<uint32_t, Session> m_sessions;
+    uint32_t m_next_session_id;
+
+    DISALLOW_COPY_AND_ASSIGN (PlatformSessionServer);
+};
+} // anonymous namespace
+
 //----------------------------------------------------------------------
 // main
 //----------------------------------------------------------------------
@@ -256,6 +593,24 @@ main_platform (int argc, char *argv[])
     listening_socket_up.reset(socket);
     printf ("Listening for a connection from %u...\n", listening_socket_up->GetLocalPortNumber());
 
+    if (g_multi_session)
+    {
+        // Serve every connection from this process instead of forking.
+        MainLoop mainloop;
+        PlatformSessionServer session_server (mainloop, listen_host_port, std::move (gdbserver_portmap), port_offset);
+        error = session_server.Start (std::move (listening_socket_up));
+        if (error.Success ())
+            error = mainloop.Run ();
+        if (error.Fail ())
+        {
+            fprintf (stderr, "error: %s\n", error.AsCString ());
+            exit (socket_error);
+        }
+
+        fprintf (stderr, "lldb-server exiting...\n");
+        return 0;
+    }
+
     do {
         GDBRemoteCommunicationServerPlatform platform;
         
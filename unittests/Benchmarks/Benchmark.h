@@ -0,0 +1,123 @@
+//===-- Benchmark.h ---------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef lldb_unittests_Benchmark_h_
+#define lldb_unittests_Benchmark_h_
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace lldb_benchmark
+{
+
+//----------------------------------------------------------------------
+// A benchmark measures one primitive. Its setup code runs once, outside
+// of the timed region, and then the body is run for a number of
+// repetitions. The body returns how many operations it performed so
+// that results can be compared as nanoseconds per operation no matter
+// how much work a single repetition does.
+//
+// All inputs must come from a fixed corpus or from the seeded Random
+// generator below so that every run measures exactly the same work.
+//----------------------------------------------------------------------
+class Benchmark
+{
+public:
+    typedef std::function<uint64_t ()> Body;
+    typedef std::function<Body ()> Setup;
+
+    Benchmark (const char *name, const Setup &setup);
+
+    static std::vector<Benchmark *> &
+    GetBenchmarks ();
+
+    const std::string &
+    GetName () const
+    {
+        return m_name;
+    }
+
+    Body
+    MakeBody () const
+    {
+        return m_setup();
+    }
+
+private:
+    std::string m_name;
+    Setup m_setup;
+};
+
+//----------------------------------------------------------------------
+// A small deterministic pseudo random number generator. std::rand and
+// the <random> distributions aren't guaranteed to produce the same
+// sequence everywhere, which would make results from different hosts
+// incomparable.
+//----------------------------------------------------------------------
+class Random
+{
+public:
+    Random (uint64_t seed = 0x2545f4914f6cdd1dULL) :
+        m_state (seed)
+    {
+    }
+
+    uint64_t
+    Next ()
+    {
+        // xorshift64*
+        m_state ^= m_state >> 12;
+        m_state ^= m_state << 25;
+        m_state ^= m_state >> 27;
+        return m_state * 0x2545f4914f6cdd1dULL;
+    }
+
+    uint64_t
+    NextBelow (uint64_t limit)
+    {
+        return Next() % limit;
+    }
+
+private:
+    uint64_t m_state;
+};
+
+//----------------------------------------------------------------------
+// Feed results into this so that the compiler can't discard the work
+// that is being measured.
+//----------------------------------------------------------------------
+void
+Consume (uint64_t value);
+
+void
+Consume (const void *value);
+
+} // namespace lldb_benchmark
+
+#define LLDB_BENCHMARK_CONCAT2(a, b) a##b
+#define LLDB_BENCHMARK_CONCAT(a, b) LLDB_BENCHMARK_CONCAT2(a, b)
+
+//----------------------------------------------------------------------
+// Register a benchmark:
+//
+// LLDB_BENCHMARK("DataExtractor.GetU32", []() {
+//     ... set up the input ...
+//     return lldb_benchmark::Benchmark::Body([=]() -> uint64_t {
+//         ... do the work ...
+//         return num_operations;
+//     });
+// });
+//----------------------------------------------------------------------
+#define LLDB_BENCHMARK(name, ...) \
+    static lldb_benchmark::Benchmark LLDB_BENCHMARK_CONCAT(g_benchmark_, __LINE__) (name, __VA_ARGS__)
+
+#endif // lldb_unittests_Benchmark_h_
@@ -0,0 +1,262 @@
+//===-- BenchmarkMain.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Runs the lldb microbenchmarks:
+//
+//   lldb-benchmarks [--filter <substring>] [--repetitions <n>] [--list]
+//                   [--json <results.json>]
+//                   [--baseline <results.json> [--max-regression <percent>]]
+//
+// Every benchmark runs on a fixed corpus so results from the same host
+// can be compared directly. Save the results of a known good build with
+// --json and pass them to --baseline when testing a new build: the exit
+// status is non-zero if any benchmark got slower by more than
+// --max-regression percent (10% by default).
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+
+#include "Benchmark.h"
+
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/StructuredData.h"
+#include "lldb/Core/Timer.h"
+
+using namespace lldb_benchmark;
+using namespace lldb_private;
+
+namespace lldb_benchmark
+{
+    static volatile uint64_t g_sink;
+
+    void
+    Consume (uint64_t value)
+    {
+        g_sink += value;
+    }
+
+    void
+    Consume (const void *value)
+    {
+        g_sink += (uintptr_t)value;
+    }
+}
+
+Benchmark::Benchmark (const char *name, const Setup &setup) :
+    m_name (name),
+    m_setup (setup)
+{
+    GetBenchmarks().push_back (this);
+}
+
+std::vector<Benchmark *> &
+Benchmark::GetBenchmarks ()
+{
+    static std::vector<Benchmark *> g_benchmarks;
+    return g_benchmarks;
+}
+
+namespace
+{
+    struct Result
+    {
+        std::string name;
+        uint64_t operations;
+        double min_ns_per_op;
+        double median_ns_per_op;
+    };
+
+    Result
+    RunBenchmark (const Benchmark &benchmark, uint32_t repetitions)
+    {
+        typedef std::chrono::steady_clock Clock;
+
+        Benchmark::Body body = benchmark.MakeBody();
+
+        // Warm up caches and any lazily created state before timing.
+        uint64_t operations = body();
+
+        std::vector<double> ns_per_op;
+        for (uint32_t i = 0; i < repetitions; ++i)
+        {
+            Clock::time_point start = Clock::now();
+            operations = body();
+            Clock::time_point end = Clock::now();
+            const double ns = std::chrono::duration<double, std::nano>(end - start).count();
+            ns_per_op.push_back (ns / (operations ? operations : 1));
+        }
+        std::sort (ns_per_op.begin(), ns_per_op.end());
+
+        Result result;
+        result.name = benchmark.GetName();
+        result.operations = operations;
+        result.min_ns_per_op = ns_per_op.front();
+        result.median_ns_per_op = ns_per_op[ns_per_op.size() / 2];
+        return result;
+    }
+
+    StructuredData::ObjectSP
+    ReadResults (const char *path)
+    {
+        std::ifstream file (path);
+        if (!file)
+            return StructuredData::ObjectSP();
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return StructuredData::ParseJSON (contents.str());
+    }
+
+    bool
+    GetBaselineValue (StructuredData::Dictionary *baseline, const std::string &name, double &value)
+    {
+        if (baseline == nullptr)
+            return false;
+        StructuredData::ObjectSP entry_sp = baseline->GetValueForKey (name);
+        StructuredData::Dictionary *entry = entry_sp ? entry_sp->GetAsDictionary() : nullptr;
+        if (entry == nullptr)
+            return false;
+        StructuredData::ObjectSP value_sp = entry->GetValueForKey ("min_ns_per_op");
+        if (!value_sp)
+            return false;
+        if (StructuredData::Float *float_value = value_sp->GetAsFloat())
+            value = float_value->GetValue();
+        else if (StructuredData::Integer *int_value = value_sp->GetAsInteger())
+            value = int_value->GetValue();
+        else
+            return false;
+        return true;
+    }
+
+    void
+    Usage (const char *progname)
+    {
+        fprintf (stderr,
+                 "usage: %s [--filter <substring>] [--repetitions <n>] [--list]\n"
+                 "       [--json <results.json>] [--baseline <results.json> [--max-regression <percent>]]\n",
+                 progname);
+    }
+}
+
+int
+main (int argc, const char *argv[])
+{
+    const char *filter = nullptr;
+    const char *json_path = nullptr;
+    const char *baseline_path = nullptr;
+    uint32_t repetitions = 10;
+    double max_regression = 10.0;
+    bool list_only = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const bool has_value = i + 1 < argc;
+        if (strcmp (arg, "--list") == 0)
+            list_only = true;
+        else if (strcmp (arg, "--filter") == 0 && has_value)
+            filter = argv[++i];
+        else if (strcmp (arg, "--repetitions") == 0 && has_value)
+            repetitions = std::max (1, atoi (argv[++i]));
+        else if (strcmp (arg, "--json") == 0 && has_value)
+            json_path = argv[++i];
+        else if (strcmp (arg, "--baseline") == 0 && has_value)
+            baseline_path = argv[++i];
+        else if (strcmp (arg, "--max-regression") == 0 && has_value)
+            max_regression = atof (argv[++i]);
+        else
+        {
+            Usage (argv[0]);
+            return 2;
+        }
+    }
+
+    Timer::Initialize();
+
+    StructuredData::ObjectSP baseline_sp;
+    StructuredData::Dictionary *baseline = nullptr;
+    if (baseline_path)
+    {
+        baseline_sp = ReadResults (baseline_path);
+        baseline = baseline_sp ? baseline_sp->GetAsDictionary() : nullptr;
+        if (baseline == nullptr)
+        {
+            fprintf (stderr, "error: couldn't read benchmark results from '%s'\n", baseline_path);
+            return 2;
+        }
+    }
+
+    StructuredData::Dictionary results;
+    uint32_t num_regressions = 0;
+
+    for (const Benchmark *benchmark : Benchmark::GetBenchmarks())
+    {
+        if (filter && benchmark->GetName().find (filter) == std::string::npos)
+            continue;
+        if (list_only)
+        {
+            printf ("%s\n", benchmark->GetName().c_str());
+            continue;
+        }
+
+        const Result result = RunBenchmark (*benchmark, repetitions);
+        printf ("%-48s %12.2f ns/op (median %.2f, %" PRIu64 " ops)",
+                result.name.c_str(),
+                result.min_ns_per_op,
+                result.median_ns_per_op,
+                result.operations);
+
+        double baseline_ns_per_op = 0;
+        if (GetBaselineValue (baseline, result.name, baseline_ns_per_op) && baseline_ns_per_op > 0)
+        {
+            const double change = (result.min_ns_per_op - baseline_ns_per_op) * 100.0 / baseline_ns_per_op;
+            printf (" %+.1f%%", change);
+            if (change > max_regression)
+            {
+                printf (" REGRESSION");
+                ++num_regressions;
+            }
+        }
+        printf ("\n");
+        fflush (stdout);
+
+        StructuredData::Dictionary *entry = new StructuredData::Dictionary();
+        entry->AddFloatItem ("min_ns_per_op", result.min_ns_per_op);
+        entry->AddFloatItem ("median_ns_per_op", result.median_ns_per_op);
+        entry->AddIntegerItem ("operations", result.operations);
+        results.AddItem (result.name, StructuredData::ObjectSP (entry));
+    }
+
+    if (json_path)
+    {
+        StreamString strm;
+        results.Dump (strm);
+        FILE *file = fopen (json_path, "w");
+        if (file == nullptr)
+        {
+            fprintf (stderr, "error: couldn't open '%s' for writing\n", json_path);
+            return 2;
+        }
+        fprintf (file, "%s\n", strm.GetData());
+        fclose (file);
+    }
+
+    if (num_regressions > 0)
+    {
+        fprintf (stderr, "%u benchmark(s) regressed by more than %.1f%%\n", num_regressions, max_regression);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,402 @@
+//===-- CoreBenchmarks.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#if defined(_MSC_VER) && (_HAS_EXCEPTIONS == 0)
+// Workaround for MSVC standard library bug, which fails to include <thread> when
+// exceptions are disabled.
+#include <eh.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/CxaDemangle.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/FastDemangle.h"
+#include "lldb/Core/Mangled.h"
+#include "lldb/Core/RangeMap.h"
+#include "lldb/Core/UniqueCStringMap.h"
+#include "lldb/Host/Endian.h"
+
+using namespace lldb_benchmark;
+using namespace lldb_private;
+
+namespace
+{
+    const char *g_mangled_names[] =
+    {
+#include "MangledNames.inc"
+    };
+
+    const size_t g_num_mangled_names = sizeof(g_mangled_names) / sizeof(g_mangled_names[0]);
+
+    //------------------------------------------------------------------
+    // LEB128 values are mostly small in DWARF (attribute forms, abbrev
+    // codes, line table advances) with the occasional large address or
+    // constant, so weight the corpus the same way.
+    //------------------------------------------------------------------
+    uint64_t
+    MakeLEB128Value (Random &random)
+    {
+        const uint64_t kind = random.NextBelow (100);
+        if (kind < 60)
+            return random.NextBelow (1ull << 7);
+        if (kind < 85)
+            return random.NextBelow (1ull << 14);
+        if (kind < 95)
+            return random.NextBelow (1ull << 32);
+        return random.Next();
+    }
+
+    void
+    AppendULEB128 (std::vector<uint8_t> &bytes, uint64_t value)
+    {
+        do
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0x80;
+            bytes.push_back (byte);
+        } while (value != 0);
+    }
+
+    void
+    AppendSLEB128 (std::vector<uint8_t> &bytes, int64_t value)
+    {
+        bool more = true;
+        while (more)
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0))
+                more = false;
+            else
+                byte |= 0x80;
+            bytes.push_back (byte);
+        }
+    }
+
+    const uint32_t kNumLEB128Values = 1000000;
+
+    std::shared_ptr<std::vector<uint8_t>>
+    MakeLEB128Buffer (bool is_signed)
+    {
+        std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>());
+        Random random;
+        for (uint32_t i = 0; i < kNumLEB128Values; ++i)
+        {
+            const uint64_t value = MakeLEB128Value (random);
+            if (is_signed)
+                AppendSLEB128 (*bytes, (random.Next() & 1) ? (int64_t)value : -(int64_t)value);
+            else
+                AppendULEB128 (*bytes, value);
+        }
+        return bytes;
+    }
+}
+
+//----------------------------------------------------------------------
+// DataExtractor
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("DataExtractor.GetULEB128", []() {
+    std::shared_ptr<std::vector<uint8_t>> bytes = MakeLEB128Buffer (false);
+    return Benchmark::Body([bytes]() -> uint64_t {
+        DataExtractor data (bytes->data(), bytes->size(), lldb::eByteOrderLittle, 8);
+        lldb::offset_t offset = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < kNumLEB128Values; ++i)
+            sum += data.GetULEB128 (&offset);
+        Consume (sum);
+        return kNumLEB128Values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.GetSLEB128", []() {
+    std::shared_ptr<std::vector<uint8_t>> bytes = MakeLEB128Buffer (true);
+    return Benchmark::Body([bytes]() -> uint64_t {
+        DataExtractor data (bytes->data(), bytes->size(), lldb::eByteOrderLittle, 8);
+        lldb::offset_t offset = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < kNumLEB128Values; ++i)
+            sum += data.GetSLEB128 (&offset);
+        Consume (sum);
+        return kNumLEB128Values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.GetULEB128.Batched", []() {
+    std::shared_ptr<std::vector<uint8_t>> bytes = MakeLEB128Buffer (false);
+    std::shared_ptr<std::vector<uint64_t>> values (new std::vector<uint64_t>(kNumLEB128Values));
+    return Benchmark::Body([bytes, values]() -> uint64_t {
+        DataExtractor data (bytes->data(), bytes->size(), lldb::eByteOrderLittle, 8);
+        lldb::offset_t offset = 0;
+        const uint32_t num_values = data.GetULEB128 (&offset, values->data(), kNumLEB128Values);
+        Consume ((*values)[num_values / 2]);
+        return num_values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.Skip_LEB128", []() {
+    std::shared_ptr<std::vector<uint8_t>> bytes = MakeLEB128Buffer (false);
+    return Benchmark::Body([bytes]() -> uint64_t {
+        DataExtractor data (bytes->data(), bytes->size(), lldb::eByteOrderLittle, 8);
+        lldb::offset_t offset = 0;
+        for (uint32_t i = 0; i < kNumLEB128Values; ++i)
+            data.Skip_LEB128 (&offset);
+        Consume (offset);
+        return kNumLEB128Values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.Skip_LEB128.Batched", []() {
+    std::shared_ptr<std::vector<uint8_t>> bytes = MakeLEB128Buffer (false);
+    return Benchmark::Body([bytes]() -> uint64_t {
+        DataExtractor data (bytes->data(), bytes->size(), lldb::eByteOrderLittle, 8);
+        lldb::offset_t offset = 0;
+        const uint32_t num_values = data.Skip_LEB128 (&offset, kNumLEB128Values);
+        Consume (offset);
+        return num_values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.GetU32", []() {
+    const uint32_t num_values = 1000000;
+    std::shared_ptr<std::vector<uint32_t>> values (new std::vector<uint32_t>());
+    Random random;
+    for (uint32_t i = 0; i < num_values; ++i)
+        values->push_back ((uint32_t)random.Next());
+    return Benchmark::Body([values, num_values]() -> uint64_t {
+        DataExtractor data (values->data(), values->size() * sizeof(uint32_t), lldb::endian::InlHostByteOrder(), 8);
+        lldb::offset_t offset = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < num_values; ++i)
+            sum += data.GetU32 (&offset);
+        Consume (sum);
+        return num_values;
+    });
+});
+
+LLDB_BENCHMARK("DataExtractor.GetU32.Swapped", []() {
+    const uint32_t num_values = 1000000;
+    std::shared_ptr<std::vector<uint32_t>> values (new std::vector<uint32_t>());
+    Random random;
+    for (uint32_t i = 0; i < num_values; ++i)
+        values->push_back ((uint32_t)random.Next());
+    const lldb::ByteOrder swapped = lldb::endian::InlHostByteOrder() == lldb::eByteOrderLittle ? lldb::eByteOrderBig : lldb::eByteOrderLittle;
+    return Benchmark::Body([values, num_values, swapped]() -> uint64_t {
+        DataExtractor data (values->data(), values->size() * sizeof(uint32_t), swapped, 8);
+        lldb::offset_t offset = 0;
+        uint64_t sum = 0;
+        for (uint32_t i = 0; i < num_values; ++i)
+            sum += data.GetU32 (&offset);
+        Consume (sum);
+        return num_values;
+    });
+});
+
+//----------------------------------------------------------------------
+// ConstString
+//
+// Each thread interns the same mix of strings that a symbol table load
+// does: half of them are shared with the other threads (common library
+// symbols) and half are unique to the thread. After the warm up run
+// every string is already in the pool, so this measures the lookup path
+// that dominates real sessions along with the pool's lock contention.
+//----------------------------------------------------------------------
+
+namespace
+{
+    const uint32_t kStringsPerThread = 50000;
+
+    Benchmark::Body
+    MakeConstStringBody (uint32_t num_threads)
+    {
+        typedef std::vector<std::string> Strings;
+        std::shared_ptr<std::vector<Strings>> strings (new std::vector<Strings>(num_threads));
+        char buffer[256];
+        for (uint32_t t = 0; t < num_threads; ++t)
+        {
+            for (uint32_t i = 0; i < kStringsPerThread; ++i)
+            {
+                const char *mangled = g_mangled_names[i % g_num_mangled_names];
+                if (i & 1)
+                    snprintf (buffer, sizeof(buffer), "%s.%u.%u", mangled, t, i);
+                else
+                    snprintf (buffer, sizeof(buffer), "%s.%u", mangled, i);
+                (*strings)[t].push_back (buffer);
+            }
+        }
+
+        return Benchmark::Body([strings, num_threads]() -> uint64_t {
+            std::vector<std::thread> threads;
+            for (uint32_t t = 0; t < num_threads; ++t)
+            {
+                const Strings *thread_strings = &(*strings)[t];
+                threads.push_back (std::thread([thread_strings]() {
+                    for (const std::string &s : *thread_strings)
+                        Consume (ConstString (s.c_str()).GetCString());
+                }));
+            }
+            for (std::thread &thread : threads)
+                thread.join();
+            return (uint64_t)num_threads * kStringsPerThread;
+        });
+    }
+}
+
+LLDB_BENCHMARK("ConstString.Intern/threads:1", []() { return MakeConstStringBody (1); });
+LLDB_BENCHMARK("ConstString.Intern/threads:2", []() { return MakeConstStringBody (2); });
+LLDB_BENCHMARK("ConstString.Intern/threads:4", []() { return MakeConstStringBody (4); });
+LLDB_BENCHMARK("ConstString.Intern/threads:8", []() { return MakeConstStringBody (8); });
+LLDB_BENCHMARK("ConstString.Intern/threads:16", []() { return MakeConstStringBody (16); });
+LLDB_BENCHMARK("ConstString.Intern/threads:32", []() { return MakeConstStringBody (32); });
+
+//----------------------------------------------------------------------
+// Demangling
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("Demangle.FastDemangle", []() {
+    return Benchmark::Body([]() -> uint64_t {
+        for (size_t i = 0; i < g_num_mangled_names; ++i)
+        {
+            const char *mangled = g_mangled_names[i];
+            char *demangled = FastDemangle (mangled, strlen (mangled));
+            Consume (demangled);
+            free (demangled);
+        }
+        return g_num_mangled_names;
+    });
+});
+
+LLDB_BENCHMARK("Demangle.CxaDemangle", []() {
+    return Benchmark::Body([]() -> uint64_t {
+        for (size_t i = 0; i < g_num_mangled_names; ++i)
+        {
+            char *demangled = lldb_private::__cxa_demangle (g_mangled_names[i], NULL, NULL, NULL);
+            Consume (demangled);
+            free (demangled);
+        }
+        return g_num_mangled_names;
+    });
+});
+
+// Mangled remembers every demangled name in the ConstString pool, so
+// after the warm up run this measures the cached path that symbol lookups
+// take over and over.
+LLDB_BENCHMARK("Mangled.GetDemangledName", []() {
+    std::shared_ptr<std::vector<ConstString>> names (new std::vector<ConstString>());
+    for (size_t i = 0; i < g_num_mangled_names; ++i)
+        names->push_back (ConstString (g_mangled_names[i]));
+    return Benchmark::Body([names]() -> uint64_t {
+        for (const ConstString &name : *names)
+        {
+            Mangled mangled (name, true);
+            Consume (mangled.GetDemangledName().GetCString());
+        }
+        return names->size();
+    });
+});
+
+//----------------------------------------------------------------------
+// RangeDataVector
+//
+// Mimics a file address to symbol map: 100,000 sorted, mostly adjacent
+// ranges with the odd gap, queried at random addresses.
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("RangeDataVector.FindEntryThatContains", []() {
+    typedef RangeDataVector<lldb::addr_t, uint32_t, uint32_t> RangeMap;
+    const uint32_t num_ranges = 100000;
+    const uint32_t num_lookups = 1000000;
+
+    std::shared_ptr<RangeMap> ranges (new RangeMap());
+    Random random;
+    lldb::addr_t addr = 0x100000;
+    for (uint32_t i = 0; i < num_ranges; ++i)
+    {
+        const uint32_t size = 4 + (uint32_t)random.NextBelow (512);
+        ranges->Append (RangeMap::Entry (addr, size, i));
+        addr += size;
+        if (random.NextBelow (10) == 0)
+            addr += random.NextBelow (64);
+    }
+    ranges->Sort();
+
+    std::shared_ptr<std::vector<lldb::addr_t>> lookups (new std::vector<lldb::addr_t>());
+    for (uint32_t i = 0; i < num_lookups; ++i)
+        lookups->push_back (0x100000 + random.NextBelow (addr - 0x100000));
+
+    return Benchmark::Body([ranges, lookups]() -> uint64_t {
+        uint64_t found = 0;
+        for (lldb::addr_t lookup : *lookups)
+        {
+            if (ranges->FindEntryThatContains (lookup))
+                ++found;
+        }
+        Consume (found);
+        return lookups->size();
+    });
+});
+
+//----------------------------------------------------------------------
+// UniqueCStringMap
+//
+// Mimics a symbol name index: 100,000 names, looked up with a mix of
+// names that are in the map and names that aren't.
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("UniqueCStringMap.Find", []() {
+    const uint32_t num_names = 100000;
+    const uint32_t num_lookups = 1000000;
+
+    std::shared_ptr<UniqueCStringMap<uint32_t>> map (new UniqueCStringMap<uint32_t>());
+    std::vector<const char *> names;
+    char buffer[256];
+    for (uint32_t i = 0; i < num_names; ++i)
+    {
+        snprintf (buffer, sizeof(buffer), "%s.%u", g_mangled_names[i % g_num_mangled_names], i);
+        const char *name = ConstString (buffer).GetCString();
+        names.push_back (name);
+        map->Append (name, i);
+    }
+    map->Sort();
+
+    // One lookup in ten is for a name that isn't in the map.
+    std::shared_ptr<std::vector<const char *>> lookups (new std::vector<const char *>());
+    Random random;
+    for (uint32_t i = 0; i < num_lookups; ++i)
+    {
+        if (random.NextBelow (10) == 0)
+        {
+            snprintf (buffer, sizeof(buffer), "missing.%u", (uint32_t)random.NextBelow (num_names));
+            lookups->push_back (ConstString (buffer).GetCString());
+        }
+        else
+            lookups->push_back (names[random.NextBelow (num_names)]);
+    }
+
+    return Benchmark::Body([map, lookups]() -> uint64_t {
+        uint64_t sum = 0;
+        for (const char *lookup : *lookups)
+            sum += map->Find (lookup, UINT32_MAX);
+        Consume (sum);
+        return lookups->size();
+    });
+});
@@ -0,0 +1,70 @@
+//===-- UtilityBenchmarks.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmark.h"
+
+#include "lldb/Utility/HexEncoding.h"
+#include "Utility/StringExtractor.h"
+
+using namespace lldb_benchmark;
+using namespace lldb_private;
+
+//----------------------------------------------------------------------
+// StringExtractor
+//
+// Decodes the hex payload of a 64KB memory read packet, which is how
+// "m" and "x" packet replies are handled.
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("StringExtractor.GetHexBytes", []() {
+    const size_t num_bytes = 64 * 1024;
+    static const char hex_digits[] = "0123456789abcdef";
+    std::string packet;
+    Random random;
+    for (size_t i = 0; i < num_bytes; ++i)
+    {
+        const uint8_t byte = (uint8_t)random.Next();
+        packet.push_back (hex_digits[byte >> 4]);
+        packet.push_back (hex_digits[byte & 0xf]);
+    }
+
+    std::shared_ptr<StringExtractor> extractor (new StringExtractor (packet.c_str()));
+    std::shared_ptr<std::vector<uint8_t>> buffer (new std::vector<uint8_t>(num_bytes));
+    return Benchmark::Body([extractor, buffer]() -> uint64_t {
+        extractor->SetFilePos (0);
+        const size_t bytes_read = extractor->GetHexBytes (buffer->data(), buffer->size(), 0);
+        Consume (buffer->data()[bytes_read / 2]);
+        return bytes_read;
+    });
+});
+
+//----------------------------------------------------------------------
+// HexEncoding
+//
+// Encodes a 64KB memory read reply, which is what lldb-server does for
+// "m" and "x" packets.
+//----------------------------------------------------------------------
+
+LLDB_BENCHMARK("HexEncoding.Encode", []() {
+    const size_t num_bytes = 64 * 1024;
+    std::shared_ptr<std::vector<uint8_t>> bytes (new std::vector<uint8_t>());
+    Random random;
+    for (size_t i = 0; i < num_bytes; ++i)
+        bytes->push_back ((uint8_t)random.Next());
+    std::shared_ptr<std::string> hex (new std::string (num_bytes * 2, '\0'));
+    return Benchmark::Body([bytes, hex]() -> uint64_t {
+        HexEncoding::Encode (bytes->data(), bytes->size(), &(*hex)[0]);
+        Consume ((uint64_t)(*hex)[hex->size() / 2]);
+        return bytes->size();
+    });
+});
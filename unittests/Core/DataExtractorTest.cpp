@@ -0,0 +1,159 @@
+//===-- DataExtractorTest.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/DataExtractor.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    class DataExtractorTest: public ::testing::Test
+    {
+    };
+
+    // Values of every encoded length from 1 to 10 bytes, so both the word
+    // at a time and the byte at a time decoders get exercised.
+    const uint64_t kULEB128Values[] =
+    {
+        0, 1, 0x7f, 0x80, 0x3fff, 0x4000, 0x1fffff, 0x200000, 0xfffffff,
+        0x10000000, 0x7ffffffffULL, 0x800000000ULL, 0x3ffffffffffULL,
+        0x40000000000ULL, 0x1ffffffffffffULL, 0x2000000000000ULL,
+        0xffffffffffffffULL, 0x100000000000000ULL, 0x7fffffffffffffffULL,
+        0x8000000000000000ULL, 0xffffffffffffffffULL
+    };
+
+    const int64_t kSLEB128Values[] =
+    {
+        0, 1, -1, 63, -64, 64, -65, 8191, -8192, 8192, -8193,
+        0x7ffffffffffffLL, -0x8000000000000LL, 0x3fffffffffffffffLL,
+        -0x4000000000000000LL, INT64_MAX, INT64_MIN
+    };
+
+    void
+    AppendULEB128 (std::vector<uint8_t> &bytes, uint64_t value)
+    {
+        do
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if (value != 0)
+                byte |= 0x80;
+            bytes.push_back (byte);
+        } while (value != 0);
+    }
+
+    void
+    AppendSLEB128 (std::vector<uint8_t> &bytes, int64_t value)
+    {
+        bool more = true;
+        while (more)
+        {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if ((value == 0 && (byte & 0x40) == 0) || (value == -1 && (byte & 0x40) != 0))
+                more = false;
+            else
+                byte |= 0x80;
+            bytes.push_back (byte);
+        }
+    }
+}
+
+TEST_F (DataExtractorTest, GetULEB128)
+{
+    const size_t num_values = sizeof(kULEB128Values) / sizeof(kULEB128Values[0]);
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < num_values; ++i)
+        AppendULEB128 (bytes, kULEB128Values[i]);
+
+    DataExtractor data (bytes.data(), bytes.size(), eByteOrderLittle, 8);
+    offset_t offset = 0;
+    for (size_t i = 0; i < num_values; ++i)
+        EXPECT_EQ (kULEB128Values[i], data.GetULEB128 (&offset));
+    EXPECT_EQ (bytes.size(), offset);
+
+    std::vector<uint64_t> values (num_values + 1);
+    offset = 0;
+    EXPECT_EQ (num_values, data.GetULEB128 (&offset, values.data(), values.size()));
+    EXPECT_EQ (bytes.size(), offset);
+    for (size_t i = 0; i < num_values; ++i)
+        EXPECT_EQ (kULEB128Values[i], values[i]);
+}
+
+TEST_F (DataExtractorTest, GetSLEB128)
+{
+    const size_t num_values = sizeof(kSLEB128Values) / sizeof(kSLEB128Values[0]);
+    std::vector<uint8_t> bytes;
+    for (size_t i = 0; i < num_values; ++i)
+        AppendSLEB128 (bytes, kSLEB128Values[i]);
+
+    DataExtractor data (bytes.data(), bytes.size(), eByteOrderLittle, 8);
+    offset_t offset = 0;
+    for (size_t i = 0; i < num_values; ++i)
+        EXPECT_EQ (kSLEB128Values[i], data.GetSLEB128 (&offset));
+    EXPECT_EQ (bytes.size(), offset);
+
+    std::vector<int64_t> values (num_values);
+    offset = 0;
+    EXPECT_EQ (num_values, data.GetSLEB128 (&offset, values.data(), values.size()));
+    EXPECT_EQ (bytes.size(), offset);
+    for (size_t i = 0; i < num_values; ++i)
+        EXPECT_EQ (kSLEB128Values[i], values[i]);
+}
+
+TEST_F (DataExtractorTest, SkipLEB128)
+{
+    const size_t num_values = sizeof(kULEB128Values) / sizeof(kULEB128Values[0]);
+    std::vector<uint8_t> bytes;
+    std::vector<offset_t> offsets;
+    for (size_t i = 0; i < num_values; ++i)
+    {
+        AppendULEB128 (bytes, kULEB128Values[i]);
+        offsets.push_back (bytes.size());
+    }
+
+    DataExtractor data (bytes.data(), bytes.size(), eByteOrderLittle, 8);
+    offset_t offset = 0;
+    for (size_t i = 0; i < num_values; ++i)
+    {
+        const offset_t start = offset;
+        EXPECT_EQ (offsets[i] - start - 1, data.Skip_LEB128 (&offset));
+        EXPECT_EQ (offsets[i], offset);
+    }
+
+    offset = 0;
+    EXPECT_EQ (3u, data.Skip_LEB128 (&offset, 3));
+    EXPECT_EQ (offsets[2], offset);
+    EXPECT_EQ (num_values - 3, data.Skip_LEB128 (&offset, num_values));
+    EXPECT_EQ (bytes.size(), offset);
+    EXPECT_EQ (0u, data.Skip_LEB128 (&offset, 1));
+}
+
+TEST_F (DataExtractorTest, TruncatedLEB128)
+{
+    // A value that runs off the end of the data is decoded from the bytes
+    // that are there and consumes all of them.
+    const uint8_t bytes[] = { 0x81, 0x82, 0x83 };
+    DataExtractor data (bytes, sizeof(bytes), eByteOrderLittle, 8);
+
+    offset_t offset = 0;
+    EXPECT_EQ (0x1u | (0x2u << 7) | (0x3u << 14), data.GetULEB128 (&offset));
+    EXPECT_EQ (sizeof(bytes), offset);
+    EXPECT_EQ (0u, data.GetULEB128 (&offset));
+    EXPECT_EQ (sizeof(bytes), offset);
+
+    offset = 1;
+    data.Skip_LEB128 (&offset);
+    EXPECT_EQ (sizeof(bytes), offset);
+}
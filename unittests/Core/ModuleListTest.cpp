@@ -0,0 +1,117 @@
+//===-- ModuleListTest.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/Module.h"
+#include "lldb/Core/ModuleList.h"
+#include "lldb/Core/ModuleSpec.h"
+#include "lldb/Host/HostInfo.h"
+#include "Plugins/ObjectFile/ELF/ObjectFileELF.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    class ModuleListTest: public ::testing::Test
+    {
+    public:
+        static void
+        SetUpTestCase ()
+        {
+            HostInfo::Initialize();
+            ObjectFileELF::Initialize();
+        }
+
+        static void
+        TearDownTestCase ()
+        {
+            ObjectFileELF::Terminate();
+        }
+    };
+
+    const size_t kNumThreads = 8;
+
+    // Get the shared module for each spec from its own thread, all at once.
+    void
+    GetSharedModulesInParallel (const std::vector<ModuleSpec> &module_specs,
+                                std::vector<ModuleSP> &module_sps,
+                                std::vector<char> &did_create)
+    {
+        module_sps.assign (module_specs.size(), ModuleSP());
+        did_create.assign (module_specs.size(), false);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < module_specs.size(); ++i)
+        {
+            threads.push_back (std::thread ([&, i]() {
+                bool created = false;
+                ModuleList::GetSharedModule (module_specs[i], module_sps[i], NULL, NULL, &created, false);
+                did_create[i] = created;
+            }));
+        }
+        for (std::thread &thread : threads)
+            thread.join();
+    }
+}
+
+TEST_F (ModuleListTest, ConcurrentGetSharedModule)
+{
+#if defined(__linux__)
+    const FileSpec exe_spec (HostInfo::GetProgramFileSpec());
+    ASSERT_TRUE (exe_spec.Exists());
+
+    // Half the threads also give a platform path. Exactly one of them must
+    // create the module.
+    std::vector<ModuleSpec> module_specs;
+    for (size_t i = 0; i < kNumThreads; ++i)
+    {
+        ModuleSpec module_spec (exe_spec);
+        if (i % 2)
+            module_spec.GetPlatformFileSpec() = exe_spec;
+        module_specs.push_back (module_spec);
+    }
+
+    std::vector<ModuleSP> module_sps;
+    std::vector<char> did_create; // Not vector<bool>, each thread sets its own element
+    GetSharedModulesInParallel (module_specs, module_sps, did_create);
+
+    ASSERT_TRUE (module_sps[0].get() != NULL);
+    size_t num_created = 0;
+    for (size_t i = 0; i < kNumThreads; ++i)
+    {
+        EXPECT_EQ (module_sps[0].get(), module_sps[i].get());
+        if (did_create[i])
+            ++num_created;
+    }
+    EXPECT_EQ (1u, num_created);
+
+    // Specs with only a UUID and no name must find the same module.
+    const UUID &uuid = module_sps[0]->GetUUID();
+    if (uuid.IsValid())
+    {
+        module_specs.assign (kNumThreads, ModuleSpec());
+        for (ModuleSpec &module_spec : module_specs)
+            module_spec.GetUUID() = uuid;
+
+        std::vector<ModuleSP> uuid_module_sps;
+        GetSharedModulesInParallel (module_specs, uuid_module_sps, did_create);
+        for (size_t i = 0; i < kNumThreads; ++i)
+        {
+            EXPECT_EQ (module_sps[0].get(), uuid_module_sps[i].get());
+            EXPECT_FALSE (did_create[i]);
+        }
+    }
+
+    ModuleList::RemoveSharedModule (module_sps[0]);
+#endif
+}
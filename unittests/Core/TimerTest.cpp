@@ -0,0 +1,81 @@
+//===-- TimerTest.cpp -------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Core/StreamString.h"
+#include "lldb/Core/Timer.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    class TimerTest: public ::testing::Test
+    {
+    public:
+        static void
+        SetUpTestCase ()
+        {
+            Timer::Initialize();
+        }
+    };
+
+    void
+    RunTimedThread ()
+    {
+        std::thread thread ([] () {
+            Timer scoped_timer ("TimerTest", "RunTimedThread");
+        });
+        thread.join();
+    }
+
+    size_t
+    CountThreadsInTrace ()
+    {
+        StreamString trace;
+        Timer::DumpChromeTrace (trace);
+        const std::string &trace_str = trace.GetString();
+        size_t num_threads = 0;
+        for (size_t pos = trace_str.find ("\"thread_name\""); pos != std::string::npos; pos = trace_str.find ("\"thread_name\"", pos + 1))
+            ++num_threads;
+        return num_threads;
+    }
+}
+
+TEST_F (TimerTest, ExitedThreadsAreKeptInTrace)
+{
+    Timer::SetTracing (true);
+    for (size_t i = 0; i < 4; ++i)
+        RunTimedThread ();
+    Timer::SetTracing (false);
+    EXPECT_EQ (4u, CountThreadsInTrace ());
+}
+
+TEST_F (TimerTest, ExitedThreadBuffersAreRecycled)
+{
+    // Far more threads than there are trace buffers, only the buffers of
+    // the most recent threads are dumped.
+    Timer::SetTracing (true);
+    for (size_t i = 0; i < 1024; ++i)
+        RunTimedThread ();
+    Timer::SetTracing (false);
+    const size_t num_threads = CountThreadsInTrace ();
+    EXPECT_LT (0u, num_threads);
+    EXPECT_GE (256u, num_threads);
+
+    // A new trace reuses the buffers of exited threads.
+    Timer::SetTracing (true);
+    RunTimedThread ();
+    Timer::SetTracing (false);
+    EXPECT_EQ (1u, CountThreadsInTrace ());
+}
@@ -0,0 +1,209 @@
+//===-- DWARFExpressionTest.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <thread>
+#include <vector>
+
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Value.h"
+#include "lldb/Core/dwarf.h"
+#include "lldb/Expression/DWARFExpression.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    // Exposes the location list walk of the opcode interpreter.
+    class InterpretedDWARFExpression : public DWARFExpression
+    {
+    public:
+        InterpretedDWARFExpression (const DataExtractor &data) :
+            DWARFExpression (ModuleSP (), data, 0, data.GetByteSize ())
+        {
+        }
+
+        using DWARFExpression::GetLocation;
+    };
+
+    class DWARFExpressionTest : public ::testing::Test
+    {
+    public:
+        void
+        AppendAddress (std::vector<uint8_t> &bytes, uint64_t addr)
+        {
+            for (int i = 0; i < 8; ++i)
+                bytes.push_back ((addr >> (8 * i)) & 0xff);
+        }
+
+        void
+        AppendLocationListEntry (std::vector<uint8_t> &bytes, uint64_t lo_pc, uint64_t hi_pc, const std::vector<uint8_t> &expr)
+        {
+            AppendAddress (bytes, lo_pc);
+            AppendAddress (bytes, hi_pc);
+            bytes.push_back (expr.size () & 0xff);
+            bytes.push_back (expr.size () >> 8);
+            bytes.insert (bytes.end (), expr.begin (), expr.end ());
+        }
+
+        // Evaluate the expression through the compiled fast path and
+        // through the opcode interpreter and check they agree.
+        void
+        CheckAgainstInterpreter (const std::vector<uint8_t> &opcodes)
+        {
+            DataExtractor data (opcodes.data (), opcodes.size (), eByteOrderLittle, 8);
+            DWARFExpression expr (ModuleSP (), data, 0, opcodes.size ());
+
+            Value compiled_result;
+            Error compiled_error;
+            const bool compiled = expr.Evaluate ((ExecutionContext *)NULL, NULL, NULL, NULL, LLDB_INVALID_ADDRESS,
+                                                 NULL, compiled_result, &compiled_error);
+
+            Value interpreted_result;
+            Error interpreted_error;
+            const bool interpreted = DWARFExpression::Evaluate (NULL, NULL, NULL, NULL, ModuleSP (), data, 0, opcodes.size (),
+                                                                eRegisterKindDWARF, NULL, interpreted_result, &interpreted_error);
+
+            ASSERT_EQ (interpreted, compiled);
+            if (compiled)
+            {
+                EXPECT_EQ (interpreted_result.GetValueType (), compiled_result.GetValueType ());
+                EXPECT_EQ (interpreted_result.GetScalar ().ULongLong (), compiled_result.GetScalar ().ULongLong ());
+            }
+        }
+
+        // Check that the compiled location list finds the same expression
+        // as the interpreter's walk of the list for each address.
+        void
+        CheckLocationList (const std::vector<uint8_t> &bytes, addr_t base_addr, addr_t end_addr)
+        {
+            DataExtractor data (bytes.data (), bytes.size (), eByteOrderLittle, 8);
+            InterpretedDWARFExpression loclist (data);
+            loclist.SetLocationListSlide (0);
+
+            for (addr_t addr = base_addr; addr < end_addr; ++addr)
+            {
+                uint32_t reg_num = 0;
+                uint64_t operand = 0;
+                const DWARFExpression::SimpleLocationKind kind = loclist.GetSimpleLocation (base_addr, addr, reg_num, operand);
+
+                lldb::offset_t offset = 0;
+                lldb::offset_t length = 0;
+                if (!loclist.GetLocation (base_addr, addr, offset, length))
+                {
+                    EXPECT_EQ (DWARFExpression::eSimpleLocationNone, kind) << "at 0x" << std::hex << addr;
+                    continue;
+                }
+
+                DWARFExpression expr (ModuleSP (), data, offset, length);
+                uint32_t expected_reg_num = 0;
+                uint64_t expected_operand = 0;
+                EXPECT_EQ (expr.GetSimpleLocation (LLDB_INVALID_ADDRESS, addr, expected_reg_num, expected_operand), kind)
+                    << "at 0x" << std::hex << addr;
+                EXPECT_EQ (expected_reg_num, reg_num);
+                EXPECT_EQ (expected_operand, operand);
+            }
+        }
+    };
+}
+
+TEST_F (DWARFExpressionTest, SingleOpcodesMatchInterpreter)
+{
+    CheckAgainstInterpreter ({DW_OP_addr, 0x78, 0x56, 0x34, 0x12, 0, 0, 0, 0});
+    // Registers and the frame base can't be read without a frame, and both
+    // have to fail the same way.
+    CheckAgainstInterpreter ({DW_OP_reg5});
+    CheckAgainstInterpreter ({DW_OP_breg7, 0x78});
+    CheckAgainstInterpreter ({DW_OP_fbreg, 0x70});
+    // Not a single opcode, so both go through the interpreter.
+    CheckAgainstInterpreter ({DW_OP_addr, 0x78, 0x56, 0x34, 0x12, 0, 0, 0, 0, DW_OP_constu, 0x10, DW_OP_plus});
+    CheckAgainstInterpreter ({DW_OP_constu, 0x2a, DW_OP_stack_value});
+}
+
+TEST_F (DWARFExpressionTest, SimpleLocations)
+{
+    std::vector<uint8_t> opcodes = {DW_OP_breg7, 0x78};
+    DataExtractor data (opcodes.data (), opcodes.size (), eByteOrderLittle, 8);
+    DWARFExpression expr (ModuleSP (), data, 0, opcodes.size ());
+
+    uint32_t reg_num = 0;
+    uint64_t operand = 0;
+    ASSERT_EQ (DWARFExpression::eSimpleLocationRegisterOffset, expr.GetSimpleLocation (LLDB_INVALID_ADDRESS, 0, reg_num, operand));
+    EXPECT_EQ (7u, reg_num);
+    EXPECT_EQ (-8, (int64_t)operand);
+
+    // Changing the opcodes drops what was compiled.
+    opcodes = {DW_OP_reg3};
+    expr.SetOpcodeData (DataExtractor (opcodes.data (), opcodes.size (), eByteOrderLittle, 8));
+    ASSERT_EQ (DWARFExpression::eSimpleLocationRegister, expr.GetSimpleLocation (LLDB_INVALID_ADDRESS, 0, reg_num, operand));
+    EXPECT_EQ (3u, reg_num);
+}
+
+TEST_F (DWARFExpressionTest, SortedLocationListMatchesInterpreter)
+{
+    std::vector<uint8_t> bytes;
+    AppendLocationListEntry (bytes, 0x40, 0x50, {DW_OP_addr, 0x00, 0x20, 0, 0, 0, 0, 0, 0});
+    AppendLocationListEntry (bytes, 0x10, 0x20, {DW_OP_reg5});
+    AppendLocationListEntry (bytes, 0x20, 0x28, {DW_OP_breg7, 0x78});
+    AppendLocationListEntry (bytes, 0x28, 0x30, {});
+    AppendLocationListEntry (bytes, 0x30, 0x38, {DW_OP_constu, 0x2a, DW_OP_stack_value});
+    AppendAddress (bytes, 0);
+    AppendAddress (bytes, 0);
+    CheckLocationList (bytes, 0x1000, 0x1060);
+}
+
+TEST_F (DWARFExpressionTest, OverlappingLocationListMatchesInterpreter)
+{
+    // The first entry that contains an address wins.
+    std::vector<uint8_t> bytes;
+    AppendLocationListEntry (bytes, 0x10, 0x30, {DW_OP_reg5});
+    AppendLocationListEntry (bytes, 0x20, 0x40, {DW_OP_reg6});
+    AppendLocationListEntry (bytes, 0x00, 0x18, {DW_OP_fbreg, 0x70});
+    AppendAddress (bytes, 0);
+    AppendAddress (bytes, 0);
+    CheckLocationList (bytes, 0x1000, 0x1050);
+}
+
+TEST_F (DWARFExpressionTest, CompilesOnceFromManyThreads)
+{
+    std::vector<uint8_t> bytes;
+    for (uint8_t i = 0; i < 32; ++i)
+        AppendLocationListEntry (bytes, 0x10 * i, 0x10 * i + 0x10, {(uint8_t)(DW_OP_reg0 + i)});
+    AppendAddress (bytes, 0);
+    AppendAddress (bytes, 0);
+    DataExtractor data (bytes.data (), bytes.size (), eByteOrderLittle, 8);
+    DWARFExpression loclist (ModuleSP (), data, 0, bytes.size ());
+    loclist.SetLocationListSlide (0);
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures (8, 0);
+    for (size_t t = 0; t < failures.size (); ++t)
+    {
+        threads.push_back (std::thread ([&loclist, &failures, t] ()
+        {
+            // Copies share the compiled location list with the original.
+            DWARFExpression copy (loclist);
+            for (addr_t addr = 0; addr < 0x200; ++addr)
+            {
+                uint32_t reg_num = 0;
+                uint64_t operand = 0;
+                const DWARFExpression &expr = (addr & 1) ? copy : loclist;
+                if (expr.GetSimpleLocation (0, addr, reg_num, operand) != DWARFExpression::eSimpleLocationRegister ||
+                    reg_num != addr / 0x10)
+                    ++failures[t];
+            }
+        }));
+    }
+    for (std::thread &thread : threads)
+        thread.join ();
+    for (int failure_count : failures)
+        EXPECT_EQ (0, failure_count);
+}
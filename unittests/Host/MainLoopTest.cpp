@@ -0,0 +1,131 @@
+//===-- MainLoopTest.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/File.h"
+#include "lldb/Host/MainLoop.h"
+
+#ifndef _WIN32
+#include <signal.h>
+#include <unistd.h>
+#endif
+
+using namespace lldb_private;
+
+#ifndef _WIN32
+
+class MainLoopTest : public testing::Test
+{
+  public:
+    void
+    SetUp() override
+    {
+        ASSERT_EQ(0, ::pipe(m_fds));
+        m_read_sp = std::make_shared<File>(m_fds[0], true);
+    }
+
+    void
+    TearDown() override
+    {
+        m_read_sp.reset();
+        ::close(m_fds[1]);
+    }
+
+  protected:
+    int m_fds[2];
+    lldb::IOObjectSP m_read_sp;
+};
+
+TEST_F(MainLoopTest, ReadObject)
+{
+    char c = 'X';
+    ASSERT_EQ(1, ::write(m_fds[1], &c, 1));
+
+    MainLoop loop;
+    Error error;
+    int callback_count = 0;
+    auto handle = loop.RegisterReadObject(m_read_sp,
+                                          [&](MainLoopBase &loop) {
+                                              char c;
+                                              size_t len = 1;
+                                              m_read_sp->Read(&c, len);
+                                              ++callback_count;
+                                              loop.RequestTermination();
+                                          },
+                                          error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+    ASSERT_TRUE(loop.Run().Success());
+    ASSERT_EQ(1, callback_count);
+}
+
+TEST_F(MainLoopTest, RegisterTwice)
+{
+    MainLoop loop;
+    Error error;
+    auto callback = [](MainLoopBase &) {};
+    auto handle = loop.RegisterReadObject(m_read_sp, callback, error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    auto second_handle = loop.RegisterReadObject(m_read_sp, callback, error);
+    ASSERT_TRUE(error.Fail());
+    ASSERT_FALSE(second_handle);
+}
+
+TEST_F(MainLoopTest, UnregisterFromCallback)
+{
+    char c = 'X';
+    ASSERT_EQ(1, ::write(m_fds[1], &c, 1));
+
+    // The callback doesn't consume the data, so it would be called again if
+    // it didn't unregister itself.
+    MainLoop loop;
+    Error error;
+    int callback_count = 0;
+    MainLoop::ReadHandleUP handle;
+    handle = loop.RegisterReadObject(m_read_sp,
+                                     [&](MainLoopBase &) {
+                                         ++callback_count;
+                                         handle.reset();
+                                         ::kill(::getpid(), SIGUSR1);
+                                     },
+                                     error);
+    ASSERT_TRUE(error.Success());
+
+    auto signal_handle = loop.RegisterSignal(SIGUSR1,
+                                             [](MainLoopBase &loop) { loop.RequestTermination(); },
+                                             error);
+    ASSERT_TRUE(error.Success());
+
+    ASSERT_TRUE(loop.Run().Success());
+    ASSERT_EQ(1, callback_count);
+}
+
+TEST_F(MainLoopTest, Signal)
+{
+    MainLoop loop;
+    Error error;
+    int callback_count = 0;
+    auto handle = loop.RegisterSignal(SIGUSR1,
+                                      [&](MainLoopBase &loop) {
+                                          ++callback_count;
+                                          loop.RequestTermination();
+                                      },
+                                      error);
+    ASSERT_TRUE(error.Success());
+    ASSERT_TRUE(handle);
+
+    ASSERT_EQ(0, ::kill(::getpid(), SIGUSR1));
+    ASSERT_TRUE(loop.Run().Success());
+    ASSERT_EQ(1, callback_count);
+}
+
+#endif
@@ -0,0 +1,154 @@
+//===-- NativeSoftwareWatchpointListTest.cpp --------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/common/NativeSoftwareWatchpointList.h"
+#include "lldb/lldb-enumerations.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    const uint32_t k_watch_write = 0x1;
+    const uint32_t k_watch_read_write = 0x3;
+    const uint32_t k_read_write = lldb::ePermissionsReadable | lldb::ePermissionsWritable;
+
+    bool
+    GetReadWrite (lldb::addr_t page_addr, uint32_t &permissions)
+    {
+        permissions = k_read_write;
+        return true;
+    }
+}
+
+TEST (NativeSoftwareWatchpointListTest, WriteWatchpointTakesWriteAccessAway)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    ASSERT_TRUE (list.Add (0x10010, 8, k_watch_write, GetReadWrite, changes).Success ());
+
+    ASSERT_EQ (1u, changes.size ());
+    EXPECT_EQ (0x10000u, changes[0].addr);
+    EXPECT_EQ (0x1000u, changes[0].size);
+    EXPECT_EQ (static_cast<uint32_t> (lldb::ePermissionsReadable), changes[0].permissions);
+    EXPECT_TRUE (list.IsWatchedPage (0x10000));
+    EXPECT_FALSE (list.IsWatchedPage (0x11000));
+
+    changes.clear ();
+    ASSERT_TRUE (list.Remove (0x10010, changes).Success ());
+    ASSERT_EQ (1u, changes.size ());
+    EXPECT_EQ (k_read_write, changes[0].permissions);
+    EXPECT_TRUE (list.IsEmpty ());
+    EXPECT_FALSE (list.IsWatchedPage (0x10000));
+}
+
+TEST (NativeSoftwareWatchpointListTest, LargeWatchpointChangesPagesTogether)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    ASSERT_TRUE (list.Add (0x10800, 0x2000, k_watch_read_write, GetReadWrite, changes).Success ());
+
+    ASSERT_EQ (1u, changes.size ());
+    EXPECT_EQ (0x10000u, changes[0].addr);
+    EXPECT_EQ (0x3000u, changes[0].size);
+    EXPECT_EQ (0u, changes[0].permissions);
+
+    const NativeSoftwareWatchpointList::Watchpoint *watchpoint = list.FindWatchpoint (0x10800);
+    ASSERT_NE (nullptr, watchpoint);
+    EXPECT_EQ (3u, list.GetNumPages (*watchpoint));
+}
+
+TEST (NativeSoftwareWatchpointListTest, SharedPageKeepsStrongestProtection)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    ASSERT_TRUE (list.Add (0x10000, 4, k_watch_write, GetReadWrite, changes).Success ());
+    changes.clear ();
+    ASSERT_TRUE (list.Add (0x10100, 4, k_watch_read_write, GetReadWrite, changes).Success ());
+    ASSERT_EQ (1u, changes.size ());
+    EXPECT_EQ (0u, changes[0].permissions);
+
+    // The write watchpoint still needs the page read only.
+    changes.clear ();
+    ASSERT_TRUE (list.Remove (0x10100, changes).Success ());
+    ASSERT_EQ (1u, changes.size ());
+    EXPECT_EQ (static_cast<uint32_t> (lldb::ePermissionsReadable), changes[0].permissions);
+    EXPECT_EQ (k_watch_write, list.GetPageWatchFlags (0x10000));
+
+    std::vector<NativeSoftwareWatchpointList::Watchpoint *> watchpoints;
+    list.FindWatchpoints (0x10002, 1, watchpoints);
+    ASSERT_EQ (1u, watchpoints.size ());
+    EXPECT_EQ (0x10000u, watchpoints[0]->addr);
+}
+
+TEST (NativeSoftwareWatchpointListTest, AccessesUnprotectPageUntilLastOneEnds)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    ASSERT_TRUE (list.Add (0x10000, 4, k_watch_write, GetReadWrite, changes).Success ());
+
+    NativeSoftwareWatchpointList::ProtectionChange change;
+    EXPECT_TRUE (list.BeginAccess (0x10000, change));
+    EXPECT_EQ (k_read_write, change.permissions);
+    EXPECT_FALSE (list.BeginAccess (0x10000, change));
+
+    EXPECT_FALSE (list.EndAccess (0x10000, change));
+    EXPECT_TRUE (list.EndAccess (0x10000, change));
+    EXPECT_EQ (static_cast<uint32_t> (lldb::ePermissionsReadable), change.permissions);
+
+    list.RecordFault (0x10000);
+    list.RecordFault (0x10000);
+    EXPECT_EQ (2u, list.FindWatchpoint (0x10000)->num_faults);
+}
+
+TEST (NativeSoftwareWatchpointListTest, FailsForUnmappedPagesWithoutChanges)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    auto only_first_page = [] (lldb::addr_t page_addr, uint32_t &permissions)
+    {
+        permissions = k_read_write;
+        return page_addr == 0x10000;
+    };
+    EXPECT_TRUE (list.Add (0x10ff0, 0x20, k_watch_write, only_first_page, changes).Fail ());
+    EXPECT_TRUE (changes.empty ());
+    EXPECT_TRUE (list.IsEmpty ());
+    EXPECT_FALSE (list.IsWatchedPage (0x10000));
+}
+
+TEST (NativeSoftwareWatchpointListTest, UnwatchedRangesHaveOriginalPermissions)
+{
+    NativeSoftwareWatchpointList list (0x1000);
+    NativeSoftwareWatchpointList::ProtectionChanges changes;
+    ASSERT_TRUE (list.Add (0x11000, 4, k_watch_write, GetReadWrite, changes).Success ());
+    ASSERT_TRUE (list.Add (0x12000, 4, k_watch_write, GetReadWrite, changes).Success ());
+
+    // The watched pages are read only now, the pages around them already
+    // were.
+    NativeSoftwareWatchpointList::ProtectionChanges ranges;
+    list.GetUnwatchedRanges (0x10000, 0x4000, lldb::ePermissionsReadable, ranges);
+    ASSERT_EQ (3u, ranges.size ());
+    EXPECT_EQ (0x10000u, ranges[0].addr);
+    EXPECT_EQ (0x1000u, ranges[0].size);
+    EXPECT_EQ (static_cast<uint32_t> (lldb::ePermissionsReadable), ranges[0].permissions);
+    EXPECT_EQ (0x11000u, ranges[1].addr);
+    EXPECT_EQ (0x2000u, ranges[1].size);
+    EXPECT_EQ (k_read_write, ranges[1].permissions);
+    EXPECT_EQ (0x13000u, ranges[2].addr);
+    EXPECT_EQ (0x1000u, ranges[2].size);
+
+    // A range without watched pages is left alone.
+    ranges.clear ();
+    list.GetUnwatchedRanges (0x20000, 0x1000, k_read_write, ranges);
+    ASSERT_EQ (1u, ranges.size ());
+    EXPECT_EQ (0x20000u, ranges[0].addr);
+    EXPECT_EQ (0x1000u, ranges[0].size);
+    EXPECT_EQ (k_read_write, ranges[0].permissions);
+}
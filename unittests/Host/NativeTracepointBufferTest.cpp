@@ -0,0 +1,78 @@
+//===-- NativeTracepointBufferTest.cpp --------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include "lldb/Host/common/NativeTracepointBuffer.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    NativeTracepointBuffer::Record
+    MakeRecord (lldb::tid_t tid, size_t value_size)
+    {
+        NativeTracepointBuffer::Record record;
+        record.tid = tid;
+        record.addr = 0x1000;
+        record.values.push_back (std::vector<uint8_t> (value_size, 0xab));
+        record.available.push_back (true);
+        return record;
+    }
+}
+
+TEST (NativeTracepointBufferTest, KeepsRecordsInOrder)
+{
+    NativeTracepointBuffer buffer;
+    buffer.Add (MakeRecord (1, 4));
+    buffer.Add (MakeRecord (2, 8));
+    ASSERT_EQ (2u, buffer.GetNumRecords ());
+
+    EXPECT_EQ (1u, buffer.GetOldest ().tid);
+    EXPECT_EQ (4u, buffer.GetOldest ().values[0].size ());
+    buffer.RemoveOldest ();
+    EXPECT_EQ (2u, buffer.GetOldest ().tid);
+    buffer.RemoveOldest ();
+
+    EXPECT_EQ (0u, buffer.GetNumRecords ());
+    EXPECT_EQ (0u, buffer.GetByteSize ());
+    EXPECT_EQ (0u, buffer.GetNumDropped ());
+}
+
+TEST (NativeTracepointBufferTest, DropsOldestRecordsWhenFull)
+{
+    const size_t record_size = MakeRecord (0, 16).GetByteSize ();
+    NativeTracepointBuffer buffer (3 * record_size);
+
+    for (lldb::tid_t tid = 1; tid <= 5; ++tid)
+        buffer.Add (MakeRecord (tid, 16));
+
+    EXPECT_EQ (3u, buffer.GetNumRecords ());
+    EXPECT_EQ (3 * record_size, buffer.GetByteSize ());
+    EXPECT_EQ (2u, buffer.GetNumDropped ());
+    EXPECT_EQ (3u, buffer.GetOldest ().tid);
+}
+
+TEST (NativeTracepointBufferTest, DropsRecordsLargerThanTheBuffer)
+{
+    const size_t record_size = MakeRecord (0, 16).GetByteSize ();
+    NativeTracepointBuffer buffer (record_size);
+
+    buffer.Add (MakeRecord (1, 16));
+    buffer.Add (MakeRecord (2, 32));
+
+    ASSERT_EQ (1u, buffer.GetNumRecords ());
+    EXPECT_EQ (1u, buffer.GetOldest ().tid);
+    EXPECT_EQ (1u, buffer.GetNumDropped ());
+
+    buffer.Clear ();
+    EXPECT_EQ (0u, buffer.GetNumRecords ());
+    EXPECT_EQ (0u, buffer.GetByteSize ());
+    EXPECT_EQ (1u, buffer.GetNumDropped ());
+}
@@ -15,10 +15,18 @@
 
 #include <thread>
 
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#include <sys/select.h>
+#include <unistd.h>
+#endif
+
 #include "gtest/gtest.h"
 
+#include "lldb/Host/ConnectionFileDescriptor.h"
 #include "lldb/Host/Socket.h"
 
+using namespace lldb;
 using namespace lldb_private;
 
 class SocketTest : public testing::Test
@@ -146,3 +154,39 @@ TEST_F (SocketTest, GetAddress)
     EXPECT_STREQ ("127.0.0.1", socket_a_up->GetRemoteIPAddress ().c_str ());
     EXPECT_STREQ ("127.0.0.1", socket_b_up->GetRemoteIPAddress ().c_str ());
 }
+
+#if !defined(_WIN32)
+TEST_F (SocketTest, ConnectionAboveFDSetSize)
+{
+    std::unique_ptr<Socket> socket_a_up;
+    std::unique_ptr<Socket> socket_b_up;
+    CreateConnectedSockets (&socket_a_up, &socket_b_up);
+
+    // Servers with many connections get descriptors that select() can't
+    // wait on, make sure reading from those works.
+    const int high_fd = FD_SETSIZE + 10;
+    struct rlimit limit;
+    ASSERT_EQ (0, ::getrlimit (RLIMIT_NOFILE, &limit));
+    if (limit.rlim_cur <= (rlim_t)high_fd)
+    {
+        if (limit.rlim_max != RLIM_INFINITY && limit.rlim_max <= (rlim_t)high_fd)
+            return; // Can't test this here
+        limit.rlim_cur = high_fd + 1;
+        ASSERT_EQ (0, ::setrlimit (RLIMIT_NOFILE, &limit));
+    }
+    ASSERT_EQ (high_fd, ::dup2 (socket_b_up->GetNativeSocket (), high_fd));
+
+    ConnectionFileDescriptor connection (high_fd, true);
+    char buffer[4];
+    ConnectionStatus status;
+    Error error;
+    EXPECT_EQ (0u, connection.Read (buffer, sizeof buffer, 1000, status, &error));
+    EXPECT_EQ (eConnectionStatusTimedOut, status);
+
+    size_t bytes_written = 2;
+    ASSERT_TRUE (socket_a_up->Write ("+$", bytes_written).Success ());
+    EXPECT_EQ (2u, connection.Read (buffer, sizeof buffer, 1000000, status, &error));
+    EXPECT_EQ (eConnectionStatusSuccess, status);
+    EXPECT_EQ (0, ::memcmp ("+$", buffer, 2));
+}
+#endif
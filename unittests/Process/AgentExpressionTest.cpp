@@ -0,0 +1,199 @@
+//===-- AgentExpressionTest.cpp ---------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string.h>
+
+#include "Plugins/Process/Utility/AgentExpression.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    class AgentExpressionTest: public ::testing::Test
+    {
+    public:
+        AgentExpressionTest () :
+            m_registers (),
+            m_memory ()
+        {
+        }
+
+        Error
+        Evaluate (AgentExpression &expr, uint64_t &result)
+        {
+            expr.AppendOpcode (AgentExpression::eOpEnd);
+            return expr.Evaluate ([this] (uint32_t reg_num, uint64_t &value)
+                                  {
+                                      auto pos = m_registers.find (reg_num);
+                                      if (pos == m_registers.end ())
+                                          return false;
+                                      value = pos->second;
+                                      return true;
+                                  },
+                                  [this] (addr_t addr, void *buf, size_t size)
+                                  {
+                                      auto pos = m_memory.find (addr);
+                                      if (pos == m_memory.end () || pos->second.size () < size)
+                                          return false;
+                                      ::memcpy (buf, pos->second.data (), size);
+                                      return true;
+                                  },
+                                  eByteOrderLittle,
+                                  result);
+        }
+
+        std::map<uint32_t, uint64_t> m_registers;
+        std::map<addr_t, std::vector<uint8_t> > m_memory;
+    };
+}
+
+TEST_F (AgentExpressionTest, ConstantsUseShortestEncoding)
+{
+    AgentExpression expr;
+    expr.AppendConstant (0x12);
+    EXPECT_EQ (2u, expr.GetSize ());
+    expr.AppendConstant (0x1234);
+    EXPECT_EQ (5u, expr.GetSize ());
+    expr.AppendConstant (0x12345678);
+    EXPECT_EQ (10u, expr.GetSize ());
+    expr.AppendConstant (0x123456789aull);
+    EXPECT_EQ (19u, expr.GetSize ());
+
+    const uint8_t expected[] = { 0x25, 0x00, 0x00, 0x00, 0x12, 0x34, 0x56, 0x78, 0x9a };
+    EXPECT_EQ (0, ::memcmp (expected, expr.GetBytes ().data () + 10, sizeof expected));
+
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expr, result).Success ());
+    EXPECT_EQ (0x123456789aull, result);
+}
+
+TEST_F (AgentExpressionTest, ComparesRegisterWithConstant)
+{
+    // $r3 == 42
+    AgentExpression expr;
+    expr.AppendRegister (3);
+    expr.AppendConstant (42);
+    expr.AppendOpcode (AgentExpression::eOpEqual);
+
+    uint64_t result = 0;
+    m_registers[3] = 42;
+    ASSERT_TRUE (Evaluate (expr, result).Success ());
+    EXPECT_EQ (1u, result);
+
+    AgentExpression expr2 (expr.GetBytes ().data (), expr.GetSize () - 1);
+    m_registers[3] = 41;
+    ASSERT_TRUE (Evaluate (expr2, result).Success ());
+    EXPECT_EQ (0u, result);
+}
+
+TEST_F (AgentExpressionTest, SignedAndUnsignedLess)
+{
+    // -1 < 1
+    AgentExpression expr;
+    expr.AppendConstant (0xff);
+    expr.AppendExtend (true, 8);
+    expr.AppendConstant (1);
+    expr.AppendOpcode (AgentExpression::eOpLessSigned);
+
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expr, result).Success ());
+    EXPECT_EQ (1u, result);
+
+    AgentExpression unsigned_expr;
+    unsigned_expr.AppendConstant (0xff);
+    unsigned_expr.AppendExtend (true, 8);
+    unsigned_expr.AppendConstant (1);
+    unsigned_expr.AppendOpcode (AgentExpression::eOpLessUnsigned);
+    ASSERT_TRUE (Evaluate (unsigned_expr, result).Success ());
+    EXPECT_EQ (0u, result);
+}
+
+TEST_F (AgentExpressionTest, ReadsMemoryInTargetByteOrder)
+{
+    // *(int16_t *)0x1000 < 0
+    m_memory[0x1000] = { 0xfe, 0xff };
+    AgentExpression expr;
+    expr.AppendConstant (0x1000);
+    ASSERT_TRUE (expr.AppendReference (2));
+    expr.AppendExtend (true, 16);
+
+    uint64_t result = 0;
+    ASSERT_TRUE (Evaluate (expr, result).Success ());
+    EXPECT_EQ (static_cast<uint64_t> (-2), result);
+
+    EXPECT_FALSE (expr.AppendReference (3));
+}
+
+TEST_F (AgentExpressionTest, ConditionalJumps)
+{
+    // $r0 ? 7 : 9
+    AgentExpression expr;
+    expr.AppendRegister (0);
+    const size_t if_true = expr.AppendJump (AgentExpression::eOpIfGoto);
+    expr.AppendConstant (9);
+    const size_t to_end = expr.AppendJump (AgentExpression::eOpGoto);
+    expr.PatchJump (if_true);
+    expr.AppendConstant (7);
+    expr.PatchJump (to_end);
+
+    uint64_t result = 0;
+    m_registers[0] = 1;
+    ASSERT_TRUE (Evaluate (expr, result).Success ());
+    EXPECT_EQ (7u, result);
+
+    AgentExpression expr2 (expr.GetBytes ().data (), expr.GetSize () - 1);
+    m_registers[0] = 0;
+    ASSERT_TRUE (Evaluate (expr2, result).Success ());
+    EXPECT_EQ (9u, result);
+}
+
+TEST_F (AgentExpressionTest, ReportsErrors)
+{
+    uint64_t result = 0;
+
+    // Unreadable register.
+    AgentExpression reg_expr;
+    reg_expr.AppendRegister (5);
+    EXPECT_TRUE (Evaluate (reg_expr, result).Fail ());
+
+    // Unreadable memory.
+    AgentExpression mem_expr;
+    mem_expr.AppendConstant (0x2000);
+    mem_expr.AppendReference (4);
+    EXPECT_TRUE (Evaluate (mem_expr, result).Fail ());
+
+    // Division by zero.
+    AgentExpression div_expr;
+    div_expr.AppendConstant (1);
+    div_expr.AppendConstant (0);
+    div_expr.AppendOpcode (AgentExpression::eOpDivSigned);
+    EXPECT_TRUE (Evaluate (div_expr, result).Fail ());
+
+    // Stack underflow.
+    AgentExpression underflow_expr;
+    underflow_expr.AppendOpcode (AgentExpression::eOpAdd);
+    EXPECT_TRUE (Evaluate (underflow_expr, result).Fail ());
+
+    // A loop that never ends.
+    AgentExpression loop_expr;
+    loop_expr.AppendConstant (1);
+    loop_expr.AppendOpcode (AgentExpression::eOpGoto);
+    loop_expr.AppendOpcode (static_cast<AgentExpression::Opcode> (0));
+    loop_expr.AppendOpcode (static_cast<AgentExpression::Opcode> (2));
+    EXPECT_TRUE (Evaluate (loop_expr, result).Fail ());
+
+    // Truncated operand.
+    const uint8_t truncated[] = { AgentExpression::eOpConst32, 0x00 };
+    AgentExpression truncated_expr (truncated, sizeof truncated);
+    EXPECT_TRUE (truncated_expr.Evaluate (nullptr, nullptr, eByteOrderLittle, result).Fail ());
+}
@@ -0,0 +1,239 @@
+//===-- DisplacedStepTest.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <string>
+
+#include "Plugins/Process/Utility/DisplacedStep.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace
+{
+    const addr_t kInsnAddr = 0x400000;
+    const addr_t kScratchAddr = 0x401000;
+
+    class DisplacedStepTest: public ::testing::Test
+    {
+    public:
+        DisplacedStepTest () :
+            m_registers ()
+        {
+        }
+
+        DisplacedStep::ReadRegisterCallback
+        GetReadRegister ()
+        {
+            return [this] (const char *reg_name, uint64_t &value)
+            {
+                auto pos = m_registers.find (reg_name);
+                if (pos == m_registers.end ())
+                    return false;
+                value = pos->second;
+                return true;
+            };
+        }
+
+        template <size_t N> Error
+        Prepare (DisplacedStep &step, const char *triple, const uint8_t (&bytes)[N])
+        {
+            return step.Prepare (ArchSpec (triple), kInsnAddr, bytes, N, kScratchAddr, GetReadRegister ());
+        }
+
+        static uint64_t
+        GetRegister (const DisplacedStep::Fixup &fixup, const char *reg_name)
+        {
+            for (const auto &reg : fixup.registers)
+            {
+                if (reg.first == reg_name)
+                    return reg.second;
+            }
+            return LLDB_INVALID_ADDRESS;
+        }
+
+        std::map<std::string, uint64_t> m_registers;
+    };
+}
+
+TEST_F (DisplacedStepTest, X86_64CopiesPlainInstruction)
+{
+    // push %rbp, followed by other bytes that aren't part of it
+    const uint8_t bytes[] = { 0x55, 0x48, 0x89, 0xe5 };
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+    ASSERT_EQ (1u, step.GetSlotBytes ().size ());
+    EXPECT_EQ (0x55, step.GetSlotBytes ()[0]);
+
+    DisplacedStep::Fixup fixup;
+    step.Finish (kScratchAddr + 1, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 1, GetRegister (fixup, "rip"));
+    EXPECT_EQ (LLDB_INVALID_ADDRESS, fixup.memory_addr);
+}
+
+TEST_F (DisplacedStepTest, X86_64InstructionLengths)
+{
+    // movabs $0x1122334455667788, %rax
+    const uint8_t movabs[] = { 0x48, 0xb8, 0x88, 0x77, 0x66, 0x55, 0x44, 0x33, 0x22, 0x11 };
+    // testl $0x1, 0x8(%rsp,%rbx,4)
+    const uint8_t test[] = { 0xf7, 0x44, 0x9c, 0x08, 0x01, 0x00, 0x00, 0x00 };
+    // vpxor %ymm2, %ymm1, %ymm0
+    const uint8_t vpxor[] = { 0xc5, 0xf5, 0xef, 0xc2 };
+    // pshufd $0x1b, %xmm1, %xmm0
+    const uint8_t pshufd[] = { 0x66, 0x0f, 0x70, 0xc1, 0x1b };
+
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", movabs).Success ());
+    EXPECT_EQ (sizeof movabs, step.GetSlotBytes ().size ());
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", test).Success ());
+    EXPECT_EQ (sizeof test, step.GetSlotBytes ().size ());
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", vpxor).Success ());
+    EXPECT_EQ (sizeof vpxor, step.GetSlotBytes ().size ());
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", pshufd).Success ());
+    EXPECT_EQ (sizeof pshufd, step.GetSlotBytes ().size ());
+}
+
+TEST_F (DisplacedStepTest, X86_64RewritesRIPRelativeOperand)
+{
+    // mov 0x10(%rip), %rax
+    const uint8_t bytes[] = { 0x48, 0x8b, 0x05, 0x10, 0x00, 0x00, 0x00 };
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+    const std::vector<uint8_t> &slot = step.GetSlotBytes ();
+    ASSERT_EQ (sizeof bytes, slot.size ());
+
+    const int32_t disp = (int32_t)(slot[3] | slot[4] << 8 | slot[5] << 16 | (uint32_t)slot[6] << 24);
+    EXPECT_EQ (kInsnAddr + sizeof bytes + 0x10, kScratchAddr + sizeof bytes + disp);
+}
+
+TEST_F (DisplacedStepTest, X86_64EmulatesConditionalBranch)
+{
+    // je +0x20
+    const uint8_t bytes[] = { 0x74, 0x20 };
+    DisplacedStep step;
+    DisplacedStep::Fixup fixup;
+
+    m_registers["rflags"] = 1 << 6; // ZF
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+    ASSERT_EQ (1u, step.GetSlotBytes ().size ());
+    EXPECT_EQ (0x90, step.GetSlotBytes ()[0]);
+    step.Finish (kScratchAddr + 1, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 2 + 0x20, GetRegister (fixup, "rip"));
+
+    m_registers["rflags"] = 0;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+    step.Finish (kScratchAddr + 1, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 2, GetRegister (fixup, "rip"));
+}
+
+TEST_F (DisplacedStepTest, X86_64EmulatesCall)
+{
+    // call -0x100
+    const uint8_t bytes[] = { 0xe8, 0x00, 0xff, 0xff, 0xff };
+    m_registers["rsp"] = 0x7ff000;
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+
+    DisplacedStep::Fixup fixup;
+    step.Finish (kScratchAddr + 1, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 5 - 0x100, GetRegister (fixup, "rip"));
+    EXPECT_EQ (0x7ff000u - 8, GetRegister (fixup, "rsp"));
+    EXPECT_EQ (0x7ff000u - 8, fixup.memory_addr);
+    EXPECT_EQ (kInsnAddr + 5, fixup.memory_value);
+}
+
+TEST_F (DisplacedStepTest, X86_64FixesIndirectCallReturnAddress)
+{
+    // call *%rax
+    const uint8_t bytes[] = { 0xff, 0xd0 };
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+
+    m_registers["rsp"] = 0x7feff8;
+    DisplacedStep::Fixup fixup;
+    step.Finish (0x500000, GetReadRegister (), fixup);
+    EXPECT_EQ (LLDB_INVALID_ADDRESS, GetRegister (fixup, "rip"));
+    EXPECT_EQ (0x7feff8u, fixup.memory_addr);
+    EXPECT_EQ (kInsnAddr + 2, fixup.memory_value);
+}
+
+TEST_F (DisplacedStepTest, X86_64RejectsSystemCall)
+{
+    const uint8_t bytes[] = { 0x0f, 0x05 };
+    DisplacedStep step;
+    EXPECT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Fail ());
+}
+
+TEST_F (DisplacedStepTest, NotExecutedRestoresPC)
+{
+    const uint8_t bytes[] = { 0x74, 0x20 };
+    m_registers["rflags"] = 0;
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "x86_64-pc-linux", bytes).Success ());
+
+    DisplacedStep::Fixup fixup;
+    step.Finish (kScratchAddr, GetReadRegister (), fixup);
+    ASSERT_EQ (1u, fixup.registers.size ());
+    EXPECT_EQ (kInsnAddr, GetRegister (fixup, "rip"));
+}
+
+TEST_F (DisplacedStepTest, ARM64EmulatesBranchWithLink)
+{
+    // bl -0x8
+    const uint8_t bytes[] = { 0xfe, 0xff, 0xff, 0x97 };
+    DisplacedStep step;
+    ASSERT_TRUE (Prepare (step, "aarch64-unknown-linux", bytes).Success ());
+
+    DisplacedStep::Fixup fixup;
+    step.Finish (kScratchAddr + 4, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr - 8, GetRegister (fixup, "pc"));
+    EXPECT_EQ (kInsnAddr + 4, GetRegister (fixup, "lr"));
+}
+
+TEST_F (DisplacedStepTest, ARM64EmulatesCompareAndBranch)
+{
+    // cbnz x3, +0x40
+    const uint8_t bytes[] = { 0x03, 0x02, 0x00, 0xb5 };
+    DisplacedStep step;
+    DisplacedStep::Fixup fixup;
+
+    m_registers["x3"] = 1;
+    ASSERT_TRUE (Prepare (step, "aarch64-unknown-linux", bytes).Success ());
+    step.Finish (kScratchAddr + 4, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 0x40, GetRegister (fixup, "pc"));
+
+    m_registers["x3"] = 0;
+    ASSERT_TRUE (Prepare (step, "aarch64-unknown-linux", bytes).Success ());
+    step.Finish (kScratchAddr + 4, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 4, GetRegister (fixup, "pc"));
+}
+
+TEST_F (DisplacedStepTest, ARM64EmulatesADRP)
+{
+    // adrp x0, +0x2000
+    const uint8_t bytes[] = { 0x00, 0x00, 0x00, 0xd0 };
+    DisplacedStep step;
+    ASSERT_TRUE (step.Prepare (ArchSpec ("aarch64-unknown-linux"), kInsnAddr + 0x123, bytes, sizeof bytes,
+                               kScratchAddr, GetReadRegister ()).Success ());
+
+    DisplacedStep::Fixup fixup;
+    step.Finish (kScratchAddr + 4, GetReadRegister (), fixup);
+    EXPECT_EQ (kInsnAddr + 0x2000, GetRegister (fixup, "x0"));
+    EXPECT_EQ (kInsnAddr + 0x127, GetRegister (fixup, "pc"));
+}
+
+TEST_F (DisplacedStepTest, ARM64RejectsLiteralLoad)
+{
+    // ldr x1, +0x10
+    const uint8_t bytes[] = { 0x81, 0x00, 0x00, 0x58 };
+    DisplacedStep step;
+    EXPECT_TRUE (Prepare (step, "aarch64-unknown-linux", bytes).Fail ());
+}
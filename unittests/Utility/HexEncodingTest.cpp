@@ -0,0 +1,115 @@
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "lldb/Utility/HexEncoding.h"
+
+using namespace lldb_private;
+
+namespace
+{
+    class HexEncodingTest: public ::testing::Test
+    {
+    };
+
+    // Long enough to go through the 16 byte at a time paths and leave a
+    // tail for the byte at a time loops.
+    std::vector<uint8_t>
+    MakeBytes (size_t size)
+    {
+        std::vector<uint8_t> bytes;
+        for (size_t i = 0; i < size; ++i)
+            bytes.push_back ((uint8_t)(i * 37 + 11));
+        return bytes;
+    }
+
+    std::string
+    SlowEncode (const std::vector<uint8_t> &bytes)
+    {
+        static const char hex_chars[] = "0123456789abcdef";
+        std::string hex;
+        for (uint8_t byte : bytes)
+        {
+            hex.push_back (hex_chars[byte >> 4]);
+            hex.push_back (hex_chars[byte & 0xf]);
+        }
+        return hex;
+    }
+}
+
+TEST_F (HexEncodingTest, DecodeDigit)
+{
+    ASSERT_EQ (0, HexEncoding::DecodeDigit ('0'));
+    ASSERT_EQ (9, HexEncoding::DecodeDigit ('9'));
+    ASSERT_EQ (10, HexEncoding::DecodeDigit ('a'));
+    ASSERT_EQ (15, HexEncoding::DecodeDigit ('f'));
+    ASSERT_EQ (10, HexEncoding::DecodeDigit ('A'));
+    ASSERT_EQ (15, HexEncoding::DecodeDigit ('F'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit ('g'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit ('G'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit ('/'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit (':'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit ('`'));
+    ASSERT_EQ (-1, HexEncoding::DecodeDigit ('\xff'));
+}
+
+TEST_F (HexEncodingTest, Encode)
+{
+    for (size_t size = 0; size < 70; ++size)
+    {
+        const std::vector<uint8_t> bytes = MakeBytes (size);
+        std::string hex (size * 2, '\0');
+        HexEncoding::Encode (bytes.data(), bytes.size(), &hex[0]);
+        ASSERT_EQ (SlowEncode (bytes), hex);
+    }
+}
+
+TEST_F (HexEncodingTest, Decode)
+{
+    for (size_t size = 0; size < 70; ++size)
+    {
+        const std::vector<uint8_t> bytes = MakeBytes (size);
+        std::vector<uint8_t> decoded (size);
+        const std::string hex = SlowEncode (bytes);
+        ASSERT_EQ (size, HexEncoding::Decode (hex.data(), hex.size(), decoded.data(), decoded.size()));
+        ASSERT_EQ (bytes, decoded);
+    }
+}
+
+TEST_F (HexEncodingTest, DecodeMixedCase)
+{
+    const char kHex[] = "0123456789ABCDEFabcdefAbCdEf0a";
+    uint8_t decoded[15];
+    ASSERT_EQ (15u, HexEncoding::Decode (kHex, strlen (kHex), decoded, sizeof(decoded)));
+    ASSERT_EQ (0x01, decoded[0]);
+    ASSERT_EQ (0xef, decoded[7]);
+    ASSERT_EQ (0xab, decoded[8]);
+    ASSERT_EQ (0xef, decoded[13]);
+    ASSERT_EQ (0x0a, decoded[14]);
+}
+
+TEST_F (HexEncodingTest, DecodeStopsAtInvalidDigit)
+{
+    const std::string hex = SlowEncode (MakeBytes (40));
+    uint8_t decoded[40];
+    for (size_t bad_idx = 0; bad_idx < hex.size(); ++bad_idx)
+    {
+        std::string bad_hex = hex;
+        bad_hex[bad_idx] = 'x';
+        ASSERT_EQ (bad_idx / 2, HexEncoding::Decode (bad_hex.data(), bad_hex.size(), decoded, sizeof(decoded)));
+    }
+}
+
+TEST_F (HexEncodingTest, DecodeLimits)
+{
+    const std::string hex = SlowEncode (MakeBytes (40));
+    uint8_t decoded[40];
+    // Limited by the destination size
+    ASSERT_EQ (17u, HexEncoding::Decode (hex.data(), hex.size(), decoded, 17));
+    // Limited by the source size, ignoring a trailing odd digit
+    ASSERT_EQ (9u, HexEncoding::Decode (hex.data(), 19, decoded, sizeof(decoded)));
+    ASSERT_EQ (0u, HexEncoding::Decode (hex.data(), 1, decoded, sizeof(decoded)));
+}